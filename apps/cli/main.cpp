@@ -5,28 +5,45 @@
 
 #include "audio/audio_capture_device.h"
 #include "audio/audio_processor.h"
-#include "media/flac_writer.h"
+#include "audio/biquad_cascade.h"
+#include "audio/lookahead_limiter.h"
+#include "media/async_file_sink.h"
+#include "media/opus_writer.h"
 #include "media/wav_writer.h"
+#include "utils/audio_kernels.h"
 #include "utils/logger.h"
+#include "utils/metrics.h"
 #include "utils/signal_generator.h"
+#include "utils/thread_policy.h"
+#include "utils/trace.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #ifdef ENABLE_RNNOISE
     #include "audio/rnnoise_processor.h"
 #endif
 
 #ifdef ENABLE_WHISPER
+    #include "audio/caption_server.h"
+    #include "audio/chunked_transcriber.h"
     #include "audio/diarizer.h"
+    #include "audio/inference_scheduler.h"
     #include "audio/live_captioner.h"
+    #include "audio/transcription_cache.h"
     #include "audio/vad_segmenter.h"
     #include "audio/whisper_processor.h"
     #include "utils/audio_converter.h"
+    #include "utils/batch_inputs.h"
     #include "utils/subtitle_generator.h"
 #endif
 
@@ -58,6 +75,15 @@ static bool g_json_mode = false;
 // "progress" events; both must write atomically.
 static std::mutex g_stdout_mutex;
 
+#ifdef ENABLE_WHISPER
+// Whisper backend from --backend / --gpu-device / --flash-attn, stripped in the
+// same pre-pass and applied to every WhisperConfig the commands build.
+static ffvoice::WhisperAcceleration g_whisper_acceleration;
+
+// Transcription result cache directory from --cache-dir (empty = no cache)
+static std::string g_cache_dir;
+#endif
+
 // ---------------------------------------------------------------------------
 // JSON helper: escape a raw string for embedding as a JSON string value.
 // (Mirrors EscapeJSON in subtitle_generator.cpp — kept local to avoid
@@ -159,20 +185,44 @@ void print_usage(const char* program_name) {
     std::cout << "  --help, -h              Show this help message\n";
     std::cout << "  --version, -V           Print version and exit\n";
     std::cout << "  --json                  Machine-readable JSON output mode\n";
+    std::cout << "  --metrics-json FILE     Write per-stage latency/throughput metrics on exit\n";
+    std::cout << "                          (- for stderr)\n";
+    std::cout << "  --trace FILE            Write a Chrome/Perfetto trace of pipeline spans\n";
+    std::cout << "                          (needs a build with FFVOICE_ENABLE_TRACING=ON)\n";
     std::cout << "  --list-devices, -l      List available audio devices\n";
+#ifdef ENABLE_WHISPER
+    std::cout << "  --list-backends         List Whisper backends and GPUs in this build\n";
+#endif
     std::cout << "  --test-wav FILE         Generate test WAV file (440Hz sine wave)\n";
     std::cout << "  --record, -r            Record audio from microphone\n";
     std::cout << "    -d, --device ID       Select audio device (default: auto)\n";
     std::cout << "    -o, --output FILE     Output file path (required; use - for stdout)\n";
     std::cout << "    -t, --duration SEC    Recording duration in seconds (0 = unlimited)\n";
-    std::cout << "    -f, --format FMT      Output format: wav, flac (default: wav)\n";
+    std::cout << "    -f, --format FMT      Output format: wav, flac, opus (default: wav)\n";
     std::cout << "    --sample-rate RATE    Sample rate in Hz (default: 48000)\n";
-    std::cout << "    --channels NUM        Number of channels: 1=mono, 2=stereo (default: 1)\n";
+    std::cout << "    --channels NUM        Channels 1-8: 1=mono, 2=stereo (default: 1)\n";
     std::cout << "    --compression LEVEL   FLAC compression level 0-8 (default: 5)\n";
+    std::cout << "    --bitrate KBPS        Opus bitrate in kb/s, 6-510 (default: 32)\n";
+    std::cout << "    --write-buffer MS     Audio queued for the file writer thread in ms\n";
+    std::cout << "                          (default: 2000; raise if samples are dropped)\n";
+    std::cout << "    --segment SEC         Start a new file every SEC seconds\n";
+    std::cout << "                          (FILE_0000.wav, FILE_0001.wav, ...)\n";
+    std::cout << "    --segment-mb MB       Start a new file every MB megabytes of audio\n";
+    std::cout << "    --buffer-frames N     Frames per capture callback, 0-8192; 0 lets\n";
+    std::cout << "                          PortAudio choose (default: 256)\n";
+    std::cout << "    --latency-ms MS       Suggested input latency in ms, 0-1000; 0 uses the\n";
+    std::cout << "                          device's low-latency default (default: 0)\n";
+    std::cout << "    --realtime            Run the capture thread at real-time priority\n";
+    std::cout << "    --capture-cpus LIST   Pin the capture thread to cores, e.g. 0 or 0-1\n";
+    std::cout << "    --worker-cpus LIST    Pin writer and caption threads to cores, e.g. 2-7\n";
+    std::cout << "                          (default with --capture-cpus: all other cores)\n";
     std::cout
         << "    --enable-processing   Enable audio processing (normalize + high-pass filter)\n";
     std::cout << "    --normalize           Enable volume normalization\n";
-    std::cout << "    --highpass FREQ       Enable high-pass filter at FREQ Hz (default: 80)\n";
+    std::cout << "    --highpass FREQ       Enable 24 dB/oct high-pass filter at FREQ Hz\n";
+    std::cout << "                          (default: 80)\n";
+    std::cout << "    --limiter             Lookahead limiter at -1 dBFS as the last stage\n";
+    std::cout << "                          (no clipping; adds 5 ms of latency)\n";
 #ifdef ENABLE_RNNOISE
     std::cout << "    --rnnoise             Enable RNNoise deep learning noise suppression\n";
     std::cout << "    --rnnoise-vad         Enable RNNoise with VAD (experimental)\n";
@@ -184,12 +234,31 @@ void print_usage(const char* program_name) {
     std::cout << "    --transcribe FILE     Transcribe audio file (offline mode)\n";
     std::cout << "    --format FMT          Subtitle format: txt, srt, vtt, json (default: txt)\n";
     std::cout << "    --language LANG       Language: auto, zh, en, etc. (default: auto)\n";
+    std::cout << "    --chunked             Transcribe long files in parallel VAD-cut chunks,\n";
+    std::cout << "                          writing subtitles as each chunk completes\n";
+    std::cout << "    --transcribe-batch SRC\n";
+    std::cout << "                          Transcribe every audio file in directory SRC, or\n";
+    std::cout << "                          each path listed in manifest SRC (model loaded once)\n";
+    std::cout << "    --output-dir DIR      Batch: subtitle directory (default: beside input)\n";
+    std::cout << "    --jobs N              Batch: files at once (default: cores / threads)\n";
+    std::cout << "    --threads N           Batch: Whisper threads per file (default: 4)\n";
+    std::cout << "    --serve ADDR          Caption server for many PCM streams (s16le in,\n";
+    std::cout << "                          JSON lines out); ADDR is unix:PATH or [HOST:]PORT\n";
+    std::cout << "    --max-sessions N      Serve: concurrent streams (default: 64)\n";
     std::cout << "    --live-captions       Enable real-time live captioning during recording\n";
     std::cout
         << "                          (LiveCaptioner engine; worker thread handles Whisper)\n";
     std::cout << "    --transcribe-live     Alias for --live-captions (legacy name)\n";
     std::cout << "    --partial-interval MS Interval between partial caption attempts in ms\n";
     std::cout << "                          (default: 500)\n";
+    std::cout << "    --captions-out FILE   Live captions: append each final caption to FILE\n";
+    std::cout << "                          (.srt, .vtt, .json or text) as it is recognized\n";
+    std::cout << "    --backend NAME        Whisper backend: auto, cpu, cuda, metal, vulkan,\n";
+    std::cout << "                          openvino, coreml (default: auto)\n";
+    std::cout << "    --gpu-device N        GPU index within the backend (default: 0)\n";
+    std::cout << "    --flash-attn          Use flash attention in the decoder\n";
+    std::cout << "    --cache-dir DIR       Reuse transcripts of unchanged files from DIR\n";
+    std::cout << "                          (--transcribe, --transcribe-batch)\n";
     #ifdef ENABLE_DIARIZATION
     std::cout << "    --diarize             Run speaker diarization on the transcript\n";
     std::cout << "    --num-speakers N      Expected number of speakers (default: -1 = auto)\n";
@@ -206,6 +275,7 @@ void print_usage(const char* program_name) {
     std::cout << "  " << program_name << " --test-wav test.wav\n";
     std::cout << "  " << program_name << " --record -o recording.wav -t 10\n";
     std::cout << "  " << program_name << " --record -o recording.flac -f flac -t 30\n";
+    std::cout << "  " << program_name << " --record -o talk.opus --bitrate 24 -t 30\n";
     std::cout << "  " << program_name << " --record -o output.wav --enable-processing -t 20\n";
     std::cout << "  " << program_name << " --record -o clean.flac --normalize --highpass 100\n";
 #ifdef ENABLE_RNNOISE
@@ -215,14 +285,28 @@ void print_usage(const char* program_name) {
 #endif
 #ifdef ENABLE_WHISPER
     std::cout << "  " << program_name << " --transcribe speech.wav -o transcript.txt\n";
+    std::cout << "  " << program_name
+              << " --transcribe speech.wav --backend cuda --flash-attn -o transcript.txt\n";
     std::cout << "  " << program_name << " --transcribe speech.wav --format srt -o subtitles.srt\n";
     std::cout << "  " << program_name << " --transcribe speech.flac --format vtt --language zh\n";
+    std::cout << "  " << program_name
+              << " --transcribe archive.wav --chunked --format srt -o archive.srt\n";
     std::cout << "  " << program_name
               << " --transcribe speech.wav --format json -o transcript.json\n";
+    std::cout << "  " << program_name
+              << " --transcribe-batch recordings/ --format srt --output-dir subs/ --json\n";
+    std::cout << "  " << program_name
+              << " --serve unix:/tmp/captions.sock --sample-rate 16000 --jobs 2\n";
     std::cout << "  " << program_name << " --record -o speech.wav --live-captions -t 60\n";
     std::cout << "  " << program_name
               << " --record -o speech.wav --live-captions --partial-interval 300 -t 60\n";
+    std::cout << "  " << program_name
+              << " --record -o talk.wav --live-captions --captions-out talk.srt -t 3600\n";
     std::cout << "  " << program_name << " --record -o speech.wav --live-captions --json -t 60\n";
+    std::cout << "  " << program_name
+              << " --record -o speech.wav --live-captions --metrics-json metrics.json -t 60\n";
+    std::cout << "  " << program_name
+              << " --record -o speech.wav --live-captions --trace trace.json -t 60\n";
     std::cout << "  " << program_name << " --transcribe speech.wav -o -\n";
     #ifdef ENABLE_DIARIZATION
     std::cout << "  " << program_name
@@ -324,9 +408,156 @@ int list_devices() {
 }
 
 #ifdef ENABLE_WHISPER
+int list_backends() {
+    using namespace ffvoice;
+
+    const WhisperCapabilities caps = ProbeWhisperCapabilities();
+    if (g_json_mode) {
+        std::ostringstream oss;
+        oss << "{\"backends\":[";
+        for (size_t b = 0; b < caps.backends.size(); ++b) {
+            oss << (b > 0 ? "," : "") << "\"" << GetWhisperBackendName(caps.backends[b]) << "\"";
+        }
+        oss << "],\"devices\":[";
+        for (size_t d = 0; d < caps.devices.size(); ++d) {
+            const auto& dev = caps.devices[d];
+            if (d > 0)
+                oss << ",";
+            oss << "{";
+            oss << "\"backend\":\"" << GetWhisperBackendName(dev.backend) << "\",";
+            oss << "\"index\":" << dev.index << ",";
+            oss << "\"name\":\"" << json_escape(dev.name) << "\",";
+            oss << "\"description\":\"" << json_escape(dev.description) << "\",";
+            oss << "\"memory_free\":" << dev.memory_free << ",";
+            oss << "\"memory_total\":" << dev.memory_total;
+            oss << "}";
+        }
+        oss << "],\"system_info\":\"" << json_escape(caps.system_info) << "\"}";
+        emit_json_line(oss.str());
+        return EXIT_OK;
+    }
+
+    std::cout << "Whisper backends:";
+    for (WhisperBackend backend : caps.backends) {
+        std::cout << " " << GetWhisperBackendName(backend);
+    }
+    std::cout << "\n";
+    if (caps.devices.empty()) {
+        std::cout << "No GPUs found; --backend auto runs on the CPU.\n";
+    }
+    for (const auto& dev : caps.devices) {
+        std::cout << "  " << GetWhisperBackendName(dev.backend) << " --gpu-device " << dev.index
+                  << ": " << dev.name;
+        if (!dev.description.empty()) {
+            std::cout << " (" << dev.description << ")";
+        }
+        if (dev.memory_total > 0) {
+            std::cout << ", " << dev.memory_free / (1024 * 1024) << " / "
+                      << dev.memory_total / (1024 * 1024) << " MB free";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "System info: " << caps.system_info << "\n";
+    return EXIT_OK;
+}
+#endif
+
+#ifdef ENABLE_WHISPER
+// Map a --format value to a subtitle format; unknown values fall back to plain text.
+static ffvoice::SubtitleGenerator::Format parse_subtitle_format(const std::string& format_str) {
+    using ffvoice::SubtitleGenerator;
+    if (format_str == "srt") {
+        return SubtitleGenerator::Format::SRT;
+    } else if (format_str == "vtt") {
+        return SubtitleGenerator::Format::VTT;
+    } else if (format_str == "json") {
+        return SubtitleGenerator::Format::JSON;
+    }
+    return SubtitleGenerator::Format::PlainText;
+}
+
+// Streaming variant of transcribe_file(): chunks run in parallel and the
+// subtitle file grows as each one completes, so memory stays bounded on
+// multi-hour recordings.
+int transcribe_file_chunked(const std::string& audio_file, const std::string& output_file,
+                            ffvoice::SubtitleGenerator::Format format,
+                            const ffvoice::WhisperConfig& whisper_config) {
+    using namespace ffvoice;
+
+    ChunkedTranscriberConfig config;
+    config.whisper = whisper_config;
+    // whisper.cpp progress is per chunk and interleaves across workers
+    config.whisper.print_progress = false;
+
+    ChunkedTranscriber transcriber(config);
+    if (!transcriber.Initialize()) {
+        emit_error(EXIT_RUNTIME, "Failed to initialize Whisper: " + transcriber.GetLastError());
+        return EXIT_RUNTIME;
+    }
+
+    const bool to_stdout = output_file == "-";
+    SubtitleWriter writer;
+    if (to_stdout) {
+        std::lock_guard<std::mutex> lock(g_stdout_mutex);
+        writer.Open(std::cout, format);
+    } else if (!writer.Open(output_file, format)) {
+        emit_error(EXIT_RUNTIME, "Failed to open output file: " + output_file);
+        return EXIT_RUNTIME;
+    }
+
+    std::cerr << "Processing in chunks...\n";
+    std::vector<TranscriptionSegment> preview;
+    const bool ok = transcriber.TranscribeFile(
+        audio_file, [&](const std::vector<TranscriptionSegment>& segments) {
+            {
+                std::lock_guard<std::mutex> lock(g_stdout_mutex);
+                writer.Write(segments);
+            }
+            // Progress lines would mix into the transcript when it goes to stdout
+            if (g_json_mode && !to_stdout && !segments.empty()) {
+                std::ostringstream oss;
+                oss << "{\"event\":\"chunk\",\"segments\":" << segments.size()
+                    << ",\"end_ms\":" << segments.back().end_ms << "}";
+                emit_json_line(oss.str());
+            }
+            for (size_t i = 0; i < segments.size() && preview.size() < 3; ++i) {
+                preview.push_back(segments[i]);
+            }
+        });
+
+    bool closed = false;
+    {
+        std::lock_guard<std::mutex> lock(g_stdout_mutex);
+        closed = writer.Close();
+    }
+    if (!ok) {
+        emit_error(EXIT_RUNTIME, "Transcription failed: " + transcriber.GetLastError());
+        return EXIT_RUNTIME;
+    }
+    if (!closed) {
+        emit_error(EXIT_RUNTIME, "Failed to write subtitle file");
+        return EXIT_RUNTIME;
+    }
+
+    const ChunkedTranscriptionStats& stats = transcriber.GetLastStats();
+    std::cerr << "Transcription complete: " << stats.segments << " segments in " << stats.chunks
+              << " chunks (" << std::fixed << std::setprecision(1) << stats.realtime_factor
+              << "x realtime)\n";
+    if (!to_stdout) {
+        std::cerr << "Success! Transcription saved to: " << output_file << "\n";
+    }
+
+    std::cerr << "\nPreview (first 3 segments):\n";
+    for (size_t i = 0; i < preview.size(); ++i) {
+        std::cerr << "  [" << i << "] " << preview[i].text << "\n";
+    }
+
+    return EXIT_OK;
+}
+
 int transcribe_file(const std::string& audio_file, const std::string& output_file,
                     const std::string& format_str, const std::string& language,
-                    bool diarize = false, int num_speakers = -1) {
+                    bool diarize = false, int num_speakers = -1, bool chunked = false) {
     using namespace ffvoice;
 
     std::cerr << "Transcribing audio file:\n";
@@ -337,20 +568,13 @@ int transcribe_file(const std::string& audio_file, const std::string& output_fil
 
     // Determine output format (resolved before constructing the processor so the
     // JSON format can request per-word timestamps from Whisper).
-    SubtitleGenerator::Format format;
-    if (format_str == "srt") {
-        format = SubtitleGenerator::Format::SRT;
-    } else if (format_str == "vtt") {
-        format = SubtitleGenerator::Format::VTT;
-    } else if (format_str == "json") {
-        format = SubtitleGenerator::Format::JSON;
-    } else {
-        format = SubtitleGenerator::Format::PlainText;
-    }
+    const SubtitleGenerator::Format format = parse_subtitle_format(format_str);
 
     // Initialize Whisper processor
     WhisperConfig config;
     config.language = language;
+    config.acceleration = g_whisper_acceleration;
+    config.cache_dir = g_cache_dir;
     // In JSON mode whisper.cpp's own C-level progress output would pollute stdout.
     config.print_progress = !g_json_mode;
     // JSON output embeds per-word timestamps; other formats leave this at false.
@@ -358,12 +582,65 @@ int transcribe_file(const std::string& audio_file, const std::string& output_fil
         config.word_timestamps = true;
     }
 
+    if (chunked) {
+        return transcribe_file_chunked(audio_file, output_file, format, config);
+    }
+
+    #ifdef ENABLE_DIARIZATION
+    // Diarization needs only the audio, so it runs beside Whisper instead of
+    // after it. Long recordings are diarized in 5-minute windows on half the
+    // cores; Whisper keeps the other half.
+    std::vector<SpeakerSegment> speaker_segments;
+    std::string diarize_error;
+    std::thread diarize_thread;
+    if (diarize) {
+        diarize_thread = std::thread([&] {
+            std::vector<float> pcm_data;
+            if (!AudioConverter::LoadAndConvert(audio_file, pcm_data, 16000)) {
+                diarize_error = "Diarization: failed to load audio";
+                return;
+            }
+            DiarizerConfig diar_cfg;
+            diar_cfg.num_speakers = num_speakers;
+            diar_cfg.window_s = 300;
+            diar_cfg.num_workers =
+                static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+            Diarizer diarizer(diar_cfg);
+            if (!diarizer.Init()) {
+                diarize_error = "Diarization init failed: " + diarizer.GetLastError();
+                return;
+            }
+            speaker_segments = diarizer.Diarize(pcm_data, diarizer.GetExpectedSampleRate());
+            if (speaker_segments.empty() && !diarizer.GetLastError().empty()) {
+                diarize_error = "Diarization failed: " + diarizer.GetLastError();
+            }
+        });
+    }
+    // Joined on every path out of this function, including early errors
+    struct JoinOnExit {
+        std::thread& thread;
+        ~JoinOnExit() {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    } join_diarize{diarize_thread};
+    #else
+    if (diarize) {
+        emit_error(EXIT_RUNTIME,
+                   "--diarize is not available in this build "
+                   "(rebuild with -DENABLE_DIARIZATION=ON)");
+        return EXIT_RUNTIME;
+    }
+    #endif
+
     WhisperProcessor whisper(config);
 
     if (!whisper.Initialize()) {
         emit_error(EXIT_RUNTIME, "Failed to initialize Whisper: " + whisper.GetLastError());
         return EXIT_RUNTIME;
     }
+    std::cerr << "Backend: " << whisper.GetBackendDescription() << "\n";
 
     // Transcribe audio file
     std::vector<TranscriptionSegment> segments;
@@ -378,29 +655,14 @@ int transcribe_file(const std::string& audio_file, const std::string& output_fil
 
     #ifdef ENABLE_DIARIZATION
     if (diarize) {
-        std::vector<float> pcm_data;
-        if (!ffvoice::AudioConverter::LoadAndConvert(audio_file, pcm_data, 16000)) {
-            emit_error(EXIT_RUNTIME, "Diarization: failed to load audio");
-            return EXIT_RUNTIME;
-        }
-        ffvoice::DiarizerConfig diar_cfg;
-        diar_cfg.num_speakers = num_speakers;
-        ffvoice::Diarizer diarizer(diar_cfg);
-        if (!diarizer.Init()) {
-            emit_error(EXIT_RUNTIME, "Diarization init failed: " + diarizer.GetLastError());
+        diarize_thread.join();
+        if (!diarize_error.empty()) {
+            emit_error(EXIT_RUNTIME, diarize_error);
             return EXIT_RUNTIME;
         }
-        auto speaker_segments = diarizer.Diarize(pcm_data, diarizer.GetExpectedSampleRate());
-        ffvoice::MergeIntoSegments(segments, speaker_segments);
+        MergeIntoSegments(segments, speaker_segments);
         std::cerr << "Diarization complete: " << speaker_segments.size() << " speaker segments\n";
     }
-    #else
-    if (diarize) {
-        emit_error(EXIT_RUNTIME,
-                   "--diarize is not available in this build "
-                   "(rebuild with -DENABLE_DIARIZATION=ON)");
-        return EXIT_RUNTIME;
-    }
     #endif
 
     // Generate subtitle/transcript output
@@ -427,6 +689,304 @@ int transcribe_file(const std::string& audio_file, const std::string& output_fil
 
     return EXIT_OK;
 }
+// Transcribe many files with one model load. Each of the `jobs` file workers
+// loads a file, decodes it on a shared InferenceScheduler worker and writes
+// the subtitle next to the input (or into output_dir).
+int transcribe_batch(const std::string& source, const std::string& output_dir,
+                     const std::string& format_str, const std::string& language, int jobs,
+                     int threads) {
+    using namespace ffvoice;
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> files;
+    if (!CollectBatchInputs(source, files)) {
+        emit_error(EXIT_NOT_FOUND, "Cannot read batch input: " + source);
+        return EXIT_NOT_FOUND;
+    }
+    if (files.empty()) {
+        emit_error(EXIT_NOT_FOUND, "No audio files found in: " + source);
+        return EXIT_NOT_FOUND;
+    }
+    if (!output_dir.empty()) {
+        std::error_code ec;
+        fs::create_directories(output_dir, ec);
+        if (ec) {
+            emit_error(EXIT_RUNTIME, "Cannot create output directory: " + output_dir);
+            return EXIT_RUNTIME;
+        }
+    }
+
+    const SubtitleGenerator::Format format = parse_subtitle_format(format_str);
+    const char* extension = format == SubtitleGenerator::Format::SRT    ? ".srt"
+                            : format == SubtitleGenerator::Format::VTT  ? ".vtt"
+                            : format == SubtitleGenerator::Format::JSON ? ".json"
+                                                                        : ".txt";
+
+    // Workers run concurrently, so two inputs must never share an output file
+    std::vector<std::string> outputs;
+    std::string plan_error;
+    if (!PlanBatchOutputs(files, output_dir, extension, outputs, plan_error)) {
+        emit_error(EXIT_BAD_ARGS, "Conflicting batch outputs: " + plan_error);
+        return EXIT_BAD_ARGS;
+    }
+
+    // Files run concurrently, each decode using `threads` whisper.cpp threads
+    if (threads <= 0) {
+        threads = WhisperConfig().n_threads;
+    }
+    if (jobs <= 0) {
+        const int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        jobs = std::max(1, hw / threads);
+    }
+    jobs = std::min(jobs, static_cast<int>(files.size()));
+
+    InferenceSchedulerConfig scheduler_cfg;
+    scheduler_cfg.whisper.language = language;
+    scheduler_cfg.whisper.acceleration = g_whisper_acceleration;
+    // whisper.cpp progress would interleave across concurrent files
+    scheduler_cfg.whisper.print_progress = false;
+    scheduler_cfg.whisper.word_timestamps = format == SubtitleGenerator::Format::JSON;
+    scheduler_cfg.num_workers = static_cast<size_t>(jobs);
+    scheduler_cfg.threads_per_worker = threads;
+
+    std::cerr << "Batch transcription: " << files.size() << " files, " << jobs << " jobs x "
+              << threads << " threads\n";
+
+    InferenceScheduler scheduler(scheduler_cfg);
+    if (!scheduler.Start()) {
+        emit_error(EXIT_RUNTIME, "Failed to initialize Whisper: " + scheduler.GetLastError());
+        return EXIT_RUNTIME;
+    }
+
+    // One cache for all workers; keyed off the configuration every file runs with
+    std::unique_ptr<TranscriptionCache> cache;
+    if (!g_cache_dir.empty()) {
+        cache = std::make_unique<TranscriptionCache>(TranscriptionCacheConfig{g_cache_dir});
+    }
+
+    std::atomic<size_t> next_file{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<double> total_audio_s{0.0};
+    const auto batch_start = std::chrono::steady_clock::now();
+
+    auto report = [&](size_t index, const std::string& input, const std::string& output,
+                      const std::string& error, size_t segments, double audio_s,
+                      double elapsed_ms) {
+        const double rtf = elapsed_ms > 0.0 ? audio_s * 1000.0 / elapsed_ms : 0.0;
+        if (g_json_mode) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(3);
+            oss << "{\"event\":\"file\",\"index\":" << index << ",\"total\":" << files.size()
+                << ",\"input\":\"" << json_escape(input) << "\"";
+            if (error.empty()) {
+                oss << ",\"status\":\"ok\",\"output\":\"" << json_escape(output)
+                    << "\",\"segments\":" << segments << ",\"audio_s\":" << audio_s
+                    << ",\"elapsed_ms\":" << elapsed_ms << ",\"realtime_factor\":" << rtf;
+            } else {
+                oss << ",\"status\":\"error\",\"message\":\"" << json_escape(error) << "\"";
+            }
+            oss << "}";
+            emit_json_line(oss.str());
+            return;
+        }
+        std::lock_guard<std::mutex> lock(g_stdout_mutex);
+        std::cerr << "  [" << index + 1 << "/" << files.size() << "] " << input;
+        if (error.empty()) {
+            std::cerr << " -> " << output << " (" << segments << " segments, " << std::fixed
+                      << std::setprecision(1) << rtf << "x realtime)\n";
+        } else {
+            std::cerr << ": " << error << "\n";
+        }
+    };
+
+    auto worker = [&]() {
+        for (size_t index = next_file++; index < files.size(); index = next_file++) {
+            const std::string& input = files[index];
+            const auto start = std::chrono::steady_clock::now();
+
+            const fs::path output = outputs[index];
+
+            // A hit needs neither the decoded audio nor a Whisper worker
+            std::string cache_key;
+            std::vector<TranscriptionSegment> cached;
+            if (cache) {
+                const std::string content_hash = TranscriptionCache::HashFile(input);
+                if (!content_hash.empty()) {
+                    cache_key = TranscriptionCache::MakeKey(content_hash, scheduler_cfg.whisper);
+                }
+            }
+            if (!cache_key.empty() && cache->Lookup(cache_key, cached)) {
+                if (!SubtitleGenerator::Generate(cached, output.string(), format)) {
+                    ++failed;
+                    report(index, input, output.string(), "failed to write subtitle file", 0,
+                           0.0, 0.0);
+                    continue;
+                }
+                // Audio length is not known without decoding; the last cue end is close
+                const double audio_s =
+                    cached.empty() ? 0.0 : static_cast<double>(cached.back().end_ms) / 1000.0;
+                const double elapsed_ms = std::chrono::duration<double, std::milli>(
+                                              std::chrono::steady_clock::now() - start)
+                                              .count();
+                total_audio_s.fetch_add(audio_s);
+                report(index, input, output.string(), std::string(), cached.size(), audio_s,
+                       elapsed_ms);
+                continue;
+            }
+
+            std::vector<float> pcm;
+            if (!AudioConverter::LoadAndConvert(input, pcm, 16000)) {
+                ++failed;
+                report(index, input, output.string(), "failed to load audio", 0, 0.0, 0.0);
+                continue;
+            }
+            const double audio_s = static_cast<double>(pcm.size()) / 16000.0;
+
+            InferenceResult result =
+                scheduler.SubmitPcm(InferencePriority::Final, std::move(pcm)).get();
+            if (!result.ok) {
+                ++failed;
+                report(index, input, output.string(), "transcription failed", 0, audio_s, 0.0);
+                continue;
+            }
+            if (!cache_key.empty()) {
+                cache->Store(cache_key, result.segments);
+            }
+            if (!SubtitleGenerator::Generate(result.segments, output.string(), format)) {
+                ++failed;
+                report(index, input, output.string(), "failed to write subtitle file", 0,
+                       audio_s, 0.0);
+                continue;
+            }
+
+            const double elapsed_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                          start)
+                    .count();
+            total_audio_s.fetch_add(audio_s);
+            report(index, input, output.string(), std::string(), result.segments.size(), audio_s,
+                   elapsed_ms);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < jobs; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    scheduler.Stop();
+
+    const double batch_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batch_start)
+            .count();
+    const double batch_rtf = batch_ms > 0.0 ? total_audio_s.load() * 1000.0 / batch_ms : 0.0;
+    if (g_json_mode) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3);
+        oss << "{\"event\":\"batch_done\",\"files\":" << files.size()
+            << ",\"failed\":" << failed.load() << ",\"audio_s\":" << total_audio_s.load()
+            << ",\"elapsed_ms\":" << batch_ms << ",\"realtime_factor\":" << batch_rtf << "}";
+        emit_json_line(oss.str());
+    } else {
+        std::cerr << "Batch complete: " << files.size() - failed.load() << "/" << files.size()
+                  << " files (" << std::fixed << std::setprecision(1) << batch_rtf
+                  << "x realtime overall)\n";
+    }
+
+    return failed.load() == 0 ? EXIT_OK : EXIT_RUNTIME;
+}
+
+// Server the SIGINT handler stops; only set while serve_captions() runs
+static ffvoice::CaptionServer* g_caption_server = nullptr;
+
+static void serve_signal_handler(int signal) {
+    if (signal == SIGINT && g_caption_server) {
+        g_caption_server->RequestStop();
+    }
+}
+
+// Serve live captions for many concurrent PCM streams with one model load.
+// Clients send s16le PCM at sample_rate/channels and read JSON caption lines
+// back (see audio/caption_server.h).
+int serve_captions(const std::string& listen, int sample_rate, int channels,
+                   const std::string& language, int jobs, int threads, int partial_interval_ms,
+                   int max_sessions) {
+    using namespace ffvoice;
+
+    if (sample_rate <= 0 || channels < 1 || channels > 8) {
+        emit_error(EXIT_BAD_ARGS, "Invalid --sample-rate or --channels");
+        return EXIT_BAD_ARGS;
+    }
+    if (max_sessions < 1) {
+        emit_error(EXIT_BAD_ARGS, "--max-sessions must be at least 1");
+        return EXIT_BAD_ARGS;
+    }
+
+    // Streams share decode workers, each using `threads` whisper.cpp threads
+    if (threads <= 0) {
+        threads = WhisperConfig().n_threads;
+    }
+    if (jobs <= 0) {
+        const int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        jobs = std::max(1, hw / threads);
+    }
+
+    CaptionServerConfig cfg;
+    cfg.listen = listen;
+    cfg.max_sessions = static_cast<size_t>(max_sessions);
+    cfg.session.sample_rate = sample_rate;
+    cfg.session.channels = channels;
+    cfg.session.partial_interval_ms = partial_interval_ms;
+    cfg.session.whisper.language = language;
+    cfg.session.whisper.acceleration = g_whisper_acceleration;
+    cfg.session.whisper.print_progress = false;
+    cfg.scheduler.whisper = cfg.session.whisper;
+    cfg.scheduler.num_workers = static_cast<size_t>(jobs);
+    cfg.scheduler.threads_per_worker = threads;
+
+    CaptionServer server(cfg);
+    if (!server.Start()) {
+        emit_error(EXIT_RUNTIME, "Failed to start caption server: " + server.GetLastError());
+        return EXIT_RUNTIME;
+    }
+
+    if (g_json_mode) {
+        emit_json_line("{\"event\":\"listening\",\"address\":\"" +
+                       json_escape(server.GetBoundAddress()) + "\"}");
+    }
+    std::cerr << "Caption server listening on " << server.GetBoundAddress() << " (" << sample_rate
+              << " Hz, " << channels << " ch s16le; " << jobs << " jobs x " << threads
+              << " threads)\n";
+    std::cerr << "Press Ctrl+C to stop\n";
+
+    g_caption_server = &server;
+    std::signal(SIGINT, serve_signal_handler);
+    const bool ok = server.Run();
+    std::signal(SIGINT, SIG_DFL);
+    g_caption_server = nullptr;
+
+    const CaptionServerStats stats = server.GetStats();
+    if (g_json_mode) {
+        std::ostringstream oss;
+        oss << "{\"event\":\"server_done\",\"sessions\":" << stats.sessions_accepted
+            << ",\"refused\":" << stats.sessions_refused
+            << ",\"bytes_received\":" << stats.bytes_received
+            << ",\"dropped_samples\":" << stats.dropped_samples
+            << ",\"dropped_events\":" << stats.dropped_events << "}";
+        emit_json_line(oss.str());
+    } else {
+        std::cerr << "Caption server stopped: " << stats.sessions_accepted << " sessions served, "
+                  << stats.sessions_refused << " refused, " << stats.dropped_samples
+                  << " samples dropped\n";
+    }
+    if (!ok) {
+        emit_error(EXIT_RUNTIME, "Caption server failed: " + server.GetLastError());
+        return EXIT_RUNTIME;
+    }
+    return EXIT_OK;
+}
 #endif
 
 // Global flag for Ctrl+C handling
@@ -440,15 +1000,19 @@ void signal_handler(int signal) {
 }
 
 int record_audio(int device_id, int duration, const std::string& output_file, int sample_rate,
-                 int channels, const std::string& format, int compression_level,
-                 bool enable_normalize, bool enable_highpass, float highpass_freq
+                 int channels, const std::string& format, int compression_level, int opus_kbps,
+                 bool enable_normalize, bool enable_highpass, float highpass_freq,
+                 bool enable_limiter, int write_buffer_ms, int segment_s, int segment_mb,
+                 int buffer_frames, float latency_ms, const ffvoice::ThreadPolicy& capture_policy,
+                 const ffvoice::ThreadPolicy& worker_policy
 #ifdef ENABLE_RNNOISE
                  ,
                  bool enable_rnnoise = false, bool rnnoise_vad = false
 #endif
 #ifdef ENABLE_WHISPER
                  ,
-                 bool live_captions = false, int partial_interval_ms = 500
+                 bool live_captions = false, int partial_interval_ms = 500,
+                 const std::string& captions_file = ""
 #endif
 ) {
     using namespace ffvoice;
@@ -462,17 +1026,19 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
     std::cerr << "  Format: " << format << "\n";
     if (format == "flac") {
         std::cerr << "  Compression: level " << compression_level << "\n";
+    } else if (format == "opus") {
+        std::cerr << "  Bitrate: " << opus_kbps << " kb/s\n";
     }
 
     // Audio processing
-    bool has_processing = enable_normalize || enable_highpass;
+    bool has_processing = enable_normalize || enable_highpass || enable_limiter;
 #ifdef ENABLE_RNNOISE
     has_processing = has_processing || enable_rnnoise;
 #endif
     if (has_processing) {
         std::cerr << "  Audio processing: enabled\n";
         if (enable_highpass) {
-            std::cerr << "    - High-pass filter (" << highpass_freq << " Hz)\n";
+            std::cerr << "    - High-pass filter (" << highpass_freq << " Hz, 24 dB/oct)\n";
         }
 #ifdef ENABLE_RNNOISE
         if (enable_rnnoise) {
@@ -486,9 +1052,22 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
         if (enable_normalize) {
             std::cerr << "    - Volume normalization\n";
         }
+        if (enable_limiter) {
+            std::cerr << "    - Lookahead limiter (-1 dBFS)\n";
+        }
     }
 
     std::cerr << "  Output: " << output_file << "\n";
+    if (segment_s > 0 || segment_mb > 0) {
+        std::cerr << "  Segments: new file every";
+        if (segment_s > 0) {
+            std::cerr << " " << segment_s << " s";
+        }
+        if (segment_mb > 0) {
+            std::cerr << (segment_s > 0 ? " or" : "") << " " << segment_mb << " MB";
+        }
+        std::cerr << "\n";
+    }
 
 #ifdef ENABLE_WHISPER
     if (live_captions) {
@@ -498,45 +1077,75 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
 #endif
     std::cerr << "\n";
 
-    // Open output file based on format
-    WavWriter wav_writer;
-    FlacWriter flac_writer;
-    bool file_opened = false;
-
+    // Open output file based on format. Encoding runs on the sink's own writer
+    // thread; the capture callback only copies samples into its ring buffer.
+    AsyncFileSink::Config sink_cfg;
     if (format == "wav") {
-        if (wav_writer.Open(output_file, sample_rate, channels, 16)) {
-            file_opened = true;
-        }
+        sink_cfg.format = AsyncFileSink::Format::WAV;
     } else if (format == "flac") {
-        if (flac_writer.Open(output_file, sample_rate, channels, 16, compression_level)) {
-            file_opened = true;
-        }
+        sink_cfg.format = AsyncFileSink::Format::FLAC;
+    } else if (format == "opus") {
+        sink_cfg.format = AsyncFileSink::Format::OPUS;
     } else {
         emit_error(EXIT_BAD_ARGS, "Unsupported format: " + format);
         return EXIT_BAD_ARGS;
     }
+    sink_cfg.sample_rate = sample_rate;
+    sink_cfg.channels = channels;
+    sink_cfg.writer_thread_policy = worker_policy;
+    sink_cfg.bits_per_sample = 16;
+    sink_cfg.compression_level = compression_level;
+    sink_cfg.opus.bitrate = opus_kbps * 1000;
+    sink_cfg.ring_buffer_capacity = static_cast<size_t>(sample_rate) * channels *
+                                    static_cast<size_t>(write_buffer_ms) / 1000;
+    sink_cfg.segment_seconds = segment_s;
+    sink_cfg.segment_bytes = static_cast<uint64_t>(segment_mb) * 1000 * 1000;
+    // Segmented WAV files stay under 4 GB by construction; a single long WAV
+    // becomes RF64 instead of stopping at the limit
+    sink_cfg.wav.rf64 = segment_s <= 0 && segment_mb <= 0;
+    // Multichannel interfaces share FLAC frames across cores; a fixed-length
+    // recording in one file gets a seek table (segments get one from the sink)
+    if (channels > 2) {
+        sink_cfg.flac.num_threads = 0;
+    }
+    if (duration > 0 && sink_cfg.wav.rf64) {
+        sink_cfg.flac.total_frames_estimate =
+            static_cast<uint64_t>(duration) * static_cast<uint64_t>(sample_rate);
+    }
 
-    if (!file_opened) {
+    AsyncFileSink file_sink(sink_cfg);
+    if (!file_sink.Open(output_file)) {
         emit_error(EXIT_RUNTIME, "Failed to open output file: " + output_file);
         return EXIT_RUNTIME;
     }
 
     // Setup audio processing chain
     std::unique_ptr<AudioProcessorChain> processor_chain;
+#ifdef ENABLE_RNNOISE
+    RNNoiseProcessor* rnnoise = nullptr;  // Owned by processor_chain
+#endif
 
     if (has_processing) {
         processor_chain = std::make_unique<AudioProcessorChain>();
 
         // Processing order: High-pass -> RNNoise -> Normalize
         if (enable_highpass) {
-            processor_chain->AddProcessor(std::make_unique<HighPassFilter>(highpass_freq));
+            // 4th-order Butterworth: rumble well below the cutoff is gone, not just halved
+            processor_chain->AddProcessor(std::make_unique<BiquadCascade>(
+                BiquadCascade::ButterworthHighPass(highpass_freq, 4)));
         }
 
 #ifdef ENABLE_RNNOISE
         if (enable_rnnoise) {
             RNNoiseConfig config;
             config.enable_vad = rnnoise_vad;
-            processor_chain->AddProcessor(std::make_unique<RNNoiseProcessor>(config));
+    #ifdef ENABLE_WHISPER
+            // Its per-frame VAD segments the live captions
+            config.enable_vad = config.enable_vad || live_captions;
+    #endif
+            auto processor = std::make_unique<RNNoiseProcessor>(config);
+            rnnoise = processor.get();
+            processor_chain->AddProcessor(std::move(processor));
         }
 #endif
 
@@ -544,6 +1153,11 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
             processor_chain->AddProcessor(std::make_unique<VolumeNormalizer>());
         }
 
+        // Last, so nothing after it can push peaks back over the ceiling
+        if (enable_limiter) {
+            processor_chain->AddProcessor(std::make_unique<LookaheadLimiter>());
+        }
+
         // Initialize the processor chain
         if (!processor_chain->Initialize(sample_rate, channels)) {
             emit_error(EXIT_RUNTIME, "Failed to initialize audio processing");
@@ -554,20 +1168,40 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
 #ifdef ENABLE_WHISPER
     // Setup live captioning via LiveCaptioner (worker thread owns all Whisper calls).
     std::unique_ptr<ffvoice::LiveCaptioner> captioner;
+    // Declared before the captioner is started so it outlives the worker callback
+    SubtitleWriter captions_writer;
 
     if (live_captions) {
+        if (!captions_file.empty()) {
+            const std::string ext = std::filesystem::path(captions_file).extension().string();
+            const auto captions_format = parse_subtitle_format(ext.empty() ? ext : ext.substr(1));
+            if (!captions_writer.Open(captions_file, captions_format)) {
+                emit_error(EXIT_RUNTIME, "Failed to open captions file: " + captions_file);
+                return EXIT_RUNTIME;
+            }
+        }
+
         ffvoice::LiveCaptionerConfig cap_cfg;
         cap_cfg.whisper.language = "auto";
+        cap_cfg.whisper.acceleration = g_whisper_acceleration;
         cap_cfg.whisper.print_progress = false;
         cap_cfg.partial_interval_ms = partial_interval_ms;
         cap_cfg.sample_rate = sample_rate;
         cap_cfg.channels = channels;
         cap_cfg.suppress_whisper_progress = true;
+        cap_cfg.thread_policy = worker_policy;
+        // Start recording at once; the model loads (and warms up) while audio is buffered
+        cap_cfg.background_init = true;
+        cap_cfg.whisper.warmup = true;
 
         captioner = std::make_unique<ffvoice::LiveCaptioner>(cap_cfg);
 
         // Register the caption callback — called from the worker thread.
-        captioner->SetCallback([](const ffvoice::CaptionEvent& ev) {
+        captioner->SetCallback([&captions_writer](const ffvoice::CaptionEvent& ev) {
+            // Finals are appended and flushed one cue at a time; partials are skipped
+            if (captions_writer.IsOpen()) {
+                captions_writer.WriteCaption(ev);
+            }
             const std::string type_str =
                 (ev.type == ffvoice::CaptionEventType::Final) ? "final" : "partial";
 
@@ -577,7 +1211,8 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
                 oss << "{\"type\":\"" << type_str << "\",\"utterance_id\":" << ev.utterance_id
                     << ",\"text\":\"" << json_escape(ev.text)
                     << "\",\"utterance_start_ms\":" << ev.utterance_start_ms
-                    << ",\"utterance_end_ms\":" << ev.utterance_end_ms << "}";
+                    << ",\"utterance_end_ms\":" << ev.utterance_end_ms << ",\"language\":\""
+                    << json_escape(ev.language) << "\"}";
                 emit_json_line(oss.str());
             } else {
                 // Plain mode: partials overwrite the current line; finals get their own line.
@@ -608,9 +1243,26 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
     }
 #endif
 
+    // With processing enabled the device delivers float and the chain runs in
+    // float end to end; samples become int16 once, just before the sinks.
+    const bool float_pipeline = has_processing && processor_chain;
+
+    // While the device runs, log through the background writer so the capture
+    // callback never blocks on stderr; everything queued is written on return
+    struct AsyncLoggingScope {
+        AsyncLoggingScope() {
+            set_async_logging(true);
+        }
+        ~AsyncLoggingScope() {
+            set_async_logging(false);
+        }
+    } async_logging;
+
     // Open audio device
     AudioCaptureDevice capture;
-    if (!capture.Open(device_id, sample_rate, channels, 256)) {
+    capture.SetThreadPolicy(capture_policy);
+    if (!capture.Open(device_id, sample_rate, channels, buffer_frames,
+                      float_pipeline ? AudioFormat::FLOAT32 : AudioFormat::INT16, latency_ms)) {
         emit_error(EXIT_RUNTIME, "Failed to open audio device");
         return EXIT_RUNTIME;
     }
@@ -620,10 +1272,20 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
 
     size_t total_samples = 0;
 
-    // Buffer for audio processing (if enabled)
-    std::vector<int16_t> process_buffer;
-    if (has_processing) {
-        process_buffer.resize(256 * channels * 4);  // Large enough buffer
+    // Fan-out: the capture callback only publishes each block once into this
+    // broadcast buffer (1 s of audio). The pipeline thread below consumes it at
+    // its own pace, runs the processor chain and feeds the sinks, so none of
+    // that work happens on the PortAudio thread.
+    const size_t bus_capacity = static_cast<size_t>(sample_rate) * channels;
+    BroadcastRingBuffer<int16_t> capture_bus(float_pipeline ? 0 : bus_capacity);
+    BroadcastRingBuffer<float> float_capture_bus(float_pipeline ? bus_capacity : 0);
+    int pipeline_consumer = -1;
+    if (float_pipeline) {
+        pipeline_consumer = float_capture_bus.add_consumer();
+        capture.SetFloatBroadcastBuffer(&float_capture_bus);
+    } else {
+        pipeline_consumer = capture_bus.add_consumer();
+        capture.SetBroadcastBuffer(&capture_bus);
     }
 
     // Emit JSON start event (before the capture loop)
@@ -635,45 +1297,87 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
         emit_json_line(oss.str());
     }
 
-    // Start capturing with format-specific callback
-    bool success = capture.Start([&](const int16_t* samples, size_t num_samples) {
-        // Apply audio processing if enabled
-        const int16_t* processed_samples = samples;
-        if (has_processing && processor_chain) {
-            // Copy to buffer for in-place processing
-            if (process_buffer.size() < num_samples) {
-                process_buffer.resize(num_samples);
+    // Pipeline thread: drains the capture bus, processes in place, then hands
+    // the block to the live captioner and the file sink (both non-blocking).
+    std::atomic<bool> pipeline_running{true};
+    std::thread pipeline_thread([&]() {
+        std::vector<int16_t> block(256 * channels * 4);
+        std::vector<float> float_block(float_pipeline ? block.size() : 0);
+        const AudioKernels& kernels = GetAudioKernels();
+
+        // Next block as int16, processed in float first when the chain is active
+        auto pop_block = [&]() -> size_t {
+            if (!float_pipeline) {
+                return capture_bus.pop_bulk(pipeline_consumer, block.data(), block.size());
             }
-            std::copy(samples, samples + num_samples, process_buffer.data());
+            const size_t n = float_capture_bus.pop_bulk(pipeline_consumer, float_block.data(),
+                                                        float_block.size());
+            if (n > 0) {
+                processor_chain->Process(float_block.data(), n);
+                kernels.float_to_int16(float_block.data(), n, block.data());  // The one conversion
+            }
+            return n;
+        };
 
-            // Process in-place
-            processor_chain->Process(process_buffer.data(), num_samples);
-            processed_samples = process_buffer.data();
-        }
+        auto drain = [&]() {
+            size_t n = 0;
+            while ((n = pop_block()) > 0) {
 
 #ifdef ENABLE_WHISPER
-        // Feed processed audio into LiveCaptioner's lock-free ring buffer.
-        // FeedAudio() is non-blocking and safe to call from the capture callback.
-        if (live_captions && captioner) {
-            captioner->FeedAudio(processed_samples, num_samples);
-        }
+                if (live_captions && captioner) {
+    #ifdef ENABLE_RNNOISE
+                    // RNNoise frames are the captioner's 10 ms frames only at 48 kHz.
+                    // Its probabilities describe its own output; the stages after
+                    // it (the high-pass before it has no delay) push that later.
+                    if (rnnoise && sample_rate == 48000) {
+                        const std::vector<float>& probs = rnnoise->GetFrameVADProbabilities();
+                        const size_t offset =
+                            rnnoise->GetFrameVADOffset() +
+                            (processor_chain->GetLatencyFrames() - rnnoise->GetLatencyFrames()) *
+                                static_cast<size_t>(channels);
+                        captioner->FeedAudio(block.data(), n, probs.data(), probs.size(), offset);
+                    } else {
+                        captioner->FeedAudio(block.data(), n);
+                    }
+    #else
+                    captioner->FeedAudio(block.data(), n);
+    #endif
+                }
 #endif
 
-        // Write processed (or original) samples to file
-        if (format == "wav") {
-            wav_writer.WriteSamples(processed_samples, num_samples);
-        } else if (format == "flac") {
-            flac_writer.WriteSamples(processed_samples, num_samples);
+                // Queue processed (or original) samples for the file writer thread
+                file_sink.Write(block.data(), n);
+                total_samples += n;
+            }
+        };
+
+        while (pipeline_running.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
         }
-        total_samples += num_samples;
+        drain();  // Whatever was captured before the device stopped
     });
 
-    if (!success) {
+    auto stop_pipeline = [&]() {
+        pipeline_running.store(false, std::memory_order_release);
+        if (pipeline_thread.joinable()) {
+            pipeline_thread.join();
+        }
+    };
+
+    // Start capturing; the device publishes straight into the capture bus
+    const bool capture_started =
+        float_pipeline ? capture.StartFloat(nullptr) : capture.Start(nullptr);
+    if (!capture_started) {
+        stop_pipeline();
         emit_error(EXIT_RUNTIME, "Failed to start audio capture");
         return EXIT_RUNTIME;
     }
 
     if (!g_json_mode) {
+        std::ostringstream latency;  // Keeps std::fixed off std::cerr for later output
+        latency << std::fixed << std::setprecision(1) << capture.GetInputLatencyMs();
+        std::cerr << "Input latency: " << latency.str() << " ms\n";
         std::cerr << "Recording... (Press Ctrl+C to stop)\n";
     }
 
@@ -712,21 +1416,35 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
     // Stop and cleanup
     capture.Stop();
     capture.Close();
+    stop_pipeline();
+
+    const size_t capture_overruns = capture_bus.overruns(pipeline_consumer);
 
 #ifdef ENABLE_WHISPER
     // Stop LiveCaptioner after capture has stopped so all buffered audio is
     // flushed and the final caption event is emitted before we exit.
     if (live_captions && captioner) {
         captioner->Stop();
+        // With background_init a load failure only surfaces here; the recording itself is kept
+        if (!captioner->IsModelReady()) {
+            emit_error(EXIT_RUNTIME,
+                       "LiveCaptioner model failed to load: " + captioner->GetLastError());
+        }
+        // The worker has exited, so the footer cannot race a last cue
+        if (captions_writer.IsOpen()) {
+            const size_t cues = captions_writer.GetSegmentCount();
+            if (captions_writer.Close()) {
+                std::cerr << "Captions saved to: " << captions_file << " (" << cues << " cues)\n";
+            } else {
+                emit_error(EXIT_RUNTIME, "Failed to write captions file: " + captions_file);
+            }
+        }
     }
 #endif
 
-    if (format == "wav") {
-        wav_writer.Close();
-    } else if (format == "flac") {
-        flac_writer.Close();
-    }
+    file_sink.Close();
 
+    const size_t dropped_samples = file_sink.GetDroppedSamples();
     double duration_sec = static_cast<double>(total_samples) / (sample_rate * channels);
 
     if (g_json_mode) {
@@ -735,9 +1453,29 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
         oss << "{\"event\":\"complete\",\"total_samples\":" << total_samples
             << ",\"duration_seconds\":" << duration_sec << ",\"output_file\":\""
             << json_escape(output_file) << "\"";
-        if (format == "flac") {
+        oss << ",\"files\":" << file_sink.GetNumFiles();
+        oss << ",\"dropped_samples\":" << dropped_samples
+            << ",\"capture_overruns\":" << capture_overruns
+            << ",\"write_buffer_high_water\":" << file_sink.GetHighWaterMark()
+            << ",\"write_buffer_capacity\":" << file_sink.GetCapacity();
+        if (format != "wav") {
             oss << ",\"compression_ratio\":" << std::setprecision(2)
-                << flac_writer.GetCompressionRatio();
+                << file_sink.GetCompressionRatio();
+        }
+        const auto applied_policies = GetAppliedThreadPolicies();
+        if (!applied_policies.empty()) {
+            oss << ",\"thread_policies\":[";
+            for (size_t i = 0; i < applied_policies.size(); ++i) {
+                const auto& applied = applied_policies[i];
+                oss << (i > 0 ? "," : "") << "{\"thread\":\"" << json_escape(applied.thread_name)
+                    << "\",\"priority\":\"" << ThreadPriorityName(applied.priority)
+                    << "\",\"mechanism\":\"" << json_escape(applied.mechanism) << "\",\"cpus\":[";
+                for (size_t c = 0; c < applied.cpus.size(); ++c) {
+                    oss << (c > 0 ? "," : "") << applied.cpus[c];
+                }
+                oss << "],\"error\":\"" << json_escape(applied.error) << "\"}";
+            }
+            oss << "]";
         }
         oss << "}";
         emit_json_line(oss.str());
@@ -745,10 +1483,29 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
         std::cerr << "\nRecording complete!\n";
         std::cerr << "  Captured: " << total_samples << " samples (" << duration_sec
                   << " seconds)\n";
-        std::cerr << "  Saved to: " << output_file << "\n";
+        if (file_sink.GetNumFiles() > 1) {
+            std::cerr << "  Saved to: " << file_sink.GetNumFiles() << " files, "
+                      << AsyncFileSink::GetSegmentPath(output_file, 0) << " ...\n";
+        } else {
+            std::cerr << "  Saved to: " << output_file << "\n";
+        }
+
+        std::cerr << "  Write buffer peak: " << file_sink.GetHighWaterMark() << " / "
+                  << file_sink.GetCapacity() << " samples\n";
+        if (capture_overruns > 0) {
+            std::cerr << "  WARNING: processing fell behind capture, " << capture_overruns
+                      << " samples lost\n";
+        }
+        if (dropped_samples > 0) {
+            std::cerr << "  WARNING: dropped " << dropped_samples
+                      << " samples (writer fell behind; increase --write-buffer)\n";
+        }
+        for (const auto& applied : GetAppliedThreadPolicies()) {
+            std::cerr << "  Thread " << FormatAppliedThreadPolicy(applied) << "\n";
+        }
 
-        if (format == "flac") {
-            double ratio = flac_writer.GetCompressionRatio();
+        if (format != "wav") {
+            double ratio = file_sink.GetCompressionRatio();
             std::cerr << "  Compression ratio: " << std::fixed << std::setprecision(2) << ratio
                       << "x\n";
         }
@@ -759,25 +1516,108 @@ int record_audio(int device_id, int duration, const std::string& output_file, in
     return EXIT_OK;
 }
 
+// ---------------------------------------------------------------------------
+// write_metrics_json(): dump MetricsRegistry for --metrics-json ("-" = stderr,
+// which keeps stdout clean for --json events and audio piped to -o -)
+// ---------------------------------------------------------------------------
+static void write_metrics_json(const std::string& path) {
+    const std::string json = ffvoice::MetricsRegistry::Instance().ToJson();
+    if (path == "-") {
+        std::cerr << json << std::endl;
+        return;
+    }
+    std::ofstream out(path);
+    out << json << "\n";
+    if (!out) {
+        emit_error(EXIT_RUNTIME, "cannot write metrics to " + path);
+    }
+}
+
+static int run_command(int fargc, char** fargv);
+
 int main(int argc, char* argv[]) {
     // ---------------------------------------------------------------------------
-    // Pre-pass: strip --json from argv before command dispatch so that every
-    // code path below sees a clean argv without the flag yet can rely on the
-    // global g_json_mode being set.
+    // Pre-pass: strip --json, --metrics-json, --trace and the Whisper backend
+    // flags from argv before command dispatch so that every code path below
+    // sees a clean argv without the flags yet can rely on the globals
+    // (g_json_mode, g_whisper_acceleration) being set.
     // ---------------------------------------------------------------------------
     std::vector<char*> filtered_argv;
     filtered_argv.push_back(argv[0]);
+    std::string metrics_path;
+    std::string trace_path;
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         if (a == "--json") {
             g_json_mode = true;
+        } else if (a == "--metrics-json") {
+            if (i + 1 >= argc) {
+                emit_error(EXIT_BAD_ARGS, "--metrics-json requires a file (or - for stderr)");
+                return EXIT_BAD_ARGS;
+            }
+            metrics_path = argv[++i];
+        } else if (a == "--trace") {
+            if (i + 1 >= argc) {
+                emit_error(EXIT_BAD_ARGS, "--trace requires a file");
+                return EXIT_BAD_ARGS;
+            }
+            trace_path = argv[++i];
+#ifdef ENABLE_WHISPER
+        } else if (a == "--backend") {
+            if (i + 1 >= argc ||
+                !ffvoice::ParseWhisperBackend(argv[i + 1], g_whisper_acceleration.backend)) {
+                emit_error(EXIT_BAD_ARGS, "--backend requires one of: auto, cpu, cuda, metal, "
+                                          "vulkan, openvino, coreml");
+                return EXIT_BAD_ARGS;
+            }
+            ++i;
+        } else if (a == "--gpu-device") {
+            if (i + 1 >= argc) {
+                emit_error(EXIT_BAD_ARGS, "--gpu-device requires an index");
+                return EXIT_BAD_ARGS;
+            }
+            if (!parse_int_arg(argv[++i], a, g_whisper_acceleration.gpu_device)) {
+                return EXIT_BAD_ARGS;
+            }
+        } else if (a == "--flash-attn") {
+            g_whisper_acceleration.flash_attn = true;
+        } else if (a == "--cache-dir") {
+            if (i + 1 >= argc) {
+                emit_error(EXIT_BAD_ARGS, "--cache-dir requires a directory");
+                return EXIT_BAD_ARGS;
+            }
+            g_cache_dir = argv[++i];
+#endif
         } else {
             filtered_argv.push_back(argv[i]);
         }
     }
-    int fargc = static_cast<int>(filtered_argv.size());
-    char** fargv = filtered_argv.data();
 
+    if (!metrics_path.empty()) {
+        ffvoice::MetricsRegistry::SetEnabled(true);
+    }
+    if (!trace_path.empty()) {
+#ifndef FFVOICE_ENABLE_TRACING
+        LOG_WARNING("--trace: built without FFVOICE_ENABLE_TRACING, the trace will be empty");
+#endif
+        ffvoice::Tracer::Start();
+    }
+
+    const int code = run_command(static_cast<int>(filtered_argv.size()), filtered_argv.data());
+
+    if (!trace_path.empty()) {
+        ffvoice::Tracer::Stop();
+        if (!ffvoice::Tracer::WriteChromeTrace(trace_path)) {
+            emit_error(EXIT_RUNTIME, "cannot write trace to " + trace_path);
+        }
+    }
+    if (!metrics_path.empty()) {
+        write_metrics_json(metrics_path);
+    }
+    return code;
+}
+
+static int run_command(int fargc, char** fargv) {
     // Parse command line arguments
     if (fargc < 2) {
         print_usage(fargv[0]);
@@ -809,6 +1649,12 @@ int main(int argc, char* argv[]) {
         return list_devices();
     }
 
+#ifdef ENABLE_WHISPER
+    if (arg1 == "--list-backends") {
+        return list_backends();
+    }
+#endif
+
 #ifdef ENABLE_WHISPER
     if (arg1 == "--transcribe") {
         // Parse transcription arguments
@@ -825,6 +1671,7 @@ int main(int argc, char* argv[]) {
         std::string language = "auto";  // default: auto-detect
         bool diarize = false;           // run speaker diarization
         int num_speakers = -1;          // -1 = auto-detect
+        bool chunked = false;           // streaming, parallel chunked mode
 
         // Parse options
         for (int i = 3; i < fargc; ++i) {
@@ -835,6 +1682,10 @@ int main(int argc, char* argv[]) {
                 diarize = true;
                 continue;
             }
+            if (arg == "--chunked") {
+                chunked = true;
+                continue;
+            }
 
             if (i + 1 >= fargc)
                 break;
@@ -862,7 +1713,135 @@ int main(int argc, char* argv[]) {
             return EXIT_BAD_ARGS;
         }
 
-        return transcribe_file(audio_file, output_file, format, language, diarize, num_speakers);
+        // Diarization needs the whole recording and the whole transcript at once
+        if (chunked && diarize) {
+            emit_error(EXIT_BAD_ARGS, "--chunked cannot be combined with --diarize");
+            return EXIT_BAD_ARGS;
+        }
+
+        return transcribe_file(audio_file, output_file, format, language, diarize, num_speakers,
+                               chunked);
+    }
+
+    if (arg1 == "--transcribe-batch") {
+        if (fargc < 3) {
+            emit_error(EXIT_BAD_ARGS, "--transcribe-batch requires a directory or manifest file");
+            std::cerr << "Usage: " << fargv[0]
+                      << " --transcribe-batch DIR|MANIFEST [--output-dir DIR] [OPTIONS]\n";
+            return EXIT_BAD_ARGS;
+        }
+
+        std::string source = fargv[2];
+        std::string output_dir;         // default: beside each input
+        std::string format = "txt";     // default: plain text
+        std::string language = "auto";  // default: auto-detect
+        int jobs = 0;                   // 0 = hardware threads / threads
+        int threads = 0;                // 0 = WhisperConfig default
+
+        for (int i = 3; i < fargc; ++i) {
+            std::string arg = fargv[i];
+            if (i + 1 >= fargc) {
+                emit_error(EXIT_BAD_ARGS, "unknown option or missing value: " + arg);
+                return EXIT_BAD_ARGS;
+            }
+            std::string value = fargv[i + 1];
+
+            if (arg == "--output-dir" || arg == "-o") {
+                output_dir = value;
+                ++i;
+            } else if (arg == "--format" || arg == "-f") {
+                format = value;
+                ++i;
+            } else if (arg == "--language") {
+                language = value;
+                ++i;
+            } else if (arg == "--jobs" || arg == "-j") {
+                if (!parse_int_arg(value, arg, jobs)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--threads") {
+                if (!parse_int_arg(value, arg, threads)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else {
+                emit_error(EXIT_BAD_ARGS, "unknown option: " + arg);
+                std::cerr << "Run '" << fargv[0] << " --help' for usage.\n";
+                return EXIT_BAD_ARGS;
+            }
+        }
+
+        return transcribe_batch(source, output_dir, format, language, jobs, threads);
+    }
+
+    if (arg1 == "--serve") {
+        if (fargc < 3) {
+            emit_error(EXIT_BAD_ARGS, "--serve requires a listen address");
+            std::cerr << "Usage: " << fargv[0]
+                      << " --serve unix:PATH|[HOST:]PORT [--sample-rate RATE] [OPTIONS]\n";
+            return EXIT_BAD_ARGS;
+        }
+
+        std::string listen = fargv[2];
+        int sample_rate = 16000;
+        int channels = 1;
+        std::string language = "auto";  // default: auto-detect
+        int jobs = 0;                   // 0 = hardware threads / threads
+        int threads = 0;                // 0 = WhisperConfig default
+        int partial_interval_ms = 500;
+        int max_sessions = 64;
+
+        for (int i = 3; i < fargc; ++i) {
+            std::string arg = fargv[i];
+            if (i + 1 >= fargc) {
+                emit_error(EXIT_BAD_ARGS, "unknown option or missing value: " + arg);
+                return EXIT_BAD_ARGS;
+            }
+            std::string value = fargv[i + 1];
+
+            if (arg == "--language") {
+                language = value;
+                ++i;
+            } else if (arg == "--sample-rate") {
+                if (!parse_int_arg(value, arg, sample_rate)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--channels") {
+                if (!parse_int_arg(value, arg, channels)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--jobs" || arg == "-j") {
+                if (!parse_int_arg(value, arg, jobs)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--threads") {
+                if (!parse_int_arg(value, arg, threads)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--partial-interval") {
+                if (!parse_int_arg(value, arg, partial_interval_ms)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--max-sessions") {
+                if (!parse_int_arg(value, arg, max_sessions)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else {
+                emit_error(EXIT_BAD_ARGS, "unknown option: " + arg);
+                std::cerr << "Run '" << fargv[0] << " --help' for usage.\n";
+                return EXIT_BAD_ARGS;
+            }
+        }
+
+        return serve_captions(listen, sample_rate, channels, language, jobs, threads,
+                              partial_interval_ms, max_sessions);
     }
 #endif
 
@@ -874,10 +1853,20 @@ int main(int argc, char* argv[]) {
         std::string format = "wav";  // default format
         int sample_rate = 48000;
         int channels = 1;
-        int compression_level = 5;  // FLAC compression level (0-8)
+        int compression_level = 5;   // FLAC compression level (0-8)
+        int opus_kbps = 32;          // Opus bitrate (kb/s)
+        int write_buffer_ms = 2000;  // Audio queued for the file writer thread
+        int segment_s = 0;           // New file every N seconds (0 = one file)
+        int segment_mb = 0;          // New file every N MB (0 = one file)
+        int buffer_frames = 256;     // Frames per capture callback (0 = PortAudio chooses)
+        float latency_ms = 0.0f;     // Suggested input latency (0 = device low-latency default)
+        bool realtime = false;       // Real-time priority for the capture thread
+        std::string capture_cpus;    // Cores for the capture thread (empty = any)
+        std::string worker_cpus;     // Cores for writer/caption threads (empty = see below)
 
         // Audio processing options
         bool enable_normalize = false;
+        bool enable_limiter = false;
         bool enable_highpass = false;
         float highpass_freq = 80.0f;  // Default 80 Hz
 #ifdef ENABLE_RNNOISE
@@ -887,6 +1876,7 @@ int main(int argc, char* argv[]) {
 #ifdef ENABLE_WHISPER
         bool live_captions = false;
         int partial_interval_ms = 500;
+        std::string captions_file;
 #endif
 
         // Simple argument parsing
@@ -901,6 +1891,12 @@ int main(int argc, char* argv[]) {
             } else if (arg == "--normalize") {
                 enable_normalize = true;
                 continue;
+            } else if (arg == "--limiter") {
+                enable_limiter = true;
+                continue;
+            } else if (arg == "--realtime") {
+                realtime = true;
+                continue;
             }
 #ifdef ENABLE_RNNOISE
             else if (arg == "--rnnoise") {
@@ -957,6 +1953,42 @@ int main(int argc, char* argv[]) {
                     return EXIT_BAD_ARGS;
                 }
                 ++i;
+            } else if (arg == "--bitrate") {
+                if (!parse_int_arg(value, arg, opus_kbps)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--write-buffer") {
+                if (!parse_int_arg(value, arg, write_buffer_ms)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--segment") {
+                if (!parse_int_arg(value, arg, segment_s)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--segment-mb") {
+                if (!parse_int_arg(value, arg, segment_mb)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--buffer-frames") {
+                if (!parse_int_arg(value, arg, buffer_frames)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--latency-ms") {
+                if (!parse_float_arg(value, arg, latency_ms)) {
+                    return EXIT_BAD_ARGS;
+                }
+                ++i;
+            } else if (arg == "--capture-cpus") {
+                capture_cpus = value;
+                ++i;
+            } else if (arg == "--worker-cpus") {
+                worker_cpus = value;
+                ++i;
             } else if (arg == "--highpass") {
                 if (!parse_float_arg(value, arg, highpass_freq)) {
                     return EXIT_BAD_ARGS;
@@ -969,6 +2001,9 @@ int main(int argc, char* argv[]) {
                     return EXIT_BAD_ARGS;
                 }
                 ++i;
+            } else if (arg == "--captions-out") {
+                captions_file = value;
+                ++i;
 #endif
             } else {
                 emit_error(EXIT_BAD_ARGS, "unknown option: " + arg);
@@ -989,21 +2024,68 @@ int main(int argc, char* argv[]) {
                                           std::to_string(sample_rate) + ")");
             return EXIT_BAD_ARGS;
         }
-        if (channels < 1 || channels > 2) {
-            emit_error(EXIT_BAD_ARGS, "--channels must be 1 (mono) or 2 (stereo) (got " +
+        if (channels < 1 || channels > 8) {
+            emit_error(EXIT_BAD_ARGS, "--channels must be between 1 and 8 (got " +
                                           std::to_string(channels) + ")");
             return EXIT_BAD_ARGS;
         }
+        if (opus_kbps < 6 || opus_kbps > 510) {
+            emit_error(EXIT_BAD_ARGS, "--bitrate must be between 6 and 510 kb/s (got " +
+                                          std::to_string(opus_kbps) + ")");
+            return EXIT_BAD_ARGS;
+        }
         if (compression_level < 0 || compression_level > 8) {
             emit_error(EXIT_BAD_ARGS, "--compression must be between 0 and 8 (got " +
                                           std::to_string(compression_level) + ")");
             return EXIT_BAD_ARGS;
         }
+        if (write_buffer_ms < 10 || write_buffer_ms > 60000) {
+            emit_error(EXIT_BAD_ARGS, "--write-buffer must be between 10 and 60000 ms (got " +
+                                          std::to_string(write_buffer_ms) + ")");
+            return EXIT_BAD_ARGS;
+        }
         if (duration < 0) {
             emit_error(EXIT_BAD_ARGS,
                        "--duration must be >= 0 (got " + std::to_string(duration) + ")");
             return EXIT_BAD_ARGS;
         }
+        if (segment_s < 0 || segment_mb < 0 || segment_mb > 4000) {
+            emit_error(EXIT_BAD_ARGS, "--segment must be >= 0 and --segment-mb between 0 and 4000");
+            return EXIT_BAD_ARGS;
+        }
+        if (buffer_frames < 0 || buffer_frames > 8192) {
+            emit_error(EXIT_BAD_ARGS, "--buffer-frames must be between 0 and 8192 (got " +
+                                          std::to_string(buffer_frames) + ")");
+            return EXIT_BAD_ARGS;
+        }
+        if (latency_ms < 0.0f || latency_ms > 1000.0f) {
+            emit_error(EXIT_BAD_ARGS, "--latency-ms must be between 0 and 1000");
+            return EXIT_BAD_ARGS;
+        }
+        ffvoice::ThreadPolicy capture_policy;
+        ffvoice::ThreadPolicy worker_policy;
+        if (realtime) {
+            capture_policy.priority = ffvoice::ThreadPriority::RealTime;
+        }
+        if (!capture_cpus.empty() && !ffvoice::ParseCpuList(capture_cpus, capture_policy.cpus)) {
+            emit_error(EXIT_BAD_ARGS, "--capture-cpus must be a core list like 0 or 0-1,4 (got " +
+                                          capture_cpus + ")");
+            return EXIT_BAD_ARGS;
+        }
+        if (!worker_cpus.empty()) {
+            if (!ffvoice::ParseCpuList(worker_cpus, worker_policy.cpus)) {
+                emit_error(EXIT_BAD_ARGS, "--worker-cpus must be a core list like 2-7 (got " +
+                                              worker_cpus + ")");
+                return EXIT_BAD_ARGS;
+            }
+        } else if (!capture_policy.cpus.empty()) {
+            // Keep writer and inference threads off the capture cores
+            worker_policy.cpus = ffvoice::CpusExcept(capture_policy.cpus);
+        }
+        if ((segment_s > 0 || segment_mb > 0) && output_file == "-") {
+            emit_error(EXIT_BAD_ARGS, "--segment/--segment-mb need a file output, not stdout");
+            return EXIT_BAD_ARGS;
+        }
         if (device_id < -1) {
             emit_error(EXIT_BAD_ARGS, "--device must be >= 0, or -1 for the default device (got " +
                                           std::to_string(device_id) + ")");
@@ -1018,20 +2100,34 @@ int main(int argc, char* argv[]) {
         }
 
         // Auto-detect format from file extension if not specified explicitly
-        if (format == "wav" && output_file.size() > 5 &&
-            output_file.substr(output_file.size() - 5) == ".flac") {
+        const auto has_extension = [&](const std::string& ext) {
+            return output_file.size() > ext.size() &&
+                   output_file.compare(output_file.size() - ext.size(), ext.size(), ext) == 0;
+        };
+        if (format == "wav" && has_extension(".flac")) {
             format = "flac";
+        } else if (format == "wav" &&
+                   (has_extension(".opus") || has_extension(".ogg") || has_extension(".webm"))) {
+            format = "opus";
+        }
+        if (format == "opus" && !ffvoice::OpusWriter::IsSupportedSampleRate(sample_rate)) {
+            emit_error(EXIT_BAD_ARGS,
+                       "Opus needs --sample-rate 8000, 12000, 16000, 24000 or 48000 (got " +
+                           std::to_string(sample_rate) + ")");
+            return EXIT_BAD_ARGS;
         }
 
         return record_audio(device_id, duration, output_file, sample_rate, channels, format,
-                            compression_level, enable_normalize, enable_highpass, highpass_freq
+                            compression_level, opus_kbps, enable_normalize, enable_highpass,
+                            highpass_freq, enable_limiter, write_buffer_ms, segment_s,
+                            segment_mb, buffer_frames, latency_ms, capture_policy, worker_policy
 #ifdef ENABLE_RNNOISE
                             ,
                             enable_rnnoise, rnnoise_vad
 #endif
 #ifdef ENABLE_WHISPER
                             ,
-                            live_captions, partial_interval_ms
+                            live_captions, partial_interval_ms, captions_file
 #endif
         );
     }
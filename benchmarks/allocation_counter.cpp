@@ -0,0 +1,35 @@
+/**
+ * @file allocation_counter.cpp
+ * @brief Counting replacement of the global operator new
+ */
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace ffvoice {
+namespace bench {
+
+std::atomic<uint64_t> g_allocations{0};
+
+}  // namespace bench
+}  // namespace ffvoice
+
+// Out of line so GCC does not pair the inlined malloc/free with new/delete
+// call sites and raise -Wmismatched-new-delete
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    ffvoice::bench::g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
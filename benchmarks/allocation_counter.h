@@ -0,0 +1,40 @@
+/**
+ * @file allocation_counter.h
+ * @brief Heap-allocation counter shared by the benchmarks
+ *
+ * allocation_counter.cpp replaces the global operator new, so every
+ * allocation made anywhere in the benchmark binary is counted.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+
+namespace ffvoice {
+namespace bench {
+
+/// Allocations made through operator new since the process started
+extern std::atomic<uint64_t> g_allocations;
+
+/// Count allocations across the timed loop and report them as "allocs_per_iter"
+class AllocationScope {
+public:
+    explicit AllocationScope(benchmark::State& state)
+        : state_(state), start_(g_allocations.load(std::memory_order_relaxed)) {
+    }
+
+    ~AllocationScope() {
+        const uint64_t count = g_allocations.load(std::memory_order_relaxed) - start_;
+        state_.counters["allocs_per_iter"] =
+            benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state_;
+    const uint64_t start_;
+};
+
+}  // namespace bench
+}  // namespace ffvoice
@@ -6,46 +6,119 @@
 #ifdef ENABLE_WHISPER
 
 #include "utils/audio_converter.h"
+#include "utils/audio_kernels.h"
+#include "utils/polyphase_resampler.h"
 #include "utils/signal_generator.h"
 #include "media/wav_writer.h"
 
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <cstdio>
 
 using namespace ffvoice;
 
 // =============================================================================
-// Audio Conversion Benchmarks
+// Audio Conversion Benchmarks (one run per ISA compiled in and supported)
 // =============================================================================
 
+namespace {
+
+// Args: samples (or frames) per call, SimdLevel. Only ISAs this CPU runs are added.
+void ConversionArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "isa"});
+    for (int64_t n : {480, 1024, 4096, 16000, 48000}) {
+        for (SimdLevel level :
+             {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+            if (GetAudioKernels(level)) {
+                b->Args({n, static_cast<int64_t>(level)});
+            }
+        }
+    }
+}
+
+const AudioKernels& KernelsFor(benchmark::State& state) {
+    const AudioKernels& kernels = *GetAudioKernels(static_cast<SimdLevel>(state.range(1)));
+    state.SetLabel(kernels.name);
+    return kernels;
+}
+
+// Run @p call in the benchmark loop and report its speedup over @p scalar_call
+template <typename Call, typename ScalarCall>
+void RunWithSpeedup(benchmark::State& state, Call call, ScalarCall scalar_call) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int kScalarReps = 100;
+    scalar_call();  // Warm up caches
+    const auto scalar_start = Clock::now();
+    for (int i = 0; i < kScalarReps; ++i) {
+        scalar_call();
+        benchmark::ClobberMemory();
+    }
+    const double scalar_ns =
+        std::chrono::duration<double, std::nano>(Clock::now() - scalar_start).count() /
+        kScalarReps;
+
+    const auto start = Clock::now();
+    for (auto _ : state) {
+        call();
+        benchmark::ClobberMemory();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                      static_cast<double>(state.iterations());
+    state.counters["speedup_vs_scalar"] = ns > 0.0 ? scalar_ns / ns : 0.0;
+}
+
+}  // namespace
+
 static void BM_AudioConverter_Int16ToFloat(benchmark::State& state) {
     const size_t num_samples = state.range(0);
+    const AudioKernels& kernels = KernelsFor(state);
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
     SignalGenerator generator;
     std::vector<int16_t> int_samples = generator.GenerateSineWave(440.0,
         static_cast<double>(num_samples) / 16000, 16000, 0.5);
     std::vector<float> float_samples(num_samples);
 
-    for (auto _ : state) {
-        AudioConverter::Int16ToFloat(int_samples.data(), num_samples, float_samples.data());
-        benchmark::DoNotOptimize(float_samples.data());
-    }
+    RunWithSpeedup(
+        state,
+        [&]() { kernels.int16_to_float(int_samples.data(), num_samples, float_samples.data()); },
+        [&]() { scalar.int16_to_float(int_samples.data(), num_samples, float_samples.data()); });
 
     state.SetItemsProcessed(state.iterations() * num_samples);
     state.SetBytesProcessed(state.iterations() * num_samples * sizeof(int16_t));
 }
 
-BENCHMARK(BM_AudioConverter_Int16ToFloat)
-    ->Arg(480)
-    ->Arg(1024)
-    ->Arg(4096)
-    ->Arg(16000)   // 1 second @ 16kHz
-    ->Arg(48000)   // 1 second @ 48kHz
-    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AudioConverter_Int16ToFloat)->Apply(ConversionArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_AudioConverter_FloatToInt16(benchmark::State& state) {
+    const size_t num_samples = state.range(0);
+    const AudioKernels& kernels = KernelsFor(state);
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    std::vector<float> float_samples(num_samples);
+    std::vector<int16_t> int_samples(num_samples);
+
+    for (size_t i = 0; i < num_samples; ++i) {
+        // Overdriven sine, so part of the signal is clamped
+        float_samples[i] = static_cast<float>(1.2 * std::sin(2.0 * M_PI * 440.0 * i / 16000));
+    }
+
+    RunWithSpeedup(
+        state,
+        [&]() { kernels.float_to_int16(float_samples.data(), num_samples, int_samples.data()); },
+        [&]() { scalar.float_to_int16(float_samples.data(), num_samples, int_samples.data()); });
+
+    state.SetItemsProcessed(state.iterations() * num_samples);
+    state.SetBytesProcessed(state.iterations() * num_samples * sizeof(float));
+}
+
+BENCHMARK(BM_AudioConverter_FloatToInt16)->Apply(ConversionArgs)->Unit(benchmark::kMicrosecond);
 
 static void BM_AudioConverter_StereoToMono(benchmark::State& state) {
     const size_t num_frames = state.range(0);
     const size_t num_samples = num_frames * 2;  // Stereo
+    const AudioKernels& kernels = KernelsFor(state);
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
     std::vector<float> stereo_samples(num_samples);
     std::vector<float> mono_samples(num_frames);
 
@@ -55,21 +128,48 @@ static void BM_AudioConverter_StereoToMono(benchmark::State& state) {
         stereo_samples[i + 1] = static_cast<float>(i + 1) / num_samples;  // Right
     }
 
-    for (auto _ : state) {
-        AudioConverter::StereoToMono(stereo_samples.data(), num_frames, mono_samples.data());
-        benchmark::DoNotOptimize(mono_samples.data());
-    }
+    RunWithSpeedup(
+        state,
+        [&]() { kernels.stereo_to_mono(stereo_samples.data(), num_frames, mono_samples.data()); },
+        [&]() { scalar.stereo_to_mono(stereo_samples.data(), num_frames, mono_samples.data()); });
 
     state.SetItemsProcessed(state.iterations() * num_frames);
     state.SetBytesProcessed(state.iterations() * num_samples * sizeof(float));
 }
 
-BENCHMARK(BM_AudioConverter_StereoToMono)
-    ->Arg(480)
-    ->Arg(1024)
-    ->Arg(4096)
-    ->Arg(16000)
-    ->Arg(48000)
+BENCHMARK(BM_AudioConverter_StereoToMono)->Apply(ConversionArgs)->Unit(benchmark::kMicrosecond);
+
+// Fused int16 stereo -> float mono; the speedup is against the scalar two-step path
+static void BM_AudioConverter_Int16StereoToMono(benchmark::State& state) {
+    const size_t num_frames = state.range(0);
+    const size_t num_samples = num_frames * 2;
+    const AudioKernels& kernels = KernelsFor(state);
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    std::vector<int16_t> stereo_int16(num_samples);
+    std::vector<float> stereo_float(num_samples);
+    std::vector<float> mono_samples(num_frames);
+
+    for (size_t i = 0; i < num_samples; ++i) {
+        stereo_int16[i] = static_cast<int16_t>(
+            16000.0 * std::sin(2.0 * M_PI * 440.0 * (i / 2) / 48000));
+    }
+
+    RunWithSpeedup(
+        state,
+        [&]() {
+            kernels.int16_stereo_to_mono(stereo_int16.data(), num_frames, mono_samples.data());
+        },
+        [&]() {
+            scalar.int16_to_float(stereo_int16.data(), num_samples, stereo_float.data());
+            scalar.stereo_to_mono(stereo_float.data(), num_frames, mono_samples.data());
+        });
+
+    state.SetItemsProcessed(state.iterations() * num_frames);
+    state.SetBytesProcessed(state.iterations() * num_samples * sizeof(int16_t));
+}
+
+BENCHMARK(BM_AudioConverter_Int16StereoToMono)
+    ->Apply(ConversionArgs)
     ->Unit(benchmark::kMicrosecond);
 
 static void BM_AudioConverter_Resample(benchmark::State& state) {
@@ -102,15 +202,58 @@ BENCHMARK(BM_AudioConverter_Resample)
     ->Arg(48000)   // 1 second @ 48kHz
     ->Unit(benchmark::kMicrosecond);
 
+// Args: input samples per call, input rate (48000 or 44100); output is 16kHz
+static void BM_PolyphaseResampler_Process(benchmark::State& state) {
+    const size_t input_size = state.range(0);
+    const int in_sample_rate = static_cast<int>(state.range(1));
+    const int out_sample_rate = 16000;
+
+    PolyphaseResampler resampler(in_sample_rate, out_sample_rate);
+    std::vector<float> input_samples(input_size);
+    std::vector<float> output_samples(resampler.GetMaxOutputSize(input_size));
+
+    for (size_t i = 0; i < input_size; ++i) {
+        input_samples[i] = std::sin(2.0 * M_PI * 440.0 * i / in_sample_rate);
+    }
+
+    for (auto _ : state) {
+        // Streaming: each call continues the previous one, as in live capture
+        size_t written = resampler.Process(input_samples.data(), input_size,
+                                           output_samples.data(), output_samples.size());
+        benchmark::DoNotOptimize(written);
+        benchmark::DoNotOptimize(output_samples.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input_size);
+    state.SetBytesProcessed(state.iterations() * input_size * sizeof(float));
+    state.SetLabel(PolyphaseResampler::GetKernelName());
+}
+
+BENCHMARK(BM_PolyphaseResampler_Process)
+    ->Args({480, 48000})
+    ->Args({4096, 48000})
+    ->Args({48000, 48000})  // 1 second @ 48kHz
+    ->Args({441, 44100})
+    ->Args({44100, 44100})  // 1 second @ 44.1kHz
+    ->Unit(benchmark::kMicrosecond);
+
 // =============================================================================
 // WAV Writer Benchmarks
 // =============================================================================
 
+// Args: {samples, write-behind buffer bytes (0 = write through), direct I/O}.
+// Samples arrive in 256-frame callbacks as on the capture path; Close() (the
+// final flush and header) is timed too, since buffering moves work into it.
 static void BM_WavWriter_WriteSamples(benchmark::State& state) {
     const int sample_rate = 48000;
     const int channels = 1;
     const size_t num_samples = state.range(0);
     const std::string test_file = "/tmp/benchmark_wav.wav";
+    constexpr size_t kCallbackSamples = 256;
+
+    WavWriter::Config config;
+    config.buffer_bytes = static_cast<size_t>(state.range(1));
+    config.direct_io = state.range(2) != 0;
 
     SignalGenerator generator;
     std::vector<int16_t> samples = generator.GenerateSineWave(440.0,
@@ -118,27 +261,34 @@ static void BM_WavWriter_WriteSamples(benchmark::State& state) {
 
     for (auto _ : state) {
         state.PauseTiming();
-        WavWriter writer;
+        WavWriter writer(config);
         writer.Open(test_file, sample_rate, channels, 16);
         state.ResumeTiming();
 
-        writer.WriteSamples(samples);
+        for (size_t pos = 0; pos < samples.size(); pos += kCallbackSamples) {
+            writer.WriteSamples(samples.data() + pos,
+                                std::min(kCallbackSamples, samples.size() - pos));
+        }
+        writer.Close();
 
         state.PauseTiming();
-        writer.Close();
         std::remove(test_file.c_str());
         state.ResumeTiming();
     }
 
+    const double bytes = static_cast<double>(state.iterations()) * num_samples * sizeof(int16_t);
     state.SetItemsProcessed(state.iterations() * num_samples);
-    state.SetBytesProcessed(state.iterations() * num_samples * sizeof(int16_t));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["MB/s"] = benchmark::Counter(bytes / 1e6, benchmark::Counter::kIsRate);
 }
 
 BENCHMARK(BM_WavWriter_WriteSamples)
-    ->Arg(480)
-    ->Arg(1024)
-    ->Arg(4096)
-    ->Arg(48000)
+    ->Args({48000, 0, 0})       // 1 second, one write per callback
+    ->Args({48000, 65536, 0})   // 1 second, default buffer
+    ->Args({480000, 0, 0})      // 10 seconds
+    ->Args({480000, 65536, 0})
+    ->Args({480000, 262144, 0})
+    ->Args({480000, 262144, 1})  // O_DIRECT
     ->Unit(benchmark::kMicrosecond);
 
 // =============================================================================
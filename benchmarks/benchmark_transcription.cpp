@@ -0,0 +1,225 @@
+/**
+ * @file benchmark_transcription.cpp
+ * @brief Heap-allocation benchmarks for the transcription hot path
+ *
+ * Every benchmark reports an "allocs_per_iter" counter (see allocation_counter.h).
+ */
+
+#include "allocation_counter.h"
+#include "audio/diarizer.h"
+#include "audio/whisper_processor.h"
+#include "utils/word_grouper.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef ENABLE_WHISPER
+#include "utils/signal_generator.h"
+#endif
+
+using namespace ffvoice;
+using ffvoice::bench::AllocationScope;
+
+namespace {
+
+// Tokens of a typical English sentence: short BPE pieces, some continuing a word
+std::vector<WordToken> MakeTokens(size_t num_words) {
+    static const char* const kPieces[] = {" the", " qu", "ick", " brown", " fox", " jump", "ed"};
+    std::vector<WordToken> tokens;
+    for (size_t i = 0; tokens.size() < num_words * 3 / 2; ++i) {
+        const int64_t t = static_cast<int64_t>(i) * 120;
+        tokens.push_back(WordToken{kPieces[i % 7], t, t + 120, 0.9f});
+    }
+    return tokens;
+}
+
+}  // namespace
+
+// =============================================================================
+// Word grouping
+// =============================================================================
+
+static void BM_GroupTokensIntoWords_Returning(benchmark::State& state) {
+    const std::vector<WordToken> tokens = MakeTokens(static_cast<size_t>(state.range(0)));
+
+    AllocationScope allocations(state);
+    for (auto _ : state) {
+        std::vector<Word> words = GroupTokensIntoWords(tokens);
+        benchmark::DoNotOptimize(words.data());
+    }
+}
+
+BENCHMARK(BM_GroupTokensIntoWords_Returning)->Arg(8)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+static void BM_GroupTokensIntoWords_InPlace(benchmark::State& state) {
+    const std::vector<WordToken> tokens = MakeTokens(static_cast<size_t>(state.range(0)));
+    std::vector<Word> words;
+    GroupTokensIntoWords(tokens, words);  // Warm up
+
+    AllocationScope allocations(state);
+    for (auto _ : state) {
+        GroupTokensIntoWords(tokens, words);
+        benchmark::DoNotOptimize(words.data());
+    }
+}
+
+BENCHMARK(BM_GroupTokensIntoWords_InPlace)->Arg(8)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+// =============================================================================
+// Segment output: fresh vector vs. reused arena
+// =============================================================================
+
+// The same fill ExtractSegments does for each decoded segment
+static void FillSegment(TranscriptionSegment& segment, const std::string& text,
+                        const std::vector<WordToken>& tokens, int64_t t0) {
+    segment.start_ms = t0;
+    segment.end_ms = t0 + 3000;
+    segment.text.assign(text);
+    GroupTokensIntoWords(tokens, segment.words);
+}
+
+static void BM_SegmentOutput_Vector(benchmark::State& state) {
+    const size_t num_segments = static_cast<size_t>(state.range(0));
+    const std::string text(" The quick brown fox jumped over the lazy dog near the river bank.");
+    const std::vector<WordToken> tokens = MakeTokens(12);
+    std::vector<TranscriptionSegment> segments;
+
+    AllocationScope allocations(state);
+    for (auto _ : state) {
+        segments.clear();
+        for (size_t i = 0; i < num_segments; ++i) {
+            TranscriptionSegment segment;
+            FillSegment(segment, text, tokens, static_cast<int64_t>(i) * 3000);
+            segments.push_back(segment);
+        }
+        benchmark::DoNotOptimize(segments.data());
+    }
+}
+
+BENCHMARK(BM_SegmentOutput_Vector)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond);
+
+static void BM_SegmentOutput_Arena(benchmark::State& state) {
+    const size_t num_segments = static_cast<size_t>(state.range(0));
+    const std::string text(" The quick brown fox jumped over the lazy dog near the river bank.");
+    const std::vector<WordToken> tokens = MakeTokens(12);
+    TranscriptionArena arena;
+
+    auto fill = [&]() {
+        arena.clear();
+        for (size_t i = 0; i < num_segments; ++i) {
+            FillSegment(arena.Append(), text, tokens, static_cast<int64_t>(i) * 3000);
+        }
+    };
+    fill();  // Warm up
+
+    AllocationScope allocations(state);
+    for (auto _ : state) {
+        fill();
+        benchmark::DoNotOptimize(arena.begin());
+    }
+}
+
+BENCHMARK(BM_SegmentOutput_Arena)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond);
+
+// =============================================================================
+// Speaker merge
+// =============================================================================
+
+// A meeting transcript: 3 s segments of 8 words, speaker turns of 2-9 s
+static void MakeMeeting(size_t num_segments, std::vector<TranscriptionSegment>& segments,
+                        std::vector<SpeakerSegment>& speakers) {
+    segments.clear();
+    speakers.clear();
+    for (size_t i = 0; i < num_segments; ++i) {
+        const int64_t t0 = static_cast<int64_t>(i) * 3000;
+        TranscriptionSegment segment(t0, t0 + 3000, " text", 0.9f);
+        for (int64_t w = 0; w < 8; ++w) {
+            segment.words.emplace_back(t0 + w * 375, t0 + w * 375 + 300, " word", 0.9f);
+        }
+        segments.push_back(segment);
+    }
+    const int64_t end = static_cast<int64_t>(num_segments) * 3000;
+    for (int64_t t = 0, turn = 0; t < end; ++turn) {
+        const int64_t length = 2000 + (turn * 7919) % 7000;
+        speakers.emplace_back(t, t + length, static_cast<int32_t>(turn % 4));
+        t += length;
+    }
+}
+
+static void BM_MergeIntoSegments(benchmark::State& state) {
+    std::vector<TranscriptionSegment> segments;
+    std::vector<SpeakerSegment> speakers;
+    MakeMeeting(static_cast<size_t>(state.range(0)), segments, speakers);
+
+    for (auto _ : state) {
+        MergeIntoSegments(segments, speakers);
+        benchmark::DoNotOptimize(segments.data());
+    }
+    state.counters["speaker_segments"] = static_cast<double>(speakers.size());
+}
+
+BENCHMARK(BM_MergeIntoSegments)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// The previous implementation: every speaker segment for every segment (O(S x T))
+static void BM_MergeIntoSegments_Exhaustive(benchmark::State& state) {
+    std::vector<TranscriptionSegment> segments;
+    std::vector<SpeakerSegment> speakers;
+    MakeMeeting(static_cast<size_t>(state.range(0)), segments, speakers);
+
+    for (auto _ : state) {
+        for (auto& seg : segments) {
+            int64_t best_overlap = 0;
+            for (const auto& sp : speakers) {
+                const int64_t overlap =
+                    std::min(seg.end_ms, sp.end_ms) - std::max(seg.start_ms, sp.start_ms);
+                if (overlap > best_overlap) {
+                    best_overlap = overlap;
+                    seg.speaker_id = sp.speaker_id;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(segments.data());
+    }
+}
+
+BENCHMARK(BM_MergeIntoSegments_Exhaustive)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// End-to-end TranscribeBuffer (needs a model)
+// =============================================================================
+
+#ifdef ENABLE_WHISPER
+
+// Counts include whisper.cpp's own allocations inside whisper_full; compare
+// against the ffvoice-only benchmarks above to see what the wrapper adds.
+static void BM_WhisperProcessor_TranscribeBuffer_Arena(benchmark::State& state) {
+    WhisperConfig config;
+    config.print_progress = false;
+    config.word_timestamps = true;
+    config.input_sample_rate = 16000;
+    WhisperProcessor processor(config);
+    if (!processor.Initialize()) {
+        state.SkipWithError("Whisper model not available (set WHISPER_MODEL_PATH)");
+        return;
+    }
+
+    SignalGenerator generator;
+    const std::vector<int16_t> samples = generator.GenerateSineWave(440.0, 2.0, 16000, 0.3);
+    TranscriptionArena arena;
+    processor.TranscribeBuffer(samples.data(), samples.size(), arena);  // Warm up
+
+    AllocationScope allocations(state);
+    for (auto _ : state) {
+        processor.TranscribeBuffer(samples.data(), samples.size(), arena);
+        benchmark::DoNotOptimize(arena.begin());
+    }
+}
+
+BENCHMARK(BM_WhisperProcessor_TranscribeBuffer_Arena)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,232 @@
+/**
+ * @file benchmark_whisper.cpp
+ * @brief Performance benchmarks for the ASR path (WhisperProcessor, LiveCaptioner)
+ *
+ * The WhisperProcessor benchmarks need ggml model files. They look for
+ * ggml-<type>.bin in $FFVOICE_BENCH_MODEL_DIR, or else next to the model that
+ * CMake downloaded (WHISPER_MODEL_PATH). Model types that are not found are
+ * skipped. The LiveCaptioner benchmark uses a synthetic transcribe_fn and
+ * needs no model.
+ */
+
+#ifdef ENABLE_WHISPER
+
+#include "audio/live_captioner.h"
+#include "audio/whisper_processor.h"
+#include "utils/signal_generator.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+std::string ResolveModelPath(WhisperModelType type) {
+    std::filesystem::path dir;
+    if (const char* env = std::getenv("FFVOICE_BENCH_MODEL_DIR")) {
+        dir = env;
+    } else {
+#ifdef WHISPER_MODEL_PATH
+        dir = std::filesystem::path(WHISPER_MODEL_PATH).parent_path();
+#endif
+    }
+    const std::filesystem::path path =
+        dir / ("ggml-" + WhisperProcessor::GetModelTypeName(type) + ".bin");
+    return std::filesystem::exists(path) ? path.string() : std::string();
+}
+
+// Nearest-rank percentile of an unsorted sample set (p in [0, 100])
+double Percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(values.size() - 1));
+    return values[rank];
+}
+
+}  // namespace
+
+// =============================================================================
+// WhisperProcessor Benchmarks
+// =============================================================================
+
+// Args: model type, whisper.cpp threads
+static void BM_WhisperProcessor_TranscribeBuffer(benchmark::State& state) {
+    const auto model_type = static_cast<WhisperModelType>(state.range(0));
+    const int n_threads = static_cast<int>(state.range(1));
+
+    WhisperConfig config;
+    config.model_path = ResolveModelPath(model_type);
+    config.model_type = model_type;
+    config.n_threads = n_threads;
+    config.print_progress = false;
+    config.enable_performance_metrics = true;
+    config.input_sample_rate = 48000;
+    if (config.model_path.empty()) {
+        state.SkipWithError("Model file not found (set FFVOICE_BENCH_MODEL_DIR)");
+        return;
+    }
+
+    WhisperProcessor processor(config);
+    if (!processor.Initialize()) {
+        state.SkipWithError("Failed to load model");
+        return;
+    }
+
+    // 5 s at 48 kHz (the live capture rate), so conversion includes resampling
+    const std::vector<int16_t> audio = SignalGenerator::GenerateSineWave(440.0, 5.0, 48000, 0.5);
+    TranscriptionArena arena;
+
+    double convert_ms = 0.0;
+    double inference_ms = 0.0;
+    double extract_ms = 0.0;
+    double rtf = 0.0;
+    for (auto _ : state) {
+        if (!processor.TranscribeBuffer(audio.data(), audio.size(), arena)) {
+            state.SkipWithError("Transcription failed");
+            return;
+        }
+        const WhisperPerformanceMetrics& metrics = processor.GetLastPerformanceMetrics();
+        convert_ms += metrics.convert_ms;
+        inference_ms += metrics.inference_ms;
+        extract_ms += metrics.extract_ms;
+        rtf += metrics.realtime_factor;
+    }
+
+    constexpr auto kAvg = benchmark::Counter::kAvgIterations;
+    state.counters["convert_ms"] = benchmark::Counter(convert_ms, kAvg);
+    state.counters["inference_ms"] = benchmark::Counter(inference_ms, kAvg);
+    state.counters["extract_ms"] = benchmark::Counter(extract_ms, kAvg);
+    state.counters["RTF"] = benchmark::Counter(rtf, kAvg);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(audio.size()));
+}
+
+BENCHMARK(BM_WhisperProcessor_TranscribeBuffer)
+    ->ArgNames({"model", "threads"})
+    ->ArgsProduct({{static_cast<int64_t>(WhisperModelType::TINY),
+                    static_cast<int64_t>(WhisperModelType::BASE),
+                    static_cast<int64_t>(WhisperModelType::SMALL)},
+                   {1, 2, 4, 8}})
+    ->Iterations(3)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// LiveCaptioner Benchmarks
+// =============================================================================
+
+// Feeds utterances (speech then silence) at a multiple of realtime into a
+// captioner whose transcribe_fn sleeps to simulate decode cost. Latency is
+// measured from feeding the last speech sample of an utterance to its Final
+// callback, so it includes the VAD silence hangover (fed at the same speedup).
+//
+// Args: simulated decode cost (ms per second of audio), feed speed (x realtime)
+static void BM_LiveCaptioner_FeedToFinal(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+
+    const double cost_ms_per_s = static_cast<double>(state.range(0));
+    const double speedup = static_cast<double>(state.range(1));
+    constexpr int kSampleRate = 48000;
+    constexpr size_t kChunk = 480;  // 10 ms, a typical audio callback
+    constexpr int kUtterances = 10;
+
+    const std::vector<int16_t> speech =
+        SignalGenerator::GenerateSineWave(440.0, 1.0, kSampleRate, 0.5);
+    const std::vector<int16_t> silence = SignalGenerator::GenerateSilence(0.6, kSampleRate);
+    const auto chunk_period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(kChunk) / kSampleRate / speedup));
+
+    std::vector<double> latencies_ms;
+    uint64_t overrun_samples = 0;
+    uint64_t dropped_partials = 0;
+    uint64_t missing_finals = 0;
+
+    for (auto _ : state) {
+        LiveCaptionerConfig config;
+        config.sample_rate = kSampleRate;
+        config.vad.min_speech_frames = 2;   // VAD frames are 100 ms ingest batches
+        config.vad.min_silence_frames = 3;
+        config.transcribe_fn = [cost_ms_per_s](const int16_t*, size_t count,
+                                               std::vector<TranscriptionSegment>& out) {
+            // The seam sees Whisper-format audio (16 kHz mono)
+            const double audio_s = static_cast<double>(count) / 16000.0;
+            std::this_thread::sleep_for(
+                std::chrono::duration<double, std::milli>(audio_s * cost_ms_per_s));
+            out.clear();
+            out.emplace_back(0, static_cast<int64_t>(audio_s * 1000.0), " synthetic", 0.9f);
+            return true;
+        };
+
+        std::mutex finals_mutex;
+        std::vector<Clock::time_point> final_times;
+        LiveCaptioner captioner(config);
+        captioner.SetCallback([&](const CaptionEvent& event) {
+            if (event.type == CaptionEventType::Final) {
+                std::lock_guard<std::mutex> lock(finals_mutex);
+                final_times.push_back(Clock::now());
+            }
+        });
+        if (!captioner.Initialize() || !captioner.Start()) {
+            state.SkipWithError("LiveCaptioner failed to start");
+            return;
+        }
+
+        // Paced like a capture callback; samples FeedAudio() refuses are overruns
+        auto next_feed = Clock::now();
+        auto feed = [&](const std::vector<int16_t>& block) {
+            for (size_t offset = 0; offset < block.size(); offset += kChunk) {
+                const size_t n = std::min(kChunk, block.size() - offset);
+                overrun_samples += n - captioner.FeedAudio(block.data() + offset, n);
+                next_feed += chunk_period;
+                std::this_thread::sleep_until(next_feed);
+            }
+        };
+
+        std::vector<Clock::time_point> speech_end(kUtterances);
+        for (int u = 0; u < kUtterances; ++u) {
+            feed(speech);
+            speech_end[u] = Clock::now();
+            feed(silence);
+        }
+        captioner.Stop();  // Drains queued Finals
+
+        std::lock_guard<std::mutex> lock(finals_mutex);
+        const size_t matched = std::min<size_t>(final_times.size(), kUtterances);
+        for (size_t i = 0; i < matched; ++i) {
+            latencies_ms.push_back(
+                std::chrono::duration<double, std::milli>(final_times[i] - speech_end[i]).count());
+        }
+        missing_finals += kUtterances - matched;
+        dropped_partials += captioner.GetDroppedPartials();
+    }
+
+    state.counters["final_p50_ms"] = Percentile(latencies_ms, 50.0);
+    state.counters["final_p95_ms"] = Percentile(latencies_ms, 95.0);
+    state.counters["final_p99_ms"] = Percentile(latencies_ms, 99.0);
+    constexpr auto kAvg = benchmark::Counter::kAvgIterations;
+    state.counters["overrun_samples"] =
+        benchmark::Counter(static_cast<double>(overrun_samples), kAvg);
+    state.counters["dropped_partials"] =
+        benchmark::Counter(static_cast<double>(dropped_partials), kAvg);
+    state.counters["missing_finals"] = static_cast<double>(missing_finals);
+}
+
+BENCHMARK(BM_LiveCaptioner_FeedToFinal)
+    ->ArgNames({"cost_ms_per_s", "speedup"})
+    ->Args({50, 4})    // Fast model, comfortably keeping up
+    ->Args({200, 4})   // Finals alone keep the decoder ~80% busy
+    ->Args({200, 8})   // Overloaded: decodes fall behind the feed
+    ->Iterations(2)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+#endif  // ENABLE_WHISPER
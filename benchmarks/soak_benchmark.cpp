@@ -0,0 +1,548 @@
+/**
+ * @file soak_benchmark.cpp
+ * @brief Load / soak test: how many live-caption streams this machine sustains
+ *
+ * Drives N simulated capture streams at wall-clock rate through the real-time
+ * pipeline — AudioProcessorChain → AsyncFileSink (WAV) + LiveCaptioner, every
+ * captioner decoding on one shared InferenceScheduler — and ramps N through
+ * the requested levels. A level is sustained when no audio was dropped, the
+ * feeders kept to the clock and p99 caption latency stayed under the limit;
+ * the ramp stops at the first level that is not.
+ *
+ * Caption latency is measured end to end: from the wall-clock time the last
+ * sample of a speech burst was fed to the time its Final caption arrived, so
+ * it includes the VAD hangover, queueing and decoding.
+ *
+ * The result is one JSON document (stdout or --output FILE) meant to be
+ * tracked across releases:
+ *
+ * @code
+ * {"benchmark":"soak","version":"0.6.0","asr":"whisper","sample_rate":48000,
+ *  "level_seconds":60,"workers":2,"threads_per_worker":4,"max_latency_ms":3000,
+ *  "sustained_streams":8,
+ *  "levels":[{"streams":1,"sustained":true,"audio_s":60.0,"utterances":24,"finals":24,
+ *             "partials":70,"final_latency_ms":{"p50":812,"p99":1405,"max":1490},
+ *             "feed_lag_ms":{"p99":0.4,"max":1.9},"cpu_pct_per_stream":38.2,
+ *             "dropped_samples":0,"sink_dropped_samples":0,"dropped_partials":3,
+ *             "rejected_requests":0},...]}
+ * @endcode
+ *
+ * Usage:
+ *   ffvoice_soak [--model PATH | --simulate-asr RTF] [--streams 1,2,4,8]
+ *                [--duration SEC] [--sample-rate RATE] [--jobs N] [--threads N]
+ *                [--language LANG] [--max-latency-ms MS] [--output FILE]
+ *
+ * --simulate-asr replaces Whisper with a stub that takes RTF seconds per
+ * second of audio, which checks the harness without a model.
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/audio_processor.h"
+    #include "audio/biquad_cascade.h"
+    #include "audio/inference_scheduler.h"
+    #include "audio/live_captioner.h"
+    #include "media/async_file_sink.h"
+    #include "utils/metrics.h"
+    #include "utils/test_signal_generator.h"
+
+    #include <algorithm>
+    #include <atomic>
+    #include <chrono>
+    #include <cmath>
+    #include <cstdint>
+    #include <cstdlib>
+    #include <deque>
+    #include <filesystem>
+    #include <fstream>
+    #include <iomanip>
+    #include <iostream>
+    #include <memory>
+    #include <mutex>
+    #include <sstream>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+    #ifdef _WIN32
+        #include <windows.h>
+    #else
+        #include <sys/resource.h>
+    #endif
+
+using namespace ffvoice;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int kBlockMs = 10;  ///< One simulated capture callback
+
+struct SoakOptions {
+    std::string model_path;
+    double simulate_rtf = 0.0;  ///< > 0: stub decoder instead of Whisper
+    std::vector<int> levels = {1, 2, 4, 8, 16, 32};
+    int duration_s = 60;
+    int sample_rate = 48000;
+    int jobs = 0;
+    int threads = 0;
+    std::string language = "en";
+    int max_latency_ms = 3000;
+    std::string output;  ///< Empty = stdout
+};
+
+/// Process CPU time (user + system) in seconds
+double ProcessCpuSeconds() {
+    #ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto to_seconds = [](const FILETIME& t) {
+        const uint64_t ticks = (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+        return static_cast<double>(ticks) / 1e7;  // 100 ns units
+    };
+    return to_seconds(kernel) + to_seconds(user);
+    #else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    #endif
+}
+
+/**
+ * @brief A loop of speech-like bursts over a low noise floor.
+ *
+ * Each burst is a gliding voiced tone (fundamental plus two harmonics)
+ * amplitude-modulated at a syllable rate, separated by pauses longer than
+ * the VAD hangover so every burst becomes one utterance. @p seed varies the
+ * pitch and timing so streams do not run in lockstep.
+ */
+struct SpeechScript {
+    std::vector<int16_t> samples;
+    std::vector<size_t> burst_ends;  ///< Offset one past the last sample of each burst
+};
+
+SpeechScript MakeSpeechScript(int sample_rate, int seed) {
+    test::TestSignalGenerator gen(static_cast<uint32_t>(sample_rate));
+    SpeechScript script;
+
+    for (int burst = 0; burst < 4; ++burst) {
+        const uint32_t pause_ms = 800 + static_cast<uint32_t>((seed * 7 + burst * 13) % 5) * 100;
+        const uint32_t burst_ms = 1200 + static_cast<uint32_t>((seed * 3 + burst * 11) % 7) * 200;
+        const double f0 = 110.0 + ((seed * 17 + burst * 29) % 9) * 12.0;
+
+        std::vector<int16_t> pause = gen.GenerateSilence(pause_ms);
+        script.samples.insert(script.samples.end(), pause.begin(), pause.end());
+
+        std::vector<int16_t> voiced = gen.MixSignals(
+            {gen.GenerateChirp(f0, f0 * 1.3, burst_ms, 0.6),
+             gen.GenerateChirp(2 * f0, 2.6 * f0, burst_ms, 0.4),
+             gen.GenerateChirp(3 * f0, 3.9 * f0, burst_ms, 0.25)},
+            1.5);
+        for (size_t i = 0; i < voiced.size(); ++i) {
+            const double t = static_cast<double>(i) / sample_rate;
+            const double syllables = 0.55 + 0.45 * std::sin(2.0 * M_PI * 4.0 * t);
+            voiced[i] = static_cast<int16_t>(voiced[i] * syllables);
+        }
+        voiced = gen.ApplyEnvelope(voiced, 30, 50, 0.8, 80);
+        script.samples.insert(script.samples.end(), voiced.begin(), voiced.end());
+        script.burst_ends.push_back(script.samples.size());
+    }
+
+    // Room noise under everything, roughly -50 dBFS
+    const uint32_t total_ms =
+        static_cast<uint32_t>(script.samples.size() * 1000 / static_cast<size_t>(sample_rate));
+    const std::vector<int16_t> noise = gen.GeneratePinkNoise(total_ms, 0.003);
+    for (size_t i = 0; i < std::min(noise.size(), script.samples.size()); ++i) {
+        const int32_t mixed = script.samples[i] + noise[i];
+        script.samples[i] = static_cast<int16_t>(std::clamp(mixed, -32768, 32767));
+    }
+    return script;
+}
+
+/// One simulated capture stream and its share of the pipeline
+struct Stream {
+    SpeechScript script;
+    std::unique_ptr<AudioProcessorChain> chain;
+    std::unique_ptr<AsyncFileSink> sink;
+    std::unique_ptr<LiveCaptioner> captioner;
+    std::thread feeder;
+
+    // Feeder thread only
+    uint64_t fed_samples = 0;
+    uint64_t dropped_samples = 0;
+
+    std::mutex mutex;
+    std::deque<Clock::time_point> pending_ends;  ///< Bursts fed but not yet captioned
+    uint64_t utterances = 0;
+    uint64_t finals = 0;
+    uint64_t partials = 0;
+};
+
+struct LevelResult {
+    int streams = 0;
+    bool sustained = false;
+    double audio_s = 0.0;
+    uint64_t utterances = 0;
+    uint64_t finals = 0;
+    uint64_t partials = 0;
+    HistogramSnapshot final_latency_us;
+    HistogramSnapshot feed_lag_us;
+    double cpu_pct_per_stream = 0.0;
+    uint64_t dropped_samples = 0;
+    uint64_t sink_dropped_samples = 0;
+    uint64_t dropped_partials = 0;
+    uint64_t rejected_requests = 0;
+    std::string error;
+};
+
+/// Simulated capture callback: every 10 ms, process one block and hand it to both consumers
+void FeedStream(Stream& stream, int sample_rate, Clock::time_point start, Clock::time_point end,
+                MetricHistogram& feed_lag_us) {
+    const size_t block = static_cast<size_t>(sample_rate) * kBlockMs / 1000;
+    const std::vector<int16_t>& source = stream.script.samples;
+    std::vector<int16_t> buffer(block);
+    size_t position = 0;
+    size_t next_burst = 0;
+
+    for (Clock::time_point due = start; due < end; due += std::chrono::milliseconds(kBlockMs)) {
+        std::this_thread::sleep_until(due);
+        const auto now = Clock::now();
+        feed_lag_us.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - due).count()));
+
+        const size_t block_start = position;
+        for (size_t i = 0; i < block; ++i) {
+            buffer[i] = source[position];
+            if (++position == source.size()) {
+                position = 0;
+            }
+        }
+        stream.chain->Process(buffer.data(), block);
+        stream.sink->Write(buffer.data(), block);
+        const size_t written = stream.captioner->FeedAudio(buffer.data(), block);
+        stream.dropped_samples += block - written;
+        stream.fed_samples += block;
+
+        // Did this block hold the last sample of the next burst? (The script loops)
+        const size_t last_sample = stream.script.burst_ends[next_burst] - 1;
+        if ((last_sample + source.size() - block_start) % source.size() < block) {
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            stream.pending_ends.push_back(now);
+            ++stream.utterances;
+            next_burst = (next_burst + 1) % stream.script.burst_ends.size();
+        }
+    }
+}
+
+LevelResult RunLevel(const SoakOptions& options, InferenceScheduler& scheduler, int num_streams,
+                     const fs::path& work_dir) {
+    LevelResult result;
+    result.streams = num_streams;
+    MetricHistogram final_latency_us;
+    MetricHistogram feed_lag_us;
+    const InferenceSchedulerStats scheduler_before = scheduler.GetStats();
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (int i = 0; i < num_streams; ++i) {
+        auto stream = std::make_unique<Stream>();
+        stream->script = MakeSpeechScript(options.sample_rate, i);
+
+        // The CLI's --highpass 80 --normalize chain
+        stream->chain = std::make_unique<AudioProcessorChain>();
+        stream->chain->AddProcessor(
+            std::make_unique<BiquadCascade>(BiquadCascade::ButterworthHighPass(80.0f, 4)));
+        stream->chain->AddProcessor(std::make_unique<VolumeNormalizer>());
+        if (!stream->chain->Initialize(options.sample_rate, 1)) {
+            result.error = "processor chain failed to initialize";
+            return result;
+        }
+
+        AsyncFileSink::Config sink_cfg;
+        sink_cfg.sample_rate = options.sample_rate;
+        sink_cfg.channels = 1;
+        sink_cfg.ring_buffer_capacity = static_cast<size_t>(options.sample_rate) * 2;
+        stream->sink = std::make_unique<AsyncFileSink>(sink_cfg);
+        const fs::path wav = work_dir / ("stream_" + std::to_string(i) + ".wav");
+        if (!stream->sink->Open(wav.string())) {
+            result.error = "cannot open " + wav.string();
+            return result;
+        }
+
+        LiveCaptionerConfig cap_cfg;
+        cap_cfg.sample_rate = options.sample_rate;
+        cap_cfg.channels = 1;
+        cap_cfg.scheduler = &scheduler;
+        cap_cfg.whisper.language = options.language;
+        stream->captioner = std::make_unique<LiveCaptioner>(cap_cfg);
+
+        Stream* raw = stream.get();
+        stream->captioner->SetCallback([raw, &final_latency_us](const CaptionEvent& ev) {
+            const auto now = Clock::now();
+            std::lock_guard<std::mutex> lock(raw->mutex);
+            if (ev.type == CaptionEventType::Partial) {
+                ++raw->partials;
+                return;
+            }
+            ++raw->finals;
+            // Finals arrive in utterance order; one that ends no fed burst
+            // (e.g. the flush at Stop()) is not a latency sample
+            if (!raw->pending_ends.empty()) {
+                final_latency_us.Record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - raw->pending_ends.front())
+                        .count()));
+                raw->pending_ends.pop_front();
+            }
+        });
+        if (!stream->captioner->Initialize() || !stream->captioner->Start()) {
+            result.error = "captioner failed: " + stream->captioner->GetLastError();
+            return result;
+        }
+        streams.push_back(std::move(stream));
+    }
+
+    // Feeders start together, a moment from now, and run for the level duration
+    const auto start = Clock::now() + std::chrono::milliseconds(100);
+    const auto end = start + std::chrono::seconds(options.duration_s);
+    const double cpu_before = ProcessCpuSeconds();
+    for (auto& stream : streams) {
+        Stream& s = *stream;
+        s.feeder = std::thread([&s, &options, start, end, &feed_lag_us]() {
+            FeedStream(s, options.sample_rate, start, end, feed_lag_us);
+        });
+    }
+    for (auto& stream : streams) {
+        stream->feeder.join();
+    }
+    // CPU over the real-time window only, not the drain below
+    const double wall_s = std::chrono::duration<double>(Clock::now() - start).count();
+    const double cpu_s = ProcessCpuSeconds() - cpu_before;
+
+    // Stop() flushes each captioner; bursts already fed still get their Finals
+    for (auto& stream : streams) {
+        stream->captioner->Stop();
+        stream->sink->Close();
+    }
+
+    for (auto& stream : streams) {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        result.audio_s += static_cast<double>(stream->fed_samples) / options.sample_rate;
+        result.utterances += stream->utterances;
+        result.finals += stream->finals;
+        result.partials += stream->partials;
+        result.dropped_samples += stream->dropped_samples;
+        result.sink_dropped_samples += stream->sink->GetDroppedSamples();
+        result.dropped_partials += stream->captioner->GetDroppedPartials();
+    }
+    result.audio_s /= num_streams;
+    result.final_latency_us = final_latency_us.GetSnapshot();
+    result.feed_lag_us = feed_lag_us.GetSnapshot();
+    result.cpu_pct_per_stream = wall_s > 0.0 ? 100.0 * cpu_s / wall_s / num_streams : 0.0;
+    result.rejected_requests = scheduler.GetStats().rejected - scheduler_before.rejected;
+
+    // A burst still waiting for its Final after Stop() also means the level fell behind
+    const bool all_captioned = result.final_latency_us.count >= result.utterances;
+    result.sustained = result.dropped_samples == 0 && result.sink_dropped_samples == 0 &&
+                       all_captioned &&
+                       result.final_latency_us.p99 <=
+                           static_cast<uint64_t>(options.max_latency_ms) * 1000 &&
+                       result.feed_lag_us.p99 <= static_cast<uint64_t>(5 * kBlockMs) * 1000;
+    return result;
+}
+
+std::string LevelToJson(const LevelResult& level) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "{\"streams\":" << level.streams
+        << ",\"sustained\":" << (level.sustained ? "true" : "false")
+        << ",\"audio_s\":" << level.audio_s << ",\"utterances\":" << level.utterances
+        << ",\"finals\":" << level.finals << ",\"partials\":" << level.partials
+        << ",\"final_latency_ms\":{\"p50\":" << level.final_latency_us.p50 / 1000
+        << ",\"p99\":" << level.final_latency_us.p99 / 1000
+        << ",\"max\":" << level.final_latency_us.max / 1000 << "}"
+        << ",\"feed_lag_ms\":{\"p99\":" << level.feed_lag_us.p99 / 1000.0
+        << ",\"max\":" << level.feed_lag_us.max / 1000.0 << "}"
+        << ",\"cpu_pct_per_stream\":" << level.cpu_pct_per_stream
+        << ",\"dropped_samples\":" << level.dropped_samples
+        << ",\"sink_dropped_samples\":" << level.sink_dropped_samples
+        << ",\"dropped_partials\":" << level.dropped_partials
+        << ",\"rejected_requests\":" << level.rejected_requests;
+    if (!level.error.empty()) {
+        oss << ",\"error\":\"";
+        for (const char c : level.error) {
+            oss << (c == '"' || c == '\\' ? "\\" : "") << (c == '\n' ? ' ' : c);
+        }
+        oss << "\"";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+bool ParseLevels(const std::string& list, std::vector<int>& levels) {
+    levels.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const int n = std::atoi(item.c_str());
+        if (n <= 0) {
+            return false;
+        }
+        levels.push_back(n);
+    }
+    std::sort(levels.begin(), levels.end());
+    return !levels.empty();
+}
+
+bool ParseArgs(int argc, char** argv, SoakOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--model") {
+            options.model_path = value;
+        } else if (arg == "--simulate-asr") {
+            options.simulate_rtf = std::atof(value.c_str());
+        } else if (arg == "--streams") {
+            if (!ParseLevels(value, options.levels)) {
+                std::cerr << "--streams expects a list like 1,2,4,8\n";
+                return false;
+            }
+        } else if (arg == "--duration") {
+            options.duration_s = std::atoi(value.c_str());
+        } else if (arg == "--sample-rate") {
+            options.sample_rate = std::atoi(value.c_str());
+        } else if (arg == "--jobs") {
+            options.jobs = std::atoi(value.c_str());
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "--language") {
+            options.language = value;
+        } else if (arg == "--max-latency-ms") {
+            options.max_latency_ms = std::atoi(value.c_str());
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (options.duration_s <= 0 || options.sample_rate < 8000 || options.max_latency_ms <= 0) {
+        std::cerr << "--duration, --sample-rate and --max-latency-ms must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    SoakOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--model PATH | --simulate-asr RTF] [--streams 1,2,4,8] [--duration SEC]\n"
+                     "       [--sample-rate RATE] [--jobs N] [--threads N] [--language LANG]\n"
+                     "       [--max-latency-ms MS] [--output FILE]\n";
+        return 2;
+    }
+    InferenceSchedulerConfig scheduler_cfg;
+    scheduler_cfg.whisper.language = options.language;
+    scheduler_cfg.whisper.print_progress = false;
+    if (!options.model_path.empty()) {
+        scheduler_cfg.whisper.model_path = options.model_path;
+    }
+    scheduler_cfg.num_workers = static_cast<size_t>(std::max(0, options.jobs));
+    scheduler_cfg.threads_per_worker = options.threads;
+    if (options.simulate_rtf > 0.0) {
+        const double rtf = options.simulate_rtf;
+        scheduler_cfg.transcribe_fn = [rtf](const int16_t*, size_t num_samples,
+                                            std::vector<TranscriptionSegment>& out) {
+            // 16 kHz in: num_samples / 16 ms of audio
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                static_cast<int64_t>(rtf * static_cast<double>(num_samples) * 1000.0 / 16.0)));
+            out.clear();
+            out.emplace_back(0LL, static_cast<int64_t>(num_samples / 16), " soak", 0.9f);
+            return true;
+        };
+    }
+
+    InferenceScheduler scheduler(scheduler_cfg);
+    if (!scheduler.Start()) {
+        std::cerr << "Failed to start the scheduler: " << scheduler.GetLastError() << "\n";
+        return 1;
+    }
+
+    std::error_code ec;
+    const std::string run_id = std::to_string(Clock::now().time_since_epoch().count());
+    const fs::path work_dir = fs::temp_directory_path() / ("ffvoice_soak_" + run_id);
+    fs::create_directories(work_dir, ec);
+    if (ec) {
+        std::cerr << "Cannot create " << work_dir << ": " << ec.message() << "\n";
+        return 1;
+    }
+
+    std::vector<LevelResult> levels;
+    int sustained_streams = 0;
+    for (const int n : options.levels) {
+        std::cerr << "Soak: " << n << " streams for " << options.duration_s << " s..."
+                  << std::flush;
+        levels.push_back(RunLevel(options, scheduler, n, work_dir));
+        const LevelResult& level = levels.back();
+        fs::remove_all(work_dir, ec);
+        fs::create_directories(work_dir, ec);
+
+        std::cerr << (level.sustained ? " sustained" : " fell behind") << " (p99 final "
+                  << level.final_latency_us.p99 / 1000 << " ms, " << std::fixed
+                  << std::setprecision(1) << level.cpu_pct_per_stream << "% CPU per stream, "
+                  << level.dropped_samples << " samples dropped)\n";
+        if (!level.sustained) {
+            break;
+        }
+        sustained_streams = n;
+    }
+    scheduler.Stop();
+    fs::remove_all(work_dir, ec);
+
+    std::ostringstream json;
+    json << "{\"benchmark\":\"soak\",\"version\":\"" FFVOICE_VERSION "\",\"asr\":\""
+         << (options.simulate_rtf > 0.0 ? "simulated" : "whisper")
+         << "\",\"sample_rate\":" << options.sample_rate
+         << ",\"level_seconds\":" << options.duration_s
+         << ",\"workers\":" << scheduler.GetNumWorkers()
+         << ",\"threads_per_worker\":" << scheduler.GetThreadsPerWorker()
+         << ",\"max_latency_ms\":" << options.max_latency_ms
+         << ",\"sustained_streams\":" << sustained_streams << ",\"levels\":[";
+    for (size_t i = 0; i < levels.size(); ++i) {
+        json << (i > 0 ? "," : "") << LevelToJson(levels[i]);
+    }
+    json << "]}\n";
+
+    if (options.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(options.output);
+        out << json.str();
+        if (!out) {
+            std::cerr << "Cannot write " << options.output << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+    #include <iostream>
+
+int main() {
+    std::cerr << "ffvoice_soak needs a build with -DENABLE_WHISPER=ON\n";
+    return 1;
+}
+
+#endif  // ENABLE_WHISPER
@@ -36,13 +36,19 @@ try:
         AudioDeviceInfo,
         # Enums
         WhisperModelType,
+        WhisperBackend,
+        WhisperQuantization,
         VADSensitivity,
         # Configuration classes
         WhisperConfig,
+        WhisperAcceleration,
+        WhisperResourceBudget,
         VADConfig,
         # Main processing classes
         WhisperASR,
+        WhisperModelCatalog,
         AudioCapture,
+        BufferedCapture,
         VADSegmenter,
         WAVWriter,
         FLACWriter,
@@ -50,6 +56,14 @@ try:
         RingBuffer,
         # Free functions
         merge_into_segments,
+        probe_whisper_capabilities,
+        enable_metrics,
+        metrics_enabled,
+        get_metrics,
+        get_metrics_json,
+        reset_metrics,
+        set_async_logging,
+        flush_log,
     )
 except ImportError as e:
     raise ImportError(
@@ -72,7 +86,9 @@ except ImportError:
 try:
     from ._ffvoice import (  # noqa: F401
         CaptionEvent,
+        CaptionEventStream,
         CaptionEventType,
+        LanguageLockConfig,
         LiveCaptioner,
         LiveCaptionerConfig,
     )
@@ -110,13 +126,19 @@ __all__ = [
     "AudioDeviceInfo",
     # Enums
     "WhisperModelType",
+    "WhisperBackend",
+    "WhisperQuantization",
     "VADSensitivity",
     # Configuration classes
     "WhisperConfig",
+    "WhisperAcceleration",
+    "WhisperResourceBudget",
     "VADConfig",
     # Main processing classes
     "WhisperASR",
+    "WhisperModelCatalog",
     "AudioCapture",
+    "BufferedCapture",
     "VADSegmenter",
     "WAVWriter",
     "FLACWriter",
@@ -128,12 +150,24 @@ __all__ = [
     # LiveCaptioner (conditionally available — only when built with ENABLE_WHISPER=ON)
     "LiveCaptioner",
     "LiveCaptionerConfig",
+    "LanguageLockConfig",
     "CaptionEvent",
+    "CaptionEventStream",
     "CaptionEventType",
     # Speaker diarization
     "merge_into_segments",
+    "probe_whisper_capabilities",
     "HAS_DIARIZATION",
     # Diarizer (conditionally available — only when built with ENABLE_DIARIZATION=ON)
     "Diarizer",
     "DiarizerConfig",
+    # Pipeline metrics
+    "enable_metrics",
+    "metrics_enabled",
+    "get_metrics",
+    "get_metrics_json",
+    "reset_metrics",
+    # Logging
+    "set_async_logging",
+    "flush_log",
 ]
@@ -0,0 +1,88 @@
+"""
+asyncio integration for ``LiveCaptioner.events()``.
+
+The captioner pushes each ``CaptionEvent`` into a lock-free C++ queue from
+its inference thread without touching the GIL.  The queue exposes a
+descriptor (an eventfd on Linux, a pipe on other POSIX systems) that turns
+readable when events arrive, so the iterator below waits on it with
+``loop.add_reader`` — no thread hop per event and no polling.  Where the
+loop cannot watch descriptors (Windows, or a loop without ``add_reader``)
+it falls back to one blocking ``wait()`` in the default executor per batch.
+
+Usage::
+
+    captioner = ffvoice.LiveCaptioner(config)
+    captioner.initialize()
+    events = captioner.events()   # before start()
+    captioner.start()
+    async for event in events:    # ends after captioner.stop()
+        print(event.type, event.text)
+
+This module is stdlib-only and does not import the compiled extension, so
+it can be exercised with a fake stream in tests.
+"""
+
+from __future__ import annotations
+
+import asyncio
+from collections import deque
+from typing import Any, Deque
+
+
+class CaptionEventIterator:
+    """
+    Async iterator over the events of one ``CaptionEventStream``.
+
+    Events are yielded oldest first; iteration stops once the captioner has
+    stopped and every queued event was delivered.  Only one task should
+    iterate a given stream.
+    """
+
+    def __init__(self, stream: Any) -> None:
+        self._stream = stream
+        self._pending: Deque[Any] = deque()
+
+    @property
+    def stream(self) -> Any:
+        """The underlying ``CaptionEventStream`` (for ``get_dropped_events()``)."""
+        return self._stream
+
+    def __aiter__(self) -> "CaptionEventIterator":
+        return self
+
+    async def __anext__(self) -> Any:
+        while not self._pending:
+            # Read closed before draining: every event precedes the close
+            closed = self._stream.closed
+            self._pending.extend(self._stream.drain())
+            if self._pending:
+                break
+            if closed:
+                raise StopAsyncIteration
+            await self._wait_ready()
+        return self._pending.popleft()
+
+    async def _wait_ready(self) -> None:
+        loop = asyncio.get_running_loop()
+        fd = self._stream.fileno()
+        if fd >= 0:
+            ready = loop.create_future()
+
+            def _on_ready() -> None:
+                if not ready.done():
+                    ready.set_result(None)
+
+            try:
+                loop.add_reader(fd, _on_ready)
+            except NotImplementedError:
+                pass  # e.g. ProactorEventLoop: fall through to the executor
+            else:
+                try:
+                    await ready
+                finally:
+                    loop.remove_reader(fd)
+                return
+
+        # wait() releases the GIL; the timeout bounds how long a cancelled
+        # iteration keeps the executor thread
+        await loop.run_in_executor(None, self._stream.wait, 0.5)
@@ -11,6 +11,10 @@ from __future__ import annotations
 from typing import Callable, Optional
 import numpy as np
 
+# 1-D int16 or float32 samples: any C-contiguous buffer is read without a copy
+# (raw bytes are native-endian int16 PCM)
+_PcmBuffer = np.ndarray | bytes | bytearray | memoryview
+
 # ---------------------------------------------------------------------------
 # Enums
 # ---------------------------------------------------------------------------
@@ -24,6 +28,25 @@ class WhisperModelType:
     MEDIUM: WhisperModelType  # ~769 MB, ~1x real-time
     LARGE: WhisperModelType  # ~1550 MB, <1x real-time
 
+class WhisperBackend:
+    """Where whisper.cpp runs the model; see probe_whisper_capabilities()."""
+
+    AUTO: WhisperBackend  # first GPU if available, otherwise CPU
+    CPU: WhisperBackend  # CPU only
+    CUDA: WhisperBackend  # NVIDIA GPU (ENABLE_WHISPER_CUDA)
+    METAL: WhisperBackend  # Apple GPU (ENABLE_WHISPER_METAL)
+    VULKAN: WhisperBackend  # Vulkan GPU (ENABLE_WHISPER_VULKAN)
+    OPENVINO: WhisperBackend  # encoder on an OpenVINO device (ENABLE_WHISPER_OPENVINO)
+    COREML: WhisperBackend  # encoder on the Apple Neural Engine (ENABLE_WHISPER_COREML)
+
+class WhisperQuantization:
+    """Weight format of a GGML model file."""
+
+    F16: WhisperQuantization  # original half-precision weights
+    Q8_0: WhisperQuantization  # 8-bit, near-lossless, ~55% of F16 size
+    Q5_1: WhisperQuantization  # 5-bit with offsets, ~40% of F16 size
+    Q5_0: WhisperQuantization  # 5-bit, ~35% of F16 size (medium / large)
+
 class VADSensitivity:
     """Preset sensitivity levels for VADConfig.from_preset()."""
 
@@ -159,8 +182,176 @@ class WhisperConfig:
     """Populate TranscriptionSegment.words with per-word timing."""
     input_sample_rate: int
     """Sample rate (Hz) of audio passed to transcribe_buffer(). Default: 48000."""
+    initial_prompt: str
+    """Text that conditions decoding (empty = none)."""
+    share_model: bool
+    """Load the model once per process and borrow a decoder state per call. Default: False."""
+    max_shared_states: int
+    """Decoder state pool limit for a shared model (0 = unlimited). Default: 0."""
+    acceleration: WhisperAcceleration
+    """Backend, GPU device and flash attention. Default: AUTO, GPU 0, no flash attention."""
+    use_mmap: bool
+    """Memory-map the model file instead of reading it through stdio. Default: True."""
+    warmup: bool
+    """Run one silent inference during initialize(). Default: False."""
+    cache_dir: str
+    """Reuse transcribe_file() results of unchanged files from this directory (empty = off)."""
+    cache_max_mb: int
+    """Size bound of cache_dir in MiB; least recently used entries are evicted. Default: 256."""
+
+    def __init__(self) -> None: ...
+
+class WhisperAcceleration:
+    """Accelerator options of WhisperConfig.acceleration."""
+
+    backend: WhisperBackend
+    """Backend to run the model on. Default: AUTO."""
+    gpu_device: int
+    """GPU index within the backend (for AUTO, among all GPUs). Default: 0."""
+    flash_attn: bool
+    """Use flash attention in the decoder. Default: False."""
+    openvino_device: str
+    """OpenVINO device for the encoder ('CPU', 'GPU', 'NPU', …). Default: 'CPU'."""
+    openvino_cache_dir: str
+    """Directory for compiled OpenVINO kernels (empty = beside the model)."""
+
+    def __init__(self) -> None: ...
+
+class WhisperDeviceInfo:
+    """A GPU visible to whisper.cpp."""
+
+    backend: WhisperBackend
+    """CUDA, METAL or VULKAN."""
+    index: int
+    """Index among the GPUs of the same backend (WhisperAcceleration.gpu_device)."""
+    name: str
+    """ggml device name, e.g. 'CUDA0'."""
+    description: str
+    """Device description, e.g. 'NVIDIA L4'."""
+    memory_free: int
+    """Free memory in bytes (0 if unknown)."""
+    memory_total: int
+    """Total memory in bytes (0 if unknown)."""
+
+class WhisperCapabilities:
+    """What this build of whisper.cpp can run on, on this machine."""
+
+    backends: list[WhisperBackend]
+    """Usable backends; always includes CPU."""
+    devices: list[WhisperDeviceInfo]
+    """GPUs found, in whisper.cpp's device order."""
+    system_info: str
+    """whisper.cpp system info (CPU features, compiled-in encoders)."""
+
+    def supports(self, backend: WhisperBackend) -> bool:
+        """Return True if *backend* can be selected."""
+        ...
+
+def probe_whisper_capabilities() -> WhisperCapabilities:
+    """
+    List the Whisper backends and GPUs available in this build.
+
+    A backend that is requested explicitly but missing makes
+    WhisperASR.initialize() fail instead of falling back to the CPU.
+    """
+    ...
+
+class WhisperModelVariant:
+    """One downloadable Whisper model file."""
+
+    type: WhisperModelType
+    quantization: WhisperQuantization
+    name: str
+    """Catalog name, e.g. 'small-q5_1' (ffvoice.models.ensure_whisper_model() accepts it)."""
+    filename: str
+    """GGML file name, e.g. 'ggml-small-q5_1.bin'."""
+    file_mb: int
+    """Download size; also the resident weights."""
+    state_mb: int
+    """Per-decode state (KV cache, mel, work buffers)."""
+    relative_cost: float
+    """Compute per second of audio, tiny F16 = 1."""
+
+class WhisperResourceBudget:
+    """What a deployment can afford, for WhisperModelCatalog.select()."""
+
+    max_rtf: float
+    """Highest decode time / audio time per stream (lower = faster). Default: 0.5."""
+    concurrency: int
+    """Streams decoding at the same time. Default: 1."""
+    max_memory_mb: int
+    """Memory for weights plus states in MB (0 = unlimited). Default: 0."""
+    share_model: bool
+    """Weights loaded once for all streams (WhisperConfig.share_model). Default: True."""
+    allow_quantized: bool
+    """Consider q8_0 / q5_x files, not only F16. Default: True."""
+    model_dir: str
+    """If set, only variants whose file exists in this directory."""
+
+    def __init__(self) -> None: ...
+
+class WhisperModelChoice:
+    """Result of WhisperModelCatalog.select()."""
+
+    variant: WhisperModelVariant
+    estimated_rtf: float
+    """Per-stream realtime factor at the budget's concurrency."""
+    estimated_memory_mb: int
+    """Weights and states for all streams."""
+    measured: bool
+    """The estimate comes from calibrating this variant."""
+
+class WhisperModelCatalog:
+    """
+    Whisper model sizes x quantizations with calibrated speed estimates.
+
+    Estimates start from the documented per-size speeds and are rescaled by
+    calibrate() measurements, so calibrating one small model on first run is
+    enough to choose between all of them.
+    """
 
     def __init__(self) -> None: ...
+    def get_variants(self) -> list[WhisperModelVariant]:
+        """Every published variant, smallest size first."""
+        ...
+    def find(self, name: str) -> Optional[WhisperModelVariant]:
+        """Variant by catalog name ('base', 'medium-q5_0', …), or None."""
+        ...
+    def calibrate(
+        self,
+        variant: WhisperModelVariant,
+        model_path: str,
+        config: WhisperConfig = ...,
+        audio_seconds: float = 10.0,
+    ) -> bool:
+        """Decode a synthetic clip with *model_path* and record its realtime factor."""
+        ...
+    def calibrate_smallest_available(
+        self, model_dir: str, config: WhisperConfig = ..., audio_seconds: float = 10.0
+    ) -> bool:
+        """First-run calibration with the cheapest catalog file in *model_dir*."""
+        ...
+    def set_measured_rtf(self, name: str, rtf: float) -> None:
+        """Record a realtime factor measured elsewhere."""
+        ...
+    def is_calibrated(self) -> bool: ...
+    def estimate_rtf(self, variant: WhisperModelVariant) -> float:
+        """Realtime factor (decode time / audio time) of one stream decoding alone."""
+        ...
+    @staticmethod
+    def estimate_memory_mb(
+        variant: WhisperModelVariant, concurrency: int, share_model: bool = True
+    ) -> int: ...
+    def select(self, budget: WhisperResourceBudget) -> WhisperModelChoice:
+        """
+        Pick the largest, least quantized variant that fits *budget*.
+
+        Raises RuntimeError if none does.
+        """
+        ...
+    def load_calibration(self, path: str) -> bool: ...
+    def save_calibration(self, path: str) -> bool: ...
+    def get_last_error(self) -> str: ...
 
 class VADConfig:
     """Configuration for VADSegmenter."""
@@ -212,6 +403,22 @@ class DiarizerConfig:
 # Processing classes
 # ---------------------------------------------------------------------------
 
+class TranscriptionCacheStats:
+    """Counters of the transcription result cache (WhisperASR.get_cache_stats())."""
+
+    hits: int
+    """Lookups answered from the cache."""
+    misses: int
+    """Lookups with no valid entry."""
+    stores: int
+    """Entries written."""
+    evictions: int
+    """Entries deleted to stay under cache_max_mb."""
+    entries: int
+    """Entries currently in the directory (shared with other processes)."""
+    bytes: int
+    """Total size of those entries."""
+
 class WhisperASR:
     """Offline speech recognition using whisper.cpp."""
 
@@ -224,16 +431,21 @@ class WhisperASR:
         """Return True if the model is loaded."""
         ...
 
+    def warmup(self) -> bool:
+        """Run one silent inference so the first real call is not slowed. Needs initialize()."""
+        ...
+
     def transcribe_file(self, audio_file: str) -> list[TranscriptionSegment]:
         """Transcribe an audio file. Raises RuntimeError on failure."""
         ...
 
-    def transcribe_buffer(self, audio_array: np.ndarray) -> list[TranscriptionSegment]:
+    def transcribe_buffer(self, audio_array: _PcmBuffer) -> list[TranscriptionSegment]:
         """
-        Transcribe audio from a 1-D int16 NumPy array.
+        Transcribe 1-D mono audio.
 
-        The array must be dtype=np.int16 and 1-dimensional.
-        Set WhisperConfig.input_sample_rate to match the array's sample rate.
+        int16 samples (NumPy array, bytes, memoryview) are resampled from
+        WhisperConfig.input_sample_rate; float32 samples in [-1, 1] must
+        already be 16 kHz. The GIL is released while transcribing.
         Raises RuntimeError on failure.
         """
         ...
@@ -246,6 +458,14 @@ class WhisperASR:
         """Return inference time of the most recent call in milliseconds."""
         ...
 
+    def get_backend_description(self) -> str:
+        """Return where the model runs, e.g. 'CUDA0 (NVIDIA L4)' or 'CPU'."""
+        ...
+
+    def get_cache_stats(self) -> TranscriptionCacheStats:
+        """Return result cache counters (all zero when WhisperConfig.cache_dir is empty)."""
+        ...
+
     @staticmethod
     def get_model_type_name(model_type: WhisperModelType) -> str:
         """Return the human-readable name of a WhisperModelType."""
@@ -261,6 +481,7 @@ class AudioCapture:
         sample_rate: int = 48000,
         channels: int = 1,
         frames_per_buffer: int = 256,
+        suggested_latency_ms: float = 0.0,
     ) -> bool:
         """
         Open an audio capture device.
@@ -269,7 +490,11 @@ class AudioCapture:
             device_id: PortAudio device ID (-1 = system default).
             sample_rate: Sample rate in Hz.
             channels: Number of input channels.
-            frames_per_buffer: Frames per audio callback.
+            frames_per_buffer: Frames per audio callback (0 = PortAudio
+                chooses, usually the most efficient size for the host API).
+            suggested_latency_ms: Requested input latency in ms (0 = the
+                device's default low latency).  The granted value is
+                reported by get_input_latency_ms().
 
         Returns:
             True on success.
@@ -284,9 +509,38 @@ class AudioCapture:
         frame; the argument is a 1-D int16 NumPy array of length
         `frames_per_buffer`.  Acquire the GIL before touching Python objects
         inside the callback (the binding does this automatically).
+
+        This takes the GIL on the real-time audio thread for every buffer;
+        prefer BufferedCapture for anything but quick experiments.
+        """
+        ...
+
+    def start_blocking(self) -> bool:
+        """
+        Start capturing without a callback.
+
+        Audio is pulled with read() instead of pushed to Python, so no thread
+        other than the caller's ever runs for it.
+        """
+        ...
+
+    def read(self, num_frames: int) -> np.ndarray:
+        """
+        Block until *num_frames* frames are captured (after start_blocking()).
+
+        Returns interleaved int16 samples, ``num_frames * channels`` long.
+        The GIL is released while waiting.  An input overflow (the caller fell
+        behind) is logged but still returns data.
+
+        Raises:
+            RuntimeError: If the device is not capturing in blocking mode.
         """
         ...
 
+    def get_read_available(self) -> int:
+        """Frames read() can return without blocking (-1 outside blocking mode)."""
+        ...
+
     def stop(self) -> None:
         """Stop capturing audio."""
         ...
@@ -311,6 +565,14 @@ class AudioCapture:
         """Return the configured channel count."""
         ...
 
+    def get_frames_per_buffer(self) -> int:
+        """Return the requested frames per buffer (0 = chosen by PortAudio)."""
+        ...
+
+    def get_input_latency_ms(self) -> float:
+        """Return the input latency PortAudio granted for the open stream, in ms."""
+        ...
+
     @staticmethod
     def initialize() -> bool:
         """Initialize the PortAudio library. Call once before any AudioCapture."""
@@ -331,6 +593,51 @@ class AudioCapture:
         """Return the default input device ID."""
         ...
 
+class BufferedCapture:
+    """
+    Batched capture from an opened AudioCapture.
+
+    The PortAudio callback only copies into a C++ ring buffer; Python gets
+    audio in batches, either through a callback on a drainer thread or by
+    pulling with read(). A slow consumer loses samples (see
+    get_dropped_samples()) instead of causing input overflows.
+    """
+
+    def __init__(self, capture: AudioCapture, batch_ms: int = 100, buffer_ms: int = 2000) -> None:
+        """*buffer_ms* bounds how long Python may fall behind before samples are dropped."""
+        ...
+
+    def start(self, callback: Optional[Callable[[np.ndarray], None]] = None) -> bool:
+        """
+        Start capturing (once per instance).
+
+        With *callback*, it is called with one 1-D int16 array of batch_ms
+        audio at a time; arrays come from a small pool and are refilled only
+        after Python released them. Without it, call read().
+        """
+        ...
+
+    def stop(self) -> None:
+        """Stop the device; the callback receives the remaining partial batch."""
+        ...
+
+    def read(self, num_samples: int, timeout: float = -1.0) -> np.ndarray:
+        """
+        Return up to *num_samples* int16 samples.
+
+        Waits until that many are buffered, *timeout* seconds pass (negative
+        waits without limit) or stop() is called. Releases the GIL while waiting.
+        """
+        ...
+
+    def get_dropped_samples(self) -> int:
+        """Return the number of samples lost because Python fell behind."""
+        ...
+
+    def get_available_samples(self) -> int:
+        """Return the number of samples buffered and not yet read."""
+        ...
+
 class RNNoise:
     """
     AI-powered noise reduction using RNNoise.
@@ -343,12 +650,13 @@ class RNNoise:
         """Initialize with the given sample rate and channel count."""
         ...
 
-    def process(self, audio_array: np.ndarray) -> None:
+    def process(self, audio_array: _PcmBuffer) -> None:
         """
         Denoise audio in-place.
 
-        *audio_array* must be a writable 1-D int16 NumPy array.
-        The array is modified in-place.
+        *audio_array* must be a writable, C-contiguous 1-D int16 or float32
+        buffer (NumPy array, bytearray, memoryview); it is modified in-place
+        with the GIL released.
         """
         ...
 
@@ -378,11 +686,11 @@ class Diarizer:
 
     def diarize(
         self,
-        audio_array: np.ndarray,
+        audio_array: _PcmBuffer,
         sample_rate: int = 16000,
     ) -> list[SpeakerSegment]:
         """
-        Run speaker diarization on a 1-D float32 NumPy array of mono PCM samples.
+        Run speaker diarization on 1-D mono PCM (float32 in [-1, 1], or int16).
 
         Returns speaker segments sorted by start time (empty on failure).
         """
@@ -677,3 +985,53 @@ class RingBuffer:
     def clear(self) -> None:
         """Reset the buffer to empty."""
         ...
+
+# ---------------------------------------------------------------------------
+# Metrics
+# ---------------------------------------------------------------------------
+
+def enable_metrics(enabled: bool = True) -> None:
+    """Turn per-stage latency/throughput recording on or off (off by default)."""
+    ...
+
+def metrics_enabled() -> bool:
+    """Whether metrics are being recorded."""
+    ...
+
+def get_metrics() -> dict[str, dict]:
+    """
+    Snapshot of all metrics.
+
+    Returns ``{"counters": {name: int}, "histograms": {name: {"count", "sum",
+    "min", "max", "mean", "p50", "p90", "p99", "p999"}}}``. Histogram values
+    are microseconds unless the name ends in ``_pct``. The Whisper real-time
+    factor is ``counters["whisper.audio_us"] / histograms["whisper.total_us"]["sum"]``.
+    """
+    ...
+
+def get_metrics_json() -> str:
+    """All metrics as a JSON string (same format as the CLI's --metrics-json)."""
+    ...
+
+def reset_metrics() -> None:
+    """Zero every metric."""
+    ...
+
+# ---------------------------------------------------------------------------
+# Logging
+# ---------------------------------------------------------------------------
+
+def set_async_logging(enabled: bool = True) -> None:
+    """
+    Write log messages from a background thread.
+
+    The capture callback then only copies a message into a lock-free queue and
+    never blocks on stderr. Repeated identical messages are coalesced into one
+    "(repeated N more times)" line. Turning it off writes out everything still
+    queued.
+    """
+    ...
+
+def flush_log() -> None:
+    """Wait until every queued log message has been written."""
+    ...
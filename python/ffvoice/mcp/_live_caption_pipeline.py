@@ -79,6 +79,7 @@ class LiveCaptionSession:
             "utterance_start_ms": int(event.utterance_start_ms),
             "utterance_end_ms": int(event.utterance_end_ms),
             "confidence": float(event.confidence),
+            "language": str(event.language),
         }
         with self._lock:
             self._events.append(entry)
@@ -75,6 +75,10 @@ def _build_asr(model_name: str, language: str, word_timestamps: bool) -> ffvoice
     model_path = _resolve_model_path(model_name.lower())
     if model_path:
         config.model_path = model_path
+    # Agents often ask for the same file again; unchanged files are answered from disk
+    cache_dir = os.environ.get("FFVOICE_TRANSCRIPT_CACHE_DIR", "")
+    if cache_dir:
+        config.cache_dir = cache_dir
 
     asr = ffvoice.WhisperASR(config)
     if not asr.initialize():
@@ -423,7 +427,8 @@ def capture_and_caption(
                     "text": str,
                     "utterance_start_ms": int,
                     "utterance_end_ms": int,
-                    "confidence": float
+                    "confidence": float,
+                    "language": str
                 },
                 ...
             ],
@@ -36,7 +36,24 @@ from typing import Tuple
 
 # Whisper model weights (whisper.cpp ggml format), hosted on Hugging Face.
 _WHISPER_BASE_URL = "https://huggingface.co/ggerganov/whisper.cpp/resolve/main"
-_WHISPER_MODEL_NAMES = ("tiny", "base", "small", "medium", "large")
+# Quantized variants (q8_0 / q5_x) are the names of WhisperModelCatalog.
+_WHISPER_MODEL_NAMES = (
+    "tiny",
+    "tiny-q8_0",
+    "tiny-q5_1",
+    "base",
+    "base-q8_0",
+    "base-q5_1",
+    "small",
+    "small-q8_0",
+    "small-q5_1",
+    "medium",
+    "medium-q8_0",
+    "medium-q5_0",
+    "large",
+    "large-v3",
+    "large-v3-q5_0",
+)
 
 # Pyannote speaker-segmentation model — distributed as a .tar.bz2 archive that
 # extracts to a directory containing ``model.onnx``.
@@ -145,7 +162,9 @@ def ensure_whisper_model(name: str = "tiny") -> str:
 
     Args:
         name: Whisper model size — one of ``tiny``, ``base``, ``small``,
-            ``medium``, ``large``.
+            ``medium``, ``large``, ``large-v3`` — optionally with a
+            quantization suffix as listed by ``WhisperModelCatalog``
+            (``small-q5_1``, ``medium-q8_0``, ``large-v3-q5_0``, …).
 
     Raises:
         ValueError: If *name* is not a recognised model size.
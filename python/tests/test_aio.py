@@ -0,0 +1,139 @@
+"""
+Unit tests for ``ffvoice._aio`` — the asyncio iterator behind
+``LiveCaptioner.events()``.
+
+A fake stream stands in for the C++ ``CaptionEventStream``: a pipe plays the
+eventfd and a background thread plays the inference thread, so these tests
+run without the compiled extension.
+"""
+
+from __future__ import annotations
+
+import asyncio
+import os
+import pathlib
+import sys
+import threading
+import time
+from typing import Any, List
+
+# Ensure python/ is importable so `import ffvoice._aio` resolves from disk.
+_PYTHON_DIR = str(pathlib.Path(__file__).parent.parent)
+if _PYTHON_DIR not in sys.path:
+    sys.path.insert(0, _PYTHON_DIR)
+
+from ffvoice._aio import CaptionEventIterator  # noqa: E402
+
+
+class FakeStream:
+    """Same surface as CaptionEventStream; *use_fd* False mimics Windows."""
+
+    def __init__(self, use_fd: bool = True) -> None:
+        self._lock = threading.Lock()
+        self._cond = threading.Condition(self._lock)
+        self._events: List[Any] = []
+        self._closed = False
+        self._read_fd, self._write_fd = os.pipe() if use_fd else (-1, -1)
+        if use_fd:
+            os.set_blocking(self._read_fd, False)
+
+    # Producer side (the "inference thread")
+    def push(self, event: Any) -> None:
+        with self._cond:
+            self._events.append(event)
+            self._cond.notify_all()
+        if self._write_fd >= 0:
+            os.write(self._write_fd, b"x")
+
+    def close(self) -> None:
+        with self._cond:
+            self._closed = True
+            self._cond.notify_all()
+        if self._write_fd >= 0:
+            os.write(self._write_fd, b"x")
+
+    # Consumer side
+    @property
+    def closed(self) -> bool:
+        with self._lock:
+            return self._closed
+
+    def fileno(self) -> int:
+        return self._read_fd
+
+    def drain(self) -> List[Any]:
+        if self._read_fd >= 0:
+            try:
+                os.read(self._read_fd, 4096)
+            except BlockingIOError:
+                pass
+        with self._lock:
+            events, self._events = self._events, []
+        return events
+
+    def wait(self, timeout: float = -1.0) -> bool:
+        with self._cond:
+            self._cond.wait_for(
+                lambda: self._events or self._closed, None if timeout < 0 else timeout
+            )
+            return bool(self._events)
+
+
+def _produce(stream: FakeStream, count: int) -> threading.Thread:
+    def run() -> None:
+        for i in range(count):
+            time.sleep(0.002)
+            stream.push(i)
+        stream.close()
+
+    thread = threading.Thread(target=run)
+    thread.start()
+    return thread
+
+
+async def _collect(stream: FakeStream) -> List[Any]:
+    return [event async for event in CaptionEventIterator(stream)]
+
+
+def test_iterates_until_closed():
+    stream = FakeStream()
+    producer = _produce(stream, 20)
+    assert asyncio.run(_collect(stream)) == list(range(20))
+    producer.join()
+
+
+def test_events_queued_before_close_are_delivered():
+    stream = FakeStream()
+    for i in range(5):
+        stream.push(i)
+    stream.close()
+    assert asyncio.run(_collect(stream)) == list(range(5))
+
+
+def test_executor_fallback_without_descriptor():
+    stream = FakeStream(use_fd=False)
+    producer = _produce(stream, 10)
+    assert asyncio.run(_collect(stream)) == list(range(10))
+    producer.join()
+
+
+def test_loop_stays_responsive_while_waiting():
+    stream = FakeStream()
+    ticks = 0
+
+    async def ticker() -> None:
+        nonlocal ticks
+        while not stream.closed:
+            ticks += 1
+            await asyncio.sleep(0.001)
+
+    async def main() -> List[Any]:
+        tick_task = asyncio.create_task(ticker())
+        events = await _collect(stream)
+        await tick_task
+        return events
+
+    producer = _produce(stream, 10)
+    assert asyncio.run(main()) == list(range(10))
+    producer.join()
+    assert ticks > 5
@@ -387,6 +387,31 @@ def test_mix_block_clipping_saturates():
         pytest.skip(f"Module not built yet: {e}")
 
 
+def test_mix_minus_block_leaves_out_own_track():
+    """Each track receives the mix of all the other tracks."""
+    try:
+        import numpy as np
+        from ffvoice import AudioMixer
+
+        mixer = AudioMixer()
+        mixer.initialize(48000, 1)
+        track_a = mixer.add_track()
+        track_b = mixer.add_track()
+        track_c = mixer.add_track()
+
+        a = np.full(4, 100, dtype=np.int16)
+        b = np.full(4, 200, dtype=np.int16)
+        c = np.full(4, 300, dtype=np.int16)
+        mixes = mixer.mix_minus_block({track_a: a, track_b: b, track_c: c})
+
+        assert set(mixes.keys()) == {track_a, track_b, track_c}
+        np.testing.assert_array_equal(mixes[track_a], np.full(4, 500, dtype=np.int16))
+        np.testing.assert_array_equal(mixes[track_b], np.full(4, 400, dtype=np.int16))
+        np.testing.assert_array_equal(mixes[track_c], np.full(4, 300, dtype=np.int16))
+    except ImportError as e:
+        pytest.skip(f"Module not built yet: {e}")
+
+
 def test_mix_block_clipping_saturates_negative():
     """Summed values below the int16 range saturate at -32768."""
     try:
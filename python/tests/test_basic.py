@@ -70,6 +70,57 @@ def test_whisper_config():
         pytest.skip(f"Module not built yet: {e}")
 
 
+def test_whisper_acceleration():
+    """Test WhisperConfig.acceleration and the capability probe"""
+    try:
+        from ffvoice import WhisperBackend, WhisperConfig, probe_whisper_capabilities
+
+        config = WhisperConfig()
+        assert config.acceleration.backend == WhisperBackend.AUTO
+        assert config.acceleration.gpu_device == 0
+        assert config.acceleration.flash_attn is False
+
+        # Nested fields are writable in place
+        config.acceleration.backend = WhisperBackend.CPU
+        config.acceleration.flash_attn = True
+        assert config.acceleration.backend == WhisperBackend.CPU
+        assert config.acceleration.flash_attn is True
+
+        caps = probe_whisper_capabilities()
+        assert WhisperBackend.CPU in caps.backends
+        assert caps.supports(WhisperBackend.AUTO)
+        for device in caps.devices:
+            assert caps.supports(device.backend) or device.backend == WhisperBackend.AUTO
+    except ImportError as e:
+        pytest.skip(f"Module not built yet: {e}")
+
+
+def test_whisper_model_catalog():
+    """Test budget-driven model selection without model files"""
+    try:
+        from ffvoice import WhisperModelCatalog, WhisperQuantization, WhisperResourceBudget
+
+        catalog = WhisperModelCatalog()
+        variant = catalog.find("medium-q5_0")
+        assert variant is not None
+        assert variant.quantization == WhisperQuantization.Q5_0
+        assert variant.filename == "ggml-medium-q5_0.bin"
+        assert catalog.find("huge") is None
+
+        budget = WhisperResourceBudget()
+        budget.max_rtf = 1.0
+        budget.max_memory_mb = 1200
+        choice = catalog.select(budget)
+        assert choice.variant.name == "medium-q5_0"
+        assert choice.estimated_memory_mb <= 1200
+
+        budget.concurrency = 100
+        with pytest.raises(RuntimeError):
+            catalog.select(budget)
+    except ImportError as e:
+        pytest.skip(f"Module not built yet: {e}")
+
+
 def test_audio_capture():
     """Test AudioCapture class is importable and exposes expected methods"""
     try:
@@ -56,6 +56,7 @@ class _CaptionEvent:
         utterance_start_ms: int = 0,
         utterance_end_ms: int = 1000,
         confidence: float = 0.9,
+        language: str = "en",
     ) -> None:
         self.type = event_type
         self.text = text
@@ -63,6 +64,7 @@ class _CaptionEvent:
         self.utterance_start_ms = utterance_start_ms
         self.utterance_end_ms = utterance_end_ms
         self.confidence = confidence
+        self.language = language
 
 
 def _make_final_event(
@@ -467,11 +469,13 @@ class TestLiveCaptionSession:
             "utterance_start_ms",
             "utterance_end_ms",
             "confidence",
+            "language",
         ):
             assert field in ev, f"Missing field: {field}"
         assert ev["utterance_id"] == 5
         assert ev["text"] == "test"
         assert ev["type"] == "Final"
+        assert ev["language"] == "en"
 
     def test_captioner_initialize_failure_raises(self) -> None:
         from ffvoice.mcp._live_caption_pipeline import LiveCaptionSession
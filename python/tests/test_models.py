@@ -94,6 +94,17 @@ class TestEnsureWhisperModel:
         with pytest.raises(ValueError, match="Unknown Whisper model"):
             models.ensure_whisper_model("supermodel")
 
+    def test_quantized_name_downloads_quantized_file(self, tmp_path: Any) -> None:
+        cache = tmp_path / "cache"
+        opener = _fake_urlopen(b"q5-weights")
+        with patch.dict(os.environ, {"FFVOICE_CACHE_DIR": str(cache)}, clear=False):
+            os.environ.pop("FFVOICE_MODEL_PATH", None)
+            with patch("urllib.request.urlopen", opener):
+                result = models.ensure_whisper_model("Small-Q5_1")
+
+        assert result == str(cache / "whisper" / "ggml-small-q5_1.bin")
+        assert opener.calls[0].endswith("ggml-small-q5_1.bin")  # type: ignore[attr-defined]
+
     def test_model_path_override_returned(self, tmp_path: Any) -> None:
         """FFVOICE_MODEL_PATH override is used when the file exists there."""
         model_file = tmp_path / "ggml-tiny.bin"
@@ -6,6 +6,7 @@
 #include "audio/audio_capture_device.h"
 
 #include "utils/logger.h"
+#include "utils/trace.h"
 
 #include <iostream>
 
@@ -92,14 +93,35 @@ int AudioCaptureDevice::GetDefaultInputDevice() {
     return Pa_GetDefaultInputDevice();
 }
 
-bool AudioCaptureDevice::Open(int device_id, int sample_rate, int channels, int frames_per_buffer) {
+namespace {
+
+PaSampleFormat ToPaSampleFormat(AudioFormat format) {
+    return format == AudioFormat::FLOAT32 ? paFloat32 : paInt16;
+}
+
+}  // namespace
+
+bool AudioCaptureDevice::Open(int device_id, int sample_rate, int channels, int frames_per_buffer,
+                              AudioFormat format, double suggested_latency_ms) {
     if (stream_) {
         LOG_ERROR("Device already open");
         return false;
     }
 
+    if (format != AudioFormat::INT16 && format != AudioFormat::FLOAT32) {
+        LOG_ERROR("Unsupported capture format (only INT16 and FLOAT32)");
+        return false;
+    }
+    if (frames_per_buffer < 0 || suggested_latency_ms < 0.0) {
+        LOG_ERROR("frames_per_buffer and suggested latency must not be negative");
+        return false;
+    }
+    format_ = format;
+
     sample_rate_ = sample_rate;
     channels_ = channels;
+    frames_per_buffer_ = frames_per_buffer;
+    suggested_latency_ms_ = suggested_latency_ms;
 
     // Use default device if -1
     if (device_id < 0) {
@@ -114,42 +136,64 @@ bool AudioCaptureDevice::Open(int device_id, int sample_rate, int channels, int
     // Store the device ID for later use
     device_id_ = device_id;
 
-    // Configure input parameters
+    // No callback yet: Start() reopens with one, StartBlocking() uses this stream
+    if (!OpenStream(false)) {
+        return false;
+    }
+
+    LOG_INFO("Audio device opened: %s (%.1f ms input latency)", Pa_GetDeviceInfo(device_id)->name,
+             GetInputLatencyMs());
+    return true;
+}
+
+bool AudioCaptureDevice::OpenStream(bool with_callback) {
+    const PaDeviceInfo* info = Pa_GetDeviceInfo(device_id_);
+    if (!info) {
+        LOG_ERROR("Invalid input device: %d", device_id_);
+        return false;
+    }
+
     PaStreamParameters input_params;
-    input_params.device = device_id;
-    input_params.channelCount = channels;
-    input_params.sampleFormat = paInt16;  // 16-bit PCM
-    input_params.suggestedLatency = Pa_GetDeviceInfo(device_id)->defaultLowInputLatency;
+    input_params.device = device_id_;
+    input_params.channelCount = channels_;
+    input_params.sampleFormat = ToPaSampleFormat(format_);  // 16-bit PCM or 32-bit float
+    input_params.suggestedLatency = suggested_latency_ms_ > 0.0 ? suggested_latency_ms_ / 1000.0
+                                                                : info->defaultLowInputLatency;
     input_params.hostApiSpecificStreamInfo = nullptr;
 
-    // Open stream
+    const unsigned long frames = frames_per_buffer_ > 0
+                                     ? static_cast<unsigned long>(frames_per_buffer_)
+                                     : paFramesPerBufferUnspecified;
     PaError err = Pa_OpenStream(&stream_, &input_params,
                                 nullptr,  // No output
-                                sample_rate, frames_per_buffer,
+                                sample_rate_, frames,
                                 paClipOff,  // Don't clip samples
-                                nullptr,    // No callback yet (will set on Start)
-                                nullptr);
+                                with_callback ? PortAudioCallback : nullptr,
+                                with_callback ? this : nullptr);
 
     if (err != paNoError) {
         LOG_ERROR("Failed to open stream: %s", Pa_GetErrorText(err));
-        stream_ = nullptr;
+        stream_ = nullptr;  // No valid stream; keep device in a clean closed state
         return false;
     }
-
-    LOG_INFO("Audio device opened: %s", Pa_GetDeviceInfo(device_id)->name);
+    stream_has_callback_ = with_callback;
     return true;
 }
 
+double AudioCaptureDevice::GetInputLatencyMs() const {
+    const PaStreamInfo* info = stream_ ? Pa_GetStreamInfo(stream_) : nullptr;
+    return info ? info->inputLatency * 1000.0 : 0.0;
+}
+
 int AudioCaptureDevice::PortAudioCallback(const void* input_buffer, void* output_buffer,
                                           unsigned long frames_per_buffer,
                                           const PaStreamCallbackTimeInfo* time_info,
                                           PaStreamCallbackFlags status_flags, void* user_data) {
     (void)output_buffer;  // Unused
-    (void)time_info;      // Unused
 
     auto* self = static_cast<AudioCaptureDevice*>(user_data);
 
-    if (!self || !self->user_callback_) {
+    if (!self) {
         return paContinue;
     }
 
@@ -158,16 +202,62 @@ int AudioCaptureDevice::PortAudioCallback(const void* input_buffer, void* output
         return paContinue;
     }
 
-    // Check for input overflow
+    // One-time setup of PortAudio's thread (a few syscalls, never repeated)
+    if (self->thread_policy_pending_.load(std::memory_order_relaxed)) {
+        self->thread_policy_pending_.store(false, std::memory_order_relaxed);
+        ApplyThreadPolicy(self->thread_policy_,
+                          "Capture callback (device " + std::to_string(self->device_id_) + ")");
+    }
+
+    // Covers the broadcast push and the user callback
+    ScopedTimer timer(*self->callback_time_);
+    FFVOICE_TRACE_SCOPE("AudioCaptureDevice::Callback");
+    const bool metrics = MetricsRegistry::IsEnabled();
+    if (metrics) {
+        self->captured_frames_->Add(frames_per_buffer);
+    }
+
+    // Check for input overflow (with async logging on this only enqueues, and
+    // a burst of overflows is coalesced into one "repeated" line)
     if (status_flags & paInputOverflow) {
+        if (metrics) {
+            self->input_overflows_->Add();
+        }
         LOG_ERROR("Input overflow detected");
     }
 
-    // Call user callback with audio data
-    const int16_t* samples = static_cast<const int16_t*>(input_buffer);
     size_t num_samples = frames_per_buffer * self->channels_;
 
-    self->user_callback_(samples, num_samples);
+    if (self->format_ == AudioFormat::FLOAT32) {
+        const float* samples = static_cast<const float*>(input_buffer);
+        if (self->float_broadcast_) {
+            self->float_broadcast_->push_bulk(samples, num_samples);
+        }
+        if (self->float_callback_) {
+            self->float_callback_(samples, num_samples);
+        }
+        return paContinue;
+    }
+
+    const int16_t* samples = static_cast<const int16_t*>(input_buffer);
+
+    // Publish once to all broadcast consumers (wait-free, never blocks)
+    if (self->broadcast_) {
+        self->broadcast_->push_bulk(samples, num_samples);
+    }
+
+    // Call user callback with audio data
+    if (self->user_callback_) {
+        self->user_callback_(samples, num_samples);
+    }
+    if (self->timed_callback_) {
+        double adc_time = time_info ? time_info->inputBufferAdcTime : 0.0;
+        if (adc_time <= 0.0) {
+            const PaStreamInfo* info = Pa_GetStreamInfo(self->stream_);
+            adc_time = Pa_GetStreamTime(self->stream_) - (info ? info->inputLatency : 0.0);
+        }
+        self->timed_callback_(samples, num_samples, adc_time);
+    }
 
     return paContinue;
 }
@@ -183,8 +273,73 @@ bool AudioCaptureDevice::Start(AudioCallback callback) {
         return false;
     }
 
+    if (format_ != AudioFormat::INT16) {
+        LOG_ERROR("Device opened as FLOAT32; use StartFloat()");
+        return false;
+    }
+
+    if (!callback && !broadcast_) {
+        LOG_ERROR("No audio callback or broadcast buffer set");
+        return false;
+    }
+
     user_callback_ = callback;
+    timed_callback_ = nullptr;
+    return StartStream();
+}
 
+bool AudioCaptureDevice::StartTimed(TimedAudioCallback callback) {
+    if (!stream_) {
+        LOG_ERROR("Device not open");
+        return false;
+    }
+
+    if (is_capturing_) {
+        LOG_ERROR("Already capturing");
+        return false;
+    }
+
+    if (format_ != AudioFormat::INT16) {
+        LOG_ERROR("Device opened as FLOAT32; timestamped capture needs INT16");
+        return false;
+    }
+
+    if (!callback) {
+        LOG_ERROR("No audio callback set");
+        return false;
+    }
+
+    user_callback_ = nullptr;
+    timed_callback_ = std::move(callback);
+    return StartStream();
+}
+
+bool AudioCaptureDevice::StartFloat(FloatAudioCallback callback) {
+    if (!stream_) {
+        LOG_ERROR("Device not open");
+        return false;
+    }
+
+    if (is_capturing_) {
+        LOG_ERROR("Already capturing");
+        return false;
+    }
+
+    if (format_ != AudioFormat::FLOAT32) {
+        LOG_ERROR("Device opened as INT16; use Start()");
+        return false;
+    }
+
+    if (!callback && !float_broadcast_) {
+        LOG_ERROR("No audio callback or broadcast buffer set");
+        return false;
+    }
+
+    float_callback_ = callback;
+    return StartStream();
+}
+
+bool AudioCaptureDevice::StartStream() {
     // Close the callback-less stream opened by Open(). The handle is invalid
     // after this point regardless of the return code, so clear it immediately
     // to avoid a dangling pointer / double-close if reopening fails below.
@@ -195,23 +350,8 @@ bool AudioCaptureDevice::Start(AudioCallback callback) {
         return false;
     }
 
-    // Use the stored device ID
-    PaStreamParameters input_params;
-    input_params.device = device_id_;
-    input_params.channelCount = channels_;
-    input_params.sampleFormat = paInt16;
-    input_params.suggestedLatency = Pa_GetDeviceInfo(device_id_)->defaultLowInputLatency;
-    input_params.hostApiSpecificStreamInfo = nullptr;
-
-    err = Pa_OpenStream(&stream_, &input_params, nullptr, sample_rate_,
-                        256,  // frames per buffer
-                        paClipOff, PortAudioCallback,
-                        this  // User data
-    );
-
-    if (err != paNoError) {
-        LOG_ERROR("Failed to reopen stream with callback: %s", Pa_GetErrorText(err));
-        stream_ = nullptr;  // No valid stream; keep device in a clean closed state
+    // Same device, buffer size and latency as Open(), now with the callback
+    if (!OpenStream(true)) {
         return false;
     }
 
@@ -225,12 +365,99 @@ bool AudioCaptureDevice::Start(AudioCallback callback) {
         return false;
     }
 
+    thread_policy_pending_.store(!thread_policy_.IsDefault(), std::memory_order_relaxed);
     callback_active_.store(true);  // Enable callback execution
     is_capturing_ = true;
-    LOG_INFO("Audio capture started");
+    LOG_INFO("Audio capture started (%.1f ms input latency)", GetInputLatencyMs());
+    return true;
+}
+
+bool AudioCaptureDevice::StartBlocking() {
+    if (!stream_) {
+        LOG_ERROR("Device not open");
+        return false;
+    }
+
+    if (is_capturing_) {
+        LOG_ERROR("Already capturing");
+        return false;
+    }
+
+    // A previous Start() left a callback stream behind; Pa_ReadStream needs one without
+    if (stream_has_callback_) {
+        PaError err = Pa_CloseStream(stream_);
+        stream_ = nullptr;
+        if (err != paNoError) {
+            LOG_ERROR("Failed to close stream before reopen: %s", Pa_GetErrorText(err));
+            return false;
+        }
+        if (!OpenStream(false)) {
+            return false;
+        }
+    }
+
+    PaError err = Pa_StartStream(stream_);
+    if (err != paNoError) {
+        LOG_ERROR("Failed to start stream: %s", Pa_GetErrorText(err));
+        return false;
+    }
+
+    is_blocking_ = true;
+    is_capturing_ = true;
+    LOG_INFO("Audio capture started in blocking mode (%.1f ms input latency)",
+             GetInputLatencyMs());
     return true;
 }
 
+bool AudioCaptureDevice::Read(int16_t* samples, size_t num_frames) {
+    return ReadFrames(samples, num_frames, AudioFormat::INT16);
+}
+
+bool AudioCaptureDevice::ReadFloat(float* samples, size_t num_frames) {
+    return ReadFrames(samples, num_frames, AudioFormat::FLOAT32);
+}
+
+bool AudioCaptureDevice::ReadFrames(void* samples, size_t num_frames, AudioFormat format) {
+    if (!is_capturing_ || !is_blocking_) {
+        LOG_ERROR("Read() needs a stream started with StartBlocking()");
+        return false;
+    }
+    if (format != format_) {
+        LOG_ERROR("Sample format mismatch: use %s for this device",
+                  format_ == AudioFormat::INT16 ? "Read()" : "ReadFloat()");
+        return false;
+    }
+    if (!samples || num_frames == 0) {
+        return num_frames == 0;
+    }
+
+    ScopedTimer timer(*read_time_);
+    FFVOICE_TRACE_SCOPE("AudioCaptureDevice::Read");
+    PaError err = Pa_ReadStream(stream_, samples, static_cast<unsigned long>(num_frames));
+    const bool metrics = MetricsRegistry::IsEnabled();
+    if (err == paInputOverflowed) {
+        // Data is still delivered; the caller fell behind by at least one buffer
+        if (metrics) {
+            input_overflows_->Add();
+        }
+        LOG_ERROR("Input overflow detected (blocking read)");
+    } else if (err != paNoError) {
+        LOG_ERROR("Failed to read stream: %s", Pa_GetErrorText(err));
+        return false;
+    }
+    if (metrics) {
+        captured_frames_->Add(num_frames);
+    }
+    return true;
+}
+
+long AudioCaptureDevice::GetReadAvailable() const {
+    if (!stream_ || !is_capturing_ || !is_blocking_) {
+        return -1;
+    }
+    return Pa_GetStreamReadAvailable(stream_);
+}
+
 void AudioCaptureDevice::Stop() {
     if (!stream_ || !is_capturing_) {
         return;
@@ -244,6 +471,7 @@ void AudioCaptureDevice::Stop() {
     }
 
     is_capturing_ = false;
+    is_blocking_ = false;
     LOG_INFO("Audio capture stopped");
 }
 
@@ -255,6 +483,7 @@ void AudioCaptureDevice::Close() {
     if (stream_) {
         Pa_CloseStream(stream_);
         stream_ = nullptr;
+        stream_has_callback_ = false;
         LOG_INFO("Audio device closed");
     }
 }
@@ -14,6 +14,9 @@
 #include <vector>
 
 #include "ffvoice/types.h"
+#include "utils/broadcast_ring_buffer.h"
+#include "utils/metrics.h"
+#include "utils/thread_policy.h"
 
 namespace ffvoice {
 
@@ -31,6 +34,23 @@ public:
      */
     using AudioCallback = std::function<void(const int16_t* samples, size_t num_frames)>;
 
+    /**
+     * @brief Audio callback function type for FLOAT32 streams
+     * @param samples Audio samples (float in [-1, 1], interleaved)
+     * @param num_samples Number of samples captured (frames * channels)
+     */
+    using FloatAudioCallback = std::function<void(const float* samples, size_t num_samples)>;
+
+    /**
+     * @brief INT16 callback that also receives the capture time of the block
+     * @param samples Audio samples (int16_t, interleaved)
+     * @param num_samples Number of samples captured (frames * channels)
+     * @param adc_time PortAudio stream time (seconds) at which the first frame
+     *                 reached the ADC (PaStreamCallbackTimeInfo::inputBufferAdcTime)
+     */
+    using TimedAudioCallback =
+        std::function<void(const int16_t* samples, size_t num_samples, double adc_time)>;
+
     AudioCaptureDevice();
     ~AudioCaptureDevice();
 
@@ -64,19 +84,121 @@ public:
      * @param device_id Device ID (-1 for default)
      * @param sample_rate Sample rate in Hz
      * @param channels Number of channels (1 or 2)
-     * @param frames_per_buffer Buffer size in frames
+     * @param frames_per_buffer Frames per callback or Read() block (0 = let PortAudio
+     *                          pick the host's optimal, possibly varying, size).
+     *                          Small buffers (64) suit live monitoring; large ones
+     *                          (960) cut wakeups on captioning-only hosts.
+     * @param format Sample format delivered: INT16 (Start()) or FLOAT32 (StartFloat()).
+     *               FLOAT32 lets a float processing chain skip the int16 round trip.
+     * @param suggested_latency_ms Input latency asked of the host API (0 = the
+     *                             device's default low input latency). The
+     *                             latency actually granted is GetInputLatencyMs().
      * @return true if successful
      */
     bool Open(int device_id = -1, int sample_rate = 48000, int channels = 1,
-              int frames_per_buffer = 256);
+              int frames_per_buffer = 256, AudioFormat format = AudioFormat::INT16,
+              double suggested_latency_ms = 0.0);
+
+    /**
+     * @brief Publish captured audio into a broadcast buffer
+     *
+     * When set, every captured block is pushed once into @p buffer from the
+     * PortAudio thread, before the user callback runs. Consumers attach with
+     * BroadcastRingBuffer::add_consumer() and drain at their own pace on their
+     * own threads, so a slow consumer cannot stall the callback.
+     *
+     * Must be called before Start(). Pass nullptr to detach. The buffer must
+     * outlive the capture.
+     *
+     * @param buffer Broadcast buffer to publish into (not owned)
+     */
+    void SetBroadcastBuffer(BroadcastRingBuffer<int16_t>* buffer) {
+        broadcast_ = buffer;
+    }
+
+    /**
+     * @brief Publish captured FLOAT32 audio into a broadcast buffer
+     *
+     * Same contract as SetBroadcastBuffer(), for devices opened with
+     * AudioFormat::FLOAT32.
+     *
+     * @param buffer Broadcast buffer to publish into (not owned)
+     */
+    void SetFloatBroadcastBuffer(BroadcastRingBuffer<float>* buffer) {
+        float_broadcast_ = buffer;
+    }
+
+    /**
+     * @brief Priority and cores for the PortAudio callback thread
+     *
+     * PortAudio owns that thread, so the policy is applied from inside the
+     * first callback after each Start(); GetAppliedThreadPolicies() reports
+     * the outcome under "Capture callback (device N)". Set before starting.
+     */
+    void SetThreadPolicy(const ThreadPolicy& policy) {
+        thread_policy_ = policy;
+    }
 
     /**
      * @brief Start capturing audio
-     * @param callback Function to call when audio data is available
+     * @param callback Function to call when audio data is available; may be
+     *                 empty when a broadcast buffer is attached
      * @return true if successful
      */
     bool Start(AudioCallback callback);
 
+    /**
+     * @brief Start capturing a FLOAT32 stream
+     * @param callback Function to call when audio data is available; may be
+     *                 empty when a float broadcast buffer is attached
+     * @return true if successful
+     */
+    bool StartFloat(FloatAudioCallback callback);
+
+    /**
+     * @brief Start capturing an INT16 stream with per-block capture timestamps
+     *
+     * Host APIs that leave inputBufferAdcTime at 0 get the stream time minus
+     * the input latency instead, so the timestamp is always usable (if
+     * noisier) for aligning this device with others.
+     *
+     * @param callback Function to call when audio data is available
+     * @return true if successful
+     */
+    bool StartTimed(TimedAudioCallback callback);
+
+    /**
+     * @brief Start a callback-less stream for pull-based pipelines
+     *
+     * Audio is then fetched with Read() / ReadFloat() from the caller's own
+     * thread; no PortAudio thread runs user code. Broadcast buffers are not
+     * fed in this mode.
+     *
+     * @return true if successful
+     */
+    bool StartBlocking();
+
+    /**
+     * @brief Read @p num_frames frames from a stream started with StartBlocking()
+     *
+     * Blocks until the frames are available. An input overflow (the caller
+     * read too slowly) is logged and counted, and the frames are still
+     * returned.
+     *
+     * @param samples Receives num_frames * GetChannels() interleaved int16 samples
+     * @return true on success (device opened as INT16 and capturing)
+     */
+    bool Read(int16_t* samples, size_t num_frames);
+
+    /// Read() for devices opened as FLOAT32
+    bool ReadFloat(float* samples, size_t num_frames);
+
+    /**
+     * @brief Frames that Read() can return without blocking (blocking mode only)
+     * @return Frame count, or -1 if the stream is not capturing in blocking mode
+     */
+    long GetReadAvailable() const;
+
     /**
      * @brief Stop capturing audio
      */
@@ -115,7 +237,36 @@ public:
         return channels_;
     }
 
+    /**
+     * @brief Get the sample format the device was opened with
+     */
+    AudioFormat GetFormat() const {
+        return format_;
+    }
+
+    /**
+     * @brief Frames per buffer requested in Open() (0 = chosen by PortAudio)
+     */
+    int GetFramesPerBuffer() const {
+        return frames_per_buffer_;
+    }
+
+    /**
+     * @brief Input latency PortAudio reports for the open stream (Pa_GetStreamInfo)
+     * @return Latency in milliseconds, or 0 if no stream is open
+     */
+    double GetInputLatencyMs() const;
+
 private:
+    /// Open stream_ with the stored parameters, with or without PortAudioCallback
+    bool OpenStream(bool with_callback);
+
+    /// Reopen the callback-less stream from Open() with PortAudioCallback and start it
+    bool StartStream();
+
+    /// Shared checks and bookkeeping of Read() / ReadFloat()
+    bool ReadFrames(void* samples, size_t num_frames, AudioFormat format);
+
     // PortAudio callback
     static int PortAudioCallback(const void* input_buffer, void* output_buffer,
                                  unsigned long frames_per_buffer,
@@ -124,11 +275,29 @@ private:
 
     PaStream* stream_ = nullptr;
     AudioCallback user_callback_;
+    TimedAudioCallback timed_callback_;
+    BroadcastRingBuffer<int16_t>* broadcast_ = nullptr;  // Optional fan-out target (not owned)
+    FloatAudioCallback float_callback_;
+    BroadcastRingBuffer<float>* float_broadcast_ = nullptr;  // FLOAT32 fan-out (not owned)
+    AudioFormat format_ = AudioFormat::INT16;
     int device_id_ = -1;
     int sample_rate_ = 0;
     int channels_ = 0;
+    int frames_per_buffer_ = 256;
+    double suggested_latency_ms_ = 0.0;
+    bool stream_has_callback_ = false;  // stream_ was opened with PortAudioCallback
+    bool is_blocking_ = false;          // Capturing through StartBlocking()
     bool is_capturing_ = false;
     std::atomic<bool> callback_active_{false};  // Thread-safe flag for callback execution
+    ThreadPolicy thread_policy_;
+    std::atomic<bool> thread_policy_pending_{false};  // Apply in the next callback
+
+    // Metric handles, looked up once so the callback never takes the registry lock
+    MetricHistogram* callback_time_ = &MetricsRegistry::Instance().Histogram("capture.callback_us");
+    MetricHistogram* read_time_ = &MetricsRegistry::Instance().Histogram("capture.read_us");
+    MetricCounter* captured_frames_ = &MetricsRegistry::Instance().Counter("capture.frames");
+    MetricCounter* input_overflows_ =
+        &MetricsRegistry::Instance().Counter("capture.input_overflows");
 
     static bool is_initialized_;
 };
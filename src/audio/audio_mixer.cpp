@@ -5,18 +5,42 @@
 
 #include "audio/audio_mixer.h"
 
+#include "utils/audio_kernels.h"
 #include "utils/logger.h"
 
 #include <algorithm>
 #include <string>
+#include <utility>
 
 namespace ffvoice {
 
 namespace {
+constexpr size_t kMaxLanes = 64;
+constexpr uint32_t kSlotMask = 3;
 constexpr float kInt16Min = -32768.0f;
 constexpr float kInt16Max = 32767.0f;
+
+// Linear gain ramp from @p from to @p to over the frames of one block; the
+// last frame reaches @p to
+void MixInt16Ramp(const int16_t* input, size_t num_samples, size_t channels, const float from[2],
+                  const float to[2], float* accumulator) {
+    const size_t num_frames = num_samples / channels;
+    const float step = 1.0f / static_cast<float>(num_frames);
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        const float t = static_cast<float>(frame + 1) * step;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            const size_t i = frame * channels + ch;
+            const float gain = from[ch] + (to[ch] - from[ch]) * t;
+            accumulator[i] += static_cast<float>(input[i]) * gain;
+        }
+    }
+}
 }  // namespace
 
+AudioMixer::~AudioMixer() {
+    StopWorkers();
+}
+
 bool AudioMixer::Initialize(int sample_rate, int channels) {
     if (sample_rate <= 0) {
         LOG_ERROR("AudioMixer: invalid sample rate %d", sample_rate);
@@ -32,7 +56,23 @@ bool AudioMixer::Initialize(int sample_rate, int channels) {
     next_track_id_ = 0;
     master_gain_ = 1.0f;
     tracks_.clear();
+    slot_of_id_.clear();
+
+    // Not concurrent with MixBlock(), so the exchange can be reset directly
+    for (Snapshot& snapshot : snapshots_) {
+        snapshot.tracks.clear();
+        snapshot.slot_of_id.clear();
+        snapshot.master_gain = 1.0f;
+    }
+    shared_slot_.store(2, std::memory_order_relaxed);
+    publish_slot_ = 3;
+    mix_slot_ = 0;
+    spare_slot_ = 1;
+    applied_master_gain_ = -1.0f;
     initialized_ = true;
+    if (limiter_ && !limiter_->Initialize(sample_rate, channels)) {
+        limiter_.reset();
+    }
 
     LOG_INFO("AudioMixer initialized: %dHz, %d channel(s)", sample_rate, channels);
     return true;
@@ -49,18 +89,27 @@ int AudioMixer::AddTrack(float gain, float pan) {
     track.gain = std::clamp(gain, 0.0f, kMaxGain);
     track.pan = std::clamp(pan, -1.0f, 1.0f);
     track.muted = false;
+    slot_of_id_.push_back(static_cast<int32_t>(tracks_.size()));
     tracks_.push_back(track);
+    Publish();
     return track.id;
 }
 
 bool AudioMixer::RemoveTrack(int track_id) {
-    for (auto it = tracks_.begin(); it != tracks_.end(); ++it) {
-        if (it->id == track_id) {
-            tracks_.erase(it);
-            return true;
-        }
+    if (FindTrack(track_id) == nullptr) {
+        return false;
     }
-    return false;
+
+    // Swap-remove keeps tracks_ dense; only the moved track's slot changes
+    const int32_t slot = slot_of_id_[static_cast<size_t>(track_id)];
+    if (static_cast<size_t>(slot) != tracks_.size() - 1) {
+        tracks_[static_cast<size_t>(slot)] = tracks_.back();
+        slot_of_id_[static_cast<size_t>(tracks_[static_cast<size_t>(slot)].id)] = slot;
+    }
+    tracks_.pop_back();
+    slot_of_id_[static_cast<size_t>(track_id)] = kNoSlot;
+    Publish();
+    return true;
 }
 
 bool AudioMixer::HasTrack(int track_id) const {
@@ -68,21 +117,15 @@ bool AudioMixer::HasTrack(int track_id) const {
 }
 
 const AudioMixer::Track* AudioMixer::FindTrack(int track_id) const {
-    for (const auto& track : tracks_) {
-        if (track.id == track_id) {
-            return &track;
-        }
+    if (track_id < 0 || static_cast<size_t>(track_id) >= slot_of_id_.size()) {
+        return nullptr;
     }
-    return nullptr;
+    const int32_t slot = slot_of_id_[static_cast<size_t>(track_id)];
+    return slot != kNoSlot ? &tracks_[static_cast<size_t>(slot)] : nullptr;
 }
 
 AudioMixer::Track* AudioMixer::FindTrack(int track_id) {
-    for (auto& track : tracks_) {
-        if (track.id == track_id) {
-            return &track;
-        }
-    }
-    return nullptr;
+    return const_cast<Track*>(std::as_const(*this).FindTrack(track_id));
 }
 
 bool AudioMixer::SetGain(int track_id, float gain) {
@@ -91,6 +134,7 @@ bool AudioMixer::SetGain(int track_id, float gain) {
         return false;
     }
     track->gain = std::clamp(gain, 0.0f, kMaxGain);
+    Publish();
     return true;
 }
 
@@ -100,6 +144,7 @@ bool AudioMixer::SetPan(int track_id, float pan) {
         return false;
     }
     track->pan = std::clamp(pan, -1.0f, 1.0f);
+    Publish();
     return true;
 }
 
@@ -109,6 +154,7 @@ bool AudioMixer::SetMute(int track_id, bool muted) {
         return false;
     }
     track->muted = muted;
+    Publish();
     return true;
 }
 
@@ -129,6 +175,70 @@ bool AudioMixer::IsMuted(int track_id) const {
 
 void AudioMixer::SetMasterGain(float gain) {
     master_gain_ = std::clamp(gain, 0.0f, kMaxGain);
+    Publish();
+}
+
+void AudioMixer::Publish() {
+    Snapshot& snapshot = snapshots_[publish_slot_];
+    snapshot.tracks.resize(tracks_.size());
+    for (size_t slot = 0; slot < tracks_.size(); ++slot) {
+        const Track& track = tracks_[slot];
+        TrackParams& params = snapshot.tracks[slot];
+        params.id = track.id;
+
+        // Per-channel gain: linear "balance" pan for stereo, plain gain for mono.
+        const float gain = track.muted ? 0.0f : track.gain;
+        params.target[0] = gain;
+        params.target[1] = gain;
+        if (channels_ == 2) {
+            params.target[0] = gain * (track.pan <= 0.0f ? 1.0f : 1.0f - track.pan);
+            params.target[1] = gain * (track.pan >= 0.0f ? 1.0f : 1.0f + track.pan);
+        }
+    }
+    snapshot.slot_of_id = slot_of_id_;
+    snapshot.master_gain = master_gain_;
+
+    // Share it; whatever the audio thread last left in the shared slot is ours now
+    publish_slot_ =
+        shared_slot_.exchange(publish_slot_ | kFreshSnapshot, std::memory_order_acq_rel) &
+        kSlotMask;
+}
+
+void AudioMixer::AcquireSnapshot() const {
+    if ((shared_slot_.load(std::memory_order_acquire) & kFreshSnapshot) == 0) {
+        return;
+    }
+    // Hand over the spare, not the current snapshot, which is still read below
+    const uint32_t fresh_slot =
+        shared_slot_.exchange(spare_slot_, std::memory_order_acq_rel) & kSlotMask;
+    Snapshot& fresh = snapshots_[fresh_slot];
+    const Snapshot& current = snapshots_[mix_slot_];
+
+    // Ramp from where each track's last block ended; new tracks start at their gain
+    for (TrackParams& params : fresh.tracks) {
+        const size_t id = static_cast<size_t>(params.id);
+        const int32_t slot = id < current.slot_of_id.size() ? current.slot_of_id[id] : kNoSlot;
+        const float* from =
+            slot != kNoSlot ? current.tracks[static_cast<size_t>(slot)].applied : params.target;
+        params.applied[0] = from[0];
+        params.applied[1] = from[1];
+    }
+
+    spare_slot_ = mix_slot_;
+    mix_slot_ = fresh_slot;
+}
+
+void AudioMixer::SetNumThreads(int num_threads) {
+    const size_t lanes = std::clamp<size_t>(num_threads > 1 ? num_threads : 1, 1, kMaxLanes);
+    if (lanes == num_lanes_) {
+        return;
+    }
+    StopWorkers();
+    lane_accumulators_.resize(lanes);
+    if (lanes > 1) {
+        StartWorkers(lanes);
+    }
+    LOG_INFO("AudioMixer: mixing on %zu thread(s)", lanes);
 }
 
 bool AudioMixer::MixBlock(const std::vector<MixerInput>& inputs, int16_t* output,
@@ -146,50 +256,272 @@ bool AudioMixer::MixBlock(const std::vector<MixerInput>& inputs, int16_t* output
         return false;
     }
 
-    // Accumulate every track's contribution in float so that summing loud
-    // tracks does not clip until the final conversion back to int16.
-    if (accumulator_.size() < num_samples) {
-        accumulator_.resize(num_samples);
+    AccumulateBlock(inputs, num_samples);
+    WriteOutput(lane_accumulators_[0].data(), num_samples, output, true);
+    FinishBlock();
+    return true;
+}
+
+bool AudioMixer::EnableLimiter(const LookaheadLimiterConfig& config) {
+    if (!initialized_) {
+        LOG_ERROR("AudioMixer::EnableLimiter called before Initialize()");
+        return false;
     }
-    std::fill(accumulator_.begin(), accumulator_.begin() + static_cast<std::ptrdiff_t>(num_samples),
-              0.0f);
+    auto limiter = std::make_unique<LookaheadLimiter>(config);
+    if (!limiter->Initialize(sample_rate_, channels_)) {
+        return false;
+    }
+    limiter_ = std::move(limiter);
+    return true;
+}
 
-    const size_t channels = static_cast<size_t>(channels_);
+void AudioMixer::DisableLimiter() {
+    limiter_.reset();
+}
 
-    for (const auto& input : inputs) {
-        if (input.samples == nullptr) {
-            continue;
+bool AudioMixer::MixMinusBlock(const std::vector<MixerInput>& inputs,
+                               const std::vector<MixMinusOutput>& outputs,
+                               size_t num_samples) const {
+    if (!initialized_) {
+        return false;
+    }
+    if (num_samples % static_cast<size_t>(channels_) != 0) {
+        return false;
+    }
+    if (num_samples == 0) {
+        return true;  // nothing to mix
+    }
+    for (const MixMinusOutput& output : outputs) {
+        if (output.samples == nullptr) {
+            return false;
+        }
+    }
+
+    AccumulateBlock(inputs, num_samples);
+    const Snapshot& snapshot = snapshots_[mix_slot_];
+    const float* bus = lane_accumulators_[0].data();
+
+    // First input entry of every track, so each output finds its own in O(1)
+    if (input_of_slot_.size() < snapshot.tracks.size()) {
+        input_of_slot_.resize(snapshot.tracks.size());
+    }
+    std::fill(input_of_slot_.begin(), input_of_slot_.end(), kNoSlot);
+    for (size_t index = 0; index < inputs.size(); ++index) {
+        const int32_t slot = FindSlot(snapshot, inputs[index].track_id);
+        if (slot != kNoSlot && inputs[index].samples != nullptr &&
+            input_of_slot_[static_cast<size_t>(slot)] == kNoSlot) {
+            input_of_slot_[static_cast<size_t>(slot)] = static_cast<int32_t>(index);
         }
-        const Track* track = FindTrack(input.track_id);
-        if (track == nullptr || track->muted) {
+    }
+    if (minus_scratch_.size() < num_samples) {
+        minus_scratch_.resize(num_samples);
+    }
+
+    // Each output is the bus minus its own track's weighted contribution,
+    // removed with exactly the gains it was added with, then clipped on its own
+    for (const MixMinusOutput& output : outputs) {
+        const int32_t slot = FindSlot(snapshot, output.track_id);
+        const int32_t index = slot != kNoSlot ? input_of_slot_[static_cast<size_t>(slot)] : kNoSlot;
+        if (index == kNoSlot) {
+            WriteOutput(bus, num_samples, output.samples);  // listen-only: the full mix
             continue;
         }
+        std::copy(bus, bus + num_samples, minus_scratch_.begin());
+        AccumulateTrack(snapshot.tracks[static_cast<size_t>(slot)],
+                        inputs[static_cast<size_t>(index)].samples, num_samples, -1.0f,
+                        minus_scratch_.data());
+        WriteOutput(minus_scratch_.data(), num_samples, output.samples);
+    }
+    FinishBlock();
+    return true;
+}
 
-        // Per-channel gain: linear "balance" pan for stereo, plain gain for mono.
-        float channel_gain[2] = {track->gain, track->gain};
-        if (channels_ == 2) {
-            const float pan = track->pan;
-            channel_gain[0] = track->gain * (pan <= 0.0f ? 1.0f : 1.0f - pan);
-            channel_gain[1] = track->gain * (pan >= 0.0f ? 1.0f : 1.0f + pan);
+void AudioMixer::AccumulateBlock(const std::vector<MixerInput>& inputs, size_t num_samples) const {
+    AcquireSnapshot();
+
+    // Accumulate every track's contribution in float so that summing loud
+    // tracks does not clip until the final conversion back to int16.
+    const size_t wanted_lanes = (inputs.size() + kMinInputsPerLane - 1) / kMinInputsPerLane;
+    const size_t lanes = std::clamp<size_t>(wanted_lanes, 1, num_lanes_);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        if (lane_accumulators_[lane].size() < num_samples) {
+            lane_accumulators_[lane].resize(num_samples);
+        }
+    }
+    job_inputs_ = &inputs;
+    job_samples_ = num_samples;
+    job_lanes_ = lanes;
+
+    if (lanes == 1) {
+        MixLane(0);
+    } else {
+        // Release the workers, mix our own share, then wait at the barrier
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            workers_busy_ = workers_.size();
+            ++block_seq_;
         }
+        block_ready_.notify_all();
+
+        MixLane(0);
+
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+        block_done_.wait(lock, [this] { return workers_busy_ == 0; });
+    }
 
+    // Pairwise tree reduction into lane 0: (0+1) + (2+3), ... in a fixed order
+    for (size_t stride = 1; stride < lanes; stride *= 2) {
+        for (size_t lane = 0; lane + stride < lanes; lane += 2 * stride) {
+            float* sum = lane_accumulators_[lane].data();
+            const float* partial = lane_accumulators_[lane + stride].data();
+            for (size_t i = 0; i < num_samples; ++i) {
+                sum[i] += partial[i];
+            }
+        }
+    }
+    job_inputs_ = nullptr;
+}
+
+void AudioMixer::WriteOutput(const float* mix, size_t num_samples, int16_t* output,
+                             bool limit) const {
+    const float target = snapshots_[mix_slot_].master_gain;
+    const size_t channels = static_cast<size_t>(channels_);
+    if (limit && limiter_) {
+        // Master gain into [-1, 1] scale, limit, then a conversion that never clips
+        if (limiter_scratch_.size() < num_samples) {
+            limiter_scratch_.resize(num_samples);
+        }
+        const float from = applied_master_gain_ < 0.0f ? target : applied_master_gain_;
+        const float step = (target - from) / static_cast<float>(num_samples / channels);
         for (size_t i = 0; i < num_samples; ++i) {
-            accumulator_[i] += static_cast<float>(input.samples[i]) * channel_gain[i % channels];
+            const float gain = from + step * static_cast<float>(i / channels + 1);
+            limiter_scratch_[i] = mix[i] * gain / kInt16Max;
         }
+        limiter_->Process(limiter_scratch_.data(), num_samples);
+        GetAudioKernels().float_to_int16(limiter_scratch_.data(), num_samples, output);
+        return;
     }
 
     // Apply master gain and clamp into the int16 output.
+    if (applied_master_gain_ < 0.0f || applied_master_gain_ == target) {
+        GetAudioKernels().scaled_float_to_int16(mix, num_samples, target, output);
+        return;
+    }
+    const float from = applied_master_gain_;
+    const float step = (target - from) / static_cast<float>(num_samples / channels);
     for (size_t i = 0; i < num_samples; ++i) {
-        const float value = std::clamp(accumulator_[i] * master_gain_, kInt16Min, kInt16Max);
-        output[i] = static_cast<int16_t>(value);
+        const float gain = from + step * static_cast<float>(i / channels + 1);
+        output[i] = static_cast<int16_t>(std::clamp(mix[i] * gain, kInt16Min, kInt16Max));
+    }
+}
+
+void AudioMixer::FinishBlock() const {
+    // Every ramp has reached its target
+    Snapshot& snapshot = snapshots_[mix_slot_];
+    for (TrackParams& params : snapshot.tracks) {
+        params.applied[0] = params.target[0];
+        params.applied[1] = params.target[1];
+    }
+    applied_master_gain_ = snapshot.master_gain;
+}
+
+int32_t AudioMixer::FindSlot(const Snapshot& snapshot, int track_id) {
+    if (track_id < 0 || static_cast<size_t>(track_id) >= snapshot.slot_of_id.size()) {
+        return kNoSlot;
+    }
+    return snapshot.slot_of_id[static_cast<size_t>(track_id)];
+}
+
+void AudioMixer::AccumulateTrack(const TrackParams& params, const int16_t* samples,
+                                 size_t num_samples, float sign, float* accumulator) const {
+    if (params.applied[0] == params.target[0] && params.applied[1] == params.target[1]) {
+        if (params.target[0] == 0.0f && params.target[1] == 0.0f) {
+            return;  // muted or silent
+        }
+        const float gains[2] = {sign * params.target[0], sign * params.target[1]};
+        GetAudioKernels().mix_int16(samples, num_samples, gains, accumulator);
+    } else {
+        // Negating both ends negates every ramp step exactly, so a subtraction
+        // removes precisely what the addition put in
+        const float from[2] = {sign * params.applied[0], sign * params.applied[1]};
+        const float to[2] = {sign * params.target[0], sign * params.target[1]};
+        MixInt16Ramp(samples, num_samples, static_cast<size_t>(channels_), from, to, accumulator);
+    }
+}
+
+void AudioMixer::MixLane(size_t lane) const {
+    if (lane >= job_lanes_) {
+        return;  // fewer inputs than lanes in this block
+    }
+    const std::vector<MixerInput>& inputs = *job_inputs_;
+    const size_t begin = inputs.size() * lane / job_lanes_;
+    const size_t end = inputs.size() * (lane + 1) / job_lanes_;
+    float* accumulator = lane_accumulators_[lane].data();
+    std::fill(accumulator, accumulator + job_samples_, 0.0f);
+
+    const Snapshot& snapshot = snapshots_[mix_slot_];
+    for (size_t index = begin; index < end; ++index) {
+        const MixerInput& input = inputs[index];
+        const int32_t slot = FindSlot(snapshot, input.track_id);
+        if (input.samples == nullptr || slot == kNoSlot) {
+            continue;
+        }
+        AccumulateTrack(snapshot.tracks[static_cast<size_t>(slot)], input.samples, job_samples_,
+                        1.0f, accumulator);
+    }
+}
+
+void AudioMixer::StartWorkers(size_t num_lanes) {
+    num_lanes_ = num_lanes;
+    stop_workers_ = false;
+    // Read before launching so no worker can miss the first block
+    const uint64_t start_seq = block_seq_;
+    workers_.reserve(num_lanes - 1);
+    for (size_t lane = 1; lane < num_lanes; ++lane) {
+        workers_.emplace_back(&AudioMixer::WorkerLoop, this, lane, start_seq);
+    }
+}
+
+void AudioMixer::StopWorkers() {
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            stop_workers_ = true;
+        }
+        block_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+    num_lanes_ = 1;
+}
+
+void AudioMixer::WorkerLoop(size_t lane, uint64_t seen) const {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    while (true) {
+        block_ready_.wait(lock, [&] { return block_seq_ != seen || stop_workers_; });
+        if (stop_workers_) {
+            return;
+        }
+        seen = block_seq_;
+
+        lock.unlock();
+        MixLane(lane);
+        lock.lock();
+
+        if (--workers_busy_ == 0) {
+            block_done_.notify_one();
+        }
     }
-    return true;
 }
 
 void AudioMixer::Reset() {
     tracks_.clear();
+    slot_of_id_.clear();
     next_track_id_ = 0;
     master_gain_ = 1.0f;
+    Publish();
 }
 
 }  // namespace ffvoice
@@ -5,8 +5,16 @@
 
 #pragma once
 
+#include "audio/lookahead_limiter.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace ffvoice {
@@ -19,6 +27,14 @@ struct MixerInput {
     const int16_t* samples;  ///< Interleaved int16 block; nullptr means silence.
 };
 
+/**
+ * @brief One participant's output for AudioMixer::MixMinusBlock().
+ */
+struct MixMinusOutput {
+    int track_id;      ///< Track left out of this mix; one not in the inputs gets the full mix.
+    int16_t* samples;  ///< Receives the interleaved int16 mix-minus block.
+};
+
 /**
  * @brief Mixes multiple int16 audio tracks down to a single output buffer.
  *
@@ -27,9 +43,32 @@ struct MixerInput {
  * clamps to int16, so combining loud tracks saturates cleanly instead of
  * wrapping around.
  *
- * The mixer keeps only track configuration as state — MixBlock() does not
- * retain audio between calls. It is not thread-safe: configure and mix from a
- * single thread, or synchronize externally.
+ * Tracks live in a dense array with an id -> slot table, so every per-track
+ * call and each MixBlock() input is an O(1) lookup, and the per-sample work
+ * runs through the SIMD kernels in utils/audio_kernels.h.
+ *
+ * For hundreds of tracks SetNumThreads() splits each block's inputs across
+ * persistent workers. Every lane sums its contiguous share of the inputs into
+ * its own float accumulator; the partial mixes are then added pairwise in a
+ * fixed tree order before the master gain and clamp. The summation order
+ * depends only on the input list and the thread count, so the output is
+ * bit-identical from run to run at a given thread count (and, with one
+ * thread, identical to serial mixing).
+ *
+ * Threading: one control thread may call AddTrack(), RemoveTrack(), the
+ * Set*() / Get*() track and master controls and Reset() while one audio
+ * thread calls MixBlock(), with no lock between them. Every control change
+ * publishes a fresh copy of the track parameters (O(tracks), on the control
+ * thread) through a lock-free four-slot buffer; MixBlock() picks up the newest
+ * copy at the start of a block, so a block never sees half an update and
+ * neither thread ever waits for the other. A gain, pan, mute or master change
+ * is ramped linearly across the next block instead of stepping, which avoids
+ * zipper noise; new tracks and the first block start at the set gain.
+ * Initialize() and SetNumThreads() must not overlap MixBlock().
+ *
+ * The mixer keeps only track configuration and the per-track ramp position as
+ * state — MixBlock() does not retain audio between calls, unless
+ * EnableLimiter() adds its lookahead delay.
  *
  * Usage:
  * @code
@@ -50,7 +89,14 @@ public:
     /// Maximum linear gain accepted for a track or the master (~ +18 dB).
     static constexpr float kMaxGain = 8.0f;
 
+    /// Fewest inputs per lane before another thread is used for a block.
+    static constexpr size_t kMinInputsPerLane = 16;
+
     AudioMixer() = default;
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
 
     /**
      * @brief Initialize the mixer. Clears any existing tracks and master gain.
@@ -114,6 +160,48 @@ public:
         return master_gain_;
     }
 
+    /**
+     * @brief Set the threads that share each MixBlock() call.
+     *
+     * 0 or 1 mixes on the calling thread. Larger values start num_threads - 1
+     * persistent workers; the caller mixes its own share and waits for the rest.
+     * A block uses at most one lane per kMinInputsPerLane inputs, so small mixes
+     * stay serial. Must not be called concurrently with MixBlock().
+     *
+     * @param num_threads Lanes per block, clamped to [1, 64].
+     */
+    void SetNumThreads(int num_threads);
+
+    int GetNumThreads() const {
+        return static_cast<int>(num_lanes_);
+    }
+
+    /**
+     * @brief Limit MixBlock() output with a LookaheadLimiter instead of clipping it
+     *
+     * The master-gained mix goes through the limiter before the int16
+     * conversion, so loud overlaps are turned down smoothly ahead of each
+     * peak rather than clipped. The output is delayed by GetLatencyFrames().
+     * MixMinusBlock() outputs keep the plain clamp. Must not be called
+     * concurrently with MixBlock(); Initialize() re-initializes the limiter
+     * for the new format.
+     *
+     * @return false if the mixer is not initialized or @p config is invalid
+     */
+    bool EnableLimiter(const LookaheadLimiterConfig& config = LookaheadLimiterConfig{});
+
+    /// Back to clipping (the limiter's delayed audio is discarded)
+    void DisableLimiter();
+
+    bool IsLimiterEnabled() const {
+        return limiter_ != nullptr;
+    }
+
+    /// Frames MixBlock() output lags its inputs (the limiter's lookahead, else 0)
+    size_t GetLatencyFrames() const {
+        return limiter_ ? limiter_->GetLatencyFrames() : 0;
+    }
+
     /**
      * @brief Mix one block of audio.
      *
@@ -123,12 +211,36 @@ public:
      * id is unknown all contribute silence. @p output receives @p num_samples
      * mixed samples.
      *
+     * Parameter changes published since the previous block take effect here,
+     * ramped from the previous gains to the new ones over the block.
+     *
      * @return false if the mixer is not initialized, @p num_samples is not a
      *         multiple of the channel count, or @p output is null.
      */
     bool MixBlock(const std::vector<MixerInput>& inputs, int16_t* output, size_t num_samples) const;
 
-    /// Remove all tracks and reset the master gain to 1.0 (stays initialized).
+    /**
+     * @brief Mix one block into a separate "mix-minus" output per participant.
+     *
+     * Conference bridges send every participant the mix of everyone else
+     * (N-1). The full bus is summed once, exactly as MixBlock() does, and each
+     * output is the bus with its own track's weighted contribution subtracted,
+     * then master-gained and clipped on its own: O(tracks + outputs) per
+     * sample instead of the O(N^2) of N MixBlock() calls. Only the first input
+     * entry of a track is subtracted. Because the subtraction happens in float
+     * after the sum, an output may differ from separately mixing the other
+     * tracks by float rounding (well under one int16 step).
+     *
+     * @param inputs As for MixBlock().
+     * @param outputs One entry per listener; every samples pointer must hold
+     *        @p num_samples samples.
+     * @return false for the same conditions as MixBlock(), or if any output
+     *         pointer is null.
+     */
+    bool MixMinusBlock(const std::vector<MixerInput>& inputs,
+                       const std::vector<MixMinusOutput>& outputs, size_t num_samples) const;
+
+    /// Remove all tracks and reset the master gain to 1.0 (stays initialized; ids restart at 0).
     void Reset();
 
 private:
@@ -139,19 +251,109 @@ private:
         bool muted;
     };
 
+    /// Mixing view of one track, as published to the audio thread
+    struct TrackParams {
+        int id;
+        float target[2];   ///< Per-channel gain (pan and mute applied)
+        float applied[2];  ///< Gain reached at the end of the last block (audio thread)
+    };
+
+    /// Immutable-while-shared copy of everything MixBlock() reads
+    struct Snapshot {
+        std::vector<TrackParams> tracks;
+        std::vector<int32_t> slot_of_id;  ///< Mirrors AudioMixer::slot_of_id_
+        float master_gain = 1.0f;
+    };
+
+    /// Slot table entry of an id that was removed or never issued
+    static constexpr int32_t kNoSlot = -1;
+
+    /// shared_slot_ flag: the shared snapshot is newer than the audio thread's
+    static constexpr uint32_t kFreshSnapshot = 4;
+
     const Track* FindTrack(int track_id) const;
     Track* FindTrack(int track_id);
 
+    /// Control thread: copy tracks_ and master_gain_ into a snapshot and share it
+    void Publish();
+
+    /// Audio thread: adopt the newest shared snapshot, carrying ramp positions over
+    void AcquireSnapshot() const;
+
+    /// Slot of @p track_id in @p snapshot, or kNoSlot
+    static int32_t FindSlot(const Snapshot& snapshot, int track_id);
+
+    /// Adopt the newest snapshot and sum @p inputs into lane_accumulators_[0]
+    void AccumulateBlock(const std::vector<MixerInput>& inputs, size_t num_samples) const;
+
+    /// Add (sign 1) or remove (sign -1) one track's block with its current gains/ramp
+    void AccumulateTrack(const TrackParams& params, const int16_t* samples, size_t num_samples,
+                         float sign, float* accumulator) const;
+
+    /// Master gain (ramped if it changed) and clamp of a float mix into int16;
+    /// @p limit routes it through limiter_ (if enabled) before the conversion
+    void WriteOutput(const float* mix, size_t num_samples, int16_t* output,
+                     bool limit = false) const;
+
+    /// Mark every ramp of the current snapshot as complete
+    void FinishBlock() const;
+
+    /// Sum lane @p lane's share of job_inputs_ into lane_accumulators_[lane]
+    void MixLane(size_t lane) const;
+
+    void StartWorkers(size_t num_lanes);
+    void StopWorkers();
+    void WorkerLoop(size_t lane, uint64_t seen) const;
+
     bool initialized_ = false;
     int sample_rate_ = 0;
     int channels_ = 0;
     int next_track_id_ = 0;
     float master_gain_ = 1.0f;
-    std::vector<Track> tracks_;
+    std::vector<Track> tracks_;  ///< Dense; RemoveTrack() moves the last track into the hole
+
+    /// Index into tracks_ per issued id (ids are never reused until Initialize()/Reset())
+    std::vector<int32_t> slot_of_id_;
+
+    // Four-slot snapshot exchange. The control thread owns publish_slot_, the
+    // audio thread owns mix_slot_ and spare_slot_, and shared_slot_ holds the
+    // fourth (plus kFreshSnapshot). The audio thread swaps in its spare rather
+    // than its old snapshot, so it can still read the old one while carrying
+    // the ramp positions over. Slots are never freed, only refilled.
+    mutable std::array<Snapshot, 4> snapshots_;
+    mutable std::atomic<uint32_t> shared_slot_{2};
+    uint32_t publish_slot_ = 3;
+    mutable uint32_t mix_slot_ = 0;
+    mutable uint32_t spare_slot_ = 1;
+    /// Master gain the last block ended at (negative before the first block)
+    mutable float applied_master_gain_ = -1.0f;
+
+    // One float accumulator per lane, grown to the largest block and then
+    // reused so the audio path does not allocate. mutable because MixBlock() is
+    // logically const; the same goes for the block being mixed (job_*).
+    mutable std::vector<std::vector<float>> lane_accumulators_{1};
+    mutable const std::vector<MixerInput>* job_inputs_ = nullptr;
+    mutable size_t job_samples_ = 0;
+    mutable size_t job_lanes_ = 1;  ///< Lanes with inputs in the current block
+
+    // MixMinusBlock() scratch, grown like lane_accumulators_
+    mutable std::vector<int32_t> input_of_slot_;  ///< First input index per track slot
+    mutable std::vector<float> minus_scratch_;    ///< Bus minus one track
+
+    // Optional output limiter; only MixBlock() touches its state
+    std::unique_ptr<LookaheadLimiter> limiter_;
+    mutable std::vector<float> limiter_scratch_;  ///< Mix at [-1, 1] scale
 
-    // Float scratch buffer reused across MixBlock() calls to avoid per-call
-    // allocation on the audio path. mutable because MixBlock() is logically const.
-    mutable std::vector<float> accumulator_;
+    // Per-block barrier, as in RNNoiseProcessor: the caller bumps block_seq_,
+    // each worker decrements workers_busy_ when its share is summed.
+    std::vector<std::thread> workers_;
+    size_t num_lanes_ = 1;  ///< Threads sharing each block (workers + caller)
+    mutable std::mutex pool_mutex_;
+    mutable std::condition_variable block_ready_;  ///< Caller -> workers: block_seq_ changed
+    mutable std::condition_variable block_done_;   ///< Last worker -> caller: workers_busy_ is 0
+    mutable uint64_t block_seq_ = 0;
+    mutable size_t workers_busy_ = 0;
+    bool stop_workers_ = false;
 };
 
 }  // namespace ffvoice
@@ -10,7 +10,9 @@
 
 #include "audio/audio_processor.h"
 
+#include "utils/audio_kernels.h"
 #include "utils/logger.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 #include <cmath>
@@ -18,6 +20,24 @@
 
 namespace ffvoice {
 
+// ============================================================================
+// AudioProcessor Implementation
+// ============================================================================
+
+void AudioProcessor::Process(float* samples, size_t num_samples) {
+    if (num_samples == 0)
+        return;
+
+    // Fallback for int16-only processors (grows once, then reused)
+    if (int16_scratch_.size() < num_samples) {
+        int16_scratch_.resize(num_samples);
+    }
+    const AudioKernels& kernels = GetAudioKernels();
+    kernels.float_to_int16(samples, num_samples, int16_scratch_.data());
+    Process(int16_scratch_.data(), num_samples);
+    kernels.int16_to_float(int16_scratch_.data(), num_samples, samples);
+}
+
 // ============================================================================
 // VolumeNormalizer Implementation
 // ============================================================================
@@ -49,42 +69,16 @@ bool VolumeNormalizer::Initialize(int sample_rate, int channels) {
 }
 
 void VolumeNormalizer::Process(int16_t* samples, size_t num_samples) {
-    if (num_samples == 0)
-        return;
-
-    constexpr float max_sample = 32767.0f;
-    constexpr float min_gain = 0.1f;
-    constexpr float max_gain = 10.0f;
-
-    // Process in frames
-    size_t num_frames = num_samples / channels_;
+    const size_t num_frames = num_samples / channels_;
+    for (size_t i = 0; i < num_frames; ++i) {
+        ProcessFrame(samples + i * channels_);
+    }
+}
 
+void VolumeNormalizer::Process(float* samples, size_t num_samples) {
+    const size_t num_frames = num_samples / channels_;
     for (size_t i = 0; i < num_frames; ++i) {
-        // Calculate RMS for this frame
-        float sum_squares = 0.0f;
-        for (int ch = 0; ch < channels_; ++ch) {
-            size_t idx = i * channels_ + ch;
-            float sample = samples[idx] / max_sample;
-            sum_squares += sample * sample;
-        }
-        float rms = std::sqrt(sum_squares / channels_);
-
-        // Calculate desired gain
-        float desired_gain = (rms > 0.001f) ? (target_level_ / rms) : 1.0f;
-        desired_gain = std::clamp(desired_gain, min_gain, max_gain);
-
-        // Smooth gain adjustment (attack/release)
-        float coeff = (desired_gain > current_gain_) ? attack_coeff_ : release_coeff_;
-        current_gain_ = current_gain_ + coeff * (desired_gain - current_gain_);
-
-        // Apply gain to all channels in this frame
-        for (int ch = 0; ch < channels_; ++ch) {
-            size_t idx = i * channels_ + ch;
-            float processed = samples[idx] * current_gain_;
-            // Clamp to prevent overflow
-            processed = std::clamp(processed, -max_sample, max_sample);
-            samples[idx] = static_cast<int16_t>(processed);
-        }
+        ProcessFrame(samples + i * channels_);
     }
 }
 
@@ -119,33 +113,16 @@ bool HighPassFilter::Initialize(int sample_rate, int channels) {
 }
 
 void HighPassFilter::Process(int16_t* samples, size_t num_samples) {
-    if (num_samples == 0)
-        return;
-
-    constexpr float max_sample = 32767.0f;
-
-    // Process samples
-    size_t num_frames = num_samples / channels_;
-
+    const size_t num_frames = num_samples / channels_;
     for (size_t i = 0; i < num_frames; ++i) {
-        for (int ch = 0; ch < channels_; ++ch) {
-            size_t idx = i * channels_ + ch;
-
-            // Convert to normalized float
-            float input = samples[idx] / max_sample;
-
-            // First-order high-pass filter:
-            // y[n] = alpha * (y[n-1] + x[n] - x[n-1])
-            float output = alpha_ * (prev_output_[ch] + input - prev_input_[ch]);
-
-            // Update state
-            prev_input_[ch] = input;
-            prev_output_[ch] = output;
+        ProcessFrame(samples + i * channels_);
+    }
+}
 
-            // Convert back to int16_t
-            output = std::clamp(output * max_sample, -max_sample, max_sample);
-            samples[idx] = static_cast<int16_t>(output);
-        }
+void HighPassFilter::Process(float* samples, size_t num_samples) {
+    const size_t num_frames = num_samples / channels_;
+    for (size_t i = 0; i < num_frames; ++i) {
+        ProcessFrame(samples + i * channels_);
     }
 }
 
@@ -161,6 +138,8 @@ void HighPassFilter::Reset() {
 void AudioProcessorChain::AddProcessor(std::unique_ptr<AudioProcessor> processor) {
     if (processor) {
         LOG_INFO("Adding processor to chain: %s", processor->GetName().c_str());
+        timings_.push_back(
+            &MetricsRegistry::Instance().Histogram("processor." + processor->GetName() + "_us"));
         processors_.push_back(std::move(processor));
     }
 }
@@ -183,10 +162,29 @@ bool AudioProcessorChain::Initialize(int sample_rate, int channels) {
 }
 
 void AudioProcessorChain::Process(int16_t* samples, size_t num_samples) {
+    FFVOICE_TRACE_SCOPE("AudioProcessorChain::Process");
     // Process through each processor in sequence
-    for (auto& processor : processors_) {
-        processor->Process(samples, num_samples);
+    for (size_t i = 0; i < processors_.size(); ++i) {
+        ScopedTimer timer(*timings_[i]);
+        processors_[i]->Process(samples, num_samples);
+    }
+}
+
+void AudioProcessorChain::Process(float* samples, size_t num_samples) {
+    FFVOICE_TRACE_SCOPE("AudioProcessorChain::Process");
+    // Stays in float between stages; no intermediate int16 conversion
+    for (size_t i = 0; i < processors_.size(); ++i) {
+        ScopedTimer timer(*timings_[i]);
+        processors_[i]->Process(samples, num_samples);
+    }
+}
+
+size_t AudioProcessorChain::GetLatencyFrames() const {
+    size_t latency = 0;
+    for (const auto& processor : processors_) {
+        latency += processor->GetLatencyFrames();
     }
+    return latency;
 }
 
 void AudioProcessorChain::Reset() {
@@ -5,18 +5,53 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "utils/metrics.h"
+
 namespace ffvoice {
 
+namespace detail {
+
+// Sample types the built-in processors are instantiated for. kFullScale maps a
+// sample to [-1, 1]; Store() converts a processed value back (int16 clamps,
+// float keeps headroom until the int16 boundary).
+template <typename Sample>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<int16_t> {
+    static constexpr float kFullScale = 32767.0f;
+    static int16_t Store(float value) {
+        return static_cast<int16_t>(std::clamp(value, -kFullScale, kFullScale));
+    }
+};
+
+template <>
+struct SampleTraits<float> {
+    static constexpr float kFullScale = 1.0f;
+    static float Store(float value) {
+        return value;
+    }
+};
+
+}  // namespace detail
+
 /**
  * @brief Abstract audio processor interface
  *
  * Base class for all audio processing modules.
  * Processes audio in-place for efficiency.
+ *
+ * Two sample types are supported: int16 and float in [-1, 1]. A chain fed from
+ * a paFloat32 capture stays in float through every stage and is converted to
+ * int16 once, where it reaches the file writer. Float stages do not clamp, so
+ * intermediate peaks above full scale survive until that conversion.
  */
 class AudioProcessor {
 public:
@@ -37,6 +72,18 @@ public:
      */
     virtual void Process(int16_t* samples, size_t num_samples) = 0;
 
+    /**
+     * @brief Process float samples in-place
+     *
+     * The default converts to int16, calls the int16 overload and converts
+     * back, so processors that only implement int16 still work in a float
+     * chain. Built-in processors override it with native float code.
+     *
+     * @param samples Audio samples (float interleaved, nominally [-1, 1])
+     * @param num_samples Number of samples (not frames!)
+     */
+    virtual void Process(float* samples, size_t num_samples);
+
     /**
      * @brief Reset processor state
      */
@@ -47,9 +94,23 @@ public:
      */
     virtual std::string GetName() const = 0;
 
+    /**
+     * @brief Frames by which the output currently lags the input
+     *
+     * 0 for processors that filter in place. Chains report the sum of their
+     * stages, so a caller can shift timestamps or delay an unprocessed path
+     * to line up with the processed one.
+     */
+    virtual size_t GetLatencyFrames() const {
+        return 0;
+    }
+
 protected:
     int sample_rate_ = 0;
     int channels_ = 0;
+
+private:
+    std::vector<int16_t> int16_scratch_;  ///< Default float Process() round-trip buffer
 };
 
 /**
@@ -71,12 +132,27 @@ public:
 
     bool Initialize(int sample_rate, int channels) override;
     void Process(int16_t* samples, size_t num_samples) override;
+    void Process(float* samples, size_t num_samples) override;
     void Reset() override;
     std::string GetName() const override {
         return "VolumeNormalizer";
     }
 
+    /**
+     * @brief Process one interleaved frame of float samples in place
+     *
+     * Per-sample hook that lets ProcessorChain fuse this stage with its
+     * neighbours in one loop; equivalent to the float Process() on one frame.
+     */
+    void ProcessFusedFrame(float* frame) {
+        ProcessFrame(frame);
+    }
+
 private:
+    /// One interleaved frame (channels_ samples); shared by every sample type
+    template <typename Sample>
+    void ProcessFrame(Sample* frame);
+
     float target_level_;
     float attack_time_;
     float release_time_;
@@ -89,7 +165,8 @@ private:
  * @brief High-pass filter to remove low-frequency noise
  *
  * Removes rumble, breathing sounds, and other low-frequency noise.
- * Uses a simple first-order IIR filter.
+ * Uses a simple first-order IIR filter (6 dB/octave); BiquadCascade
+ * (audio/biquad_cascade.h) gives steeper, vectorized high-pass filtering.
  */
 class HighPassFilter : public AudioProcessor {
 public:
@@ -101,18 +178,84 @@ public:
 
     bool Initialize(int sample_rate, int channels) override;
     void Process(int16_t* samples, size_t num_samples) override;
+    void Process(float* samples, size_t num_samples) override;
     void Reset() override;
     std::string GetName() const override {
         return "HighPassFilter";
     }
 
+    /**
+     * @brief Process one interleaved frame of float samples in place
+     *
+     * Per-sample hook that lets ProcessorChain fuse this stage with its
+     * neighbours in one loop; equivalent to the float Process() on one frame.
+     */
+    void ProcessFusedFrame(float* frame) {
+        ProcessFrame(frame);
+    }
+
 private:
+    /// One interleaved frame (channels_ samples); shared by every sample type
+    template <typename Sample>
+    void ProcessFrame(Sample* frame);
+
     float cutoff_freq_;
     float alpha_;                     // Filter coefficient
     std::vector<float> prev_input_;   // Previous input per channel
     std::vector<float> prev_output_;  // Previous output per channel
 };
 
+template <typename Sample>
+inline void VolumeNormalizer::ProcessFrame(Sample* frame) {
+    using Traits = detail::SampleTraits<Sample>;
+    constexpr float max_sample = Traits::kFullScale;
+    constexpr float min_gain = 0.1f;
+    constexpr float max_gain = 10.0f;
+
+    // Calculate RMS for this frame
+    float sum_squares = 0.0f;
+    for (int ch = 0; ch < channels_; ++ch) {
+        float sample = frame[ch] / max_sample;
+        sum_squares += sample * sample;
+    }
+    float rms = std::sqrt(sum_squares / channels_);
+
+    // Calculate desired gain
+    float desired_gain = (rms > 0.001f) ? (target_level_ / rms) : 1.0f;
+    desired_gain = std::clamp(desired_gain, min_gain, max_gain);
+
+    // Smooth gain adjustment (attack/release)
+    float coeff = (desired_gain > current_gain_) ? attack_coeff_ : release_coeff_;
+    current_gain_ = current_gain_ + coeff * (desired_gain - current_gain_);
+
+    // Apply gain to all channels in this frame (int16 clamps to prevent overflow)
+    for (int ch = 0; ch < channels_; ++ch) {
+        frame[ch] = Traits::Store(frame[ch] * current_gain_);
+    }
+}
+
+template <typename Sample>
+inline void HighPassFilter::ProcessFrame(Sample* frame) {
+    using Traits = detail::SampleTraits<Sample>;
+    constexpr float max_sample = Traits::kFullScale;
+
+    for (int ch = 0; ch < channels_; ++ch) {
+        // Convert to normalized float
+        float input = frame[ch] / max_sample;
+
+        // First-order high-pass filter:
+        // y[n] = alpha * (y[n-1] + x[n] - x[n-1])
+        float output = alpha_ * (prev_output_[ch] + input - prev_input_[ch]);
+
+        // Update state
+        prev_input_[ch] = input;
+        prev_output_[ch] = output;
+
+        // Convert back to the sample type
+        frame[ch] = Traits::Store(output * max_sample);
+    }
+}
+
 /**
  * @brief Chain multiple audio processors
  *
@@ -129,11 +272,15 @@ public:
 
     bool Initialize(int sample_rate, int channels) override;
     void Process(int16_t* samples, size_t num_samples) override;
+    void Process(float* samples, size_t num_samples) override;
     void Reset() override;
     std::string GetName() const override {
         return "AudioProcessorChain";
     }
 
+    /// Sum of the stages' latencies
+    size_t GetLatencyFrames() const override;
+
     /**
      * @brief Get number of processors in chain
      */
@@ -143,6 +290,7 @@ public:
 
 private:
     std::vector<std::unique_ptr<AudioProcessor>> processors_;
+    std::vector<MetricHistogram*> timings_;  ///< processor.<name>_us, parallel to processors_
 };
 
 }  // namespace ffvoice
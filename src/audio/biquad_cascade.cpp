@@ -0,0 +1,346 @@
+/**
+ * @file biquad_cascade.cpp
+ * @brief BiquadCascade design and its SSE2 / NEON wavefront kernel
+ */
+
+#include "audio/biquad_cascade.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define FFVOICE_BIQUAD_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define FFVOICE_BIQUAD_NEON
+#endif
+
+namespace ffvoice {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Frames per float sub-block in the int16 Process() (keeps scratch_ in L1)
+constexpr size_t kInt16BlockFrames = 256;
+
+constexpr int kMaxButterworthOrder = 16;
+
+std::vector<BiquadSection> Butterworth(BiquadType type, float cutoff, int order) {
+    std::vector<BiquadSection> sections;
+    if (order < 2 || order > kMaxButterworthOrder || order % 2 != 0) {
+        return sections;
+    }
+    // Pole pair k of an order-N Butterworth filter has Q = 1 / (2 sin((2k + 1) pi / 2N))
+    for (int k = 0; k < order / 2; ++k) {
+        BiquadSection section;
+        section.type = type;
+        section.frequency = cutoff;
+        section.q = static_cast<float>(1.0 / (2.0 * std::sin((2 * k + 1) * kPi / (2 * order))));
+        sections.push_back(section);
+    }
+    return sections;
+}
+
+const char* TypeName(BiquadType type) {
+    switch (type) {
+        case BiquadType::HighPass:
+            return "high-pass";
+        case BiquadType::LowPass:
+            return "low-pass";
+        case BiquadType::LowShelf:
+            return "low-shelf";
+        case BiquadType::HighShelf:
+            return "high-shelf";
+        case BiquadType::Notch:
+            return "notch";
+        case BiquadType::Peaking:
+        default:
+            return "peaking";
+    }
+}
+
+}  // namespace
+
+BiquadCascade::BiquadCascade() : BiquadCascade(ButterworthHighPass(80.0f, 4)) {
+}
+
+BiquadCascade::BiquadCascade(std::vector<BiquadSection> sections)
+    : sections_(std::move(sections)) {
+}
+
+std::vector<BiquadSection> BiquadCascade::ButterworthHighPass(float cutoff, int order) {
+    return Butterworth(BiquadType::HighPass, cutoff, order);
+}
+
+std::vector<BiquadSection> BiquadCascade::ButterworthLowPass(float cutoff, int order) {
+    return Butterworth(BiquadType::LowPass, cutoff, order);
+}
+
+BiquadCoefficients BiquadCascade::Design(const BiquadSection& section, int sample_rate) {
+    const double w0 = 2.0 * kPi * section.frequency / sample_rate;
+    const double cos_w0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * section.q);
+    const double a = std::pow(10.0, section.gain_db / 40.0);  // Shelf / peak amplitude
+    const double sqrt_a_alpha = 2.0 * std::sqrt(a) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    switch (section.type) {
+        case BiquadType::HighPass:
+            b0 = (1.0 + cos_w0) / 2.0;
+            b1 = -(1.0 + cos_w0);
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha;
+            break;
+        case BiquadType::LowPass:
+            b0 = (1.0 - cos_w0) / 2.0;
+            b1 = 1.0 - cos_w0;
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha;
+            break;
+        case BiquadType::LowShelf:
+            b0 = a * ((a + 1.0) - (a - 1.0) * cos_w0 + sqrt_a_alpha);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cos_w0 - sqrt_a_alpha);
+            a0 = (a + 1.0) + (a - 1.0) * cos_w0 + sqrt_a_alpha;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0);
+            a2 = (a + 1.0) + (a - 1.0) * cos_w0 - sqrt_a_alpha;
+            break;
+        case BiquadType::HighShelf:
+            b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + sqrt_a_alpha);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - sqrt_a_alpha);
+            a0 = (a + 1.0) - (a - 1.0) * cos_w0 + sqrt_a_alpha;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0);
+            a2 = (a + 1.0) - (a - 1.0) * cos_w0 - sqrt_a_alpha;
+            break;
+        case BiquadType::Notch:
+            b0 = 1.0;
+            b1 = -2.0 * cos_w0;
+            b2 = 1.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha;
+            break;
+        case BiquadType::Peaking:
+            b0 = 1.0 + alpha * a;
+            b1 = -2.0 * cos_w0;
+            b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a;
+            a1 = -2.0 * cos_w0;
+            a2 = 1.0 - alpha / a;
+            break;
+    }
+
+    BiquadCoefficients coefficients;
+    coefficients.b0 = b0 / a0;
+    coefficients.b1 = b1 / a0;
+    coefficients.b2 = b2 / a0;
+    coefficients.a1 = a1 / a0;
+    coefficients.a2 = a2 / a0;
+    return coefficients;
+}
+
+bool BiquadCascade::Initialize(int sample_rate, int channels) {
+    if (sample_rate <= 0 || channels <= 0) {
+        LOG_ERROR("BiquadCascade: invalid format (%d Hz, %d channels)", sample_rate, channels);
+        return false;
+    }
+    if (sections_.empty()) {
+        LOG_ERROR("BiquadCascade: no sections (Butterworth order must be even, 2-%d)",
+                  kMaxButterworthOrder);
+        return false;
+    }
+    for (const auto& section : sections_) {
+        if (!(section.frequency > 0.0f && section.frequency < sample_rate / 2.0f) ||
+            !(section.q > 0.0f)) {
+            LOG_ERROR("BiquadCascade: invalid %s section (%.1f Hz, Q %.3f) at %d Hz",
+                      TypeName(section.type), section.frequency, section.q, sample_rate);
+            return false;
+        }
+    }
+
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    num_sections_ = sections_.size();
+
+    designs_.clear();
+    for (const auto& section : sections_) {
+        designs_.push_back(Design(section, sample_rate));
+    }
+
+    const size_t used_lanes = static_cast<size_t>(channels) * num_sections_;
+    num_lanes_ = (used_lanes + kLaneWidth - 1) / kLaneWidth * kLaneWidth;
+
+    // Padding lanes keep zero coefficients, so their state stays zero
+    for (auto* lane : {&b0_, &b1_, &b2_, &a1_, &a2_}) {
+        lane->assign(num_lanes_, 0.0f);
+    }
+    for (size_t ch = 0; ch < static_cast<size_t>(channels); ++ch) {
+        for (size_t k = 0; k < num_sections_; ++k) {
+            const size_t lane = ch * num_sections_ + k;
+            b0_[lane] = static_cast<float>(designs_[k].b0);
+            b1_[lane] = static_cast<float>(designs_[k].b1);
+            b2_[lane] = static_cast<float>(designs_[k].b2);
+            a1_[lane] = static_cast<float>(designs_[k].a1);
+            a2_[lane] = static_cast<float>(designs_[k].a2);
+        }
+    }
+    s1_.assign(num_lanes_, 0.0f);
+    s2_.assign(num_lanes_, 0.0f);
+    x_.assign(num_lanes_, 0.0f);
+    y_.assign(num_lanes_, 0.0f);
+    scratch_.assign(kInt16BlockFrames * static_cast<size_t>(channels), 0.0f);
+
+    LOG_INFO("BiquadCascade initialized: %zu sections, %d channels, %zu SIMD lanes",
+             num_sections_, channels, num_lanes_);
+    return true;
+}
+
+void BiquadCascade::Process(int16_t* samples, size_t num_samples) {
+    using Traits = detail::SampleTraits<int16_t>;
+    if (num_lanes_ == 0) {
+        return;
+    }
+    // The filter is linear, so it runs directly at int16 scale
+    const auto channels = static_cast<size_t>(channels_);
+    size_t num_frames = num_samples / channels;
+    while (num_frames > 0) {
+        const size_t frames = std::min(num_frames, kInt16BlockFrames);
+        const size_t count = frames * channels;
+        for (size_t i = 0; i < count; ++i) {
+            scratch_[i] = static_cast<float>(samples[i]);
+        }
+        ProcessFrames(scratch_.data(), frames);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = Traits::Store(scratch_[i]);
+        }
+        samples += count;
+        num_frames -= frames;
+    }
+}
+
+void BiquadCascade::Process(float* samples, size_t num_samples) {
+    if (num_lanes_ == 0) {
+        return;
+    }
+    ProcessFrames(samples, num_samples / static_cast<size_t>(channels_));
+}
+
+void BiquadCascade::Reset() {
+    std::fill(s1_.begin(), s1_.end(), 0.0f);
+    std::fill(s2_.begin(), s2_.end(), 0.0f);
+}
+
+void BiquadCascade::ProcessFrames(float* samples, size_t num_frames) {
+    if (num_frames == 0) {
+        return;
+    }
+    const auto channels = static_cast<size_t>(channels_);
+    const size_t last = num_sections_ - 1;
+
+    // Step t feeds frame t into section 0 and takes frame t - last out of the
+    // final section; in place is safe because that frame was already read.
+    for (size_t t = 0; t < num_frames + last; ++t) {
+        // Each section's input is the previous section's output from the last step
+        if (num_lanes_ > 1) {
+            std::memmove(x_.data() + 1, y_.data(), (num_lanes_ - 1) * sizeof(float));
+        }
+        const float* in = samples + t * channels;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            x_[ch * num_sections_] = t < num_frames ? in[ch] : 0.0f;
+        }
+
+        if (t >= last && t < num_frames) {
+            StepAllLanes();
+        } else {
+            StepValidLanes(t, num_frames);
+        }
+
+        if (t >= last) {
+            float* out = samples + (t - last) * channels;
+            for (size_t ch = 0; ch < channels; ++ch) {
+                out[ch] = y_[ch * num_sections_ + last];
+            }
+        }
+    }
+}
+
+void BiquadCascade::StepAllLanes() {
+    // Same operation order as StepValidLanes(), so both give identical results
+#if defined(FFVOICE_BIQUAD_SSE2)
+    for (size_t l = 0; l < num_lanes_; l += kLaneWidth) {
+        const __m128 x = _mm_loadu_ps(&x_[l]);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b0_[l]), x), _mm_loadu_ps(&s1_[l]));
+        const __m128 s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b1_[l]), x),
+                                                _mm_mul_ps(_mm_loadu_ps(&a1_[l]), y)),
+                                     _mm_loadu_ps(&s2_[l]));
+        const __m128 s2 = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b2_[l]), x),
+                                     _mm_mul_ps(_mm_loadu_ps(&a2_[l]), y));
+        _mm_storeu_ps(&y_[l], y);
+        _mm_storeu_ps(&s1_[l], s1);
+        _mm_storeu_ps(&s2_[l], s2);
+    }
+#elif defined(FFVOICE_BIQUAD_NEON)
+    for (size_t l = 0; l < num_lanes_; l += kLaneWidth) {
+        const float32x4_t x = vld1q_f32(&x_[l]);
+        const float32x4_t y = vaddq_f32(vmulq_f32(vld1q_f32(&b0_[l]), x), vld1q_f32(&s1_[l]));
+        const float32x4_t s1 = vaddq_f32(
+            vsubq_f32(vmulq_f32(vld1q_f32(&b1_[l]), x), vmulq_f32(vld1q_f32(&a1_[l]), y)),
+            vld1q_f32(&s2_[l]));
+        const float32x4_t s2 =
+            vsubq_f32(vmulq_f32(vld1q_f32(&b2_[l]), x), vmulq_f32(vld1q_f32(&a2_[l]), y));
+        vst1q_f32(&y_[l], y);
+        vst1q_f32(&s1_[l], s1);
+        vst1q_f32(&s2_[l], s2);
+    }
+#else
+    for (size_t l = 0; l < num_lanes_; ++l) {
+        const float x = x_[l];
+        const float y = b0_[l] * x + s1_[l];
+        s1_[l] = (b1_[l] * x - a1_[l] * y) + s2_[l];
+        s2_[l] = b2_[l] * x - a2_[l] * y;
+        y_[l] = y;
+    }
+#endif
+}
+
+void BiquadCascade::StepValidLanes(size_t t, size_t num_frames) {
+    const size_t used_lanes = static_cast<size_t>(channels_) * num_sections_;
+    for (size_t l = 0; l < used_lanes; ++l) {
+        // Section k is k frames behind section 0
+        const size_t k = l % num_sections_;
+        if (t < k || t - k >= num_frames) {
+            continue;
+        }
+        const float x = x_[l];
+        const float y = b0_[l] * x + s1_[l];
+        s1_[l] = (b1_[l] * x - a1_[l] * y) + s2_[l];
+        s2_[l] = b2_[l] * x - a2_[l] * y;
+        y_[l] = y;
+    }
+}
+
+double BiquadCascade::GetMagnitudeResponse(double frequency) const {
+    if (sample_rate_ <= 0) {
+        return 0.0;
+    }
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * kPi * frequency / sample_rate_);
+    const std::complex<double> z2 = z1 * z1;
+    double gain = 1.0;
+    for (const auto& c : designs_) {
+        gain *= std::abs((c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2));
+    }
+    return gain;
+}
+
+}  // namespace ffvoice
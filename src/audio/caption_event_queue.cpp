@@ -0,0 +1,178 @@
+/**
+ * @file caption_event_queue.cpp
+ * @brief CaptionEventQueue implementation (bounded MPSC ring of sequenced slots)
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/caption_event_queue.h"
+
+    #include "utils/logger.h"
+
+    #include <cerrno>
+    #include <chrono>
+    #include <cstring>
+
+    #ifndef _WIN32
+        #include <fcntl.h>
+        #include <unistd.h>
+    #endif
+    #ifdef __linux__
+        #include <sys/eventfd.h>
+    #endif
+
+namespace ffvoice {
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+    size_t p = 2;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+}  // namespace
+
+CaptionEventQueue::CaptionEventQueue(size_t capacity)
+    : mask_(RoundUpToPowerOfTwo(capacity) - 1), slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    #if defined(__linux__)
+    read_fd_ = write_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    #elif !defined(_WIN32)
+    int fds[2];
+    if (pipe(fds) == 0) {
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        read_fd_ = fds[0];
+        write_fd_ = fds[1];
+    }
+    #endif
+    #ifndef _WIN32
+    if (read_fd_ < 0) {
+        LOG_WARNING("CaptionEventQueue: no readiness descriptor (%s); use WaitForEvent()",
+                    std::strerror(errno));
+        read_fd_ = write_fd_ = -1;
+    }
+    #endif
+}
+
+CaptionEventQueue::~CaptionEventQueue() {
+    #ifndef _WIN32
+    if (write_fd_ >= 0 && write_fd_ != read_fd_) {
+        close(write_fd_);
+    }
+    if (read_fd_ >= 0) {
+        close(read_fd_);
+    }
+    #endif
+}
+
+bool CaptionEventQueue::Push(const CaptionEvent& event) {
+    if (closed_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);  // Consumer fell behind
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->event = event;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    Signal();
+    return true;
+}
+
+bool CaptionEventQueue::Pop(CaptionEvent& event) {
+    const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+    event = std::move(slot.event);
+    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool CaptionEventQueue::HasEvent() const {
+    const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return slots_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+void CaptionEventQueue::Signal() {
+    #ifndef _WIN32
+    // One write per ClearReady(): the descriptor is level-triggered either way
+    if (write_fd_ >= 0 && !signaled_.exchange(true, std::memory_order_acq_rel)) {
+        const uint64_t one = 1;
+        const ssize_t written = write(write_fd_, &one, write_fd_ == read_fd_ ? sizeof(one) : 1);
+        (void)written;  // EAGAIN: already readable
+    }
+    #endif
+
+    // Pairs with the fence in WaitForEvent(): a parked consumer sees the event or is notified
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+        { std::lock_guard<std::mutex> lock(wait_mutex_); }
+        wait_cv_.notify_all();
+    }
+}
+
+void CaptionEventQueue::ClearReady() {
+    #ifndef _WIN32
+    if (read_fd_ >= 0 && signaled_.exchange(false, std::memory_order_acq_rel)) {
+        uint64_t buf[8];
+        while (read(read_fd_, buf, sizeof(buf)) > 0) {
+        }
+    }
+    #endif
+}
+
+bool CaptionEventQueue::WaitForEvent(int timeout_ms) {
+    if (HasEvent() || IsClosed()) {
+        return HasEvent();
+    }
+
+    waiters_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        const auto ready = [this] { return HasEvent() || IsClosed(); };
+        if (timeout_ms < 0) {
+            wait_cv_.wait(lock, ready);
+        } else {
+            wait_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+        }
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return HasEvent();
+}
+
+void CaptionEventQueue::Close() {
+    closed_.store(true, std::memory_order_release);
+    Signal();
+}
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,134 @@
+/**
+ * @file caption_event_queue.h
+ * @brief Lock-free caption event queue with a pollable readiness descriptor
+ *
+ * Lets an event loop consume LiveCaptioner events without a callback on the
+ * inference thread: the captioner pushes into the queue, and the loop watches
+ * GetReadyFd() (an eventfd on Linux, a pipe elsewhere on POSIX) and drains
+ * the queue when it becomes readable. Threads without an event loop use
+ * WaitForEvent() instead.
+ *
+ * @code
+ * auto queue = std::make_shared<CaptionEventQueue>();
+ * captioner.SetEventQueue(queue);
+ * captioner.Start();
+ * ...
+ * // In the loop, when GetReadyFd() is readable:
+ * queue->ClearReady();
+ * CaptionEvent ev;
+ * while (queue->Pop(ev)) { Show(ev); }
+ * @endcode
+ */
+
+#pragma once
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/live_captioner.h"
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <memory>
+    #include <mutex>
+
+namespace ffvoice {
+
+/**
+ * @brief Bounded multi-producer / single-consumer queue of CaptionEvent.
+ *
+ * Push() takes no lock (the event text is copied into a preallocated slot),
+ * touches the descriptor only when the consumer has cleared it since the
+ * last signal, and locks the wait mutex only while a WaitForEvent() caller
+ * is parked. When the queue is full the new event is dropped and counted.
+ */
+class CaptionEventQueue {
+public:
+    /// Default capacity: a few minutes of Partials at the default interval
+    static constexpr size_t kDefaultCapacity = 256;
+
+    /// @param capacity Maximum queued events (rounded up to a power of two)
+    explicit CaptionEventQueue(size_t capacity = kDefaultCapacity);
+    ~CaptionEventQueue();
+
+    CaptionEventQueue(const CaptionEventQueue&) = delete;
+    CaptionEventQueue& operator=(const CaptionEventQueue&) = delete;
+
+    /**
+     * @brief Append an event (any thread)
+     * @return false if the queue is full or closed (the event is dropped)
+     */
+    bool Push(const CaptionEvent& event);
+
+    /**
+     * @brief Take the oldest event (consumer only)
+     * @return false if the queue is empty
+     */
+    bool Pop(CaptionEvent& event);
+
+    /**
+     * @brief Descriptor that turns readable when events arrive or the queue closes
+     *
+     * Stays readable until ClearReady(). Returns -1 where no descriptor is
+     * available (Windows); use WaitForEvent() there.
+     */
+    int GetReadyFd() const {
+        return read_fd_;
+    }
+
+    /**
+     * @brief Reset GetReadyFd() to not-readable; call before draining with Pop()
+     *
+     * Events pushed after this call signal the descriptor again, so none is
+     * missed between draining and waiting.
+     */
+    void ClearReady();
+
+    /**
+     * @brief Block until an event is queued or the queue is closed (consumer only)
+     * @param timeout_ms Maximum wait; negative waits without limit
+     * @return true if an event is ready to Pop()
+     */
+    bool WaitForEvent(int timeout_ms = -1);
+
+    /// No more events will be pushed; wakes the consumer so it can finish
+    void Close();
+
+    bool IsClosed() const {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    /// Events rejected by Push() because the queue was full
+    uint64_t GetDroppedEvents() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        CaptionEvent event;
+    };
+
+    bool HasEvent() const;
+    void Signal();
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> enqueue_pos_{0};
+    std::atomic<size_t> dequeue_pos_{0};  // Consumer only
+    std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> dropped_{0};
+
+    int read_fd_ = -1;
+    int write_fd_ = -1;                // Same as read_fd_ for an eventfd
+    std::atomic<bool> signaled_{false};  // Descriptor holds an unread signal
+
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::atomic<int> waiters_{0};
+};
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
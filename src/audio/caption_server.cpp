@@ -0,0 +1,715 @@
+/**
+ * @file caption_server.cpp
+ * @brief CaptionServer implementation (single-threaded poll() loop over all connections)
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/caption_server.h"
+
+    #include "audio/caption_event_queue.h"
+    #include "utils/logger.h"
+
+    #include <cerrno>
+    #include <cstdio>
+    #include <cstring>
+    #include <thread>
+
+    #ifndef _WIN32
+        #include <fcntl.h>
+        #include <netdb.h>
+        #include <poll.h>
+        #include <sys/socket.h>
+        #include <sys/stat.h>
+        #include <sys/un.h>
+        #include <unistd.h>
+    #endif
+
+namespace ffvoice {
+
+namespace {
+
+    #ifndef _WIN32
+constexpr size_t kReadBufferBytes = 16384;  ///< One recv() per connection per loop turn
+constexpr size_t kCompactOutputBytes = 65536;
+
+void AppendEscaped(std::string& out, const std::string& text) {
+    for (const char c : text) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+/// Same fields, in the same order, as the CLI's --live-captions --json lines
+void AppendEventLine(std::string& out, const CaptionEvent& event) {
+    out += "{\"type\":\"";
+    out += event.type == CaptionEventType::Final ? "final" : "partial";
+    out += "\",\"utterance_id\":" + std::to_string(event.utterance_id) + ",\"text\":\"";
+    AppendEscaped(out, event.text);
+    out += "\",\"utterance_start_ms\":" + std::to_string(event.utterance_start_ms) +
+           ",\"utterance_end_ms\":" + std::to_string(event.utterance_end_ms) +
+           ",\"language\":\"";
+    AppendEscaped(out, event.language);
+    out += "\"}\n";
+}
+
+void CloseFd(int& fd) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool PrepareFd(int fd) {
+    const int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+           fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+ssize_t SendSome(int fd, const char* data, size_t size) {
+        #ifdef MSG_NOSIGNAL
+    return send(fd, data, size, MSG_NOSIGNAL);
+        #else
+    return send(fd, data, size, 0);  // SO_NOSIGPIPE is set on accepted sockets
+        #endif
+}
+
+/// Best effort: tell a turned-away client why, then hang up
+void RefuseConnection(int fd, const std::string& message) {
+    std::string line = "{\"event\":\"error\",\"message\":\"";
+    AppendEscaped(line, message);
+    line += "\"}\n";
+    const ssize_t sent = SendSome(fd, line.data(), line.size());
+    (void)sent;
+    close(fd);
+}
+    #endif
+
+}  // namespace
+
+struct CaptionServer::Session {
+    uint64_t id = 0;
+    int fd = -1;
+    std::shared_ptr<CaptionEventQueue> queue;
+    std::unique_ptr<LiveCaptioner> captioner;
+    std::atomic<bool> stopped{false};  ///< A closer thread finished captioner->Stop()
+    CaptionEvent event;                ///< Pop() target, reused
+
+    std::string output;  ///< JSON lines not yet sent
+    size_t output_sent = 0;
+    bool has_odd_byte = false;  ///< A sample split across two reads
+    uint8_t odd_byte = 0;
+
+    bool input_closed = false;  ///< EOF, error or server stop; the captioner is stopping
+    bool broken = false;        ///< The client is gone; output is discarded
+    bool events_done = false;   ///< The queue closed and session_end was queued
+    uint64_t dropped_samples = 0;
+    uint64_t dropped_events = 0;
+
+    ~Session() {
+        if (captioner) {
+            captioner->Stop();
+        }
+    #ifndef _WIN32
+        CloseFd(fd);
+    #endif
+    }
+};
+
+CaptionServer::CaptionServer(const CaptionServerConfig& config) : config_(config) {
+}
+
+CaptionServer::~CaptionServer() {
+    // Sessions first: a stopping captioner still submits its Final to the scheduler
+    for (auto& session : sessions_) {
+        if (!session->input_closed) {
+            BeginClose(*session);
+        }
+    }
+    StopClosers();  // Drains the close queue, so no closer still uses a session
+    sessions_.clear();
+    if (scheduler_) {
+        scheduler_->Stop();
+    }
+    #ifndef _WIN32
+    CloseListener();
+    CloseFd(wake_read_fd_);
+    CloseFd(wake_write_fd_);
+    #endif
+}
+
+CaptionServerStats CaptionServer::GetStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void CaptionServer::Discard(Session& session) {
+    session.broken = true;
+    session.output.clear();
+    session.output_sent = 0;
+}
+
+void CaptionServer::BeginClose(Session& session) {
+    session.input_closed = true;
+    {
+        std::lock_guard<std::mutex> lock(close_mutex_);
+        close_queue_.push_back(&session);
+    }
+    close_cv_.notify_one();
+}
+
+void CaptionServer::CloseLoop() {
+    std::unique_lock<std::mutex> lock(close_mutex_);
+    while (true) {
+        close_cv_.wait(lock, [this]() { return closers_stop_ || !close_queue_.empty(); });
+        if (close_queue_.empty()) {
+            return;  // Asked to stop and nothing left to close
+        }
+        Session* session = close_queue_.front();
+        close_queue_.pop_front();
+        lock.unlock();
+
+        // Blocks until the last Final is decoded, which is why it is not done on the loop
+        session->captioner->Stop();
+        session->stopped.store(true, std::memory_order_release);
+        Wake();  // The loop may be waiting with nothing else to do
+
+        lock.lock();
+    }
+}
+
+void CaptionServer::StopClosers() {
+    {
+        std::lock_guard<std::mutex> lock(close_mutex_);
+        closers_stop_ = true;
+    }
+    close_cv_.notify_all();
+    for (auto& closer : closers_) {
+        closer.join();
+    }
+    closers_.clear();
+}
+
+    #ifdef _WIN32
+
+bool CaptionServer::Start() {
+    last_error_ = "CaptionServer is not supported on Windows";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+}
+
+bool CaptionServer::Run() {
+    last_error_ = "CaptionServer is not supported on Windows";
+    return false;
+}
+
+void CaptionServer::RequestStop() {
+    stop_requested_.store(true);
+}
+
+void CaptionServer::Wake() {
+}
+
+bool CaptionServer::Listen() {
+    return false;
+}
+
+void CaptionServer::AcceptConnections() {
+}
+
+void CaptionServer::ReadInput(Session&) {
+}
+
+void CaptionServer::DrainEvents(Session&) {
+}
+
+void CaptionServer::WriteOutput(Session&) {
+}
+
+void CaptionServer::CloseListener() {
+}
+
+    #else
+
+bool CaptionServer::Start() {
+    if (listen_fd_ >= 0) {
+        LOG_WARNING("CaptionServer already started");
+        return true;
+    }
+
+    if (wake_read_fd_ < 0) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            last_error_ = std::string("Cannot create wake-up pipe: ") + std::strerror(errno);
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+        wake_read_fd_ = fds[0];
+        wake_write_fd_ = fds[1];
+        PrepareFd(wake_read_fd_);
+        PrepareFd(wake_write_fd_);
+    }
+
+    if (!Listen()) {
+        return false;
+    }
+
+    scheduler_ = std::make_unique<InferenceScheduler>(config_.scheduler);
+    if (!scheduler_->Start()) {
+        last_error_ = "Failed to start inference scheduler: " + scheduler_->GetLastError();
+        LOG_ERROR("%s", last_error_.c_str());
+        scheduler_.reset();
+        CloseListener();
+        return false;
+    }
+
+    // Each Stop() waits for one Final decode, so more closers than decode
+    // workers would only queue inside the scheduler
+    closers_stop_ = false;
+    for (size_t i = 0; i < scheduler_->GetNumWorkers(); ++i) {
+        closers_.emplace_back(&CaptionServer::CloseLoop, this);
+    }
+
+    read_buffer_.resize(kReadBufferBytes);
+    pcm_buffer_.resize(kReadBufferBytes / 2 + 1);
+    LOG_INFO("CaptionServer: listening on %s (%zu decode workers)", bound_address_.c_str(),
+             scheduler_->GetNumWorkers());
+    return true;
+}
+
+bool CaptionServer::Listen() {
+    const std::string& address = config_.listen;
+    if (address.rfind("unix:", 0) == 0) {
+        const std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            last_error_ = "Unix socket path is empty or too long: " + address;
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        // A socket file left behind by an earlier server would make bind() fail
+        struct stat st {};
+        if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            unlink(path.c_str());
+        }
+
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0 ||
+            bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listen_fd_, SOMAXCONN) != 0) {
+            last_error_ = "Cannot listen on " + address + ": " + std::strerror(errno);
+            LOG_ERROR("%s", last_error_.c_str());
+            CloseFd(listen_fd_);
+            return false;
+        }
+        unix_path_ = path;
+        bound_address_ = address;
+    } else {
+        std::string host = "127.0.0.1";
+        std::string port = address;
+        const size_t colon = address.rfind(':');
+        if (colon != std::string::npos) {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+            host = host.substr(1, host.size() - 2);  // "[::1]:8765"
+        }
+        if (port.empty()) {
+            last_error_ = "Listen address " + address + " has no port";
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+        addrinfo* result = nullptr;
+        const int rc =
+            getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (rc != 0) {
+            last_error_ = "Cannot resolve listen address " + address + ": " + gai_strerror(rc);
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+        int bind_errno = 0;
+        for (addrinfo* ai = result; ai && listen_fd_ < 0; ai = ai->ai_next) {
+            const int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) {
+                bind_errno = errno;
+                continue;
+            }
+            const int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+                listen_fd_ = fd;
+            } else {
+                bind_errno = errno;
+                close(fd);
+            }
+        }
+        freeaddrinfo(result);
+        if (listen_fd_ < 0) {
+            last_error_ = "Cannot listen on " + address + ": " + std::strerror(bind_errno);
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+
+        // Report the real port when port 0 asked the kernel to pick one
+        sockaddr_storage bound{};
+        socklen_t length = sizeof(bound);
+        char bound_host[NI_MAXHOST];
+        char bound_port[NI_MAXSERV];
+        if (getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&bound), &length) == 0 &&
+            getnameinfo(reinterpret_cast<const sockaddr*>(&bound), length, bound_host,
+                        sizeof(bound_host), bound_port, sizeof(bound_port),
+                        NI_NUMERICHOST | NI_NUMERICSERV) == 0) {
+            bound_address_ = bound.ss_family == AF_INET6
+                                 ? "[" + std::string(bound_host) + "]:" + bound_port
+                                 : std::string(bound_host) + ":" + bound_port;
+        } else {
+            bound_address_ = address;
+        }
+    }
+
+    if (!PrepareFd(listen_fd_)) {
+        last_error_ = "Cannot configure listening socket: " + std::string(std::strerror(errno));
+        LOG_ERROR("%s", last_error_.c_str());
+        CloseListener();
+        return false;
+    }
+    return true;
+}
+
+void CaptionServer::CloseListener() {
+    CloseFd(listen_fd_);
+    if (!unix_path_.empty()) {
+        unlink(unix_path_.c_str());
+        unix_path_.clear();
+    }
+}
+
+void CaptionServer::RequestStop() {
+    stop_requested_.store(true);
+    Wake();
+}
+
+void CaptionServer::Wake() {
+    if (wake_write_fd_ >= 0) {
+        const char byte = 1;
+        const ssize_t written = write(wake_write_fd_, &byte, 1);
+        (void)written;  // EAGAIN: a wake-up is already pending
+    }
+}
+
+bool CaptionServer::Run() {
+    if (!scheduler_) {
+        last_error_ = "CaptionServer not started";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    std::vector<pollfd> fds;
+    bool stopping = false;
+    bool ok = true;
+    while (true) {
+        if (!stopping && stop_requested_.load()) {
+            stopping = true;
+            LOG_INFO("CaptionServer: stopping, finishing %zu sessions", sessions_.size());
+            CloseListener();
+            for (auto& session : sessions_) {
+                if (!session->input_closed) {
+                    BeginClose(*session);
+                }
+            }
+        }
+
+        // A session ends once its last event is queued and sent (or the client is gone)
+        // and a closer has returned from its captioner's Stop()
+        for (auto it = sessions_.begin(); it != sessions_.end();) {
+            Session& session = **it;
+            if (session.events_done && (session.broken || session.output.empty()) &&
+                session.stopped.load(std::memory_order_acquire)) {
+                LOG_INFO("CaptionServer: session %llu closed",
+                         static_cast<unsigned long long>(session.id));
+                it = sessions_.erase(it);
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                stats_.active_sessions = sessions_.size();
+            } else {
+                ++it;
+            }
+        }
+        if (stopping && sessions_.empty()) {
+            break;
+        }
+
+        fds.clear();
+        fds.push_back({wake_read_fd_, POLLIN, 0});
+        const bool listening = listen_fd_ >= 0;
+        if (listening) {
+            fds.push_back({listen_fd_, POLLIN, 0});
+        }
+        int timeout_ms = -1;
+        for (const auto& session : sessions_) {
+            short events = session->input_closed ? 0 : POLLIN;
+            if (!session->broken && !session->output.empty()) {
+                events |= POLLOUT;
+            }
+            // A hung-up socket with nothing left to read or write would poll as ready forever
+            const bool idle = session->input_closed && (session->broken || events == 0);
+            fds.push_back({idle ? -1 : session->fd, events, 0});
+            const int queue_fd = session->queue->GetReadyFd();
+            fds.push_back({queue_fd, POLLIN, 0});
+            if (queue_fd < 0) {
+                timeout_ms = 50;  // No descriptor: drain the queue on a timer
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), timeout_ms) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            last_error_ = std::string("poll() failed: ") + std::strerror(errno);
+            LOG_ERROR("%s", last_error_.c_str());
+            ok = false;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wake_read_fd_, drain, sizeof(drain)) > 0) {
+            }
+        }
+        const size_t first = listening ? 2 : 1;
+        const bool accept_ready = listening && (fds[1].revents & POLLIN);
+
+        // Sessions accepted below are appended and polled from the next turn on
+        const size_t polled = (fds.size() - first) / 2;
+        for (size_t i = 0; i < polled; ++i) {
+            Session& session = *sessions_[i];
+            const short socket_events = fds[first + 2 * i].revents;
+            const short queue_events = fds[first + 2 * i + 1].revents;
+
+            if (!session.input_closed && (socket_events & (POLLIN | POLLHUP | POLLERR))) {
+                ReadInput(session);
+            } else if (socket_events & (POLLHUP | POLLERR)) {
+                Discard(session);
+            }
+            if ((queue_events & POLLIN) || fds[first + 2 * i + 1].fd < 0) {
+                DrainEvents(session);
+            }
+            if (!session.broken && !session.output.empty()) {
+                WriteOutput(session);
+            }
+        }
+
+        if (accept_ready) {
+            AcceptConnections();
+        }
+    }
+    return ok;
+}
+
+void CaptionServer::AcceptConnections() {
+    while (true) {
+        const int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_WARNING("CaptionServer: accept() failed: %s", std::strerror(errno));
+            }
+            return;
+        }
+        PrepareFd(fd);
+        #ifdef SO_NOSIGPIPE
+        const int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+        #endif
+
+        if (sessions_.size() >= config_.max_sessions) {
+            LOG_WARNING("CaptionServer: refusing connection, %zu sessions open",
+                        sessions_.size());
+            RefuseConnection(fd, "server full");
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.sessions_refused;
+            continue;
+        }
+
+        LiveCaptionerConfig session_config = config_.session;
+        session_config.scheduler = scheduler_.get();
+        auto session = std::make_unique<Session>();
+        session->queue = std::make_shared<CaptionEventQueue>();
+        session->captioner = std::make_unique<LiveCaptioner>(session_config);
+        session->captioner->SetEventQueue(session->queue);
+        if (!session->captioner->Initialize() || !session->captioner->Start()) {
+            const std::string error = session->captioner->GetLastError();
+            LOG_ERROR("CaptionServer: cannot start a captioner: %s", error.c_str());
+            RefuseConnection(fd, "cannot start captioner: " + error);
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.sessions_refused;
+            continue;
+        }
+
+        session->id = next_session_id_++;
+        session->fd = fd;
+        session->output = "{\"event\":\"session_start\",\"session\":" +
+                          std::to_string(session->id) +
+                          ",\"sample_rate\":" + std::to_string(session_config.sample_rate) +
+                          ",\"channels\":" + std::to_string(session_config.channels) + "}\n";
+        LOG_INFO("CaptionServer: session %llu connected",
+                 static_cast<unsigned long long>(session->id));
+        sessions_.push_back(std::move(session));
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.sessions_accepted;
+        stats_.active_sessions = sessions_.size();
+    }
+}
+
+void CaptionServer::ReadInput(Session& session) {
+    const ssize_t received = recv(session.fd, read_buffer_.data(), read_buffer_.size(), 0);
+    if (received == 0) {
+        BeginClose(session);  // Client finished sending; flush the last Final
+        return;
+    }
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return;
+        }
+        Discard(session);
+        BeginClose(session);
+        return;
+    }
+
+    // 16-bit little-endian samples; one split across two reads is carried over
+    const uint8_t* bytes = read_buffer_.data();
+    size_t size = static_cast<size_t>(received);
+    size_t count = 0;
+    if (session.has_odd_byte) {
+        pcm_buffer_[count++] = static_cast<int16_t>(
+            static_cast<uint16_t>(session.odd_byte | static_cast<uint16_t>(bytes[0]) << 8));
+        ++bytes;
+        --size;
+        session.has_odd_byte = false;
+    }
+    for (size_t i = 0; i + 1 < size; i += 2) {
+        pcm_buffer_[count++] = static_cast<int16_t>(
+            static_cast<uint16_t>(bytes[i] | static_cast<uint16_t>(bytes[i + 1]) << 8));
+    }
+    if (size & 1) {
+        session.has_odd_byte = true;
+        session.odd_byte = bytes[size - 1];
+    }
+
+    // Overrun: what the ring cannot take now is dropped, never waited for
+    const size_t written = count > 0 ? session.captioner->FeedAudio(pcm_buffer_.data(), count) : 0;
+    const uint64_t dropped = count - written;
+    if (dropped > 0 && session.dropped_samples == 0) {
+        LOG_WARNING("CaptionServer: session %llu is sending faster than it is captioned, "
+                    "dropping audio",
+                    static_cast<unsigned long long>(session.id));
+    }
+    session.dropped_samples += dropped;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.bytes_received += static_cast<uint64_t>(received);
+    stats_.dropped_samples += dropped;
+}
+
+void CaptionServer::DrainEvents(Session& session) {
+    // Read before draining: everything pushed before Close() is then seen below
+    const bool closed = session.queue->IsClosed();
+    session.queue->ClearReady();
+
+    uint64_t dropped = 0;
+    while (session.queue->Pop(session.event)) {
+        if (session.broken) {
+            continue;
+        }
+        // A slow reader loses Partials first; a later Partial or Final supersedes them
+        if (session.event.type == CaptionEventType::Partial &&
+            session.output.size() - session.output_sent > config_.max_output_bytes) {
+            ++dropped;
+            continue;
+        }
+        AppendEventLine(session.output, session.event);
+    }
+
+    const bool finished = closed && !session.events_done;
+    if (finished) {
+        session.events_done = true;
+        dropped += session.queue->GetDroppedEvents();
+    }
+    session.dropped_events += dropped;
+    if (finished && !session.broken) {
+        session.output += "{\"event\":\"session_end\",\"session\":" + std::to_string(session.id) +
+                          ",\"dropped_samples\":" + std::to_string(session.dropped_samples) +
+                          ",\"dropped_events\":" + std::to_string(session.dropped_events) + "}\n";
+    }
+    if (dropped > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.dropped_events += dropped;
+    }
+}
+
+void CaptionServer::WriteOutput(Session& session) {
+    while (session.output_sent < session.output.size()) {
+        const ssize_t sent = SendSome(session.fd, session.output.data() + session.output_sent,
+                                      session.output.size() - session.output_sent);
+        if (sent > 0) {
+            session.output_sent += static_cast<size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            Discard(session);  // EPIPE / ECONNRESET
+            if (!session.input_closed) {
+                BeginClose(session);
+            }
+            return;
+        }
+    }
+    if (session.output_sent == session.output.size()) {
+        session.output.clear();
+        session.output_sent = 0;
+    } else if (session.output_sent >= kCompactOutputBytes) {
+        session.output.erase(0, session.output_sent);
+        session.output_sent = 0;
+    }
+}
+
+    #endif  // _WIN32
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
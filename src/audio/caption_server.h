@@ -0,0 +1,189 @@
+/**
+ * @file caption_server.h
+ * @brief Headless live-caption server: many PCM streams, one shared model
+ *
+ * Each client connects over a local (Unix domain) socket or TCP, streams raw
+ * 16-bit little-endian PCM at the configured rate and channel count, and reads
+ * caption events back on the same connection as JSON lines:
+ *
+ * @code
+ * {"event":"session_start","session":1,"sample_rate":16000,"channels":1}
+ * {"type":"partial","utterance_id":1,"text":"...","utterance_start_ms":0,...}
+ * {"type":"final","utterance_id":1,"text":"...","utterance_start_ms":0,...}
+ * {"event":"session_end","session":1,"dropped_samples":0,"dropped_events":0}
+ * @endcode
+ *
+ * Closing the write side (shutdown(SHUT_WR)) ends the stream: the last
+ * utterance is flushed as a Final and the server closes the connection after
+ * session_end.
+ *
+ * Every connection gets its own LiveCaptioner, and all of them decode through
+ * one InferenceScheduler, so the model is loaded once and Finals from any
+ * session go ahead of Partials. Socket I/O for all connections runs on the
+ * single thread that calls Run(): a poll() loop over the listening socket,
+ * the connections and each session's CaptionEventQueue descriptor. Ending a
+ * session waits for its last Final, so that runs on a fixed pool of closer
+ * threads, one per decode worker.
+ *
+ * Each session's LiveCaptioner still runs its own ingest and inference
+ * threads (the latter mostly waiting on the scheduler), so a server with N
+ * open sessions runs 2N threads besides the loop, the closers and the decode
+ * workers. Size max_sessions with that in mind.
+ *
+ * Backpressure follows the ring-buffer overrun rule instead of stalling the
+ * client: audio that does not fit a session's ring buffer is dropped and
+ * counted, and when a client reads captions too slowly its Partials are
+ * dropped (Finals are always kept).
+ *
+ * POSIX only; Start() fails on Windows.
+ */
+
+#pragma once
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/inference_scheduler.h"
+    #include "audio/live_captioner.h"
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Configuration for CaptionServer
+ */
+struct CaptionServerConfig {
+    /// "unix:/path/to.sock", or "[host:]port" for TCP: host defaults to 127.0.0.1,
+    /// ":port" listens on every interface, and port 0 picks a free port
+    std::string listen = "127.0.0.1:8765";
+
+    /**
+     * @brief Template for each connection's captioner.
+     *
+     * sample_rate and channels describe the PCM clients send. The scheduler
+     * field is overwritten with the server's shared scheduler.
+     */
+    LiveCaptionerConfig session;
+
+    /// Shared model and decode workers for all sessions
+    InferenceSchedulerConfig scheduler;
+
+    /// Connections beyond this are refused with an error line (each open session
+    /// costs two captioner threads)
+    size_t max_sessions = 64;
+
+    /// Unsent output per connection above which new Partials are dropped
+    size_t max_output_bytes = 1 << 20;
+};
+
+/**
+ * @brief Server statistics (see CaptionServer::GetStats())
+ */
+struct CaptionServerStats {
+    uint64_t sessions_accepted = 0;  ///< Connections that got a session
+    uint64_t sessions_refused = 0;   ///< Connections turned away (limit or captioner failure)
+    size_t active_sessions = 0;      ///< Sessions currently open (including ones closing)
+    uint64_t bytes_received = 0;     ///< PCM bytes read from all clients
+    uint64_t dropped_samples = 0;    ///< Samples that did not fit a session's ring buffer
+    uint64_t dropped_events = 0;     ///< Caption events dropped for slow readers
+};
+
+/**
+ * @brief Accepts PCM streams and returns live captions for each.
+ *
+ * Start() binds the socket and starts the shared scheduler; Run() serves
+ * until RequestStop(), then ends every session (flushing its last Final)
+ * before returning.
+ */
+class CaptionServer {
+public:
+    explicit CaptionServer(const CaptionServerConfig& config);
+    ~CaptionServer();
+
+    CaptionServer(const CaptionServer&) = delete;
+    CaptionServer& operator=(const CaptionServer&) = delete;
+
+    /**
+     * @brief Bind and listen, load the model and start the scheduler
+     * @return false on a bad address, bind failure or model load failure
+     */
+    bool Start();
+
+    /**
+     * @brief Serve connections on the calling thread until RequestStop()
+     * @return false if Start() has not succeeded or polling fails
+     */
+    bool Run();
+
+    /**
+     * @brief Ask Run() to finish its sessions and return
+     *
+     * Async-signal-safe: only sets a flag and writes one byte to a pipe,
+     * so it may be called from a SIGINT handler.
+     */
+    void RequestStop();
+
+    /// Address actually bound, e.g. "127.0.0.1:40123" for port 0 (empty before Start())
+    std::string GetBoundAddress() const {
+        return bound_address_;
+    }
+
+    CaptionServerStats GetStats() const;
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    struct Session;
+
+    bool Listen();
+    void AcceptConnections();
+    void ReadInput(Session& session);
+    void DrainEvents(Session& session);
+    void WriteOutput(Session& session);
+    void BeginClose(Session& session);
+    void CloseLoop();
+    void StopClosers();
+    void Wake();
+    void Discard(Session& session);
+    void CloseListener();
+
+    CaptionServerConfig config_;
+    std::string last_error_;
+    std::string bound_address_;
+    std::string unix_path_;  ///< Socket file to unlink on shutdown
+
+    std::unique_ptr<InferenceScheduler> scheduler_;
+    std::vector<std::unique_ptr<Session>> sessions_;
+    uint64_t next_session_id_ = 1;
+    std::vector<uint8_t> read_buffer_;  ///< Socket reads, shared by all sessions
+    std::vector<int16_t> pcm_buffer_;   ///< Decoded samples of one read
+
+    std::mutex close_mutex_;  ///< Guards close_queue_ and closers_stop_
+    std::condition_variable close_cv_;
+    std::deque<Session*> close_queue_;  ///< Sessions whose captioner still has to Stop()
+    std::vector<std::thread> closers_;  ///< Run CloseLoop(), one per decode worker
+    bool closers_stop_ = false;
+
+    int listen_fd_ = -1;
+    int wake_read_fd_ = -1;
+    int wake_write_fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+
+    mutable std::mutex stats_mutex_;  ///< GetStats() may be called from any thread
+    CaptionServerStats stats_;
+};
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
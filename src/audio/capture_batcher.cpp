@@ -0,0 +1,112 @@
+/**
+ * @file capture_batcher.cpp
+ * @brief CaptureBatcher implementation
+ */
+
+#include "audio/capture_batcher.h"
+
+#include "utils/logger.h"
+#include "utils/trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ffvoice {
+
+CaptureBatcher::CaptureBatcher() : CaptureBatcher(CaptureBatcherConfig{}) {
+}
+
+CaptureBatcher::CaptureBatcher(const CaptureBatcherConfig& config)
+    : batch_samples_(std::clamp<size_t>(config.batch_samples, 1,
+                                        std::max<size_t>(config.capacity_samples, 1))),
+      drainer_thread_policy_(config.drainer_thread_policy),
+      ring_(config.capacity_samples) {
+}
+
+CaptureBatcher::~CaptureBatcher() {
+    Stop();
+}
+
+void CaptureBatcher::Push(const int16_t* samples, size_t num_samples) {
+    const size_t written = ring_.push_bulk(samples, num_samples);
+    if (written < num_samples) {
+        dropped_.fetch_add(num_samples - written, std::memory_order_relaxed);
+    }
+}
+
+bool CaptureBatcher::StartDrainer(BatchCallback callback) {
+    if (drainer_.joinable()) {
+        LOG_ERROR("CaptureBatcher: drainer already running");
+        return false;
+    }
+    if (!callback) {
+        LOG_ERROR("CaptureBatcher: no batch callback set");
+        return false;
+    }
+
+    callback_ = std::move(callback);
+    batch_.resize(batch_samples_);
+    stopping_.store(false, std::memory_order_relaxed);
+    drainer_ = std::thread(&CaptureBatcher::DrainLoop, this);
+    return true;
+}
+
+void CaptureBatcher::Stop() {
+    stopping_.store(true, std::memory_order_release);
+    ring_.wake();  // Release a parked drainer or Read()
+    if (drainer_.joinable()) {
+        drainer_.join();
+    }
+}
+
+size_t CaptureBatcher::Read(int16_t* out, size_t count, int timeout_ms) {
+    if (out == nullptr || count == 0) {
+        return 0;
+    }
+
+    const size_t wanted = std::min(count, ring_.capacity());
+    if (timeout_ms < 0) {
+        while (ring_.available_read() < wanted && !stopping_.load(std::memory_order_acquire)) {
+            ring_.wait_for_data(wanted);
+        }
+    } else if (timeout_ms > 0) {
+        // std::atomic::wait has no timed form, so a bounded wait polls in 1 ms steps
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (ring_.available_read() < wanted && !stopping_.load(std::memory_order_acquire)) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            std::this_thread::sleep_for(
+                std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                              std::chrono::milliseconds(1)));
+        }
+    }
+    return ring_.pop_bulk(out, count);
+}
+
+void CaptureBatcher::DrainLoop() {
+    FFVOICE_TRACE_THREAD_NAME("CaptureBatcher drainer");
+    ApplyThreadPolicy(drainer_thread_policy_, "CaptureBatcher drainer");
+
+    while (true) {
+        if (ring_.wait_for_data(batch_samples_)) {
+            FFVOICE_TRACE_SCOPE("CaptureBatcher::Batch");
+            const size_t n = ring_.pop_bulk(batch_.data(), batch_samples_);
+            callback_(batch_.data(), n);
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    // Hand over the tail the device captured before it stopped
+    size_t n;
+    while ((n = ring_.pop_bulk(batch_.data(), batch_samples_)) > 0) {
+        callback_(batch_.data(), n);
+    }
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,136 @@
+/**
+ * @file capture_batcher.h
+ * @brief Decouples the real-time capture callback from slow consumers
+ *
+ * The capture callback only copies its block into a lock-free ring; a
+ * consumer either pulls with Read() or lets a drainer thread hand it
+ * fixed-size batches. A consumer that stalls (a Python callback waiting for
+ * the GIL, a garbage-collection pause) fills the ring and loses the newest
+ * samples, which are counted, instead of delaying the audio thread into an
+ * input overflow.
+ *
+ * @code
+ * CaptureBatcherConfig cfg;
+ * cfg.batch_samples = 4800;  // 100 ms at 48 kHz mono
+ * CaptureBatcher batcher(cfg);
+ * batcher.StartDrainer([](const int16_t* samples, size_t n) { Consume(samples, n); });
+ * device.Start([&](const int16_t* samples, size_t n) { batcher.Push(samples, n); });
+ * ...
+ * device.Stop();
+ * batcher.Stop();  // Delivers the final partial batch
+ * @endcode
+ */
+
+#pragma once
+
+#include "utils/ring_buffer.h"
+#include "utils/thread_policy.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Configuration for CaptureBatcher.
+ */
+struct CaptureBatcherConfig {
+    /// Ring capacity in samples (2 s at 48 kHz mono); bounds how long a consumer may stall
+    size_t capacity_samples = 96000;
+
+    /// Samples per drainer batch (100 ms at 48 kHz mono)
+    size_t batch_samples = 4800;
+
+    /// Priority and cores of the drainer thread
+    ThreadPolicy drainer_thread_policy;
+};
+
+/**
+ * @brief Ring buffer between the capture callback and one consumer.
+ *
+ * Push() is the producer side and never blocks, locks or allocates. The
+ * consumer side is either Read() on a single thread or the drainer started
+ * by StartDrainer(), never both.
+ */
+class CaptureBatcher {
+public:
+    using BatchCallback = std::function<void(const int16_t* samples, size_t num_samples)>;
+
+    CaptureBatcher();
+    explicit CaptureBatcher(const CaptureBatcherConfig& config);
+    ~CaptureBatcher();
+
+    CaptureBatcher(const CaptureBatcher&) = delete;
+    CaptureBatcher& operator=(const CaptureBatcher&) = delete;
+
+    /**
+     * @brief Append captured samples (real-time safe; call from the capture callback)
+     *
+     * Samples that do not fit are dropped and counted in GetDroppedSamples().
+     */
+    void Push(const int16_t* samples, size_t num_samples);
+
+    /**
+     * @brief Deliver the ring to @p callback in batches from a drainer thread
+     *
+     * The callback receives exactly batch_samples samples per call, except for
+     * the final call made by Stop(). The pointer is valid only during the call.
+     *
+     * @return false if a drainer is already running or @p callback is empty
+     */
+    bool StartDrainer(BatchCallback callback);
+
+    /**
+     * @brief Wake readers and join the drainer after it delivered what remains
+     *
+     * Call after the capture device stopped so no samples arrive afterwards.
+     * Afterwards Read() returns without waiting. Safe to call multiple times.
+     */
+    void Stop();
+
+    /**
+     * @brief Pull up to @p count samples; only when no drainer runs
+     *
+     * Blocks until @p count samples (clamped to the capacity) are available,
+     * @p timeout_ms elapses or Stop() is called, then returns whatever is
+     * stored up to @p count. A negative timeout waits without limit; zero
+     * returns immediately.
+     *
+     * @return Number of samples written to @p out
+     */
+    size_t Read(int16_t* out, size_t count, int timeout_ms = -1);
+
+    /// Samples stored and not yet read or drained
+    size_t GetAvailableSamples() const {
+        return ring_.available_read();
+    }
+
+    /// Samples dropped by Push() because the ring was full
+    uint64_t GetDroppedSamples() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /// Samples per drainer batch
+    size_t GetBatchSamples() const {
+        return batch_samples_;
+    }
+
+private:
+    void DrainLoop();
+
+    const size_t batch_samples_;
+    const ThreadPolicy drainer_thread_policy_;
+    RingBuffer<int16_t> ring_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+
+    BatchCallback callback_;
+    std::vector<int16_t> batch_;  // Drainer scratch, allocated once
+    std::thread drainer_;
+};
+
+}  // namespace ffvoice
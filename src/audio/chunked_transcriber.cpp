@@ -0,0 +1,385 @@
+/**
+ * @file chunked_transcriber.cpp
+ * @brief Implementation of VAD-chunked parallel offline transcription
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/chunked_transcriber.h"
+
+    #include "media/mapped_wav_reader.h"
+    #include "media/media_file_reader.h"
+    #include "utils/audio_converter.h"
+    #include "utils/logger.h"
+
+    #include <algorithm>
+    #include <chrono>
+    #include <deque>
+    #include <future>
+    #include <utility>
+
+namespace ffvoice {
+
+namespace {
+
+constexpr int64_t kSampleRate = 16000;
+
+// VAD frame: 10 ms, the unit of VADSegmenter's frame counts
+constexpr size_t kFrameSamples = 160;
+
+// Samples read from a WAV file per step (5 s)
+constexpr size_t kReadSamples = 5 * kSampleRate;
+
+// Trimming the history moves memory; only do it once this much can go
+constexpr size_t kTrimSlack = kSampleRate;
+
+int64_t SamplesToMs(int64_t samples) {
+    return samples * 1000 / kSampleRate;
+}
+
+}  // namespace
+
+/**
+ * @brief State of one TranscribeFile() / TranscribePcm() call
+ *
+ * Positions are absolute 16 kHz sample indices into the input. history_ holds
+ * the input from history_base_ on: everything the next chunk, its overlap and
+ * the VAD's onset frames may still need.
+ */
+class ChunkedTranscriber::Run {
+public:
+    Run(const ChunkedTranscriberConfig& config, InferenceScheduler& scheduler,
+        const SegmentCallback& on_segments, ChunkedTranscriptionStats& stats)
+        : scheduler_(scheduler),
+          on_segments_(on_segments),
+          stats_(stats),
+          vad_(MakeVadConfig(config)),
+          frame_vad_(config.frame_vad),
+          overlap_samples_(static_cast<int64_t>(std::max(0, config.overlap_ms)) * kSampleRate /
+                           1000),
+          max_in_flight_(config.max_in_flight > 0 ? config.max_in_flight
+                                                  : 2 * scheduler.GetNumWorkers()) {
+        // Silence before speech that must survive until the VAD confirms it
+        keep_before_speech_ = overlap_samples_ +
+                              static_cast<int64_t>(config.vad.min_speech_frames + 1) *
+                                  static_cast<int64_t>(kFrameSamples) +
+                              static_cast<int64_t>(config.vad.pre_roll_samples);
+        frame_vad_.Initialize(static_cast<int>(kSampleRate), 1);
+        frame_.resize(kFrameSamples);
+    }
+
+    /// Append input; returns false once a chunk has failed
+    bool Feed(const float* pcm, size_t count) {
+        history_.insert(history_.end(), pcm, pcm + count);
+        position_ += static_cast<int64_t>(count);
+        while (!failed_ && vad_pos_ + static_cast<int64_t>(kFrameSamples) <= position_) {
+            ProcessFrame(kFrameSamples);
+        }
+        return !failed_;
+    }
+
+    /// Cut the final chunk and deliver everything still in flight
+    bool Finish(std::string& error) {
+        if (!failed_ && vad_pos_ < position_) {
+            ProcessFrame(static_cast<size_t>(position_ - vad_pos_));
+        }
+        if (!failed_) {
+            size_t segment_samples = 0;
+            vad_.Flush([&](const int16_t*, size_t n) { segment_samples = n; });
+            if (segment_samples > 0) {
+                EmitChunk(position_ - static_cast<int64_t>(segment_samples), position_);
+            }
+        }
+        while (!failed_ && !in_flight_.empty()) {
+            DeliverFront();
+        }
+        stats_.audio_duration_s = static_cast<double>(position_) / kSampleRate;
+        error = error_;
+        return !failed_;
+    }
+
+private:
+    struct InFlight {
+        std::future<InferenceResult> result;
+        int64_t offset_ms;     ///< File time of the chunk's first sample
+        int64_t keep_from_ms;  ///< Segments centred before this belong to the previous chunk
+    };
+
+    static VADSegmenter::Config MakeVadConfig(const ChunkedTranscriberConfig& config) {
+        VADSegmenter::Config vad = config.vad;
+        // A whole number of frames, so a forced cut never truncates a frame and
+        // chunk positions can be recovered from the segment length
+        const size_t max_frames = std::max<size_t>(
+            1, static_cast<size_t>(std::max(0, config.max_chunk_ms)) / 10);
+        vad.max_segment_samples = max_frames * kFrameSamples;
+        vad.pre_roll_samples = vad.pre_roll_samples / kFrameSamples * kFrameSamples;
+        return vad;
+    }
+
+    void ProcessFrame(size_t count) {
+        const float* samples = history_.data() + (vad_pos_ - history_base_);
+
+        // FrameVAD, as in LiveCaptioner, so a file and a live stream of the same
+        // audio are cut alike; the short last frame is scored padded with silence
+        AudioConverter::FloatToInt16(samples, count, frame_.data());
+        std::fill(frame_.begin() + static_cast<std::ptrdiff_t>(count), frame_.end(), 0);
+        const float vad_prob = frame_vad_.ProcessFrame(frame_.data());
+
+        size_t segment_samples = 0;
+        vad_.ProcessFrame(frame_.data(), count, vad_prob,
+                          [&](const int16_t*, size_t n) { segment_samples = n; });
+        vad_pos_ += static_cast<int64_t>(count);
+
+        if (segment_samples > 0) {
+            // The segment ends with this frame
+            EmitChunk(vad_pos_ - static_cast<int64_t>(segment_samples), vad_pos_);
+        } else if (!vad_.IsInSpeech()) {
+            Trim(vad_pos_ - keep_before_speech_);
+        }
+    }
+
+    void EmitChunk(int64_t start, int64_t end) {
+        const int64_t chunk_start = std::max(history_base_, start - overlap_samples_);
+        const float* begin = history_.data() + (chunk_start - history_base_);
+        std::vector<float> pcm(begin, begin + (end - chunk_start));
+
+        stats_.chunks++;
+        stats_.decoded_duration_s += static_cast<double>(pcm.size()) / kSampleRate;
+        LOG_INFO("ChunkedTranscriber: chunk %zu, %.2fs - %.2fs", stats_.chunks,
+                 static_cast<double>(chunk_start) / kSampleRate,
+                 static_cast<double>(end) / kSampleRate);
+
+        // Keep no more than max_in_flight_ chunks of audio and results around
+        while (!failed_ && in_flight_.size() >= max_in_flight_) {
+            DeliverFront();
+        }
+        if (failed_) {
+            return;
+        }
+        in_flight_.push_back(
+            InFlight{scheduler_.SubmitPcm(InferencePriority::Final, std::move(pcm)),
+                     SamplesToMs(chunk_start), SamplesToMs(last_chunk_end_)});
+
+        last_chunk_end_ = end;
+        Trim(end - overlap_samples_);
+
+        // Hand on whatever has finished already, without waiting
+        while (!failed_ && !in_flight_.empty() &&
+               in_flight_.front().result.wait_for(std::chrono::seconds(0)) ==
+                   std::future_status::ready) {
+            DeliverFront();
+        }
+    }
+
+    void DeliverFront() {
+        InFlight chunk = std::move(in_flight_.front());
+        in_flight_.pop_front();
+
+        InferenceResult result = chunk.result.get();
+        if (!result.ok) {
+            failed_ = true;
+            error_ = "Chunk at " + std::to_string(chunk.offset_ms) + " ms failed to transcribe";
+            LOG_ERROR("ChunkedTranscriber: %s", error_.c_str());
+            return;
+        }
+
+        output_.clear();
+        for (TranscriptionSegment& segment : result.segments) {
+            segment.start_ms += chunk.offset_ms;
+            segment.end_ms += chunk.offset_ms;
+            for (Word& word : segment.words) {
+                word.start_ms += chunk.offset_ms;
+                word.end_ms += chunk.offset_ms;
+            }
+            // Mostly inside the overlap: the previous chunk already has it
+            if ((segment.start_ms + segment.end_ms) / 2 < chunk.keep_from_ms) {
+                continue;
+            }
+            output_.push_back(std::move(segment));
+        }
+        if (!output_.empty()) {
+            stats_.segments += output_.size();
+            on_segments_(output_);
+        }
+    }
+
+    /// Drop history before @p keep_from (never past the VAD position)
+    void Trim(int64_t keep_from) {
+        keep_from = std::min(keep_from, vad_pos_);
+        if (keep_from - history_base_ < static_cast<int64_t>(kTrimSlack)) {
+            return;
+        }
+        history_.erase(history_.begin(), history_.begin() + (keep_from - history_base_));
+        history_base_ = keep_from;
+    }
+
+    InferenceScheduler& scheduler_;
+    const SegmentCallback& on_segments_;
+    ChunkedTranscriptionStats& stats_;
+    VADSegmenter vad_;
+    FrameVAD frame_vad_;
+    const int64_t overlap_samples_;
+    const size_t max_in_flight_;
+    int64_t keep_before_speech_ = 0;
+
+    std::vector<float> history_;  ///< Input from history_base_ to position_
+    int64_t history_base_ = 0;
+    int64_t position_ = 0;        ///< Samples fed so far
+    int64_t vad_pos_ = 0;         ///< First sample not yet seen by the VAD
+    int64_t last_chunk_end_ = 0;  ///< End of the previous chunk (without overlap)
+    std::vector<int16_t> frame_;  ///< One VAD frame as int16
+
+    std::deque<InFlight> in_flight_;            ///< Submitted chunks, in file order
+    std::vector<TranscriptionSegment> output_;  ///< Segments of the chunk being delivered
+    bool failed_ = false;
+    std::string error_;
+};
+
+ChunkedTranscriber::ChunkedTranscriber(const ChunkedTranscriberConfig& config) : config_(config) {
+}
+
+ChunkedTranscriber::~ChunkedTranscriber() {
+    if (owned_scheduler_) {
+        owned_scheduler_->Stop();
+    }
+}
+
+bool ChunkedTranscriber::Initialize() {
+    if (config_.scheduler) {
+        if (!config_.scheduler->IsRunning()) {
+            last_error_ = "ChunkedTranscriber: shared scheduler is not running";
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+        return true;
+    }
+    if (owned_scheduler_ && owned_scheduler_->IsRunning()) {
+        return true;
+    }
+
+    InferenceSchedulerConfig scheduler_config;
+    scheduler_config.whisper = config_.whisper;
+    scheduler_config.num_workers = config_.num_workers;
+    scheduler_config.threads_per_worker = config_.threads_per_worker;
+    scheduler_config.transcribe_fn = config_.transcribe_fn;
+    owned_scheduler_ = std::make_unique<InferenceScheduler>(scheduler_config);
+    if (!owned_scheduler_->Start()) {
+        last_error_ = owned_scheduler_->GetLastError();
+        owned_scheduler_.reset();
+        return false;
+    }
+    LOG_INFO("ChunkedTranscriber: %zu workers x %d threads", owned_scheduler_->GetNumWorkers(),
+             owned_scheduler_->GetThreadsPerWorker());
+    return true;
+}
+
+InferenceScheduler* ChunkedTranscriber::GetScheduler() const {
+    return config_.scheduler ? config_.scheduler : owned_scheduler_.get();
+}
+
+bool ChunkedTranscriber::TranscribeFile(const std::string& audio_file,
+                                        const SegmentCallback& on_segments) {
+    InferenceScheduler* scheduler = GetScheduler();
+    if (!scheduler || !scheduler->IsRunning()) {
+        last_error_ = "ChunkedTranscriber not initialized";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    std::string ext;
+    const size_t dot_pos = audio_file.find_last_of('.');
+    if (dot_pos != std::string::npos) {
+        ext = audio_file.substr(dot_pos);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    }
+
+    // Both readers convert a block at a time, so memory stays bounded by the
+    // chunks in flight whatever the file length
+    std::vector<float> block;
+    if (ext != ".wav") {
+        MediaFileReader reader;
+        if (!reader.Open(audio_file, kSampleRate)) {
+            last_error_ = reader.GetLastError();
+            return false;
+        }
+        const bool ok = RunChunks(*scheduler, on_segments, [&](Run& run) {
+            while (reader.NextChunk(block, kReadSamples)) {
+                if (!run.Feed(block.data(), block.size())) {
+                    return;
+                }
+            }
+        });
+        if (ok && !reader.GetLastError().empty()) {
+            last_error_ = reader.GetLastError();
+            return false;
+        }
+        return ok;
+    }
+
+    MappedWavReader reader;
+    if (!reader.Open(audio_file, kSampleRate)) {
+        last_error_ = reader.GetLastError();
+        return false;
+    }
+
+    return RunChunks(*scheduler, on_segments, [&](Run& run) {
+        while (reader.NextChunk(block, kReadSamples)) {
+            if (!run.Feed(block.data(), block.size())) {
+                return;
+            }
+        }
+    });
+}
+
+bool ChunkedTranscriber::TranscribeFile(const std::string& audio_file,
+                                        std::vector<TranscriptionSegment>& segments) {
+    segments.clear();
+    return TranscribeFile(audio_file, [&](const std::vector<TranscriptionSegment>& chunk) {
+        segments.insert(segments.end(), chunk.begin(), chunk.end());
+    });
+}
+
+bool ChunkedTranscriber::TranscribePcm(const float* pcm, size_t num_samples,
+                                       const SegmentCallback& on_segments) {
+    InferenceScheduler* scheduler = GetScheduler();
+    if (!scheduler || !scheduler->IsRunning()) {
+        last_error_ = "ChunkedTranscriber not initialized";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    // Feed in read-sized steps so the history stays a few seconds long
+    return RunChunks(*scheduler, on_segments, [&](Run& run) {
+        for (size_t offset = 0; offset < num_samples; offset += kReadSamples) {
+            if (!run.Feed(pcm + offset, std::min(kReadSamples, num_samples - offset))) {
+                return;
+            }
+        }
+    });
+}
+
+bool ChunkedTranscriber::RunChunks(InferenceScheduler& scheduler,
+                                   const SegmentCallback& on_segments,
+                                   const std::function<void(Run&)>& feed) {
+    const auto start = std::chrono::steady_clock::now();
+    stats_ = ChunkedTranscriptionStats{};
+    last_error_.clear();
+
+    Run run(config_, scheduler, on_segments, stats_);
+    feed(run);
+    const bool ok = run.Finish(last_error_);
+
+    stats_.elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    if (stats_.elapsed_ms > 0.0) {
+        stats_.realtime_factor = stats_.audio_duration_s * 1000.0 / stats_.elapsed_ms;
+    }
+    LOG_INFO("ChunkedTranscriber: %zu chunks, %zu segments, %.1fs audio, RTF=%.2fx", stats_.chunks,
+             stats_.segments, stats_.audio_duration_s, stats_.realtime_factor);
+    return ok;
+}
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
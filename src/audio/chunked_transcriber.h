@@ -0,0 +1,189 @@
+/**
+ * @file chunked_transcriber.h
+ * @brief Streaming offline transcription of long files in VAD-bounded chunks
+ *
+ * WhisperProcessor::TranscribeFile() holds the whole file in memory and
+ * returns nothing until a single whisper_full call has finished. For
+ * multi-hour recordings ChunkedTranscriber instead reads the file a few
+ * seconds at a time, cuts it on VAD boundaries, decodes the chunks in
+ * parallel on an InferenceScheduler and hands back segments as soon as all
+ * earlier chunks are done.
+ */
+
+#pragma once
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/frame_vad.h"
+    #include "audio/inference_scheduler.h"
+    #include "audio/vad_segmenter.h"
+    #include "audio/whisper_processor.h"
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <functional>
+    #include <memory>
+    #include <string>
+    #include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Configuration for ChunkedTranscriber.
+ */
+struct ChunkedTranscriberConfig {
+    /// Whisper configuration of the owned scheduler's workers (unused with @ref scheduler)
+    WhisperConfig whisper;
+
+    /**
+     * @brief Optional shared scheduler that decodes the chunks.
+     *
+     * Must be started and outlive the transcriber. When null the transcriber
+     * starts its own, sized by num_workers / threads_per_worker.
+     */
+    InferenceScheduler* scheduler = nullptr;
+
+    /// Concurrent decodes of the owned scheduler (0 = one per 4 hardware threads)
+    size_t num_workers = 0;
+
+    /// whisper.cpp threads per owned worker (0 = hardware threads / num_workers)
+    int threads_per_worker = 0;
+
+    /**
+     * @brief Chunk boundary detection; frame counts are in 10 ms frames.
+     *
+     * max_segment_samples is ignored (see max_chunk_ms); pre_roll_samples is
+     * rounded down to whole frames.
+     */
+    VADSegmenter::Config vad;
+
+    /// Per-frame VAD probability, the same estimator LiveCaptioner uses by default
+    FrameVAD::Config frame_vad;
+
+    /// Longest chunk before a forced cut; with overlap_ms it stays in one 30 s Whisper window
+    int max_chunk_ms = 28000;
+
+    /**
+     * @brief Audio before each chunk that is decoded with it (ms)
+     *
+     * Gives the decoder context across forced cuts and recovers the speech onset
+     * the VAD needs to confirm speech. Segments lying mostly inside the previous
+     * chunk are dropped, so the overlap is not transcribed twice.
+     */
+    int overlap_ms = 1000;
+
+    /// Chunks decoding or waiting for output at once (0 = 2 per scheduler worker)
+    size_t max_in_flight = 0;
+
+    /// Test-seam passed to the owned scheduler (receives 16 kHz mono int16); no model is loaded
+    std::function<bool(const int16_t*, size_t, std::vector<TranscriptionSegment>&)> transcribe_fn =
+        nullptr;
+};
+
+/**
+ * @brief Summary of the last ChunkedTranscriber run.
+ */
+struct ChunkedTranscriptionStats {
+    size_t chunks = 0;                ///< Chunks decoded
+    size_t segments = 0;              ///< Segments delivered
+    double audio_duration_s = 0.0;    ///< Length of the input
+    double decoded_duration_s = 0.0;  ///< Audio sent to Whisper, overlap included
+    double elapsed_ms = 0.0;          ///< Wall time of the whole run
+    double realtime_factor = 0.0;     ///< audio_duration_s / elapsed time (>1 = faster)
+};
+
+/**
+ * @brief Transcribes long recordings chunk by chunk, in parallel, in order.
+ *
+ * The input is converted to 16 kHz mono as it is read (WAV files through
+ * MappedWavReader, anything else through MediaFileReader), so memory stays
+ * bounded by the chunks in flight. A
+ * VADSegmenter cuts it in silences, or after max_chunk_ms of continuous
+ * speech. Each chunk is submitted as a Final request with overlap_ms of the
+ * preceding audio; its segment timestamps are shifted to file time.
+ *
+ * Chunks decode concurrently, but @p on_segments is always called in chunk
+ * order, on the calling thread, so the output does not depend on timing.
+ * Chunks are decoded independently (no prompt carried between them).
+ *
+ * @code
+ * ChunkedTranscriber transcriber(cfg);
+ * SubtitleWriter writer;
+ * if (transcriber.Initialize() && writer.Open("meeting.srt", SubtitleGenerator::Format::SRT)) {
+ *     transcriber.TranscribeFile("meeting.wav", [&](const auto& segments) {
+ *         writer.Write(segments);
+ *     });
+ *     writer.Close();
+ * }
+ * @endcode
+ */
+class ChunkedTranscriber {
+public:
+    /// Receives the segments of one chunk, already in file time
+    using SegmentCallback = std::function<void(const std::vector<TranscriptionSegment>&)>;
+
+    explicit ChunkedTranscriber(const ChunkedTranscriberConfig& config);
+    ~ChunkedTranscriber();
+
+    ChunkedTranscriber(const ChunkedTranscriber&) = delete;
+    ChunkedTranscriber& operator=(const ChunkedTranscriber&) = delete;
+
+    /**
+     * @brief Start the owned scheduler (loads the model), or check the shared one
+     * @return true on success; false on failure (see GetLastError())
+     */
+    bool Initialize();
+
+    /**
+     * @brief Transcribe an audio file, delivering segments as chunks complete
+     * @param audio_file Path to a WAV file, or any format FFmpeg decodes (streamed either way)
+     * @param on_segments Called in chunk order on this thread
+     * @return true if every chunk was transcribed, false otherwise
+     */
+    bool TranscribeFile(const std::string& audio_file, const SegmentCallback& on_segments);
+
+    /**
+     * @brief Transcribe a file and collect all segments
+     * @param audio_file Path to audio file (WAV, FLAC, MP3, M4A, Opus, ...)
+     * @param segments Output segments in file order
+     * @return true if successful, false otherwise
+     */
+    bool TranscribeFile(const std::string& audio_file, std::vector<TranscriptionSegment>& segments);
+
+    /**
+     * @brief Transcribe audio already in Whisper format (16 kHz float mono)
+     * @param pcm Samples in [-1, 1] at 16 kHz, mono
+     * @param num_samples Number of samples
+     * @param on_segments Called in chunk order on this thread
+     * @return true if every chunk was transcribed, false otherwise
+     */
+    bool TranscribePcm(const float* pcm, size_t num_samples, const SegmentCallback& on_segments);
+
+    /// Statistics of the last TranscribeFile() / TranscribePcm() call
+    const ChunkedTranscriptionStats& GetLastStats() const {
+        return stats_;
+    }
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    class Run;
+
+    /// Scheduler in use (owned or shared)
+    InferenceScheduler* GetScheduler() const;
+
+    /// Run @p feed against a fresh Run, then deliver the rest and fill stats_
+    bool RunChunks(InferenceScheduler& scheduler, const SegmentCallback& on_segments,
+                   const std::function<void(Run&)>& feed);
+
+    ChunkedTranscriberConfig config_;
+    std::unique_ptr<InferenceScheduler> owned_scheduler_;  ///< Set when config_.scheduler is null
+    ChunkedTranscriptionStats stats_;
+    std::string last_error_;
+};
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
@@ -8,7 +8,11 @@
 #include "utils/logger.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <thread>
 
 namespace ffvoice {
 
@@ -16,50 +20,400 @@ namespace ffvoice {
 // MergeIntoSegments — unconditionally compiled (no sherpa-onnx dependency)
 // =============================================================================
 
+namespace {
+
+/**
+ * @brief Speaker segments in start-time order, queried for the largest overlap.
+ *
+ * Queries whose start times do not decrease share one sweep: speaker segments
+ * are admitted once they start before the query ends and retired once they
+ * end before it starts, so each query only looks at the segments that can
+ * overlap it.
+ */
+class SpeakerSweep {
+public:
+    explicit SpeakerSweep(const std::vector<SpeakerSegment>& speakers) : speakers_(speakers) {
+        order_.resize(speakers.size());
+        for (size_t i = 0; i < order_.size(); ++i) {
+            order_[i] = i;
+        }
+        auto by_start = [&](size_t a, size_t b) {
+            return speakers_[a].start_ms < speakers_[b].start_ms;
+        };
+        if (!std::is_sorted(order_.begin(), order_.end(), by_start)) {
+            std::stable_sort(order_.begin(), order_.end(), by_start);
+        }
+    }
+
+    /// Start the sweep over from the first speaker segment
+    void Rewind() {
+        next_ = 0;
+        active_.clear();
+        have_query_ = false;
+    }
+
+    /// Index of the speaker segment overlapping [start_ms, end_ms) the most, or -1
+    int64_t Best(int64_t start_ms, int64_t end_ms) {
+        if (have_query_ && start_ms < last_start_ms_) {
+            Rewind();  // Out of order: retired segments may overlap this query
+        }
+        have_query_ = true;
+        last_start_ms_ = start_ms;
+
+        while (next_ < order_.size() && speakers_[order_[next_]].start_ms < end_ms) {
+            active_.push_back(order_[next_++]);
+        }
+        // Segments ending by this start cannot overlap this or any later query
+        active_.erase(std::remove_if(active_.begin(), active_.end(),
+                                     [&](size_t i) { return speakers_[i].end_ms <= start_ms; }),
+                      active_.end());
+
+        int64_t best_overlap = 0;
+        int64_t best = -1;
+        for (size_t i : active_) {
+            const SpeakerSegment& sp = speakers_[i];
+            const int64_t overlap = std::min(end_ms, sp.end_ms) - std::max(start_ms, sp.start_ms);
+            // On a tie the earlier (lower-index) speaker segment is kept
+            if (overlap > best_overlap ||
+                (overlap == best_overlap && best >= 0 && static_cast<int64_t>(i) < best)) {
+                best_overlap = overlap;
+                best = static_cast<int64_t>(i);
+            }
+        }
+        return best;
+    }
+
+private:
+    const std::vector<SpeakerSegment>& speakers_;
+    std::vector<size_t> order_;   ///< speakers_ indices by start time
+    size_t next_ = 0;             ///< First entry of order_ not yet admitted
+    std::vector<size_t> active_;  ///< Admitted segments that have not ended yet
+    int64_t last_start_ms_ = 0;
+    bool have_query_ = false;
+};
+
+}  // namespace
+
 void MergeIntoSegments(std::vector<TranscriptionSegment>& segments,
                        const std::vector<SpeakerSegment>& speakers) {
     if (speakers.empty()) {
         return;
     }
 
+    // A segment starts no later than its words, so one sweep covers both
+    SpeakerSweep sweep(speakers);
     for (auto& seg : segments) {
-        int64_t best_overlap = 0;
-        int32_t best_speaker = -1;
+        const int64_t best = sweep.Best(seg.start_ms, seg.end_ms);
+        if (best >= 0) {
+            seg.speaker_id = speakers[static_cast<size_t>(best)].speaker_id;
+        }
+        // Otherwise leave seg.speaker_id unchanged (default -1).
 
-        for (const auto& sp : speakers) {
-            // Millisecond overlap between the transcription and speaker spans.
-            const int64_t overlap =
-                std::min(seg.end_ms, sp.end_ms) - std::max(seg.start_ms, sp.start_ms);
+        for (auto& word : seg.words) {
+            const int64_t best = sweep.Best(word.start_ms, word.end_ms);
+            word.speaker_id =
+                best >= 0 ? speakers[static_cast<size_t>(best)].speaker_id : seg.speaker_id;
+        }
+    }
+}
 
-            // Strict '>' so that, on a tie, the earlier (lower-index) speaker
-            // segment is kept.
-            if (overlap > best_overlap) {
-                best_overlap = overlap;
-                best_speaker = sp.speaker_id;
+// =============================================================================
+// SpeakerClusterer — unconditionally compiled (no sherpa-onnx dependency)
+// =============================================================================
+
+SpeakerClusterer::SpeakerClusterer() : SpeakerClusterer(Config{}) {
+}
+
+SpeakerClusterer::SpeakerClusterer(const Config& config) : config_(config) {
+}
+
+int32_t SpeakerClusterer::Assign(const float* embedding, size_t dim) {
+    if (embedding == nullptr || dim == 0 || (dim_ != 0 && dim != dim_)) {
+        LOG_WARNING("SpeakerClusterer: rejected embedding of dimension %zu (expected %zu)", dim,
+                    dim_);
+        return -1;
+    }
+
+    double norm_sq = 0.0;
+    for (size_t i = 0; i < dim; ++i) {
+        norm_sq += static_cast<double>(embedding[i]) * embedding[i];
+    }
+    if (norm_sq <= 0.0) {
+        return -1;
+    }
+    dim_ = dim;
+    unit_.resize(dim);
+    const float inv_norm = static_cast<float>(1.0 / std::sqrt(norm_sq));
+    for (size_t i = 0; i < dim; ++i) {
+        unit_[i] = embedding[i] * inv_norm;
+    }
+
+    // Most similar existing speaker (cosine; unit_ is already normalized)
+    int32_t best = -1;
+    double best_similarity = -2.0;
+    for (size_t s = 0; s < counts_.size(); ++s) {
+        const float* centroid = centroids_.data() + s * dim;
+        double dot = 0.0;
+        double centroid_sq = 0.0;
+        for (size_t i = 0; i < dim; ++i) {
+            dot += static_cast<double>(unit_[i]) * centroid[i];
+            centroid_sq += static_cast<double>(centroid[i]) * centroid[i];
+        }
+        const double similarity = centroid_sq > 0.0 ? dot / std::sqrt(centroid_sq) : -1.0;
+        if (similarity > best_similarity) {
+            best_similarity = similarity;
+            best = static_cast<int32_t>(s);
+        }
+    }
+
+    const bool full = counts_.size() >= static_cast<size_t>(std::max(config_.max_speakers, 1));
+    if (best >= 0 && (best_similarity >= config_.similarity_threshold || full)) {
+        // Running mean, with the weight of history capped so the centroid can drift
+        const int max_weight = std::max(config_.max_centroid_weight, 1);
+        int& count = counts_[static_cast<size_t>(best)];
+        count = std::min(count + 1, max_weight);
+        float* centroid = centroids_.data() + static_cast<size_t>(best) * dim;
+        const float rate = 1.0f / static_cast<float>(count);
+        for (size_t i = 0; i < dim; ++i) {
+            centroid[i] += (unit_[i] - centroid[i]) * rate;
+        }
+        return best;
+    }
+
+    centroids_.insert(centroids_.end(), unit_.begin(), unit_.end());
+    counts_.push_back(1);
+    LOG_INFO("SpeakerClusterer: new speaker %zu (best similarity %.2f)", counts_.size() - 1,
+             best_similarity);
+    return static_cast<int32_t>(counts_.size() - 1);
+}
+
+void SpeakerClusterer::Reset() {
+    dim_ = 0;
+    centroids_.clear();
+    counts_.clear();
+}
+
+// =============================================================================
+// ClusterEmbeddings — unconditionally compiled
+// =============================================================================
+
+std::vector<int32_t> ClusterEmbeddings(const std::vector<std::vector<float>>& embeddings,
+                                       int num_speakers, float threshold) {
+    std::vector<int32_t> labels(embeddings.size(), -1);
+
+    // The first non-empty embedding fixes the dimension
+    size_t dim = 0;
+    for (const auto& embedding : embeddings) {
+        if (!embedding.empty()) {
+            dim = embedding.size();
+            break;
+        }
+    }
+
+    // One cluster per usable embedding, held as the sum of its unit-normalized members
+    std::vector<std::vector<double>> sums;
+    std::vector<size_t> item_of_cluster;
+    for (size_t i = 0; i < embeddings.size(); ++i) {
+        const std::vector<float>& embedding = embeddings[i];
+        if (dim == 0 || embedding.size() != dim) {
+            continue;
+        }
+        double norm_sq = 0.0;
+        for (float v : embedding) {
+            norm_sq += static_cast<double>(v) * v;
+        }
+        if (norm_sq <= 0.0) {
+            continue;
+        }
+        const double inv_norm = 1.0 / std::sqrt(norm_sq);
+        sums.emplace_back(dim);
+        for (size_t d = 0; d < dim; ++d) {
+            sums.back()[d] = embedding[d] * inv_norm;
+        }
+        item_of_cluster.push_back(i);
+    }
+
+    const size_t n = sums.size();
+    std::vector<size_t> root(n);  // Cluster each initial cluster was merged into
+    for (size_t c = 0; c < n; ++c) {
+        root[c] = c;
+    }
+
+    // Centroid cosine similarity of every live pair, updated row by row on merges
+    auto norm = [&](size_t c) {
+        double sq = 0.0;
+        for (double v : sums[c]) {
+            sq += v * v;
+        }
+        return std::sqrt(sq);
+    };
+    std::vector<double> norms(n);
+    for (size_t c = 0; c < n; ++c) {
+        norms[c] = norm(c);
+    }
+    auto cosine = [&](size_t a, size_t b) {
+        double dot = 0.0;
+        for (size_t d = 0; d < dim; ++d) {
+            dot += sums[a][d] * sums[b][d];
+        }
+        return dot / (norms[a] * norms[b]);
+    };
+    std::vector<double> similarity(n * n, 0.0);
+    for (size_t a = 0; a < n; ++a) {
+        for (size_t b = a + 1; b < n; ++b) {
+            similarity[a * n + b] = similarity[b * n + a] = cosine(a, b);
+        }
+    }
+
+    std::vector<bool> alive(n, true);
+    size_t clusters = n;
+    const size_t target = num_speakers > 0 ? static_cast<size_t>(num_speakers) : 1;
+    while (clusters > target) {
+        size_t best_a = 0;
+        size_t best_b = 0;
+        double best = -2.0;
+        for (size_t a = 0; a < n; ++a) {
+            if (!alive[a]) {
+                continue;
+            }
+            for (size_t b = a + 1; b < n; ++b) {
+                if (alive[b] && similarity[a * n + b] > best) {
+                    best = similarity[a * n + b];
+                    best_a = a;
+                    best_b = b;
+                }
             }
         }
+        if (num_speakers <= 0 && 1.0 - best >= threshold) {
+            break;
+        }
 
-        if (best_overlap > 0) {
-            seg.speaker_id = best_speaker;
+        // Merge b into a
+        for (size_t d = 0; d < dim; ++d) {
+            sums[best_a][d] += sums[best_b][d];
+        }
+        norms[best_a] = norm(best_a);
+        alive[best_b] = false;
+        --clusters;
+        for (size_t c = 0; c < n; ++c) {
+            if (root[c] == best_b) {
+                root[c] = best_a;
+            }
+        }
+        for (size_t c = 0; c < n; ++c) {
+            if (alive[c] && c != best_a) {
+                similarity[best_a * n + c] = similarity[c * n + best_a] = cosine(best_a, c);
+            }
         }
-        // Otherwise leave seg.speaker_id unchanged (default -1).
     }
+
+    // Number clusters by the first item that belongs to them
+    std::vector<int32_t> label_of_root(n, -1);
+    int32_t next_label = 0;
+    for (size_t c = 0; c < n; ++c) {
+        int32_t& label = label_of_root[root[c]];
+        if (label < 0) {
+            label = next_label++;
+        }
+        labels[item_of_cluster[c]] = label;
+    }
+    return labels;
 }
 
 #ifdef ENABLE_DIARIZATION
 
+namespace {
+
+/// Audio embedded per window speaker; longer turns add little to the voice print
+constexpr double kMaxEmbedSeconds = 30.0;
+
+/// Sample index of a millisecond time, clamped at 0
+size_t MsToSamples(int64_t ms, int sample_rate) {
+    return static_cast<size_t>(std::max<int64_t>(0, ms)) * static_cast<size_t>(sample_rate) / 1000;
+}
+
+/// Run sherpa-onnx offline diarization over one buffer
+bool RunSherpaDiarization(const SherpaOnnxOfflineSpeakerDiarization* handle, const float* samples,
+                          size_t count, std::vector<SpeakerSegment>& result) {
+    const SherpaOnnxOfflineSpeakerDiarizationResult* sd_result =
+        SherpaOnnxOfflineSpeakerDiarizationProcess(handle, samples, static_cast<int32_t>(count));
+    if (!sd_result) {
+        return false;
+    }
+
+    const int32_t num_segments = SherpaOnnxOfflineSpeakerDiarizationResultGetNumSegments(sd_result);
+    const SherpaOnnxOfflineSpeakerDiarizationSegment* segments =
+        SherpaOnnxOfflineSpeakerDiarizationResultSortByStartTime(sd_result);
+
+    if (segments && num_segments > 0) {
+        result.reserve(static_cast<size_t>(num_segments));
+        for (int32_t i = 0; i < num_segments; ++i) {
+            // sherpa-onnx reports start/end in seconds; convert to milliseconds.
+            const int64_t start_ms = static_cast<int64_t>(segments[i].start * 1000.0f);
+            const int64_t end_ms = static_cast<int64_t>(segments[i].end * 1000.0f);
+            result.emplace_back(start_ms, end_ms, segments[i].speaker);
+        }
+    }
+
+    // Free the C objects: the segment array first, then the result.
+    if (segments) {
+        SherpaOnnxOfflineSpeakerDiarizationDestroySegment(segments);
+    }
+    SherpaOnnxOfflineSpeakerDiarizationDestroyResult(sd_result);
+    return true;
+}
+
+/// Speaker embedding of mono samples; empty on failure
+std::vector<float> ExtractEmbedding(const SherpaOnnxSpeakerEmbeddingExtractor* extractor,
+                                    const float* samples, size_t count, int sample_rate) {
+    std::vector<float> result;
+    const SherpaOnnxOnlineStream* stream =
+        SherpaOnnxSpeakerEmbeddingExtractorCreateStream(extractor);
+    if (!stream) {
+        return result;
+    }
+    SherpaOnnxOnlineStreamAcceptWaveform(stream, sample_rate, samples,
+                                         static_cast<int32_t>(count));
+    SherpaOnnxOnlineStreamInputFinished(stream);
+
+    if (SherpaOnnxSpeakerEmbeddingExtractorIsReady(extractor, stream)) {
+        const float* embedding =
+            SherpaOnnxSpeakerEmbeddingExtractorComputeEmbedding(extractor, stream);
+        if (embedding) {
+            const int32_t dim = SherpaOnnxSpeakerEmbeddingExtractorDim(extractor);
+            result.assign(embedding, embedding + std::max(dim, 0));
+            SherpaOnnxSpeakerEmbeddingExtractorDestroyEmbedding(embedding);
+        }
+    }
+    SherpaOnnxDestroyOnlineStream(stream);
+    return result;
+}
+
+}  // namespace
+
 // =============================================================================
 // Diarizer — gated by ENABLE_DIARIZATION
 // =============================================================================
 
+/// One window of a windowed Diarize()
+struct Diarizer::Window {
+    size_t begin = 0;                            ///< First sample
+    size_t end = 0;                              ///< One past the last sample
+    std::vector<SpeakerSegment> segments;        ///< Recording time, window-local speaker ids
+    std::vector<std::vector<float>> embeddings;  ///< Indexed by window-local speaker id
+    bool ok = false;                             ///< ProcessWindow() succeeded
+};
+
 Diarizer::Diarizer(const DiarizerConfig& config) : config_(config) {
     LOG_INFO("Diarizer created");
 }
 
 Diarizer::~Diarizer() {
-    if (handle_) {
-        SherpaOnnxDestroyOfflineSpeakerDiarization(handle_);
-        handle_ = nullptr;
+    for (const SherpaOnnxOfflineSpeakerDiarization* handle : handles_) {
+        SherpaOnnxDestroyOfflineSpeakerDiarization(handle);
+    }
+    for (const SherpaOnnxSpeakerEmbeddingExtractor* extractor : extractors_) {
+        SherpaOnnxDestroySpeakerEmbeddingExtractor(extractor);
     }
     LOG_INFO("Diarizer destroyed");
 }
@@ -109,19 +463,52 @@ bool Diarizer::Init() {
         sd_config.clustering.threshold = config_.cluster_threshold;
     }
 
-    handle_ = SherpaOnnxCreateOfflineSpeakerDiarization(&sd_config);
-    if (!handle_) {
-        last_error_ =
-            "Diarizer: SherpaOnnxCreateOfflineSpeakerDiarization failed "
-            "(check segmentation/embedding model paths)";
-        LOG_ERROR("%s", last_error_.c_str());
-        return false;
+    // Windowed mode: a handle and an extractor per worker, since windows run
+    // concurrently. Per-window clustering only separates the window's own
+    // speakers; the global pass decides the final count.
+    const size_t workers = config_.window_s > 0 ? GetNumWorkers() : 1;
+    if (config_.window_s > 0) {
+        sd_config.clustering.num_clusters = 0;
+        sd_config.clustering.threshold = config_.cluster_threshold;
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        const SherpaOnnxOfflineSpeakerDiarization* handle =
+            SherpaOnnxCreateOfflineSpeakerDiarization(&sd_config);
+        if (!handle) {
+            last_error_ =
+                "Diarizer: SherpaOnnxCreateOfflineSpeakerDiarization failed "
+                "(check segmentation/embedding model paths)";
+            LOG_ERROR("%s", last_error_.c_str());
+            return false;
+        }
+        handles_.push_back(handle);
+    }
+
+    if (config_.window_s > 0) {
+        SherpaOnnxSpeakerEmbeddingExtractorConfig extractor_config;
+        memset(&extractor_config, 0, sizeof(extractor_config));
+        extractor_config.model = config_.embedding_model_path.c_str();
+        extractor_config.num_threads = config_.num_threads;
+        extractor_config.provider = "cpu";
+        for (size_t i = 0; i < workers; ++i) {
+            const SherpaOnnxSpeakerEmbeddingExtractor* extractor =
+                SherpaOnnxCreateSpeakerEmbeddingExtractor(&extractor_config);
+            if (!extractor) {
+                last_error_ =
+                    "Diarizer: SherpaOnnxCreateSpeakerEmbeddingExtractor failed "
+                    "(check embedding model path)";
+                LOG_ERROR("%s", last_error_.c_str());
+                return false;
+            }
+            extractors_.push_back(extractor);
+        }
     }
 
     initialized_ = true;
-    LOG_INFO("Diarizer initialized: segmentation='%s', embedding='%s', sample_rate=%d Hz",
+    LOG_INFO("Diarizer initialized: segmentation='%s', embedding='%s', sample_rate=%d Hz, "
+             "%zu worker(s)",
              config_.segmentation_model_path.c_str(), config_.embedding_model_path.c_str(),
-             SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handle_));
+             SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handles_.front()), workers);
     return true;
 }
 
@@ -136,50 +523,198 @@ std::vector<SpeakerSegment> Diarizer::Diarize(const std::vector<float>& samples,
         return result;
     }
 
+    if (!config_.diarize_fn) {
+        const int expected_rate =
+            SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handles_.front());
+        if (sample_rate != expected_rate) {
+            last_error_ = "Diarizer: sample rate mismatch";
+            LOG_ERROR("Diarizer::Diarize: sample rate %d Hz does not match expected %d Hz",
+                      sample_rate, expected_rate);
+            return result;
+        }
+    }
+
+    if (UseWindows(samples.size(), sample_rate)) {
+        return DiarizeWindowed(samples, sample_rate);
+    }
+
     // Test-seam mode: delegate to the injected function.
     if (config_.diarize_fn) {
         return config_.diarize_fn(samples, sample_rate);
     }
 
-    const int expected_rate = SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handle_);
-    if (sample_rate != expected_rate) {
-        last_error_ = "Diarizer: sample rate mismatch";
-        LOG_ERROR("Diarizer::Diarize: sample rate %d Hz does not match expected %d Hz", sample_rate,
-                  expected_rate);
-        return result;
-    }
-
-    const SherpaOnnxOfflineSpeakerDiarizationResult* sd_result =
-        SherpaOnnxOfflineSpeakerDiarizationProcess(handle_, samples.data(),
-                                                   static_cast<int32_t>(samples.size()));
-    if (!sd_result) {
+    if (!RunSherpaDiarization(handles_.front(), samples.data(), samples.size(), result)) {
         last_error_ = "Diarizer: SherpaOnnxOfflineSpeakerDiarizationProcess returned null";
         LOG_ERROR("%s", last_error_.c_str());
         return result;
     }
 
-    const int32_t num_segments = SherpaOnnxOfflineSpeakerDiarizationResultGetNumSegments(sd_result);
-    const SherpaOnnxOfflineSpeakerDiarizationSegment* segments =
-        SherpaOnnxOfflineSpeakerDiarizationResultSortByStartTime(sd_result);
+    LOG_INFO("Diarizer::Diarize produced %zu speaker segment(s)", result.size());
+    return result;
+}
 
-    if (segments && num_segments > 0) {
-        result.reserve(static_cast<size_t>(num_segments));
-        for (int32_t i = 0; i < num_segments; ++i) {
-            // sherpa-onnx reports start/end in seconds; convert to milliseconds.
-            const int64_t start_ms = static_cast<int64_t>(segments[i].start * 1000.0f);
-            const int64_t end_ms = static_cast<int64_t>(segments[i].end * 1000.0f);
-            result.emplace_back(start_ms, end_ms, segments[i].speaker);
+bool Diarizer::UseWindows(size_t num_samples, int sample_rate) const {
+    if (config_.window_s <= 0 || sample_rate <= 0) {
+        return false;
+    }
+    if (config_.diarize_fn && !config_.embed_fn) {
+        return false;  // A seam diarizer without embeddings cannot be clustered globally
+    }
+    return num_samples > static_cast<size_t>(config_.window_s) * static_cast<size_t>(sample_rate);
+}
+
+size_t Diarizer::GetNumWorkers() const {
+    if (config_.num_workers > 0) {
+        return static_cast<size_t>(config_.num_workers);
+    }
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, hw / static_cast<unsigned>(std::max(config_.num_threads, 1)));
+}
+
+bool Diarizer::ProcessWindow(size_t worker, const float* samples, int sample_rate,
+                             Window& window) const {
+    const float* data = samples + window.begin;
+    const size_t count = window.end - window.begin;
+    if (config_.diarize_fn) {
+        window.segments = config_.diarize_fn(std::vector<float>(data, data + count), sample_rate);
+    } else if (!RunSherpaDiarization(handles_[worker], data, count, window.segments)) {
+        return false;
+    }
+
+    // Embed each window speaker from (up to kMaxEmbedSeconds of) its own audio
+    int32_t num_local = 0;
+    for (const SpeakerSegment& seg : window.segments) {
+        num_local = std::max(num_local, seg.speaker_id + 1);
+    }
+    const size_t max_embed = static_cast<size_t>(kMaxEmbedSeconds * sample_rate);
+    std::vector<float> audio;
+    window.embeddings.assign(static_cast<size_t>(num_local), std::vector<float>());
+    for (int32_t local = 0; local < num_local; ++local) {
+        audio.clear();
+        for (const SpeakerSegment& seg : window.segments) {
+            if (seg.speaker_id != local || audio.size() >= max_embed) {
+                continue;
+            }
+            const size_t first = std::min(count, MsToSamples(seg.start_ms, sample_rate));
+            const size_t last = std::min(count, MsToSamples(seg.end_ms, sample_rate));
+            const size_t take = std::min(last - std::min(first, last), max_embed - audio.size());
+            audio.insert(audio.end(), data + first, data + first + take);
         }
+        if (audio.empty()) {
+            continue;
+        }
+        window.embeddings[static_cast<size_t>(local)] =
+            config_.embed_fn ? config_.embed_fn(audio.data(), audio.size(), sample_rate)
+                             : ExtractEmbedding(extractors_[worker], audio.data(), audio.size(),
+                                                sample_rate);
     }
 
-    // Free the C objects: the segment array first, then the result.
-    if (segments) {
-        SherpaOnnxOfflineSpeakerDiarizationDestroySegment(segments);
+    // Window time -> recording time
+    const int64_t offset_ms =
+        static_cast<int64_t>(window.begin * 1000 / static_cast<size_t>(sample_rate));
+    for (SpeakerSegment& seg : window.segments) {
+        seg.start_ms += offset_ms;
+        seg.end_ms += offset_ms;
     }
-    SherpaOnnxOfflineSpeakerDiarizationDestroyResult(sd_result);
+    return true;
+}
 
-    LOG_INFO("Diarizer::Diarize produced %zu speaker segment(s)", result.size());
-    return result;
+std::vector<SpeakerSegment> Diarizer::DiarizeWindowed(const std::vector<float>& samples,
+                                                      int sample_rate) {
+    const size_t rate = static_cast<size_t>(sample_rate);
+    const size_t window_samples = static_cast<size_t>(config_.window_s) * rate;
+    const size_t overlap = std::min(
+        static_cast<size_t>(std::max(config_.window_overlap_s, 0)) * rate, window_samples / 2);
+    const size_t step = window_samples - overlap;
+
+    std::vector<Window> windows;
+    for (size_t begin = 0;; begin += step) {
+        Window window;
+        window.begin = begin;
+        window.end = std::min(begin + window_samples, samples.size());
+        windows.push_back(std::move(window));
+        if (windows.back().end == samples.size()) {
+            break;
+        }
+    }
+
+    // Windows are independent until clustering: spread them over the workers
+    const size_t workers = std::min(GetNumWorkers(), windows.size());
+    std::atomic<size_t> next{0};
+    auto run = [&](size_t worker) {
+        for (size_t w = next.fetch_add(1); w < windows.size(); w = next.fetch_add(1)) {
+            windows[w].ok = ProcessWindow(worker, samples.data(), sample_rate, windows[w]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t worker = 1; worker < workers; ++worker) {
+        threads.emplace_back(run, worker);
+    }
+    run(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<SpeakerSegment> result;
+    for (const Window& window : windows) {
+        if (!window.ok) {
+            last_error_ = "Diarizer: SherpaOnnxOfflineSpeakerDiarizationProcess returned null";
+            LOG_ERROR("%s (window at %zu s)", last_error_.c_str(), window.begin / rate);
+            return result;
+        }
+    }
+
+    // One clustering pass over every window's speakers
+    std::vector<std::vector<float>> embeddings;
+    std::vector<size_t> first_item(windows.size());
+    for (size_t w = 0; w < windows.size(); ++w) {
+        first_item[w] = embeddings.size();
+        for (std::vector<float>& embedding : windows[w].embeddings) {
+            embeddings.push_back(std::move(embedding));
+        }
+    }
+    const std::vector<int32_t> labels =
+        ClusterEmbeddings(embeddings, config_.num_speakers, config_.cluster_threshold);
+
+    // Each window keeps its turns between the midpoints of its overlaps
+    auto midpoint_ms = [&](size_t w) {
+        return static_cast<int64_t>((windows[w].end + windows[w + 1].begin) / 2 * 1000 / rate);
+    };
+    for (size_t w = 0; w < windows.size(); ++w) {
+        const int64_t lo = w == 0 ? INT64_MIN : midpoint_ms(w - 1);
+        const int64_t hi = w + 1 == windows.size() ? INT64_MAX : midpoint_ms(w);
+        const size_t num_local = windows[w].embeddings.size();
+        for (const SpeakerSegment& seg : windows[w].segments) {
+            const int64_t start = std::max(seg.start_ms, lo);
+            const int64_t end = std::min(seg.end_ms, hi);
+            if (start >= end) {
+                continue;
+            }
+            const bool known =
+                seg.speaker_id >= 0 && static_cast<size_t>(seg.speaker_id) < num_local;
+            const int32_t speaker =
+                known ? labels[first_item[w] + static_cast<size_t>(seg.speaker_id)] : -1;
+            result.emplace_back(start, end, speaker);
+        }
+    }
+
+    // Rejoin turns that were cut at a window midpoint
+    std::stable_sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.start_ms < b.start_ms;
+    });
+    std::vector<SpeakerSegment> merged;
+    for (const SpeakerSegment& seg : result) {
+        if (!merged.empty() && merged.back().speaker_id == seg.speaker_id &&
+            seg.start_ms <= merged.back().end_ms) {
+            merged.back().end_ms = std::max(merged.back().end_ms, seg.end_ms);
+        } else {
+            merged.push_back(seg);
+        }
+    }
+
+    LOG_INFO("Diarizer::Diarize produced %zu speaker segment(s) from %zu windows on %zu workers",
+             merged.size(), windows.size(), workers);
+    return merged;
 }
 
 bool Diarizer::IsInitialized() const {
@@ -193,12 +728,115 @@ std::string Diarizer::GetLastError() const {
 int Diarizer::GetExpectedSampleRate() const {
     // In test-seam mode (or before Init) there is no handle; report the
     // sherpa-onnx diarization model rate, which is 16 kHz.
-    if (handle_) {
-        return SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handle_);
+    if (!handles_.empty()) {
+        return SherpaOnnxOfflineSpeakerDiarizationGetSampleRate(handles_.front());
     }
     return 16000;
 }
 
+// =============================================================================
+// OnlineDiarizer — gated by ENABLE_DIARIZATION
+// =============================================================================
+
+OnlineDiarizer::OnlineDiarizer(const OnlineDiarizerConfig& config)
+    : config_(config), clusterer_(config.clustering) {
+    LOG_INFO("OnlineDiarizer created");
+}
+
+OnlineDiarizer::~OnlineDiarizer() {
+    if (extractor_) {
+        SherpaOnnxDestroySpeakerEmbeddingExtractor(extractor_);
+        extractor_ = nullptr;
+    }
+    LOG_INFO("OnlineDiarizer destroyed");
+}
+
+bool OnlineDiarizer::Init() {
+    if (initialized_) {
+        return true;
+    }
+
+    // Test-seam mode: no model file, no sherpa-onnx handle needed.
+    if (config_.embed_fn) {
+        initialized_ = true;
+        LOG_INFO("OnlineDiarizer initialized in test-seam mode (embed_fn set)");
+        return true;
+    }
+
+    if (config_.embedding_model_path.empty()) {
+        last_error_ = "OnlineDiarizer: embedding_model_path is empty";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    SherpaOnnxSpeakerEmbeddingExtractorConfig extractor_config;
+    memset(&extractor_config, 0, sizeof(extractor_config));
+    extractor_config.model = config_.embedding_model_path.c_str();
+    extractor_config.num_threads = config_.num_threads;
+    extractor_config.provider = "cpu";
+
+    extractor_ = SherpaOnnxCreateSpeakerEmbeddingExtractor(&extractor_config);
+    if (!extractor_) {
+        last_error_ =
+            "OnlineDiarizer: SherpaOnnxCreateSpeakerEmbeddingExtractor failed "
+            "(check embedding model path)";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    initialized_ = true;
+    LOG_INFO("OnlineDiarizer initialized: embedding='%s', dim=%d",
+             config_.embedding_model_path.c_str(),
+             SherpaOnnxSpeakerEmbeddingExtractorDim(extractor_));
+    return true;
+}
+
+int32_t OnlineDiarizer::AssignSpeaker(const float* samples, size_t count, int sample_rate) {
+    if (!initialized_) {
+        LOG_ERROR("OnlineDiarizer::AssignSpeaker called before successful Init()");
+        return -1;
+    }
+    if (samples == nullptr || sample_rate <= 0) {
+        return -1;
+    }
+    // Too short to carry a reliable voice print
+    if (static_cast<int64_t>(count) * 1000 <
+        static_cast<int64_t>(config_.min_segment_ms) * sample_rate) {
+        return -1;
+    }
+
+    // Test-seam mode: delegate to the injected function.
+    if (config_.embed_fn) {
+        const std::vector<float> embedding = config_.embed_fn(samples, count, sample_rate);
+        return clusterer_.Assign(embedding.data(), embedding.size());
+    }
+
+    const std::vector<float> embedding =
+        ExtractEmbedding(extractor_, samples, count, sample_rate);
+    if (embedding.empty()) {
+        last_error_ = "OnlineDiarizer: embedding extraction failed";
+        LOG_ERROR("%s", last_error_.c_str());
+        return -1;
+    }
+    return clusterer_.Assign(embedding.data(), embedding.size());
+}
+
+bool OnlineDiarizer::IsInitialized() const {
+    return initialized_;
+}
+
+std::string OnlineDiarizer::GetLastError() const {
+    return last_error_;
+}
+
+int OnlineDiarizer::GetExpectedSampleRate() const {
+    return 16000;
+}
+
+void OnlineDiarizer::Reset() {
+    clusterer_.Reset();
+}
+
 #endif  // ENABLE_DIARIZATION
 
 }  // namespace ffvoice
@@ -7,15 +7,21 @@
  * clustering).  MergeIntoSegments then stamps those speaker labels onto
  * Whisper TranscriptionSegments by largest temporal overlap.
  *
- * The Diarizer class is only available when ENABLE_DIARIZATION is defined.
- * SpeakerSegment and MergeIntoSegments are always compiled so callers and
- * tests can use them in any build configuration.
+ * OnlineDiarizer is the streaming counterpart: it embeds one utterance at a
+ * time (e.g. each LiveCaptioner Final) and assigns it to a speaker with
+ * SpeakerClusterer, so memory stays bounded however long the session runs.
+ *
+ * The Diarizer and OnlineDiarizer classes are only available when
+ * ENABLE_DIARIZATION is defined. SpeakerSegment, MergeIntoSegments and
+ * SpeakerClusterer are always compiled so callers and tests can use them in
+ * any build configuration.
  */
 
 #pragma once
 
 #include "audio/whisper_processor.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -49,12 +55,20 @@ struct SpeakerSegment {
 };
 
 /**
- * @brief Assign a speaker_id to each TranscriptionSegment via temporal overlap.
+ * @brief Assign a speaker_id to each TranscriptionSegment and Word via temporal overlap.
  *
  * For every segment, the SpeakerSegment with the largest millisecond overlap
  * wins (ties resolved to the earlier SpeakerSegment).  Segments with no overlap
- * keep their existing speaker_id of -1.  An empty @p speakers list leaves every
- * segment untouched.
+ * keep their existing speaker_id of -1.  Each Word is matched the same way, so
+ * a speaker change inside a segment shows up on its words; a word with no
+ * overlap takes its segment's speaker_id.  An empty @p speakers list leaves
+ * every segment untouched.
+ *
+ * Runs as one sweep over both lists in time order, O(S + T) for S speaker
+ * segments and T segments plus words (and the speaker segments that actually
+ * overlap each query). Neither list has to be sorted: unsorted speakers are
+ * indexed by start time first (O(S log S)), and a query that starts before
+ * the previous one restarts the sweep.
  *
  * @param segments Transcription segments to annotate (modified in place).
  * @param speakers Diarization segments produced by Diarizer::Diarize().
@@ -62,6 +76,79 @@ struct SpeakerSegment {
 void MergeIntoSegments(std::vector<TranscriptionSegment>& segments,
                        const std::vector<SpeakerSegment>& speakers);
 
+/**
+ * @brief Agglomerative clustering of speaker embeddings.
+ *
+ * Starts with one cluster per embedding and repeatedly merges the two
+ * clusters whose centroids (sums of unit-normalized members) have the
+ * smallest cosine distance. It stops at @p num_speakers clusters, or, when
+ * that is <= 0, once the closest pair is at least @p threshold apart.
+ *
+ * @param embeddings   One embedding per item, all of the same dimension
+ * @param num_speakers Clusters to produce; <= 0 = decide by @p threshold
+ * @param threshold    Cosine distance (1 - similarity) below which clusters merge
+ * @return Cluster label per item, numbered 0.. by first appearance; -1 for
+ *         empty, all-zero or wrongly sized embeddings
+ */
+std::vector<int32_t> ClusterEmbeddings(const std::vector<std::vector<float>>& embeddings,
+                                       int num_speakers, float threshold);
+
+/**
+ * @brief Online speaker clustering against running centroids.
+ *
+ * Each embedding is compared (cosine similarity) with the centroid of every
+ * speaker seen so far. It joins the most similar speaker if the similarity
+ * reaches similarity_threshold, otherwise it starts a new speaker; once
+ * max_speakers exist it always joins the most similar one. A centroid is the
+ * running mean of its member embeddings (unit-normalized), weighted as if it
+ * held at most max_centroid_weight of them, so it keeps following a voice
+ * that drifts over a long session.
+ *
+ * Memory is max_speakers centroids of one embedding each. Unconditionally
+ * compiled; not thread-safe.
+ */
+class SpeakerClusterer {
+public:
+    /**
+     * @brief Configuration for SpeakerClusterer
+     */
+    struct Config {
+        float similarity_threshold = 0.5f;  ///< Cosine similarity needed to join a speaker
+        int max_speakers = 8;               ///< Speakers tracked; past this the nearest one wins
+        int max_centroid_weight = 50;       ///< Embeddings a centroid averages at most
+    };
+
+    SpeakerClusterer();
+    explicit SpeakerClusterer(const Config& config);
+
+    /**
+     * @brief Assign one embedding to a speaker, updating that speaker's centroid.
+     *
+     * The first embedding fixes the dimension; later ones of another
+     * dimension, or all-zero ones, are rejected.
+     *
+     * @param embedding Speaker embedding (any scale)
+     * @param dim       Number of values in @p embedding
+     * @return Speaker index, 0-based; -1 if the embedding was rejected
+     */
+    int32_t Assign(const float* embedding, size_t dim);
+
+    /// Number of speakers created so far
+    size_t GetNumSpeakers() const {
+        return counts_.size();
+    }
+
+    /// Forget every speaker
+    void Reset();
+
+private:
+    Config config_;
+    size_t dim_ = 0;                ///< Embedding dimension, fixed by the first Assign()
+    std::vector<float> centroids_;  ///< GetNumSpeakers() x dim_, row-major
+    std::vector<int> counts_;       ///< Embeddings merged into each centroid (capped)
+    std::vector<float> unit_;       ///< Normalized copy of the embedding being assigned
+};
+
 #ifdef ENABLE_DIARIZATION
 
 /**
@@ -94,6 +181,22 @@ struct DiarizerConfig {
     /// Inference threads for the segmentation and embedding models.
     int num_threads = 2;
 
+    /**
+     * @brief Windowed mode for long recordings (seconds; 0 = one call over everything).
+     *
+     * Longer recordings are split into windows overlapping by window_overlap_s.
+     * The windows are segmented and their speakers embedded concurrently on
+     * num_workers threads, then ClusterEmbeddings() labels the speakers of all
+     * windows together, so speaker ids agree across the whole recording.
+     */
+    int window_s = 0;
+
+    /// Overlap between consecutive windows (s); turns are cut at its midpoint.
+    int window_overlap_s = 10;
+
+    /// Windows processed at once (0 = hardware threads / num_threads).
+    int num_workers = 0;
+
     /**
      * @brief Test-seam for the diarization back-end.
      *
@@ -102,13 +205,22 @@ struct DiarizerConfig {
      * LiveCaptionerConfig::transcribe_fn — enables unit tests with no models.
      */
     std::function<std::vector<SpeakerSegment>(const std::vector<float>&, int)> diarize_fn = nullptr;
+
+    /**
+     * @brief Test-seam for speaker embeddings in windowed mode.
+     *
+     * With diarize_fn set, windowed mode calls diarize_fn once per window and
+     * this (samples, count, sample rate -> embedding) once per window speaker;
+     * without it a seam diarizer makes a single call.
+     */
+    std::function<std::vector<float>(const float*, size_t, int)> embed_fn = nullptr;
 };
 
 /**
  * @brief Offline speaker diarization engine.
  *
  * Wraps the sherpa-onnx offline speaker-diarization C API with RAII over the
- * opaque C handle.  Usage:
+ * opaque C handles.  Usage:
  * @code
  * DiarizerConfig cfg;
  * Diarizer diarizer(cfg);
@@ -152,6 +264,8 @@ public:
      * Returns an empty vector if the diarizer is not initialized or @p samples
      * is empty.  When config.diarize_fn is set, the seam is invoked instead of
      * sherpa-onnx.  Otherwise @p sample_rate must equal GetExpectedSampleRate().
+     * Recordings longer than config.window_s are diarized window by window in
+     * parallel (see DiarizerConfig::window_s).
      *
      * @param samples     Mono PCM samples normalized to [-1, 1].
      * @param sample_rate Sample rate of @p samples in Hz.
@@ -181,12 +295,149 @@ public:
     int GetExpectedSampleRate() const;
 
 private:
+    struct Window;
+
+    /// Whether @p num_samples at @p sample_rate is diarized window by window
+    bool UseWindows(size_t num_samples, int sample_rate) const;
+
+    /// Windowed Diarize(): parallel windows, then one clustering pass
+    std::vector<SpeakerSegment> DiarizeWindowed(const std::vector<float>& samples,
+                                                int sample_rate);
+
+    /// Segment one window and embed each of its speakers (worker thread)
+    bool ProcessWindow(size_t worker, const float* samples, int sample_rate, Window& window) const;
+
+    /// Number of windowed-mode worker threads
+    size_t GetNumWorkers() const;
+
     DiarizerConfig config_;     ///< Configuration (copy)
     std::string last_error_;    ///< Last error message
     bool initialized_ = false;  ///< True after Init() succeeds
 
+    /// Opaque sherpa-onnx handles, one per worker; empty until Init() (and in seam mode).
+    std::vector<const SherpaOnnxOfflineSpeakerDiarization*> handles_;
+
+    /// Embedding extractors for windowed mode, one per worker.
+    std::vector<const SherpaOnnxSpeakerEmbeddingExtractor*> extractors_;
+};
+
+/**
+ * @brief Configuration for the OnlineDiarizer.
+ */
+struct OnlineDiarizerConfig {
+    #ifdef DIARIZATION_EMBEDDING_MODEL_PATH
+    /// Speaker-embedding model (.onnx).
+    std::string embedding_model_path = DIARIZATION_EMBEDDING_MODEL_PATH;
+    #else
+    std::string embedding_model_path = "";
+    #endif
+
+    /// Inference threads for the embedding model.
+    int num_threads = 1;
+
+    /// Utterances shorter than this are too short to embed reliably; they get -1.
+    int min_segment_ms = 500;
+
+    /// Online clustering of the embeddings.
+    SpeakerClusterer::Config clustering;
+
+    /**
+     * @brief Test-seam for the embedding back-end.
+     *
+     * When set, AssignSpeaker() calls this function instead of sherpa-onnx
+     * (mono samples, count, sample rate -> embedding), and Init() becomes a
+     * no-op success requiring no model file.
+     */
+    std::function<std::vector<float>(const float*, size_t, int)> embed_fn = nullptr;
+};
+
+/**
+ * @brief Streaming speaker diarization, one utterance at a time.
+ *
+ * Where Diarizer needs the whole recording, OnlineDiarizer embeds each
+ * utterance as it is finalized (sherpa-onnx speaker-embedding extractor) and
+ * labels it with SpeakerClusterer. Nothing but the centroids is kept between
+ * calls. Hook it into LiveCaptioner through LiveCaptionerConfig::speaker_fn:
+ * @code
+ * OnlineDiarizer diarizer;
+ * diarizer.Init();
+ * cfg.speaker_fn = [&diarizer](const float* pcm, size_t n) {
+ *     return diarizer.AssignSpeaker(pcm, n, 16000);
+ * };
+ * @endcode
+ *
+ * Not thread-safe; LiveCaptioner calls speaker_fn from its inference thread only.
+ */
+class OnlineDiarizer {
+public:
+    /**
+     * @brief Construct an OnlineDiarizer with the given configuration.
+     * @param config Configuration parameters (copied internally).
+     */
+    explicit OnlineDiarizer(const OnlineDiarizerConfig& config = OnlineDiarizerConfig{});
+
+    /**
+     * @brief Destructor — releases the embedding extractor.
+     */
+    ~OnlineDiarizer();
+
+    // Non-copyable (owns an opaque C handle).
+    OnlineDiarizer(const OnlineDiarizer&) = delete;
+    OnlineDiarizer& operator=(const OnlineDiarizer&) = delete;
+
+    /**
+     * @brief Load the embedding model.
+     *
+     * Idempotent. When config.embed_fn is set, this is a no-op success.
+     *
+     * @return true on success; false on failure (see GetLastError()).
+     */
+    bool Init();
+
+    /**
+     * @brief Embed one utterance and assign it to a speaker.
+     *
+     * @param samples     Mono PCM samples normalized to [-1, 1].
+     * @param count       Number of samples.
+     * @param sample_rate Sample rate of @p samples in Hz (GetExpectedSampleRate()).
+     * @return Speaker index, 0-based; -1 if not initialized, the utterance is
+     *         shorter than min_segment_ms or embedding failed.
+     */
+    int32_t AssignSpeaker(const float* samples, size_t count, int sample_rate);
+
+    /**
+     * @brief Query whether Init() has succeeded.
+     * @return true once Init() has completed successfully.
+     */
+    bool IsInitialized() const;
+
+    /**
+     * @brief Return the last error message (empty string if no error).
+     * @return Human-readable error description.
+     */
+    std::string GetLastError() const;
+
+    /**
+     * @brief Return the input sample rate the model expects (Hz, 16000).
+     */
+    int GetExpectedSampleRate() const;
+
+    /// Number of speakers seen so far
+    size_t GetNumSpeakers() const {
+        return clusterer_.GetNumSpeakers();
+    }
+
+    /// Forget every speaker (e.g. at the start of a new session)
+    void Reset();
+
+private:
+    OnlineDiarizerConfig config_;  ///< Configuration (copy)
+    std::string last_error_;       ///< Last error message
+    bool initialized_ = false;     ///< True after Init() succeeds
+    SpeakerClusterer clusterer_;   ///< Running speaker centroids
+
     /// Opaque sherpa-onnx handle; nullptr until Init() (and in seam mode).
-    const SherpaOnnxOfflineSpeakerDiarization* handle_ = nullptr;
+    const SherpaOnnxSpeakerEmbeddingExtractor* extractor_ = nullptr;
 };
 
 #endif  // ENABLE_DIARIZATION
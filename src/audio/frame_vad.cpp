@@ -0,0 +1,125 @@
+/**
+ * @file frame_vad.cpp
+ * @brief Implementation of the energy / spectral-flatness frame VAD
+ */
+
+#include "audio/frame_vad.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ffvoice {
+
+namespace {
+
+// Mean square of a full-scale int16 signal, the 0 dBFS reference
+constexpr double kFullScaleEnergy = 32768.0 * 32768.0;
+
+double DbfsToEnergy(float dbfs) {
+    return kFullScaleEnergy * std::pow(10.0, static_cast<double>(dbfs) / 10.0);
+}
+
+// Energy and lag-1 autocorrelation of one mono frame. Integer sums are exact
+// in any order, so the compiler is free to vectorize both reductions.
+template <typename Sample>
+void FrameSums(const Sample* x, size_t n, int64_t& energy, int64_t& lag1) {
+    int64_t e = 0;
+    int64_t c = 0;
+    for (size_t i = 0; i < n; ++i) {
+        e += static_cast<int64_t>(x[i]) * x[i];
+    }
+    for (size_t i = 1; i < n; ++i) {
+        c += static_cast<int64_t>(x[i]) * x[i - 1];
+    }
+    energy = e;
+    lag1 = c;
+}
+
+}  // namespace
+
+FrameVAD::FrameVAD() : FrameVAD(Config{}) {
+}
+
+FrameVAD::FrameVAD(const Config& config) : config_(config) {
+    Reset();
+}
+
+bool FrameVAD::Initialize(int sample_rate, int channels) {
+    if (sample_rate <= 0 || channels <= 0 || config_.frame_ms <= 0) {
+        LOG_ERROR("FrameVAD: invalid configuration (rate=%d, channels=%d, frame=%d ms)",
+                  sample_rate, channels, config_.frame_ms);
+        return false;
+    }
+    const size_t frames =
+        static_cast<size_t>(sample_rate) * static_cast<size_t>(config_.frame_ms) / 1000;
+    if (frames < 2) {
+        LOG_ERROR("FrameVAD: %d ms frames at %d Hz are too short", config_.frame_ms, sample_rate);
+        return false;
+    }
+
+    channels_ = channels;
+    frame_frames_ = frames;
+    mono_.assign(channels > 1 ? frames : 0, 0);
+
+    const double frame_s = static_cast<double>(config_.frame_ms) / 1000.0;
+    noise_rise_ = std::pow(10.0, config_.noise_rise_db_per_s * frame_s / 10.0);
+    min_energy_ = DbfsToEnergy(config_.min_energy_dbfs);
+    Reset();
+    return true;
+}
+
+float FrameVAD::ProcessFrame(const int16_t* samples) {
+    if (frame_frames_ == 0 || samples == nullptr) {
+        return 0.0f;
+    }
+
+    // Downmix by summing; the mean square is rescaled by channels^2 below
+    int64_t energy_sum = 0;
+    int64_t lag1_sum = 0;
+    if (channels_ == 1) {
+        FrameSums(samples, frame_frames_, energy_sum, lag1_sum);
+    } else {
+        const size_t channels = static_cast<size_t>(channels_);
+        for (size_t i = 0; i < frame_frames_; ++i) {
+            int32_t sum = 0;
+            for (size_t ch = 0; ch < channels; ++ch) {
+                sum += samples[i * channels + ch];
+            }
+            mono_[i] = sum;
+        }
+        FrameSums(mono_.data(), frame_frames_, energy_sum, lag1_sum);
+    }
+
+    const double scale = static_cast<double>(channels_) * static_cast<double>(channels_);
+    const double energy =
+        static_cast<double>(energy_sum) / static_cast<double>(frame_frames_) / scale;
+
+    // Score against the floor as it was before this frame
+    const double noise = noise_energy_;
+    noise_energy_ = energy < noise ? std::max(energy, min_energy_)
+                                   : std::min(energy, noise * noise_rise_);
+    if (energy <= min_energy_) {
+        return 0.0f;
+    }
+
+    const double snr_db = 10.0 * std::log10(energy / noise);
+    const double span =
+        std::max(1e-3, static_cast<double>(config_.snr_high_db - config_.snr_low_db));
+    const double score = std::clamp((snr_db - config_.snr_low_db) / span, 0.0, 1.0);
+
+    const double r1 = static_cast<double>(lag1_sum) / static_cast<double>(energy_sum);
+    const double flatness = std::clamp(1.0 - r1 * r1, 0.0, 1.0);
+    return static_cast<float>(score * (1.0 - config_.flatness_weight * flatness));
+}
+
+void FrameVAD::Reset() {
+    noise_energy_ = DbfsToEnergy(config_.initial_noise_dbfs);
+}
+
+float FrameVAD::GetNoiseFloorDbfs() const {
+    return static_cast<float>(10.0 * std::log10(noise_energy_ / kFullScaleEnergy));
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,91 @@
+/**
+ * @file frame_vad.h
+ * @brief Low-cost voice activity estimate on 10 ms frames
+ *
+ * VADSegmenter counts its min_speech_frames / min_silence_frames in 10 ms
+ * frames but needs a probability for each one. FrameVAD provides it without a
+ * model: frame energy against a running noise floor, weighted by how far the
+ * frame's spectrum is from flat (noise is flat, voiced speech is not).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Energy / spectral-flatness voice activity detector.
+ *
+ * Each frame is downmixed to mono and reduced to three sums: energy,
+ * lag-1 autocorrelation and sample count. The sums are integer, so the loop
+ * vectorizes without -ffast-math and the result does not depend on the
+ * instruction set.
+ *
+ * - Energy is compared with a noise floor that follows quiet frames down
+ *   immediately and rises by at most noise_rise_db_per_s, so speech does not
+ *   drag it up but a louder room is learned within seconds.
+ * - 1 - r1^2 (r1 = normalized lag-1 autocorrelation) is the first-order
+ *   spectral flatness: 1 for white noise, near 0 for low-frequency voiced
+ *   speech and for sibilants. It scales the energy score by
+ *   (1 - flatness_weight) .. 1.
+ *
+ * Not thread-safe; owned by a single worker thread.
+ */
+class FrameVAD {
+public:
+    /**
+     * @brief Configuration for FrameVAD
+     */
+    struct Config {
+        int frame_ms = 10;                  ///< Frame length (VADSegmenter's frame unit)
+        float snr_low_db = 3.0f;            ///< Energy above the floor that scores 0
+        float snr_high_db = 15.0f;          ///< Energy above the floor that scores 1
+        float min_energy_dbfs = -60.0f;     ///< Frames quieter than this are silence
+        float noise_rise_db_per_s = 3.0f;   ///< Fastest upward drift of the noise floor
+        float flatness_weight = 0.6f;       ///< Share of the score a flat spectrum removes
+        float initial_noise_dbfs = -60.0f;  ///< Noise floor before any frame is seen
+    };
+
+    FrameVAD();
+    explicit FrameVAD(const Config& config);
+
+    /**
+     * @brief Prepare for interleaved int16 input
+     * @param sample_rate Sample rate in Hz
+     * @param channels Number of interleaved channels (1 or more)
+     * @return true on success, false on invalid arguments
+     */
+    bool Initialize(int sample_rate, int channels);
+
+    /// Interleaved samples in one frame (frame_ms at the configured rate, all channels)
+    size_t GetFrameSamples() const {
+        return frame_frames_ * static_cast<size_t>(channels_);
+    }
+
+    /**
+     * @brief Voice activity probability of one frame
+     * @param samples GetFrameSamples() interleaved samples
+     * @return Probability in [0, 1]; 0 if not initialized
+     */
+    float ProcessFrame(const int16_t* samples);
+
+    /// Forget the learned noise floor
+    void Reset();
+
+    /// Current noise floor estimate (dBFS)
+    float GetNoiseFloorDbfs() const;
+
+private:
+    Config config_;
+    int channels_ = 0;
+    size_t frame_frames_ = 0;    ///< Frames (per channel) in one VAD frame
+    double noise_energy_ = 0.0;  ///< Mean square of the noise floor (int16 scale)
+    double noise_rise_ = 1.0;    ///< Per-frame upper bound on noise floor growth
+    double min_energy_ = 0.0;    ///< min_energy_dbfs as a mean square
+    std::vector<int32_t> mono_;  ///< Downmix scratch for multi-channel input
+};
+
+}  // namespace ffvoice
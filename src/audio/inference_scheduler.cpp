@@ -0,0 +1,259 @@
+/**
+ * @file inference_scheduler.cpp
+ * @brief Implementation of the central multi-session Whisper scheduler
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/inference_scheduler.h"
+
+    #include "utils/audio_converter.h"
+    #include "utils/logger.h"
+
+    #include <algorithm>
+
+namespace ffvoice {
+
+namespace {
+
+// Whisper's encoder scales well up to roughly four threads; beyond that more
+// concurrent decodes give better throughput than wider ones.
+constexpr unsigned kThreadsPerDecode = 4;
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+}  // namespace
+
+InferenceScheduler::InferenceScheduler(const InferenceSchedulerConfig& config) : config_(config) {
+    // Cores the workers may use: the pinned set, or the whole machine
+    const auto hw = static_cast<size_t>(CpuBudget(config_.worker_thread_policy));
+
+    num_workers_ = config_.num_workers > 0 ? config_.num_workers
+                                           : std::max<size_t>(1, hw / kThreadsPerDecode);
+    threads_per_worker_ =
+        config_.threads_per_worker > 0
+            ? config_.threads_per_worker
+            : static_cast<int>(std::max<size_t>(1, hw / num_workers_));
+}
+
+InferenceScheduler::~InferenceScheduler() {
+    Stop();
+}
+
+bool InferenceScheduler::Start() {
+    if (running_.load(std::memory_order_acquire)) {
+        LOG_WARNING("InferenceScheduler: already running");
+        return true;
+    }
+
+    // One processor per worker, all borrowing states from one shared model
+    if (!config_.transcribe_fn && processors_.empty()) {
+        WhisperConfig whisper = config_.whisper;
+        whisper.share_model = true;
+        whisper.n_threads = threads_per_worker_;
+        if (whisper.max_shared_states == 0) {
+            whisper.max_shared_states = num_workers_;
+        }
+        for (size_t i = 0; i < num_workers_; ++i) {
+            auto processor = std::make_unique<WhisperProcessor>(whisper);
+            if (!processor->Initialize()) {
+                last_error_ =
+                    "InferenceScheduler: model initialization failed: " + processor->GetLastError();
+                LOG_ERROR("%s", last_error_.c_str());
+                processors_.clear();
+                return false;
+            }
+            processors_.push_back(std::move(processor));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    running_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < num_workers_; ++i) {
+        workers_.emplace_back(&InferenceScheduler::WorkerLoop, this, i);
+    }
+
+    LOG_INFO("InferenceScheduler: started %zu workers x %d threads", num_workers_,
+             threads_per_worker_);
+    return true;
+}
+
+void InferenceScheduler::Stop() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::deque<Request> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto* queue : {&finals_, &partials_}) {
+            for (auto& request : *queue) {
+                cancelled.push_back(std::move(request));
+            }
+            queue->clear();
+        }
+        stats_.cancelled += cancelled.size();
+    }
+    work_available_.notify_all();
+
+    for (auto& request : cancelled) {
+        request.promise.set_value(InferenceResult());
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    running_.store(false, std::memory_order_release);
+    LOG_INFO("InferenceScheduler: stopped");
+}
+
+std::future<InferenceResult> InferenceScheduler::Submit(InferencePriority priority,
+                                                        std::vector<int16_t> samples,
+                                                        int input_sample_rate,
+                                                        const std::string& prompt,
+                                                        const std::string& language) {
+    Request request;
+    request.samples = std::move(samples);
+    request.input_sample_rate = input_sample_rate;
+    request.prompt = prompt;
+    request.language = language;
+    return Enqueue(priority, std::move(request));
+}
+
+std::future<InferenceResult> InferenceScheduler::SubmitPcm(InferencePriority priority,
+                                                           std::vector<float> pcm,
+                                                           const std::string& prompt,
+                                                           const std::string& language) {
+    Request request;
+    request.pcm = std::move(pcm);
+    request.input_sample_rate = 16000;
+    request.prompt = prompt;
+    request.language = language;
+    return Enqueue(priority, std::move(request));
+}
+
+std::future<InferenceResult> InferenceScheduler::Enqueue(InferencePriority priority,
+                                                         Request request) {
+    request.submitted_at = std::chrono::steady_clock::now();
+    std::future<InferenceResult> future = request.promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool full = finals_.size() + partials_.size() >= config_.max_queue_depth;
+        if (stopping_ || !running_.load(std::memory_order_acquire) ||
+            (priority == InferencePriority::Partial && full)) {
+            // Finals are never rejected for depth; everything is rejected once stopped
+            ++stats_.rejected;
+            request.promise.set_value(InferenceResult());
+            return future;
+        }
+        ++stats_.submitted;
+        (priority == InferencePriority::Final ? finals_ : partials_).push_back(std::move(request));
+    }
+    work_available_.notify_one();
+    return future;
+}
+
+size_t InferenceScheduler::GetQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finals_.size() + partials_.size();
+}
+
+InferenceSchedulerStats InferenceScheduler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    InferenceSchedulerStats stats = stats_;
+    stats.queue_depth = finals_.size() + partials_.size();
+    stats.mean_final_wait_ms =
+        completed_finals_ ? total_final_wait_ms_ / static_cast<double>(completed_finals_) : 0.0;
+    stats.mean_partial_wait_ms =
+        completed_partials_ ? total_partial_wait_ms_ / static_cast<double>(completed_partials_)
+                            : 0.0;
+    return stats;
+}
+
+void InferenceScheduler::WorkerLoop(size_t index) {
+    ApplyThreadPolicy(config_.worker_thread_policy,
+                      "InferenceScheduler worker " + std::to_string(index));
+    WhisperProcessor* processor = processors_.empty() ? nullptr : processors_[index].get();
+    std::vector<int16_t> seam_samples;  // PCM requests converted back for transcribe_fn
+
+    while (true) {
+        Request request;
+        bool is_final = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(
+                lock, [this]() { return stopping_ || !finals_.empty() || !partials_.empty(); });
+            if (stopping_) {
+                break;
+            }
+            // Finals first: a user waiting on a finished sentence beats a preview
+            is_final = !finals_.empty();
+            auto& queue = is_final ? finals_ : partials_;
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        InferenceResult result;
+        result.queue_wait_ms = MillisecondsSince(request.submitted_at);
+
+        const auto start = std::chrono::steady_clock::now();
+        if (config_.transcribe_fn) {
+            const std::vector<int16_t>* samples = &request.samples;
+            if (!request.pcm.empty()) {
+                seam_samples.resize(request.pcm.size());
+                AudioConverter::FloatToInt16(request.pcm.data(), request.pcm.size(),
+                                             seam_samples.data());
+                samples = &seam_samples;
+            }
+            result.ok = config_.transcribe_fn(samples->data(), samples->size(), result.segments);
+        } else {
+            // Sessions share workers, so every request sets its own language
+            processor->SetLanguage(request.language.empty() ? config_.whisper.language
+                                                            : request.language);
+            processor->SetInitialPrompt(request.prompt);
+            if (!request.pcm.empty()) {
+                result.ok = processor->TranscribePcm(request.pcm.data(), request.pcm.size(),
+                                                     result.segments);
+            } else {
+                processor->SetInputSampleRate(request.input_sample_rate);
+                result.ok = processor->TranscribeBuffer(request.samples.data(),
+                                                        request.samples.size(), result.segments);
+            }
+            if (result.ok) {
+                result.language = processor->GetDetectedLanguage();
+            }
+        }
+        result.inference_ms = MillisecondsSince(start);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.completed;
+            if (is_final) {
+                ++completed_finals_;
+                total_final_wait_ms_ += result.queue_wait_ms;
+                stats_.max_final_wait_ms = std::max(stats_.max_final_wait_ms, result.queue_wait_ms);
+            } else {
+                ++completed_partials_;
+                total_partial_wait_ms_ += result.queue_wait_ms;
+                stats_.max_partial_wait_ms =
+                    std::max(stats_.max_partial_wait_ms, result.queue_wait_ms);
+            }
+        }
+        request.promise.set_value(std::move(result));
+    }
+}
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,232 @@
+/**
+ * @file inference_scheduler.h
+ * @brief Central Whisper inference scheduler shared by many caption sessions
+ *
+ * Instead of every LiveCaptioner running whisper_full with its own thread
+ * pool (oversubscribing the CPU when dozens of sessions run on one box), the
+ * sessions submit requests to one InferenceScheduler. It runs them on a fixed
+ * set of workers whose thread counts are sized to the machine, always serving
+ * Final requests before Partial ones.
+ */
+
+#pragma once
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_processor.h"
+    #include "utils/thread_policy.h"
+
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <functional>
+    #include <future>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Scheduling class of a request; Final is always served first.
+ */
+enum class InferencePriority {
+    Final,   ///< End-of-utterance transcription (never rejected)
+    Partial  ///< Mid-utterance preview (rejected when the queue is full)
+};
+
+/**
+ * @brief Outcome of one scheduled transcription.
+ */
+struct InferenceResult {
+    bool ok = false;                             ///< True if transcription succeeded
+    std::vector<TranscriptionSegment> segments;  ///< Transcribed segments (empty on failure)
+    double queue_wait_ms = 0.0;                  ///< Time between Submit() and a worker starting it
+    double inference_ms = 0.0;                   ///< Time spent transcribing
+    std::string language;                        ///< Language decoded in (empty if unknown)
+};
+
+/**
+ * @brief Configuration for InferenceScheduler.
+ */
+struct InferenceSchedulerConfig {
+    /// Whisper configuration for every worker (n_threads is overridden; the model is shared)
+    WhisperConfig whisper;
+
+    /// Number of concurrent decodes (0 = one per 4 cores, at least 1)
+    size_t num_workers = 0;
+
+    /// whisper.cpp threads per worker (0 = cores / num_workers, at least 1)
+    int threads_per_worker = 0;
+
+    /// Maximum queued requests before new Partial requests are rejected
+    size_t max_queue_depth = 64;
+
+    /// Priority / cores of every worker (whisper.cpp's compute threads inherit it on
+    /// Linux); pinned cores also bound the default num_workers and threads_per_worker
+    ThreadPolicy worker_thread_policy;
+
+    /**
+     * @brief Test-seam for the transcription back-end.
+     *
+     * When set, workers call this instead of WhisperProcessor::TranscribeBuffer
+     * and no model is loaded. Signature mirrors LiveCaptionerConfig::transcribe_fn.
+     * SubmitPcm() audio reaches it converted to 16 kHz int16.
+     */
+    std::function<bool(const int16_t*, size_t, std::vector<TranscriptionSegment>&)> transcribe_fn =
+        nullptr;
+};
+
+/**
+ * @brief Cumulative scheduler statistics (see InferenceScheduler::GetStats()).
+ */
+struct InferenceSchedulerStats {
+    uint64_t submitted = 0;             ///< Requests accepted into the queue
+    uint64_t completed = 0;             ///< Requests a worker finished (ok or not)
+    uint64_t rejected = 0;              ///< Refused (queue full for Partials, or stopped)
+    uint64_t cancelled = 0;             ///< Queued requests abandoned by Stop()
+    size_t queue_depth = 0;             ///< Requests currently queued (not yet started)
+    double mean_final_wait_ms = 0.0;    ///< Mean queue wait of completed Final requests
+    double max_final_wait_ms = 0.0;     ///< Longest queue wait of a Final request
+    double mean_partial_wait_ms = 0.0;  ///< Mean queue wait of completed Partial requests
+    double max_partial_wait_ms = 0.0;   ///< Longest queue wait of a Partial request
+};
+
+/**
+ * @brief Fixed pool of Whisper workers serving requests from many sessions.
+ *
+ * @code
+ * InferenceSchedulerConfig cfg;
+ * cfg.whisper.model_path = "ggml-base.bin";
+ * InferenceScheduler scheduler(cfg);
+ * scheduler.Start();
+ *
+ * LiveCaptionerConfig cap_cfg;
+ * cap_cfg.scheduler = &scheduler;  // Must outlive the captioner
+ * @endcode
+ *
+ * Each worker owns a WhisperProcessor with WhisperConfig::share_model set, so
+ * the weights are loaded once and each worker borrows its own whisper_state.
+ * Submit() is thread-safe and never blocks on inference.
+ */
+class InferenceScheduler {
+public:
+    explicit InferenceScheduler(const InferenceSchedulerConfig& config);
+    ~InferenceScheduler();
+
+    InferenceScheduler(const InferenceScheduler&) = delete;
+    InferenceScheduler& operator=(const InferenceScheduler&) = delete;
+
+    /**
+     * @brief Load the model and launch the workers.
+     * @return true on success; false on failure (see GetLastError())
+     */
+    bool Start();
+
+    /**
+     * @brief Finish in-flight requests, cancel queued ones and join the workers.
+     *
+     * Cancelled requests resolve with ok = false. Safe to call multiple times.
+     */
+    void Stop();
+
+    /**
+     * @brief Queue audio for transcription.
+     *
+     * @param priority          Final requests are served before all Partial ones
+     * @param samples           Mono int16 PCM (moved into the request)
+     * @param input_sample_rate Sample rate of @p samples (Hz)
+     * @param prompt            Optional initial prompt for the decode
+     * @param language          Language for this decode ("auto" detects it); empty uses
+     *                          the configured whisper.language
+     * @return Future resolved when the request completes, is rejected or is cancelled
+     */
+    std::future<InferenceResult> Submit(InferencePriority priority, std::vector<int16_t> samples,
+                                        int input_sample_rate,
+                                        const std::string& prompt = std::string(),
+                                        const std::string& language = std::string());
+
+    /**
+     * @brief Queue audio that is already in Whisper format (16 kHz float mono)
+     *
+     * Like Submit(), but the worker decodes @p pcm without converting it.
+     *
+     * @param priority Final requests are served before all Partial ones
+     * @param pcm      Samples in [-1, 1] at 16 kHz, mono (moved into the request)
+     * @param prompt   Optional initial prompt for the decode
+     * @param language Language for this decode; empty uses the configured whisper.language
+     * @return Future resolved when the request completes, is rejected or is cancelled
+     */
+    std::future<InferenceResult> SubmitPcm(InferencePriority priority, std::vector<float> pcm,
+                                           const std::string& prompt = std::string(),
+                                           const std::string& language = std::string());
+
+    /// Requests currently queued (not yet picked up by a worker)
+    size_t GetQueueDepth() const;
+
+    /// Snapshot of cumulative statistics
+    InferenceSchedulerStats GetStats() const;
+
+    /// Number of workers (resolved from the config at construction)
+    size_t GetNumWorkers() const {
+        return num_workers_;
+    }
+
+    /// whisper.cpp threads used by each worker
+    int GetThreadsPerWorker() const {
+        return threads_per_worker_;
+    }
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    struct Request {
+        std::vector<int16_t> samples;
+        std::vector<float> pcm;  ///< Whisper-format audio; used instead of samples if not empty
+        int input_sample_rate = 48000;
+        std::string prompt;
+        std::string language;  ///< Empty: config_.whisper.language
+        std::chrono::steady_clock::time_point submitted_at;
+        std::promise<InferenceResult> promise;
+    };
+
+    /// Queue @p request, or resolve it as rejected; returns its future
+    std::future<InferenceResult> Enqueue(InferencePriority priority, Request request);
+
+    void WorkerLoop(size_t index);
+
+    InferenceSchedulerConfig config_;
+    size_t num_workers_ = 1;
+    int threads_per_worker_ = 1;
+    std::string last_error_;
+
+    std::vector<std::unique_ptr<WhisperProcessor>> processors_;  ///< One per worker
+    std::vector<std::thread> workers_;
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::deque<Request> finals_;    ///< Pending Final requests, oldest first
+    std::deque<Request> partials_;  ///< Pending Partial requests, oldest first
+    bool stopping_ = false;
+    InferenceSchedulerStats stats_;     ///< queue_depth and means are filled in GetStats()
+    double total_final_wait_ms_ = 0.0;  ///< Sum over completed Final requests
+    double total_partial_wait_ms_ = 0.0;
+    uint64_t completed_finals_ = 0;
+    uint64_t completed_partials_ = 0;
+};
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
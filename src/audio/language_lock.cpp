@@ -0,0 +1,82 @@
+/**
+ * @file language_lock.cpp
+ * @brief LanguageLock implementation
+ */
+
+#include "audio/language_lock.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+
+namespace ffvoice {
+
+const std::string LanguageLock::kAuto = "auto";
+
+LanguageLock::LanguageLock() : LanguageLock(Config()) {
+}
+
+LanguageLock::LanguageLock(const Config& config) : config_(config) {
+}
+
+void LanguageLock::OnFinal(const std::string& detected, int64_t speech_ms, float confidence) {
+    if (!config_.enabled || detected.empty()) {
+        return;
+    }
+
+    if (locked_) {
+        weak_finals_ = confidence < config_.reprobe_confidence ? weak_finals_ + 1 : 0;
+        if (weak_finals_ >= std::max<size_t>(config_.reprobe_after, 1)) {
+            LOG_INFO("LanguageLock: %zu weak finals in '%s', detecting again", weak_finals_,
+                     language_.c_str());
+            Unlock();
+            ++reprobes_;
+        }
+        return;
+    }
+
+    // Speech-weighted vote: a long sentence outweighs a misdetected "yes"
+    auto it = std::find_if(votes_.begin(), votes_.end(),
+                           [&](const auto& vote) { return vote.first == detected; });
+    if (it == votes_.end()) {
+        votes_.emplace_back(detected, 0);
+        it = votes_.end() - 1;
+    }
+    const int64_t ms = std::max<int64_t>(speech_ms, 0);
+    it->second += ms;
+    probe_speech_ms_ += ms;
+    ++probe_finals_;
+
+    if (probe_speech_ms_ < config_.probe_ms && probe_finals_ < config_.probe_utterances) {
+        return;
+    }
+
+    // Ties go to the language heard first
+    auto best = votes_.begin();
+    for (auto vote = votes_.begin(); vote != votes_.end(); ++vote) {
+        if (vote->second > best->second) {
+            best = vote;
+        }
+    }
+    language_ = best->first;
+    locked_ = true;
+    weak_finals_ = 0;
+    LOG_INFO("LanguageLock: locked '%s' after %zu finals (%lld ms of speech)", language_.c_str(),
+             probe_finals_, static_cast<long long>(probe_speech_ms_));
+}
+
+void LanguageLock::Reset() {
+    Unlock();
+    reprobes_ = 0;
+}
+
+void LanguageLock::Unlock() {
+    locked_ = false;
+    language_.clear();
+    votes_.clear();
+    probe_speech_ms_ = 0;
+    probe_finals_ = 0;
+    weak_finals_ = 0;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,91 @@
+/**
+ * @file language_lock.h
+ * @brief Session-level language pinning for streaming transcription
+ *
+ * With language "auto" every whisper_full() call detects the language again:
+ * one more encoder pass per decode, and short partials sometimes come back in
+ * a different language than the utterance around them. A live session almost
+ * always speaks one language, so LanguageLock detects it over the first few
+ * seconds of speech, pins it for every following decode, and goes back to
+ * detection only if the pinned language stops producing confident finals.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Detects a session's language once, then pins it.
+ *
+ * While probing, GetLanguage() is "auto" and every Final reports the language
+ * Whisper detected for it; votes are weighted by the utterance's speech
+ * duration. Once probe_ms of speech (or probe_utterances finals) is seen, the
+ * language with the most speech is locked. While locked, reprobe_after
+ * consecutive finals below reprobe_confidence unlock it again (a speaker
+ * change, or a wrong first guess).
+ *
+ * Not thread-safe; owned by a single worker thread.
+ */
+class LanguageLock {
+public:
+    /**
+     * @brief Configuration for LanguageLock
+     */
+    struct Config {
+        bool enabled = true;              ///< false: always detect ("auto" on every decode)
+        int probe_ms = 3000;              ///< Speech to detect over before locking
+        size_t probe_utterances = 3;      ///< ...or lock after this many finals, if sooner
+        float reprobe_confidence = 0.4f;  ///< Finals below this mean confidence count as weak
+        size_t reprobe_after = 2;         ///< Consecutive weak finals that unlock the language
+    };
+
+    LanguageLock();
+    explicit LanguageLock(const Config& config);
+
+    /**
+     * @brief Record the outcome of a Final decode
+     * @param detected Language Whisper used for it ("en"); empty if unknown (ignored)
+     * @param speech_ms Duration of the utterance
+     * @param confidence Mean segment confidence of the Final
+     */
+    void OnFinal(const std::string& detected, int64_t speech_ms, float confidence);
+
+    /// Language to request for the next decode: the locked code, or "auto"
+    const std::string& GetLanguage() const {
+        return locked_ ? language_ : kAuto;
+    }
+
+    bool IsLocked() const {
+        return locked_;
+    }
+
+    /// Times a locked language was released for detection again
+    size_t GetReprobeCount() const {
+        return reprobes_;
+    }
+
+    /// Forget the lock and all votes
+    void Reset();
+
+private:
+    void Unlock();
+
+    static const std::string kAuto;
+
+    Config config_;
+    std::string language_;  ///< Locked language
+    bool locked_ = false;
+    std::vector<std::pair<std::string, int64_t>> votes_;  ///< Probe speech ms per language
+    int64_t probe_speech_ms_ = 0;
+    size_t probe_finals_ = 0;
+    size_t weak_finals_ = 0;
+    size_t reprobes_ = 0;
+};
+
+}  // namespace ffvoice
@@ -7,27 +7,97 @@
 
     #include "audio/live_captioner.h"
 
+    #include "audio/caption_event_queue.h"
+    #include "utils/audio_converter.h"
     #include "utils/logger.h"
+    #include "utils/trace.h"
 
     #include <algorithm>
     #include <chrono>
-    #include <cmath>
+    #include <future>
     #include <numeric>
     #include <thread>
 
 namespace ffvoice {
 
+namespace {
+
+// Longest confirmed-text tail passed back to Whisper as the prompt.
+constexpr size_t kMaxPromptChars = 200;
+
+// Whisper's input rate; Job audio is always at this rate, mono.
+constexpr int kWhisperSampleRate = 16000;
+
+// Interleaved int16 -> mono float; stereo takes the fused SIMD path
+void ToMonoFloat(const int16_t* samples, size_t frames, size_t channels, std::vector<float>& mono) {
+    if (channels == 2) {
+        mono.resize(frames);
+        AudioConverter::Int16StereoToMono(samples, frames, mono.data());
+        return;
+    }
+    mono.resize(frames * channels);
+    AudioConverter::Int16ToFloat(samples, frames * channels, mono.data());
+    if (channels > 2) {
+        // In place: frame f is read from index f * channels >= f before it is overwritten
+        for (size_t f = 0; f < frames; ++f) {
+            float sum = 0.0f;
+            for (size_t c = 0; c < channels; ++c) {
+                sum += mono[f * channels + c];
+            }
+            mono[f] = sum / static_cast<float>(channels);
+        }
+        mono.resize(frames);
+    }
+}
+
+WhisperConfig MakeWhisperConfig(const LiveCaptionerConfig& config) {
+    WhisperConfig whisper = config.whisper;
+    // Word boundaries let incremental partials advance the decode window
+    // exactly to the last confirmed word.
+    if (config.incremental_partials) {
+        whisper.word_timestamps = true;
+    }
+    // More compute threads than pinned cores would only time-slice them
+    if (!config.thread_policy.cpus.empty()) {
+        whisper.n_threads = std::min(whisper.n_threads, CpuBudget(config.thread_policy));
+    }
+    return whisper;
+}
+
+// One tag per 10 ms frame the sample ring can hold, plus slack
+size_t FrameVadTagCapacity(const LiveCaptionerConfig& config) {
+    const size_t frame_samples = static_cast<size_t>(std::max(config.sample_rate / 100, 1)) *
+                                 static_cast<size_t>(std::max(config.channels, 1));
+    return config.ring_buffer_capacity / frame_samples + 2;
+}
+
+}  // namespace
+
 // ============================================================================
 // Construction / Destruction
 // ============================================================================
 
 LiveCaptioner::LiveCaptioner(const LiveCaptionerConfig& config)
     : config_(config),
-      whisper_(config.whisper),
+      whisper_(MakeWhisperConfig(config)),
       vad_(config.vad),
-      ring_buffer_(config.ring_buffer_capacity) {
+      frame_vad_(config.frame_vad),
+      ring_buffer_(config.ring_buffer_capacity),
+      frame_vad_tags_(FrameVadTagCapacity(config)),
+      resampler_(config.sample_rate, kWhisperSampleRate),
+      language_lock_(config.language_lock),
+      final_resampler_(config.sample_rate, kWhisperSampleRate) {
     // Pre-allocate accumulation buffer to avoid repeated allocations
-    accumulation_buffer_.reserve(config_.vad.max_segment_samples);
+    const size_t channels = static_cast<size_t>(std::max(config_.channels, 1));
+    accumulation_buffer_.reserve(static_cast<size_t>(
+        static_cast<double>(config_.vad.max_segment_samples) / static_cast<double>(channels) *
+        kWhisperSampleRate / std::max(config_.sample_rate, 1)) + 1);
+
+    // Falls back to mono 48 kHz framing so the ingest batch is never empty
+    if (!frame_vad_.Initialize(config_.sample_rate, std::max(config_.channels, 1))) {
+        frame_vad_.Initialize(48000, 1);
+    }
+    vad_frame_.resize(frame_vad_.GetFrameSamples());
 
     // Apply the suppress_whisper_progress flag to the embedded WhisperConfig so
     // the real WhisperProcessor respects it even though config_.whisper is a
@@ -39,6 +109,10 @@ LiveCaptioner::LiveCaptioner(const LiveCaptionerConfig& config)
 
 LiveCaptioner::~LiveCaptioner() {
     Stop();
+    // A background load still running uses whisper_, which is destroyed first
+    if (model_loading_.valid()) {
+        model_loading_.wait();
+    }
 }
 
 // ============================================================================
@@ -50,11 +124,30 @@ bool LiveCaptioner::Initialize() {
         LOG_WARNING("LiveCaptioner: already initialized");
         return true;
     }
+    init_started_ = std::chrono::steady_clock::now();
+
+    // The ingest thread consumes whole 10 ms frames; a ring that cannot hold
+    // one would never fill a batch
+    if (ring_buffer_.capacity() < frame_vad_.GetFrameSamples()) {
+        SetLastError("LiveCaptioner: ring_buffer_capacity " +
+                     std::to_string(ring_buffer_.capacity()) + " is below one 10 ms frame (" +
+                     std::to_string(frame_vad_.GetFrameSamples()) + " samples)");
+        return false;
+    }
 
     // If a test-seam transcription function is provided, skip loading the real
     // Whisper model — this allows unit testing without a model file.
     if (config_.transcribe_fn) {
         LOG_INFO("LiveCaptioner: using test-seam transcribe_fn, skipping model load");
+        model_ready_.store(true, std::memory_order_release);
+        initialized_ = true;
+        return true;
+    }
+
+    // A shared scheduler owns the model; nothing to load per session
+    if (config_.scheduler) {
+        LOG_INFO("LiveCaptioner: using shared inference scheduler, skipping model load");
+        model_ready_.store(true, std::memory_order_release);
         initialized_ = true;
         return true;
     }
@@ -63,27 +156,51 @@ bool LiveCaptioner::Initialize() {
     // user set it; apply it now just before initialisation).
     config_.whisper.print_progress = !config_.suppress_whisper_progress;
 
-    if (!whisper_.Initialize()) {
-        last_error_ =
-            "LiveCaptioner: WhisperProcessor initialization failed: " + whisper_.GetLastError();
-        LOG_ERROR("%s", last_error_.c_str());
-        return false;
+    if (config_.background_init) {
+        // The inference thread waits for the load before its first job
+        model_loading_ = std::async(std::launch::async, [this]() { return LoadModel(); });
+        initialized_ = true;
+        LOG_INFO("LiveCaptioner: loading the model in the background");
+        return true;
     }
 
+    if (!LoadModel()) {
+        return false;
+    }
     initialized_ = true;
+    return true;
+}
+
+bool LiveCaptioner::LoadModel() {
+    FFVOICE_TRACE_SCOPE("LiveCaptioner::LoadModel");
+    if (!whisper_.Initialize()) {
+        SetLastError("LiveCaptioner: WhisperProcessor initialization failed: " +
+                     whisper_.GetLastError());
+        return false;
+    }
+    model_ready_.store(true, std::memory_order_release);
     LOG_INFO("LiveCaptioner: initialized (ring_buffer=%zu, partial_interval=%dms)",
              config_.ring_buffer_capacity, config_.partial_interval_ms);
     return true;
 }
 
+void LiveCaptioner::SetLastError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = message;
+    LOG_ERROR("%s", last_error_.c_str());
+}
+
 void LiveCaptioner::SetCallback(CaptionCallback callback) {
     callback_ = std::move(callback);
 }
 
+void LiveCaptioner::SetEventQueue(std::shared_ptr<CaptionEventQueue> queue) {
+    event_queue_ = std::move(queue);
+}
+
 bool LiveCaptioner::Start() {
     if (!initialized_) {
-        last_error_ = "LiveCaptioner: Start() called before Initialize()";
-        LOG_ERROR("%s", last_error_.c_str());
+        SetLastError("LiveCaptioner: Start() called before Initialize()");
         return false;
     }
 
@@ -92,46 +209,50 @@ bool LiveCaptioner::Start() {
         return true;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        inference_stop_ = false;
+    }
     running_.store(true, std::memory_order_release);
+    inference_thread_ = std::thread(&LiveCaptioner::InferenceLoop, this);
     worker_thread_ = std::thread(&LiveCaptioner::WorkerLoop, this);
 
-    LOG_INFO("LiveCaptioner: worker thread started");
+    LOG_INFO("LiveCaptioner: ingest and inference threads started");
     return true;
 }
 
 void LiveCaptioner::Stop() {
     if (!running_.load(std::memory_order_acquire)) {
+        if (event_queue_) {
+            event_queue_->Close();  // Never started: let a waiting consumer finish
+        }
         return;
     }
 
     running_.store(false, std::memory_order_release);
+    ring_buffer_.wake();  // Release the ingest thread if it is parked
 
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
 
     // Flush any audio that is still buffered in the VAD segmenter.  This is
-    // done on the calling thread (the worker has already exited), so we are
-    // the only writer to accumulation_buffer_ at this point.
-    auto on_segment = [this](const int16_t* seg_samples, size_t seg_count) {
-        std::vector<TranscriptionSegment> segments;
-        bool ok = Transcribe(seg_samples, seg_count, segments);
-
-        if (callback_) {
-            CaptionEvent ev;
-            ev.type = CaptionEventType::Final;
-            ev.utterance_id = utterance_id_++;
-            ev.confidence = ok ? MeanConfidence(segments) : 0.0f;
-            ev.text = ok ? JoinText(segments) : "";
-            ev.utterance_start_ms = (!ok || segments.empty()) ? 0 : segments.front().start_ms;
-            ev.utterance_end_ms = (!ok || segments.empty()) ? 0 : segments.back().end_ms;
-            callback_(ev);
-        }
-
-        accumulation_buffer_.clear();
-    };
-
-    vad_.Flush(on_segment);
+    // done on the calling thread (the ingest thread has already exited), so we
+    // are the only writer to accumulation_buffer_ at this point.
+    vad_.Flush([this](const int16_t*, size_t) { EnqueueFinal(); });
+
+    // Let the inference thread drain every queued job before it exits
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        inference_stop_ = true;
+    }
+    jobs_cv_.notify_one();
+    if (inference_thread_.joinable()) {
+        inference_thread_.join();
+    }
+    if (event_queue_) {
+        event_queue_->Close();  // Every event, including the flushed Final, is queued
+    }
 
     LOG_INFO("LiveCaptioner: stopped");
 }
@@ -140,87 +261,186 @@ size_t LiveCaptioner::FeedAudio(const int16_t* samples, size_t count) {
     if (!samples || count == 0) {
         return 0;
     }
-    return ring_buffer_.push_bulk(samples, count);
+    const size_t written = ring_buffer_.push_bulk(samples, count);
+    fed_samples_ += written;
+    RecordFeedMetrics(count, written);
+    return written;
+}
+
+size_t LiveCaptioner::FeedAudio(const int16_t* samples, size_t count,
+                                const float* frame_vad_probs, size_t num_probs,
+                                size_t first_prob_offset) {
+    if (!frame_vad_probs || num_probs == 0) {
+        return FeedAudio(samples, count);
+    }
+    if (!samples || count == 0) {
+        return 0;
+    }
+
+    // Only the producer writes, so this much room is certain to be there
+    const size_t to_write = std::min(count, ring_buffer_.available_write());
+
+    // Tags go in first: once the ingest thread can see a frame's samples, it
+    // can see its tag. A tag off the ingest thread's frame grid would never
+    // match, and after a short write the audio that follows is not the audio
+    // a tag past the written part describes. Frames left untagged (or without
+    // room for a tag) fall back to FrameVAD.
+    const size_t frame_samples = frame_vad_.GetFrameSamples();
+    const uint64_t first_sample = fed_samples_ + first_prob_offset;
+    if (first_sample % frame_samples == 0) {
+        for (size_t i = 0; i < num_probs; ++i) {
+            const uint64_t frame_start = first_sample + i * frame_samples;
+            if (to_write < count && frame_start + frame_samples > fed_samples_ + to_write) {
+                break;
+            }
+            if (!frame_vad_tags_.push({frame_start, frame_vad_probs[i]})) {
+                break;
+            }
+        }
+    }
+    const size_t written = ring_buffer_.push_bulk(samples, to_write);
+    fed_samples_ += written;
+    RecordFeedMetrics(count, written);
+    return written;
+}
+
+void LiveCaptioner::RecordFeedMetrics(size_t offered, size_t written) {
+    if (!MetricsRegistry::IsEnabled()) {
+        return;
+    }
+    if (written < offered) {
+        dropped_samples_->Add(offered - written);
+    }
+    ring_fill_->Record(ring_buffer_.size() * 100 / ring_buffer_.capacity());
+}
+
+uint64_t LiveCaptioner::GetDroppedPartials() const {
+    return dropped_partials_.load(std::memory_order_relaxed);
 }
 
 bool LiveCaptioner::IsRunning() const {
     return running_.load(std::memory_order_acquire);
 }
 
+bool LiveCaptioner::IsModelReady() const {
+    return model_ready_.load(std::memory_order_acquire);
+}
+
+int64_t LiveCaptioner::GetTimeToFirstCaptionMs() const {
+    const int64_t us = first_caption_us_.load(std::memory_order_relaxed);
+    return us < 0 ? -1 : us / 1000;
+}
+
 std::string LiveCaptioner::GetLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
     return last_error_;
 }
 
 // ============================================================================
-// Worker thread
+// Ingest thread
 // ============================================================================
 
 void LiveCaptioner::WorkerLoop() {
-    // Batch size: ~100 ms at 48 kHz (10 ms chunks typical for VAD)
-    static constexpr size_t kBatchSize = 4800;
-    std::vector<int16_t> batch(kBatchSize);
+    FFVOICE_TRACE_THREAD_NAME("LiveCaptioner worker");
+    ApplyThreadPolicy(config_.thread_policy, "LiveCaptioner worker");
+    // Batches of ~100 ms: ten FrameVAD frames (4800 samples at 48 kHz mono)
+    static constexpr size_t kFramesPerBatch = 10;
+    const size_t frame_samples = frame_vad_.GetFrameSamples();
+    // Whole frames that fit in the ring: wait_for_data() clamps to the
+    // capacity, so a larger batch would end mid-frame
+    const size_t batch_size =
+        std::min(kFramesPerBatch, ring_buffer_.capacity() / frame_samples) * frame_samples;
+
+    vad_batch_.resize(batch_size);
 
     auto last_partial_time = std::chrono::steady_clock::now();
 
-    // Build the VAD on_segment callback.  This closure is called from within
-    // ProcessFrame() (on the worker thread) whenever end-of-speech is detected.
-    auto on_segment = [this](const int16_t* seg_samples, size_t seg_count) {
-        std::vector<TranscriptionSegment> segments;
-        bool ok = Transcribe(seg_samples, seg_count, segments);
-
-        if (callback_) {
-            CaptionEvent ev;
-            ev.type = CaptionEventType::Final;
-            ev.utterance_id = utterance_id_++;
-            ev.confidence = ok ? MeanConfidence(segments) : 0.0f;
-            ev.text = ok ? JoinText(segments) : "";
-            ev.utterance_start_ms = (!ok || segments.empty()) ? 0 : segments.front().start_ms;
-            ev.utterance_end_ms = (!ok || segments.empty()) ? 0 : segments.back().end_ms;
-            callback_(ev);
-        }
+    // Called from within ProcessFrame() whenever end-of-speech is detected.
+    // The segment is copied into a Final job; Whisper runs on the inference thread.
+    auto on_segment = [this](const int16_t*, size_t) { EnqueueFinal(); };
 
-        // Clear the worker-local accumulation buffer for the next utterance
-        accumulation_buffer_.clear();
-        partial_in_flight_.store(false, std::memory_order_release);
+    // Feed samples into the VAD segmenter, which keeps the speech itself
+    // (worker-local, no mutex)
+    auto process_region = [&](const int16_t* region, size_t count, float vad_prob) {
+        if (count == 0) {
+            return;
+        }
+        vad_.ProcessFrame(region, count, vad_prob, on_segment);
     };
 
-    while (running_.load(std::memory_order_acquire)) {
-        size_t n = ring_buffer_.pop_bulk(batch.data(), kBatchSize);
-
-        if (n == 0) {
-            // Nothing in the ring; yield to avoid a tight spin
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    bool draining = false;
+    size_t drain_left = 0;
+    while (true) {
+        // Park until a full batch is buffered; FeedAudio() rings the doorbell
+        // only while this thread is parked. Returns early when Stop() wakes us.
+        const bool running = running_.load(std::memory_order_acquire);
+        if (running && !ring_buffer_.wait_for_data(batch_size)) {
             continue;
         }
 
-        // ----------------------------------------------------------------
-        // Compute VAD probability for this batch
-        // ----------------------------------------------------------------
-        float vad_prob = 0.0f;
-        if (config_.vad_prob_source) {
-            vad_prob = config_.vad_prob_source();
-        } else {
-            // Built-in RMS estimator: map RMS → [0, 1] with a 3000-count knee
-            double sum_sq = 0.0;
-            for (size_t i = 0; i < n; ++i) {
-                double s = static_cast<double>(batch[i]);
-                sum_sq += s * s;
+        // After Stop(), the whole frames that were in the ring are processed
+        // too, so the end of a stream reaches the final flush instead of being
+        // dropped; audio fed after that is not waited for
+        size_t take = batch_size;
+        if (!running) {
+            if (!draining) {
+                draining = true;
+                drain_left = ring_buffer_.size();
+            }
+            take = std::min(drain_left, batch_size) / frame_samples * frame_samples;
+            if (take == 0) {
+                break;
             }
-            float rms = static_cast<float>(std::sqrt(sum_sq / static_cast<double>(n)));
-            vad_prob = std::clamp(rms / 3000.0f, 0.0f, 1.0f);
+            drain_left -= take;
         }
 
-        // ----------------------------------------------------------------
-        // Feed samples into the VAD segmenter
-        // ----------------------------------------------------------------
-        vad_.ProcessFrame(batch.data(), n, vad_prob, on_segment);
+        // Work directly on ring memory (up to two contiguous regions); the
+        // samples are released with consume() once the batch is processed.
+        const RingSpans<const int16_t> batch = ring_buffer_.peek_read(take);
+        const size_t n = batch.size();
 
-        // ----------------------------------------------------------------
-        // Accumulate samples while in speech (worker-local, no mutex)
-        // ----------------------------------------------------------------
-        if (vad_.IsInSpeech()) {
-            accumulation_buffer_.insert(accumulation_buffer_.end(), batch.data(), batch.data() + n);
+        if (config_.vad_prob_source) {
+            // One probability for the whole batch, so it is one VAD frame: a
+            // batch split by the ring wrap is copied out whole
+            const float vad_prob = config_.vad_prob_source();
+            if (batch.second_size == 0) {
+                process_region(batch.first, n, vad_prob);
+            } else {
+                std::copy(batch.first, batch.first + batch.first_size, vad_batch_.begin());
+                std::copy(batch.second, batch.second + batch.second_size,
+                          vad_batch_.begin() + static_cast<std::ptrdiff_t>(batch.first_size));
+                process_region(vad_batch_.data(), n, vad_prob);
+            }
+            ingested_samples_ += n;
+            DropFrameVadTags();  // tags are ignored alongside a vad_prob_source
+        } else {
+            // Built-in FrameVAD: one probability per 10 ms frame, so the
+            // segmenter's frame counts mean what its config says. The frame
+            // straddling the ring wrap (if any) is copied out whole.
+            for (size_t pos = 0; pos < n; pos += frame_samples) {
+                const int16_t* frame = batch.first + pos;
+                if (pos >= batch.first_size) {
+                    frame = batch.second + (pos - batch.first_size);
+                } else if (pos + frame_samples > batch.first_size) {
+                    const size_t head = batch.first_size - pos;
+                    std::copy(batch.first + pos, batch.first + batch.first_size,
+                              vad_frame_.begin());
+                    std::copy(batch.second, batch.second + (frame_samples - head),
+                              vad_frame_.begin() + static_cast<std::ptrdiff_t>(head));
+                    frame = vad_frame_.data();
+                }
+                float vad_prob = 0.0f;
+                if (!TakeFrameVadTag(vad_prob)) {
+                    vad_prob = frame_vad_.ProcessFrame(frame);
+                }
+                process_region(frame, frame_samples, vad_prob);
+                ingested_samples_ += frame_samples;
+            }
         }
+        ring_buffer_.consume(n);
+
+        // Convert this batch to Whisper format once; partials reuse it as is
+        FlushIngest();
 
         // ----------------------------------------------------------------
         // Partial caption emission
@@ -229,46 +449,381 @@ void LiveCaptioner::WorkerLoop() {
         auto elapsed_ms =
             std::chrono::duration_cast<std::chrono::milliseconds>(now - last_partial_time).count();
 
-        if (vad_.IsInSpeech() &&
+        if (running && vad_.IsInSpeech() &&
             elapsed_ms >= static_cast<long long>(config_.partial_interval_ms) &&
-            accumulation_buffer_.size() >= config_.min_samples_for_partial &&
-            !partial_in_flight_.load(std::memory_order_acquire)) {
-            partial_in_flight_.store(true, std::memory_order_release);
+            vad_.GetBufferSize() >= config_.min_samples_for_partial) {
             last_partial_time = now;
+            EnqueuePartial();
+        }
+    }
+
+    LOG_INFO("LiveCaptioner: ingest thread exiting");
+}
+
+bool LiveCaptioner::TakeFrameVadTag(float& vad_prob) {
+    DropFrameVadTags();
+    const RingSpans<const FrameVadTag> tags = frame_vad_tags_.peek_read(1);
+    if (tags.empty() || tags.first[0].first_sample != ingested_samples_) {
+        return false;
+    }
+    vad_prob = tags.first[0].vad_prob;
+    frame_vad_tags_.consume(1);
+    return true;
+}
+
+void LiveCaptioner::DropFrameVadTags() {
+    while (true) {
+        const RingSpans<const FrameVadTag> tags = frame_vad_tags_.peek_read(1);
+        if (tags.empty() || tags.first[0].first_sample >= ingested_samples_) {
+            return;
+        }
+        frame_vad_tags_.consume(1);
+    }
+}
+
+void LiveCaptioner::FlushIngest() {
+    // The segmenter's buffer is the utterance; convert what is new since the
+    // last batch, reading it in place. It is contiguous, so a frame split
+    // across the two ring regions is still downmixed whole.
+    const std::vector<int16_t>& speech = vad_.GetCurrentBuffer();
+    const size_t channels = static_cast<size_t>(std::max(config_.channels, 1));
+    const size_t frames = (speech.size() - converted_input_samples_) / channels;
+    if (frames == 0) {
+        return;
+    }
+
+    ToMonoFloat(speech.data() + converted_input_samples_, frames, channels, mono_buffer_);
+    const float* mono = mono_buffer_.data();
+
+    // The streaming resampler carries its filter history from batch to batch,
+    // so the result matches converting the whole utterance in one go.
+    const size_t old_size = accumulation_buffer_.size();
+    if (resampler_.IsValid()) {
+        accumulation_buffer_.resize(old_size + resampler_.GetMaxOutputSize(frames));
+        const size_t written =
+            resampler_.Process(mono, frames, accumulation_buffer_.data() + old_size,
+                               accumulation_buffer_.size() - old_size);
+        accumulation_buffer_.resize(old_size + written);
+    } else {
+        // Rate the polyphase filter cannot handle: linear, batch by batch
+        const size_t out = static_cast<size_t>(static_cast<double>(frames) * kWhisperSampleRate /
+                                               config_.sample_rate);
+        accumulation_buffer_.resize(old_size + out);
+        AudioConverter::Resample(mono, frames, config_.sample_rate,
+                                 accumulation_buffer_.data() + old_size, out, kWhisperSampleRate);
+    }
+
+    // A trailing partial frame waits for the next batch
+    converted_input_samples_ += frames * channels;
+}
+
+void LiveCaptioner::ConvertSegment(const int16_t* samples, size_t count, std::vector<float>& pcm) {
+    const size_t channels = static_cast<size_t>(std::max(config_.channels, 1));
+    const size_t frames = count / channels;
 
-            // Transcribe a copy of the accumulation buffer
-            std::vector<int16_t> partial_copy = accumulation_buffer_;
-            std::vector<TranscriptionSegment> segments;
-            Transcribe(partial_copy.data(), partial_copy.size(), segments);
-
-            if (callback_) {
-                CaptionEvent ev;
-                ev.type = CaptionEventType::Partial;
-                ev.utterance_id = utterance_id_;  // Same ID as ongoing utterance
-                ev.confidence = 0.0f;             // Confidence not meaningful for Partial
-                ev.text = JoinText(segments);
-                ev.utterance_start_ms = segments.empty() ? 0 : segments.front().start_ms;
-                ev.utterance_end_ms = segments.empty() ? 0 : segments.back().end_ms;
-                callback_(ev);
+    ToMonoFloat(samples, frames, channels, final_mono_buffer_);
+    const float* mono = final_mono_buffer_.data();
+
+    pcm.resize(static_cast<size_t>(static_cast<double>(frames) * kWhisperSampleRate /
+                                   config_.sample_rate));
+    if (final_resampler_.IsValid()) {
+        final_resampler_.ResampleBuffer(mono, frames, pcm.data(), pcm.size());
+    } else {
+        AudioConverter::Resample(mono, frames, config_.sample_rate, pcm.data(), pcm.size(),
+                                 kWhisperSampleRate);
+    }
+}
+
+void LiveCaptioner::EnqueuePartial() {
+    Job job;
+    job.type = CaptionEventType::Partial;
+    job.utterance_id = utterance_id_;
+
+    // Incremental partials only decode from the inference thread's window
+    // start onward, so there is no need to copy the confirmed audio.
+    if (config_.incremental_partials) {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        if (hint_utterance_id_ == utterance_id_) {
+            job.base_sample = std::min(hint_window_start_, accumulation_buffer_.size());
+        }
+    }
+    job.pcm.assign(accumulation_buffer_.begin() + static_cast<std::ptrdiff_t>(job.base_sample),
+                   accumulation_buffer_.end());
+    EnqueueJob(std::move(job));
+}
+
+void LiveCaptioner::EnqueueFinal() {
+    // The segment's buffer itself goes into the queue; it is converted to
+    // Whisper format on the inference thread
+    Job job;
+    job.type = CaptionEventType::Final;
+    job.utterance_id = utterance_id_++;
+    job.segment = vad_.TakeSegment();
+    job.queued_at = std::chrono::steady_clock::now();
+    EnqueueJob(std::move(job));
+
+    // Clear the ingest-local accumulation buffer for the next utterance
+    accumulation_buffer_.clear();
+    converted_input_samples_ = 0;
+    resampler_.Reset();
+}
+
+void LiveCaptioner::EnqueueJob(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+
+        // A queued Partial is superseded by any newer job of its utterance
+        for (auto it = jobs_.begin(); it != jobs_.end();) {
+            if (it->type == CaptionEventType::Partial && it->utterance_id == job.utterance_id) {
+                it = jobs_.erase(it);
+                dropped_partials_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                ++it;
+            }
+        }
+
+        if (job.type == CaptionEventType::Partial &&
+            jobs_.size() >= std::max<size_t>(config_.max_pending_jobs, 1)) {
+            dropped_partials_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+}
+
+// ============================================================================
+// Inference thread
+// ============================================================================
+
+void LiveCaptioner::InferenceLoop() {
+    FFVOICE_TRACE_THREAD_NAME("LiveCaptioner inference");
+    ApplyThreadPolicy(config_.thread_policy, "LiveCaptioner inference");
+    // background_init: jobs queue up while the model loads. On failure they still
+    // run (and come out empty) so Finals are not lost silently and Stop() drains.
+    if (model_loading_.valid()) {
+        model_loading_.get();
+    }
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_cv_.wait(lock, [this]() { return inference_stop_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                break;  // Stop requested and every job has been handled
             }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
 
-            partial_in_flight_.store(false, std::memory_order_release);
+        if (job.type == CaptionEventType::Final) {
+            ProcessFinal(job);
+        } else {
+            ProcessPartial(job);
         }
     }
 
-    LOG_INFO("LiveCaptioner: worker thread exiting");
+    LOG_INFO("LiveCaptioner: inference thread exiting");
+}
+
+void LiveCaptioner::ProcessFinal(const Job& job) {
+    ConvertSegment(job.segment.data(), job.segment.size(), final_pcm_);
+    std::vector<TranscriptionSegment> segments;
+    bool ok = Transcribe(final_pcm_.data(), final_pcm_.size(), segments, std::string(),
+                         InferencePriority::Final);
+    if (ok && config_.whisper.language == "auto") {
+        // Finals carry enough speech to vote on (and to judge) the session language
+        language_lock_.OnFinal(decoded_language_,
+                               static_cast<int64_t>(final_pcm_.size() * 1000 / kWhisperSampleRate),
+                               MeanConfidence(segments));
+    }
+
+    if (callback_ || event_queue_) {
+        CaptionEvent ev;
+        ev.type = CaptionEventType::Final;
+        ev.utterance_id = job.utterance_id;
+        ev.confidence = ok ? MeanConfidence(segments) : 0.0f;
+        ev.text = ok ? JoinText(segments) : "";
+        ev.utterance_start_ms = (!ok || segments.empty()) ? 0 : segments.front().start_ms;
+        ev.utterance_end_ms = (!ok || segments.empty()) ? 0 : segments.back().end_ms;
+        ev.language = decoded_language_;
+        if (config_.speaker_fn && !final_pcm_.empty()) {
+            ev.speaker_id = config_.speaker_fn(final_pcm_.data(), final_pcm_.size());
+        }
+        if (MetricsRegistry::IsEnabled()) {
+            final_latency_->Record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - job.queued_at)
+                    .count()));
+        }
+        Emit(ev);
+    }
+
+    ResetPartialState();
+    agreement_utterance_ = job.utterance_id + 1;
+}
+
+void LiveCaptioner::ProcessPartial(const Job& job) {
+    if (config_.incremental_partials) {
+        // Decode only the unconfirmed tail of the utterance
+        EmitIncrementalPartial(job);
+        return;
+    }
+
+    std::vector<TranscriptionSegment> segments;
+    Transcribe(job.pcm.data(), job.pcm.size(), segments);
+
+    if (callback_ || event_queue_) {
+        CaptionEvent ev;
+        ev.type = CaptionEventType::Partial;
+        ev.utterance_id = job.utterance_id;  // Same ID as ongoing utterance
+        ev.confidence = 0.0f;                // Confidence not meaningful for Partial
+        ev.text = JoinText(segments);
+        ev.utterance_start_ms = segments.empty() ? 0 : segments.front().start_ms;
+        ev.utterance_end_ms = segments.empty() ? 0 : segments.back().end_ms;
+        ev.language = decoded_language_;
+        Emit(ev);
+    }
 }
 
 // ============================================================================
 // Private helpers
 // ============================================================================
 
-bool LiveCaptioner::Transcribe(const int16_t* samples, size_t num_samples,
-                               std::vector<TranscriptionSegment>& segments) {
+bool LiveCaptioner::Transcribe(const float* pcm, size_t num_samples,
+                               std::vector<TranscriptionSegment>& segments,
+                               const std::string& prompt, InferencePriority priority) {
+    FFVOICE_TRACE_SCOPE("LiveCaptioner::Transcribe");
+    decoded_language_.clear();
+    // "auto" is detected until the session language is locked, then pinned
+    const std::string& language = config_.whisper.language == "auto"
+                                      ? language_lock_.GetLanguage()
+                                      : config_.whisper.language;
     if (config_.transcribe_fn) {
-        return config_.transcribe_fn(samples, num_samples, segments);
+        seam_samples_.resize(num_samples);
+        AudioConverter::FloatToInt16(pcm, num_samples, seam_samples_.data());
+        const bool ok = config_.transcribe_fn(seam_samples_.data(), num_samples, segments);
+        if (ok && config_.language_fn) {
+            decoded_language_ = config_.language_fn(language);
+        }
+        return ok;
+    }
+    if (config_.scheduler) {
+        InferenceResult result =
+            config_.scheduler
+                ->SubmitPcm(priority, std::vector<float>(pcm, pcm + num_samples), prompt,
+                            language)
+                .get();
+        segments = std::move(result.segments);
+        decoded_language_ = result.language;
+        return result.ok;
+    }
+    whisper_.SetInitialPrompt(prompt);
+    whisper_.SetLanguage(language);
+    const bool ok = whisper_.TranscribePcm(pcm, num_samples, segments);
+    if (ok) {
+        decoded_language_ = whisper_.GetDetectedLanguage();
+    }
+    return ok;
+}
+
+void LiveCaptioner::EmitIncrementalPartial(const Job& job) {
+    if (job.utterance_id != agreement_utterance_) {
+        ResetPartialState();
+        agreement_utterance_ = job.utterance_id;
+    }
+    // Job audio is 16 kHz mono
+    constexpr double samples_per_ms = kWhisperSampleRate / 1000.0;
+    auto to_samples = [&](int64_t ms) {
+        return static_cast<size_t>(static_cast<double>(ms) * samples_per_ms);
+    };
+    auto to_ms = [&](size_t samples) {
+        return static_cast<int64_t>(static_cast<double>(samples) / samples_per_ms);
+    };
+
+    // The job holds utterance samples [base_sample, total)
+    const size_t total = job.base_sample + job.pcm.size();
+    window_start_sample_ = std::max(window_start_sample_, job.base_sample);
+
+    // Sliding window: audio older than partial_window_ms is not re-decoded;
+    // whatever was tentative there is taken as confirmed.
+    const size_t max_window = to_samples(std::max(config_.partial_window_ms, 1));
+    if (total > window_start_sample_ + max_window) {
+        const size_t forced_start = total - max_window;
+        agreement_.CommitUntil(to_ms(forced_start));
+        window_start_sample_ = forced_start;
+    }
+
+    if (window_start_sample_ >= total) {
+        return;
+    }
+
+    // Prompt with the tail of the confirmed text, cut at a word boundary
+    std::string prompt = agreement_.GetCommittedText();
+    if (prompt.size() > kMaxPromptChars) {
+        const size_t cut = prompt.find(' ', prompt.size() - kMaxPromptChars);
+        prompt = (cut == std::string::npos) ? std::string() : prompt.substr(cut);
+    }
+
+    std::vector<TranscriptionSegment> segments;
+    if (Transcribe(job.pcm.data() + (window_start_sample_ - job.base_sample),
+                   total - window_start_sample_, segments, prompt)) {
+        agreement_.Update(LocalAgreement::SegmentsToWords(segments, to_ms(window_start_sample_)));
+    }
+
+    // Next decode starts at the last confirmed word
+    const size_t committed_end = std::min(to_samples(agreement_.GetCommittedEndMs()), total);
+    window_start_sample_ = std::max(window_start_sample_, committed_end);
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        hint_utterance_id_ = job.utterance_id;
+        hint_window_start_ = window_start_sample_;
+    }
+
+    if (callback_ || event_queue_) {
+        const auto& committed = agreement_.GetCommitted();
+        const auto& tentative = agreement_.GetTentative();
+
+        CaptionEvent ev;
+        ev.type = CaptionEventType::Partial;
+        ev.utterance_id = job.utterance_id;
+        ev.confidence = 0.0f;
+        ev.text = agreement_.GetText();
+        ev.utterance_start_ms = !committed.empty()   ? committed.front().start_ms
+                                : !tentative.empty() ? tentative.front().start_ms
+                                                     : 0;
+        ev.utterance_end_ms = !tentative.empty()   ? tentative.back().end_ms
+                              : !committed.empty() ? committed.back().end_ms
+                                                   : 0;
+        ev.language = decoded_language_;
+        Emit(ev);
     }
-    return whisper_.TranscribeBuffer(samples, num_samples, segments);
+}
+
+void LiveCaptioner::Emit(const CaptionEvent& ev) {
+    if (first_caption_us_.load(std::memory_order_relaxed) < 0) {
+        const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - init_started_)
+                               .count();
+        first_caption_us_.store(us, std::memory_order_relaxed);
+        if (MetricsRegistry::IsEnabled()) {
+            first_caption_latency_->Record(static_cast<uint64_t>(us));
+        }
+        LOG_INFO("LiveCaptioner: first caption %.0f ms after Initialize()",
+                 static_cast<double>(us) / 1000.0);
+    }
+    if (callback_) {
+        callback_(ev);
+    }
+    if (event_queue_ && !event_queue_->Push(ev)) {
+        LOG_WARNING("LiveCaptioner: event queue full; dropped utterance %u event",
+                    ev.utterance_id);
+    }
+}
+
+void LiveCaptioner::ResetPartialState() {
+    agreement_.Reset();
+    window_start_sample_ = 0;
 }
 
 float LiveCaptioner::MeanConfidence(const std::vector<TranscriptionSegment>& segments) {
@@ -3,30 +3,49 @@
  * @brief Real-time live captioning using VAD segmentation and Whisper ASR
  *
  * LiveCaptioner connects a lock-free ring buffer (for audio ingestion from any
- * thread) to a VAD-driven segmenter and Whisper ASR back-end running on a
- * dedicated worker thread.  Partial captions are emitted at a configurable
- * interval while speech is ongoing; a Final caption is emitted at the end of
- * each detected utterance.
+ * thread) to a VAD-driven segmenter on an ingest thread, which hands
+ * transcription jobs to a Whisper ASR back-end on a separate inference thread.
+ * Partial captions are emitted at a configurable interval while speech is
+ * ongoing; a Final caption is emitted at the end of each detected utterance.
+ *
+ * Speech is converted to Whisper's format (16 kHz mono float) once, batch by
+ * batch as it is ingested, by a streaming resampler that carries its filter
+ * history across batches. Partials decode that buffer directly.
  */
 
 #pragma once
 
 #ifdef ENABLE_WHISPER
 
+    #include "audio/frame_vad.h"
+    #include "audio/inference_scheduler.h"
+    #include "audio/language_lock.h"
+    #include "audio/local_agreement.h"
     #include "audio/vad_segmenter.h"
     #include "audio/whisper_processor.h"
+    #include "utils/metrics.h"
+    #include "utils/polyphase_resampler.h"
     #include "utils/ring_buffer.h"
+    #include "utils/thread_policy.h"
 
     #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
     #include <cstddef>
     #include <cstdint>
+    #include <deque>
     #include <functional>
+    #include <future>
+    #include <memory>
+    #include <mutex>
     #include <string>
     #include <thread>
     #include <vector>
 
 namespace ffvoice {
 
+class CaptionEventQueue;
+
 // ============================================================================
 // Caption event types
 // ============================================================================
@@ -50,6 +69,8 @@ struct CaptionEvent {
     int64_t utterance_end_ms;    ///< Estimated utterance end  (ms, from Whisper segments)
     float confidence;            ///< Mean segment confidence (0.0 for Partial; mean for Final)
     uint32_t utterance_id;       ///< Monotonically incrementing utterance counter
+    int32_t speaker_id = -1;     ///< Final: speaker from speaker_fn; -1 = unknown / Partial
+    std::string language;        ///< Language decoded in ("en"); empty if unknown
 };
 
 // ============================================================================
@@ -63,51 +84,146 @@ struct CaptionEvent {
  * Whisper tiny model.  Override as needed before passing to the constructor.
  */
 struct LiveCaptionerConfig {
-    /// Whisper ASR configuration (model path, language, threads, …)
+    /**
+     * @brief Whisper ASR configuration (model path, language, threads, …)
+     *
+     * Set whisper.share_model when running many captioners on one model: the
+     * weights are loaded once and each decode borrows a pooled whisper_state.
+     */
     WhisperConfig whisper;
 
     /// VAD segmentation configuration (thresholds, min frames, …)
     VADSegmenter::Config vad;
 
+    /// Built-in frame VAD used when vad_prob_source is not set
+    FrameVAD::Config frame_vad;
+
+    /**
+     * @brief Session language lock, used when whisper.language is "auto".
+     *
+     * The language is detected over the first probe_ms of speech and then
+     * pinned for every partial and final, which saves the detection pass and
+     * stops partials flipping language; a run of low-confidence finals
+     * detects it again. Set enabled = false to detect on every decode.
+     */
+    LanguageLock::Config language_lock;
+
     /// Interval between Partial caption attempts while in speech (ms)
     int partial_interval_ms = 500;
 
-    /// Minimum accumulated samples before a Partial is emitted
+    /// Minimum accumulated input samples (at sample_rate, all channels) before a Partial
     size_t min_samples_for_partial = 16000;
 
-    /// Ring buffer capacity in samples (default ≈ 3 s at 48 kHz)
+    /**
+     * @brief Decode partials incrementally instead of re-transcribing the whole utterance.
+     *
+     * Each partial decodes only the audio after the last confirmed word, with
+     * the confirmed text passed as the Whisper prompt. Words are confirmed
+     * once two consecutive decodes agree on them (LocalAgreement-2). Partial
+     * text is the confirmed text followed by the latest unconfirmed tail. Final
+     * captions still transcribe the whole utterance.
+     */
+    bool incremental_partials = false;
+
+    /// Maximum audio re-decoded per incremental partial (ms); older audio is force-confirmed
+    int partial_window_ms = 10000;
+
+    /// Ring buffer capacity in samples (default ≈ 3 s at 48 kHz); at least one 10 ms frame
     size_t ring_buffer_capacity = 144000;
 
+    /**
+     * @brief Maximum number of transcription jobs waiting for the inference thread.
+     *
+     * A queued Partial is replaced by a newer Partial or Final of the same
+     * utterance. When the queue is full a new Partial is dropped; Final jobs
+     * are never dropped, so the bound only stalls partials while finals back up.
+     */
+    size_t max_pending_jobs = 4;
+
     /// Input audio sample rate (Hz)
     int sample_rate = 48000;
 
     /// Input audio channel count (1 = mono, 2 = stereo)
     int channels = 1;
 
+    /**
+     * @brief Priority and cores of the ingest and inference threads.
+     *
+     * whisper.cpp's compute threads are started from the inference thread and
+     * inherit its cores on Linux; with pinned cores whisper.n_threads is also
+     * capped at their count. Keep these cores off the capture thread's
+     * (CpusExcept()) so inference never preempts capture.
+     */
+    ThreadPolicy thread_policy;
+
     /**
      * @brief Optional VAD probability source.
      *
      * When set, the worker thread calls this function once per processing
-     * batch to obtain a voice-activity probability in [0, 1].  When nullptr,
-     * a built-in RMS-based estimator is used instead.
+     * batch (~100 ms) to obtain a voice-activity probability in [0, 1], and
+     * the whole batch counts as one VADSegmenter frame.  When nullptr, the
+     * built-in FrameVAD scores every 10 ms frame instead.
      */
     std::function<float()> vad_prob_source = nullptr;
 
+    /**
+     * @brief Optional shared scheduler that runs this captioner's transcriptions.
+     *
+     * When set, no model is loaded by the captioner; Final and Partial jobs are
+     * submitted to the scheduler (Finals first across all sessions) and the
+     * inference thread waits for the result. The scheduler must be started
+     * before audio is fed and must outlive the captioner.
+     */
+    InferenceScheduler* scheduler = nullptr;
+
     /// When true, Whisper's built-in progress messages are silenced.
     bool suppress_whisper_progress = true;
 
+    /**
+     * @brief Load the model on a background thread.
+     *
+     * Initialize() returns at once and Start() may follow immediately: audio
+     * is ingested and segmented while the model loads (and warms up, with
+     * whisper.warmup), and the queued jobs are transcribed once it is ready.
+     * A load failure is reported by GetLastError() and IsModelReady(); its
+     * captions come out empty.
+     */
+    bool background_init = false;
+
     /**
      * @brief Test-seam for the transcription back-end.
      *
      * When set, the worker thread calls this function instead of
      * WhisperProcessor::TranscribeBuffer.  Signature mirrors TranscribeBuffer:
      *   bool fn(const int16_t* samples, size_t count, vector<TranscriptionSegment>& out)
+     * The audio is what Whisper would decode, converted back to int16: 16 kHz
+     * mono regardless of sample_rate and channels.
      *
      * This allows full unit-testing of LiveCaptioner without a real Whisper
      * model loaded.
      */
     std::function<bool(const int16_t*, size_t, std::vector<TranscriptionSegment>&)> transcribe_fn =
         nullptr;
+
+    /**
+     * @brief Test-seam for language detection alongside transcribe_fn.
+     *
+     * Called after each successful transcribe_fn decode with the language
+     * requested for it ("auto" or the locked code); the result is the
+     * language the decode reports, as WhisperProcessor::GetDetectedLanguage()
+     * would. Lets tests drive the session language lock without a model.
+     */
+    std::function<std::string(const std::string& requested)> language_fn = nullptr;
+
+    /**
+     * @brief Optional speaker labelling of each Final.
+     *
+     * Called on the inference thread with the utterance as Whisper sees it
+     * (16 kHz mono float) before its Final is emitted; the result becomes
+     * CaptionEvent::speaker_id. Bind OnlineDiarizer::AssignSpeaker here for
+     * streaming diarization with bounded memory.
+     */
+    std::function<int32_t(const float*, size_t)> speaker_fn = nullptr;
 };
 
 // ============================================================================
@@ -153,9 +269,12 @@ using CaptionCallback = std::function<void(const CaptionEvent&)>;
  * Threading model:
  * - FeedAudio() is the producer; it writes to a lock-free ring buffer and
  *   returns immediately — safe to call from a real-time audio callback.
- * - A single worker thread drains the ring buffer, runs VAD, and serialises
- *   all Whisper calls (whisper_context is not re-entrant).
- * - CaptionCallback is invoked from the worker thread.
+ * - The ingest thread drains the ring buffer, runs VAD and queues Partial and
+ *   Final jobs.  It never waits for Whisper, so the ring keeps draining while
+ *   a decode is in progress.
+ * - The inference thread pops jobs from a bounded queue and serialises all
+ *   Whisper calls (whisper_context is not re-entrant).
+ * - CaptionCallback is invoked from the inference thread.
  */
 class LiveCaptioner {
 public:
@@ -194,6 +313,15 @@ public:
      */
     void SetCallback(CaptionCallback callback);
 
+    /**
+     * @brief Also push every CaptionEvent into @p queue (nullptr detaches).
+     *
+     * For consumers that poll from an event loop instead of running code on
+     * the inference thread. Stop() closes the queue once the last event is
+     * in it. Must be called while stopped; works alongside SetCallback().
+     */
+    void SetEventQueue(std::shared_ptr<CaptionEventQueue> queue);
+
     /**
      * @brief Start the worker thread and begin processing audio.
      *
@@ -225,12 +353,73 @@ public:
      */
     size_t FeedAudio(const int16_t* samples, size_t count);
 
+    /**
+     * @brief Feed audio together with VAD probabilities for its frames.
+     *
+     * Lets a VAD that already ran on the samples (e.g.
+     * RNNoiseProcessor::GetFrameVADProbabilities()) drive segmentation instead
+     * of the built-in FrameVAD. The probabilities travel through a second
+     * lock-free ring tagged with the stream position of the frame they
+     * describe, so they stay aligned with the samples regardless of thread
+     * timing and block size.
+     *
+     * Probability i describes the frame (see GetVadFrameSamples()) starting
+     * @p first_prob_offset + i frames into @p samples; the offset may point
+     * past the end of the block when the VAD runs ahead of its output, as
+     * RNNoise does once it falls back to its one-frame delay (pass
+     * RNNoiseProcessor::GetFrameVADOffset() plus the latency of anything
+     * after it). Samples are written like the plain FeedAudio(). Frames
+     * without a probability, or whose probability is not on the 10 ms grid
+     * of everything fed so far, use FrameVAD; all probabilities are ignored
+     * when vad_prob_source is set.
+     *
+     * @param samples           Pointer to int16_t PCM samples.
+     * @param count             Number of samples (total, not per channel).
+     * @param frame_vad_probs   Probabilities in [0, 1], one per frame.
+     * @param num_probs         Number of probabilities.
+     * @param first_prob_offset Samples from the start of @p samples to the
+     *                          frame of the first probability.
+     * @return                  Number of samples written (0..count).
+     */
+    size_t FeedAudio(const int16_t* samples, size_t count, const float* frame_vad_probs,
+                     size_t num_probs, size_t first_prob_offset = 0);
+
+    /// Samples (all channels) in one VAD frame: 10 ms at the configured rate
+    size_t GetVadFrameSamples() const {
+        return frame_vad_.GetFrameSamples();
+    }
+
     /**
      * @brief Query whether the worker thread is currently running.
      * @return true between a successful Start() and Stop().
      */
     bool IsRunning() const;
 
+    /**
+     * @brief Number of Partial jobs discarded before being transcribed.
+     *
+     * Counts jobs superseded by a newer job of the same utterance as well as
+     * jobs dropped because the queue was full.
+     */
+    uint64_t GetDroppedPartials() const;
+
+    /**
+     * @brief Whether transcription can run: the model is loaded (or not needed).
+     *
+     * Only false while a background_init load is in progress, or after it failed.
+     */
+    bool IsModelReady() const;
+
+    /**
+     * @brief Time from Initialize() to the first caption event, in ms.
+     *
+     * Includes loading the model and waiting for the first utterance. Also
+     * recorded as captioner.time_to_first_caption_us.
+     *
+     * @return -1 until a caption has been emitted
+     */
+    int64_t GetTimeToFirstCaptionMs() const;
+
     /**
      * @brief Return the last error message (empty string if no error).
      * @return Human-readable error description.
@@ -242,20 +431,117 @@ private:
     // Internal helpers
     // -------------------------------------------------------------------------
 
+    /// Audio handed from the ingest thread to the inference thread
+    struct Job {
+        CaptionEventType type = CaptionEventType::Partial;  ///< Partial or Final
+        uint32_t utterance_id = 0;                          ///< Utterance the audio belongs to
+        size_t base_sample = 0;                             ///< Utterance offset of pcm[0]
+        std::vector<float> pcm;                             ///< Partial: 16 kHz mono float audio
+        SegmentHandle segment;                              ///< Final: VAD segment, input format
+        std::chrono::steady_clock::time_point queued_at;    ///< Final: when VAD closed the segment
+    };
+
     /**
-     * @brief Worker thread entry point.
+     * @brief Load the Whisper model (calling thread, or the background_init thread).
+     */
+    bool LoadModel();
+
+    /**
+     * @brief Record and log an error under error_mutex_ (every write goes through here).
+     */
+    void SetLastError(const std::string& message);
+
+    /**
+     * @brief Ingest thread entry point (ring buffer → VAD → job queue).
      */
     void WorkerLoop();
 
+    /**
+     * @brief Inference thread entry point (job queue → Whisper → callback).
+     */
+    void InferenceLoop();
+
+    /**
+     * @brief Queue a job, replacing stale Partials of the same utterance.
+     *
+     * Called from the ingest thread, and from Stop() once it has exited.
+     */
+    void EnqueueJob(Job job);
+
+    /**
+     * @brief Side-channel probability for the frame at ingested_samples_, if one was fed.
+     */
+    bool TakeFrameVadTag(float& vad_prob);
+
+    /**
+     * @brief Drop tags for frames before ingested_samples_ (passed, or misaligned).
+     */
+    void DropFrameVadTags();
+
+    /**
+     * @brief Downmix and resample the segmenter's new samples into the accumulation buffer.
+     */
+    void FlushIngest();
+
+    /**
+     * @brief Convert a complete VAD segment to Whisper format in one call (inference thread).
+     */
+    void ConvertSegment(const int16_t* samples, size_t count, std::vector<float>& pcm);
+
+    /**
+     * @brief Queue a Partial for the utterance currently in speech.
+     */
+    void EnqueuePartial();
+
+    /**
+     * @brief Queue a Final for a completed VAD segment and start a new utterance.
+     *
+     * Must be called from inside the segmenter's on_segment callback: the job
+     * takes the segment's buffer instead of a copy of it.
+     */
+    void EnqueueFinal();
+
+    /// Record ring occupancy and anything FeedAudio() could not fit (producer thread)
+    void RecordFeedMetrics(size_t offered, size_t written);
+
+    /**
+     * @brief Transcribe a Final job and emit its event.
+     */
+    void ProcessFinal(const Job& job);
+
+    /**
+     * @brief Transcribe a Partial job (full or incremental) and emit its event.
+     */
+    void ProcessPartial(const Job& job);
+
     /**
      * @brief Invoke the transcription back-end (test seam or real Whisper).
-     * @param samples     PCM samples to transcribe.
+     * @param pcm         Audio to transcribe (16 kHz mono float).
      * @param num_samples Number of samples.
      * @param segments    Output transcription segments.
-     * @return true on success.
+     * @param prompt      Optional initial prompt.
+     * @param priority    Scheduling class when a shared scheduler is configured.
+     * @return true on success; decoded_language_ holds the language used.
+     */
+    bool Transcribe(const float* pcm, size_t num_samples,
+                    std::vector<TranscriptionSegment>& segments,
+                    const std::string& prompt = std::string(),
+                    InferencePriority priority = InferencePriority::Partial);
+
+    /**
+     * @brief Decode the unconfirmed tail of the utterance and emit a Partial.
+     *
+     * Used when LiveCaptionerConfig::incremental_partials is set.
+     */
+    void EmitIncrementalPartial(const Job& job);
+
+    /**
+     * @brief Forget streaming partial state at an utterance boundary.
      */
-    bool Transcribe(const int16_t* samples, size_t num_samples,
-                    std::vector<TranscriptionSegment>& segments);
+    void ResetPartialState();
+
+    /// Deliver @p ev to the callback and the event queue (inference thread)
+    void Emit(const CaptionEvent& ev);
 
     /**
      * @brief Compute the mean confidence across a segment list.
@@ -275,24 +561,73 @@ private:
     // Data members
     // -------------------------------------------------------------------------
 
-    LiveCaptionerConfig config_;  ///< Configuration (copy)
-    std::string last_error_;      ///< Last error message
-    bool initialized_ = false;    ///< True after Initialize() succeeds
+    LiveCaptionerConfig config_;      ///< Configuration (copy)
+    mutable std::mutex error_mutex_;  ///< Guards last_error_ (the background load writes it)
+    std::string last_error_;          ///< Last error message
+    bool initialized_ = false;        ///< True after Initialize() succeeds
+
+    std::future<bool> model_loading_;                     ///< Pending background_init load
+    std::atomic<bool> model_ready_{false};                ///< See IsModelReady()
+    std::chrono::steady_clock::time_point init_started_;  ///< When Initialize() was called
+    std::atomic<int64_t> first_caption_us_{-1};           ///< Initialize() to the first caption
 
     WhisperProcessor whisper_;         ///< Whisper ASR back-end
     VADSegmenter vad_;                 ///< VAD segmenter
+    FrameVAD frame_vad_;               ///< Built-in per-frame VAD probability
+    std::vector<int16_t> vad_frame_;   ///< A frame split across the ring wrap
+    std::vector<int16_t> vad_batch_;   ///< A vad_prob_source batch split across the wrap
     RingBuffer<int16_t> ring_buffer_;  ///< Lock-free SPSC ring buffer
 
-    std::thread worker_thread_;         ///< Worker thread
-    std::atomic<bool> running_{false};  ///< Signals the worker thread to run
-
-    CaptionCallback callback_;  ///< User-supplied caption callback
-
-    // Worker-thread-local state (no mutex needed — only touched by worker)
-    std::vector<int16_t> accumulation_buffer_;  ///< Accumulates samples during speech
-    uint32_t utterance_id_ = 0;                 ///< Incremented on each Final event
-
-    std::atomic<bool> partial_in_flight_{false};  ///< Guard against overlapping partials
+    /// VAD probability handed in with the frame starting at input sample first_sample
+    struct FrameVadTag {
+        uint64_t first_sample = 0;
+        float vad_prob = 0.0f;
+    };
+    RingBuffer<FrameVadTag> frame_vad_tags_;  ///< Side channel beside ring_buffer_
+    uint64_t fed_samples_ = 0;                ///< Samples written so far (producer only)
+    uint64_t ingested_samples_ = 0;           ///< Samples consumed so far (ingest thread only)
+
+    MetricHistogram* ring_fill_ = &MetricsRegistry::Instance().Histogram("captioner.ring_fill_pct");
+    MetricCounter* dropped_samples_ =
+        &MetricsRegistry::Instance().Counter("captioner.dropped_samples");
+    MetricHistogram* final_latency_ =
+        &MetricsRegistry::Instance().Histogram("captioner.vad_to_final_us");
+    MetricHistogram* first_caption_latency_ =
+        &MetricsRegistry::Instance().Histogram("captioner.time_to_first_caption_us");
+
+    std::thread worker_thread_;         ///< Ingest thread
+    std::thread inference_thread_;      ///< Inference thread
+    std::atomic<bool> running_{false};  ///< Signals the ingest thread to run
+
+    CaptionCallback callback_;                       ///< User-supplied caption callback
+    std::shared_ptr<CaptionEventQueue> event_queue_;  ///< Optional pull-side consumer
+
+    // Job queue shared by the ingest and inference threads (guarded by jobs_mutex_)
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;                       ///< Pending jobs, oldest first
+    bool inference_stop_ = false;                ///< Inference thread exits once the queue is empty
+    uint32_t hint_utterance_id_ = 0;             ///< Utterance that hint_window_start_ refers to
+    size_t hint_window_start_ = 0;               ///< Incremental decode window start (samples)
+    std::atomic<uint64_t> dropped_partials_{0};  ///< See GetDroppedPartials()
+
+    // Ingest-thread-local state
+    PolyphaseResampler resampler_;            ///< sample_rate -> 16 kHz, streaming
+    std::vector<float> mono_buffer_;          ///< Downmixed float input awaiting resampling
+    std::vector<float> accumulation_buffer_;  ///< Speech so far, in Whisper format
+    size_t converted_input_samples_ = 0;      ///< Segmenter samples behind accumulation_buffer_
+    uint32_t utterance_id_ = 0;               ///< Incremented on each Final event
+
+    // Inference-thread-local state
+    LocalAgreement agreement_;              ///< Confirmed/tentative words (incremental mode)
+    uint32_t agreement_utterance_ = 0;      ///< Utterance agreement_ belongs to
+    LanguageLock language_lock_;            ///< Session language (whisper.language "auto")
+    std::string decoded_language_;          ///< Language of the last Transcribe()
+    size_t window_start_sample_ = 0;        ///< First sample of the current decode window
+    std::vector<int16_t> seam_samples_;     ///< Job audio converted back for transcribe_fn
+    PolyphaseResampler final_resampler_;    ///< sample_rate -> 16 kHz, one-shot per Final
+    std::vector<float> final_mono_buffer_;  ///< Downmixed Final segment
+    std::vector<float> final_pcm_;          ///< Final segment in Whisper format
 };
 
 }  // namespace ffvoice
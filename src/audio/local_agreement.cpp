@@ -0,0 +1,133 @@
+/**
+ * @file local_agreement.cpp
+ * @brief LocalAgreement-2 streaming transcript stabilization
+ */
+
+#include "audio/local_agreement.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace ffvoice {
+
+namespace {
+// Longest committed n-gram checked against the start of a new hypothesis when
+// removing words that Whisper repeated from its prompt.
+constexpr size_t kMaxEchoWords = 5;
+}  // namespace
+
+size_t LocalAgreement::Update(const std::vector<Word>& hypothesis) {
+    // Drop a leading run of words that merely repeats the committed tail.
+    size_t skip = 0;
+    const size_t max_n = std::min({kMaxEchoWords, committed_.size(), hypothesis.size()});
+    for (size_t n = max_n; n > 0; --n) {
+        bool match = true;
+        for (size_t i = 0; i < n && match; ++i) {
+            match = Normalize(committed_[committed_.size() - n + i].text) ==
+                    Normalize(hypothesis[i].text);
+        }
+        if (match) {
+            skip = n;
+            break;
+        }
+    }
+
+    // Commit the longest common prefix with the previous hypothesis.
+    size_t agreed = 0;
+    while (agreed < tentative_.size() && skip + agreed < hypothesis.size() &&
+           Normalize(tentative_[agreed].text) == Normalize(hypothesis[skip + agreed].text)) {
+        ++agreed;
+    }
+
+    // Take the newer decode's timestamps for committed words; they were
+    // computed with more right context.
+    committed_.insert(committed_.end(), hypothesis.begin() + skip,
+                      hypothesis.begin() + skip + agreed);
+    tentative_.assign(hypothesis.begin() + skip + agreed, hypothesis.end());
+    return agreed;
+}
+
+size_t LocalAgreement::CommitUntil(int64_t end_ms) {
+    size_t n = 0;
+    while (n < tentative_.size() && tentative_[n].end_ms <= end_ms) {
+        ++n;
+    }
+    committed_.insert(committed_.end(), tentative_.begin(), tentative_.begin() + n);
+    tentative_.erase(tentative_.begin(), tentative_.begin() + n);
+    return n;
+}
+
+int64_t LocalAgreement::GetCommittedEndMs() const {
+    return committed_.empty() ? 0 : committed_.back().end_ms;
+}
+
+std::string LocalAgreement::GetCommittedText() const {
+    return JoinWords(committed_);
+}
+
+std::string LocalAgreement::GetText() const {
+    std::vector<Word> all = committed_;
+    all.insert(all.end(), tentative_.begin(), tentative_.end());
+    return JoinWords(all);
+}
+
+void LocalAgreement::Reset() {
+    committed_.clear();
+    tentative_.clear();
+}
+
+std::vector<Word> LocalAgreement::SegmentsToWords(
+    const std::vector<TranscriptionSegment>& segments, int64_t offset_ms) {
+    std::vector<Word> words;
+    for (const auto& seg : segments) {
+        if (!seg.words.empty()) {
+            for (const auto& w : seg.words) {
+                words.emplace_back(w.start_ms + offset_ms, w.end_ms + offset_ms, w.text,
+                                   w.probability);
+            }
+            continue;
+        }
+
+        std::istringstream iss(seg.text);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token) {
+            tokens.push_back(token);
+        }
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            const bool last = (i + 1 == tokens.size());
+            words.emplace_back(seg.start_ms + offset_ms,
+                               (last ? seg.end_ms : seg.start_ms) + offset_ms, " " + tokens[i],
+                               seg.confidence);
+        }
+    }
+    return words;
+}
+
+std::string LocalAgreement::JoinWords(const std::vector<Word>& words) {
+    std::string result;
+    for (const auto& w : words) {
+        if (!result.empty() && !w.text.empty() && w.text.front() != ' ') {
+            result += ' ';
+        }
+        result += w.text;
+    }
+    return result;
+}
+
+std::string LocalAgreement::Normalize(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (unsigned char c : text) {
+        // Non-ASCII bytes (e.g. CJK) are kept as-is
+        if (c >= 0x80) {
+            out += static_cast<char>(c);
+        } else if (std::isalnum(c)) {
+            out += static_cast<char>(std::tolower(c));
+        }
+    }
+    return out;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,109 @@
+/**
+ * @file local_agreement.h
+ * @brief LocalAgreement-style stabilization of streaming partial transcripts
+ *
+ * Streaming ASR re-decodes a growing window of audio and gets a slightly
+ * different hypothesis every time. LocalAgreement-2 commits the longest common
+ * word prefix of two consecutive hypotheses: once two decodes agree on a word
+ * it is considered stable and never changes again. Only the audio after the
+ * last committed word needs to be decoded on the next tick.
+ */
+
+#pragma once
+
+#include "audio/whisper_processor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Commits the stable prefix of successive streaming hypotheses.
+ *
+ * The caller decodes only the audio after GetCommittedEndMs(), converts the
+ * segments with SegmentsToWords() (shifting them to utterance-relative time),
+ * and passes the words to Update(). GetCommittedText() is suitable as the
+ * Whisper prompt for the next decode.
+ *
+ * Not thread-safe; owned by a single worker thread.
+ */
+class LocalAgreement {
+public:
+    /**
+     * @brief Merge a new hypothesis for the uncommitted tail.
+     *
+     * Words that repeat the end of the committed text (Whisper tends to echo
+     * its prompt) are dropped first. The longest common prefix with the previous
+     * hypothesis is then committed. The rest becomes the new tentative tail.
+     *
+     * @param hypothesis Words with utterance-relative timestamps
+     * @return Number of newly committed words
+     */
+    size_t Update(const std::vector<Word>& hypothesis);
+
+    /**
+     * @brief Force-commit tentative words that end at or before @p end_ms.
+     *
+     * Used when the decode window would exceed its maximum length.
+     *
+     * @return Number of newly committed words
+     */
+    size_t CommitUntil(int64_t end_ms);
+
+    /// Words that are final for this utterance
+    const std::vector<Word>& GetCommitted() const {
+        return committed_;
+    }
+
+    /// Words from the latest hypothesis that are not yet confirmed
+    const std::vector<Word>& GetTentative() const {
+        return tentative_;
+    }
+
+    /// End time of the last committed word (ms), or 0 if nothing is committed
+    int64_t GetCommittedEndMs() const;
+
+    /// Committed words joined into text
+    std::string GetCommittedText() const;
+
+    /// Committed text followed by the tentative tail
+    std::string GetText() const;
+
+    /**
+     * @brief Forget all state (call at the start of every utterance)
+     */
+    void Reset();
+
+    /**
+     * @brief Flatten segments into words shifted by @p offset_ms.
+     *
+     * Uses per-word timestamps when present. Without them the segment text is
+     * split on whitespace and only the segment end is known precisely, so every
+     * word but the last ends at the segment start. Committing part of a
+     * segment therefore never advances the window past audio whose words are
+     * still tentative.
+     *
+     * @param segments  Segments relative to the decoded window
+     * @param offset_ms Window start relative to the utterance
+     * @return Words in utterance-relative time
+     */
+    static std::vector<Word> SegmentsToWords(const std::vector<TranscriptionSegment>& segments,
+                                             int64_t offset_ms);
+
+    /**
+     * @brief Join words into text, inserting a space where Whisper did not.
+     */
+    static std::string JoinWords(const std::vector<Word>& words);
+
+private:
+    /// Lower-case and strip punctuation/whitespace for word comparison
+    static std::string Normalize(const std::string& text);
+
+    std::vector<Word> committed_;
+    std::vector<Word> tentative_;
+};
+
+}  // namespace ffvoice
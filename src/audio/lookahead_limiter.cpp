@@ -0,0 +1,353 @@
+/**
+ * @file lookahead_limiter.cpp
+ * @brief LookaheadLimiter envelope and its SSE2 / NEON sub-block kernels
+ */
+
+#include "audio/lookahead_limiter.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define FFVOICE_LIMITER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define FFVOICE_LIMITER_NEON
+#endif
+
+namespace ffvoice {
+
+namespace {
+
+// Frames per sub-block; the vector passes and the serial envelope alternate
+// at this granularity so everything stays in L1
+constexpr size_t kSubBlockFrames = 128;
+
+// Below this RMS (-60 dBFS) the AGC holds its gain instead of amplifying noise
+constexpr double kAgcGateLevel = 0.001;
+
+float DbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+float LinearToDb(float gain) {
+    return 20.0f * std::log10(std::max(gain, 1e-10f));
+}
+
+// peaks[i] = |samples[i]| (mono frames)
+void AbsValues(const float* samples, size_t n, float* peaks) {
+    size_t i = 0;
+#if defined(FFVOICE_LIMITER_SSE2)
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(peaks + i, _mm_andnot_ps(sign, _mm_loadu_ps(samples + i)));
+    }
+#elif defined(FFVOICE_LIMITER_NEON)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(peaks + i, vabsq_f32(vld1q_f32(samples + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        peaks[i] = std::fabs(samples[i]);
+    }
+}
+
+// gains[i] = ceiling / max(peaks[i], ceiling): 1 below the ceiling, else the reduction needed
+void PeaksToGains(const float* peaks, size_t n, float ceiling, float* gains) {
+    size_t i = 0;
+#if defined(FFVOICE_LIMITER_SSE2)
+    const __m128 c = _mm_set1_ps(ceiling);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(gains + i, _mm_div_ps(c, _mm_max_ps(_mm_loadu_ps(peaks + i), c)));
+    }
+#elif defined(FFVOICE_LIMITER_NEON)
+    const float32x4_t c = vdupq_n_f32(ceiling);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(gains + i, vdivq_f32(c, vmaxq_f32(vld1q_f32(peaks + i), c)));
+    }
+#endif
+    for (; i < n; ++i) {
+        gains[i] = ceiling / std::max(peaks[i], ceiling);
+    }
+}
+
+// output[i] = input[i] * gains[i] (mono frames)
+void MultiplyGains(const float* input, const float* gains, size_t n, float* output) {
+    size_t i = 0;
+#if defined(FFVOICE_LIMITER_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), _mm_loadu_ps(gains + i)));
+    }
+#elif defined(FFVOICE_LIMITER_NEON)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(output + i, vmulq_f32(vld1q_f32(input + i), vld1q_f32(gains + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        output[i] = input[i] * gains[i];
+    }
+}
+
+float SumSquares(const float* samples, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(FFVOICE_LIMITER_SSE2)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(samples + i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(x, x));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 0x55));
+    sum = _mm_cvtss_f32(acc);
+#elif defined(FFVOICE_LIMITER_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t x = vld1q_f32(samples + i);
+        acc = vfmaq_f32(acc, x, x);
+    }
+    sum = vaddvq_f32(acc);
+#endif
+    for (; i < n; ++i) {
+        sum += samples[i] * samples[i];
+    }
+    return sum;
+}
+
+}  // namespace
+
+LookaheadLimiter::LookaheadLimiter() : LookaheadLimiter(LookaheadLimiterConfig{}) {
+}
+
+LookaheadLimiter::LookaheadLimiter(const LookaheadLimiterConfig& config) : config_(config) {
+}
+
+bool LookaheadLimiter::Initialize(int sample_rate, int channels) {
+    if (sample_rate <= 0 || channels <= 0) {
+        LOG_ERROR("LookaheadLimiter: invalid format (%d Hz, %d channels)", sample_rate, channels);
+        return false;
+    }
+    if (!(config_.ceiling_db <= 0.0f) || !(config_.lookahead_ms >= 0.1f) ||
+        config_.lookahead_ms > kMaxLookaheadMs || !(config_.release_ms > 0.0f)) {
+        LOG_ERROR("LookaheadLimiter: invalid ceiling %.1f dBFS, lookahead %.1f ms or release "
+                  "%.1f ms",
+                  config_.ceiling_db, config_.lookahead_ms, config_.release_ms);
+        return false;
+    }
+    agc_enabled_ = config_.agc_target_level > 0.0f;
+    if (agc_enabled_ &&
+        (config_.agc_target_level > 1.0f || config_.agc_min_gain_db > 0.0f ||
+         config_.agc_max_gain_db < 0.0f || !(config_.agc_window_ms > 0.0f))) {
+        LOG_ERROR("LookaheadLimiter: invalid AGC target %.3f, range %.1f..%.1f dB or window "
+                  "%.1f ms",
+                  config_.agc_target_level, config_.agc_min_gain_db, config_.agc_max_gain_db,
+                  config_.agc_window_ms);
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    ceiling_ = DbToLinear(config_.ceiling_db);
+    lookahead_frames_ = std::max<size_t>(
+        1, static_cast<size_t>(std::lround(config_.lookahead_ms * sample_rate / 1000.0f)));
+    window_ = lookahead_frames_ + 1;
+    release_coeff_ =
+        1.0f - std::exp(-1000.0f / (config_.release_ms * static_cast<float>(sample_rate)));
+    agc_min_gain_ = DbToLinear(config_.agc_min_gain_db);
+    agc_max_gain_ = DbToLinear(config_.agc_max_gain_db);
+    agc_window_frames_ = config_.agc_window_ms * sample_rate / 1000.0;
+
+    const auto ch = static_cast<size_t>(channels);
+    delay_.assign((lookahead_frames_ + kSubBlockFrames) * ch, 0.0f);
+    peaks_.assign(kSubBlockFrames, 0.0f);
+    gains_.assign(kSubBlockFrames, 1.0f);
+    deque_gain_.assign(window_, 1.0f);
+    deque_frame_.assign(window_, 0);
+    average_ring_.assign(window_, 1.0f);
+    int16_scratch_.assign(kSubBlockFrames * ch, 0.0f);
+    Reset();
+
+    LOG_INFO("LookaheadLimiter initialized: ceiling=%.1fdBFS, lookahead=%zu frames, "
+             "release=%.0fms, AGC %s",
+             config_.ceiling_db, lookahead_frames_, config_.release_ms,
+             agc_enabled_ ? "on" : "off");
+    return true;
+}
+
+void LookaheadLimiter::Reset() {
+    std::fill(delay_.begin(), delay_.end(), 0.0f);
+    deque_head_ = 0;
+    deque_size_ = 0;
+    frame_index_ = 0;
+    release_gain_ = 1.0f;
+    std::fill(average_ring_.begin(), average_ring_.end(), 1.0f);
+    average_pos_ = 0;
+    average_sum_ = static_cast<double>(window_);
+    agc_gain_ = 1.0f;
+    agc_energy_ = static_cast<double>(config_.agc_target_level) * config_.agc_target_level;
+    last_gain_.store(1.0f, std::memory_order_relaxed);
+    last_agc_gain_.store(1.0f, std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::Process(int16_t* samples, size_t num_samples) {
+    using Traits = detail::SampleTraits<int16_t>;
+    if (delay_.empty()) {
+        return;
+    }
+    const auto channels = static_cast<size_t>(channels_);
+    size_t num_frames = num_samples / channels;
+    while (num_frames > 0) {
+        const size_t frames = std::min(num_frames, kSubBlockFrames);
+        const size_t count = frames * channels;
+        for (size_t i = 0; i < count; ++i) {
+            int16_scratch_[i] = samples[i] / Traits::kFullScale;
+        }
+        ProcessSubBlock(int16_scratch_.data(), frames);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = Traits::Store(int16_scratch_[i] * Traits::kFullScale);
+        }
+        samples += count;
+        num_frames -= frames;
+    }
+}
+
+void LookaheadLimiter::Process(float* samples, size_t num_samples) {
+    if (delay_.empty()) {
+        return;
+    }
+    const auto channels = static_cast<size_t>(channels_);
+    size_t num_frames = num_samples / channels;
+    while (num_frames > 0) {
+        const size_t frames = std::min(num_frames, kSubBlockFrames);
+        ProcessSubBlock(samples, frames);
+        samples += frames * channels;
+        num_frames -= frames;
+    }
+}
+
+float LookaheadLimiter::GetGainReductionDb() const {
+    return LinearToDb(last_gain_.load(std::memory_order_relaxed));
+}
+
+float LookaheadLimiter::GetAgcGainDb() const {
+    return agc_enabled_ ? LinearToDb(last_agc_gain_.load(std::memory_order_relaxed)) : 0.0f;
+}
+
+void LookaheadLimiter::ProcessSubBlock(float* samples, size_t num_frames) {
+    const auto channels = static_cast<size_t>(channels_);
+    const size_t count = num_frames * channels;
+    if (agc_enabled_) {
+        ApplyAgc(samples, num_frames);
+    }
+
+    // The new input joins the delay line behind the frames still waiting
+    float* incoming = delay_.data() + lookahead_frames_ * channels;
+    std::memcpy(incoming, samples, count * sizeof(float));
+
+    if (channels == 1) {
+        AbsValues(incoming, num_frames, peaks_.data());
+    } else {
+        for (size_t i = 0; i < num_frames; ++i) {
+            float peak = 0.0f;
+            for (size_t ch = 0; ch < channels; ++ch) {
+                peak = std::max(peak, std::fabs(incoming[i * channels + ch]));
+            }
+            peaks_[i] = peak;
+        }
+    }
+    PeaksToGains(peaks_.data(), num_frames, ceiling_, gains_.data());
+    BuildEnvelope(num_frames);
+
+    // Output the oldest frames of the delay line under the envelope
+    if (channels == 1) {
+        MultiplyGains(delay_.data(), gains_.data(), num_frames, samples);
+    } else {
+        for (size_t i = 0; i < num_frames; ++i) {
+            for (size_t ch = 0; ch < channels; ++ch) {
+                samples[i * channels + ch] = delay_[i * channels + ch] * gains_[i];
+            }
+        }
+    }
+    std::memmove(delay_.data(), delay_.data() + count,
+                 lookahead_frames_ * channels * sizeof(float));
+    last_gain_.store(gains_[num_frames - 1], std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::ApplyAgc(float* samples, size_t num_frames) {
+    const size_t count = num_frames * static_cast<size_t>(channels_);
+    const double mean_square = SumSquares(samples, count) / static_cast<double>(count);
+    const double coeff = 1.0 - std::exp(-static_cast<double>(num_frames) / agc_window_frames_);
+    agc_energy_ += coeff * (mean_square - agc_energy_);
+
+    float target = agc_gain_;
+    const double rms = std::sqrt(agc_energy_);
+    if (rms > kAgcGateLevel) {
+        target = std::clamp(static_cast<float>(config_.agc_target_level / rms), agc_min_gain_,
+                            agc_max_gain_);
+    }
+
+    // Linear ramp to the new gain across the sub-block (no zipper noise)
+    const auto channels = static_cast<size_t>(channels_);
+    const float step = (target - agc_gain_) / static_cast<float>(num_frames);
+    for (size_t i = 0; i < num_frames; ++i) {
+        const float gain = agc_gain_ + step * static_cast<float>(i + 1);
+        for (size_t ch = 0; ch < channels; ++ch) {
+            samples[i * channels + ch] *= gain;
+        }
+    }
+    agc_gain_ = target;
+    last_agc_gain_.store(target, std::memory_order_relaxed);
+}
+
+void LookaheadLimiter::BuildEnvelope(size_t num_frames) {
+    // gains_[i] is the gain input frame n = frame_index_ + i needs; output frame
+    // i (input frame n - lookahead) gets the average of the released window
+    // minima over [n - lookahead, n], each of which covers that output frame,
+    // so the average never exceeds the gain it needs.
+    for (size_t i = 0; i < num_frames; ++i, ++frame_index_) {
+        const float required = gains_[i];
+
+        // Sliding-window minimum: expire the frame leaving the window (at most one per
+        // step, which keeps the deque within window_ entries), then drop larger gains
+        if (deque_size_ > 0 && deque_frame_[deque_head_] + window_ <= frame_index_) {
+            deque_head_ = (deque_head_ + 1) % window_;
+            --deque_size_;
+        }
+        while (deque_size_ > 0) {
+            const size_t back = (deque_head_ + deque_size_ - 1) % window_;
+            if (deque_gain_[back] < required) {
+                break;
+            }
+            --deque_size_;
+        }
+        const size_t slot = (deque_head_ + deque_size_) % window_;
+        deque_gain_[slot] = required;
+        deque_frame_[slot] = frame_index_;
+        ++deque_size_;
+        const float window_min = deque_gain_[deque_head_];
+
+        // Attack follows the minimum at once (the average smooths it); release recovers
+        release_gain_ = window_min < release_gain_
+                            ? window_min
+                            : release_gain_ + release_coeff_ * (window_min - release_gain_);
+
+        average_sum_ += static_cast<double>(release_gain_) - average_ring_[average_pos_];
+        average_ring_[average_pos_] = release_gain_;
+        if (++average_pos_ == window_) {
+            average_pos_ = 0;
+            // Recompute from the ring once per window so rounding cannot accumulate
+            average_sum_ = 0.0;
+            for (float gain : average_ring_) {
+                average_sum_ += gain;
+            }
+        }
+        gains_[i] =
+            std::min(static_cast<float>(average_sum_ / static_cast<double>(window_)), 1.0f);
+    }
+}
+
+}  // namespace ffvoice
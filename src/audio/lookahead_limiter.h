@@ -0,0 +1,160 @@
+/**
+ * @file lookahead_limiter.h
+ * @brief Lookahead peak limiter with optional automatic gain control
+ *
+ * VolumeNormalizer reacts to a peak only once it is being output, so a loud
+ * onset after quiet speech (gain already raised) is clipped by the int16
+ * clamp. LookaheadLimiter delays the audio by a few milliseconds and lowers
+ * the gain before the peak reaches the output, so nothing ever exceeds the
+ * ceiling and the clamps downstream never engage.
+ */
+
+#pragma once
+
+#include "audio/audio_processor.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief LookaheadLimiter configuration
+ */
+struct LookaheadLimiterConfig {
+    /// Highest output peak in dBFS (at most 0); no output sample exceeds it
+    float ceiling_db = -1.0f;
+
+    /// How far ahead peaks are seen, 0.1-50 ms; this is also the added latency
+    float lookahead_ms = 5.0f;
+
+    /// Time constant of the gain recovering after a peak
+    float release_ms = 100.0f;
+
+    /// Automatic gain control: RMS level (0-1) the input is driven towards
+    /// before limiting; 0 disables it
+    float agc_target_level = 0.0f;
+
+    /// AGC gain range in dB
+    float agc_min_gain_db = -20.0f;
+    float agc_max_gain_db = 20.0f;
+
+    /// Loudness averaging time of the AGC
+    float agc_window_ms = 400.0f;
+};
+
+/**
+ * @brief Peak limiter that looks ahead by a fixed delay
+ *
+ * The gain envelope is built in three steps per frame: the gain each input
+ * frame needs to stay under the ceiling, its minimum over the lookahead
+ * window (a sliding-window minimum over a monotonic deque, O(1) per frame),
+ * and a moving average of that minimum over the same window. The average
+ * ramps down smoothly while staying at or below every gain it covers. The
+ * audio is delayed by the window, so the gain has reached its lowest value
+ * by the time the peak leaves the delay line. Releasing is a one-pole
+ * recovery between the minimum and the average.
+ *
+ * Channels share one gain, so the stereo image does not shift. Work is done
+ * in sub-blocks. Frame peaks, required gains, AGC loudness and the gain
+ * multiply run as SSE2 / NEON loops over the whole sub-block; only the
+ * deque and the two averages are per-frame scalar code.
+ *
+ * The output lags the input by GetLatencyFrames() frames, reported through
+ * AudioProcessor::GetLatencyFrames() (and summed by the chains) so callers
+ * can shift timestamps or align an unprocessed path.
+ *
+ * @code
+ * LookaheadLimiterConfig cfg;
+ * cfg.agc_target_level = 0.2f;  // Level speech like VolumeNormalizer, without clipping
+ * LookaheadLimiter limiter(cfg);
+ * limiter.Initialize(48000, 1);
+ * limiter.Process(samples, num_samples);
+ * @endcode
+ */
+class LookaheadLimiter : public AudioProcessor {
+public:
+    /// Largest lookahead accepted by Initialize()
+    static constexpr float kMaxLookaheadMs = 50.0f;
+
+    LookaheadLimiter();
+    explicit LookaheadLimiter(const LookaheadLimiterConfig& config);
+
+    /**
+     * @return false if the configuration is out of range (ceiling above
+     *         0 dBFS, lookahead outside 0.1-50 ms, non-positive times, or an
+     *         AGC range that excludes 0 dB)
+     */
+    bool Initialize(int sample_rate, int channels) override;
+    void Process(int16_t* samples, size_t num_samples) override;
+    void Process(float* samples, size_t num_samples) override;
+    void Reset() override;
+    std::string GetName() const override {
+        return "LookaheadLimiter";
+    }
+
+    /// The lookahead delay in frames
+    size_t GetLatencyFrames() const override {
+        return lookahead_frames_;
+    }
+
+    const LookaheadLimiterConfig& GetConfig() const {
+        return config_;
+    }
+
+    /// Gain reduction on the most recent output frame in dB (0 or negative)
+    float GetGainReductionDb() const;
+
+    /// Current AGC gain in dB (0 when AGC is disabled)
+    float GetAgcGainDb() const;
+
+private:
+    /// Limit @p num_frames frames (at most kSubBlockFrames) at [-1, 1] scale in place
+    void ProcessSubBlock(float* samples, size_t num_frames);
+
+    /// Drive the sub-block towards agc_target_level, ramping the gain across it
+    void ApplyAgc(float* samples, size_t num_frames);
+
+    /// Turn the required gains_ of @p num_frames frames into the output envelope
+    void BuildEnvelope(size_t num_frames);
+
+    LookaheadLimiterConfig config_;
+    float ceiling_ = 1.0f;
+    size_t lookahead_frames_ = 0;
+    size_t window_ = 1;  ///< lookahead_frames_ + 1
+    float release_coeff_ = 0.0f;
+
+    // Delay line: lookahead_frames_ delayed frames followed by the current sub-block
+    std::vector<float> delay_;
+    std::vector<float> peaks_;  ///< Per frame of the sub-block
+    std::vector<float> gains_;  ///< Required gain, then the envelope, per frame
+
+    // Sliding-window minimum of the required gain (ring-buffer deque)
+    std::vector<float> deque_gain_;
+    std::vector<uint64_t> deque_frame_;
+    size_t deque_head_ = 0;
+    size_t deque_size_ = 0;
+    uint64_t frame_index_ = 0;
+
+    float release_gain_ = 1.0f;       ///< Released minimum (input to the average)
+    std::vector<float> average_ring_;  ///< Last window_ released gains
+    size_t average_pos_ = 0;
+    double average_sum_ = 0.0;
+
+    bool agc_enabled_ = false;
+    float agc_gain_ = 1.0f;
+    float agc_min_gain_ = 0.1f;
+    float agc_max_gain_ = 10.0f;
+    double agc_energy_ = 0.0;  ///< Smoothed mean square of the input
+    double agc_window_frames_ = 1.0;
+
+    std::atomic<float> last_gain_{1.0f};
+    std::atomic<float> last_agc_gain_{1.0f};
+
+    std::vector<float> int16_scratch_;  ///< int16 Process() sub-block at [-1, 1] scale
+};
+
+}  // namespace ffvoice
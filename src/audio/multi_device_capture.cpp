@@ -0,0 +1,466 @@
+/**
+ * @file multi_device_capture.cpp
+ * @brief MultiDeviceCapture implementation
+ */
+
+#include "audio/multi_device_capture.h"
+
+#include "utils/logger.h"
+#include "utils/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace ffvoice {
+
+namespace {
+
+/// Timestamps (and seconds they span) before a device's rate estimate is trusted
+constexpr uint64_t kMinFitStamps = 8;
+constexpr double kMinFitSeconds = 1.0;
+
+/// Queued timestamps per device (~1.3 s of 256-frame blocks at 48 kHz)
+constexpr size_t kStampCapacity = 256;
+
+int16_t ClampToInt16(float v) {
+    return static_cast<int16_t>(std::clamp(std::lrint(v), -32768L, 32767L));
+}
+
+/// Catmull-Rom interpolation between @p s1 and @p s2 at @p t in [0, 1)
+float Cubic(float s0, float s1, float s2, float s3, float t) {
+    return s1 + 0.5f * t *
+                    (s2 - s0 +
+                     t * (2.0f * s0 - 5.0f * s1 + 4.0f * s2 - s3 +
+                          t * (3.0f * (s1 - s2) + s3 - s0)));
+}
+
+}  // namespace
+
+void MultiDeviceCapture::ClockFit::Reset(double time, double frame) {
+    count = 1;
+    first_time = last_time = mean_time = time;
+    first_frame = mean_frame = frame;
+    co_time_frame = var_time = 0.0;
+}
+
+void MultiDeviceCapture::ClockFit::Add(double time, double frame) {
+    // Welford-style running co-moments: no cancellation on large stream times
+    ++count;
+    const double dt = time - mean_time;
+    mean_time += dt / static_cast<double>(count);
+    mean_frame += (frame - mean_frame) / static_cast<double>(count);
+    co_time_frame += dt * (frame - mean_frame);
+    var_time += dt * (time - mean_time);
+    last_time = time;
+}
+
+bool MultiDeviceCapture::ClockFit::IsValid() const {
+    return count >= kMinFitStamps && last_time - first_time >= kMinFitSeconds && var_time > 0.0;
+}
+
+double MultiDeviceCapture::ClockFit::Slope() const {
+    return co_time_frame / var_time;
+}
+
+double MultiDeviceCapture::ClockFit::FrameAt(double time) const {
+    return mean_frame + Slope() * (time - mean_time);
+}
+
+double MultiDeviceCapture::ClockFit::TimeAt(double frame) const {
+    return mean_time + (frame - mean_frame) / Slope();
+}
+
+MultiDeviceCapture::Lane::Lane(size_t ring_samples, size_t pending_samples)
+    : ring(ring_samples), stamps(kStampCapacity) {
+    pending.reserve(pending_samples);
+}
+
+MultiDeviceCapture::MultiDeviceCapture() : MultiDeviceCapture(MultiDeviceCaptureConfig{}) {
+}
+
+MultiDeviceCapture::MultiDeviceCapture(const MultiDeviceCaptureConfig& config)
+    : config_(config),
+      channels_(std::max(config.channels_per_device, 1)),
+      block_frames_(std::max<size_t>(config.block_frames, 1)),
+      max_step_error_(std::max(config.max_drift_ppm, 0.0) * 1e-6) {
+    if (config_.sample_rate <= 0) {
+        config_.sample_rate = 48000;
+    }
+    ResetLanes();
+}
+
+MultiDeviceCapture::~MultiDeviceCapture() {
+    Close();
+}
+
+void MultiDeviceCapture::ResetLanes() {
+    const size_t ring_frames =
+        std::max(static_cast<size_t>(std::max(config_.buffer_ms, 0)) *
+                     static_cast<size_t>(config_.sample_rate) / 1000,
+                 4 * block_frames_);
+    const size_t ch = static_cast<size_t>(channels_);
+
+    lanes_.clear();
+    for (size_t i = 0; i < config_.device_ids.size(); ++i) {
+        auto lane =
+            std::make_unique<Lane>(ring_frames * ch, (ring_frames + 2 * block_frames_) * ch);
+        lane->block.resize(block_frames_ * ch);
+        lanes_.push_back(std::move(lane));
+    }
+    interleaved_.assign(block_frames_ * ch * lanes_.size(), 0);
+    aligned_ = false;
+}
+
+bool MultiDeviceCapture::Open() {
+    if (!devices_.empty()) {
+        LOG_ERROR("MultiDeviceCapture: devices already open");
+        return false;
+    }
+    if (config_.device_ids.empty()) {
+        LOG_ERROR("MultiDeviceCapture: no devices configured");
+        return false;
+    }
+
+    for (int id : config_.device_ids) {
+        auto device = std::make_unique<AudioCaptureDevice>();
+        device->SetThreadPolicy(config_.capture_thread_policy);
+        if (!device->Open(id, config_.sample_rate, channels_, config_.frames_per_buffer,
+                          AudioFormat::INT16, config_.suggested_latency_ms)) {
+            LOG_ERROR("MultiDeviceCapture: failed to open device %d", id);
+            devices_.clear();  // Closes the ones already open
+            return false;
+        }
+        devices_.push_back(std::move(device));
+    }
+
+    LOG_INFO("MultiDeviceCapture: opened %zu devices (%d channels each)", devices_.size(),
+             channels_);
+    return true;
+}
+
+bool MultiDeviceCapture::Start(BlockCallback callback) {
+    if (devices_.empty()) {
+        LOG_ERROR("MultiDeviceCapture: not open");
+        return false;
+    }
+    if (running_.load(std::memory_order_acquire)) {
+        LOG_ERROR("MultiDeviceCapture: already capturing");
+        return false;
+    }
+    if (!callback) {
+        LOG_ERROR("MultiDeviceCapture: no block callback set");
+        return false;
+    }
+
+    ResetLanes();  // Nothing from a previous run may leak into the new alignment
+    callback_ = std::move(callback);
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        const bool started = devices_[i]->StartTimed(
+            [this, i](const int16_t* samples, size_t num_samples, double adc_time) {
+                PushDeviceAudio(i, samples, num_samples, adc_time);
+            });
+        if (!started) {
+            LOG_ERROR("MultiDeviceCapture: failed to start device %d", config_.device_ids[i]);
+            for (size_t j = 0; j < i; ++j) {
+                devices_[j]->Stop();
+            }
+            return false;
+        }
+    }
+
+    running_.store(true, std::memory_order_release);
+    aligner_ = std::thread(&MultiDeviceCapture::AlignLoop, this);
+    return true;
+}
+
+void MultiDeviceCapture::Stop() {
+    running_.store(false, std::memory_order_release);
+    for (auto& device : devices_) {
+        device->Stop();
+    }
+    if (!lanes_.empty()) {
+        lanes_[0]->ring.wake();  // Release the aligner parked on the reference ring
+    }
+    if (aligner_.joinable()) {
+        aligner_.join();
+    }
+}
+
+void MultiDeviceCapture::Close() {
+    Stop();
+    devices_.clear();
+}
+
+bool MultiDeviceCapture::PushDeviceAudio(size_t device, const int16_t* samples,
+                                         size_t num_samples, double adc_time) {
+    if (device >= lanes_.size() || samples == nullptr) {
+        return false;
+    }
+    Lane& lane = *lanes_[device];
+    const size_t frames = num_samples / static_cast<size_t>(channels_);
+    if (frames == 0) {
+        return true;
+    }
+    num_samples = frames * static_cast<size_t>(channels_);
+
+    // All or nothing, so every stamp maps to whole blocks of the ring
+    if (lane.ring.available_write() < num_samples) {
+        lane.dropped.fetch_add(num_samples, std::memory_order_relaxed);
+        lane.gap = true;
+        return false;
+    }
+    lane.ring.push_bulk(samples, num_samples);
+    if (lane.stamps.push(Stamp{adc_time, lane.pushed_frames, lane.gap})) {
+        lane.gap = false;  // Otherwise the next stamp carries the gap
+    }
+    lane.pushed_frames += frames;
+    return true;
+}
+
+void MultiDeviceCapture::DrainStamps(Lane& lane) {
+    Stamp stamp;
+    while (lane.stamps.pop(stamp)) {
+        const double frame = static_cast<double>(stamp.frame);
+        if (!lane.has_stamp || stamp.after_gap || lane.stalled) {
+            lane.fit.Reset(stamp.adc_time, frame);  // The old line no longer describes the ring
+            lane.has_stamp = true;
+            lane.stalled = false;
+        } else {
+            lane.fit.Add(stamp.adc_time, frame);
+        }
+    }
+}
+
+double MultiDeviceCapture::FrameAt(const Lane& lane, double time) const {
+    if (lane.fit.IsValid()) {
+        return lane.fit.FrameAt(time);
+    }
+    return lane.fit.first_frame + (time - lane.fit.first_time) * config_.sample_rate;
+}
+
+double MultiDeviceCapture::TimeAt(const Lane& lane, double frame) const {
+    if (lane.fit.IsValid()) {
+        return lane.fit.TimeAt(frame);
+    }
+    return lane.fit.first_time + (frame - lane.fit.first_frame) / config_.sample_rate;
+}
+
+void MultiDeviceCapture::AlignStart() {
+    // Output starts when the last device started; earlier devices skip their lead
+    double start_time = lanes_[0]->fit.first_time;
+    for (const auto& lane : lanes_) {
+        start_time = std::max(start_time, lane->fit.first_time);
+    }
+    for (auto& lane : lanes_) {
+        lane->read_pos = std::max(FrameAt(*lane, start_time), 0.0);
+    }
+    lanes_[0]->read_pos = std::round(lanes_[0]->read_pos);  // Reference stays sample-exact
+    aligned_ = true;
+}
+
+void MultiDeviceCapture::PlanBlock(Lane& lane, double block_time, const Lane& reference) {
+    const double rate = config_.sample_rate;
+    double ratio = 1.0;
+    if (lane.fit.IsValid() && reference.fit.IsValid()) {
+        ratio = lane.fit.Slope() / reference.fit.Slope();
+        lane.drift_ppm.store((ratio - 1.0) * 1e6, std::memory_order_relaxed);
+    }
+
+    const double desired = FrameAt(lane, block_time);
+    double error = desired - lane.read_pos;
+    const double resync_frames = std::max(static_cast<double>(block_frames_), rate / 50.0);
+    if (std::abs(ratio - 1.0) > max_step_error_ || std::abs(error) > resync_frames) {
+        // Too far off to pull in smoothly: jump (at most back to the oldest kept frame)
+        lane.read_pos = std::max(desired, static_cast<double>(lane.pending_base));
+        lane.resyncs.fetch_add(1, std::memory_order_relaxed);
+        ratio = std::clamp(ratio, 1.0 - max_step_error_, 1.0 + max_step_error_);
+        error = 0.0;
+    }
+
+    // Track the measured rate and close the remaining offset over about a second
+    lane.step = std::clamp(ratio + error / rate, 1.0 - 2.0 * max_step_error_,
+                           1.0 + 2.0 * max_step_error_);
+}
+
+uint64_t MultiDeviceCapture::InputEnd(const Lane& lane) const {
+    const double last = lane.read_pos + lane.step * static_cast<double>(block_frames_ - 1);
+    const bool exact = lane.step == 1.0 && lane.read_pos == std::floor(lane.read_pos);
+    return static_cast<uint64_t>(std::floor(last)) + (exact ? 1 : 3);  // 3: cubic lookahead
+}
+
+uint64_t MultiDeviceCapture::PoppedEnd(const Lane& lane) const {
+    return lane.pending_base + lane.pending.size() / static_cast<size_t>(channels_);
+}
+
+bool MultiDeviceCapture::HasInput(const Lane& lane) const {
+    const uint64_t end = InputEnd(lane);
+    const uint64_t popped = PoppedEnd(lane);
+    const size_t ch = static_cast<size_t>(channels_);
+    return end <= popped || lane.ring.available_read() / ch >= end - popped;
+}
+
+void MultiDeviceCapture::PopInput(Lane& lane) {
+    const size_t ch = static_cast<size_t>(channels_);
+    const uint64_t end = InputEnd(lane);
+    uint64_t popped = PoppedEnd(lane);
+
+    // Skip input wholly before the read position instead of buffering it
+    const double first_needed = std::floor(lane.read_pos) - 1.0;
+    if (first_needed > static_cast<double>(popped)) {
+        const auto skip = static_cast<uint64_t>(first_needed) - popped;
+        lane.ring.consume(lane.ring.peek_read(skip * ch).size());
+        lane.pending.clear();
+        lane.pending_base = popped = popped + skip;
+    }
+    if (end > popped) {
+        const size_t count = (end - popped) * ch;
+        const size_t old_size = lane.pending.size();
+        lane.pending.resize(old_size + count);
+        lane.ring.pop_bulk(lane.pending.data() + old_size, count);
+    }
+}
+
+void MultiDeviceCapture::Render(Lane& lane, size_t lane_index, bool silent) {
+    const size_t ch = static_cast<size_t>(channels_);
+    int16_t* out = lane.block.data();
+    const uint64_t frames_held = lane.pending.size() / ch;
+
+    if (silent) {
+        std::fill(lane.block.begin(), lane.block.end(), int16_t{0});
+    } else if (lane.step == 1.0 && lane.read_pos == std::floor(lane.read_pos)) {
+        const auto offset = static_cast<size_t>(lane.read_pos) - lane.pending_base;
+        std::copy_n(lane.pending.data() + offset * ch, block_frames_ * ch, out);
+    } else {
+        const auto sample = [&](int64_t frame, size_t c) {
+            const int64_t i = std::clamp<int64_t>(frame - static_cast<int64_t>(lane.pending_base),
+                                                  0, static_cast<int64_t>(frames_held) - 1);
+            return static_cast<float>(lane.pending[static_cast<size_t>(i) * ch + c]);
+        };
+        for (size_t j = 0; j < block_frames_; ++j) {
+            const double pos = lane.read_pos + lane.step * static_cast<double>(j);
+            const double whole = std::floor(pos);
+            const auto i = static_cast<int64_t>(whole);
+            const auto t = static_cast<float>(pos - whole);
+            for (size_t c = 0; c < ch; ++c) {
+                out[j * ch + c] = ClampToInt16(
+                    Cubic(sample(i - 1, c), sample(i, c), sample(i + 1, c), sample(i + 2, c), t));
+            }
+        }
+    }
+
+    const size_t total = ch * lanes_.size();
+    int16_t* dst = interleaved_.data() + lane_index * ch;
+    for (size_t j = 0; j < block_frames_; ++j) {
+        std::copy_n(out + j * ch, ch, dst + j * total);
+    }
+
+    // Advance, keeping one frame before the new position for the cubic kernel
+    lane.read_pos += lane.step * static_cast<double>(block_frames_);
+    const double keep_from = std::floor(lane.read_pos) - 1.0;
+    const auto drop = static_cast<size_t>(std::clamp(
+        keep_from - static_cast<double>(lane.pending_base), 0.0, static_cast<double>(frames_held)));
+    lane.pending.erase(lane.pending.begin(),
+                       lane.pending.begin() + static_cast<std::ptrdiff_t>(drop * ch));
+    lane.pending_base += drop;
+}
+
+bool MultiDeviceCapture::ReadBlock(MultiDeviceBlock& block) {
+    if (lanes_.empty()) {
+        return false;
+    }
+    for (auto& lane : lanes_) {
+        DrainStamps(*lane);
+    }
+    if (!aligned_) {
+        for (const auto& lane : lanes_) {
+            if (!lane->has_stamp) {
+                return false;  // Some device has not delivered its first block yet
+            }
+        }
+        AlignStart();
+    }
+
+    Lane& reference = *lanes_[0];
+    if (!HasInput(reference)) {
+        return false;
+    }
+    const double block_time = TimeAt(reference, reference.read_pos);
+    for (size_t i = 1; i < lanes_.size(); ++i) {
+        PlanBlock(*lanes_[i], block_time, reference);
+    }
+
+    // Wait for late devices, unless the reference has been waiting half its ring
+    const bool backlogged = reference.ring.available_read() >= reference.ring.capacity() / 2;
+    for (size_t i = 1; i < lanes_.size(); ++i) {
+        if (!HasInput(*lanes_[i]) && !backlogged) {
+            return false;
+        }
+    }
+
+    FFVOICE_TRACE_SCOPE("MultiDeviceCapture::ReadBlock");
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        Lane& lane = *lanes_[i];
+        const bool silent = !HasInput(lane);
+        if (silent) {
+            lane.underruns.fetch_add(1, std::memory_order_relaxed);
+            lane.stalled = true;  // Re-fit its clock when it delivers again
+        } else {
+            PopInput(lane);
+        }
+        Render(lane, i, silent);
+    }
+
+    block.devices.resize(lanes_.size());
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        block.devices[i] = lanes_[i]->block.data();
+    }
+    block.interleaved = interleaved_.data();
+    block.num_frames = block_frames_;
+    block.adc_time = block_time;
+    return true;
+}
+
+void MultiDeviceCapture::AlignLoop() {
+    FFVOICE_TRACE_THREAD_NAME("MultiDeviceCapture aligner");
+    ApplyThreadPolicy(config_.aligner_thread_policy, "MultiDeviceCapture aligner");
+
+    Lane& reference = *lanes_[0];
+    const size_t block_samples = block_frames_ * static_cast<size_t>(channels_);
+    MultiDeviceBlock block;
+    while (running_.load(std::memory_order_acquire)) {
+        if (ReadBlock(block)) {
+            callback_(block);
+            continue;
+        }
+        // Park on the reference clock; a device lagging behind it is polled in 1 ms steps
+        if (reference.ring.available_read() < block_samples) {
+            reference.ring.wait_for_data(block_samples);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+AudioCaptureDevice* MultiDeviceCapture::GetDevice(size_t device) const {
+    return device < devices_.size() ? devices_[device].get() : nullptr;
+}
+
+double MultiDeviceCapture::GetDriftPpm(size_t device) const {
+    return device < lanes_.size() ? lanes_[device]->drift_ppm.load(std::memory_order_relaxed)
+                                  : 0.0;
+}
+
+uint64_t MultiDeviceCapture::GetDroppedSamples(size_t device) const {
+    return device < lanes_.size() ? lanes_[device]->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t MultiDeviceCapture::GetUnderruns(size_t device) const {
+    return device < lanes_.size() ? lanes_[device]->underruns.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t MultiDeviceCapture::GetResyncs(size_t device) const {
+    return device < lanes_.size() ? lanes_[device]->resyncs.load(std::memory_order_relaxed) : 0;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,291 @@
+/**
+ * @file multi_device_capture.h
+ * @brief Clock-aligned capture from several input devices
+ *
+ * Opens N PortAudio input streams, timestamps every block with the capture
+ * time PortAudio reports, and resamples each device onto the clock of the
+ * first one so a room full of USB microphones yields one aligned stream.
+ * Each device callback only writes into its own lock-free ring; a single
+ * aligner assembles blocks, so the callbacks never share a lock or wait for
+ * each other.
+ *
+ * @code
+ * MultiDeviceCaptureConfig cfg;
+ * cfg.device_ids = {2, 5};
+ * MultiDeviceCapture capture(cfg);
+ * capture.Open();
+ * capture.Start([&](MultiDeviceBlock& block) {
+ *     // Per-device blocks line up with mixer tracks...
+ *     mixer.MixBlock({{track0, block.devices[0]}, {track1, block.devices[1]}}, out.data(),
+ *                    block.num_frames * mixer.GetChannels());
+ *     // ...or denoise all channels at once (rnnoise initialized with GetTotalChannels())
+ *     rnnoise.Process(block.interleaved, block.num_frames * capture.GetTotalChannels());
+ * });
+ * @endcode
+ */
+
+#pragma once
+
+#include "audio/audio_capture_device.h"
+#include "utils/ring_buffer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Configuration for MultiDeviceCapture.
+ */
+struct MultiDeviceCaptureConfig {
+    /// PortAudio device ids; the first one is the clock reference
+    std::vector<int> device_ids;
+
+    int sample_rate = 48000;
+    int channels_per_device = 1;
+
+    /// Passed to AudioCaptureDevice::Open() for every device
+    int frames_per_buffer = 256;
+    double suggested_latency_ms = 0.0;
+
+    /// Frames per aligned block (10 ms at 48 kHz, one RNNoise frame)
+    size_t block_frames = 480;
+
+    /// Per-device ring in ms; bounds the start-up skew and how long the aligner may stall
+    int buffer_ms = 200;
+
+    /// Largest clock drift corrected by resampling; beyond it the device is resynchronized
+    double max_drift_ppm = 1000.0;
+
+    /// Applied to every device's callback thread (see AudioCaptureDevice::SetThreadPolicy())
+    ThreadPolicy capture_thread_policy;
+
+    /// Priority and cores of the aligner thread
+    ThreadPolicy aligner_thread_policy;
+};
+
+/**
+ * @brief One aligned block, valid only during the block callback or until the next ReadBlock()
+ */
+struct MultiDeviceBlock {
+    /// num_frames * GetTotalChannels() samples: device 0's channels, then device 1's, ...
+    /// Writable so a processor can work on it in place.
+    int16_t* interleaved = nullptr;
+
+    /// Per device, num_frames * channels_per_device interleaved samples
+    std::vector<const int16_t*> devices;
+
+    size_t num_frames = 0;
+
+    /// Capture time of the first frame on the reference device's stream clock (s)
+    double adc_time = 0.0;
+};
+
+/**
+ * @brief Captures several devices and delivers them as one clock-aligned stream.
+ *
+ * Alignment: the capture timestamps of each device are fitted with a line
+ * (frames against stream time). The first timestamps set the start offset,
+ * so every device begins at the moment the last one started; the slopes give
+ * each device's true rate relative to the reference; and each block a small
+ * correction pulls the read position back onto the fitted line. Non-reference
+ * devices are resampled by cubic interpolation at that ratio, so their blocks
+ * keep pace with the reference without clicks. The reference device passes
+ * through bit-exact. This assumes the streams share one clock, which holds
+ * for streams of the same host API (ALSA, Core Audio, WASAPI) on one machine.
+ *
+ * A device whose drift exceeds max_drift_ppm, that drops samples, or that
+ * stops delivering is resynchronized (its position jumps to the fitted line)
+ * and the event is counted; a device that falls silent contributes silence.
+ *
+ * Threading: PushDeviceAudio() for device d is called only by device d's
+ * callback (one producer per device); ReadBlock() is called only by the
+ * aligner thread started by Start(), or by the caller's thread when used
+ * without Start().
+ */
+class MultiDeviceCapture {
+public:
+    using BlockCallback = std::function<void(MultiDeviceBlock& block)>;
+
+    MultiDeviceCapture();
+    explicit MultiDeviceCapture(const MultiDeviceCaptureConfig& config);
+    ~MultiDeviceCapture();
+
+    MultiDeviceCapture(const MultiDeviceCapture&) = delete;
+    MultiDeviceCapture& operator=(const MultiDeviceCapture&) = delete;
+
+    /**
+     * @brief Open every configured device (AudioCaptureDevice::Initialize() first)
+     * @return false if any device fails to open; none is left open then
+     */
+    bool Open();
+
+    /**
+     * @brief Start all devices and an aligner thread that delivers blocks to @p callback
+     * @return false if not open, already running or @p callback is empty
+     */
+    bool Start(BlockCallback callback);
+
+    /// Stop the devices and the aligner thread (blocks still buffered are discarded)
+    void Stop();
+
+    /// Stop() and close every device
+    void Close();
+
+    bool IsCapturing() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Enqueue one captured block of device @p device (real-time safe)
+     *
+     * Called by the device callbacks; public so other timestamped sources can
+     * be aligned too. A block that does not fit the device's ring is dropped
+     * whole and counted.
+     *
+     * @param adc_time Capture time of the first frame, on the shared stream clock
+     * @return false if @p device is out of range or the block was dropped
+     */
+    bool PushDeviceAudio(size_t device, const int16_t* samples, size_t num_samples,
+                         double adc_time);
+
+    /**
+     * @brief Assemble the next aligned block if every device has delivered enough audio
+     *
+     * Non-blocking. Pointers in @p block stay valid until the next call.
+     *
+     * @return true if @p block was filled
+     */
+    bool ReadBlock(MultiDeviceBlock& block);
+
+    size_t GetNumDevices() const {
+        return lanes_.size();
+    }
+
+    /// Channels of MultiDeviceBlock::interleaved (devices * channels_per_device)
+    int GetTotalChannels() const {
+        return static_cast<int>(lanes_.size()) * channels_;
+    }
+
+    size_t GetBlockFrames() const {
+        return block_frames_;
+    }
+
+    /// Device @p device (nullptr before Open() or if out of range)
+    AudioCaptureDevice* GetDevice(size_t device) const;
+
+    /// Estimated clock drift of @p device against the reference in ppm (0 until measured)
+    double GetDriftPpm(size_t device) const;
+
+    /// Samples of @p device dropped because its ring was full
+    uint64_t GetDroppedSamples(size_t device) const;
+
+    /// Blocks in which @p device had no audio and contributed silence
+    uint64_t GetUnderruns(size_t device) const;
+
+    /// Times @p device was snapped back onto the reference clock
+    uint64_t GetResyncs(size_t device) const;
+
+private:
+    /// Incremental least-squares line through (stream time, frame index) pairs
+    struct ClockFit {
+        uint64_t count = 0;
+        double first_time = 0.0;
+        double first_frame = 0.0;
+        double last_time = 0.0;
+        double mean_time = 0.0;
+        double mean_frame = 0.0;
+        double co_time_frame = 0.0;
+        double var_time = 0.0;
+
+        void Reset(double time, double frame);
+        void Add(double time, double frame);
+        bool IsValid() const;
+        double Slope() const;                 ///< Frames per second
+        double FrameAt(double time) const;    ///< Frame index at @p time
+        double TimeAt(double frame) const;    ///< Stream time of @p frame
+    };
+
+    /// Capture time of the block starting at ring frame @p frame
+    struct Stamp {
+        double adc_time = 0.0;
+        uint64_t frame = 0;
+        bool after_gap = false;  ///< Samples were dropped just before this block
+    };
+
+    struct Lane {
+        Lane(size_t ring_samples, size_t pending_samples);
+
+        // Producer (device callback) side
+        RingBuffer<int16_t> ring;
+        RingBuffer<Stamp> stamps;
+        uint64_t pushed_frames = 0;
+        bool gap = false;
+        std::atomic<uint64_t> dropped{0};
+
+        // Aligner side
+        ClockFit fit;
+        bool has_stamp = false;
+        bool stalled = false;  ///< Went silent; its next stamp restarts the fit
+        std::vector<int16_t> pending;  ///< Popped input, frames from pending_base on
+        uint64_t pending_base = 0;
+        double read_pos = 0.0;  ///< Absolute frame index of the next output frame
+        double step = 1.0;      ///< Input frames per output frame for the current block
+        std::vector<int16_t> block;
+        std::atomic<double> drift_ppm{0.0};
+        std::atomic<uint64_t> underruns{0};
+        std::atomic<uint64_t> resyncs{0};
+    };
+
+    /// Recreate the per-device rings and alignment state (devices stopped)
+    void ResetLanes();
+
+    void DrainStamps(Lane& lane);
+
+    /// Ring frame captured at stream time @p time (nominal rate until the fit is valid)
+    double FrameAt(const Lane& lane, double time) const;
+    double TimeAt(const Lane& lane, double frame) const;
+
+    /// Align every lane's read position to the moment the last device started
+    void AlignStart();
+
+    /// Set @p lane's step (and resync it if needed) for the block starting at @p block_time
+    void PlanBlock(Lane& lane, double block_time, const Lane& reference);
+
+    /// One past the last ring frame the next block of @p lane reads
+    uint64_t InputEnd(const Lane& lane) const;
+
+    /// Ring frames moved into pending so far
+    uint64_t PoppedEnd(const Lane& lane) const;
+
+    /// True if the ring holds everything the next block of @p lane needs
+    bool HasInput(const Lane& lane) const;
+
+    void PopInput(Lane& lane);
+
+    /// Resample the next block of @p lane into its block and interleaved_
+    void Render(Lane& lane, size_t lane_index, bool silent);
+
+    void AlignLoop();
+
+    MultiDeviceCaptureConfig config_;
+    int channels_ = 1;
+    size_t block_frames_ = 480;
+    double max_step_error_ = 0.001;  ///< max_drift_ppm as a fraction
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<std::unique_ptr<AudioCaptureDevice>> devices_;
+    std::vector<int16_t> interleaved_;
+    bool aligned_ = false;
+
+    BlockCallback callback_;
+    std::thread aligner_;
+    std::atomic<bool> running_{false};
+};
+
+}  // namespace ffvoice
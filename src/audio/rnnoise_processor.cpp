@@ -19,13 +19,8 @@ RNNoiseProcessor::RNNoiseProcessor(const RNNoiseConfig& config) : config_(config
 
 RNNoiseProcessor::~RNNoiseProcessor() {
 #ifdef ENABLE_RNNOISE
-    // Clean up RNNoise states
-    for (auto* state : states_) {
-        if (state) {
-            rnnoise_destroy(state);
-        }
-    }
-    states_.clear();
+    StopWorkers();
+    DestroyStates();
 #endif
     LOG_INFO("RNNoiseProcessor destroyed");
 }
@@ -42,12 +37,18 @@ bool RNNoiseProcessor::Initialize(int sample_rate, int channels) {
         return false;
     }
 
+    // Re-initialization: release the previous pool and states first
+    StopWorkers();
+    DestroyStates();
+
     // RNNoise frame size: 480 samples (10ms @48kHz)
     frame_size_ = 480;
 
-    // Initialize rebuffer for frame accumulation (256 -> 480)
-    rebuffer_.resize(frame_size_ * channels_, 0.0f);
-    rebuffer_pos_ = 0;
+    // Per-channel frame buffers and the interleaved output frame (256 -> 480)
+    channel_frames_.assign(frame_size_ * channels_, 0.0f);
+    output_frame_.assign(frame_size_ * channels_, 0.0f);
+    frame_pos_ = 0;
+    delayed_ = false;
 
     // Create RNNoise state for each channel
     states_.resize(channels_);
@@ -58,9 +59,20 @@ bool RNNoiseProcessor::Initialize(int sample_rate, int channels) {
             return false;
         }
     }
+    vad_probs_.assign(channels_, 0.0f);
+    frame_vad_probs_.clear();
+    frame_vad_probs_.reserve(100);  // one second of frames; longer blocks grow it
 
-    LOG_INFO("RNNoiseProcessor initialized: %d Hz, %d channel(s), frame=%zu samples%s", sample_rate,
-             channels, frame_size_, config_.enable_vad ? ", VAD enabled (experimental)" : "");
+    const size_t num_lanes =
+        static_cast<size_t>(std::clamp(config_.num_threads, 1, std::max(channels_, 1)));
+    if (num_lanes > 1) {
+        StartWorkers(num_lanes);
+    }
+
+    LOG_INFO("RNNoiseProcessor initialized: %d Hz, %d channel(s), frame=%zu samples, "
+             "%zu thread(s)%s",
+             sample_rate, channels, frame_size_, num_lanes_,
+             config_.enable_vad ? ", VAD enabled (experimental)" : "");
 #else
     // Passthrough mode when RNNoise is not enabled
     LOG_INFO(
@@ -74,59 +86,87 @@ bool RNNoiseProcessor::Initialize(int sample_rate, int channels) {
 }
 
 void RNNoiseProcessor::Process(int16_t* samples, size_t num_samples) {
+    ProcessSamples(samples, num_samples);
+}
+
+void RNNoiseProcessor::Process(float* samples, size_t num_samples) {
+    ProcessSamples(samples, num_samples);
+}
+
+namespace {
+
+// RNNoise works on floats at 16-bit scale: int16 is a plain widening, float
+// samples in [-1, 1] are scaled like AudioConverter's int16 <-> float kernels
+inline float LoadSample(int16_t sample) {
+    return static_cast<float>(sample);
+}
+
+inline float LoadSample(float sample) {
+    return sample * 32768.0f;
+}
+
+inline void StoreSample(float value, int16_t& sample) {
+    sample = static_cast<int16_t>(value);
+}
+
+inline void StoreSample(float value, float& sample) {
+    sample = value * (1.0f / 32768.0f);
+}
+
+}  // namespace
+
+template <typename Sample>
+void RNNoiseProcessor::ProcessSamples(Sample* samples, size_t num_samples) {
+    frame_vad_probs_.clear();
+    frame_vad_offset_ = 0;
     if (num_samples == 0)
         return;
 
 #ifdef ENABLE_RNNOISE
-    // Convert int16_t -> float (resize only if needed to avoid reallocations)
-    if (float_buffer_.size() < num_samples) {
-        float_buffer_.resize(num_samples);
-    }
-    for (size_t i = 0; i < num_samples; ++i) {
-        float_buffer_[i] = samples[i] / 32768.0f;  // Normalize to [-1, 1]
+    const size_t channels = static_cast<size_t>(channels_);
+    // Delayed: the first frame to complete started frame_pos_ frames before
+    // this block, and its output comes one frame after that. A switch to the
+    // delayed path happens on the last partial frame, so every frame
+    // completed in one call shares the same path.
+    if (delayed_) {
+        frame_vad_offset_ = (frame_size_ - frame_pos_) * channels;
     }
+    size_t frames_left = num_samples / channels;
+    Sample* block = samples;
 
-    // Frame rebuffering (256 -> 480)
-    size_t input_pos = 0;
-    while (input_pos < num_samples) {
-        // Copy samples to rebuffer
-        // Check for potential overflow in frame_size_ * channels_
-        size_t frame_total_size = frame_size_ * channels_;
-        if (frame_size_ > 0 && frame_total_size / frame_size_ != static_cast<size_t>(channels_)) {
-            LOG_ERROR(
-                "RNNoiseProcessor: Buffer size overflow detected (frame_size=%zu, channels=%d)",
-                frame_size_, channels_);
-            return;
-        }
+    while (frames_left > 0) {
+        const size_t to_copy = std::min(frame_size_ - frame_pos_, frames_left);
+        const size_t offset = frame_pos_ * channels;
 
-        size_t remaining_in_rebuffer = frame_total_size - rebuffer_pos_;
-        size_t remaining_in_input = num_samples - input_pos;
-        size_t to_copy = std::min(remaining_in_rebuffer, remaining_in_input);
-        std::copy(float_buffer_.begin() + input_pos, float_buffer_.begin() + input_pos + to_copy,
-                  rebuffer_.begin() + rebuffer_pos_);
-        rebuffer_pos_ += to_copy;
-        input_pos += to_copy;
-
-        // Process complete frame
-        if (rebuffer_pos_ >= frame_total_size) {
-            ProcessFrame(rebuffer_.data(), frame_size_);
-
-            // Copy processed data back to float_buffer
-            size_t output_start = input_pos - to_copy;
-            for (size_t i = 0; i < frame_total_size; ++i) {
-                if (output_start + i < num_samples) {
-                    float_buffer_[output_start + i] = rebuffer_[i];
-                }
+        if (!delayed_ && to_copy == frame_size_) {
+            // Whole frame at a frame boundary: denoise straight back into the block
+            Deinterleave(block, frame_size_);
+            ProcessFrame();
+        } else {
+            // Partial frame: from now on return the previous frame's output,
+            // starting with one frame of silence
+            if (!delayed_) {
+                delayed_ = true;
+                std::fill(output_frame_.begin(), output_frame_.end(), 0.0f);
             }
+            Deinterleave(block, to_copy);
+        }
 
-            rebuffer_pos_ = 0;
+        // Aligned: this frame's output; delayed: the matching part of the last one
+        for (size_t i = 0; i < to_copy * channels; ++i) {
+            StoreSample(output_frame_[offset + i], block[i]);
         }
-    }
 
-    // Convert float -> int16_t
-    for (size_t i = 0; i < num_samples; ++i) {
-        float clamped = std::clamp(float_buffer_[i], -1.0f, 1.0f);
-        samples[i] = static_cast<int16_t>(clamped * 32767.0f);
+        if (delayed_) {
+            frame_pos_ += to_copy;
+            if (frame_pos_ == frame_size_) {
+                ProcessFrame();
+                frame_pos_ = 0;
+            }
+        }
+
+        block += to_copy * channels;
+        frames_left -= to_copy;
     }
 #else
     // Passthrough mode: do nothing
@@ -135,52 +175,137 @@ void RNNoiseProcessor::Process(int16_t* samples, size_t num_samples) {
 #endif
 }
 
-void RNNoiseProcessor::ProcessFrame(float* frame, size_t frame_size) {
+template <typename Sample>
+void RNNoiseProcessor::Deinterleave(const Sample* input, size_t frames) {
+    const size_t channels = static_cast<size_t>(channels_);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        float* dst = channel_frames_.data() + ch * frame_size_ + frame_pos_;
+        const Sample* src = input + ch;
+        for (size_t i = 0; i < frames; ++i) {
+            dst[i] = LoadSample(src[i * channels]);
+        }
+    }
+}
+
+void RNNoiseProcessor::ProcessFrame() {
 #ifdef ENABLE_RNNOISE
-    // Process each channel independently
-    float total_vad_prob = 0.0f;
-    for (int ch = 0; ch < channels_; ++ch) {
-        // Extract channel data (deinterleave)
-        std::vector<float> channel_data(frame_size);
-        for (size_t i = 0; i < frame_size; ++i) {
-            channel_data[i] = frame[i * channels_ + ch];
+    if (workers_.empty()) {
+        DenoiseChannels(0);
+    } else {
+        // Release the workers' share of the frame, do ours, then wait at the barrier
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            workers_busy_ = workers_.size();
+            ++frame_seq_;
         }
+        frame_ready_.notify_all();
 
-        // Apply RNNoise denoising (in-place)
-        // rnnoise_process_frame returns VAD probability (0.0-1.0)
-        float vad_prob =
-            rnnoise_process_frame(states_[ch], channel_data.data(), channel_data.data());
-        total_vad_prob += vad_prob;
+        DenoiseChannels(0);
 
-        // Write back to interleaved buffer
-        for (size_t i = 0; i < frame_size; ++i) {
-            frame[i * channels_ + ch] = channel_data[i];
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+        frame_done_.wait(lock, [this] { return workers_busy_ == 0; });
+    }
+
+    // Clamp and interleave; VAD is summed in channel order in every mode
+    const size_t channels = static_cast<size_t>(channels_);
+    float total_vad_prob = 0.0f;
+    for (size_t ch = 0; ch < channels; ++ch) {
+        const float* channel_data = channel_frames_.data() + ch * frame_size_;
+        for (size_t i = 0; i < frame_size_; ++i) {
+            output_frame_[i * channels + ch] =
+                std::clamp(channel_data[i], static_cast<float>(std::numeric_limits<int16_t>::min()),
+                           static_cast<float>(std::numeric_limits<int16_t>::max()));
         }
+        total_vad_prob += vad_probs_[ch];
     }
 
     // Average VAD probability across channels (for stereo)
     if (config_.enable_vad) {
         last_vad_prob_ = total_vad_prob / channels_;
+        frame_vad_probs_.push_back(last_vad_prob_);
     }
-#else
-    (void)frame;
-    (void)frame_size;
 #endif
 }
 
-void RNNoiseProcessor::Reset() {
-    rebuffer_pos_ = 0;
-    last_vad_prob_ = 0.0f;
-    std::fill(rebuffer_.begin(), rebuffer_.end(), 0.0f);
-
 #ifdef ENABLE_RNNOISE
-    // Destroy and recreate RNNoise states
+void RNNoiseProcessor::DenoiseChannels(size_t lane) {
+    // Channels are dealt out round-robin, so each lane's share is fixed
+    for (size_t ch = lane; ch < static_cast<size_t>(channels_); ch += num_lanes_) {
+        float* channel_data = channel_frames_.data() + ch * frame_size_;
+
+        // Apply RNNoise denoising (in-place)
+        // rnnoise_process_frame returns VAD probability (0.0-1.0)
+        vad_probs_[ch] = rnnoise_process_frame(states_[ch], channel_data, channel_data);
+    }
+}
+
+void RNNoiseProcessor::StartWorkers(size_t num_lanes) {
+    num_lanes_ = num_lanes;
+    stop_workers_ = false;
+    // Read before launching so no worker can miss the first frame
+    const uint64_t start_seq = frame_seq_;
+    workers_.reserve(num_lanes - 1);
+    for (size_t lane = 1; lane < num_lanes; ++lane) {
+        workers_.emplace_back(&RNNoiseProcessor::WorkerLoop, this, lane, start_seq);
+    }
+}
+
+void RNNoiseProcessor::StopWorkers() {
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            stop_workers_ = true;
+        }
+        frame_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+    num_lanes_ = 1;
+}
+
+void RNNoiseProcessor::WorkerLoop(size_t lane, uint64_t seen) {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    while (true) {
+        frame_ready_.wait(lock, [&] { return frame_seq_ != seen || stop_workers_; });
+        if (stop_workers_) {
+            return;
+        }
+        seen = frame_seq_;
+
+        lock.unlock();
+        DenoiseChannels(lane);
+        lock.lock();
+
+        if (--workers_busy_ == 0) {
+            frame_done_.notify_one();
+        }
+    }
+}
+
+void RNNoiseProcessor::DestroyStates() {
     for (auto* state : states_) {
         if (state) {
             rnnoise_destroy(state);
         }
     }
     states_.clear();
+}
+#endif
+
+void RNNoiseProcessor::Reset() {
+    frame_pos_ = 0;
+    delayed_ = false;
+    last_vad_prob_ = 0.0f;
+    frame_vad_probs_.clear();
+    frame_vad_offset_ = 0;
+    std::fill(channel_frames_.begin(), channel_frames_.end(), 0.0f);
+    std::fill(output_frame_.begin(), output_frame_.end(), 0.0f);
+
+#ifdef ENABLE_RNNOISE
+    // Destroy and recreate RNNoise states (workers are idle between frames)
+    DestroyStates();
 
     // Recreate states
     states_.resize(channels_);
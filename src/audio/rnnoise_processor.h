@@ -7,7 +7,11 @@
 
 #include "audio/audio_processor.h"
 
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #ifdef ENABLE_RNNOISE
@@ -23,6 +27,16 @@ namespace ffvoice {
  */
 struct RNNoiseConfig {
     bool enable_vad = false;  ///< Voice activity detection (experimental)
+
+    /**
+     * @brief Threads that denoise the channels of a frame in parallel
+     *
+     * 0 or 1 runs every channel on the calling thread. Larger values start
+     * num_threads - 1 persistent workers (at most one thread per channel); the
+     * calling thread denoises its own share and waits at a per-frame barrier,
+     * so output and latency match serial mode exactly.
+     */
+    int num_threads = 1;
 };
 
 /**
@@ -32,9 +46,15 @@ struct RNNoiseConfig {
  * - Deep learning based (RNN)
  * - Low CPU overhead (~5-10%)
  * - Excellent noise reduction for speech
- * - Supports stereo + mono
+ * - Supports mono, stereo and multichannel arrays (optionally in parallel,
+ *   see RNNoiseConfig::num_threads)
  *
- * Note: Requires float conversion and frame rebuffering (256 -> 480 samples)
+ * Audio is denoised in 480-sample (10 ms @48kHz) frames. While every Process()
+ * call is a whole number of frames the block is denoised in place with no added
+ * latency. Once a call ends mid-frame (e.g. 256-sample capture blocks) the
+ * processor switches to a fixed one-frame delay: each block returns the
+ * denoised samples of the frame before. No allocation happens after Initialize()
+ * (except once, if a block longer than a second is processed with VAD enabled).
  */
 class RNNoiseProcessor : public AudioProcessor {
 public:
@@ -64,6 +84,13 @@ public:
      */
     void Process(int16_t* samples, size_t num_samples) override;
 
+    /**
+     * @brief Process float samples in-place (same framing and delay as int16)
+     * @param samples Audio samples (float interleaved, [-1, 1])
+     * @param num_samples Number of samples (not frames!)
+     */
+    void Process(float* samples, size_t num_samples) override;
+
     /**
      * @brief Reset processor state
      */
@@ -76,6 +103,11 @@ public:
         return "RNNoiseProcessor";
     }
 
+    /// One frame once a block ended mid-frame (see the class comment), else 0
+    size_t GetLatencyFrames() const override {
+        return delayed_ ? frame_size_ : 0;
+    }
+
     /**
      * @brief Get the last VAD probability (0.0 = silence, 1.0 = speech)
      *
@@ -88,31 +120,86 @@ public:
         return last_vad_prob_;
     }
 
-private:
     /**
-     * @brief Process a single frame (480 samples)
-     * @param frame Frame buffer (float, interleaved)
-     * @param frame_size Frame size in samples per channel
+     * @brief VAD probability of every frame completed by the last Process() call
+     *
+     * One value per 10 ms frame, in order, averaged across channels; empty when
+     * VAD is disabled. On the zero-latency path (blocks of whole frames) entry
+     * i describes frames [i * 480, (i + 1) * 480) of that block, so it can
+     * travel with the block, e.g. into LiveCaptioner::FeedAudio(). With
+     * the one-frame delay the values describe input the output has not
+     * reached yet; GetFrameVADOffset() says where in the output they land.
+     */
+    const std::vector<float>& GetFrameVADProbabilities() const {
+        return frame_vad_probs_;
+    }
+
+    /**
+     * @brief Where the first of GetFrameVADProbabilities() lands in the output
+     *
+     * Offset in samples (all channels) from the start of the last Process()
+     * block to the output audio the first probability describes; entry i
+     * lands i frames later. 0 on the zero-latency path. With the one-frame
+     * delay it is one frame past where that frame's input started, so it can
+     * point past the end of the block, into the audio the next call returns.
      */
-    void ProcessFrame(float* frame, size_t frame_size);
+    size_t GetFrameVADOffset() const {
+        return frame_vad_offset_;
+    }
+
+private:
+    /// Frame rebuffering shared by the int16 and float Process()
+    template <typename Sample>
+    void ProcessSamples(Sample* samples, size_t num_samples);
+
+    /// Denoise the frame held in channel_frames_ into output_frame_
+    void ProcessFrame();
+
+    /// Split @p frames interleaved frames into channel_frames_ starting at frame_pos_
+    template <typename Sample>
+    void Deinterleave(const Sample* input, size_t frames);
 
     RNNoiseConfig config_;  ///< Configuration
 
 #ifdef ENABLE_RNNOISE
+    /// Denoise channels lane, lane + num_lanes_, ... of channel_frames_ in place
+    void DenoiseChannels(size_t lane);
+
+    /// Parallel fan-out: launch num_lanes - 1 workers / join them
+    void StartWorkers(size_t num_lanes);
+    void StopWorkers();
+    void WorkerLoop(size_t lane, uint64_t seen);
+
+    void DestroyStates();
+
     // RNNoise states (one per channel)
     std::vector<DenoiseState*> states_;
+    std::vector<float> vad_probs_;  ///< Per-channel VAD of the current frame
+
+    // Per-frame barrier: the caller bumps frame_seq_, each worker decrements
+    // workers_busy_ when its channels are done. The mutex only guards the
+    // counters; denoising runs unlocked.
+    std::vector<std::thread> workers_;
+    size_t num_lanes_ = 1;  ///< Threads sharing each frame (workers + caller)
+    std::mutex pool_mutex_;
+    std::condition_variable frame_ready_;  ///< Caller -> workers: frame_seq_ changed
+    std::condition_variable frame_done_;   ///< Last worker -> caller: workers_busy_ is 0
+    uint64_t frame_seq_ = 0;
+    size_t workers_busy_ = 0;
+    bool stop_workers_ = false;
 #endif
 
-    // Format conversion buffers
-    std::vector<float> float_buffer_;  ///< int16 -> float conversion
-
-    // Frame rebuffering (256 -> 480)
-    std::vector<float> rebuffer_;  ///< Accumulation buffer
-    size_t rebuffer_pos_ = 0;      ///< Current position in rebuffer
-    size_t frame_size_ = 0;        ///< 480 samples @48kHz (10ms)
+    // Frame rebuffering (sized in Initialize(), never reallocated)
+    std::vector<float> channel_frames_;  ///< Current frame, frame_size_ samples per channel
+    std::vector<float> output_frame_;    ///< Last denoised frame, interleaved, 16-bit scale
+    size_t frame_pos_ = 0;               ///< Frames accumulated in channel_frames_
+    size_t frame_size_ = 0;              ///< 480 samples @48kHz (10ms)
+    bool delayed_ = false;               ///< Output lags input by one frame
 
     // VAD state
-    float last_vad_prob_ = 0.0f;  ///< Last VAD probability (0.0-1.0)
+    float last_vad_prob_ = 0.0f;          ///< Last VAD probability (0.0-1.0)
+    std::vector<float> frame_vad_probs_;  ///< Per-frame VAD of the last Process() call
+    size_t frame_vad_offset_ = 0;         ///< Output offset of frame_vad_probs_[0]
 };
 
 }  // namespace ffvoice
@@ -0,0 +1,472 @@
+/**
+ * @file transcription_cache.cpp
+ * @brief TranscriptionCache implementation
+ */
+
+#include "audio/transcription_cache.h"
+
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace ffvoice {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr const char* kEntryExtension = ".ffvc";
+constexpr char kMagic[4] = {'F', 'F', 'V', 'C'};
+constexpr uint32_t kFormatVersion = 2;
+
+// On-disk layout: FileHeader, segment records, word records, speaker records,
+// then the UTF-8 text: the detected language first, followed by every segment
+// and word. Numbers are in host byte
+// order; a file from a host of the other order fails the version check and
+// is treated as a miss.
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t segment_count;
+    uint32_t word_count;
+    uint32_t speaker_count;
+    uint32_t text_bytes;
+    uint32_t language_size;  ///< Detected language at the start of the text
+};
+
+struct SegmentRecord {
+    int64_t start_ms;
+    int64_t end_ms;
+    float confidence;
+    int32_t speaker_id;
+    uint32_t text_offset;
+    uint32_t text_size;
+    uint32_t first_word;
+    uint32_t word_count;
+};
+
+struct WordRecord {
+    int64_t start_ms;
+    int64_t end_ms;
+    float probability;
+    int32_t speaker_id;
+    uint32_t text_offset;
+    uint32_t text_size;
+};
+
+struct SpeakerRecord {
+    int64_t start_ms;
+    int64_t end_ms;
+    int32_t speaker_id;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 28, "FileHeader must not be padded");
+static_assert(sizeof(SegmentRecord) == 40, "SegmentRecord must not be padded");
+static_assert(sizeof(WordRecord) == 32, "WordRecord must not be padded");
+static_assert(sizeof(SpeakerRecord) == 24, "SpeakerRecord must not be padded");
+
+template <typename T>
+void Put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Records may sit at any alignment in the mapping, so they are copied out
+template <typename T>
+T Get(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+uint64_t Rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t Fmix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+/// MurmurHash3 x64/128: fast and well distributed; not meant to resist forgery
+void Murmur3(const uint8_t* data, size_t size, uint64_t& h1, uint64_t& h2) {
+    constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+    h1 = 0;
+    h2 = 0;
+
+    const size_t blocks = size / 16;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k1 = Get<uint64_t>(data + i * 16);
+        uint64_t k2 = Get<uint64_t>(data + i * 16 + 8);
+
+        k1 *= c1;
+        k1 = Rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = Rotl(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = Rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = Rotl(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = data + blocks * 16;
+    const size_t rest = size & 15;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t j = 0; j < rest; ++j) {
+        if (j < 8) {
+            k1 |= static_cast<uint64_t>(tail[j]) << (8 * j);
+        } else {
+            k2 |= static_cast<uint64_t>(tail[j]) << (8 * (j - 8));
+        }
+    }
+    if (rest > 8) {
+        k2 *= c2;
+        k2 = Rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    if (rest > 0) {
+        k1 *= c1;
+        k1 = Rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= size;
+    h2 ^= size;
+    h1 += h2;
+    h2 += h1;
+    h1 = Fmix(h1);
+    h2 = Fmix(h2);
+    h1 += h2;
+    h2 += h1;
+}
+
+struct EntryInfo {
+    fs::path path;
+    uint64_t size;
+    fs::file_time_type last_used;
+};
+
+std::vector<EntryInfo> ListEntries(const std::string& directory) {
+    std::vector<EntryInfo> entries;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != kEntryExtension) {
+            continue;  // Temporary files of writers in progress, or unrelated files
+        }
+        std::error_code entry_ec;
+        const uint64_t size = it->file_size(entry_ec);
+        const fs::file_time_type last_used = it->last_write_time(entry_ec);
+        if (!entry_ec) {
+            entries.push_back({it->path(), size, last_used});
+        }
+    }
+    return entries;
+}
+
+}  // namespace
+
+TranscriptionCache::TranscriptionCache(const TranscriptionCacheConfig& config) : config_(config) {
+}
+
+std::string TranscriptionCache::HashFile(const std::string& path) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        return {};
+    }
+    return HashBytes(file.GetData(), file.GetSize());
+}
+
+std::string TranscriptionCache::HashBytes(const void* data, size_t size) {
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+    Murmur3(static_cast<const uint8_t*>(data), size, h1, h2);
+    char hex[33];
+    std::snprintf(hex, sizeof(hex), "%016llx%016llx", static_cast<unsigned long long>(h1),
+                  static_cast<unsigned long long>(h2));
+    return hex;
+}
+
+std::string TranscriptionCache::MakeKey(const std::string& content_hash,
+                                        const WhisperConfig& config) {
+    // The model is identified by file name and size, so a moved model still hits
+    // but a re-downloaded or re-quantized one does not
+    std::error_code ec;
+    const uintmax_t model_size = fs::file_size(config.model_path, ec);
+    std::string fingerprint = "ffvc1\n" + content_hash;
+    fingerprint += "\n" + fs::path(config.model_path).filename().string();
+    fingerprint += "\n" + std::to_string(ec ? 0 : model_size);
+    fingerprint += "\n" + std::to_string(static_cast<int>(config.model_type));
+    fingerprint += "\n" + config.language;
+    fingerprint += config.translate ? "\ntranslate" : "\ntranscribe";
+    fingerprint += config.word_timestamps ? "\nwords" : "\nsegments";
+    fingerprint += "\n" + config.initial_prompt;
+    return HashBytes(fingerprint.data(), fingerprint.size());
+}
+
+std::string TranscriptionCache::EntryPath(const std::string& key) const {
+    return (fs::path(config_.directory) / (key + kEntryExtension)).string();
+}
+
+bool TranscriptionCache::Lookup(const std::string& key,
+                                std::vector<TranscriptionSegment>& segments,
+                                std::vector<SpeakerSegment>* speakers, std::string* language) {
+    const std::string path = EntryPath(key);
+    std::error_code ec;
+    if (key.empty() || !fs::is_regular_file(path, ec)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.misses;
+        return false;
+    }
+
+    MappedFile file;
+    bool valid = file.Open(path, false) && file.GetSize() >= sizeof(FileHeader);
+    FileHeader header{};
+    if (valid) {
+        header = Get<FileHeader>(file.GetData());
+        const uint64_t expected =
+            sizeof(FileHeader) + uint64_t{header.segment_count} * sizeof(SegmentRecord) +
+            uint64_t{header.word_count} * sizeof(WordRecord) +
+            uint64_t{header.speaker_count} * sizeof(SpeakerRecord) + header.text_bytes;
+        valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                header.version == kFormatVersion && expected == file.GetSize() &&
+                header.language_size <= header.text_bytes;
+    }
+
+    std::vector<TranscriptionSegment> result;
+    std::vector<SpeakerSegment> speaker_result;
+    std::string language_result;
+    if (valid) {
+        const uint8_t* segment_base = file.GetData() + sizeof(FileHeader);
+        const uint8_t* word_base = segment_base + header.segment_count * sizeof(SegmentRecord);
+        const uint8_t* speaker_base = word_base + header.word_count * sizeof(WordRecord);
+        const char* text = reinterpret_cast<const char*>(speaker_base) +
+                           header.speaker_count * sizeof(SpeakerRecord);
+        auto text_ok = [&](uint32_t offset, uint32_t size) {
+            return uint64_t{offset} + size <= header.text_bytes;
+        };
+
+        language_result.assign(text, header.language_size);
+        result.resize(header.segment_count);
+        for (uint32_t i = 0; valid && i < header.segment_count; ++i) {
+            const auto record = Get<SegmentRecord>(segment_base + i * sizeof(SegmentRecord));
+            if (!text_ok(record.text_offset, record.text_size) ||
+                uint64_t{record.first_word} + record.word_count > header.word_count) {
+                valid = false;
+                break;
+            }
+            TranscriptionSegment& segment = result[i];
+            segment.start_ms = record.start_ms;
+            segment.end_ms = record.end_ms;
+            segment.confidence = record.confidence;
+            segment.speaker_id = record.speaker_id;
+            segment.text.assign(text + record.text_offset, record.text_size);
+            segment.words.resize(record.word_count);
+            for (uint32_t w = 0; w < record.word_count; ++w) {
+                const auto word_record =
+                    Get<WordRecord>(word_base + (record.first_word + w) * sizeof(WordRecord));
+                if (!text_ok(word_record.text_offset, word_record.text_size)) {
+                    valid = false;
+                    break;
+                }
+                Word& word = segment.words[w];
+                word.start_ms = word_record.start_ms;
+                word.end_ms = word_record.end_ms;
+                word.probability = word_record.probability;
+                word.speaker_id = word_record.speaker_id;
+                word.text.assign(text + word_record.text_offset, word_record.text_size);
+            }
+        }
+        for (uint32_t i = 0; valid && i < header.speaker_count; ++i) {
+            const auto record = Get<SpeakerRecord>(speaker_base + i * sizeof(SpeakerRecord));
+            speaker_result.emplace_back(record.start_ms, record.end_ms, record.speaker_id);
+        }
+    }
+    file.Close();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!valid) {
+        LOG_WARNING("TranscriptionCache: discarding unreadable entry %s", path.c_str());
+        fs::remove(path, ec);
+        ++stats_.misses;
+        return false;
+    }
+    // Refresh the entry's place in the LRU order (shared with other processes)
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++stats_.hits;
+    segments = std::move(result);
+    if (speakers) {
+        *speakers = std::move(speaker_result);
+    }
+    if (language) {
+        *language = std::move(language_result);
+    }
+    return true;
+}
+
+bool TranscriptionCache::Store(const std::string& key,
+                               const std::vector<TranscriptionSegment>& segments,
+                               const std::vector<SpeakerSegment>* speakers,
+                               const std::string& language) {
+    std::string text = language;
+    std::string records;
+    std::string word_records;
+    uint32_t word_count = 0;
+    for (const auto& segment : segments) {
+        SegmentRecord record{};
+        record.start_ms = segment.start_ms;
+        record.end_ms = segment.end_ms;
+        record.confidence = segment.confidence;
+        record.speaker_id = segment.speaker_id;
+        record.text_offset = static_cast<uint32_t>(text.size());
+        record.text_size = static_cast<uint32_t>(segment.text.size());
+        record.first_word = word_count;
+        record.word_count = static_cast<uint32_t>(segment.words.size());
+        text += segment.text;
+        for (const auto& word : segment.words) {
+            WordRecord word_record{};
+            word_record.start_ms = word.start_ms;
+            word_record.end_ms = word.end_ms;
+            word_record.probability = word.probability;
+            word_record.speaker_id = word.speaker_id;
+            word_record.text_offset = static_cast<uint32_t>(text.size());
+            word_record.text_size = static_cast<uint32_t>(word.text.size());
+            text += word.text;
+            Put(word_records, word_record);
+        }
+        word_count += record.word_count;
+        Put(records, record);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.segment_count = static_cast<uint32_t>(segments.size());
+    header.word_count = word_count;
+    header.speaker_count = speakers ? static_cast<uint32_t>(speakers->size()) : 0;
+    header.text_bytes = static_cast<uint32_t>(text.size());
+    header.language_size = static_cast<uint32_t>(language.size());
+
+    std::string blob;
+    blob.reserve(sizeof(header) + records.size() + word_records.size() +
+                 header.speaker_count * sizeof(SpeakerRecord) + text.size());
+    Put(blob, header);
+    blob += records;
+    blob += word_records;
+    if (speakers) {
+        for (const auto& speaker : *speakers) {
+            SpeakerRecord record{};
+            record.start_ms = speaker.start_ms;
+            record.end_ms = speaker.end_ms;
+            record.speaker_id = speaker.speaker_id;
+            Put(blob, record);
+        }
+    }
+    blob += text;
+
+    std::error_code ec;
+    fs::create_directories(config_.directory, ec);
+    // Unique per writer, so concurrent stores of one key never share a file
+    static std::atomic<uint64_t> sequence{0};
+    const std::string path = EntryPath(key);
+    const std::string temp_path =
+        path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+        "-" + std::to_string(sequence++);
+    bool ok = !ec && !key.empty();
+    if (ok) {
+        std::ofstream out(temp_path, std::ios::binary);
+        out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        out.close();
+        ok = !out.fail();
+        if (ok) {
+            fs::rename(temp_path, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            fs::remove(temp_path, ec);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+        last_error_ = "Cannot write transcription cache entry in " + config_.directory;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    ++stats_.stores;
+    Evict();
+    return true;
+}
+
+void TranscriptionCache::Evict() {
+    std::vector<EntryInfo> entries = ListEntries(config_.directory);
+    uint64_t total = 0;
+    for (const auto& entry : entries) {
+        total += entry.size;
+    }
+    if (total <= config_.max_bytes) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const EntryInfo& a, const EntryInfo& b) {
+        return a.last_used < b.last_used;
+    });
+    for (const auto& entry : entries) {
+        if (total <= config_.max_bytes) {
+            break;
+        }
+        std::error_code ec;
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+            ++stats_.evictions;
+        }
+    }
+}
+
+void TranscriptionCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : ListEntries(config_.directory)) {
+        std::error_code ec;
+        fs::remove(entry.path, ec);
+    }
+}
+
+TranscriptionCacheStats TranscriptionCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TranscriptionCacheStats stats = stats_;
+    for (const auto& entry : ListEntries(config_.directory)) {
+        ++stats.entries;
+        stats.bytes += entry.size;
+    }
+    return stats;
+}
+
+std::string TranscriptionCache::GetLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
+
+}  // namespace ffvoice
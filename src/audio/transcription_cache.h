@@ -0,0 +1,147 @@
+/**
+ * @file transcription_cache.h
+ * @brief Content-addressed on-disk cache of transcription results
+ *
+ * The MCP server and batch jobs often transcribe the same recording again
+ * with identical settings. TranscriptionCache keys each result by a hash of
+ * the audio bytes plus every setting that changes the output (model file,
+ * language, translate, word timestamps, prompt), so a hit returns the stored
+ * segments without loading the audio or running Whisper at all.
+ *
+ * Each entry is one small binary file, <key>.ffvc, holding fixed-size
+ * segment, word and speaker records followed by their text and the language
+ * Whisper detected; it is read back through a MappedFile. Entries are written to a temporary name and renamed
+ * into place, so processes sharing a directory never see a partial entry.
+ * Total size is bounded: the least recently used entries (by file mtime,
+ * which a hit refreshes) are deleted once max_bytes is exceeded.
+ *
+ * @code
+ * TranscriptionCache cache({"/var/cache/ffvoice/transcripts", 512ull << 20});
+ * const std::string key = TranscriptionCache::MakeKey(
+ *     TranscriptionCache::HashFile("talk.wav"), whisper_config);
+ * if (!cache.Lookup(key, segments)) {
+ *     processor.TranscribeFile("talk.wav", segments);
+ *     cache.Store(key, segments);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "audio/diarizer.h"
+#include "audio/whisper_processor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Configuration for TranscriptionCache
+ */
+struct TranscriptionCacheConfig {
+    std::string directory;              ///< Entry directory (created if missing)
+    uint64_t max_bytes = 256ull << 20;  ///< Evict least recently used entries above this
+};
+
+/**
+ * @brief Cache statistics (see TranscriptionCache::GetStats())
+ */
+struct TranscriptionCacheStats {
+    uint64_t hits = 0;       ///< Lookups answered from the cache
+    uint64_t misses = 0;     ///< Lookups with no (valid) entry
+    uint64_t stores = 0;     ///< Entries written
+    uint64_t evictions = 0;  ///< Entries deleted to stay under max_bytes
+    uint64_t entries = 0;    ///< Entries currently in the directory
+    uint64_t bytes = 0;      ///< Their total size
+};
+
+/**
+ * @brief Stores and retrieves transcription results by content key.
+ *
+ * Thread-safe; several caches (or processes) may share one directory.
+ * Counters in GetStats() are per instance, entries and bytes are the
+ * directory's.
+ */
+class TranscriptionCache {
+public:
+    explicit TranscriptionCache(const TranscriptionCacheConfig& config);
+
+    /**
+     * @brief Hash the bytes of a file (32 hex digits)
+     * @param path File to hash
+     * @return Content hash, or an empty string if the file cannot be read
+     */
+    static std::string HashFile(const std::string& path);
+
+    /**
+     * @brief Hash a block of memory, e.g. a PCM clip (32 hex digits)
+     * @param data Bytes to hash
+     * @param size Number of bytes
+     * @return Content hash
+     */
+    static std::string HashBytes(const void* data, size_t size);
+
+    /**
+     * @brief Combine a content hash with the settings that affect the result
+     *
+     * Covers the model file (name and size), model type, language, translate,
+     * word_timestamps and initial_prompt. Threads, backend and progress
+     * options do not change the transcript and are left out.
+     *
+     * @param content_hash HashFile() or HashBytes() of the audio
+     * @param config Whisper configuration the result was produced with
+     * @return Cache key (32 hex digits)
+     */
+    static std::string MakeKey(const std::string& content_hash, const WhisperConfig& config);
+
+    /**
+     * @brief Read the entry for @p key
+     * @param key Key from MakeKey()
+     * @param segments Output segments (replaced on a hit)
+     * @param speakers Optional diarization output stored with the entry
+     * @param language Optional detected language stored with the entry ("" if none)
+     * @return true on a hit; false if absent or unreadable (a corrupt entry is deleted)
+     */
+    bool Lookup(const std::string& key, std::vector<TranscriptionSegment>& segments,
+                std::vector<SpeakerSegment>* speakers = nullptr, std::string* language = nullptr);
+
+    /**
+     * @brief Write the entry for @p key, then evict down to max_bytes
+     * @param key Key from MakeKey()
+     * @param segments Segments to store
+     * @param speakers Optional diarization output to store alongside
+     * @param language Language Whisper detected for the result, e.g. "de"
+     * @return false if the directory cannot be created or the entry written
+     */
+    bool Store(const std::string& key, const std::vector<TranscriptionSegment>& segments,
+               const std::vector<SpeakerSegment>* speakers = nullptr,
+               const std::string& language = "");
+
+    /// Delete every entry in the directory
+    void Clear();
+
+    TranscriptionCacheStats GetStats() const;
+
+    const std::string& GetDirectory() const {
+        return config_.directory;
+    }
+
+    std::string GetLastError() const;
+
+private:
+    std::string EntryPath(const std::string& key) const;
+
+    /// Delete least recently used entries until the directory fits max_bytes
+    void Evict();
+
+    TranscriptionCacheConfig config_;
+    mutable std::mutex mutex_;  ///< Guards the counters, last_error_ and Evict()
+    TranscriptionCacheStats stats_;
+    std::string last_error_;
+};
+
+}  // namespace ffvoice
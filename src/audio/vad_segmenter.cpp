@@ -6,12 +6,81 @@
 #include "audio/vad_segmenter.h"
 
 #include "utils/logger.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
+#include <utility>
 
 namespace ffvoice {
 
+namespace detail {
+
+/// Segment buffers released by SegmentHandles, shared with the segmenter
+struct SegmentPool {
+    static constexpr size_t kMaxIdle = 4;  ///< Idle buffers kept; more are freed
+
+    std::vector<int16_t> Acquire(size_t capacity) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                std::vector<int16_t> buffer = std::move(idle.back());
+                idle.pop_back();
+                return buffer;
+            }
+        }
+        std::vector<int16_t> buffer;
+        buffer.reserve(capacity);
+        return buffer;
+    }
+
+    void Release(std::vector<int16_t> buffer) {
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle.size() < kMaxIdle) {
+            idle.push_back(std::move(buffer));
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<std::vector<int16_t>> idle;
+};
+
+}  // namespace detail
+
+SegmentHandle::SegmentHandle(std::vector<int16_t> samples,
+                             std::shared_ptr<detail::SegmentPool> pool)
+    : samples_(std::move(samples)), pool_(std::move(pool)) {
+}
+
+SegmentHandle::~SegmentHandle() {
+    Release();
+}
+
+SegmentHandle::SegmentHandle(SegmentHandle&& other) noexcept
+    : samples_(std::move(other.samples_)), pool_(std::move(other.pool_)) {
+    other.samples_.clear();
+}
+
+SegmentHandle& SegmentHandle::operator=(SegmentHandle&& other) noexcept {
+    if (this != &other) {
+        Release();
+        samples_ = std::move(other.samples_);
+        pool_ = std::move(other.pool_);
+        other.samples_.clear();
+    }
+    return *this;
+}
+
+void SegmentHandle::Release() {
+    if (pool_) {
+        pool_->Release(std::move(samples_));
+        pool_.reset();
+    }
+    samples_ = std::vector<int16_t>();
+}
+
 VADSegmenter::Config VADSegmenter::Config::FromPreset(Sensitivity sensitivity) {
     Config config;
     switch (sensitivity) {
@@ -48,13 +117,18 @@ VADSegmenter::VADSegmenter() : VADSegmenter(Config{}) {
 }
 
 VADSegmenter::VADSegmenter(const Config& config)
-    : config_(config), current_threshold_(config.speech_threshold) {
+    : config_(config),
+      pool_(std::make_shared<detail::SegmentPool>()),
+      current_threshold_(config.speech_threshold) {
     // Reserve space for maximum segment size to avoid reallocations
     buffer_.reserve(config_.max_segment_samples);
+    pre_roll_.resize(std::min(config_.pre_roll_samples, config_.max_segment_samples));
 }
 
 void VADSegmenter::ProcessFrame(const int16_t* samples, size_t num_samples, float vad_prob,
                                 SegmentCallback on_segment) {
+    FFVOICE_TRACE_SCOPE("VADSegmenter::ProcessFrame");
+
     // Update statistics
     vad_sum_ += vad_prob;
     total_frames_++;
@@ -78,7 +152,9 @@ void VADSegmenter::ProcessFrame(const int16_t* samples, size_t num_samples, floa
         // Start accumulating if we have enough consecutive speech frames
         if (!in_speech_ && speech_frames_ >= config_.min_speech_frames) {
             in_speech_ = true;
-            LOG_INFO("VADSegmenter: Speech started (VAD prob: %.2f)", vad_prob);
+            LOG_INFO("VADSegmenter: Speech started (VAD prob: %.2f, %zu samples pre-roll)",
+                     vad_prob, pre_roll_size_);
+            DrainPreRoll();
         }
     } else {
         silence_frames_++;
@@ -113,16 +189,15 @@ void VADSegmenter::ProcessFrame(const int16_t* samples, size_t num_samples, floa
                      buffer_.size(), buffer_.size() / 48000.0);
 
             // Trigger callback with accumulated segment
-            if (on_segment && !buffer_.empty()) {
-                on_segment(buffer_.data(), buffer_.size());
-            }
+            DeliverSegment(on_segment);
 
             // Reset state for next segment
-            buffer_.clear();
             in_speech_ = false;
             speech_frames_ = 0;
             silence_frames_ = 0;
         }
+    } else {
+        PushPreRoll(samples, num_samples);
     }
 }
 
@@ -131,21 +206,75 @@ void VADSegmenter::Flush(SegmentCallback on_segment) {
         LOG_INFO("VADSegmenter: Flushing final segment, %zu samples (%.2fs)", buffer_.size(),
                  buffer_.size() / 48000.0);
 
-        if (on_segment) {
-            on_segment(buffer_.data(), buffer_.size());
-        }
-
-        buffer_.clear();
+        DeliverSegment(on_segment);
     }
 
     // Reset state
     in_speech_ = false;
     speech_frames_ = 0;
     silence_frames_ = 0;
+    pre_roll_size_ = 0;
+}
+
+SegmentHandle VADSegmenter::TakeSegment() {
+    if (!delivering_ || buffer_.empty()) {
+        return SegmentHandle();
+    }
+    SegmentHandle segment(std::move(buffer_), pool_);
+    buffer_ = pool_->Acquire(config_.max_segment_samples);
+    return segment;
+}
+
+void VADSegmenter::DeliverSegment(const SegmentCallback& on_segment) {
+    if (on_segment && !buffer_.empty()) {
+        delivering_ = true;
+        on_segment(buffer_.data(), buffer_.size());
+        delivering_ = false;
+    }
+    buffer_.clear();
+}
+
+void VADSegmenter::PushPreRoll(const int16_t* samples, size_t num_samples) {
+    const size_t capacity = pre_roll_.size();
+    if (capacity == 0 || samples == nullptr) {
+        return;
+    }
+    if (num_samples >= capacity) {
+        std::memcpy(pre_roll_.data(), samples + (num_samples - capacity),
+                    capacity * sizeof(int16_t));
+        pre_roll_head_ = 0;
+        pre_roll_size_ = capacity;
+        return;
+    }
+
+    const size_t first = std::min(num_samples, capacity - pre_roll_head_);
+    std::memcpy(pre_roll_.data() + pre_roll_head_, samples, first * sizeof(int16_t));
+    std::memcpy(pre_roll_.data(), samples + first, (num_samples - first) * sizeof(int16_t));
+    pre_roll_head_ = (pre_roll_head_ + num_samples) % capacity;
+    pre_roll_size_ = std::min(pre_roll_size_ + num_samples, capacity);
+}
+
+void VADSegmenter::DrainPreRoll() {
+    // Keep the newest samples if the segment has less room than the pre-roll
+    const size_t room = config_.max_segment_samples > buffer_.size()
+                            ? config_.max_segment_samples - buffer_.size()
+                            : 0;
+    const size_t count = std::min(pre_roll_size_, room);
+    if (count > 0) {
+        const size_t capacity = pre_roll_.size();
+        const size_t start = (pre_roll_head_ + capacity - count) % capacity;
+        const size_t first = std::min(count, capacity - start);
+        buffer_.insert(buffer_.end(), pre_roll_.begin() + static_cast<std::ptrdiff_t>(start),
+                       pre_roll_.begin() + static_cast<std::ptrdiff_t>(start + first));
+        buffer_.insert(buffer_.end(), pre_roll_.begin(),
+                       pre_roll_.begin() + static_cast<std::ptrdiff_t>(count - first));
+    }
+    pre_roll_size_ = 0;
 }
 
 void VADSegmenter::Reset() {
     buffer_.clear();
+    pre_roll_size_ = 0;
     in_speech_ = false;
     speech_frames_ = 0;
     silence_frames_ = 0;
@@ -11,10 +11,58 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace ffvoice {
 
+namespace detail {
+struct SegmentPool;
+}  // namespace detail
+
+/**
+ * @brief Move-only ownership of one finished speech segment
+ *
+ * Obtained from VADSegmenter::TakeSegment() inside the segment callback. The
+ * samples are the segmenter's own buffer, handed over without a copy; when the
+ * handle is destroyed (on any thread) the buffer goes back to the segmenter's
+ * pool, so steady-state segmentation does not allocate.
+ */
+class SegmentHandle {
+public:
+    SegmentHandle() = default;
+    ~SegmentHandle();
+
+    SegmentHandle(SegmentHandle&& other) noexcept;
+    SegmentHandle& operator=(SegmentHandle&& other) noexcept;
+    SegmentHandle(const SegmentHandle&) = delete;
+    SegmentHandle& operator=(const SegmentHandle&) = delete;
+
+    /// Interleaved int16 samples of the segment
+    const int16_t* data() const {
+        return samples_.data();
+    }
+
+    /// Number of samples (all channels)
+    size_t size() const {
+        return samples_.size();
+    }
+
+    bool empty() const {
+        return samples_.empty();
+    }
+
+private:
+    friend class VADSegmenter;
+    SegmentHandle(std::vector<int16_t> samples, std::shared_ptr<detail::SegmentPool> pool);
+
+    /// Return the buffer to its pool (if any) and leave the handle empty
+    void Release();
+
+    std::vector<int16_t> samples_;
+    std::shared_ptr<detail::SegmentPool> pool_;
+};
+
 /**
  * @brief VAD-based audio segmentation for real-time speech recognition
  *
@@ -26,6 +74,12 @@ namespace ffvoice {
  *   [Silence] --[VAD detects speech]--> [Accumulating Speech]
  *   [Accumulating Speech] --[VAD detects silence]--> [Trigger Callback] --> [Silence]
  *   [Accumulating Speech] --[Max length reached]--> [Trigger Callback] --> [Silence]
+ *
+ * Speech is only confirmed after min_speech_frames, so the start of every
+ * utterance would be lost. With pre_roll_samples set, the most recent audio
+ * heard in silence is kept in a fixed-size circular buffer and prepended to
+ * the segment when speech starts; thresholds can then be raised without
+ * clipping word onsets.
  */
 class VADSegmenter {
 public:
@@ -50,6 +104,7 @@ public:
         size_t max_segment_samples = 480000;     ///< Max segment length (10s @48kHz)
         bool enable_adaptive_threshold = false;  ///< Enable adaptive threshold adjustment
         float adaptive_factor = 0.1f;            ///< Adaptation speed (0.0-1.0, lower=slower)
+        size_t pre_roll_samples = 0;             ///< Audio before speech start to keep (0 = off)
 
         /**
          * @brief Create configuration from sensitivity preset
@@ -108,6 +163,27 @@ public:
      */
     void Reset();
 
+    /**
+     * @brief Take ownership of the segment being delivered
+     *
+     * Only valid inside the @p on_segment callback of ProcessFrame() or
+     * Flush(): the segment's buffer is moved into the handle (the callback's
+     * pointer stays valid for as long as the handle lives) and the segmenter
+     * continues with a pooled buffer. Outside a callback, or when called
+     * twice, returns an empty handle.
+     */
+    SegmentHandle TakeSegment();
+
+    /**
+     * @brief Read-only view of the speech accumulated so far
+     *
+     * Empty while not in speech. Valid until the next ProcessFrame(), Flush()
+     * or Reset(); partial transcription can read it without a copy.
+     */
+    const std::vector<int16_t>& GetCurrentBuffer() const {
+        return buffer_;
+    }
+
     /**
      * @brief Get the current buffer size in samples
      * @return Number of samples currently buffered
@@ -140,12 +216,30 @@ public:
     void GetStatistics(float& avg_vad_prob, float& speech_ratio) const;
 
 private:
+    /// Hand the accumulated segment to @p on_segment and start an empty buffer
+    void DeliverSegment(const SegmentCallback& on_segment);
+
+    /// Remember a frame heard in silence, overwriting the oldest pre-roll audio
+    void PushPreRoll(const int16_t* samples, size_t num_samples);
+
+    /// Move the pre-roll, oldest first, to the start of the segment buffer
+    void DrainPreRoll();
+
     Config config_;                ///< Configuration parameters
     std::vector<int16_t> buffer_;  ///< Audio sample buffer
     int speech_frames_ = 0;        ///< Consecutive speech frames
     int silence_frames_ = 0;       ///< Consecutive silence frames
     bool in_speech_ = false;       ///< Currently in speech segment
 
+    // Segment hand-off
+    std::shared_ptr<detail::SegmentPool> pool_;  ///< Buffers returned by SegmentHandles
+    bool delivering_ = false;                    ///< Inside on_segment; TakeSegment() allowed
+
+    // Pre-roll (circular, capacity min(pre_roll_samples, max_segment_samples))
+    std::vector<int16_t> pre_roll_;  ///< Most recent audio heard in silence
+    size_t pre_roll_head_ = 0;       ///< Next write position
+    size_t pre_roll_size_ = 0;       ///< Valid samples in pre_roll_
+
     // Adaptive threshold and statistics
     float current_threshold_;      ///< Current threshold (adaptive if enabled)
     float vad_sum_ = 0.0f;         ///< Sum of VAD probabilities for averaging
@@ -0,0 +1,251 @@
+/**
+ * @file whisper_backend.cpp
+ * @brief Implementation of whisper.cpp accelerator selection and probing
+ */
+
+#include "audio/whisper_backend.h"
+
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+#include "utils/metrics.h"
+
+#ifdef ENABLE_WHISPER
+    #include "ggml-backend.h"
+    #include "whisper.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+namespace ffvoice {
+
+namespace {
+
+bool IsGpuBackend(WhisperBackend backend) {
+    return backend == WhisperBackend::CUDA || backend == WhisperBackend::METAL ||
+           backend == WhisperBackend::VULKAN;
+}
+
+std::string DeviceLabel(const WhisperDeviceInfo& device) {
+    return device.description.empty() ? device.name
+                                      : device.name + " (" + device.description + ")";
+}
+
+std::string AvailableList(const WhisperCapabilities& capabilities) {
+    std::string list;
+    for (WhisperBackend backend : capabilities.backends) {
+        list += (list.empty() ? "" : ", ") + GetWhisperBackendName(backend);
+    }
+    return list;
+}
+
+#ifdef ENABLE_WHISPER
+// ggml registry names of the GPU backends WhisperBackend can select
+WhisperBackend BackendFromRegistry(const char* name) {
+    if (std::strcmp(name, "CUDA") == 0) {
+        return WhisperBackend::CUDA;
+    }
+    if (std::strcmp(name, "Metal") == 0) {
+        return WhisperBackend::METAL;
+    }
+    if (std::strcmp(name, "Vulkan") == 0) {
+        return WhisperBackend::VULKAN;
+    }
+    return WhisperBackend::AUTO;  // Another ggml GPU backend (HIP, SYCL, ...): AUTO only
+}
+#endif
+
+}  // namespace
+
+bool WhisperCapabilities::Supports(WhisperBackend backend) const {
+    return backend == WhisperBackend::AUTO ||
+           std::find(backends.begin(), backends.end(), backend) != backends.end();
+}
+
+WhisperCapabilities ProbeWhisperCapabilities() {
+    WhisperCapabilities capabilities;
+    capabilities.backends.push_back(WhisperBackend::CPU);
+#ifdef ENABLE_WHISPER
+    // Index devices per backend the way whisper.cpp counts GPUs for gpu_device
+    for (size_t i = 0; i < ggml_backend_dev_count(); ++i) {
+        ggml_backend_dev_t dev = ggml_backend_dev_get(i);
+        if (ggml_backend_dev_type(dev) != GGML_BACKEND_DEVICE_TYPE_GPU) {
+            continue;
+        }
+        WhisperDeviceInfo device;
+        device.backend =
+            BackendFromRegistry(ggml_backend_reg_name(ggml_backend_dev_backend_reg(dev)));
+        device.index = static_cast<int>(
+            std::count_if(capabilities.devices.begin(), capabilities.devices.end(),
+                          [&](const WhisperDeviceInfo& d) { return d.backend == device.backend; }));
+        device.name = ggml_backend_dev_name(dev);
+        device.description = ggml_backend_dev_description(dev);
+        ggml_backend_dev_memory(dev, &device.memory_free, &device.memory_total);
+        if (IsGpuBackend(device.backend) && !capabilities.Supports(device.backend)) {
+            capabilities.backends.push_back(device.backend);
+        }
+        capabilities.devices.push_back(std::move(device));
+    }
+
+    // The encoders are whisper.cpp build options, reported in its system info
+    capabilities.system_info = whisper_print_system_info();
+    if (capabilities.system_info.find("OPENVINO = 1") != std::string::npos) {
+        capabilities.backends.push_back(WhisperBackend::OPENVINO);
+    }
+    if (capabilities.system_info.find("COREML = 1") != std::string::npos) {
+        capabilities.backends.push_back(WhisperBackend::COREML);
+    }
+#endif
+    return capabilities;
+}
+
+bool ResolveWhisperAcceleration(const WhisperAcceleration& acceleration,
+                                const WhisperCapabilities& capabilities,
+                                WhisperContextSettings& settings, std::string& error) {
+    settings = WhisperContextSettings();
+    settings.flash_attn = acceleration.flash_attn;
+
+    const WhisperBackend backend = acceleration.backend;
+    if (!capabilities.Supports(backend)) {
+        error = "Whisper backend '" + GetWhisperBackendName(backend) +
+                "' is not available in this build (available: " + AvailableList(capabilities) +
+                ")";
+        return false;
+    }
+    if (backend == WhisperBackend::CPU) {
+        settings.description = "CPU";
+        return true;
+    }
+    if (backend == WhisperBackend::OPENVINO) {
+        if (acceleration.openvino_device.empty()) {
+            error = "OpenVINO backend needs an openvino_device (CPU, GPU, NPU, ...)";
+            return false;
+        }
+        settings.openvino_device = acceleration.openvino_device;
+        settings.description = "OpenVINO encoder on " + acceleration.openvino_device + ", CPU";
+        return true;
+    }
+
+    // Everything else runs on a GPU: the n-th of the backend's GPUs, or of all
+    // of them for AUTO and Core ML (whose decoder runs on Metal)
+    const bool any_gpu = backend == WhisperBackend::AUTO || backend == WhisperBackend::COREML;
+    int matching = 0;
+    for (size_t i = 0; i < capabilities.devices.size(); ++i) {
+        const WhisperDeviceInfo& device = capabilities.devices[i];
+        if (!any_gpu && device.backend != backend) {
+            continue;
+        }
+        if (matching++ == acceleration.gpu_device) {
+            settings.use_gpu = true;
+            settings.gpu_device = static_cast<int>(i);
+            settings.description = DeviceLabel(device);
+            break;
+        }
+    }
+    if (settings.use_gpu) {
+        if (backend == WhisperBackend::COREML) {
+            settings.description = "Core ML encoder, " + settings.description;
+        }
+        return true;
+    }
+    if (any_gpu && matching == 0) {
+        // No GPU at all: AUTO runs on the CPU, Core ML keeps its encoder
+        settings.description = backend == WhisperBackend::COREML ? "Core ML encoder, CPU" : "CPU";
+        return true;
+    }
+    error = "GPU " + std::to_string(acceleration.gpu_device) + " not found: " +
+            std::to_string(matching) + " " +
+            (any_gpu ? std::string("GPU(s)") : GetWhisperBackendName(backend) + " GPU(s)") +
+            " available";
+    return false;
+}
+
+struct whisper_context* LoadWhisperContext(const std::string& model_path,
+                                           const WhisperContextSettings& settings, bool use_mmap,
+                                           bool with_state, std::string& error) {
+#ifdef ENABLE_WHISPER
+    struct whisper_context_params cparams = whisper_context_default_params();
+    cparams.use_gpu = settings.use_gpu;
+    cparams.gpu_device = settings.gpu_device;
+    cparams.flash_attn = settings.flash_attn;
+
+    const auto start = std::chrono::steady_clock::now();
+    struct whisper_context* ctx = nullptr;
+    MappedFile mapped;
+    if (use_mmap && mapped.Open(model_path)) {
+        // whisper.cpp only reads the buffer; it copies every tensor out of it
+        void* data = const_cast<uint8_t*>(mapped.GetData());
+        ctx = with_state
+                  ? whisper_init_from_buffer_with_params(data, mapped.GetSize(), cparams)
+                  : whisper_init_from_buffer_with_params_no_state(data, mapped.GetSize(), cparams);
+    } else {
+        if (use_mmap) {
+            LOG_WARNING("Cannot map %s, reading it instead", model_path.c_str());
+        }
+        ctx = with_state
+                  ? whisper_init_from_file_with_params(model_path.c_str(), cparams)
+                  : whisper_init_from_file_with_params_no_state(model_path.c_str(), cparams);
+    }
+    if (!ctx) {
+        error = "Failed to load whisper model from: " + model_path;
+        return nullptr;
+    }
+    const auto load_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    if (MetricsRegistry::IsEnabled()) {
+        MetricsRegistry::Instance().Histogram("whisper.load_us").Record(
+            static_cast<uint64_t>(load_us));
+    }
+    LOG_INFO("Loaded %s in %.0f ms%s", model_path.c_str(), static_cast<double>(load_us) / 1000.0,
+             mapped.IsOpen() ? " (memory-mapped)" : "");
+    return ctx;
+#else
+    (void)model_path;
+    (void)settings;
+    (void)use_mmap;
+    (void)with_state;
+    error = "Whisper support not enabled (rebuild with -DENABLE_WHISPER=ON)";
+    return nullptr;
+#endif
+}
+
+std::string GetWhisperBackendName(WhisperBackend backend) {
+    switch (backend) {
+        case WhisperBackend::AUTO:
+            return "auto";
+        case WhisperBackend::CPU:
+            return "cpu";
+        case WhisperBackend::CUDA:
+            return "cuda";
+        case WhisperBackend::METAL:
+            return "metal";
+        case WhisperBackend::VULKAN:
+            return "vulkan";
+        case WhisperBackend::OPENVINO:
+            return "openvino";
+        case WhisperBackend::COREML:
+            return "coreml";
+        default:
+            return "unknown";
+    }
+}
+
+bool ParseWhisperBackend(const std::string& name, WhisperBackend& backend) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (WhisperBackend candidate :
+         {WhisperBackend::AUTO, WhisperBackend::CPU, WhisperBackend::CUDA, WhisperBackend::METAL,
+          WhisperBackend::VULKAN, WhisperBackend::OPENVINO, WhisperBackend::COREML}) {
+        if (lower == GetWhisperBackendName(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,162 @@
+/**
+ * @file whisper_backend.h
+ * @brief Accelerator selection and capability probing for whisper.cpp
+ *
+ * whisper.cpp can run the model on CUDA, Metal or Vulkan GPUs and hand the
+ * encoder to OpenVINO or Core ML, but which of these exist is decided when
+ * whisper.cpp is built (ENABLE_WHISPER_CUDA, ENABLE_WHISPER_METAL, ... in
+ * CMake). WhisperAcceleration says what a processor would like to run on;
+ * ProbeWhisperCapabilities() reports what this build and machine offer, and
+ * Initialize() fails with a clear error instead of silently falling back when
+ * an explicitly requested backend is missing.
+ *
+ * @code
+ * WhisperCapabilities caps = ProbeWhisperCapabilities();
+ * WhisperConfig config;
+ * if (caps.Supports(WhisperBackend::CUDA)) {
+ *     config.acceleration.backend = WhisperBackend::CUDA;
+ *     config.acceleration.gpu_device = 1;  // Second CUDA GPU
+ *     config.acceleration.flash_attn = true;
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct whisper_context;
+
+namespace ffvoice {
+
+/**
+ * @brief Where whisper.cpp runs the model
+ *
+ * A Core ML build of whisper.cpp loads the Core ML encoder for every context
+ * that has one next to its model, whatever the backend; COREML only makes it
+ * an error for the build to lack it.
+ */
+enum class WhisperBackend {
+    AUTO,      ///< First GPU if one is available, otherwise CPU
+    CPU,       ///< CPU only, even if a GPU is available
+    CUDA,      ///< NVIDIA GPU (ENABLE_WHISPER_CUDA)
+    METAL,     ///< Apple GPU (ENABLE_WHISPER_METAL)
+    VULKAN,    ///< Any Vulkan GPU (ENABLE_WHISPER_VULKAN)
+    OPENVINO,  ///< Encoder on an OpenVINO device, decoder on CPU (ENABLE_WHISPER_OPENVINO)
+    COREML     ///< Encoder on the Apple Neural Engine, decoder on Metal (ENABLE_WHISPER_COREML)
+};
+
+/**
+ * @brief Accelerator options of a WhisperProcessor
+ */
+struct WhisperAcceleration {
+    WhisperBackend backend = WhisperBackend::AUTO;
+
+    /// Index among the GPUs of the chosen backend (for AUTO, among all GPUs)
+    int gpu_device = 0;
+
+    /// Flash attention in the decoder; faster on GPUs, supported on CPU too
+    bool flash_attn = false;
+
+    /// OpenVINO device for the encoder: "CPU", "GPU", "NPU", ...
+    std::string openvino_device = "CPU";
+
+    /// Directory for compiled OpenVINO kernels (empty = beside the model)
+    std::string openvino_cache_dir;
+};
+
+/**
+ * @brief A GPU visible to whisper.cpp
+ */
+struct WhisperDeviceInfo {
+    WhisperBackend backend = WhisperBackend::CPU;  ///< CUDA, METAL or VULKAN
+    int index = 0;              ///< Index among the GPUs of the same backend
+    std::string name;           ///< ggml device name, e.g. "CUDA0"
+    std::string description;    ///< e.g. "NVIDIA L4"
+    size_t memory_free = 0;     ///< Bytes, 0 if unknown
+    size_t memory_total = 0;    ///< Bytes, 0 if unknown
+};
+
+/**
+ * @brief What this build of whisper.cpp can run on, on this machine
+ */
+struct WhisperCapabilities {
+    /// Usable backends; CPU always, AUTO never
+    std::vector<WhisperBackend> backends;
+
+    /// GPUs found, in whisper.cpp's device order
+    std::vector<WhisperDeviceInfo> devices;
+
+    /// whisper_print_system_info(): CPU features and compiled-in encoders
+    std::string system_info;
+
+    bool Supports(WhisperBackend backend) const;
+};
+
+/**
+ * @brief Context settings resolved from a WhisperAcceleration
+ */
+struct WhisperContextSettings {
+    bool use_gpu = false;
+    int gpu_device = 0;  ///< Index among all GPUs, as whisper_context_params expects
+    bool flash_attn = false;
+    std::string openvino_device;  ///< Non-empty: load the OpenVINO encoder on this device
+    std::string description;      ///< Human-readable choice, e.g. "CUDA0 (NVIDIA L4)"
+};
+
+/**
+ * @brief List the backends and GPUs available to whisper.cpp
+ *
+ * Cheap after the first call (ggml enumerates its devices once). Without
+ * ENABLE_WHISPER only CPU is reported.
+ */
+WhisperCapabilities ProbeWhisperCapabilities();
+
+/**
+ * @brief Turn requested acceleration into context settings
+ *
+ * Pure function of its inputs, so the selection rules can be checked against
+ * any capability set.
+ *
+ * @param acceleration Requested backend and device
+ * @param capabilities Result of ProbeWhisperCapabilities()
+ * @param settings Output settings
+ * @param error Set when the request cannot be met
+ * @return false if the backend is not available or the device index is out of range
+ */
+bool ResolveWhisperAcceleration(const WhisperAcceleration& acceleration,
+                                const WhisperCapabilities& capabilities,
+                                WhisperContextSettings& settings, std::string& error);
+
+/**
+ * @brief Create a whisper.cpp context with resolved settings
+ *
+ * With @p use_mmap the file is memory-mapped and parsed from the mapping, so
+ * it is read from the page cache shared by every process that loads it (and
+ * with kernel read-ahead) instead of through buffered reads. whisper.cpp
+ * still copies the weights into its own buffers, so the mapping is released
+ * before returning. Falls back to reading the file if it cannot be mapped.
+ *
+ * @param model_path GGML model file
+ * @param settings Result of ResolveWhisperAcceleration()
+ * @param use_mmap Parse the model from a memory mapping
+ * @param with_state Also allocate the context's default whisper_state
+ * @param error Set on failure
+ * @return New context (release with whisper_free()), or nullptr
+ */
+struct whisper_context* LoadWhisperContext(const std::string& model_path,
+                                           const WhisperContextSettings& settings, bool use_mmap,
+                                           bool with_state, std::string& error);
+
+/// Lower-case backend name ("auto", "cpu", "cuda", "metal", "vulkan", "openvino", "coreml")
+std::string GetWhisperBackendName(WhisperBackend backend);
+
+/**
+ * @brief Parse a backend name (case-insensitive)
+ * @return false if @p name is not one of the GetWhisperBackendName() names
+ */
+bool ParseWhisperBackend(const std::string& name, WhisperBackend& backend);
+
+}  // namespace ffvoice
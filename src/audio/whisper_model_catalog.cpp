@@ -0,0 +1,330 @@
+/**
+ * @file whisper_model_catalog.cpp
+ * @brief Implementation of the Whisper model catalog and budget-driven selection
+ */
+
+#include "audio/whisper_model_catalog.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace ffvoice {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kWhisperRate = 16000;
+
+// Realtime factor of tiny F16 with the default config (4 CPU threads): the
+// ~10x realtime documented on WhisperModelType. relative_cost scales it.
+constexpr double kTinyRtf = 0.1;
+
+struct SizeInfo {
+    WhisperModelType type;
+    const char* name;
+    double cost;      // Per WhisperModelType: 10x, 7x, 3x, 1x, ~0.5x realtime
+    size_t state_mb;  // KV caches, mel and compute buffers of one whisper_state
+    size_t f16_mb;
+    size_t q8_mb;     // 0 = not published
+    size_t q5_mb;
+    WhisperQuantization q5;
+};
+
+// File sizes of the ggerganov/whisper.cpp downloads, rounded to MB
+const SizeInfo kSizes[] = {
+    {WhisperModelType::TINY, "tiny", 1.0, 200, 75, 42, 31, WhisperQuantization::Q5_1},
+    {WhisperModelType::BASE, "base", 1.43, 250, 142, 78, 57, WhisperQuantization::Q5_1},
+    {WhisperModelType::SMALL, "small", 3.3, 390, 466, 252, 181, WhisperQuantization::Q5_1},
+    {WhisperModelType::MEDIUM, "medium", 10.0, 570, 1533, 785, 514, WhisperQuantization::Q5_0},
+    {WhisperModelType::LARGE, "large-v3", 20.0, 950, 3095, 0, 1080, WhisperQuantization::Q5_0},
+};
+
+// Quantized weights move less memory per token; on CPU that outweighs dequantizing
+double QuantizationCost(WhisperQuantization quantization) {
+    switch (quantization) {
+        case WhisperQuantization::Q8_0:
+            return 0.9;
+        case WhisperQuantization::Q5_1:
+        case WhisperQuantization::Q5_0:
+            return 0.95;
+        default:
+            return 1.0;
+    }
+}
+
+WhisperModelVariant MakeVariant(const SizeInfo& size, WhisperQuantization quantization,
+                                size_t file_mb) {
+    WhisperModelVariant variant;
+    variant.type = size.type;
+    variant.quantization = quantization;
+    variant.name = size.name;
+    if (quantization != WhisperQuantization::F16) {
+        variant.name += "-" + WhisperModelCatalog::GetQuantizationName(quantization);
+    }
+    variant.filename = "ggml-" + variant.name + ".bin";
+    variant.file_mb = file_mb;
+    variant.state_mb = size.state_mb;
+    variant.relative_cost = size.cost * QuantizationCost(quantization);
+    return variant;
+}
+
+double DefaultRtf(const WhisperModelVariant& variant) {
+    return kTinyRtf * variant.relative_cost;
+}
+
+/// Speech-like test signal: a gliding 120-300 Hz tone with harmonics, modulated at syllable rate
+std::vector<float> CalibrationSignal(double seconds) {
+    const size_t samples = static_cast<size_t>(seconds * kWhisperRate);
+    std::vector<float> pcm(samples);
+    double phase = 0.0;
+    for (size_t i = 0; i < samples; ++i) {
+        const double t = static_cast<double>(i) / kWhisperRate;
+        const double pitch = 210.0 + 90.0 * std::sin(2.0 * kPi * 0.3 * t);
+        phase += 2.0 * kPi * pitch / kWhisperRate;
+        const double envelope = 0.5 + 0.5 * std::sin(2.0 * kPi * 4.0 * t);
+        const double voice = std::sin(phase) + 0.5 * std::sin(2.0 * phase) +
+                             0.25 * std::sin(3.0 * phase);
+        pcm[i] = static_cast<float>(0.2 * envelope * voice);
+    }
+    return pcm;
+}
+
+}  // namespace
+
+WhisperModelCatalog::WhisperModelCatalog() {
+    for (const SizeInfo& size : kSizes) {
+        variants_.push_back(MakeVariant(size, WhisperQuantization::F16, size.f16_mb));
+        if (size.q8_mb > 0) {
+            variants_.push_back(MakeVariant(size, WhisperQuantization::Q8_0, size.q8_mb));
+        }
+        variants_.push_back(MakeVariant(size, size.q5, size.q5_mb));
+    }
+}
+
+const WhisperModelVariant* WhisperModelCatalog::Find(const std::string& name) const {
+    for (const auto& variant : variants_) {
+        if (variant.name == name) {
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+
+bool WhisperModelCatalog::Calibrate(const WhisperModelVariant& variant,
+                                    const std::string& model_path, const WhisperConfig& config,
+                                    double audio_seconds) {
+    if (audio_seconds <= 0.0 || audio_seconds > 30.0) {
+        last_error_ = "Calibration clip must be 0-30 s (one Whisper window)";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    WhisperConfig calibration = config;
+    calibration.model_path = model_path;
+    calibration.model_type = variant.type;
+    calibration.print_progress = false;
+    calibration.word_timestamps = false;
+    calibration.initial_prompt.clear();
+    WhisperProcessor processor(calibration);
+    if (!processor.Initialize()) {
+        last_error_ = "Cannot calibrate " + variant.name + ": " + processor.GetLastError();
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    // The first decode pays for GPU kernel compilation and cold caches
+    const std::vector<float> pcm = CalibrationSignal(audio_seconds);
+    std::vector<TranscriptionSegment> segments;
+    if (!processor.TranscribePcm(pcm.data(), pcm.size(), segments)) {
+        last_error_ = "Cannot calibrate " + variant.name + ": " + processor.GetLastError();
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    if (!processor.TranscribePcm(pcm.data(), pcm.size(), segments)) {
+        last_error_ = "Cannot calibrate " + variant.name + ": " + processor.GetLastError();
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    SetMeasuredRtf(variant.name, elapsed / audio_seconds);
+    LOG_INFO("Calibrated %s: %.3f x realtime (%s)", variant.name.c_str(),
+             elapsed / audio_seconds, processor.GetBackendDescription().c_str());
+    return true;
+}
+
+bool WhisperModelCatalog::CalibrateSmallestAvailable(const std::string& model_dir,
+                                                     const WhisperConfig& config,
+                                                     double audio_seconds) {
+    const WhisperModelVariant* smallest = nullptr;
+    for (const auto& variant : variants_) {
+        std::error_code ec;
+        if (std::filesystem::exists(std::filesystem::path(model_dir) / variant.filename, ec) &&
+            (smallest == nullptr || variant.relative_cost < smallest->relative_cost)) {
+            smallest = &variant;
+        }
+    }
+    if (smallest == nullptr) {
+        last_error_ = "No Whisper model from the catalog found in " + model_dir;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    const std::string path = (std::filesystem::path(model_dir) / smallest->filename).string();
+    return Calibrate(*smallest, path, config, audio_seconds);
+}
+
+void WhisperModelCatalog::SetMeasuredRtf(const std::string& name, double rtf) {
+    if (Find(name) != nullptr && rtf > 0.0) {
+        measured_rtf_[name] = rtf;
+    }
+}
+
+double WhisperModelCatalog::EstimateRtf(const WhisperModelVariant& variant) const {
+    const auto it = measured_rtf_.find(variant.name);
+    if (it != measured_rtf_.end()) {
+        return it->second;
+    }
+
+    // Measurements say how much faster or slower this machine is than the
+    // defaults assume; average that ratio geometrically so one outlier
+    // counts as much on the slow side as on the fast side
+    double log_scale = 0.0;
+    int count = 0;
+    for (const auto& [name, rtf] : measured_rtf_) {
+        const WhisperModelVariant* measured = Find(name);
+        if (measured != nullptr) {
+            log_scale += std::log(rtf / DefaultRtf(*measured));
+            ++count;
+        }
+    }
+    const double scale = count > 0 ? std::exp(log_scale / count) : 1.0;
+    return DefaultRtf(variant) * scale;
+}
+
+size_t WhisperModelCatalog::EstimateMemoryMb(const WhisperModelVariant& variant, int concurrency,
+                                             bool share_model) {
+    const size_t streams = static_cast<size_t>(std::max(concurrency, 1));
+    return share_model ? variant.file_mb + streams * variant.state_mb
+                       : streams * (variant.file_mb + variant.state_mb);
+}
+
+bool WhisperModelCatalog::Select(const WhisperResourceBudget& budget,
+                                 WhisperModelChoice& choice) const {
+    if (budget.max_rtf <= 0.0 || budget.concurrency < 1) {
+        last_error_ = "Resource budget needs max_rtf > 0 and concurrency >= 1";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    // Largest size first; within a size, the enum lists formats best first
+    std::vector<const WhisperModelVariant*> ranked;
+    for (const auto& variant : variants_) {
+        ranked.push_back(&variant);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto* a, const auto* b) {
+        if (a->type != b->type) {
+            return static_cast<int>(a->type) > static_cast<int>(b->type);
+        }
+        return static_cast<int>(a->quantization) < static_cast<int>(b->quantization);
+    });
+
+    size_t considered = 0;
+    for (const WhisperModelVariant* variant : ranked) {
+        if (!budget.allow_quantized && variant->quantization != WhisperQuantization::F16) {
+            continue;
+        }
+        if (!budget.model_dir.empty()) {
+            std::error_code ec;
+            if (!std::filesystem::exists(
+                    std::filesystem::path(budget.model_dir) / variant->filename, ec)) {
+                continue;
+            }
+        }
+        ++considered;
+
+        // Streams decoding together split the compute evenly
+        const double rtf = EstimateRtf(*variant) * budget.concurrency;
+        const size_t memory = EstimateMemoryMb(*variant, budget.concurrency, budget.share_model);
+        if (rtf > budget.max_rtf ||
+            (budget.max_memory_mb > 0 && memory > budget.max_memory_mb)) {
+            continue;
+        }
+        choice.variant = *variant;
+        choice.estimated_rtf = rtf;
+        choice.estimated_memory_mb = memory;
+        choice.measured = measured_rtf_.count(variant->name) > 0;
+        return true;
+    }
+
+    std::ostringstream error;
+    if (considered == 0) {
+        error << "No catalog Whisper model found in " << budget.model_dir;
+    } else {
+        error << "No Whisper model fits " << budget.concurrency << " stream(s) at rtf <= "
+              << budget.max_rtf;
+        if (budget.max_memory_mb > 0) {
+            error << " in " << budget.max_memory_mb << " MB";
+        }
+    }
+    last_error_ = error.str();
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+}
+
+bool WhisperModelCatalog::LoadCalibration(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        last_error_ = "Cannot open calibration file: " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        double rtf = 0.0;
+        if (line.empty() || line[0] == '#' || !(fields >> name >> rtf)) {
+            continue;
+        }
+        SetMeasuredRtf(name, rtf);
+    }
+    return true;
+}
+
+bool WhisperModelCatalog::SaveCalibration(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        last_error_ = "Cannot write calibration file: " + path;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    file << "# Whisper realtime factors (decode time / audio time) measured on this machine\n";
+    for (const auto& [name, rtf] : measured_rtf_) {
+        file << name << ' ' << rtf << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+std::string WhisperModelCatalog::GetQuantizationName(WhisperQuantization quantization) {
+    switch (quantization) {
+        case WhisperQuantization::F16:
+            return "f16";
+        case WhisperQuantization::Q8_0:
+            return "q8_0";
+        case WhisperQuantization::Q5_1:
+            return "q5_1";
+        case WhisperQuantization::Q5_0:
+            return "q5_0";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace ffvoice
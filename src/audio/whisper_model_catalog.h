@@ -0,0 +1,188 @@
+/**
+ * @file whisper_model_catalog.h
+ * @brief Whisper model variants (sizes x quantizations) and budget-driven selection
+ *
+ * WhisperModelType only names the five sizes, but whisper.cpp also publishes
+ * q8_0 / q5_x quantized files of each that are 2-3x smaller with little
+ * accuracy loss. The catalog lists those files with their memory needs and a
+ * relative compute cost, estimates how fast each runs on this machine, and
+ * picks the largest one that keeps up with a given number of concurrent
+ * streams inside a memory budget.
+ *
+ * Speed estimates start from the per-size realtime factors documented on
+ * WhisperModelType and are corrected by calibration: Calibrate() decodes a
+ * synthetic clip with a real model file and rescales every estimate by how
+ * much faster or slower this machine (backend, threads) is than the default.
+ *
+ * @code
+ * WhisperModelCatalog catalog;
+ * catalog.LoadCalibration(cache + "/whisper-calibration.txt");
+ * if (!catalog.IsCalibrated()) {
+ *     catalog.CalibrateSmallestAvailable(model_dir, config);  // First run
+ *     catalog.SaveCalibration(cache + "/whisper-calibration.txt");
+ * }
+ * WhisperResourceBudget budget;
+ * budget.max_rtf = 0.5;          // Decode twice as fast as speech arrives...
+ * budget.concurrency = 8;        // ...for eight streams at once
+ * budget.max_memory_mb = 4096;
+ * WhisperModelChoice choice;
+ * if (catalog.Select(budget, choice)) {
+ *     config.model_path = model_dir + "/" + choice.variant.filename;
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "audio/whisper_processor.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Weight format of a GGML model file
+ */
+enum class WhisperQuantization {
+    F16,   ///< Original half-precision weights
+    Q8_0,  ///< 8-bit, near-lossless, ~55% of F16 size
+    Q5_1,  ///< 5-bit with offsets, ~40% of F16 size
+    Q5_0   ///< 5-bit, ~35% of F16 size (the variant published for medium / large)
+};
+
+/**
+ * @brief One downloadable model file
+ */
+struct WhisperModelVariant {
+    WhisperModelType type = WhisperModelType::TINY;
+    WhisperQuantization quantization = WhisperQuantization::F16;
+    std::string name;        ///< Catalog name, e.g. "small-q5_1"
+    std::string filename;    ///< GGML file, e.g. "ggml-small-q5_1.bin"
+    size_t file_mb = 0;      ///< Download size; also the resident weights
+    size_t state_mb = 0;     ///< Per-decode state (KV cache, mel, work buffers)
+    double relative_cost = 1.0;  ///< Compute per second of audio, tiny F16 = 1
+};
+
+/**
+ * @brief What a deployment can afford
+ */
+struct WhisperResourceBudget {
+    /// Highest acceptable realtime factor per stream: decode time / audio time
+    /// (1.0 = just keeps up, lower = faster). The inverse of
+    /// WhisperPerformanceMetrics::realtime_factor.
+    double max_rtf = 0.5;
+
+    /// Streams decoding at the same time; they share the compute, so each one
+    /// is assumed to decode concurrency times slower
+    int concurrency = 1;
+
+    /// Memory for weights plus states in MB (0 = unlimited)
+    size_t max_memory_mb = 0;
+
+    /// Weights loaded once for all streams (WhisperConfig::share_model)
+    bool share_model = true;
+
+    /// Consider q8_0 / q5_x files, not only F16
+    bool allow_quantized = true;
+
+    /// If set, only variants whose file exists in this directory
+    std::string model_dir;
+};
+
+/**
+ * @brief Result of WhisperModelCatalog::Select()
+ */
+struct WhisperModelChoice {
+    WhisperModelVariant variant;
+    double estimated_rtf = 0.0;      ///< Per stream, at the budget's concurrency
+    size_t estimated_memory_mb = 0;  ///< Weights and states for all streams
+    bool measured = false;           ///< estimated_rtf comes from calibrating this variant
+};
+
+/**
+ * @brief Catalog of Whisper model variants with calibrated speed estimates
+ *
+ * Not thread-safe; configure and calibrate it once, then Select() from one
+ * thread at a time.
+ */
+class WhisperModelCatalog {
+public:
+    WhisperModelCatalog();
+
+    /// Every variant whisper.cpp publishes, smallest size first
+    const std::vector<WhisperModelVariant>& GetVariants() const {
+        return variants_;
+    }
+
+    /// Variant by catalog name ("base", "medium-q5_0", ...), or nullptr
+    const WhisperModelVariant* Find(const std::string& name) const;
+
+    /**
+     * @brief Measure a variant's realtime factor on this machine
+     *
+     * Loads @p model_path with @p config (backend, threads), decodes a
+     * synthetic @p audio_seconds clip once to warm up and once more to time
+     * it. Calibrate with the settings the streams will use; the result is
+     * only valid for them.
+     *
+     * @return false if the model cannot be loaded or decoded (see GetLastError())
+     */
+    bool Calibrate(const WhisperModelVariant& variant, const std::string& model_path,
+                   const WhisperConfig& config, double audio_seconds = 10.0);
+
+    /**
+     * @brief First-run calibration: calibrate the smallest variant found in @p model_dir
+     * @return false if no catalog file is present there or calibration fails
+     */
+    bool CalibrateSmallestAvailable(const std::string& model_dir, const WhisperConfig& config,
+                                    double audio_seconds = 10.0);
+
+    /// Record a realtime factor measured elsewhere (e.g. by a benchmark run)
+    void SetMeasuredRtf(const std::string& name, double rtf);
+
+    /// True once any variant has a measurement
+    bool IsCalibrated() const {
+        return !measured_rtf_.empty();
+    }
+
+    /**
+     * @brief Realtime factor of one stream decoding alone
+     *
+     * The measurement if the variant was calibrated; otherwise its default
+     * estimate scaled by how calibrated variants compared to theirs.
+     */
+    double EstimateRtf(const WhisperModelVariant& variant) const;
+
+    /// Memory in MB for @p concurrency streams of @p variant
+    static size_t EstimateMemoryMb(const WhisperModelVariant& variant, int concurrency,
+                                   bool share_model);
+
+    /**
+     * @brief Pick the largest, least quantized variant that fits the budget
+     * @return false if no variant fits (see GetLastError())
+     */
+    bool Select(const WhisperResourceBudget& budget, WhisperModelChoice& choice) const;
+
+    /// Read measurements written by SaveCalibration(); unknown names are ignored
+    bool LoadCalibration(const std::string& path);
+
+    /// Write the measurements as "name rtf" lines
+    bool SaveCalibration(const std::string& path) const;
+
+    /// Short lower-case name ("f16", "q8_0", "q5_1", "q5_0")
+    static std::string GetQuantizationName(WhisperQuantization quantization);
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    std::vector<WhisperModelVariant> variants_;
+    std::map<std::string, double> measured_rtf_;  ///< By variant name
+    mutable std::string last_error_;
+};
+
+}  // namespace ffvoice
@@ -0,0 +1,235 @@
+/**
+ * @file whisper_model_registry.cpp
+ * @brief Implementation of the shared Whisper model registry and state pool
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_model_registry.h"
+
+    #include "utils/logger.h"
+
+    #include "whisper.h"
+
+    #include <filesystem>
+    #include <future>
+    #include <system_error>
+
+namespace ffvoice {
+
+// ============================================================================
+// WhisperStateLease
+// ============================================================================
+
+WhisperStateLease::~WhisperStateLease() {
+    reset();
+}
+
+WhisperStateLease::WhisperStateLease(WhisperStateLease&& other) noexcept
+    : model_(std::move(other.model_)), state_(other.state_) {
+    other.state_ = nullptr;
+}
+
+WhisperStateLease& WhisperStateLease::operator=(WhisperStateLease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        model_ = std::move(other.model_);
+        state_ = other.state_;
+        other.state_ = nullptr;
+    }
+    return *this;
+}
+
+void WhisperStateLease::reset() {
+    if (model_ && state_) {
+        model_->ReleaseState(state_);
+    }
+    state_ = nullptr;
+    model_.reset();
+}
+
+// ============================================================================
+// WhisperModel
+// ============================================================================
+
+WhisperModel::WhisperModel(std::string model_path, struct whisper_context* ctx,
+                           size_t max_states, WhisperContextSettings settings,
+                           std::string openvino_cache_dir)
+    : model_path_(std::move(model_path)),
+      ctx_(ctx),
+      max_states_(max_states),
+      settings_(std::move(settings)),
+      openvino_cache_dir_(std::move(openvino_cache_dir)) {
+}
+
+WhisperModel::~WhisperModel() {
+    // Leases hold a reference to the model, so every state is idle by now
+    for (struct whisper_state* state : idle_states_) {
+        whisper_free_state(state);
+    }
+    if (ctx_) {
+        whisper_free(ctx_);
+    }
+    LOG_INFO("WhisperModelRegistry: unloaded %s", model_path_.c_str());
+}
+
+WhisperStateLease WhisperModel::AcquireState() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    state_released_.wait(lock, [this]() {
+        return !idle_states_.empty() || max_states_ == 0 || state_count_ < max_states_;
+    });
+
+    if (!idle_states_.empty()) {
+        struct whisper_state* state = idle_states_.back();
+        idle_states_.pop_back();
+        return WhisperStateLease(shared_from_this(), state);
+    }
+
+    // Reserve the slot, then allocate outside the lock (state buffers are large)
+    ++state_count_;
+    lock.unlock();
+
+    struct whisper_state* state = whisper_init_state(ctx_);
+    if (state && !settings_.openvino_device.empty() &&
+        whisper_ctx_init_openvino_encoder_with_state(
+            ctx_, state, model_path_.c_str(), settings_.openvino_device.c_str(),
+            openvino_cache_dir_.empty() ? nullptr : openvino_cache_dir_.c_str()) != 0) {
+        whisper_free_state(state);
+        state = nullptr;
+    }
+    if (!state) {
+        lock.lock();
+        --state_count_;
+        lock.unlock();
+        state_released_.notify_one();
+        LOG_ERROR("WhisperModelRegistry: failed to create whisper state for %s",
+                  model_path_.c_str());
+        return WhisperStateLease();
+    }
+    return WhisperStateLease(shared_from_this(), state);
+}
+
+void WhisperModel::ReleaseState(struct whisper_state* state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_states_.push_back(state);
+    }
+    state_released_.notify_one();
+}
+
+size_t WhisperModel::GetStateCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_count_;
+}
+
+size_t WhisperModel::GetIdleStateCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_states_.size();
+}
+
+// ============================================================================
+// WhisperModelRegistry
+// ============================================================================
+
+WhisperModelRegistry& WhisperModelRegistry::Instance() {
+    static WhisperModelRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<WhisperModel> WhisperModelRegistry::Acquire(const std::string& model_path,
+                                                            size_t max_states,
+                                                            const WhisperAcceleration& acceleration,
+                                                            bool use_mmap) {
+    if (model_path.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Model path not set";
+        LOG_ERROR("WhisperModelRegistry: %s", last_error_.c_str());
+        return nullptr;
+    }
+
+    // Different spellings of the same file share one entry
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(model_path, ec);
+    const std::string path = ec ? model_path : canonical.string();
+
+    WhisperContextSettings settings;
+    std::string error;
+    if (!ResolveWhisperAcceleration(acceleration, ProbeWhisperCapabilities(), settings, error)) {
+        LOG_ERROR("WhisperModelRegistry: %s", error.c_str());
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = error;
+        return nullptr;
+    }
+    // One entry per file and placement: the same model on two GPUs is two models
+    const std::string key = path + "|" + settings.description +
+                            (settings.flash_attn ? "|flash-attn" : "");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = models_.find(key);
+    if (it != models_.end()) {
+        if (auto model = it->second.lock()) {
+            return model;
+        }
+        models_.erase(it);
+    }
+
+    // Another caller is loading this key: wait for its result, not for the lock
+    auto pending = loading_.find(key);
+    if (pending != loading_.end()) {
+        std::shared_future<std::shared_ptr<WhisperModel>> result = pending->second;
+        lock.unlock();
+        return result.get();
+    }
+
+    std::promise<std::shared_ptr<WhisperModel>> promise;
+    loading_[key] = promise.get_future().share();
+    lock.unlock();
+
+    // Weights only: every decode runs on a state borrowed from the pool. Loaded
+    // without the registry lock so other keys can be acquired meanwhile.
+    LOG_INFO("WhisperModelRegistry: loading %s on %s", path.c_str(),
+             settings.description.c_str());
+    std::shared_ptr<WhisperModel> model;
+    struct whisper_context* ctx = LoadWhisperContext(model_path, settings, use_mmap, false, error);
+    if (ctx) {
+        model.reset(new WhisperModel(path, ctx, max_states, settings,
+                                     acceleration.openvino_cache_dir));
+    } else {
+        LOG_ERROR("WhisperModelRegistry: %s", error.c_str());
+    }
+
+    lock.lock();
+    loading_.erase(key);
+    if (model) {
+        models_[key] = model;
+    } else {
+        last_error_ = error;
+    }
+    lock.unlock();
+
+    promise.set_value(model);
+    return model;
+}
+
+size_t WhisperModelRegistry::GetLoadedModelCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto it = models_.begin(); it != models_.end();) {
+        if (it->second.expired()) {
+            it = models_.erase(it);
+        } else {
+            ++count;
+            ++it;
+        }
+    }
+    return count;
+}
+
+std::string WhisperModelRegistry::GetLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,206 @@
+/**
+ * @file whisper_model_registry.h
+ * @brief Shared Whisper model weights with a pool of per-decode states
+ *
+ * A whisper_context holds the model weights; a whisper_state holds the
+ * per-decode buffers (mel spectrogram, KV cache, results). whisper.cpp allows
+ * many states to decode concurrently against one context, so N caption
+ * sessions only need the weights once plus one state per decode actually in
+ * flight.
+ */
+
+#pragma once
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_backend.h"
+
+    #include <condition_variable>
+    #include <cstddef>
+    #include <future>
+    #include <map>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <utility>
+    #include <vector>
+
+extern "C" {
+struct whisper_context;
+struct whisper_state;
+}
+
+namespace ffvoice {
+
+class WhisperModel;
+
+/**
+ * @brief RAII handle to a whisper_state borrowed from a WhisperModel.
+ *
+ * Move-only. The state returns to the model's pool when the lease is
+ * destroyed or reset. An empty lease (operator bool is false) means no
+ * state could be created.
+ */
+class WhisperStateLease {
+public:
+    WhisperStateLease() = default;
+    ~WhisperStateLease();
+
+    WhisperStateLease(WhisperStateLease&& other) noexcept;
+    WhisperStateLease& operator=(WhisperStateLease&& other) noexcept;
+    WhisperStateLease(const WhisperStateLease&) = delete;
+    WhisperStateLease& operator=(const WhisperStateLease&) = delete;
+
+    /// Borrowed state (nullptr for an empty lease)
+    struct whisper_state* get() const {
+        return state_;
+    }
+
+    explicit operator bool() const {
+        return state_ != nullptr;
+    }
+
+    /// Return the state to the pool early
+    void reset();
+
+private:
+    friend class WhisperModel;
+    WhisperStateLease(std::shared_ptr<WhisperModel> model, struct whisper_state* state)
+        : model_(std::move(model)), state_(state) {
+    }
+
+    std::shared_ptr<WhisperModel> model_;
+    struct whisper_state* state_ = nullptr;
+};
+
+/**
+ * @brief Model weights loaded once, plus a pool of decoder states.
+ *
+ * Obtained from WhisperModelRegistry::Acquire(). States are created lazily on
+ * first demand and reused afterwards, so memory grows with the number of
+ * concurrent decodes rather than with the number of sessions. All methods are
+ * thread-safe.
+ */
+class WhisperModel : public std::enable_shared_from_this<WhisperModel> {
+public:
+    ~WhisperModel();
+
+    WhisperModel(const WhisperModel&) = delete;
+    WhisperModel& operator=(const WhisperModel&) = delete;
+
+    /**
+     * @brief Borrow a state for one decode.
+     *
+     * Reuses an idle state when one is available, otherwise creates a new one.
+     * When max_states states already exist and all are leased, blocks until
+     * one is released.
+     *
+     * @return Lease holding the state; empty if whisper_init_state() failed
+     */
+    WhisperStateLease AcquireState();
+
+    /// Context holding the shared weights (valid for the model's lifetime)
+    struct whisper_context* GetContext() const {
+        return ctx_;
+    }
+
+    /// Model file this instance was loaded from
+    const std::string& GetModelPath() const {
+        return model_path_;
+    }
+
+    /// Where the weights live, e.g. "CUDA0 (NVIDIA L4)" or "CPU"
+    const std::string& GetBackendDescription() const {
+        return settings_.description;
+    }
+
+    /// Maximum number of states (0 = unlimited)
+    size_t GetMaxStates() const {
+        return max_states_;
+    }
+
+    /// Number of states created so far (leased + idle)
+    size_t GetStateCount() const;
+
+    /// Number of states currently waiting in the pool
+    size_t GetIdleStateCount() const;
+
+private:
+    friend class WhisperModelRegistry;
+    friend class WhisperStateLease;
+
+    WhisperModel(std::string model_path, struct whisper_context* ctx, size_t max_states,
+                 WhisperContextSettings settings, std::string openvino_cache_dir);
+
+    void ReleaseState(struct whisper_state* state);
+
+    const std::string model_path_;
+    struct whisper_context* const ctx_;
+    const size_t max_states_;
+    const WhisperContextSettings settings_;  ///< Backend the context was created for
+    const std::string openvino_cache_dir_;   ///< For each state's OpenVINO encoder
+
+    mutable std::mutex mutex_;
+    std::condition_variable state_released_;
+    std::vector<struct whisper_state*> idle_states_;  ///< States ready for reuse
+    size_t state_count_ = 0;                          ///< States created (leased + idle)
+};
+
+/**
+ * @brief Process-wide cache of loaded Whisper models, keyed by model path and backend.
+ *
+ * The registry only keeps weak references: a model is freed when the last
+ * WhisperProcessor using it is destroyed, and loaded again on the next
+ * Acquire().
+ *
+ * @code
+ * auto model = WhisperModelRegistry::Instance().Acquire("ggml-base.bin");
+ * if (model) {
+ *     WhisperStateLease lease = model->AcquireState();
+ *     whisper_full_with_state(model->GetContext(), lease.get(), params, pcm, n);
+ * }
+ * @endcode
+ */
+class WhisperModelRegistry {
+public:
+    /// Global registry instance
+    static WhisperModelRegistry& Instance();
+
+    /**
+     * @brief Get the shared model for @p model_path, loading it if necessary.
+     *
+     * Concurrent callers for the same path and backend wait for a single load;
+     * the file is read without holding the registry lock, so callers for
+     * other models are not blocked behind it.
+     *
+     * @param model_path Path to a ggml model file
+     * @param max_states Pool limit used when the model is loaded by this call
+     *                   (0 = unlimited); ignored if the model is already loaded
+     * @param acceleration Backend to load the weights on; the same file on
+     *                     different backends or GPUs is loaded once per backend
+     * @param use_mmap Parse the file from a memory mapping (see LoadWhisperContext())
+     * @return Shared model, or nullptr on failure (see GetLastError())
+     */
+    std::shared_ptr<WhisperModel> Acquire(const std::string& model_path, size_t max_states = 0,
+                                          const WhisperAcceleration& acceleration = {},
+                                          bool use_mmap = true);
+
+    /// Number of models currently alive
+    size_t GetLoadedModelCount();
+
+    /// Last load error message
+    std::string GetLastError() const;
+
+private:
+    WhisperModelRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<WhisperModel>> models_;
+    /// Loads in progress; later callers for the same key wait on the future
+    std::map<std::string, std::shared_future<std::shared_ptr<WhisperModel>>> loading_;
+    std::string last_error_;
+};
+
+}  // namespace ffvoice
+
+#endif  // ENABLE_WHISPER
@@ -5,8 +5,12 @@
 
 #include "audio/whisper_processor.h"
 
+#include "audio/transcription_cache.h"
+#include "audio/whisper_model_registry.h"
 #include "utils/audio_converter.h"
 #include "utils/logger.h"
+#include "utils/metrics.h"
+#include "utils/polyphase_resampler.h"
 #include "utils/word_grouper.h"
 
 #ifdef ENABLE_WHISPER
@@ -47,10 +51,12 @@ WhisperProcessor::WhisperProcessor(const WhisperConfig& config)
 
 WhisperProcessor::~WhisperProcessor() {
 #ifdef ENABLE_WHISPER
-    if (ctx_) {
+    // A shared context is owned by the model; dropping the reference is enough
+    if (ctx_ && !shared_model_) {
         whisper_free(ctx_);
-        ctx_ = nullptr;
     }
+    ctx_ = nullptr;
+    shared_model_.reset();
 #endif
 }
 
@@ -73,17 +79,63 @@ bool WhisperProcessor::Initialize() {
     LOG_INFO("  Model: %s", config_.model_path.c_str());
     LOG_INFO("  Language: %s", config_.language.c_str());
     LOG_INFO("  Threads: %d", config_.n_threads);
+    if (!config_.cache_dir.empty()) {
+        LOG_INFO("  Result cache: %s", config_.cache_dir.c_str());
+        cache_ = std::make_unique<TranscriptionCache>(TranscriptionCacheConfig{
+            config_.cache_dir, static_cast<uint64_t>(config_.cache_max_mb) << 20});
+    }
+
+    WhisperContextSettings settings;
+    if (!ResolveWhisperAcceleration(config_.acceleration, ProbeWhisperCapabilities(), settings,
+                                    last_error_)) {
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    LOG_INFO("  Backend: %s%s", settings.description.c_str(),
+             settings.flash_attn ? ", flash attention" : "");
+
+    if (config_.share_model) {
+        shared_model_ = WhisperModelRegistry::Instance().Acquire(
+            config_.model_path, config_.max_shared_states, config_.acceleration,
+            config_.use_mmap);
+        if (!shared_model_) {
+            last_error_ = WhisperModelRegistry::Instance().GetLastError();
+            return false;
+        }
+        ctx_ = shared_model_->GetContext();
+        backend_description_ = shared_model_->GetBackendDescription();
+        LOG_INFO("Whisper model shared via registry");
+        if (config_.warmup) {
+            Warmup();
+        }
+        return true;
+    }
 
-    // Load the model with default context params
-    struct whisper_context_params cparams = whisper_context_default_params();
-    ctx_ = whisper_init_from_file_with_params(config_.model_path.c_str(), cparams);
+    ctx_ = LoadWhisperContext(config_.model_path, settings, config_.use_mmap, true, last_error_);
     if (!ctx_) {
-        last_error_ = "Failed to load whisper model from: " + config_.model_path;
         LOG_ERROR("%s", last_error_.c_str());
         return false;
     }
 
+    // The OpenVINO encoder replaces the ggml one on the context's own state
+    if (!settings.openvino_device.empty() &&
+        whisper_ctx_init_openvino_encoder(
+            ctx_, nullptr, settings.openvino_device.c_str(),
+            config_.acceleration.openvino_cache_dir.empty()
+                ? nullptr
+                : config_.acceleration.openvino_cache_dir.c_str()) != 0) {
+        whisper_free(ctx_);
+        ctx_ = nullptr;
+        last_error_ = "Failed to load the OpenVINO encoder for: " + config_.model_path;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    backend_description_ = settings.description;
+
     LOG_INFO("Whisper model loaded successfully");
+    if (config_.warmup) {
+        Warmup();
+    }
     return true;
 #else
     last_error_ = "Whisper support not enabled (rebuild with -DENABLE_WHISPER=ON)";
@@ -92,6 +144,44 @@ bool WhisperProcessor::Initialize() {
 #endif
 }
 
+bool WhisperProcessor::Warmup() {
+#ifdef ENABLE_WHISPER
+    if (!IsInitialized()) {
+        last_error_ = "WhisperProcessor not initialized";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    // Whisper pads any input to a 30 s window, so one second of silence runs
+    // the full encoder and a decoder pass: compute buffers get allocated, GPU
+    // kernels compiled and the weights paged in before the first real request.
+    // Called directly on RunInference() to keep it out of the decode metrics.
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<float> silence(16000, 0.0f);
+    TranscriptionArena arena;
+    const int result = RunInference(GetDefaultParams(), silence.data(), silence.size(), arena);
+    detected_language_.clear();  // Whatever was "detected" in silence
+    if (result != 0) {
+        last_error_ = "Whisper warm-up failed with code: " + std::to_string(result);
+        LOG_WARNING("%s", last_error_.c_str());
+        return false;
+    }
+    const auto warmup_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    if (MetricsRegistry::IsEnabled()) {
+        MetricsRegistry::Instance().Histogram("whisper.warmup_us").Record(
+            static_cast<uint64_t>(warmup_us));
+    }
+    LOG_INFO("Whisper warm-up done in %.0f ms", static_cast<double>(warmup_us) / 1000.0);
+    return true;
+#else
+    last_error_ = "Whisper support not enabled";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+#endif
+}
+
 bool WhisperProcessor::IsInitialized() const {
 #ifdef ENABLE_WHISPER
     return ctx_ != nullptr;
@@ -111,6 +201,21 @@ bool WhisperProcessor::TranscribeFile(const std::string& audio_file,
 
     LOG_INFO("Transcribing audio file: %s", audio_file.c_str());
 
+    // A hit skips decoding the audio as well as inference
+    std::string cache_key;
+    if (cache_) {
+        const std::string content_hash = TranscriptionCache::HashFile(audio_file);
+        if (!content_hash.empty()) {
+            cache_key = TranscriptionCache::MakeKey(content_hash, config_);
+            // The entry carries the language too: GetDetectedLanguage() must describe
+            // this file, not whatever was transcribed before it
+            if (cache_->Lookup(cache_key, segments, nullptr, &detected_language_)) {
+                LOG_INFO("Transcription cache hit: %zu segments", segments.size());
+                return true;
+            }
+        }
+    }
+
     // Load and convert audio file to whisper format (16kHz, float, mono)
     std::vector<float> pcm_data;
     if (!LoadAudioFile(audio_file, pcm_data)) {
@@ -127,16 +232,17 @@ bool WhisperProcessor::TranscribeFile(const std::string& audio_file,
 
     // Run inference
     LOG_INFO("Running Whisper inference...");
-    int result = whisper_full(ctx_, params, pcm_data.data(), pcm_data.size());
+    int result = RunInference(params, pcm_data.data(), pcm_data.size(), arena_);
 
     if (result != 0) {
         last_error_ = "Whisper inference failed with code: " + std::to_string(result);
         LOG_ERROR("%s", last_error_.c_str());
         return false;
     }
-
-    // Extract transcription segments
-    ExtractSegments(segments);
+    segments.assign(arena_.begin(), arena_.end());
+    if (!cache_key.empty()) {
+        cache_->Store(cache_key, segments, nullptr, detected_language_);
+    }
 
     LOG_INFO("Transcription complete: %zu segments", segments.size());
     return true;
@@ -149,6 +255,22 @@ bool WhisperProcessor::TranscribeFile(const std::string& audio_file,
 
 bool WhisperProcessor::TranscribeBuffer(const int16_t* samples, size_t num_samples,
                                         std::vector<TranscriptionSegment>& segments) {
+#ifdef ENABLE_WHISPER
+    if (!TranscribeBuffer(samples, num_samples, arena_)) {
+        return false;
+    }
+    // Copy-assigning over the caller's existing segments reuses their storage too
+    segments.assign(arena_.begin(), arena_.end());
+    return true;
+#else
+    last_error_ = "Whisper support not enabled";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+#endif
+}
+
+bool WhisperProcessor::TranscribeBuffer(const int16_t* samples, size_t num_samples,
+                                        TranscriptionArena& arena) {
 #ifdef ENABLE_WHISPER
     if (!IsInitialized()) {
         last_error_ = "WhisperProcessor not initialized";
@@ -160,56 +282,79 @@ bool WhisperProcessor::TranscribeBuffer(const int16_t* samples, size_t num_sampl
     auto start_time = std::chrono::high_resolution_clock::now();
 
     // Convert buffer to whisper format (16kHz, float, mono)
-    std::vector<float> pcm_data;
-    if (!ConvertBufferToFloat(samples, num_samples, pcm_data)) {
+    if (!ConvertBufferToFloat(samples, num_samples, resample_buffer_)) {
         last_error_ = "Failed to convert audio buffer";
         LOG_ERROR("%s", last_error_.c_str());
         return false;
     }
 
-    auto convert_time = std::chrono::high_resolution_clock::now();
-
-    // Get default parameters
-    auto params = GetDefaultParams();
-
-    // Run inference
-    int result = whisper_full(ctx_, params, pcm_data.data(), pcm_data.size());
+    auto convert_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::high_resolution_clock::now() - start_time)
+                          .count();
 
-    auto inference_time = std::chrono::high_resolution_clock::now();
+    return DecodePcm(resample_buffer_.data(), resample_buffer_.size(), arena, convert_ms);
+#else
+    last_error_ = "Whisper support not enabled";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+#endif
+}
 
-    if (result != 0) {
-        last_error_ = "Whisper inference failed with code: " + std::to_string(result);
+bool WhisperProcessor::TranscribeBuffer(const float* samples, size_t num_samples,
+                                        std::vector<TranscriptionSegment>& segments) {
+#ifdef ENABLE_WHISPER
+    if (config_.input_sample_rate == 16000) {
+        return TranscribePcm(samples, num_samples, segments);
+    }
+    if (!IsInitialized()) {
+        last_error_ = "WhisperProcessor not initialized";
         LOG_ERROR("%s", last_error_.c_str());
         return false;
     }
 
-    // Extract transcription segments
-    ExtractSegments(segments);
-
-    auto end_time = std::chrono::high_resolution_clock::now();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    ResampleToWhisperRate(samples, num_samples, resample_buffer_);
+    auto convert_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::high_resolution_clock::now() - start_time)
+                          .count();
 
-    // Calculate performance metrics
-    if (config_.enable_performance_metrics) {
-        auto total_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-        auto convert_ms =
-            std::chrono::duration<double, std::milli>(convert_time - start_time).count();
-        auto inference_ms =
-            std::chrono::duration<double, std::milli>(inference_time - convert_time).count();
-        auto extract_ms =
-            std::chrono::duration<double, std::milli>(end_time - inference_time).count();
+    if (!DecodePcm(resample_buffer_.data(), resample_buffer_.size(), arena_, convert_ms)) {
+        return false;
+    }
+    segments.assign(arena_.begin(), arena_.end());
+    return true;
+#else
+    last_error_ = "Whisper support not enabled";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+#endif
+}
 
-        last_inference_time_ms_ = total_ms;
+bool WhisperProcessor::TranscribePcm(const float* pcm, size_t num_samples,
+                                     TranscriptionArena& arena) {
+#ifdef ENABLE_WHISPER
+    if (!IsInitialized()) {
+        last_error_ = "WhisperProcessor not initialized";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
 
-        double audio_duration_s =
-            static_cast<double>(num_samples) / static_cast<double>(config_.input_sample_rate);
-        double realtime_factor = audio_duration_s * 1000.0 / total_ms;
+    // Already in whisper format: nothing to convert
+    return DecodePcm(pcm, num_samples, arena, 0.0);
+#else
+    last_error_ = "Whisper support not enabled";
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+#endif
+}
 
-        LOG_INFO(
-            "Performance: total=%.1fms (convert=%.1fms, inference=%.1fms, extract=%.1fms), "
-            "audio=%.2fs, RTF=%.2fx",
-            total_ms, convert_ms, inference_ms, extract_ms, audio_duration_s, realtime_factor);
+bool WhisperProcessor::TranscribePcm(const float* pcm, size_t num_samples,
+                                     std::vector<TranscriptionSegment>& segments) {
+#ifdef ENABLE_WHISPER
+    if (!TranscribePcm(pcm, num_samples, arena_)) {
+        return false;
     }
-
+    segments.assign(arena_.begin(), arena_.end());
     return true;
 #else
     last_error_ = "Whisper support not enabled";
@@ -220,6 +365,86 @@ bool WhisperProcessor::TranscribeBuffer(const int16_t* samples, size_t num_sampl
 
 #ifdef ENABLE_WHISPER
 
+namespace {
+
+// Registry handles shared by every WhisperProcessor (decode threads only)
+struct WhisperRegistryMetrics {
+    MetricHistogram& convert_us = MetricsRegistry::Instance().Histogram("whisper.convert_us");
+    MetricHistogram& inference_us = MetricsRegistry::Instance().Histogram("whisper.inference_us");
+    MetricHistogram& extract_us = MetricsRegistry::Instance().Histogram("whisper.extract_us");
+    MetricHistogram& total_us = MetricsRegistry::Instance().Histogram("whisper.total_us");
+    MetricCounter& audio_us = MetricsRegistry::Instance().Counter("whisper.audio_us");
+};
+
+WhisperRegistryMetrics& GetRegistryMetrics() {
+    static WhisperRegistryMetrics metrics;
+    return metrics;
+}
+
+uint64_t MsToUs(double ms) {
+    return ms > 0.0 ? static_cast<uint64_t>(ms * 1000.0 + 0.5) : 0;
+}
+
+}  // namespace
+
+bool WhisperProcessor::DecodePcm(const float* pcm, size_t num_samples, TranscriptionArena& arena,
+                                 double convert_ms) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // Get default parameters
+    auto params = GetDefaultParams();
+
+    // Run inference and extract transcription segments
+    double inference_ms = 0.0;
+    int result = RunInference(params, pcm, num_samples, arena, &inference_ms);
+
+    if (result != 0) {
+        last_error_ = "Whisper inference failed with code: " + std::to_string(result);
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    // Calculate performance metrics
+    const bool record = MetricsRegistry::IsEnabled();
+    if (config_.enable_performance_metrics || record) {
+        auto decode_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        auto total_ms = convert_ms + decode_ms;
+        auto extract_ms = decode_ms - inference_ms;
+        double audio_duration_s = static_cast<double>(num_samples) / 16000.0;
+
+        if (record) {
+            WhisperRegistryMetrics& metrics = GetRegistryMetrics();
+            metrics.convert_us.Record(MsToUs(convert_ms));
+            metrics.inference_us.Record(MsToUs(inference_ms));
+            metrics.extract_us.Record(MsToUs(extract_ms));
+            metrics.total_us.Record(MsToUs(total_ms));
+            metrics.audio_us.Add(MsToUs(audio_duration_s * 1000.0));
+        }
+
+        if (config_.enable_performance_metrics) {
+            double realtime_factor = audio_duration_s * 1000.0 / total_ms;
+            last_inference_time_ms_ = total_ms;
+
+            last_metrics_.total_ms = total_ms;
+            last_metrics_.convert_ms = convert_ms;
+            last_metrics_.inference_ms = inference_ms;
+            last_metrics_.extract_ms = extract_ms;
+            last_metrics_.audio_duration_s = audio_duration_s;
+            last_metrics_.realtime_factor = realtime_factor;
+
+            LOG_INFO(
+                "Performance: total=%.1fms (convert=%.1fms, inference=%.1fms, extract=%.1fms), "
+                "audio=%.2fs, RTF=%.2fx",
+                total_ms, convert_ms, inference_ms, extract_ms, audio_duration_s,
+                realtime_factor);
+        }
+    }
+
+    return true;
+}
+
 struct whisper_full_params WhisperProcessor::GetDefaultParams() {
     // Use greedy sampling strategy (fastest)
     struct whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
@@ -246,14 +471,50 @@ struct whisper_full_params WhisperProcessor::GetDefaultParams() {
     // Token options
     params.token_timestamps = true;  // Enable token-level timestamps
     params.suppress_blank = true;    // Suppress blank outputs
-    params.suppress_non_speech_tokens = true;
+    params.suppress_nst = true;
 
     // Beam size (greedy = 1 beam)
     params.greedy.best_of = 1;
 
+    // Optional conditioning prompt (e.g. committed text of a streaming utterance)
+    params.initial_prompt =
+        config_.initial_prompt.empty() ? nullptr : config_.initial_prompt.c_str();
+
     return params;
 }
 
+int WhisperProcessor::RunInference(const struct whisper_full_params& params, const float* pcm,
+                                   size_t num_samples, TranscriptionArena& arena,
+                                   double* inference_ms) {
+    // Shared model: borrow a state for this decode only, so idle sessions hold none
+    WhisperStateLease lease;
+    if (shared_model_) {
+        lease = shared_model_->AcquireState();
+        if (!lease) {
+            return -1;
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const int n_samples = static_cast<int>(num_samples);
+    int result = lease ? whisper_full_with_state(ctx_, lease.get(), params, pcm, n_samples)
+                       : whisper_full(ctx_, params, pcm, n_samples);
+    if (inference_ms) {
+        *inference_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::high_resolution_clock::now() - start)
+                            .count();
+    }
+
+    if (result == 0) {
+        ExtractSegments(arena, lease.get());
+        const int lang_id = lease ? whisper_full_lang_id_from_state(lease.get())
+                                  : whisper_full_lang_id(ctx_);
+        const char* lang = lang_id >= 0 ? whisper_lang_str(lang_id) : nullptr;
+        detected_language_ = lang ? lang : "";
+    }
+    return result;
+}
+
 bool WhisperProcessor::LoadAudioFile(const std::string& filename, std::vector<float>& pcm_data) {
     // Load and convert audio file to Whisper format (16kHz, float32, mono)
     if (!AudioConverter::LoadAndConvert(filename, pcm_data, 16000)) {
@@ -277,71 +538,100 @@ bool WhisperProcessor::ConvertBufferToFloat(const int16_t* samples, size_t num_s
     }
     AudioConverter::Int16ToFloat(samples, num_samples, conversion_buffer_.data());
 
+    ResampleToWhisperRate(conversion_buffer_.data(), num_samples, pcm_data);
+    return true;
+}
+
+void WhisperProcessor::ResampleToWhisperRate(const float* samples, size_t num_samples,
+                                             std::vector<float>& pcm_data) {
     // Resample input rate -> 16kHz (Whisper's required target rate)
     const double input_rate = static_cast<double>(config_.input_sample_rate);
     size_t output_size = static_cast<size_t>(num_samples * (16000.0 / input_rate));
     pcm_data.resize(output_size);
-    AudioConverter::Resample(conversion_buffer_.data(), num_samples, config_.input_sample_rate,
-                             pcm_data.data(), output_size, 16000);
 
-    return true;
+    // The filter bank is rebuilt only when the input rate changes
+    if (!resampler_ || resampler_->GetInputRate() != config_.input_sample_rate) {
+        resampler_ = std::make_unique<PolyphaseResampler>(config_.input_sample_rate, 16000);
+    }
+    if (resampler_->IsValid()) {
+        resampler_->ResampleBuffer(samples, num_samples, pcm_data.data(), output_size);
+    } else {
+        AudioConverter::Resample(samples, num_samples, config_.input_sample_rate,
+                                 pcm_data.data(), output_size, 16000);
+    }
 }
 
-void WhisperProcessor::ExtractSegments(std::vector<TranscriptionSegment>& segments) {
-    segments.clear();
+void WhisperProcessor::ExtractSegments(TranscriptionArena& arena, struct whisper_state* state) {
+    arena.clear();
+
+    // Results live in the borrowed state for a shared model, else in the context
+    auto segment_t0 = [&](int i) {
+        return state ? whisper_full_get_segment_t0_from_state(state, i)
+                     : whisper_full_get_segment_t0(ctx_, i);
+    };
+    auto segment_t1 = [&](int i) {
+        return state ? whisper_full_get_segment_t1_from_state(state, i)
+                     : whisper_full_get_segment_t1(ctx_, i);
+    };
 
     // Get number of segments
-    const int n_segments = whisper_full_n_segments(ctx_);
+    const int n_segments =
+        state ? whisper_full_n_segments_from_state(state) : whisper_full_n_segments(ctx_);
 
     for (int i = 0; i < n_segments; ++i) {
         // Get segment text
-        const char* text = whisper_full_get_segment_text(ctx_, i);
+        const char* text = state ? whisper_full_get_segment_text_from_state(state, i)
+                                 : whisper_full_get_segment_text(ctx_, i);
 
         // Get timestamps (in centiseconds, convert to milliseconds)
-        const int64_t t0 = whisper_full_get_segment_t0(ctx_, i) * 10;  // centiseconds -> ms
-        const int64_t t1 = whisper_full_get_segment_t1(ctx_, i) * 10;
+        const int64_t t0 = segment_t0(i) * 10;  // centiseconds -> ms
+        const int64_t t1 = segment_t1(i) * 10;
 
         // Skip empty segments
         if (!text || std::strlen(text) == 0) {
             continue;
         }
 
-        // Create segment
-        TranscriptionSegment segment(t0, t1, text);
+        // Fill the next arena slot in place, reusing its text/words storage
+        TranscriptionSegment& segment = arena.Append();
+        segment.start_ms = t0;
+        segment.end_ms = t1;
+        segment.text.assign(text);
+
+        // Collect the segment's real (non-special) tokens: their mean
+        // probability is the segment's confidence, and with word timestamps
+        // the BPE sub-word tokens are grouped into whole words
+        const int n_tokens =
+            state ? whisper_full_n_tokens_from_state(state, i) : whisper_full_n_tokens(ctx_, i);
+
+        token_buffer_.clear();
+        for (int j = 0; j < n_tokens; ++j) {
+            const whisper_token_data token_data =
+                state ? whisper_full_get_token_data_from_state(state, i, j)
+                      : whisper_full_get_token_data(ctx_, i, j);
+
+            // Skip special tokens (timestamp/marker tokens, not real text)
+            if (token_data.id >= whisper_token_eot(ctx_)) {
+                continue;
+            }
 
-        // Optionally extract per-word timestamps from the segment's tokens
-        if (config_.word_timestamps) {
-            // Whisper emits BPE sub-word tokens; collect the real (non-special)
-            // ones and group them into whole words.
-            const int n_tokens = whisper_full_n_tokens(ctx_, i);
-
-            std::vector<WordToken> tokens;
-            tokens.reserve(static_cast<size_t>(n_tokens > 0 ? n_tokens : 0));
-
-            for (int j = 0; j < n_tokens; ++j) {
-                const whisper_token_data token_data = whisper_full_get_token_data(ctx_, i, j);
-
-                // Skip special tokens (timestamp/marker tokens, not real text)
-                if (token_data.id >= whisper_token_eot(ctx_)) {
-                    continue;
-                }
-
-                // Skip tokens with no text
-                const char* token_text = whisper_full_get_token_text(ctx_, i, j);
-                if (!token_text || std::strlen(token_text) == 0) {
-                    continue;
-                }
-
-                // Token timestamps are in centiseconds -> convert to milliseconds
-                tokens.push_back(
-                    WordToken{token_text, token_data.t0 * 10, token_data.t1 * 10, token_data.p});
+            // Skip tokens with no text
+            const char* token_text = state
+                                         ? whisper_full_get_token_text_from_state(ctx_, state, i, j)
+                                         : whisper_full_get_token_text(ctx_, i, j);
+            if (!token_text || std::strlen(token_text) == 0) {
+                continue;
             }
 
-            segment.words = GroupTokensIntoWords(tokens);
+            // Token timestamps are in centiseconds -> convert to milliseconds
+            token_buffer_.push_back(
+                WordToken{token_text, token_data.t0 * 10, token_data.t1 * 10, token_data.p});
         }
 
-        // Add to results
-        segments.push_back(segment);
+        segment.confidence = MeanTokenProbability(token_buffer_);
+        if (config_.word_timestamps) {
+            GroupTokensIntoWords(token_buffer_, segment.words);
+        }
 
         // Optional: Print segment
         if (config_.print_timestamps) {
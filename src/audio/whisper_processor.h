@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include "audio/whisper_backend.h"
+
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -16,12 +19,18 @@
 extern "C" {
 // Forward declarations for whisper.cpp C API
 struct whisper_context;
+struct whisper_state;
 struct whisper_full_params;
 }
 #endif
 
 namespace ffvoice {
 
+class PolyphaseResampler;
+class TranscriptionCache;
+class WhisperModel;
+struct WordToken;
+
 /**
  * @brief A single transcribed word with its own timestamps
  *
@@ -32,6 +41,8 @@ struct Word {
     int64_t end_ms;     ///< Word end time in milliseconds
     std::string text;   ///< Word text (keeps Whisper's leading space, if any)
     float probability;  ///< Mean token probability for this word (0.0-1.0)
+    /// Speaker index, 0-based; -1 = unknown / diarization not run
+    int32_t speaker_id = -1;
 
     Word() : start_ms(0), end_ms(0), probability(0.0f) {
     }
@@ -48,7 +59,7 @@ struct TranscriptionSegment {
     int64_t start_ms;         ///< Start time in milliseconds
     int64_t end_ms;           ///< End time in milliseconds
     std::string text;         ///< Transcribed text content
-    float confidence;         ///< Confidence score (0.0-1.0)
+    float confidence;         ///< Mean token probability (0.0-1.0)
     std::vector<Word> words;  ///< Per-word timestamps (empty unless word_timestamps enabled)
     /// Speaker index, 0-based; -1 = unknown / diarization not run
     int32_t speaker_id = -1;
@@ -61,6 +72,101 @@ struct TranscriptionSegment {
     }
 };
 
+/**
+ * @brief Reusable output storage for WhisperProcessor::TranscribeBuffer()
+ *
+ * Clearing a std::vector of segments destroys every segment's text and word
+ * buffers, so the next transcription allocates them all again. The arena never
+ * destroys its slots: clear() only resets the count, and Append() hands out a
+ * previously used slot with its capacity intact. Keep one arena per session
+ * and, once it has seen a typical utterance, refilling it does no heap
+ * allocation.
+ *
+ * @code
+ * TranscriptionArena arena;
+ * while (capturing) {
+ *     processor.TranscribeBuffer(pcm, n, arena);
+ *     for (const auto& seg : arena) {
+ *         Display(seg.text);
+ *     }
+ * }
+ * @endcode
+ */
+class TranscriptionArena {
+public:
+    /// Number of segments currently held
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    /// Number of slots allocated so far (grows, never shrinks)
+    size_t capacity() const {
+        return slots_.size();
+    }
+
+    const TranscriptionSegment& operator[](size_t index) const {
+        return slots_[index];
+    }
+
+    const TranscriptionSegment* begin() const {
+        return slots_.data();
+    }
+
+    const TranscriptionSegment* end() const {
+        return slots_.data() + size_;
+    }
+
+    /// Forget all segments, keeping their storage for reuse
+    void clear() {
+        size_ = 0;
+    }
+
+    /**
+     * @brief Append an empty segment, reusing a previously allocated slot if any
+     *
+     * The returned segment has default field values; its text and words keep
+     * the capacity left by earlier use. The reference is invalidated by the
+     * next Append().
+     */
+    TranscriptionSegment& Append() {
+        if (size_ == slots_.size()) {
+            slots_.emplace_back();
+        }
+        TranscriptionSegment& segment = slots_[size_++];
+        segment.start_ms = 0;
+        segment.end_ms = 0;
+        segment.text.clear();
+        segment.confidence = 0.0f;
+        segment.words.clear();
+        segment.speaker_id = -1;
+        return segment;
+    }
+
+private:
+    std::vector<TranscriptionSegment> slots_;  ///< Slots [0, size_) are live
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Timing breakdown of the last TranscribeBuffer() call
+ *
+ * Filled only when WhisperConfig::enable_performance_metrics is true. With
+ * MetricsRegistry enabled, the same timings of every call also go to the
+ * whisper.* histograms (see utils/metrics.h).
+ */
+struct WhisperPerformanceMetrics {
+    double total_ms = 0.0;          ///< Whole call
+    double convert_ms = 0.0;        ///< int16 -> float and resampling (0 for TranscribePcm)
+    double inference_ms = 0.0;      ///< whisper_full itself
+    double extract_ms = 0.0;        ///< Copying segments/words out of whisper.cpp
+    double audio_duration_s = 0.0;  ///< Duration of the transcribed audio
+    double realtime_factor = 0.0;   ///< Audio duration / total time (>1 = faster than realtime)
+};
+
 /**
  * @brief Whisper model size/type selection
  */
@@ -90,6 +196,34 @@ struct WhisperConfig {
     bool enable_performance_metrics = false;               ///< Enable performance timing metrics
     bool word_timestamps = false;   ///< Populate per-word timestamps in each segment
     int input_sample_rate = 48000;  ///< Sample rate (Hz) of TranscribeBuffer() input
+    std::string initial_prompt;     ///< Text that conditions decoding (empty = none)
+
+    /**
+     * @brief Share model weights with other processors using the same model_path.
+     *
+     * The model is loaded once through WhisperModelRegistry and every decode
+     * borrows a whisper_state from its pool, so concurrent sessions cost one
+     * state per decode in flight instead of one full model each.
+     */
+    bool share_model = false;
+
+    /// Pool limit for the shared model (0 = unlimited); used by whichever processor loads it
+    size_t max_shared_states = 0;
+
+    /// Backend, GPU and flash attention; see ProbeWhisperCapabilities() for what is available
+    WhisperAcceleration acceleration;
+
+    /// Parse the model from a memory mapping: read through the shared page cache, not stdio
+    bool use_mmap = true;
+
+    /// Run Warmup() at the end of Initialize()
+    bool warmup = false;
+
+    /// Reuse TranscribeFile() results from this directory (see TranscriptionCache); empty = off
+    std::string cache_dir;
+
+    /// Size bound of cache_dir in MiB; least recently used entries are evicted above it
+    size_t cache_max_mb = 256;
 };
 
 /**
@@ -142,9 +276,20 @@ public:
      */
     bool Initialize();
 
+    /**
+     * @brief Decode one second of silence so the first real decode is not the slow one
+     *
+     * The first whisper_full() call allocates compute buffers, compiles GPU
+     * kernels and faults the weights in; a server or live captioner pays that
+     * here instead of on its first request. Not counted in the decode metrics.
+     *
+     * @return false if not initialized or the decode fails
+     */
+    bool Warmup();
+
     /**
      * @brief Transcribe an audio file (offline mode)
-     * @param audio_file Path to audio file (WAV/FLAC)
+     * @param audio_file Path to audio file (WAV, FLAC, MP3, M4A, Opus, ...)
      * @param segments Output vector of transcription segments
      * @return true if successful, false otherwise
      */
@@ -160,6 +305,101 @@ public:
     bool TranscribeBuffer(const int16_t* samples, size_t num_samples,
                           std::vector<TranscriptionSegment>& segments);
 
+    /**
+     * @brief Transcribe audio buffer into a caller-owned reusable arena
+     *
+     * Same as the vector overload, but the result is written into @p arena,
+     * whose slots are reused from call to call. Together with the processor's
+     * own scratch buffers this keeps the ffvoice side of the call free of heap
+     * allocations once warm; only whisper.cpp's internal work remains.
+     *
+     * @param samples Audio samples (int16_t format)
+     * @param num_samples Number of samples (total, not per channel)
+     * @param arena Output segments (cleared first)
+     * @return true if successful, false otherwise
+     */
+    bool TranscribeBuffer(const int16_t* samples, size_t num_samples, TranscriptionArena& arena);
+
+    /**
+     * @brief Transcribe float audio at input_sample_rate
+     *
+     * Like the int16 TranscribeBuffer(), for samples already in [-1, 1]:
+     * resampled to 16 kHz unless input_sample_rate is 16000, in which case it
+     * is TranscribePcm().
+     *
+     * @param samples Audio samples in [-1, 1], mono, at input_sample_rate
+     * @param num_samples Number of samples
+     * @param segments Output vector of transcription segments
+     * @return true if successful, false otherwise
+     */
+    bool TranscribeBuffer(const float* samples, size_t num_samples,
+                          std::vector<TranscriptionSegment>& segments);
+
+    /**
+     * @brief Transcribe audio that is already in Whisper format (16kHz, float32, mono)
+     *
+     * Skips conversion and resampling, so a caller that converts its audio
+     * once as it arrives (e.g. LiveCaptioner) does not pay for it again on
+     * every decode. input_sample_rate is ignored.
+     *
+     * @param pcm Samples in [-1, 1] at 16kHz, mono
+     * @param num_samples Number of samples
+     * @param arena Output segments (cleared first)
+     * @return true if successful, false otherwise
+     */
+    bool TranscribePcm(const float* pcm, size_t num_samples, TranscriptionArena& arena);
+
+    /**
+     * @brief Transcribe Whisper-format audio into a segment vector
+     * @param pcm Samples in [-1, 1] at 16kHz, mono
+     * @param num_samples Number of samples
+     * @param segments Output vector of transcription segments
+     * @return true if successful, false otherwise
+     */
+    bool TranscribePcm(const float* pcm, size_t num_samples,
+                       std::vector<TranscriptionSegment>& segments);
+
+    /**
+     * @brief Set the prompt used to condition subsequent transcriptions
+     *
+     * Typically the already-confirmed text of an utterance, so that a decode of
+     * the remaining audio continues it consistently. Pass an empty string to
+     * clear it.
+     *
+     * @param prompt Prompt text
+     */
+    void SetInitialPrompt(const std::string& prompt) {
+        config_.initial_prompt = prompt;
+    }
+
+    /**
+     * @brief Set the language of subsequent transcriptions
+     * @param language Language code ("en", "zh", ...) or "auto" to detect it per call
+     */
+    void SetLanguage(const std::string& language) {
+        config_.language = language;
+    }
+
+    /**
+     * @brief Language the last successful transcription was decoded in
+     *
+     * The detected language when WhisperConfig::language is "auto", else the
+     * configured one.
+     *
+     * @return Language code, e.g. "en" (empty before the first transcription)
+     */
+    const std::string& GetDetectedLanguage() const {
+        return detected_language_;
+    }
+
+    /**
+     * @brief Set the sample rate of subsequent TranscribeBuffer() input
+     * @param sample_rate Input sample rate in Hz
+     */
+    void SetInputSampleRate(int sample_rate) {
+        config_.input_sample_rate = sample_rate;
+    }
+
     /**
      * @brief Check if processor is initialized
      * @return true if initialized, false otherwise
@@ -174,6 +414,22 @@ public:
         return last_error_;
     }
 
+    /**
+     * @brief Where the model runs, e.g. "CUDA0 (NVIDIA L4)" or "CPU"
+     * @return Backend description (empty before a successful Initialize())
+     */
+    const std::string& GetBackendDescription() const {
+        return backend_description_;
+    }
+
+    /**
+     * @brief Result cache used by TranscribeFile()
+     * @return The cache, or nullptr when config.cache_dir is empty
+     */
+    TranscriptionCache* GetCache() const {
+        return cache_.get();
+    }
+
     /**
      * @brief Get the last inference time in milliseconds
      * @return Inference time in ms (only valid if enable_performance_metrics is true)
@@ -182,6 +438,14 @@ public:
         return last_inference_time_ms_;
     }
 
+    /**
+     * @brief Get the timing breakdown of the last TranscribeBuffer() or TranscribePcm() call
+     * @return Metrics (only valid if enable_performance_metrics is true)
+     */
+    const WhisperPerformanceMetrics& GetLastPerformanceMetrics() const {
+        return last_metrics_;
+    }
+
     /**
      * @brief Get the model type name string
      * @param type Model type enum
@@ -192,14 +456,22 @@ public:
 private:
     WhisperConfig config_;
     std::string last_error_;
-    double last_inference_time_ms_ = 0.0;  ///< Last inference time in milliseconds
+    std::string backend_description_;            ///< See GetBackendDescription()
+    double last_inference_time_ms_ = 0.0;        ///< Last inference time in milliseconds
+    WhisperPerformanceMetrics last_metrics_;     ///< See GetLastPerformanceMetrics()
+    std::string detected_language_;              ///< See GetDetectedLanguage()
+    std::unique_ptr<TranscriptionCache> cache_;  ///< Set when config_.cache_dir is not empty
 
 #ifdef ENABLE_WHISPER
-    struct whisper_context* ctx_ = nullptr;
+    struct whisper_context* ctx_ = nullptr;       ///< Own context, or the shared model's context
+    std::shared_ptr<WhisperModel> shared_model_;  ///< Set when config_.share_model is true
 
     // Reusable buffers to avoid repeated allocations
-    mutable std::vector<float> conversion_buffer_;  ///< Reusable buffer for audio conversion
-    mutable std::vector<float> resample_buffer_;    ///< Reusable buffer for resampling
+    mutable std::vector<float> conversion_buffer_;   ///< Reusable buffer for audio conversion
+    mutable std::vector<float> resample_buffer_;     ///< Reusable buffer for resampling
+    std::unique_ptr<PolyphaseResampler> resampler_;  ///< Built for input_sample_rate on first use
+    std::vector<WordToken> token_buffer_;            ///< Reusable per-segment token list
+    TranscriptionArena arena_;                       ///< Scratch output of the vector overloads
 
     /**
      * @brief Get default whisper parameters
@@ -225,11 +497,45 @@ private:
     bool ConvertBufferToFloat(const int16_t* samples, size_t num_samples,
                               std::vector<float>& pcm_data);
 
+    /**
+     * @brief Resample float input-rate mono audio to whisper format
+     * @param samples Input samples in [-1, 1] at input_sample_rate
+     * @param num_samples Number of samples
+     * @param pcm_data Output PCM data (16kHz, float32, mono)
+     */
+    void ResampleToWhisperRate(const float* samples, size_t num_samples,
+                               std::vector<float>& pcm_data);
+
+    /**
+     * @brief Decode Whisper-format audio and record performance metrics
+     * @param pcm PCM data (16kHz, float32, mono)
+     * @param num_samples Number of samples
+     * @param arena Output segments (filled on success)
+     * @param convert_ms Time the caller spent converting the input (for metrics)
+     * @return true if successful, false otherwise
+     */
+    bool DecodePcm(const float* pcm, size_t num_samples, TranscriptionArena& arena,
+                   double convert_ms);
+
+    /**
+     * @brief Run whisper_full on the own context or on a borrowed shared state
+     * @param params Inference parameters
+     * @param pcm PCM data (16kHz, float32, mono)
+     * @param num_samples Number of samples
+     * @param arena Output segments (filled on success)
+     * @param inference_ms Optional output: time spent in whisper_full, excluding extraction
+     * @return whisper_full result code (0 on success), or -1 if no state was available
+     */
+    int RunInference(const struct whisper_full_params& params, const float* pcm,
+                     size_t num_samples, TranscriptionArena& arena,
+                     double* inference_ms = nullptr);
+
     /**
      * @brief Extract transcription results from whisper context
-     * @param segments Output vector of transcription segments
+     * @param arena Output segments (cleared first; slots are reused)
+     * @param state State holding the results, or nullptr for the context's own state
      */
-    void ExtractSegments(std::vector<TranscriptionSegment>& segments);
+    void ExtractSegments(TranscriptionArena& arena, struct whisper_state* state = nullptr);
 #endif
 };
 
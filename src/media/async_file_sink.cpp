@@ -0,0 +1,368 @@
+/**
+ * @file async_file_sink.cpp
+ * @brief AsyncFileSink implementation
+ */
+
+#include "media/async_file_sink.h"
+
+#include "utils/logger.h"
+#include "utils/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace ffvoice {
+
+namespace {
+// Samples the writer thread pulls from the ring per iteration (~100 ms at 48 kHz mono)
+constexpr size_t kWriterBlockSize = 4800;
+
+// How long the writer thread sleeps when the ring is empty
+constexpr auto kIdleSleep = std::chrono::milliseconds(5);
+}  // namespace
+
+/// One output file and its encoder
+struct AsyncFileSink::Output {
+    Output(const WavWriter::Config& wav_config, const FlacWriter::Config& flac_config,
+           const OpusWriter::Config& opus_config)
+        : wav(wav_config), flac(flac_config), opus(opus_config) {}
+
+    WavWriter wav;
+    FlacWriter flac;
+    OpusWriter opus;
+    std::string path;
+};
+
+AsyncFileSink::AsyncFileSink(const Config& config)
+    : config_(config), ring_buffer_(config.ring_buffer_capacity) {
+}
+
+AsyncFileSink::~AsyncFileSink() {
+    Close();
+}
+
+std::string AsyncFileSink::GetSegmentPath(const std::string& filename, size_t index) {
+    // Number before the extension, unless the "extension" is part of a directory name
+    const size_t dot = filename.find_last_of('.');
+    const size_t slash = filename.find_last_of("/\\");
+    const size_t split =
+        (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? filename.size()
+                                                                                   : dot;
+    char number[24];
+    std::snprintf(number, sizeof(number), "_%04zu", index);
+    return filename.substr(0, split) + number + filename.substr(split);
+}
+
+bool AsyncFileSink::Open(const std::string& filename) {
+    if (open_) {
+        Close();
+    }
+
+    last_error_.clear();
+    ring_buffer_.clear();
+    samples_written_.store(0, std::memory_order_relaxed);
+    dropped_samples_.store(0, std::memory_order_relaxed);
+    high_water_mark_.store(0, std::memory_order_relaxed);
+    original_bytes_ = 0.0;
+    compressed_bytes_ = 0.0;
+
+    // Segment length in whole frames; the tighter of the two limits wins
+    const size_t channels = static_cast<size_t>(std::max(config_.channels, 1));
+    size_t segment_frames = 0;
+    if (config_.segment_seconds > 0.0) {
+        segment_frames = static_cast<size_t>(
+            std::llround(config_.segment_seconds * static_cast<double>(config_.sample_rate)));
+    }
+    if (config_.segment_bytes > 0) {
+        const size_t frames =
+            static_cast<size_t>(config_.segment_bytes / (sizeof(int16_t) * channels));
+        segment_frames = segment_frames > 0 ? std::min(segment_frames, frames) : frames;
+    }
+    if ((config_.segment_seconds > 0.0 || config_.segment_bytes > 0) && segment_frames == 0) {
+        segment_frames = 1;
+    }
+    segment_samples_ = segment_frames * channels;
+    filename_ = filename;
+
+    const std::string first = segment_samples_ > 0 ? GetSegmentPath(filename, 0) : filename;
+    current_ = OpenOutput(first);
+    if (!current_) {
+        last_error_ = "AsyncFileSink: failed to open output file: " + first;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    current_samples_ = 0;
+    num_files_.store(1, std::memory_order_relaxed);
+
+    open_ = true;
+    if (segment_samples_ > 0) {
+        {
+            std::lock_guard<std::mutex> lock(rotator_mutex_);
+            standby_.reset();
+            retiring_.clear();
+            standby_failed_ = false;
+            rotator_stop_ = false;
+            next_index_ = 1;
+        }
+        rotator_thread_ = std::thread(&AsyncFileSink::RotatorLoop, this);
+    }
+    running_.store(true, std::memory_order_release);
+    writer_thread_ = std::thread(&AsyncFileSink::WriterLoop, this);
+
+    LOG_INFO("AsyncFileSink: writing %s (ring=%zu samples)", first.c_str(),
+             ring_buffer_.capacity());
+    if (segment_samples_ > 0) {
+        LOG_INFO("AsyncFileSink: new file every %zu frames", segment_frames);
+    }
+    return true;
+}
+
+std::unique_ptr<AsyncFileSink::Output> AsyncFileSink::OpenOutput(const std::string& path) const {
+    // Segments have a known length: let FLAC reserve seek points for it
+    FlacWriter::Config flac_config = config_.flac;
+    if (flac_config.total_frames_estimate == 0 && segment_samples_ > 0) {
+        flac_config.total_frames_estimate = segment_samples_ / std::max(config_.channels, 1);
+    }
+    auto output = std::make_unique<Output>(config_.wav, flac_config, config_.opus);
+    output->path = path;
+
+    bool ok = false;
+    if (config_.format == Format::WAV) {
+        ok = output->wav.Open(path, config_.sample_rate, config_.channels,
+                              config_.bits_per_sample);
+    } else if (config_.format == Format::FLAC) {
+        ok = output->flac.Open(path, config_.sample_rate, config_.channels,
+                               config_.bits_per_sample, config_.compression_level);
+    } else {
+        ok = output->opus.Open(path, config_.sample_rate, config_.channels);
+    }
+    if (!ok) {
+        return nullptr;
+    }
+    return output;
+}
+
+void AsyncFileSink::CloseOutput(Output& output) {
+    if (config_.format == Format::WAV) {
+        output.wav.Close();
+    } else if (config_.format == Format::FLAC) {
+        const double original = static_cast<double>(output.flac.GetTotalSamples()) *
+                                static_cast<double>(config_.bits_per_sample / 8);
+        output.flac.Close();
+        const double ratio = output.flac.GetCompressionRatio();
+        if (ratio > 0.0) {
+            original_bytes_ += original;
+            compressed_bytes_ += original / ratio;
+        }
+    } else {
+        output.opus.Close();
+        original_bytes_ += static_cast<double>(output.opus.GetTotalSamples() * sizeof(int16_t));
+        compressed_bytes_ += static_cast<double>(output.opus.GetEncodedBytes());
+    }
+    if (config_.on_file_closed) {
+        config_.on_file_closed(output.path);
+    }
+}
+
+size_t AsyncFileSink::Write(const int16_t* samples, size_t num_samples) {
+    if (!open_ || !samples || num_samples == 0) {
+        return 0;
+    }
+
+    // On overflow queue whole frames only: a split frame would shift every
+    // later sample onto the wrong channel
+    size_t to_queue = num_samples;
+    const size_t free_samples = ring_buffer_.available_write();
+    if (free_samples < num_samples) {
+        const size_t channels = static_cast<size_t>(std::max(config_.channels, 1));
+        to_queue = free_samples / channels * channels;
+    }
+    const size_t written = ring_buffer_.push_bulk(samples, to_queue);
+    const bool metrics = MetricsRegistry::IsEnabled();
+    if (written < num_samples) {
+        dropped_samples_.fetch_add(num_samples - written, std::memory_order_relaxed);
+        if (metrics) {
+            dropped_metric_->Add(num_samples - written);
+        }
+    }
+
+    // Only the producer updates the high-water mark, so a plain load/store is enough.
+    const size_t fill = ring_buffer_.size();
+    if (fill > high_water_mark_.load(std::memory_order_relaxed)) {
+        high_water_mark_.store(fill, std::memory_order_relaxed);
+    }
+    if (metrics) {
+        ring_fill_->Record(fill * 100 / ring_buffer_.capacity());
+    }
+
+    return written;
+}
+
+void AsyncFileSink::Close() {
+    if (!open_) {
+        return;
+    }
+
+    // The writer thread drains whatever is left in the ring before it exits.
+    running_.store(false, std::memory_order_release);
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+
+    // The rotation thread closes the segments it was handed before it exits;
+    // the next segment it opened ahead is not needed.
+    std::unique_ptr<Output> unused;
+    if (rotator_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(rotator_mutex_);
+            rotator_stop_ = true;
+        }
+        rotator_cv_.notify_all();
+        rotator_thread_.join();
+        unused = std::move(standby_);
+    }
+    if (unused) {
+        if (config_.format == Format::WAV) {
+            unused->wav.Close();
+        } else if (config_.format == Format::FLAC) {
+            unused->flac.Close();
+        } else {
+            unused->opus.Close();
+        }
+        std::remove(unused->path.c_str());
+    }
+
+    CloseOutput(*current_);
+    current_.reset();
+    open_ = false;
+
+    const size_t dropped = GetDroppedSamples();
+    if (dropped > 0) {
+        LOG_WARNING("AsyncFileSink: dropped %zu samples (ring high-water mark %zu / %zu)", dropped,
+                    GetHighWaterMark(), ring_buffer_.capacity());
+    }
+}
+
+double AsyncFileSink::GetCompressionRatio() const {
+    if (config_.format != Format::WAV) {
+        return compressed_bytes_ > 0.0 ? original_bytes_ / compressed_bytes_ : 0.0;
+    }
+    return 1.0;
+}
+
+void AsyncFileSink::WriterLoop() {
+    FFVOICE_TRACE_THREAD_NAME("AsyncFileSink writer");
+    ApplyThreadPolicy(config_.writer_thread_policy, "AsyncFileSink writer");
+    std::vector<int16_t> block(kWriterBlockSize);
+
+    while (true) {
+        // Read the flag before draining so every sample pushed before Close()
+        // is written: once running_ is false, one more full drain follows.
+        const bool running = running_.load(std::memory_order_acquire);
+
+        size_t n = 0;
+        while ((n = ring_buffer_.pop_bulk(block.data(), block.size())) > 0) {
+            ScopedTimer timer(*write_time_);
+            const size_t written = WriteToFile(block.data(), n);
+            if (MetricsRegistry::IsEnabled()) {
+                written_metric_->Add(written);
+            }
+        }
+
+        if (!running) {
+            break;
+        }
+        std::this_thread::sleep_for(kIdleSleep);
+    }
+}
+
+void AsyncFileSink::RotatorLoop() {
+    ApplyThreadPolicy(config_.writer_thread_policy, "AsyncFileSink rotator");
+    std::unique_lock<std::mutex> lock(rotator_mutex_);
+    while (true) {
+        rotator_cv_.wait(lock, [this] {
+            return rotator_stop_ || !retiring_.empty() || (!standby_ && !standby_failed_);
+        });
+
+        // Finish closed segments first: Close() relies on it
+        if (!retiring_.empty()) {
+            std::vector<std::unique_ptr<Output>> finished = std::move(retiring_);
+            retiring_.clear();
+            lock.unlock();
+            for (auto& output : finished) {
+                CloseOutput(*output);
+            }
+            lock.lock();
+            continue;
+        }
+        if (rotator_stop_) {
+            break;
+        }
+
+        // Open the next segment ahead of time
+        const std::string path = GetSegmentPath(filename_, next_index_);
+        lock.unlock();
+        std::unique_ptr<Output> output = OpenOutput(path);
+        lock.lock();
+        if (output) {
+            standby_ = std::move(output);
+            ++next_index_;
+        } else {
+            LOG_ERROR("AsyncFileSink: failed to open next segment: %s", path.c_str());
+            standby_failed_ = true;
+        }
+        rotator_cv_.notify_all();
+    }
+}
+
+bool AsyncFileSink::Rotate() {
+    std::unique_lock<std::mutex> lock(rotator_mutex_);
+    // Normally the next file is long open by now; if not, wait for it here
+    // (the ring keeps absorbing capture meanwhile).
+    rotator_cv_.wait(lock, [this] { return standby_ || standby_failed_; });
+    if (!standby_) {
+        standby_failed_ = false;  // Try again at the next block
+        rotator_cv_.notify_all();
+        return false;
+    }
+
+    retiring_.push_back(std::move(current_));
+    current_ = std::move(standby_);
+    current_samples_ = 0;
+    num_files_.fetch_add(1, std::memory_order_relaxed);
+    lock.unlock();
+    rotator_cv_.notify_all();
+    return true;
+}
+
+size_t AsyncFileSink::WriteToFile(const int16_t* samples, size_t num_samples) {
+    size_t total = 0;
+    for (size_t pos = 0; pos < num_samples;) {
+        // Roll over lazily, so a recording that ends on a boundary leaves no
+        // empty file. If the next file cannot be opened the audio stays in
+        // the current one rather than being dropped.
+        size_t n = num_samples - pos;
+        if (segment_samples_ > 0 && (current_samples_ < segment_samples_ || Rotate())) {
+            n = std::min(n, segment_samples_ - current_samples_);
+        }
+
+        size_t written = 0;
+        if (config_.format == Format::WAV) {
+            written = current_->wav.WriteSamples(samples + pos, n);
+        } else if (config_.format == Format::FLAC) {
+            written = current_->flac.WriteSamples(samples + pos, n);
+        } else {
+            written = current_->opus.WriteSamples(samples + pos, n);
+        }
+        samples_written_.fetch_add(written, std::memory_order_release);
+        current_samples_ += n;
+        total += written;
+        pos += n;
+    }
+    return total;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,271 @@
+/**
+ * @file async_file_sink.h
+ * @brief Asynchronous WAV/FLAC/Opus recording sink fed through a lock-free ring buffer
+ */
+
+#pragma once
+
+#include "media/flac_writer.h"
+#include "media/opus_writer.h"
+#include "media/wav_writer.h"
+#include "utils/metrics.h"
+#include "utils/ring_buffer.h"
+#include "utils/thread_policy.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Moves file encoding off the real-time audio thread.
+ *
+ * Write() only copies samples into a lock-free SPSC ring buffer, so it is safe
+ * to call from the PortAudio capture callback. A dedicated writer thread drains
+ * the ring and runs the WAV, FLAC or Opus encoder, which means disk stalls and
+ * expensive encodes no longer cause input overflows.
+ *
+ * When the writer thread falls behind and the ring fills up, the samples that
+ * do not fit are dropped (never blocking the caller) and counted. The
+ * high-water mark reports the peak ring occupancy so the capacity can be sized
+ * per host.
+ *
+ * For long-running capture the recording can be split into segments that
+ * roll over by duration or size (segment_seconds / segment_bytes). The split
+ * is sample-exact on a frame boundary, so no audio is lost or repeated. A
+ * rotation thread opens the next file while the current one is being
+ * written, and closes finished files. The writer thread then only swaps
+ * pointers at the boundary, and the capture path is never involved.
+ *
+ * Typical usage:
+ * @code
+ * AsyncFileSink::Config cfg;
+ * cfg.format = AsyncFileSink::Format::FLAC;
+ * cfg.sample_rate = 48000;
+ *
+ * AsyncFileSink sink(cfg);
+ * if (!sink.Open("out.flac")) { ... }
+ *
+ * // From the audio callback:
+ * sink.Write(samples, num_samples);
+ *
+ * sink.Close();  // Drains the ring and finalizes the file
+ * @endcode
+ */
+class AsyncFileSink {
+public:
+    /**
+     * @brief Output container / encoder
+     */
+    enum class Format {
+        WAV,   ///< RIFF PCM via WavWriter
+        FLAC,  ///< Lossless FLAC via FlacWriter
+        OPUS   ///< Lossy Opus in Ogg/WebM via OpusWriter
+    };
+
+    /**
+     * @brief Sink configuration
+     */
+    struct Config {
+        Format format = Format::WAV;
+        int sample_rate = 48000;
+        int channels = 1;
+        int bits_per_sample = 16;
+        int compression_level = 5;  ///< FLAC only (0-8)
+        WavWriter::Config wav;      ///< WAV only: write-behind buffer and header checkpoints
+        FlacWriter::Config flac;    ///< FLAC only: encoder threads and seek table
+        OpusWriter::Config opus;    ///< Opus only: bitrate, container, packet callback
+
+        /// Ring buffer capacity in samples (default = 2 s of 48 kHz mono)
+        size_t ring_buffer_capacity = 96000;
+
+        /// Start a new file after this much audio (seconds); 0 = no duration limit
+        double segment_seconds = 0.0;
+
+        /// Start a new file once one holds this much PCM (bytes, before FLAC
+        /// compression); 0 = no size limit
+        uint64_t segment_bytes = 0;
+
+        /// Called with the path of every finished file, on a sink thread
+        /// (never the capture thread), e.g. to upload it
+        std::function<void(const std::string&)> on_file_closed = nullptr;
+
+        /// Priority and cores of the writer and segment rotator threads
+        ThreadPolicy writer_thread_policy;
+    };
+
+    explicit AsyncFileSink(const Config& config);
+
+    /**
+     * @brief Destructor — calls Close() if still open.
+     */
+    ~AsyncFileSink();
+
+    // Non-copyable (owns a thread and a file)
+    AsyncFileSink(const AsyncFileSink&) = delete;
+    AsyncFileSink& operator=(const AsyncFileSink&) = delete;
+
+    /**
+     * @brief Open the output file and start the writer thread
+     *
+     * When segmenting, the files are named GetSegmentPath(filename, 0),
+     * GetSegmentPath(filename, 1), ...
+     *
+     * @param filename Output file path
+     * @return true if successful (see GetLastError() on failure)
+     */
+    bool Open(const std::string& filename);
+
+    /**
+     * @brief Path of segment @p index: "rec.wav" -> "rec_0000.wav", "rec_0001.wav", ...
+     */
+    static std::string GetSegmentPath(const std::string& filename, size_t index);
+
+    /**
+     * @brief Queue samples for writing. Lock-free and non-blocking.
+     *
+     * Must be called from a single producer thread (typically the audio
+     * callback). Samples that do not fit into the ring are dropped, whole
+     * frames at a time, so the channel order of later samples is kept.
+     *
+     * @param samples Pointer to interleaved int16_t PCM samples
+     * @param num_samples Number of samples (not frames!)
+     * @return Number of samples queued (0..num_samples)
+     */
+    size_t Write(const int16_t* samples, size_t num_samples);
+
+    /**
+     * @brief Drain all queued samples, stop the writer thread and finalize the file
+     *
+     * Safe to call multiple times. Must not race with Write().
+     */
+    void Close();
+
+    /**
+     * @brief Check if the sink is open
+     */
+    bool IsOpen() const {
+        return open_;
+    }
+
+    /**
+     * @brief Get total samples written to the file by the writer thread
+     */
+    size_t GetTotalSamples() const {
+        return samples_written_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of samples dropped because the ring was full
+     */
+    size_t GetDroppedSamples() const {
+        return dropped_samples_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the peak ring occupancy observed by Write(), in samples
+     */
+    size_t GetHighWaterMark() const {
+        return high_water_mark_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of files started so far (1 unless segmenting)
+     */
+    size_t GetNumFiles() const {
+        return num_files_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the ring buffer capacity in samples
+     */
+    size_t GetCapacity() const {
+        return ring_buffer_.capacity();
+    }
+
+    /**
+     * @brief Get compression ratio of the finished FLAC/Opus file(s) (1.0 for WAV)
+     *
+     * Only meaningful after Close().
+     */
+    double GetCompressionRatio() const;
+
+    /**
+     * @brief Return the last error message (empty string if no error)
+     */
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    struct Output;
+
+    /**
+     * @brief Writer thread entry point
+     */
+    void WriterLoop();
+
+    /**
+     * @brief Rotation thread entry point: opens the next segment, closes finished ones
+     */
+    void RotatorLoop();
+
+    /**
+     * @brief Pass one block to the active encoder, rolling over at segment boundaries
+     */
+    size_t WriteToFile(const int16_t* samples, size_t num_samples);
+
+    /**
+     * @brief Switch to the pre-opened next segment (writer thread)
+     * @return false if it could not be opened; writing continues in the current file
+     */
+    bool Rotate();
+
+    std::unique_ptr<Output> OpenOutput(const std::string& path) const;
+    void CloseOutput(Output& output);
+
+    Config config_;
+    std::string last_error_;
+    bool open_ = false;
+    std::string filename_;
+    size_t segment_samples_ = 0;  ///< Samples per segment; 0 = a single file
+
+    std::unique_ptr<Output> current_;  ///< File being written (writer thread)
+    size_t current_samples_ = 0;       ///< Samples in current_ (writer thread)
+    RingBuffer<int16_t> ring_buffer_;  ///< Audio thread -> writer thread
+
+    std::thread writer_thread_;
+    std::atomic<bool> running_{false};  ///< Signals the writer thread to run
+
+    std::thread rotator_thread_;
+    std::mutex rotator_mutex_;                       ///< Guards standby_ .. next_index_
+    std::condition_variable rotator_cv_;             ///< Writer <-> rotation thread
+    std::unique_ptr<Output> standby_;                ///< Next segment, already open
+    std::vector<std::unique_ptr<Output>> retiring_;  ///< Finished segments to close
+    bool standby_failed_ = false;                    ///< Opening the next segment failed
+    bool rotator_stop_ = false;                      ///< Set by Close()
+    size_t next_index_ = 0;                          ///< Segment the rotation thread opens next
+
+    double original_bytes_ = 0.0;    ///< PCM bytes of the closed files
+    double compressed_bytes_ = 0.0;  ///< FLAC bytes of the closed files
+
+    std::atomic<size_t> num_files_{0};        ///< Written by the writer thread
+    std::atomic<size_t> samples_written_{0};  ///< Written by the writer thread
+    std::atomic<size_t> dropped_samples_{0};  ///< Written by the producer
+    std::atomic<size_t> high_water_mark_{0};  ///< Written by the producer
+
+    MetricHistogram* ring_fill_ = &MetricsRegistry::Instance().Histogram("sink.ring_fill_pct");
+    MetricCounter* dropped_metric_ = &MetricsRegistry::Instance().Counter("sink.dropped_samples");
+    MetricHistogram* write_time_ = &MetricsRegistry::Instance().Histogram("sink.write_us");
+    MetricCounter* written_metric_ = &MetricsRegistry::Instance().Counter("sink.written_samples");
+};
+
+}  // namespace ffvoice
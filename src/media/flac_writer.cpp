@@ -6,19 +6,66 @@
 #include "media/flac_writer.h"
 
 #include "utils/logger.h"
+#include "utils/trace.h"
 
+#include <FLAC/export.h>
+#include <FLAC/metadata.h>
 #include <FLAC/stream_encoder.h>
 
 #include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <thread>
 
 namespace ffvoice {
 
+namespace {
+
+// FLAC streams carry at most 8 channels
+constexpr int kMaxChannels = 8;
+
+}  // namespace
+
+FlacWriter::FlacWriter() : FlacWriter(Config{}) {
+}
+
+FlacWriter::FlacWriter(const Config& config) : config_(config) {
+}
+
 FlacWriter::~FlacWriter() {
     Close();
 }
 
+unsigned FlacWriter::GetNumThreads() const {
+    if (config_.num_threads > 0) {
+        return static_cast<unsigned>(config_.num_threads);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool FlacWriter::PrepareSeekTable() {
+    const uint64_t spacing =
+        static_cast<uint64_t>(sample_rate_) * static_cast<uint64_t>(config_.seek_point_seconds);
+    if (spacing == 0 || spacing > UINT32_MAX) {
+        return false;
+    }
+
+    seek_table_ = FLAC__metadata_object_new(FLAC__METADATA_TYPE_SEEKTABLE);
+    if (!seek_table_ ||
+        !FLAC__metadata_object_seektable_template_append_spaced_points_by_samples(
+            seek_table_, static_cast<uint32_t>(spacing), config_.total_frames_estimate) ||
+        !FLAC__metadata_object_seektable_template_sort(seek_table_, true) ||
+        !FLAC__stream_encoder_set_metadata(encoder_, &seek_table_, 1)) {
+        LOG_WARNING("FLAC: Could not prepare a seek table; writing without one");
+        if (seek_table_) {
+            FLAC__metadata_object_delete(seek_table_);
+            seek_table_ = nullptr;
+        }
+        return false;
+    }
+    return true;
+}
+
 bool FlacWriter::Open(const std::string& filename, int sample_rate, int channels,
                       int bits_per_sample, int compression_level) {
     if (encoder_) {
@@ -27,7 +74,7 @@ bool FlacWriter::Open(const std::string& filename, int sample_rate, int channels
     }
 
     // Validate parameters
-    if (channels < 1 || channels > 2) {
+    if (channels < 1 || channels > kMaxChannels) {
         LOG_ERROR("FLAC: Invalid channel count: %d", channels);
         return false;
     }
@@ -67,6 +114,28 @@ bool FlacWriter::Open(const std::string& filename, int sample_rate, int channels
     // Enable verify mode for debugging
     FLAC__stream_encoder_set_verify(encoder_, true);
 
+    // A known length fixes STREAMINFO's total and lets seek points be reserved
+    if (config_.total_frames_estimate > 0) {
+        FLAC__stream_encoder_set_total_samples_estimate(encoder_, config_.total_frames_estimate);
+        if (config_.seek_point_seconds > 0) {
+            PrepareSeekTable();
+        }
+    }
+
+    const unsigned threads = GetNumThreads();
+    if (threads > 1) {
+#if defined(FLAC_API_VERSION_CURRENT) && FLAC_API_VERSION_CURRENT >= 14
+        const uint32_t status = FLAC__stream_encoder_set_num_threads(encoder_, threads);
+        if (status != FLAC__STREAM_ENCODER_SET_NUM_THREADS_OK) {
+            LOG_WARNING("FLAC: %u encoder threads refused (status %u); encoding on one thread",
+                        threads, status);
+        }
+#else
+        LOG_WARNING("FLAC: libFLAC %s has no threaded encoder; encoding on one thread",
+                    FLAC__VERSION_STRING);
+#endif
+    }
+
     // Initialize encoder
     FLAC__StreamEncoderInitStatus init_status =
         FLAC__stream_encoder_init_file(encoder_, filename.c_str(), nullptr, nullptr);
@@ -76,17 +145,22 @@ bool FlacWriter::Open(const std::string& filename, int sample_rate, int channels
                   FLAC__StreamEncoderInitStatusString[init_status]);
         FLAC__stream_encoder_delete(encoder_);
         encoder_ = nullptr;
+        if (seek_table_) {
+            FLAC__metadata_object_delete(seek_table_);
+            seek_table_ = nullptr;
+        }
         has_error_ = true;
         return false;
     }
 
-    LOG_INFO("FLAC encoder opened: %s (%dHz, %dch, %d-bit, level=%d)", filename.c_str(),
-             sample_rate, channels, bits_per_sample, compression_level);
+    LOG_INFO("FLAC encoder opened: %s (%dHz, %dch, %d-bit, level=%d, threads=%u)",
+             filename.c_str(), sample_rate, channels, bits_per_sample, compression_level, threads);
 
     return true;
 }
 
 size_t FlacWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
+    FFVOICE_TRACE_SCOPE("FlacWriter::WriteSamples");
     if (!encoder_) {
         LOG_ERROR("FLAC encoder not open");
         has_error_ = true;
@@ -105,16 +179,14 @@ size_t FlacWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
 
     // Convert int16_t samples to FLAC__int32 for encoding
     // FLAC always works with 32-bit integers internally
-    std::vector<FLAC__int32> buffer(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        buffer[i] = samples[i];
-    }
+    buffer_.resize(num_samples);
+    std::copy(samples, samples + num_samples, buffer_.begin());
 
     // Calculate number of frames
     size_t num_frames = num_samples / channels_;
 
     // Process samples
-    bool success = FLAC__stream_encoder_process_interleaved(encoder_, buffer.data(), num_frames);
+    bool success = FLAC__stream_encoder_process_interleaved(encoder_, buffer_.data(), num_frames);
 
     if (!success) {
         FLAC__StreamEncoderState state = FLAC__stream_encoder_get_state(encoder_);
@@ -142,6 +214,12 @@ void FlacWriter::Close() {
     // Clean up
     FLAC__stream_encoder_delete(encoder_);
     encoder_ = nullptr;
+    if (seek_table_) {
+        FLAC__metadata_object_delete(seek_table_);
+        seek_table_ = nullptr;
+    }
+    buffer_.clear();
+    buffer_.shrink_to_fit();
 
     // Get file size for compression ratio
     std::ifstream file(filename_, std::ios::binary | std::ios::ate);
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <FLAC/metadata.h>
 #include <FLAC/stream_encoder.h>
 
 #include <cstdint>
@@ -18,11 +19,34 @@ namespace ffvoice {
  * @brief FLAC file writer for lossless audio compression
  *
  * Uses libFLAC to write compressed audio files with configurable
- * compression level. Supports mono/stereo, various sample rates.
+ * compression level. Supports 1-8 channels, various sample rates.
+ *
+ * With Config::num_threads > 1 the frames are encoded on libFLAC's own worker
+ * pool (libFLAC 1.5 and later), which splits the stream into independent
+ * frames, encodes them in parallel and writes them back in order with the
+ * usual STREAMINFO and seek table. Older libFLAC builds log a warning and
+ * encode on the calling thread.
  */
 class FlacWriter {
 public:
-    FlacWriter() = default;
+    /**
+     * @brief Encoder tuning beyond the per-file Open() parameters
+     */
+    struct Config {
+        /// Encoder threads; 0 = one per hardware thread, 1 = encode on the caller
+        int num_threads = 1;
+
+        /// Expected length in frames (samples per channel), e.g. when
+        /// re-encoding a file of known size; 0 = unknown. Lets libFLAC size
+        /// STREAMINFO up front and enables the seek table below.
+        uint64_t total_frames_estimate = 0;
+
+        /// Seek point spacing (seconds) when total_frames_estimate is set; 0 = none
+        int seek_point_seconds = 10;
+    };
+
+    FlacWriter();
+    explicit FlacWriter(const Config& config);
     ~FlacWriter();
 
     // Disable copy
@@ -33,7 +57,7 @@ public:
      * @brief Open FLAC file for writing
      * @param filename Output file path
      * @param sample_rate Sample rate in Hz (e.g., 48000)
-     * @param channels Number of channels (1=mono, 2=stereo)
+     * @param channels Number of interleaved channels (1-8)
      * @param bits_per_sample Bits per sample (16 or 24)
      * @param compression_level Compression level 0-8 (5=default, 8=max)
      * @return true if successful
@@ -93,7 +117,16 @@ public:
     double GetCompressionRatio() const;
 
 private:
+    /// Threads to ask libFLAC for (Config::num_threads with 0 resolved)
+    unsigned GetNumThreads() const;
+
+    /// Seek table template for the expected length; false leaves the file without one
+    bool PrepareSeekTable();
+
+    Config config_;
     FLAC__StreamEncoder* encoder_ = nullptr;
+    FLAC__StreamMetadata* seek_table_ = nullptr;  // Must outlive the encoder
+    std::vector<FLAC__int32> buffer_;             // WriteSamples() conversion scratch
     std::string filename_;
     int sample_rate_ = 0;
     int channels_ = 0;
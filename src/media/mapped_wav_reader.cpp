@@ -0,0 +1,325 @@
+/**
+ * @file mapped_wav_reader.cpp
+ * @brief Memory-mapped WAV reader implementation
+ */
+
+#include "media/mapped_wav_reader.h"
+
+#include "utils/audio_kernels.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ffvoice {
+
+namespace {
+
+// Input frames converted per step; keeps the scratch buffers a few pages long
+constexpr size_t kBlockFrames = 4096;
+
+// WAV file format structures
+#pragma pack(push, 1)
+struct WavHeader {
+    char riff[4];        // "RIFF" (or "RF64")
+    uint32_t file_size;  // File size - 8
+    char wave[4];        // "WAVE"
+};
+
+struct WavChunkHeader {
+    char id[4];     // Chunk ID
+    uint32_t size;  // Chunk size
+};
+
+struct WavFormatChunk {
+    uint16_t format;           // Audio format (1 = PCM)
+    uint16_t channels;         // Number of channels
+    uint32_t sample_rate;      // Sample rate
+    uint32_t byte_rate;        // Byte rate
+    uint16_t block_align;      // Block align
+    uint16_t bits_per_sample;  // Bits per sample
+};
+#pragma pack(pop)
+
+}  // namespace
+
+MappedWavReader::MappedWavReader() = default;
+
+MappedWavReader::~MappedWavReader() {
+    Close();
+}
+
+bool MappedWavReader::Open(const std::string& filename, int target_sample_rate) {
+    Close();
+    last_error_.clear();
+
+    if (target_sample_rate <= 0) {
+        return Fail("Invalid target sample rate: " + std::to_string(target_sample_rate));
+    }
+    target_sample_rate_ = target_sample_rate;
+
+    // Map the whole file read-only; pages are read front to back, so the
+    // kernel may read ahead aggressively
+    if (!file_.Open(filename)) {
+        last_error_ = file_.GetLastError();  // Already logged by MappedFile
+        Close();
+        return false;
+    }
+    if (file_.GetSize() < sizeof(WavHeader)) {
+        return Fail("WAV file too small: " + filename);
+    }
+
+    const uint8_t* base = file_.GetData();
+    const uint8_t* end = base + file_.GetSize();
+
+    // Read RIFF header (or RF64, as WavWriter::Config::rf64 writes past 4 GB)
+    WavHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    const bool riff = std::memcmp(header.riff, "RIFF", 4) == 0 ||
+                      std::memcmp(header.riff, "RF64", 4) == 0;
+    if (!riff || std::memcmp(header.wave, "WAVE", 4) != 0) {
+        return Fail("Invalid WAV file format: " + filename);
+    }
+
+    // Walk the chunks up to "data"; the format chunk must come first
+    WavFormatChunk fmt;
+    bool found_fmt = false;
+    const uint8_t* pos = base + sizeof(header);
+    while (static_cast<size_t>(end - pos) >= sizeof(WavChunkHeader)) {
+        WavChunkHeader chunk;
+        std::memcpy(&chunk, pos, sizeof(chunk));
+        pos += sizeof(chunk);
+        const size_t available = static_cast<size_t>(end - pos);
+
+        if (std::memcmp(chunk.id, "fmt ", 4) == 0) {
+            if (chunk.size < sizeof(fmt) || available < sizeof(fmt)) {
+                return Fail("Truncated WAV format chunk: " + filename);
+            }
+            std::memcpy(&fmt, pos, sizeof(fmt));
+            found_fmt = true;
+        } else if (std::memcmp(chunk.id, "data", 4) == 0 && found_fmt) {
+            if (fmt.format != 1) {  // Only support PCM
+                return Fail("Unsupported WAV format: " + std::to_string(fmt.format) +
+                            " (only PCM supported)");
+            }
+            if (fmt.bits_per_sample != 16) {
+                return Fail("Unsupported bit depth: " + std::to_string(fmt.bits_per_sample) +
+                            " (only 16-bit supported)");
+            }
+            if (fmt.channels != 1 && fmt.channels != 2) {
+                return Fail("Unsupported channel count: " + std::to_string(fmt.channels));
+            }
+            if (fmt.sample_rate == 0) {
+                return Fail("Invalid WAV sample rate: 0");
+            }
+
+            sample_rate_ = static_cast<int>(fmt.sample_rate);
+            channels_ = fmt.channels;
+            samples_ = pos;
+
+            // Recorders that were interrupted leave a size larger than the file
+            // (or 0xFFFFFFFF while streaming): use the bytes that actually exist.
+            // RF64 keeps the real size in ds64; its data chunk always runs to the end.
+            const size_t data_bytes = chunk.size == 0xFFFFFFFFu
+                                          ? available
+                                          : std::min(static_cast<size_t>(chunk.size), available);
+            num_frames_ = data_bytes / (sizeof(int16_t) * static_cast<size_t>(channels_));
+
+            if (sample_rate_ != target_sample_rate_) {
+                resampler_ =
+                    std::make_unique<PolyphaseResampler>(sample_rate_, target_sample_rate_);
+            }
+            open_ = true;
+            Rewind();
+
+            LOG_INFO("Mapped WAV: %d Hz, %d channels, %zu frames", sample_rate_, channels_,
+                     num_frames_);
+            return true;
+        }
+
+        // Skip the chunk body (chunks are padded to an even size)
+        const size_t skip = static_cast<size_t>(chunk.size) + (chunk.size & 1u);
+        if (skip > available) {
+            break;
+        }
+        pos += skip;
+    }
+
+    return Fail("No data chunk found in WAV file: " + filename);
+}
+
+void MappedWavReader::Close() {
+    file_.Close();
+    samples_ = nullptr;
+    open_ = false;
+    sample_rate_ = 0;
+    channels_ = 0;
+    num_frames_ = 0;
+    resampler_.reset();
+    next_frame_ = 0;
+    flushed_ = false;
+    tail_.clear();
+    tail_pos_ = 0;
+}
+
+size_t MappedWavReader::GetOutputSize() const {
+    if (!open_ || sample_rate_ == target_sample_rate_) {
+        return num_frames_;
+    }
+    return static_cast<size_t>(num_frames_ * static_cast<double>(target_sample_rate_) /
+                               sample_rate_);
+}
+
+bool MappedWavReader::ReadAll(std::vector<float>& pcm_data) {
+    if (!open_) {
+        last_error_ = "MappedWavReader not open";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+
+    Rewind();
+    pcm_data.resize(GetOutputSize());
+
+    if (resampler_ && !resampler_->IsValid()) {
+        // Rate pair beyond the polyphase filter bank: fall back to linear
+        // interpolation, which needs the whole mono input at once
+        std::vector<float> mono(num_frames_);
+        for (size_t frame = 0; frame < num_frames_; frame += kBlockFrames) {
+            const size_t count = std::min(kBlockFrames, num_frames_ - frame);
+            ConvertFrames(frame, count);
+            std::memcpy(mono.data() + frame, mono_buffer_.data(), count * sizeof(float));
+        }
+        const double ratio = static_cast<double>(sample_rate_) / target_sample_rate_;
+        for (size_t i = 0; i < pcm_data.size(); ++i) {
+            const double src_pos = i * ratio;
+            const size_t src_index = static_cast<size_t>(src_pos);
+            if (src_index + 1 >= mono.size()) {
+                pcm_data[i] = mono.back();
+            } else {
+                const double frac = src_pos - src_index;
+                pcm_data[i] = static_cast<float>(mono[src_index] * (1.0 - frac) +
+                                                 mono[src_index + 1] * frac);
+            }
+        }
+        next_frame_ = num_frames_;
+        flushed_ = true;
+        return true;
+    }
+
+    // Like PolyphaseResampler::ResampleBuffer: zero-fill if the filter ends short
+    const size_t written = Read(pcm_data.data(), pcm_data.size());
+    std::fill(pcm_data.begin() + static_cast<std::ptrdiff_t>(written), pcm_data.end(), 0.0f);
+    return true;
+}
+
+bool MappedWavReader::NextChunk(std::vector<float>& chunk, size_t max_output_samples) {
+    chunk.clear();
+    if (!open_ || max_output_samples == 0) {
+        return false;
+    }
+    if (resampler_ && !resampler_->IsValid()) {
+        // Linear fallback has no streaming form: the first chunk is the whole file
+        if (next_frame_ > 0 || flushed_) {
+            return false;
+        }
+        return ReadAll(chunk) && !chunk.empty();
+    }
+
+    chunk.resize(max_output_samples);
+    chunk.resize(Read(chunk.data(), max_output_samples));
+    return !chunk.empty();
+}
+
+void MappedWavReader::Rewind() {
+    next_frame_ = 0;
+    flushed_ = false;
+    tail_.clear();
+    tail_pos_ = 0;
+    if (resampler_) {
+        resampler_->Reset();
+    }
+}
+
+bool MappedWavReader::Fail(const std::string& message) {
+    Close();
+    last_error_ = message;
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+}
+
+void MappedWavReader::ConvertFrames(size_t frame, size_t count) {
+    const size_t num_samples = count * static_cast<size_t>(channels_);
+    const uint8_t* bytes = samples_ + frame * static_cast<size_t>(channels_) * sizeof(int16_t);
+
+    // The data chunk is only guaranteed an even offset after odd-sized chunks
+    // are padded; copy the block when a writer did not pad
+    const int16_t* input = reinterpret_cast<const int16_t*>(bytes);
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(int16_t) != 0) {
+        aligned_buffer_.resize(num_samples);
+        std::memcpy(aligned_buffer_.data(), bytes, num_samples * sizeof(int16_t));
+        input = aligned_buffer_.data();
+    }
+
+    mono_buffer_.resize(count);
+    const AudioKernels& kernels = GetAudioKernels();
+    if (channels_ == 2) {
+        kernels.int16_stereo_to_mono(input, count, mono_buffer_.data());
+    } else {
+        kernels.int16_to_float(input, count, mono_buffer_.data());
+    }
+}
+
+size_t MappedWavReader::Read(float* output, size_t capacity) {
+    size_t written = 0;
+    while (written < capacity) {
+        // Resampler tail left over from the previous call
+        if (tail_pos_ < tail_.size()) {
+            const size_t n = std::min(tail_.size() - tail_pos_, capacity - written);
+            std::memcpy(output + written, tail_.data() + tail_pos_, n * sizeof(float));
+            tail_pos_ += n;
+            written += n;
+            continue;
+        }
+
+        const size_t room = capacity - written;
+        if (next_frame_ < num_frames_) {
+            size_t count = std::min(kBlockFrames, num_frames_ - next_frame_);
+            if (!resampler_) {
+                count = std::min(count, room);
+                ConvertFrames(next_frame_, count);
+                std::memcpy(output + written, mono_buffer_.data(), count * sizeof(float));
+                written += count;
+            } else {
+                // Feed only about as much input as the remaining room needs, so
+                // the resampler's pending input stays bounded across chunks
+                const size_t needed = room * static_cast<size_t>(sample_rate_) /
+                                          static_cast<size_t>(target_sample_rate_) +
+                                      1;
+                count = std::min(count, needed);
+                ConvertFrames(next_frame_, count);
+                written += resampler_->Process(mono_buffer_.data(), count, output + written, room);
+            }
+            next_frame_ += count;
+            continue;
+        }
+
+        if (!resampler_ || flushed_) {
+            break;
+        }
+
+        // Input exhausted: drain what is still pending, then keep the filter
+        // tail for the following calls
+        const size_t drained = resampler_->Process(nullptr, 0, output + written, room);
+        written += drained;
+        if (drained == room) {
+            break;
+        }
+        tail_.resize(resampler_->GetMaxOutputSize(resampler_->GetLatency()));
+        tail_.resize(resampler_->Flush(tail_.data(), tail_.size()));
+        tail_pos_ = 0;
+        flushed_ = true;
+    }
+    return written;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,148 @@
+/**
+ * @file mapped_wav_reader.h
+ * @brief Memory-mapped 16-bit PCM WAV reader with on-the-fly Whisper conversion
+ */
+
+#pragma once
+
+#include "utils/mapped_file.h"
+#include "utils/polyphase_resampler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Reads a 16-bit PCM WAV file through a read-only memory mapping
+ *
+ * The samples are never copied as a whole: ReadAll() and NextChunk()
+ * convert, downmix and resample straight from the mapped pages, a few
+ * thousand frames at a time. A long recording therefore costs one output
+ * buffer (ReadAll) or one chunk (NextChunk) instead of several full-length
+ * intermediate copies; the mapped pages are file-backed and can be dropped
+ * by the OS under memory pressure.
+ *
+ * @code
+ * MappedWavReader reader;
+ * if (reader.Open("meeting.wav", 16000)) {
+ *     std::vector<float> chunk;
+ *     while (reader.NextChunk(chunk, 16000 * 30)) {  // 30 s at a time
+ *         Feed(chunk);
+ *     }
+ * }
+ * @endcode
+ *
+ * Mono and stereo files are supported; stereo is averaged to mono.
+ */
+class MappedWavReader {
+public:
+    MappedWavReader();
+    ~MappedWavReader();
+
+    // Disable copy
+    MappedWavReader(const MappedWavReader&) = delete;
+    MappedWavReader& operator=(const MappedWavReader&) = delete;
+
+    /**
+     * @brief Map a WAV file and parse its header
+     * @param filename Path to a 16-bit PCM WAV file (mono or stereo)
+     * @param target_sample_rate Rate of the converted output (Hz)
+     * @return true if successful, false otherwise (see GetLastError())
+     */
+    bool Open(const std::string& filename, int target_sample_rate = 16000);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    bool IsOpen() const {
+        return open_;
+    }
+
+    /// Sample rate of the file (Hz)
+    int GetSampleRate() const {
+        return sample_rate_;
+    }
+
+    /// Channel count of the file
+    int GetChannels() const {
+        return channels_;
+    }
+
+    /// Frames in the data chunk
+    size_t GetNumFrames() const {
+        return num_frames_;
+    }
+
+    /// File duration in seconds
+    double GetDurationSeconds() const {
+        return sample_rate_ > 0 ? static_cast<double>(num_frames_) / sample_rate_ : 0.0;
+    }
+
+    /// Converted output size for the whole file (mono, at the target rate)
+    size_t GetOutputSize() const;
+
+    /**
+     * @brief Convert the whole file into @p pcm_data (mono float at the target rate)
+     *
+     * @p pcm_data is the only full-length buffer allocated. Rewinds the
+     * chunk iterator.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool ReadAll(std::vector<float>& pcm_data);
+
+    /**
+     * @brief Convert the next part of the file (chunked iteration)
+     *
+     * Output is continuous across calls: concatenating every chunk gives the
+     * same samples as ReadAll() (to within the final sample).
+     *
+     * @param chunk Output samples (replaced; at most @p max_output_samples)
+     * @param max_output_samples Chunk size in output samples
+     * @return false once the whole file has been returned
+     */
+    bool NextChunk(std::vector<float>& chunk, size_t max_output_samples);
+
+    /// Restart NextChunk() from the beginning of the file
+    void Rewind();
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    /// Convert input frames [frame, frame + count) to mono float in mono_buffer_
+    void ConvertFrames(size_t frame, size_t count);
+
+    /// Produce up to @p capacity output samples from the read position onwards
+    size_t Read(float* output, size_t capacity);
+
+    /// Record @p message as the last error, unmap and return false
+    bool Fail(const std::string& message);
+
+    std::string last_error_;
+    bool open_ = false;
+    int target_sample_rate_ = 16000;
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    size_t num_frames_ = 0;
+
+    MappedFile file_;                   ///< The whole file, mapped read-only
+    const uint8_t* samples_ = nullptr;  ///< Start of the data chunk (may be unaligned)
+
+    std::unique_ptr<PolyphaseResampler> resampler_;  ///< Null when no resampling is needed
+    size_t next_frame_ = 0;                          ///< Next input frame to convert
+    bool flushed_ = false;                           ///< Resampler tail already produced
+    std::vector<float> tail_;                        ///< Resampler tail not yet returned
+    size_t tail_pos_ = 0;                            ///< Next sample of tail_ to return
+    std::vector<int16_t> aligned_buffer_;            ///< Copy of unaligned input blocks
+    std::vector<float> mono_buffer_;                 ///< One converted input block
+};
+
+}  // namespace ffvoice
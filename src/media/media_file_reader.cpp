@@ -0,0 +1,298 @@
+/**
+ * @file media_file_reader.cpp
+ * @brief FFmpeg streaming decoder implementation
+ */
+
+#include "media/media_file_reader.h"
+
+#include "utils/logger.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/error.h>
+#include <libswresample/swresample.h>
+}
+
+#include <algorithm>
+#include <cstring>
+
+namespace ffvoice {
+
+namespace {
+
+std::string AvError(int err) {
+    char buf[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(err, buf, sizeof(buf));
+    return buf;
+}
+
+}  // namespace
+
+MediaFileReader::MediaFileReader() = default;
+
+MediaFileReader::~MediaFileReader() {
+    Close();
+}
+
+bool MediaFileReader::Open(const std::string& filename, int target_sample_rate) {
+    Close();
+    last_error_.clear();
+
+    if (target_sample_rate <= 0) {
+        return Fail("Invalid target sample rate: " + std::to_string(target_sample_rate));
+    }
+    target_sample_rate_ = target_sample_rate;
+
+    int err = avformat_open_input(&format_ctx_, filename.c_str(), nullptr, nullptr);
+    if (err < 0) {
+        format_ctx_ = nullptr;  // Freed by avformat_open_input on failure
+        return Fail("Failed to open " + filename + ": " + AvError(err));
+    }
+    err = avformat_find_stream_info(format_ctx_, nullptr);
+    if (err < 0) {
+        return Fail("Failed to read stream info of " + filename + ": " + AvError(err));
+    }
+
+    const AVCodec* codec = nullptr;
+    stream_index_ = av_find_best_stream(format_ctx_, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (stream_index_ < 0 || !codec) {
+        return Fail("No decodable audio stream in " + filename);
+    }
+    const AVStream* stream = format_ctx_->streams[stream_index_];
+
+    codec_ctx_ = avcodec_alloc_context3(codec);
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!codec_ctx_ || !frame_ || !packet_) {
+        return Fail("Out of memory opening " + filename);
+    }
+    err = avcodec_parameters_to_context(codec_ctx_, stream->codecpar);
+    if (err >= 0) {
+        err = avcodec_open2(codec_ctx_, codec, nullptr);
+    }
+    if (err < 0) {
+        return Fail("Failed to open " + std::string(codec->name) + " decoder: " + AvError(err));
+    }
+
+    sample_rate_ = codec_ctx_->sample_rate;
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+    channels_ = codec_ctx_->ch_layout.nb_channels;
+#else
+    channels_ = codec_ctx_->channels;
+#endif
+    codec_name_ = codec->name;
+    if (sample_rate_ <= 0 || channels_ <= 0) {
+        return Fail("Audio stream of " + filename + " has no sample rate or channel count");
+    }
+
+    if (stream->duration != AV_NOPTS_VALUE) {
+        duration_s_ = static_cast<double>(stream->duration) * av_q2d(stream->time_base);
+    } else if (format_ctx_->duration != AV_NOPTS_VALUE) {
+        duration_s_ = static_cast<double>(format_ctx_->duration) / AV_TIME_BASE;
+    }
+
+    if (!InitResampler()) {
+        return false;
+    }
+
+    LOG_INFO("MediaFileReader: %s (%s, %d Hz, %d channels, %.1f s)", filename.c_str(),
+             codec_name_.c_str(), sample_rate_, channels_, duration_s_);
+    return true;
+}
+
+bool MediaFileReader::InitResampler() {
+    swr_free(&swr_ctx_);
+
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+    AVChannelLayout in_layout{};
+    if (codec_ctx_->ch_layout.order == AV_CHANNEL_ORDER_UNSPEC) {
+        av_channel_layout_default(&in_layout, channels_);
+    } else {
+        av_channel_layout_copy(&in_layout, &codec_ctx_->ch_layout);
+    }
+    AVChannelLayout out_layout{};
+    av_channel_layout_default(&out_layout, 1);
+    int err = swr_alloc_set_opts2(&swr_ctx_, &out_layout, AV_SAMPLE_FMT_FLT, target_sample_rate_,
+                                  &in_layout, codec_ctx_->sample_fmt, sample_rate_, 0, nullptr);
+    av_channel_layout_uninit(&in_layout);
+    av_channel_layout_uninit(&out_layout);
+#else
+    const int64_t in_layout = codec_ctx_->channel_layout != 0
+                                  ? static_cast<int64_t>(codec_ctx_->channel_layout)
+                                  : av_get_default_channel_layout(channels_);
+    swr_ctx_ = swr_alloc_set_opts(nullptr, AV_CH_LAYOUT_MONO, AV_SAMPLE_FMT_FLT,
+                                  target_sample_rate_, in_layout, codec_ctx_->sample_fmt,
+                                  sample_rate_, 0, nullptr);
+    int err = swr_ctx_ ? 0 : AVERROR(ENOMEM);
+#endif
+    if (err >= 0) {
+        err = swr_init(swr_ctx_);
+    }
+    if (err < 0) {
+        return Fail("Failed to set up resampling from " + std::to_string(sample_rate_) +
+                    " Hz: " + AvError(err));
+    }
+    return true;
+}
+
+void MediaFileReader::Close() {
+    swr_free(&swr_ctx_);
+    avcodec_free_context(&codec_ctx_);
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+    if (format_ctx_) {
+        avformat_close_input(&format_ctx_);
+    }
+    stream_index_ = -1;
+    sample_rate_ = 0;
+    channels_ = 0;
+    duration_s_ = 0.0;
+    codec_name_.clear();
+    started_ = false;
+    input_done_ = false;
+    decoder_done_ = false;
+    pending_.clear();
+    pending_pos_ = 0;
+}
+
+bool MediaFileReader::ReadAll(std::vector<float>& pcm_data) {
+    pcm_data.clear();
+    if (!IsOpen()) {
+        last_error_ = "MediaFileReader not open";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    if (!Rewind()) {
+        return false;
+    }
+
+    // Reserve from the container's duration (a little over, as it may round down)
+    pcm_data.reserve(static_cast<size_t>(duration_s_ * target_sample_rate_) + 4096);
+    std::vector<float> chunk;
+    while (NextChunk(chunk, 65536)) {
+        pcm_data.insert(pcm_data.end(), chunk.begin(), chunk.end());
+    }
+    return last_error_.empty();
+}
+
+bool MediaFileReader::NextChunk(std::vector<float>& chunk, size_t max_output_samples) {
+    chunk.clear();
+    if (!IsOpen() || max_output_samples == 0) {
+        return false;
+    }
+    chunk.resize(max_output_samples);
+    chunk.resize(Read(chunk.data(), max_output_samples));
+    return !chunk.empty();
+}
+
+bool MediaFileReader::Rewind() {
+    if (!IsOpen()) {
+        return false;
+    }
+    if (!started_) {
+        return true;  // Still at the start; some inputs (pipes) cannot seek
+    }
+
+    const int err = av_seek_frame(format_ctx_, stream_index_, 0, AVSEEK_FLAG_BACKWARD);
+    if (err < 0) {
+        last_error_ = "MediaFileReader: cannot seek to the start: " + AvError(err);
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    avcodec_flush_buffers(codec_ctx_);
+    started_ = false;
+    input_done_ = false;
+    decoder_done_ = false;
+    pending_.clear();
+    pending_pos_ = 0;
+    return InitResampler();  // Drop the resampler's history
+}
+
+size_t MediaFileReader::Read(float* output, size_t capacity) {
+    size_t produced = 0;
+    while (produced < capacity) {
+        if (pending_pos_ == pending_.size() && !DecodeMore()) {
+            break;
+        }
+        const size_t n = std::min(capacity - produced, pending_.size() - pending_pos_);
+        std::memcpy(output + produced, pending_.data() + pending_pos_, n * sizeof(float));
+        pending_pos_ += n;
+        produced += n;
+    }
+    return produced;
+}
+
+bool MediaFileReader::DecodeMore() {
+    started_ = true;
+    pending_.clear();
+    pending_pos_ = 0;
+
+    while (pending_.empty()) {
+        if (decoder_done_) {
+            return false;
+        }
+
+        int err = avcodec_receive_frame(codec_ctx_, frame_);
+        if (err >= 0) {
+            ConvertFrame(frame_);
+            av_frame_unref(frame_);
+            continue;
+        }
+        if (err == AVERROR_EOF) {
+            ConvertFrame(nullptr);  // Resampler tail
+            decoder_done_ = true;
+            continue;
+        }
+        if (err != AVERROR(EAGAIN) || input_done_) {
+            last_error_ = "MediaFileReader: decode failed: " + AvError(err);
+            LOG_ERROR("%s", last_error_.c_str());
+            decoder_done_ = true;
+            return false;
+        }
+
+        // The decoder wants input: feed it the next packet of our stream
+        err = av_read_frame(format_ctx_, packet_);
+        if (err < 0) {
+            if (err != AVERROR_EOF) {
+                // A truncated file still yields what was decoded so far
+                LOG_WARNING("MediaFileReader: read stopped early: %s", AvError(err).c_str());
+            }
+            avcodec_send_packet(codec_ctx_, nullptr);  // Start draining
+            input_done_ = true;
+            continue;
+        }
+        if (packet_->stream_index == stream_index_) {
+            err = avcodec_send_packet(codec_ctx_, packet_);
+            if (err < 0 && err != AVERROR(EAGAIN)) {
+                // Corrupt packets (e.g. junk before an MP3 frame) are skipped
+                LOG_WARNING("MediaFileReader: skipping bad packet: %s", AvError(err).c_str());
+            }
+        }
+        av_packet_unref(packet_);
+    }
+    return true;
+}
+
+void MediaFileReader::ConvertFrame(const AVFrame* frame) {
+    const int in_samples = frame ? frame->nb_samples : 0;
+    const int capacity = swr_get_out_samples(swr_ctx_, in_samples);
+    if (capacity <= 0) {
+        return;
+    }
+    pending_.resize(static_cast<size_t>(capacity));
+    uint8_t* out = reinterpret_cast<uint8_t*>(pending_.data());
+    const uint8_t** in = frame ? const_cast<const uint8_t**>(frame->extended_data) : nullptr;
+    const int converted = swr_convert(swr_ctx_, &out, capacity, in, in_samples);
+    pending_.resize(converted > 0 ? static_cast<size_t>(converted) : 0);
+}
+
+bool MediaFileReader::Fail(const std::string& message) {
+    Close();
+    last_error_ = message;
+    LOG_ERROR("%s", last_error_.c_str());
+    return false;
+}
+
+}  // namespace ffvoice
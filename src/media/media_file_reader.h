@@ -0,0 +1,152 @@
+/**
+ * @file media_file_reader.h
+ * @brief Streaming FFmpeg decoder with on-the-fly Whisper conversion
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct SwrContext;
+
+namespace ffvoice {
+
+/**
+ * @brief Decodes any audio file FFmpeg can open into mono float in bounded chunks
+ *
+ * The counterpart of MappedWavReader for compressed input (MP3, M4A/AAC,
+ * Opus, Ogg Vorbis, FLAC, ...). libavformat demuxes the first audio stream,
+ * libavcodec decodes it one packet at a time, and libswresample downmixes,
+ * converts to float and resamples to the target rate in the same step. Only
+ * one decoded packet is held at a time, so memory does not grow with the
+ * file, and no intermediate transcode to WAV is needed.
+ *
+ * @code
+ * MediaFileReader reader;
+ * if (reader.Open("meeting.m4a", 16000)) {
+ *     std::vector<float> chunk;
+ *     while (reader.NextChunk(chunk, 16000 * 30)) {  // 30 s at a time
+ *         Feed(chunk);
+ *     }
+ * }
+ * @endcode
+ *
+ * Not thread-safe; one reader per thread.
+ */
+class MediaFileReader {
+public:
+    MediaFileReader();
+    ~MediaFileReader();
+
+    // Disable copy
+    MediaFileReader(const MediaFileReader&) = delete;
+    MediaFileReader& operator=(const MediaFileReader&) = delete;
+
+    /**
+     * @brief Open a media file and its first audio stream
+     * @param filename Path to any container/codec FFmpeg supports
+     * @param target_sample_rate Rate of the converted output (Hz)
+     * @return true if successful, false otherwise (see GetLastError())
+     */
+    bool Open(const std::string& filename, int target_sample_rate = 16000);
+
+    /**
+     * @brief Close the file and free the decoder
+     */
+    void Close();
+
+    bool IsOpen() const {
+        return format_ctx_ != nullptr;
+    }
+
+    /// Sample rate of the audio stream (Hz)
+    int GetSampleRate() const {
+        return sample_rate_;
+    }
+
+    /// Channel count of the audio stream
+    int GetChannels() const {
+        return channels_;
+    }
+
+    /// Duration reported by the container (seconds); 0 if unknown
+    double GetDurationSeconds() const {
+        return duration_s_;
+    }
+
+    /// Name of the decoder in use (e.g. "mp3float", "aac")
+    std::string GetCodecName() const {
+        return codec_name_;
+    }
+
+    /**
+     * @brief Decode the whole file into @p pcm_data (mono float at the target rate)
+     *
+     * Rewinds first. @p pcm_data is reserved from the container duration, so
+     * it is normally the only full-length allocation.
+     */
+    bool ReadAll(std::vector<float>& pcm_data);
+
+    /**
+     * @brief Decode the next part of the file (chunked iteration)
+     * @param chunk Output samples (replaced; at most @p max_output_samples)
+     * @param max_output_samples Chunk size in output samples
+     * @return false once the whole file has been returned or on error
+     */
+    bool NextChunk(std::vector<float>& chunk, size_t max_output_samples);
+
+    /**
+     * @brief Restart NextChunk() from the beginning of the file
+     * @return false if the container cannot seek back
+     */
+    bool Rewind();
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    /// Produce up to @p capacity output samples from the read position onwards
+    size_t Read(float* output, size_t capacity);
+
+    /// Refill pending_ from the next decoded frame; false at the end of the stream
+    bool DecodeMore();
+
+    /// Convert one decoded frame (nullptr = resampler tail) into pending_
+    void ConvertFrame(const AVFrame* frame);
+
+    /// (Re)create the resampler for the stream's format
+    bool InitResampler();
+
+    /// Record @p message as the last error, close and return false
+    bool Fail(const std::string& message);
+
+    std::string last_error_;
+    int target_sample_rate_ = 16000;
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    double duration_s_ = 0.0;
+    std::string codec_name_;
+
+    AVFormatContext* format_ctx_ = nullptr;
+    AVCodecContext* codec_ctx_ = nullptr;
+    SwrContext* swr_ctx_ = nullptr;
+    AVFrame* frame_ = nullptr;
+    AVPacket* packet_ = nullptr;
+    int stream_index_ = -1;
+
+    bool started_ = false;       ///< Something was decoded since Open()/Rewind()
+    bool input_done_ = false;    ///< Demuxer exhausted, decoder flush requested
+    bool decoder_done_ = false;  ///< Decoder drained, resampler tail produced
+    std::vector<float> pending_;  ///< Converted samples not yet returned
+    size_t pending_pos_ = 0;      ///< Next sample of pending_ to return
+};
+
+}  // namespace ffvoice
@@ -0,0 +1,395 @@
+/**
+ * @file opus_writer.cpp
+ * @brief Opus encoder implementation using libavcodec / libavformat
+ */
+
+#include "media/opus_writer.h"
+
+#include "utils/logger.h"
+#include "utils/trace.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/error.h>
+#include <libavutil/opt.h>
+}
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace ffvoice {
+
+namespace {
+
+// Opus allows up to 255 channels, but FFmpeg only knows default layouts to 8
+constexpr int kMaxChannels = 8;
+
+std::string AvError(int err) {
+    char buf[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(err, buf, sizeof(buf));
+    return buf;
+}
+
+// First of the encoder's sample formats that we can fill from int16
+AVSampleFormat PickSampleFormat(const AVCodec* codec) {
+    if (!codec->sample_fmts) {
+        return AV_SAMPLE_FMT_S16;
+    }
+    for (const AVSampleFormat* fmt = codec->sample_fmts; *fmt != AV_SAMPLE_FMT_NONE; ++fmt) {
+        if (*fmt == AV_SAMPLE_FMT_S16 || *fmt == AV_SAMPLE_FMT_FLT ||
+            *fmt == AV_SAMPLE_FMT_FLTP) {
+            return *fmt;
+        }
+    }
+    return AV_SAMPLE_FMT_NONE;
+}
+
+}  // namespace
+
+OpusWriter::OpusWriter() : OpusWriter(Config{}) {
+}
+
+OpusWriter::OpusWriter(const Config& config) : config_(config) {
+}
+
+OpusWriter::~OpusWriter() {
+    Close();
+}
+
+bool OpusWriter::IsSupportedSampleRate(int sample_rate) {
+    return sample_rate == 8000 || sample_rate == 12000 || sample_rate == 16000 ||
+           sample_rate == 24000 || sample_rate == 48000;
+}
+
+bool OpusWriter::Open(const std::string& filename, int sample_rate, int channels) {
+    if (codec_ctx_) {
+        LOG_ERROR("Opus encoder already open");
+        return false;
+    }
+
+    // Validate parameters
+    if (!IsSupportedSampleRate(sample_rate)) {
+        LOG_ERROR("Opus: Unsupported sample rate: %d (use 8000, 12000, 16000, 24000 or 48000)",
+                  sample_rate);
+        return false;
+    }
+    if (channels < 1 || channels > kMaxChannels) {
+        LOG_ERROR("Opus: Invalid channel count: %d", channels);
+        return false;
+    }
+    const int frame_ms = config_.frame_ms;
+    if (frame_ms != 10 && frame_ms != 20 && frame_ms != 40 && frame_ms != 60) {
+        LOG_ERROR("Opus: Invalid frame duration: %d ms", frame_ms);
+        return false;
+    }
+
+    // Prefer libopus; FFmpeg's own encoder is experimental and 48 kHz only
+    const AVCodec* codec = avcodec_find_encoder_by_name("libopus");
+    const bool native = codec == nullptr;
+    if (native) {
+        codec = avcodec_find_encoder(AV_CODEC_ID_OPUS);
+    }
+    if (!codec) {
+        LOG_ERROR("Opus: FFmpeg was built without an Opus encoder");
+        return false;
+    }
+    const AVSampleFormat sample_fmt = PickSampleFormat(codec);
+    if (sample_fmt == AV_SAMPLE_FMT_NONE) {
+        LOG_ERROR("Opus: %s takes no sample format we can provide", codec->name);
+        return false;
+    }
+
+    filename_ = filename;
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    total_samples_ = 0;
+    encoded_bytes_ = 0;
+    next_pts_ = 0;
+    has_error_ = false;
+
+    codec_ctx_ = avcodec_alloc_context3(codec);
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!codec_ctx_ || !frame_ || !packet_) {
+        LOG_ERROR("Opus: Out of memory");
+        Release();
+        has_error_ = true;
+        return false;
+    }
+
+    codec_ctx_->sample_fmt = sample_fmt;
+    codec_ctx_->sample_rate = sample_rate;
+    codec_ctx_->bit_rate = config_.bitrate;
+    codec_ctx_->time_base = AVRational{1, sample_rate};
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+    av_channel_layout_default(&codec_ctx_->ch_layout, channels);
+#else
+    codec_ctx_->channels = channels;
+    codec_ctx_->channel_layout = static_cast<uint64_t>(av_get_default_channel_layout(channels));
+#endif
+    if (native) {
+        codec_ctx_->strict_std_compliance = FF_COMPLIANCE_EXPERIMENTAL;
+    }
+
+    // The muxer decides whether the encoder must put its header in extradata
+    if (!filename.empty()) {
+        const char* muxer = config_.container.empty() ? nullptr : config_.container.c_str();
+        int err = avformat_alloc_output_context2(&format_ctx_, nullptr, muxer, filename.c_str());
+        if (err < 0 || !format_ctx_) {
+            // No muxer for this extension: Ogg is the standard Opus container
+            err = avformat_alloc_output_context2(&format_ctx_, nullptr, "ogg", filename.c_str());
+        }
+        if (err < 0 || !format_ctx_) {
+            LOG_ERROR("Opus: No muxer for %s: %s", filename.c_str(), AvError(err).c_str());
+            Release();
+            has_error_ = true;
+            return false;
+        }
+        if (format_ctx_->oformat->flags & AVFMT_GLOBALHEADER) {
+            codec_ctx_->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+    }
+
+    // libopus private options; the native encoder leaves them in the dictionary
+    AVDictionary* options = nullptr;
+    av_dict_set(&options, "application", config_.voice ? "voip" : "audio", 0);
+    av_dict_set_int(&options, "frame_duration", frame_ms, 0);
+    int err = avcodec_open2(codec_ctx_, codec, &options);
+    av_dict_free(&options);
+    if (err < 0) {
+        LOG_ERROR("Opus: Failed to open %s: %s", codec->name, AvError(err).c_str());
+        Release();
+        has_error_ = true;
+        return false;
+    }
+
+    frame_frames_ = codec_ctx_->frame_size > 0
+                        ? static_cast<size_t>(codec_ctx_->frame_size)
+                        : static_cast<size_t>(sample_rate) * static_cast<size_t>(frame_ms) / 1000;
+    const int short_frame_caps = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_VARIABLE_FRAME_SIZE;
+    small_last_frame_ = (codec->capabilities & short_frame_caps) != 0;
+    staged_.assign(frame_frames_ * static_cast<size_t>(channels), 0);
+    staged_samples_ = 0;
+
+    frame_->format = sample_fmt;
+    frame_->sample_rate = sample_rate;
+    frame_->nb_samples = static_cast<int>(frame_frames_);
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+    av_channel_layout_copy(&frame_->ch_layout, &codec_ctx_->ch_layout);
+#else
+    frame_->channels = channels;
+    frame_->channel_layout = codec_ctx_->channel_layout;
+#endif
+    err = av_frame_get_buffer(frame_, 0);
+    if (err < 0) {
+        LOG_ERROR("Opus: Failed to allocate frame: %s", AvError(err).c_str());
+        Release();
+        has_error_ = true;
+        return false;
+    }
+
+    if (format_ctx_) {
+        stream_ = avformat_new_stream(format_ctx_, nullptr);
+        if (!stream_) {
+            LOG_ERROR("Opus: Failed to create stream");
+            Release();
+            has_error_ = true;
+            return false;
+        }
+        stream_->time_base = codec_ctx_->time_base;
+        err = avcodec_parameters_from_context(stream_->codecpar, codec_ctx_);
+        if (err >= 0 && !(format_ctx_->oformat->flags & AVFMT_NOFILE)) {
+            err = avio_open(&format_ctx_->pb, filename.c_str(), AVIO_FLAG_WRITE);
+        }
+        if (err >= 0) {
+            err = avformat_write_header(format_ctx_, nullptr);
+        }
+        if (err < 0) {
+            LOG_ERROR("Opus: Failed to open %s: %s", filename.c_str(), AvError(err).c_str());
+            Release();
+            has_error_ = true;
+            return false;
+        }
+    }
+
+    LOG_INFO("Opus encoder opened: %s (%dHz, %dch, %d b/s, %d ms frames, %s)",
+             filename.empty() ? "<packets>" : filename.c_str(), sample_rate, channels,
+             config_.bitrate, frame_ms, codec->name);
+    return true;
+}
+
+size_t OpusWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
+    FFVOICE_TRACE_SCOPE("OpusWriter::WriteSamples");
+    if (!codec_ctx_) {
+        LOG_ERROR("Opus encoder not open");
+        has_error_ = true;
+        return 0;
+    }
+    if (has_error_) {
+        return 0;
+    }
+    if (!samples || num_samples == 0) {
+        return 0;  // Nothing to write; not an error.
+    }
+
+    for (size_t pos = 0; pos < num_samples;) {
+        const size_t n = std::min(num_samples - pos, staged_.size() - staged_samples_);
+        std::memcpy(staged_.data() + staged_samples_, samples + pos, n * sizeof(int16_t));
+        staged_samples_ += n;
+        pos += n;
+        if (staged_samples_ == staged_.size()) {
+            staged_samples_ = 0;
+            if (!EncodeStaged(frame_frames_)) {
+                return 0;
+            }
+        }
+    }
+
+    total_samples_ += num_samples;
+    return num_samples;
+}
+
+size_t OpusWriter::WriteSamples(const std::vector<int16_t>& samples) {
+    return WriteSamples(samples.data(), samples.size());
+}
+
+bool OpusWriter::EncodeStaged(size_t frames) {
+    int err = av_frame_make_writable(frame_);
+    if (err < 0) {
+        LOG_ERROR("Opus: Frame not writable: %s", AvError(err).c_str());
+        has_error_ = true;
+        return false;
+    }
+
+    const size_t channels = static_cast<size_t>(channels_);
+    const int16_t* in = staged_.data();
+    switch (codec_ctx_->sample_fmt) {
+        case AV_SAMPLE_FMT_S16:
+            std::memcpy(frame_->data[0], in, frames * channels * sizeof(int16_t));
+            break;
+        case AV_SAMPLE_FMT_FLT: {
+            float* out = reinterpret_cast<float*>(frame_->data[0]);
+            for (size_t i = 0; i < frames * channels; ++i) {
+                out[i] = static_cast<float>(in[i]) / 32768.0f;
+            }
+            break;
+        }
+        default: {  // AV_SAMPLE_FMT_FLTP
+            for (size_t ch = 0; ch < channels; ++ch) {
+                float* out = reinterpret_cast<float*>(frame_->data[ch]);
+                for (size_t i = 0; i < frames; ++i) {
+                    out[i] = static_cast<float>(in[i * channels + ch]) / 32768.0f;
+                }
+            }
+            break;
+        }
+    }
+
+    frame_->nb_samples = static_cast<int>(frames);
+    frame_->pts = next_pts_;
+    next_pts_ += static_cast<int64_t>(frames);
+    return Encode(frame_);
+}
+
+bool OpusWriter::Encode(const AVFrame* frame) {
+    int err = avcodec_send_frame(codec_ctx_, frame);
+    if (err < 0) {
+        LOG_ERROR("Opus: Encode failed: %s", AvError(err).c_str());
+        has_error_ = true;
+        return false;
+    }
+
+    while ((err = avcodec_receive_packet(codec_ctx_, packet_)) >= 0) {
+        encoded_bytes_ += static_cast<uint64_t>(packet_->size);
+        if (config_.on_packet) {
+            config_.on_packet(packet_->data, static_cast<size_t>(packet_->size), packet_->pts);
+        }
+        if (!format_ctx_) {
+            av_packet_unref(packet_);
+            continue;
+        }
+        packet_->stream_index = stream_->index;
+        av_packet_rescale_ts(packet_, codec_ctx_->time_base, stream_->time_base);
+        err = av_interleaved_write_frame(format_ctx_, packet_);  // Takes the packet
+        if (err < 0) {
+            LOG_ERROR("Opus: Write failed: %s", AvError(err).c_str());
+            has_error_ = true;
+            return false;
+        }
+    }
+    if (err != AVERROR(EAGAIN) && err != AVERROR_EOF) {
+        LOG_ERROR("Opus: Encode failed: %s", AvError(err).c_str());
+        has_error_ = true;
+        return false;
+    }
+    return true;
+}
+
+void OpusWriter::Close() {
+    if (!codec_ctx_) {
+        return;
+    }
+
+    if (!has_error_) {
+        // The encoder only takes a short final frame if it says so; otherwise
+        // pad it with silence
+        if (staged_samples_ > 0) {
+            const size_t channels = static_cast<size_t>(channels_);
+            size_t frames = staged_samples_ / channels;
+            if (!small_last_frame_) {
+                std::fill(staged_.begin() + static_cast<std::ptrdiff_t>(staged_samples_),
+                          staged_.end(), int16_t{0});
+                frames = frame_frames_;
+            }
+            staged_samples_ = 0;
+            if (frames > 0) {
+                EncodeStaged(frames);
+            }
+        }
+        if (!has_error_) {
+            Encode(nullptr);
+        }
+    }
+    if (format_ctx_ && !has_error_) {
+        const int err = av_write_trailer(format_ctx_);
+        if (err < 0) {
+            LOG_ERROR("Opus: Failed to finish %s: %s", filename_.c_str(), AvError(err).c_str());
+            has_error_ = true;
+        }
+    }
+    Release();
+
+    LOG_INFO("Opus encoder closed: %s (%zu samples, %llu bytes, ratio=%.2fx)",
+             filename_.empty() ? "<packets>" : filename_.c_str(), total_samples_,
+             static_cast<unsigned long long>(encoded_bytes_), GetCompressionRatio());
+}
+
+void OpusWriter::Release() {
+    if (format_ctx_) {
+        if (format_ctx_->pb && !(format_ctx_->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&format_ctx_->pb);
+        }
+        avformat_free_context(format_ctx_);
+        format_ctx_ = nullptr;
+        stream_ = nullptr;
+    }
+    avcodec_free_context(&codec_ctx_);
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+    staged_.clear();
+    staged_.shrink_to_fit();
+    staged_samples_ = 0;
+}
+
+double OpusWriter::GetCompressionRatio() const {
+    if (encoded_bytes_ == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(total_samples_ * sizeof(int16_t)) /
+           static_cast<double>(encoded_bytes_);
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,161 @@
+/**
+ * @file opus_writer.h
+ * @brief Opus encoder writing Ogg/WebM files or raw packets, using FFmpeg
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct AVStream;
+
+namespace ffvoice {
+
+/**
+ * @brief Incremental Opus encoder for recording and network streaming
+ *
+ * At 32 kb/s a mono 48 kHz stream is 1/24 of its 16-bit PCM size and about
+ * a tenth of its FLAC size, which is what matters once audio leaves the box.
+ * Samples are buffered into encoder frames (20 ms by default) as they arrive,
+ * so memory stays constant however long the recording runs.
+ *
+ * Encoded packets go to a muxed file, to Config::on_packet, or to both:
+ * - Open("talk.opus" / "talk.ogg") writes Ogg Opus, Open("talk.webm") WebM;
+ *   Config::container overrides the guess from the extension.
+ * - Open("") writes no file; every packet goes to on_packet only, e.g. to
+ *   be sent over RTP or a WebSocket.
+ *
+ * libopus is used when FFmpeg was built with it; FFmpeg's native Opus
+ * encoder (48 kHz only) is the fallback. Opus runs at 8, 12, 16, 24 or
+ * 48 kHz; other capture rates are rejected rather than resampled.
+ *
+ * Not thread-safe; owned by a single writer thread.
+ */
+class OpusWriter {
+public:
+    /**
+     * @brief Callback for each encoded packet
+     * @param data Packet payload (valid only during the call)
+     * @param size Payload size in bytes
+     * @param pts Presentation time of the packet's first sample, in samples
+     *            at the stream's sample rate
+     */
+    using PacketCallback = std::function<void(const uint8_t* data, size_t size, int64_t pts)>;
+
+    /**
+     * @brief Encoder settings
+     */
+    struct Config {
+        int bitrate = 32000;       ///< Target bits per second, all channels together
+        int frame_ms = 20;         ///< Encoder frame: 10, 20, 40 or 60 ms
+        bool voice = true;         ///< Tune for speech (libopus "voip") rather than music
+        std::string container;     ///< FFmpeg muxer name ("ogg", "webm"); empty = by extension
+        PacketCallback on_packet;  ///< Called for every encoded packet; may be empty
+    };
+
+    OpusWriter();
+    explicit OpusWriter(const Config& config);
+    ~OpusWriter();
+
+    // Disable copy
+    OpusWriter(const OpusWriter&) = delete;
+    OpusWriter& operator=(const OpusWriter&) = delete;
+
+    /// Whether Opus can encode at @p sample_rate without resampling
+    static bool IsSupportedSampleRate(int sample_rate);
+
+    /**
+     * @brief Open the encoder and, unless @p filename is empty, the output file
+     * @param filename Output file path, or empty for packets to on_packet only
+     * @param sample_rate 8000, 12000, 16000, 24000 or 48000 Hz
+     * @param channels Number of interleaved channels (1-8)
+     * @return true if successful
+     */
+    bool Open(const std::string& filename, int sample_rate, int channels);
+
+    /**
+     * @brief Encode interleaved int16 samples
+     *
+     * Whole encoder frames are encoded immediately; the remainder waits for
+     * the next call (or Close()).
+     *
+     * @param samples Pointer to sample data
+     * @param num_samples Number of samples (not frames!)
+     * @return Number of samples accepted; 0 on error
+     */
+    size_t WriteSamples(const int16_t* samples, size_t num_samples);
+
+    /**
+     * @brief Write PCM samples from vector
+     */
+    size_t WriteSamples(const std::vector<int16_t>& samples);
+
+    /**
+     * @brief Encode buffered samples, flush the encoder and finish the file
+     */
+    void Close();
+
+    bool IsOpen() const {
+        return codec_ctx_ != nullptr;
+    }
+
+    /// true once an encoder or muxer error has occurred, until the next Open()
+    bool HasError() const {
+        return has_error_;
+    }
+
+    /// Samples accepted by WriteSamples()
+    size_t GetTotalSamples() const {
+        return total_samples_;
+    }
+
+    /// Bytes of encoded Opus payload produced so far (without container overhead)
+    uint64_t GetEncodedBytes() const {
+        return encoded_bytes_;
+    }
+
+    /**
+     * @brief Get compression ratio (16-bit PCM size / encoded size)
+     */
+    double GetCompressionRatio() const;
+
+private:
+    /// Convert the staged frame into frame_ and encode it
+    bool EncodeStaged(size_t frames);
+
+    /// Send @p frame (nullptr = flush) and hand every finished packet on
+    bool Encode(const AVFrame* frame);
+
+    /// Free every FFmpeg object
+    void Release();
+
+    Config config_;
+    AVCodecContext* codec_ctx_ = nullptr;
+    AVFormatContext* format_ctx_ = nullptr;  // nullptr when writing packets only
+    AVStream* stream_ = nullptr;
+    AVFrame* frame_ = nullptr;
+    AVPacket* packet_ = nullptr;
+
+    std::vector<int16_t> staged_;  // One encoder frame of interleaved input
+    size_t staged_samples_ = 0;
+    size_t frame_frames_ = 0;  // Frames (per channel) per encoder frame
+    bool small_last_frame_ = false;
+    int64_t next_pts_ = 0;
+
+    std::string filename_;
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    size_t total_samples_ = 0;
+    uint64_t encoded_bytes_ = 0;
+    bool has_error_ = false;
+};
+
+}  // namespace ffvoice
@@ -6,11 +6,23 @@
 #include "wav_writer.h"
 
 #include "utils/logger.h"
+#include "utils/trace.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
 #include <cstring>
 #include <limits>
 
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 namespace ffvoice {
 
 namespace {
@@ -20,15 +32,146 @@ namespace {
 // the data chunk at UINT32_MAX - 36.
 constexpr uint64_t kMaxWavDataBytes =
     static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) - 36u;
+
+// PCM header sizes: canonical, and with the 28-byte JUNK/ds64 chunk that
+// lets the file become RF64 (EBU Tech 3306) once it outgrows 4 GB
+constexpr size_t kHeaderBytes = 44;
+constexpr size_t kRf64HeaderBytes = 80;
+constexpr size_t kMaxHeaderBytes = kRf64HeaderBytes;
+constexpr size_t kDs64Bytes = 28;
+
+// O_DIRECT transfer unit: offsets, lengths and buffer addresses are multiples of it
+constexpr size_t kBlockBytes = 4096;
+
+template <typename T>
+T RoundUpToBlock(T value) {
+    return (value + kBlockBytes - 1) / kBlockBytes * kBlockBytes;
+}
+
+int OpenForWrite(const std::string& filename, bool direct) {
+#ifdef _WIN32
+    (void)direct;
+    return ::_open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    #ifdef O_DIRECT
+    if (direct) {
+        flags |= O_DIRECT;
+    }
+    #else
+    if (direct) {
+        errno = EINVAL;
+        return -1;
+    }
+    #endif
+    return ::open(filename.c_str(), flags, 0644);
+#endif
+}
+
+// Write all of @p bytes at the current file position
+bool WriteAll(int fd, const uint8_t* data, size_t bytes) {
+    while (bytes > 0) {
+#ifdef _WIN32
+        const unsigned int chunk =
+            static_cast<unsigned int>(std::min<size_t>(bytes, 1u << 30));
+        const int written = ::_write(fd, data, chunk);
+#else
+        const ssize_t written = ::write(fd, data, bytes);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Write @p bytes at @p offset without moving the file position
+bool WriteAt(int fd, uint64_t offset, const uint8_t* data, size_t bytes) {
+#ifdef _WIN32
+    const __int64 position = ::_lseeki64(fd, 0, SEEK_CUR);
+    if (position < 0 || ::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0) {
+        return false;
+    }
+    const bool ok = WriteAll(fd, data, bytes);
+    return ::_lseeki64(fd, position, SEEK_SET) >= 0 && ok;
+#else
+    while (bytes > 0) {
+        const ssize_t written = ::pwrite(fd, data, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+#endif
+}
+
+bool SyncData(int fd) {
+#if defined(_WIN32)
+    return ::_commit(fd) == 0;
+#elif defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+// Switch an O_DIRECT descriptor back to buffered I/O (for the unaligned tail)
+bool DisableDirect(int fd) {
+#if !defined(_WIN32) && defined(O_DIRECT)
+    const int flags = ::fcntl(fd, F_GETFL);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags & ~O_DIRECT) == 0;
+#else
+    (void)fd;
+    return true;
+#endif
+}
+
+void CloseFile(int fd) {
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+void PutU16(uint8_t* out, uint16_t value) {
+    std::memcpy(out, &value, sizeof(value));
+}
+
+void PutU32(uint8_t* out, uint32_t value) {
+    std::memcpy(out, &value, sizeof(value));
+}
+
+void PutU64(uint8_t* out, uint64_t value) {
+    std::memcpy(out, &value, sizeof(value));
+}
 }  // namespace
 
+WavWriter::WavWriter() : WavWriter(Config{}) {
+}
+
+WavWriter::WavWriter(const Config& config) : config_(config) {
+}
+
 WavWriter::~WavWriter() {
     Close();
 }
 
 bool WavWriter::Open(const std::string& filename, int sample_rate, int channels,
                      int bits_per_sample) {
-    if (file_.is_open()) {
+    if (IsOpen()) {
         Close();
     }
 
@@ -37,81 +180,207 @@ bool WavWriter::Open(const std::string& filename, int sample_rate, int channels,
     bits_per_sample_ = bits_per_sample;
     total_samples_ = 0;
     size_limit_reached_ = false;
-
-    file_.open(filename, std::ios::binary | std::ios::out);
-    if (!file_) {
+    write_failed_ = false;
+    buffered_ = 0;
+    file_bytes_ = 0;
+    checkpointed_bytes_ = 0;
+    header_bytes_ = config_.rf64 ? kRf64HeaderBytes : kHeaderBytes;
+
+    direct_ = false;
+    if (config_.direct_io) {
+        fd_ = OpenForWrite(filename, true);
+        if (fd_ >= 0) {
+            direct_ = true;
+        } else if (errno == EINVAL) {
+            LOG_WARNING("WavWriter: O_DIRECT not supported for %s, using buffered I/O",
+                        filename.c_str());
+        }
+    }
+    if (fd_ < 0) {
+        fd_ = OpenForWrite(filename, false);
+    }
+    if (fd_ < 0) {
         return false;
     }
 
-    // Write initial header (will be updated on close)
+    // O_DIRECT needs whole, aligned blocks: round the buffer up and align it
+    capacity_ = config_.buffer_bytes;
+    size_t extra = 0;
+    if (direct_) {
+        capacity_ = std::max(kBlockBytes, RoundUpToBlock(capacity_));
+        extra = 2 * kBlockBytes;  // Alignment slack plus the block 0 copy
+    }
+    if (storage_.size() < capacity_ + extra) {
+        storage_.assign(capacity_ + extra, 0);
+    }
+    const uintptr_t base = reinterpret_cast<uintptr_t>(storage_.data());
+    const uintptr_t aligned = direct_ ? RoundUpToBlock(base) : base;
+    buffer_ = storage_.data() + (aligned - base);
+    first_block_ = direct_ ? buffer_ + capacity_ : nullptr;
+
+    const uint64_t bytes_per_second = static_cast<uint64_t>(std::max(sample_rate, 0)) *
+                                      static_cast<uint64_t>(std::max(channels, 0)) *
+                                      sizeof(int16_t);
+    checkpoint_bytes_ = 0;
+    if (config_.checkpoint_ms > 0) {
+        checkpoint_bytes_ = std::max<uint64_t>(
+            1, bytes_per_second * static_cast<uint64_t>(config_.checkpoint_ms) / 1000);
+    }
+
+    // Write initial header (sizes are filled in by checkpoints and on close)
     WriteHeader();
+    if (write_failed_) {
+        CloseFile(fd_);
+        fd_ = -1;
+        return false;
+    }
 
     return true;
 }
 
-void WavWriter::WriteHeader() {
-    // WAV file header structure (44 bytes for PCM)
+size_t WavWriter::BuildHeader(uint8_t* out) const {
+    // Calculate sizes from what is in the file, not what is still buffered
+    const uint64_t samples = GetFileDataBytes() / sizeof(int16_t);
+    const uint64_t data_size = samples * static_cast<uint64_t>(bits_per_sample_) / 8;
+    const uint64_t riff_size = data_size + header_bytes_ - 8;
+    const bool rf64 = data_size > kMaxWavDataBytes;  // Only reachable with config_.rf64
 
     // RIFF chunk descriptor
-    file_.write("RIFF", 4);
-    uint32_t chunk_size = 0;  // Will be updated on close
-    file_.write(reinterpret_cast<const char*>(&chunk_size), 4);
-    file_.write("WAVE", 4);
+    std::memcpy(out + 0, rf64 ? "RF64" : "RIFF", 4);
+    PutU32(out + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riff_size));
+    std::memcpy(out + 8, "WAVE", 4);
+    size_t pos = 12;
+
+    // Reserved space for the 64-bit sizes; a JUNK chunk until they are needed
+    if (config_.rf64) {
+        std::memcpy(out + pos, rf64 ? "ds64" : "JUNK", 4);
+        PutU32(out + pos + 4, kDs64Bytes);
+        std::memset(out + pos + 8, 0, kDs64Bytes);
+        if (rf64) {
+            PutU64(out + pos + 8, riff_size);
+            PutU64(out + pos + 16, data_size);
+            PutU64(out + pos + 24, samples / static_cast<uint64_t>(std::max(channels_, 1)));
+            PutU32(out + pos + 32, 0);  // No table entries
+        }
+        pos += 8 + kDs64Bytes;
+    }
 
     // fmt sub-chunk
-    file_.write("fmt ", 4);
-    uint32_t fmt_chunk_size = 16;  // PCM
-    file_.write(reinterpret_cast<const char*>(&fmt_chunk_size), 4);
+    std::memcpy(out + pos, "fmt ", 4);
+    PutU32(out + pos + 4, 16);  // PCM
+    PutU16(out + pos + 8, 1);   // PCM
 
-    uint16_t audio_format = 1;  // PCM
-    file_.write(reinterpret_cast<const char*>(&audio_format), 2);
-
-    uint16_t num_channels = static_cast<uint16_t>(channels_);
-    file_.write(reinterpret_cast<const char*>(&num_channels), 2);
+    PutU16(out + pos + 10, static_cast<uint16_t>(channels_));
 
     uint32_t sample_rate = static_cast<uint32_t>(sample_rate_);
-    file_.write(reinterpret_cast<const char*>(&sample_rate), 4);
+    PutU32(out + pos + 12, sample_rate);
 
     uint32_t byte_rate = sample_rate * channels_ * bits_per_sample_ / 8;
-    file_.write(reinterpret_cast<const char*>(&byte_rate), 4);
-
-    uint16_t block_align = static_cast<uint16_t>(channels_ * bits_per_sample_ / 8);
-    file_.write(reinterpret_cast<const char*>(&block_align), 2);
+    PutU32(out + pos + 16, byte_rate);
 
-    uint16_t bits = static_cast<uint16_t>(bits_per_sample_);
-    file_.write(reinterpret_cast<const char*>(&bits), 2);
+    PutU16(out + pos + 20, static_cast<uint16_t>(channels_ * bits_per_sample_ / 8));
+    PutU16(out + pos + 22, static_cast<uint16_t>(bits_per_sample_));
+    pos += 24;
 
     // data sub-chunk
-    file_.write("data", 4);
-    uint32_t data_size = 0;  // Will be updated on close
-    data_pos_ = file_.tellp();
-    file_.write(reinterpret_cast<const char*>(&data_size), 4);
+    std::memcpy(out + pos, "data", 4);
+    PutU32(out + pos + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(data_size));
+    return pos + 8;
+}
+
+void WavWriter::WriteHeader() {
+    // Nothing is in the file yet, so the sizes are 0 until the first checkpoint
+    uint8_t header[kMaxHeaderBytes];
+    Append(header, BuildHeader(header));
 }
 
-void WavWriter::UpdateHeader() {
-    if (!file_.is_open()) {
-        return;
+uint64_t WavWriter::GetFileDataBytes() const {
+    return file_bytes_ > header_bytes_ ? file_bytes_ - header_bytes_ : 0;
+}
+
+bool WavWriter::UpdateHeader() {
+    if (!IsOpen()) {
+        return false;
     }
 
-    // Calculate sizes
-    uint32_t data_size = static_cast<uint32_t>(total_samples_ * bits_per_sample_ / 8);
-    uint32_t chunk_size = data_size + 36;  // 36 = header size - 8
+    if (direct_) {
+        // The header is inside block 0; until that block is written there is
+        // nothing to update, after it only whole blocks may be written.
+        if (file_bytes_ < kBlockBytes) {
+            return true;
+        }
+        BuildHeader(first_block_);
+        return WriteAt(fd_, 0, first_block_, kBlockBytes);
+    }
 
-    // Update RIFF chunk size
-    file_.seekp(4);
-    file_.write(reinterpret_cast<const char*>(&chunk_size), 4);
+    uint8_t header[kMaxHeaderBytes];
+    return WriteAt(fd_, 0, header, BuildHeader(header));
+}
 
-    // Update data chunk size
-    file_.seekp(data_pos_);
-    file_.write(reinterpret_cast<const char*>(&data_size), 4);
+bool WavWriter::WriteOut(const uint8_t* data, size_t bytes) {
+    if (write_failed_) {
+        return false;
+    }
+    if (direct_ && file_bytes_ == 0) {
+        std::memcpy(first_block_, data, kBlockBytes);  // Direct writes are whole blocks
+    }
+    if (!WriteAll(fd_, data, bytes)) {
+        write_failed_ = true;
+        LOG_ERROR("WavWriter: write failed: %s", std::strerror(errno));
+        return false;
+    }
+    file_bytes_ += bytes;
+
+    // Header checkpoint once checkpoint_ms more audio has reached the file
+    if (checkpoint_bytes_ > 0 && GetFileDataBytes() >= checkpointed_bytes_ + checkpoint_bytes_) {
+        if (!UpdateHeader() || (config_.sync_data && !SyncData(fd_))) {
+            LOG_WARNING("WavWriter: header checkpoint failed: %s", std::strerror(errno));
+        }
+        checkpointed_bytes_ = GetFileDataBytes();
+    }
+    return true;
+}
+
+bool WavWriter::Append(const uint8_t* data, size_t bytes) {
+    if (capacity_ == 0) {
+        return WriteOut(data, bytes);
+    }
+
+    // A block at least as large as the buffer goes straight to the file
+    // (O_DIRECT excepted, which must write from the aligned buffer)
+    if (!direct_ && bytes >= capacity_) {
+        if (buffered_ > 0) {
+            if (!WriteOut(buffer_, buffered_)) {
+                return false;
+            }
+            buffered_ = 0;
+        }
+        return WriteOut(data, bytes);
+    }
+
+    while (bytes > 0) {
+        const size_t take = std::min(capacity_ - buffered_, bytes);
+        std::memcpy(buffer_ + buffered_, data, take);
+        buffered_ += take;
+        data += take;
+        bytes -= take;
+        if (buffered_ == capacity_) {
+            if (!WriteOut(buffer_, capacity_)) {
+                return false;
+            }
+            buffered_ = 0;
+        }
+    }
+    return true;
 }
 
 size_t WavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
-    if (!file_.is_open() || !samples) {
+    FFVOICE_TRACE_SCOPE("WavWriter::WriteSamples");
+    if (!IsOpen() || !samples) {
         return 0;
     }
 
-    if (size_limit_reached_) {
+    if (size_limit_reached_ || write_failed_) {
         return 0;
     }
 
@@ -122,7 +391,7 @@ size_t WavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
     const uint64_t current_data_bytes = static_cast<uint64_t>(total_samples_) * bytes_per_sample;
     const uint64_t incoming_data_bytes = static_cast<uint64_t>(num_samples) * bytes_per_sample;
 
-    if (incoming_data_bytes > kMaxWavDataBytes - current_data_bytes) {
+    if (!config_.rf64 && incoming_data_bytes > kMaxWavDataBytes - current_data_bytes) {
         size_limit_reached_ = true;
         LOG_ERROR(
             "WavWriter: data size would exceed the 4 GB WAV/RIFF limit; "
@@ -131,9 +400,7 @@ size_t WavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
     }
 
     size_t bytes = num_samples * sizeof(int16_t);
-    file_.write(reinterpret_cast<const char*>(samples), bytes);
-
-    if (file_) {
+    if (Append(reinterpret_cast<const uint8_t*>(samples), bytes)) {
         total_samples_ += num_samples;
         return num_samples;
     }
@@ -145,10 +412,46 @@ size_t WavWriter::WriteSamples(const std::vector<int16_t>& samples) {
     return WriteSamples(samples.data(), samples.size());
 }
 
+bool WavWriter::Flush() {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    const size_t bytes = direct_ ? buffered_ / kBlockBytes * kBlockBytes : buffered_;
+    if (bytes > 0) {
+        if (!WriteOut(buffer_, bytes)) {
+            return false;
+        }
+        buffered_ -= bytes;
+        std::memmove(buffer_, buffer_ + bytes, buffered_);
+    }
+
+    if (!UpdateHeader() || (config_.sync_data && !SyncData(fd_))) {
+        return false;
+    }
+    checkpointed_bytes_ = GetFileDataBytes();
+    return !write_failed_;
+}
+
 void WavWriter::Close() {
-    if (file_.is_open()) {
-        UpdateHeader();
-        file_.close();
+    if (IsOpen()) {
+        // The last partial block cannot go out through O_DIRECT
+        if (buffered_ > 0) {
+            if (direct_ && DisableDirect(fd_)) {
+                direct_ = false;
+            }
+            WriteOut(buffer_, buffered_);
+            buffered_ = 0;
+        }
+        if (!UpdateHeader()) {
+            LOG_ERROR("WavWriter: failed to finalize header: %s", std::strerror(errno));
+        }
+        if (config_.sync_data) {
+            SyncData(fd_);
+        }
+        CloseFile(fd_);
+        fd_ = -1;
+        direct_ = false;
         total_samples_ = 0;
         size_limit_reached_ = false;
     }
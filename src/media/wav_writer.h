@@ -5,8 +5,8 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
 #include <string>
 #include <vector>
 
@@ -17,10 +17,52 @@ namespace ffvoice {
  *
  * This is a minimal implementation that writes standard WAV files
  * with PCM data. Supports mono/stereo, various sample rates.
+ *
+ * Samples are collected in a write-behind buffer and reach the file in
+ * buffer_bytes writes. The header starts with zero sizes. It is rewritten in
+ * place, with positioned writes that leave the file position alone, every
+ * checkpoint_ms of audio and again on Close(). A crash therefore loses at most
+ * one buffer plus one checkpoint interval of the recording, and the file is
+ * still a valid WAV.
  */
 class WavWriter {
 public:
-    WavWriter() = default;
+    /**
+     * @brief Buffering and durability options
+     */
+    struct Config {
+        /// Write-behind buffer (bytes); 0 writes every WriteSamples() call through
+        size_t buffer_bytes = 64 * 1024;
+
+        /// Audio between header checkpoints (ms); 0 = header only written on Close()
+        int checkpoint_ms = 1000;
+
+        /// fdatasync() after each checkpoint and on Close(), so checkpoints reach the disk
+        bool sync_data = false;
+
+        /**
+         * @brief Open with O_DIRECT to bypass the page cache (Linux only)
+         *
+         * Writes then go out in whole 4 KiB blocks from an aligned buffer
+         * (buffer_bytes is rounded up), and only the final partial block goes
+         * through the page cache. Filesystems that reject O_DIRECT (tmpfs,
+         * some network mounts) fall back to buffered I/O with a warning.
+         */
+        bool direct_io = false;
+
+        /**
+         * @brief Allow files past the 4 GB RIFF limit by switching them to RF64
+         *
+         * The header reserves a 28-byte JUNK chunk (80 bytes instead of 44).
+         * While the data fits in 4 GB the file is a plain WAV. Beyond that the
+         * header becomes RF64 and the chunk becomes ds64, which holds the
+         * 64-bit sizes. Without this, WriteSamples() stops at the limit.
+         */
+        bool rf64 = false;
+    };
+
+    WavWriter();
+    explicit WavWriter(const Config& config);
     ~WavWriter();
 
     // Disable copy
@@ -50,6 +92,16 @@ public:
      */
     size_t WriteSamples(const std::vector<int16_t>& samples);
 
+    /**
+     * @brief Write buffered samples to the file and checkpoint the header
+     *
+     * With direct_io the trailing partial 4 KiB block stays buffered until
+     * Close(), since O_DIRECT writes must be whole blocks.
+     *
+     * @return false if a write failed
+     */
+    bool Flush();
+
     /**
      * @brief Close the WAV file and finalize headers
      */
@@ -59,7 +111,7 @@ public:
      * @brief Check if file is open
      */
     bool IsOpen() const {
-        return file_.is_open();
+        return fd_ >= 0;
     }
 
     /**
@@ -70,16 +122,39 @@ public:
     }
 
 private:
+    /// Header for the data written to the file so far; returns its size
+    size_t BuildHeader(uint8_t* out) const;
     void WriteHeader();
-    void UpdateHeader();
+    bool UpdateHeader();
+
+    /// Copy @p bytes into the buffer, writing it out whenever it fills
+    bool Append(const uint8_t* data, size_t bytes);
 
-    std::ofstream file_;
+    /// Write @p bytes at the current end of the file
+    bool WriteOut(const uint8_t* data, size_t bytes);
+
+    /// Data bytes that have reached the file
+    uint64_t GetFileDataBytes() const;
+
+    Config config_;
+    int fd_ = -1;
+    bool direct_ = false;      ///< O_DIRECT is in effect
+    size_t header_bytes_ = 0;  ///< 44, or 80 with the RF64 reservation
     int sample_rate_ = 0;
     int channels_ = 0;
     int bits_per_sample_ = 0;
     size_t total_samples_ = 0;
-    std::streampos data_pos_ = 0;
     bool size_limit_reached_ = false;  // True once the 4 GB RIFF limit is hit
+    bool write_failed_ = false;        // True once a write to the file has failed
+
+    std::vector<uint8_t> storage_;     ///< Holds buffer_ and first_block_, over-allocated to align
+    uint8_t* buffer_ = nullptr;        ///< Write-behind buffer, block aligned
+    uint8_t* first_block_ = nullptr;   ///< Copy of file block 0, for O_DIRECT checkpoints
+    size_t capacity_ = 0;              ///< Usable bytes in buffer_
+    size_t buffered_ = 0;              ///< Bytes waiting in buffer_
+    uint64_t file_bytes_ = 0;          ///< Bytes written to the file so far
+    uint64_t checkpoint_bytes_ = 0;    ///< Data bytes between header checkpoints
+    uint64_t checkpointed_bytes_ = 0;  ///< Data bytes covered by the last checkpoint
 };
 
 }  // namespace ffvoice
@@ -11,22 +11,318 @@
 // Core ffvoice headers
 #include "audio/audio_capture_device.h"
 #include "audio/audio_mixer.h"
+#include "audio/capture_batcher.h"
 #include "audio/diarizer.h"
+#include "audio/transcription_cache.h"
 #ifdef ENABLE_RNNOISE
     #include "audio/rnnoise_processor.h"
 #endif
 #include "audio/vad_segmenter.h"
+#include "audio/whisper_model_catalog.h"
 #include "audio/whisper_processor.h"
 #ifdef ENABLE_WHISPER
+    #include "audio/caption_event_queue.h"
     #include "audio/live_captioner.h"
 #endif
 #include "media/flac_writer.h"
+#include "media/media_file_reader.h"
+#include "media/opus_writer.h"
 #include "media/wav_writer.h"
+#include "utils/audio_kernels.h"
+#include "utils/logger.h"
+#include "utils/metrics.h"
 #include "utils/ring_buffer.h"
 
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace py = pybind11;
 using namespace ffvoice;
 
+namespace {
+
+// Parse { track_id (int) : 1-D int16 NumPy array } for the mixer; every array
+// must have the same length. Returns that length.
+size_t CollectMixerInputs(const py::dict& tracks, std::vector<py::array_t<int16_t>>& arrays,
+                          std::vector<MixerInput>& inputs) {
+    size_t num_samples = 0;
+    bool first = true;
+    for (auto item : tracks) {
+        int track_id = item.first.cast<int>();
+        auto arr = item.second.cast<py::array_t<int16_t>>();
+        py::buffer_info buf = arr.request();
+        if (buf.ndim != 1) {
+            throw std::runtime_error("Each track array must be 1-dimensional");
+        }
+        size_t n = static_cast<size_t>(buf.shape[0]);
+        if (first) {
+            num_samples = n;
+            first = false;
+        } else if (n != num_samples) {
+            throw std::runtime_error("All track arrays must have the same length");
+        }
+        arrays.push_back(arr);
+        inputs.push_back(MixerInput{track_id, static_cast<const int16_t*>(buf.ptr)});
+    }
+    return num_samples;
+}
+
+enum class PcmType { Int16, Float32 };
+
+/**
+ * 1-D view of the samples held by a Python object, without copying when it
+ * exports a C-contiguous buffer (NumPy array, memoryview, bytes, bytearray,
+ * array.array) of int16 ('h') or float32 ('f') items. Raw byte buffers are
+ * read as native-endian int16 PCM. Anything else (lists, other dtypes,
+ * strided views) is converted once: float dtypes to float32, the rest to
+ * int16. Holding the view keeps the exporter's memory alive, so the GIL can
+ * be released while C++ reads it.
+ */
+struct PcmBuffer {
+    py::object converted;  // Owns the array when a conversion was needed
+    py::buffer_info info;
+    PcmType type = PcmType::Int16;
+    size_t count = 0;
+
+    const int16_t* int16_data() const {
+        return static_cast<const int16_t*>(info.ptr);
+    }
+    const float* float_data() const {
+        return static_cast<const float*>(info.ptr);
+    }
+};
+
+bool ViewBuffer(const py::object& obj, PcmBuffer& pcm) {
+    if (!PyObject_CheckBuffer(obj.ptr())) {
+        return false;
+    }
+    pcm.info = py::reinterpret_borrow<py::buffer>(obj).request();
+    if (pcm.info.ndim != 1) {
+        throw std::runtime_error("Audio array must be 1-dimensional (got " +
+                                 std::to_string(pcm.info.ndim) + " dimensions)");
+    }
+    if (pcm.info.strides[0] != pcm.info.itemsize) {
+        return false;  // Strided view: needs a contiguous copy
+    }
+
+    // Drop native byte-order prefixes; explicit big-endian data is converted below
+    std::string format = pcm.info.format;
+    const bool little_endian = std::endian::native == std::endian::little;
+    if (!format.empty() &&
+        (format[0] == '@' || format[0] == '=' || (format[0] == '<' && little_endian))) {
+        format.erase(0, 1);
+    }
+    if (format == "h" && pcm.info.itemsize == 2) {
+        pcm.type = PcmType::Int16;
+        pcm.count = static_cast<size_t>(pcm.info.shape[0]);
+    } else if (format == "f" && pcm.info.itemsize == 4) {
+        pcm.type = PcmType::Float32;
+        pcm.count = static_cast<size_t>(pcm.info.shape[0]);
+    } else if ((format == "B" || format == "b" || format == "c") && pcm.info.itemsize == 1) {
+        if (pcm.info.shape[0] % 2 != 0) {
+            throw std::runtime_error("Raw PCM bytes must hold whole int16 samples");
+        }
+        pcm.type = PcmType::Int16;
+        pcm.count = static_cast<size_t>(pcm.info.shape[0]) / 2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+PcmBuffer RequestPcm(const py::object& obj, bool writable = false) {
+    PcmBuffer pcm;
+    if (!ViewBuffer(obj, pcm)) {
+        if (writable) {
+            // A converted copy would be processed and thrown away
+            throw std::runtime_error(
+                "Audio array must be a C-contiguous int16 or float32 buffer to be processed "
+                "in place");
+        }
+        py::array array = py::array::ensure(obj);
+        if (!array) {
+            throw std::runtime_error("Audio must be an array or buffer of int16 or float32 "
+                                     "samples");
+        }
+        if (array.dtype().kind() == 'f') {
+            pcm.converted = py::array_t<float, py::array::c_style | py::array::forcecast>(array);
+            pcm.type = PcmType::Float32;
+        } else {
+            pcm.converted =
+                py::array_t<int16_t, py::array::c_style | py::array::forcecast>(array);
+            pcm.type = PcmType::Int16;
+        }
+        pcm.info = py::reinterpret_borrow<py::array>(pcm.converted).request();
+        if (pcm.info.ndim != 1) {
+            throw std::runtime_error("Audio array must be 1-dimensional (got " +
+                                     std::to_string(pcm.info.ndim) + " dimensions)");
+        }
+        pcm.count = static_cast<size_t>(pcm.info.shape[0]);
+    }
+
+    if (pcm.count > 0 && !pcm.info.ptr) {
+        throw std::runtime_error("Audio array has null data pointer");
+    }
+    if (writable && pcm.info.readonly) {
+        throw std::runtime_error("Audio array must be writable");
+    }
+    return pcm;
+}
+
+// Samples of @p pcm as float in [-1, 1] (copies; call without the GIL)
+std::vector<float> ToFloatSamples(const PcmBuffer& pcm) {
+    if (pcm.type == PcmType::Float32) {
+        return std::vector<float>(pcm.float_data(), pcm.float_data() + pcm.count);
+    }
+    std::vector<float> samples(pcm.count);
+    GetAudioKernels().int16_to_float(pcm.int16_data(), pcm.count, samples.data());
+    return samples;
+}
+
+/**
+ * Python face of CaptureBatcher: the PortAudio callback only fills the ring,
+ * and Python gets audio in batches (callback mode, from the drainer thread)
+ * or by calling read(). Callback batches come from a small pool of NumPy
+ * arrays; an array is refilled only once Python dropped every reference to
+ * it, so a kept batch is never overwritten.
+ */
+class BufferedCapture {
+public:
+    static constexpr size_t kPoolSize = 4;
+
+    BufferedCapture(AudioCaptureDevice& device, int batch_ms, int buffer_ms)
+        : device_(device), batch_ms_(batch_ms), buffer_ms_(buffer_ms) {
+        if (batch_ms <= 0 || buffer_ms < batch_ms) {
+            throw std::runtime_error("batch_ms must be positive and buffer_ms >= batch_ms");
+        }
+    }
+
+    ~BufferedCapture() {
+        py::gil_scoped_release release;  // The drainer may be waiting for the GIL
+        Stop();
+    }
+
+    bool Start(std::optional<py::function> callback) {
+        if (batcher_) {
+            throw std::runtime_error("BufferedCapture can only be started once");
+        }
+        if (!device_.IsOpen()) {
+            throw std::runtime_error("Audio device not open");
+        }
+        if (device_.GetFormat() != AudioFormat::INT16) {
+            throw std::runtime_error("BufferedCapture needs a device opened as INT16");
+        }
+
+        const size_t per_ms =
+            static_cast<size_t>(device_.GetSampleRate()) * device_.GetChannels();
+        CaptureBatcherConfig config;
+        config.batch_samples = per_ms * batch_ms_ / 1000;
+        config.capacity_samples = per_ms * buffer_ms_ / 1000;
+        batcher_ = std::make_unique<CaptureBatcher>(config);
+
+        if (callback) {
+            callback_ = *callback;
+            batcher_->StartDrainer(
+                [this](const int16_t* samples, size_t n) { Deliver(samples, n); });
+        }
+
+        CaptureBatcher* batcher = batcher_.get();
+        bool started = false;
+        {
+            py::gil_scoped_release release;
+            started = device_.Start(
+                [batcher](const int16_t* samples, size_t n) { batcher->Push(samples, n); });
+            if (!started) {
+                batcher->Stop();
+            }
+        }
+        if (!started) {
+            batcher_.reset();
+            callback_ = py::function();
+        }
+        return started;
+    }
+
+    // Call without the GIL: the drainer's last batches still need it
+    void Stop() {
+        if (batcher_) {
+            device_.Stop();
+            batcher_->Stop();
+        }
+    }
+
+    py::array_t<int16_t> Read(size_t count, double timeout) {
+        if (!batcher_) {
+            throw std::runtime_error("BufferedCapture not started");
+        }
+        if (callback_) {
+            throw std::runtime_error("read() is unavailable while a batch callback is set");
+        }
+        py::array_t<int16_t> out(static_cast<py::ssize_t>(count));
+        int16_t* data = out.mutable_data();
+        const int timeout_ms = timeout < 0.0 ? -1 : static_cast<int>(timeout * 1000.0);
+        size_t got = 0;
+        {
+            py::gil_scoped_release release;
+            got = batcher_->Read(data, count, timeout_ms);
+        }
+        if (got < count) {
+            out.resize({static_cast<py::ssize_t>(got)});
+        }
+        return out;
+    }
+
+    uint64_t GetDroppedSamples() const {
+        return batcher_ ? batcher_->GetDroppedSamples() : 0;
+    }
+
+    size_t GetAvailableSamples() const {
+        return batcher_ ? batcher_->GetAvailableSamples() : 0;
+    }
+
+private:
+    // Drainer thread: one GIL acquisition per batch
+    void Deliver(const int16_t* samples, size_t n) {
+        py::gil_scoped_acquire acquire;
+        try {
+            py::array_t<int16_t> batch = TakePoolArray(n);
+            std::memcpy(batch.mutable_data(), samples, n * sizeof(int16_t));
+            callback_(batch);
+        } catch (py::error_already_set& e) {
+            // Report like an exception in a __del__ method; keep draining
+            e.discard_as_unraisable("BufferedCapture batch callback");
+        } catch (const std::exception& e) {
+            py::print("Error in batch callback:", e.what());
+        }
+    }
+
+    py::array_t<int16_t> TakePoolArray(size_t n) {
+        for (auto& array : pool_) {
+            // Only the pool holds it: Python is done with this batch
+            if (array.ref_count() == 1 && static_cast<size_t>(array.size()) == n) {
+                return array;
+            }
+        }
+        py::array_t<int16_t> array(static_cast<py::ssize_t>(n));
+        if (pool_.size() < kPoolSize) {
+            pool_.push_back(array);
+        }
+        return array;
+    }
+
+    AudioCaptureDevice& device_;
+    const int batch_ms_;
+    const int buffer_ms_;
+    std::unique_ptr<CaptureBatcher> batcher_;
+    py::function callback_;
+    std::vector<py::array_t<int16_t>> pool_;
+};
+
+}  // namespace
+
 PYBIND11_MODULE(_ffvoice, m) {
     m.doc() = "High-performance offline speech recognition library for Python";
 
@@ -42,6 +338,8 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def_readonly("text", &Word::text, "Word text")
         .def_readonly("probability", &Word::probability,
                       "Mean token probability for this word (0.0-1.0)")
+        .def_readonly("speaker_id", &Word::speaker_id,
+                      "Speaker index, 0-based; -1 = unknown / diarization not run")
         .def("__repr__", [](const Word& w) {
             return "<Word [" + std::to_string(w.start_ms) + " -> " + std::to_string(w.end_ms) +
                    "] '" + w.text + "'>";
@@ -103,6 +401,55 @@ PYBIND11_MODULE(_ffvoice, m) {
         .value("LARGE", WhisperModelType::LARGE, "Best accuracy (~1550MB, <1x realtime)")
         .export_values();
 
+    // WhisperBackend enum
+    py::enum_<WhisperBackend>(m, "WhisperBackend")
+        .value("AUTO", WhisperBackend::AUTO, "First GPU if available, otherwise CPU")
+        .value("CPU", WhisperBackend::CPU, "CPU only")
+        .value("CUDA", WhisperBackend::CUDA, "NVIDIA GPU")
+        .value("METAL", WhisperBackend::METAL, "Apple GPU")
+        .value("VULKAN", WhisperBackend::VULKAN, "Vulkan GPU")
+        .value("OPENVINO", WhisperBackend::OPENVINO, "Encoder on an OpenVINO device")
+        .value("COREML", WhisperBackend::COREML, "Encoder on the Apple Neural Engine")
+        .export_values();
+
+    // WhisperAcceleration
+    py::class_<WhisperAcceleration>(m, "WhisperAcceleration")
+        .def(py::init<>())
+        .def_readwrite("backend", &WhisperAcceleration::backend, "Backend to run the model on")
+        .def_readwrite("gpu_device", &WhisperAcceleration::gpu_device,
+                       "GPU index within the backend (for AUTO, among all GPUs)")
+        .def_readwrite("flash_attn", &WhisperAcceleration::flash_attn,
+                       "Use flash attention in the decoder")
+        .def_readwrite("openvino_device", &WhisperAcceleration::openvino_device,
+                       "OpenVINO device for the encoder ('CPU', 'GPU', 'NPU', ...)")
+        .def_readwrite("openvino_cache_dir", &WhisperAcceleration::openvino_cache_dir,
+                       "Directory for compiled OpenVINO kernels (empty = beside the model)");
+
+    // WhisperDeviceInfo
+    py::class_<WhisperDeviceInfo>(m, "WhisperDeviceInfo")
+        .def_readonly("backend", &WhisperDeviceInfo::backend, "CUDA, METAL or VULKAN")
+        .def_readonly("index", &WhisperDeviceInfo::index, "Index among the backend's GPUs")
+        .def_readonly("name", &WhisperDeviceInfo::name, "ggml device name, e.g. 'CUDA0'")
+        .def_readonly("description", &WhisperDeviceInfo::description, "Device description")
+        .def_readonly("memory_free", &WhisperDeviceInfo::memory_free, "Free memory in bytes")
+        .def_readonly("memory_total", &WhisperDeviceInfo::memory_total, "Total memory in bytes")
+        .def("__repr__", [](const WhisperDeviceInfo& d) {
+            return "<WhisperDeviceInfo " + GetWhisperBackendName(d.backend) + ":" +
+                   std::to_string(d.index) + " " + d.name + " '" + d.description + "'>";
+        });
+
+    // WhisperCapabilities
+    py::class_<WhisperCapabilities>(m, "WhisperCapabilities")
+        .def_readonly("backends", &WhisperCapabilities::backends, "Usable backends")
+        .def_readonly("devices", &WhisperCapabilities::devices, "GPUs found")
+        .def_readonly("system_info", &WhisperCapabilities::system_info,
+                      "whisper.cpp system info string")
+        .def("supports", &WhisperCapabilities::Supports, py::arg("backend"),
+             "Check whether a backend can be selected");
+
+    m.def("probe_whisper_capabilities", &ProbeWhisperCapabilities,
+          "List the Whisper backends and GPUs available in this build");
+
     // WhisperConfig
     py::class_<WhisperConfig>(m, "WhisperConfig")
         .def(py::init<>())
@@ -122,19 +469,55 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def_readwrite("word_timestamps", &WhisperConfig::word_timestamps,
                        "Populate per-word timestamps in each transcription segment")
         .def_readwrite("input_sample_rate", &WhisperConfig::input_sample_rate,
-                       "Sample rate (Hz) of audio passed to transcribe_buffer()");
+                       "Sample rate (Hz) of audio passed to transcribe_buffer()")
+        .def_readwrite("initial_prompt", &WhisperConfig::initial_prompt,
+                       "Text that conditions decoding (empty = none)")
+        .def_readwrite("share_model", &WhisperConfig::share_model,
+                       "Load the model once per process and borrow a decoder state per call")
+        .def_readwrite("max_shared_states", &WhisperConfig::max_shared_states,
+                       "Decoder state pool limit for a shared model (0 = unlimited)")
+        .def_readwrite("acceleration", &WhisperConfig::acceleration,
+                       "Backend, GPU device and flash attention (WhisperAcceleration)")
+        .def_readwrite("use_mmap", &WhisperConfig::use_mmap,
+                       "Memory-map the model file instead of reading it through stdio")
+        .def_readwrite("warmup", &WhisperConfig::warmup,
+                       "Run one silent inference during initialize() so the first real call is "
+                       "not slowed by first-touch allocations")
+        .def_readwrite("cache_dir", &WhisperConfig::cache_dir,
+                       "Reuse transcribe_file() results stored in this directory (empty = off)")
+        .def_readwrite("cache_max_mb", &WhisperConfig::cache_max_mb,
+                       "Size bound of cache_dir in MiB; least recently used entries are evicted");
+
+    // TranscriptionCacheStats
+    py::class_<TranscriptionCacheStats>(m, "TranscriptionCacheStats")
+        .def_readonly("hits", &TranscriptionCacheStats::hits, "Lookups answered from the cache")
+        .def_readonly("misses", &TranscriptionCacheStats::misses, "Lookups with no valid entry")
+        .def_readonly("stores", &TranscriptionCacheStats::stores, "Entries written")
+        .def_readonly("evictions", &TranscriptionCacheStats::evictions,
+                      "Entries deleted to stay under the size bound")
+        .def_readonly("entries", &TranscriptionCacheStats::entries,
+                      "Entries currently in the directory")
+        .def_readonly("bytes", &TranscriptionCacheStats::bytes, "Total size of the entries");
 
     // WhisperProcessor
     py::class_<WhisperProcessor>(m, "WhisperASR")
         .def(py::init<const WhisperConfig&>(), py::arg("config") = WhisperConfig(),
              "Initialize Whisper ASR processor")
-        .def("initialize", &WhisperProcessor::Initialize, "Initialize the Whisper model")
+        .def("initialize", &WhisperProcessor::Initialize, py::call_guard<py::gil_scoped_release>(),
+             "Initialize the Whisper model")
         .def("is_initialized", &WhisperProcessor::IsInitialized, "Check if the model is loaded")
+        .def("warmup", &WhisperProcessor::Warmup, py::call_guard<py::gil_scoped_release>(),
+             "Run one silent inference to pay first-call costs up front")
         .def(
             "transcribe_file",
             [](WhisperProcessor& self, const std::string& audio_file) {
                 std::vector<TranscriptionSegment> segments;
-                bool success = self.TranscribeFile(audio_file, segments);
+                bool success = false;
+                {
+                    // Decoding and inference take seconds; let other threads run
+                    py::gil_scoped_release release;
+                    success = self.TranscribeFile(audio_file, segments);
+                }
                 if (!success) {
                     throw std::runtime_error("Transcription failed: " + self.GetLastError());
                 }
@@ -143,46 +526,140 @@ PYBIND11_MODULE(_ffvoice, m) {
             py::arg("audio_file"), "Transcribe an audio file and return segments")
         .def(
             "transcribe_buffer",
-            [](WhisperProcessor& self, py::array_t<int16_t> audio_array) {
-                // Get buffer info
-                py::buffer_info buf = audio_array.request();
-
-                // Validate buffer pointer
-                if (!buf.ptr) {
-                    throw std::runtime_error("Audio array has null data pointer");
-                }
-
-                // Validate buffer size
-                if (buf.size == 0) {
+            [](WhisperProcessor& self, const py::object& audio_array) {
+                // Read in place from any int16/float32 buffer
+                PcmBuffer pcm = RequestPcm(audio_array);
+                if (pcm.count == 0) {
                     throw std::runtime_error("Audio array is empty");
                 }
 
-                // Validate dimensions (should be 1D array)
-                if (buf.ndim != 1) {
-                    throw std::runtime_error("Audio array must be 1-dimensional (got " +
-                                             std::to_string(buf.ndim) + " dimensions)");
-                }
-
-                // Get pointer and size
-                int16_t* samples = static_cast<int16_t*>(buf.ptr);
-                size_t num_samples = buf.shape[0];
-
-                // Transcribe
                 std::vector<TranscriptionSegment> segments;
-                bool success = self.TranscribeBuffer(samples, num_samples, segments);
+                bool success = false;
+                {
+                    py::gil_scoped_release release;
+                    success = pcm.type == PcmType::Float32
+                                  ? self.TranscribeBuffer(pcm.float_data(), pcm.count, segments)
+                                  : self.TranscribeBuffer(pcm.int16_data(), pcm.count, segments);
+                }
                 if (!success) {
                     throw std::runtime_error("Transcription failed: " + self.GetLastError());
                 }
                 return segments;
             },
             py::arg("audio_array"),
-            "Transcribe audio from NumPy array (int16, 1D) and return segments")
+            "Transcribe a 1-D mono buffer at WhisperConfig.input_sample_rate and return "
+            "segments: int16 PCM (NumPy array, bytes, memoryview) or float32 in [-1, 1]. "
+            "Releases the GIL while transcribing")
         .def("get_last_error", &WhisperProcessor::GetLastError, "Get last error message")
         .def("get_last_inference_time_ms", &WhisperProcessor::GetLastInferenceTimeMs,
              "Get last inference time in milliseconds")
+        .def("get_backend_description", &WhisperProcessor::GetBackendDescription,
+             "Where the model runs, e.g. 'CUDA0 (NVIDIA L4)' or 'CPU'")
+        .def(
+            "get_cache_stats",
+            [](const WhisperProcessor& self) {
+                const TranscriptionCache* cache = self.GetCache();
+                return cache ? cache->GetStats() : TranscriptionCacheStats{};
+            },
+            "Result cache counters (all zero when WhisperConfig.cache_dir is empty)")
         .def_static("get_model_type_name", &WhisperProcessor::GetModelTypeName,
                     py::arg("model_type"), "Get model type name as string");
 
+    // ========== Whisper Model Catalog ==========
+
+    // WhisperQuantization enum
+    py::enum_<WhisperQuantization>(m, "WhisperQuantization")
+        .value("F16", WhisperQuantization::F16, "Original half-precision weights")
+        .value("Q8_0", WhisperQuantization::Q8_0, "8-bit, near-lossless")
+        .value("Q5_1", WhisperQuantization::Q5_1, "5-bit with offsets")
+        .value("Q5_0", WhisperQuantization::Q5_0, "5-bit")
+        .export_values();
+
+    // WhisperModelVariant
+    py::class_<WhisperModelVariant>(m, "WhisperModelVariant")
+        .def_readonly("type", &WhisperModelVariant::type, "Model size (WhisperModelType)")
+        .def_readonly("quantization", &WhisperModelVariant::quantization, "Weight format")
+        .def_readonly("name", &WhisperModelVariant::name, "Catalog name, e.g. 'small-q5_1'")
+        .def_readonly("filename", &WhisperModelVariant::filename, "GGML file name")
+        .def_readonly("file_mb", &WhisperModelVariant::file_mb, "File size / weights in MB")
+        .def_readonly("state_mb", &WhisperModelVariant::state_mb, "Per-decode state in MB")
+        .def_readonly("relative_cost", &WhisperModelVariant::relative_cost,
+                      "Compute per second of audio relative to tiny F16")
+        .def("__repr__", [](const WhisperModelVariant& v) {
+            return "<WhisperModelVariant " + v.name + " " + std::to_string(v.file_mb) + " MB>";
+        });
+
+    // WhisperResourceBudget
+    py::class_<WhisperResourceBudget>(m, "WhisperResourceBudget")
+        .def(py::init<>())
+        .def_readwrite("max_rtf", &WhisperResourceBudget::max_rtf,
+                       "Highest decode time / audio time per stream (lower = faster)")
+        .def_readwrite("concurrency", &WhisperResourceBudget::concurrency,
+                       "Streams decoding at the same time")
+        .def_readwrite("max_memory_mb", &WhisperResourceBudget::max_memory_mb,
+                       "Memory for weights and states in MB (0 = unlimited)")
+        .def_readwrite("share_model", &WhisperResourceBudget::share_model,
+                       "Weights loaded once for all streams")
+        .def_readwrite("allow_quantized", &WhisperResourceBudget::allow_quantized,
+                       "Consider q8_0 / q5_x files")
+        .def_readwrite("model_dir", &WhisperResourceBudget::model_dir,
+                       "If set, only variants whose file exists in this directory");
+
+    // WhisperModelChoice
+    py::class_<WhisperModelChoice>(m, "WhisperModelChoice")
+        .def_readonly("variant", &WhisperModelChoice::variant, "Selected variant")
+        .def_readonly("estimated_rtf", &WhisperModelChoice::estimated_rtf,
+                      "Per-stream realtime factor at the budget's concurrency")
+        .def_readonly("estimated_memory_mb", &WhisperModelChoice::estimated_memory_mb,
+                      "Weights and states for all streams in MB")
+        .def_readonly("measured", &WhisperModelChoice::measured,
+                      "The estimate comes from calibrating this variant");
+
+    // WhisperModelCatalog
+    py::class_<WhisperModelCatalog>(m, "WhisperModelCatalog")
+        .def(py::init<>())
+        .def("get_variants", &WhisperModelCatalog::GetVariants,
+             "Every published variant, smallest size first")
+        .def(
+            "find",
+            [](const WhisperModelCatalog& self, const std::string& name) {
+                const WhisperModelVariant* variant = self.Find(name);
+                return variant ? std::optional<WhisperModelVariant>(*variant) : std::nullopt;
+            },
+            py::arg("name"), "Variant by catalog name, or None")
+        .def("calibrate", &WhisperModelCatalog::Calibrate, py::arg("variant"),
+             py::arg("model_path"), py::arg("config") = WhisperConfig(),
+             py::arg("audio_seconds") = 10.0, py::call_guard<py::gil_scoped_release>(),
+             "Measure a variant's realtime factor with a real model file; False on failure")
+        .def("calibrate_smallest_available", &WhisperModelCatalog::CalibrateSmallestAvailable,
+             py::arg("model_dir"), py::arg("config") = WhisperConfig(),
+             py::arg("audio_seconds") = 10.0, py::call_guard<py::gil_scoped_release>(),
+             "First-run calibration with the cheapest catalog file in model_dir")
+        .def("set_measured_rtf", &WhisperModelCatalog::SetMeasuredRtf, py::arg("name"),
+             py::arg("rtf"), "Record a realtime factor measured elsewhere")
+        .def("is_calibrated", &WhisperModelCatalog::IsCalibrated,
+             "True once any variant has a measurement")
+        .def("estimate_rtf", &WhisperModelCatalog::EstimateRtf, py::arg("variant"),
+             "Realtime factor of one stream decoding alone")
+        .def_static("estimate_memory_mb", &WhisperModelCatalog::EstimateMemoryMb,
+                    py::arg("variant"), py::arg("concurrency"), py::arg("share_model") = true,
+                    "Memory in MB for concurrency streams of a variant")
+        .def(
+            "select",
+            [](const WhisperModelCatalog& self, const WhisperResourceBudget& budget) {
+                WhisperModelChoice choice;
+                if (!self.Select(budget, choice)) {
+                    throw std::runtime_error(self.GetLastError());
+                }
+                return choice;
+            },
+            py::arg("budget"), "Largest, least quantized variant that fits the budget")
+        .def("load_calibration", &WhisperModelCatalog::LoadCalibration, py::arg("path"),
+             "Read measurements saved by save_calibration()")
+        .def("save_calibration", &WhisperModelCatalog::SaveCalibration, py::arg("path"),
+             "Write the measurements to a text file")
+        .def("get_last_error", &WhisperModelCatalog::GetLastError, "Get last error message");
+
     // ========== Audio Device Info ==========
 
     // AudioDeviceInfo
@@ -202,9 +679,17 @@ PYBIND11_MODULE(_ffvoice, m) {
     // AudioCaptureDevice
     py::class_<AudioCaptureDevice>(m, "AudioCapture")
         .def(py::init<>(), "Initialize audio capture device")
-        .def("open", &AudioCaptureDevice::Open, py::arg("device_id") = -1,
-             py::arg("sample_rate") = 48000, py::arg("channels") = 1,
-             py::arg("frames_per_buffer") = 256, "Open audio capture device")
+        .def(
+            "open",
+            [](AudioCaptureDevice& self, int device_id, int sample_rate, int channels,
+               int frames_per_buffer, double suggested_latency_ms) {
+                return self.Open(device_id, sample_rate, channels, frames_per_buffer,
+                                 AudioFormat::INT16, suggested_latency_ms);
+            },
+            py::arg("device_id") = -1, py::arg("sample_rate") = 48000, py::arg("channels") = 1,
+            py::arg("frames_per_buffer") = 256, py::arg("suggested_latency_ms") = 0.0,
+            "Open audio capture device (frames_per_buffer 0 lets PortAudio choose; "
+            "suggested_latency_ms 0 uses the device's low-latency default)")
         .def(
             "start",
             [](AudioCaptureDevice& self, py::function callback) {
@@ -237,12 +722,43 @@ PYBIND11_MODULE(_ffvoice, m) {
             },
             py::arg("callback"),
             "Start capturing audio with Python callback (receives NumPy array)")
-        .def("stop", &AudioCaptureDevice::Stop, "Stop capturing audio")
-        .def("close", &AudioCaptureDevice::Close, "Close the device")
+        .def("start_blocking", &AudioCaptureDevice::StartBlocking,
+             "Start capturing without a callback; pull audio with read()")
+        .def(
+            "read",
+            [](AudioCaptureDevice& self, size_t num_frames) {
+                py::array_t<int16_t> audio(num_frames * self.GetChannels());
+                int16_t* out = audio.mutable_data();
+                bool ok;
+                {
+                    // Blocks until num_frames are captured
+                    py::gil_scoped_release release;
+                    ok = self.Read(out, num_frames);
+                }
+                if (!ok) {
+                    throw std::runtime_error("Read failed (is the device started with "
+                                             "start_blocking()?)");
+                }
+                return audio;
+            },
+            py::arg("num_frames"),
+            "Block until num_frames frames are captured (after start_blocking()); "
+            "returns interleaved int16 samples")
+        .def("get_read_available", &AudioCaptureDevice::GetReadAvailable,
+             "Frames read() can return without blocking (-1 if not in blocking mode)")
+        // Stopping waits for a running callback, which may be waiting for the GIL
+        .def("stop", &AudioCaptureDevice::Stop, py::call_guard<py::gil_scoped_release>(),
+             "Stop capturing audio")
+        .def("close", &AudioCaptureDevice::Close, py::call_guard<py::gil_scoped_release>(),
+             "Close the device")
         .def("is_open", &AudioCaptureDevice::IsOpen, "Check if device is open")
         .def("is_capturing", &AudioCaptureDevice::IsCapturing, "Check if currently capturing")
         .def("get_sample_rate", &AudioCaptureDevice::GetSampleRate, "Get current sample rate")
         .def("get_channels", &AudioCaptureDevice::GetChannels, "Get current channel count")
+        .def("get_frames_per_buffer", &AudioCaptureDevice::GetFramesPerBuffer,
+             "Requested frames per buffer (0 = chosen by PortAudio)")
+        .def("get_input_latency_ms", &AudioCaptureDevice::GetInputLatencyMs,
+             "Input latency PortAudio reports for the open stream, in ms")
         .def_static("initialize", &AudioCaptureDevice::Initialize, "Initialize PortAudio")
         .def_static("terminate", &AudioCaptureDevice::Terminate, "Terminate PortAudio")
         .def_static("get_devices", &AudioCaptureDevice::GetDevices,
@@ -250,6 +766,30 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def_static("get_default_input_device", &AudioCaptureDevice::GetDefaultInputDevice,
                     "Get default input device ID");
 
+    // BufferedCapture
+    py::class_<BufferedCapture>(m, "BufferedCapture")
+        .def(py::init<AudioCaptureDevice&, int, int>(), py::arg("capture"),
+             py::arg("batch_ms") = 100, py::arg("buffer_ms") = 2000, py::keep_alive<1, 2>(),
+             "Buffer an opened AudioCapture in C++ and hand audio to Python in batches")
+        .def("start", &BufferedCapture::Start, py::arg("callback") = py::none(),
+             "Start capturing. With a callback, it receives one int16 NumPy array per "
+             "batch_ms from a drainer thread (arrays are recycled once released); without "
+             "one, pull audio with read()")
+        .def(
+            "stop",
+            [](BufferedCapture& self) {
+                py::gil_scoped_release release;
+                self.Stop();
+            },
+            "Stop the device and deliver the buffered tail to the callback")
+        .def("read", &BufferedCapture::Read, py::arg("num_samples"), py::arg("timeout") = -1.0,
+             "Return up to num_samples int16 samples, waiting at most timeout seconds "
+             "(negative = until available or stopped). Releases the GIL while waiting")
+        .def("get_dropped_samples", &BufferedCapture::GetDroppedSamples,
+             "Samples lost because the buffer was full (Python fell behind)")
+        .def("get_available_samples", &BufferedCapture::GetAvailableSamples,
+             "Samples buffered and not yet read");
+
 #ifdef ENABLE_RNNOISE
     // ========== RNNoise Processor ==========
 
@@ -267,43 +807,31 @@ PYBIND11_MODULE(_ffvoice, m) {
              py::arg("channels"), "Initialize with sample rate and channels")
         .def(
             "process",
-            [](RNNoiseProcessor& self, py::array_t<int16_t> audio_array) {
-                // Get buffer info
-                py::buffer_info buf = audio_array.request();
-
-                // Validate buffer pointer
-                if (!buf.ptr) {
-                    throw std::runtime_error("Audio array has null data pointer");
-                }
-
-                // Validate buffer size
-                if (buf.size == 0) {
+            [](RNNoiseProcessor& self, const py::object& audio_array) {
+                PcmBuffer pcm = RequestPcm(audio_array, /*writable=*/true);
+                if (pcm.count == 0) {
                     throw std::runtime_error("Audio array is empty");
                 }
 
-                // Validate dimensions (should be 1D array)
-                if (buf.ndim != 1) {
-                    throw std::runtime_error("Audio array must be 1-dimensional (got " +
-                                             std::to_string(buf.ndim) + " dimensions)");
-                }
-
-                // Check if array is writable
-                if (buf.readonly) {
-                    throw std::runtime_error("Audio array must be writable");
+                // Process audio (in-place) without holding the GIL
+                py::gil_scoped_release release;
+                if (pcm.type == PcmType::Float32) {
+                    self.Process(static_cast<float*>(pcm.info.ptr), pcm.count);
+                } else {
+                    self.Process(static_cast<int16_t*>(pcm.info.ptr), pcm.count);
                 }
-
-                // Get pointer and size
-                int16_t* samples = static_cast<int16_t*>(buf.ptr);
-                size_t num_samples = buf.shape[0];
-
-                // Process audio (in-place)
-                self.Process(samples, num_samples);
             },
             py::arg("audio_array"),
-            "Process audio with RNNoise (in-place modification of NumPy array)")
+            "Denoise a writable 1-D int16 or float32 buffer (NumPy array, bytearray, "
+            "memoryview) in place")
         .def("reset", &RNNoiseProcessor::Reset, "Reset internal state")
         .def("get_vad_probability", &RNNoiseProcessor::GetVADProbability,
-             "Get last VAD probability (0.0-1.0)");
+             "Get last VAD probability (0.0-1.0)")
+        .def("get_frame_vad_probabilities", &RNNoiseProcessor::GetFrameVADProbabilities,
+             "VAD probability of each 10 ms frame completed by the last process() call")
+        .def("get_frame_vad_offset", &RNNoiseProcessor::GetFrameVADOffset,
+             "Samples from the start of the last process() block to the output audio the "
+             "first frame VAD probability describes");
 #endif  // ENABLE_RNNOISE
 
 #ifdef ENABLE_WHISPER
@@ -329,12 +857,30 @@ PYBIND11_MODULE(_ffvoice, m) {
                       "Mean segment confidence (0.0 for Partial; mean for Final)")
         .def_readonly("utterance_id", &CaptionEvent::utterance_id,
                       "Monotonically incrementing utterance counter")
+        .def_readonly("speaker_id", &CaptionEvent::speaker_id,
+                      "Final: speaker index from the configured speaker_fn; -1 = unknown")
+        .def_readonly("language", &CaptionEvent::language,
+                      "Language the caption was decoded in (e.g. 'en'); empty if unknown")
         .def("__repr__", [](const CaptionEvent& ev) {
             std::string type_str = (ev.type == CaptionEventType::Final) ? "Final" : "Partial";
             return "<CaptionEvent " + type_str + " id=" + std::to_string(ev.utterance_id) + " '" +
                    ev.text + "'>";
         });
 
+    // LanguageLock::Config
+    py::class_<LanguageLock::Config>(m, "LanguageLockConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &LanguageLock::Config::enabled,
+                       "Pin the detected language; False detects it on every decode")
+        .def_readwrite("probe_ms", &LanguageLock::Config::probe_ms,
+                       "Speech (ms) to detect the language over before locking it")
+        .def_readwrite("probe_utterances", &LanguageLock::Config::probe_utterances,
+                       "Lock after this many finals if probe_ms is not reached first")
+        .def_readwrite("reprobe_confidence", &LanguageLock::Config::reprobe_confidence,
+                       "Finals below this mean confidence count as weak")
+        .def_readwrite("reprobe_after", &LanguageLock::Config::reprobe_after,
+                       "Consecutive weak finals that release the language for detection");
+
     // LiveCaptionerConfig
     py::class_<LiveCaptionerConfig>(m, "LiveCaptionerConfig")
         .def(py::init<>())
@@ -342,24 +888,35 @@ PYBIND11_MODULE(_ffvoice, m) {
                        "Whisper ASR configuration (model path, language, threads, …)")
         .def_readwrite("vad", &LiveCaptionerConfig::vad,
                        "VAD segmentation configuration (thresholds, min frames, …)")
+        .def_readwrite("language_lock", &LiveCaptionerConfig::language_lock,
+                       "Session language lock used when whisper.language is 'auto'")
         .def_readwrite("partial_interval_ms", &LiveCaptionerConfig::partial_interval_ms,
                        "Interval between Partial caption attempts while in speech (ms)")
         .def_readwrite("min_samples_for_partial", &LiveCaptionerConfig::min_samples_for_partial,
                        "Minimum accumulated samples before a Partial is emitted")
+        .def_readwrite("incremental_partials", &LiveCaptionerConfig::incremental_partials,
+                       "Decode only the unconfirmed tail of the utterance for each Partial")
+        .def_readwrite("partial_window_ms", &LiveCaptionerConfig::partial_window_ms,
+                       "Maximum audio re-decoded per incremental Partial (ms)")
         .def_readwrite("ring_buffer_capacity", &LiveCaptionerConfig::ring_buffer_capacity,
                        "Ring buffer capacity in samples (default ≈ 3 s at 48 kHz)")
+        .def_readwrite("max_pending_jobs", &LiveCaptionerConfig::max_pending_jobs,
+                       "Maximum transcription jobs waiting for the inference thread")
         .def_readwrite("sample_rate", &LiveCaptionerConfig::sample_rate,
                        "Input audio sample rate (Hz)")
         .def_readwrite("channels", &LiveCaptionerConfig::channels,
                        "Input audio channel count (1 = mono, 2 = stereo)")
         .def_readwrite("suppress_whisper_progress", &LiveCaptionerConfig::suppress_whisper_progress,
-                       "When true, Whisper's built-in progress messages are silenced");
+                       "When true, Whisper's built-in progress messages are silenced")
+        .def_readwrite("background_init", &LiveCaptionerConfig::background_init,
+                       "Load the model on a background thread so initialize() returns at once; "
+                       "audio pushed meanwhile is buffered");
 
     // LiveCaptioner
     py::class_<LiveCaptioner>(m, "LiveCaptioner")
         .def(py::init<const LiveCaptionerConfig&>(), py::arg("config") = LiveCaptionerConfig(),
              "Construct a LiveCaptioner with the given configuration")
-        .def("initialize", &LiveCaptioner::Initialize,
+        .def("initialize", &LiveCaptioner::Initialize, py::call_guard<py::gil_scoped_release>(),
              "Load the Whisper model and prepare internal state; must be called before start()")
         .def(
             "set_callback",
@@ -384,43 +941,93 @@ PYBIND11_MODULE(_ffvoice, m) {
             py::arg("callback"),
             "Register the Python callable invoked on each CaptionEvent (called from worker thread)")
         .def("start", &LiveCaptioner::Start, "Start the worker thread and begin processing audio")
-        .def("stop", &LiveCaptioner::Stop,
+        // Joins the worker, whose caption callback may be waiting for the GIL
+        .def("stop", &LiveCaptioner::Stop, py::call_guard<py::gil_scoped_release>(),
              "Stop the worker thread and flush any buffered audio; blocks until joined")
         .def(
             "feed_audio",
-            [](LiveCaptioner& self, py::array_t<int16_t> audio_array) {
-                // Get buffer info
-                py::buffer_info buf = audio_array.request();
-
-                // Validate buffer pointer
-                if (!buf.ptr) {
-                    throw std::runtime_error("Audio array has null data pointer");
-                }
-
-                // Validate buffer size
-                if (buf.size == 0) {
+            [](LiveCaptioner& self, const py::object& audio_array,
+               std::optional<std::vector<float>> frame_vad_probs, size_t frame_vad_offset) {
+                PcmBuffer pcm = RequestPcm(audio_array);
+                if (pcm.count == 0) {
                     throw std::runtime_error("Audio array is empty");
                 }
 
-                // Validate dimensions (should be 1D array)
-                if (buf.ndim != 1) {
-                    throw std::runtime_error("Audio array must be 1-dimensional (got " +
-                                             std::to_string(buf.ndim) + " dimensions)");
-                }
-
-                const int16_t* samples = static_cast<const int16_t*>(buf.ptr);
-                size_t count = static_cast<size_t>(buf.shape[0]);
+                const size_t count = pcm.count;
+                const float* probs = frame_vad_probs ? frame_vad_probs->data() : nullptr;
+                const size_t num_probs = frame_vad_probs ? frame_vad_probs->size() : 0;
 
                 // Release GIL during the lock-free ring buffer write
                 py::gil_scoped_release release;
-                return self.FeedAudio(samples, count);
+                if (pcm.type == PcmType::Float32) {
+                    std::vector<int16_t> samples(count);
+                    GetAudioKernels().float_to_int16(pcm.float_data(), count, samples.data());
+                    return self.FeedAudio(samples.data(), count, probs, num_probs,
+                                          frame_vad_offset);
+                }
+                return self.FeedAudio(pcm.int16_data(), count, probs, num_probs,
+                                      frame_vad_offset);
             },
-            py::arg("audio_array"),
-            "Feed raw int16 PCM samples into the ring buffer; returns samples actually written")
+            py::arg("audio_array"), py::arg("frame_vad_probs") = py::none(),
+            py::arg("frame_vad_offset") = 0,
+            "Feed int16 PCM (NumPy array, bytes, memoryview; float32 in [-1, 1] is converted) "
+            "into the ring buffer, optionally with VAD probabilities for consecutive 10 ms "
+            "frames starting frame_vad_offset samples into the block (e.g. "
+            "RNNoise.get_frame_vad_probabilities() and get_frame_vad_offset()); returns "
+            "samples actually written")
         .def("is_running", &LiveCaptioner::IsRunning,
              "True between a successful start() and stop()")
+        .def("get_dropped_partials", &LiveCaptioner::GetDroppedPartials,
+             "Number of Partial jobs discarded before being transcribed")
+        .def(
+            "events",
+            [](LiveCaptioner& self, size_t capacity) {
+                if (self.IsRunning()) {
+                    throw std::runtime_error("events() must be called before start()");
+                }
+                auto queue = std::make_shared<CaptionEventQueue>(capacity);
+                self.SetEventQueue(queue);
+                return py::module_::import("ffvoice._aio").attr("CaptionEventIterator")(queue);
+            },
+            py::arg("capacity") = CaptionEventQueue::kDefaultCapacity,
+            "Return an async iterator of CaptionEvents (async for ev in captioner.events()); "
+            "events are queued without taking the GIL and iteration ends after stop(). "
+            "Call before start()")
+        .def("is_model_ready", &LiveCaptioner::IsModelReady,
+             "True once the Whisper model has loaded (see background_init)")
+        .def("get_time_to_first_caption_ms", &LiveCaptioner::GetTimeToFirstCaptionMs,
+             "Milliseconds from initialize() to the first emitted caption (-1 until then)")
         .def("get_last_error", &LiveCaptioner::GetLastError,
              "Return the last error message (empty string if no error)");
+
+    // CaptionEventStream: pull side of LiveCaptioner.events()
+    py::class_<CaptionEventQueue, std::shared_ptr<CaptionEventQueue>>(m, "CaptionEventStream")
+        .def("fileno", &CaptionEventQueue::GetReadyFd,
+             "Descriptor readable while events are pending or after close (-1 on Windows)")
+        .def(
+            "drain",
+            [](CaptionEventQueue& self) {
+                // Clear first: an event pushed during the drain re-arms the descriptor
+                self.ClearReady();
+                std::vector<CaptionEvent> events;
+                CaptionEvent ev;
+                while (self.Pop(ev)) {
+                    events.push_back(std::move(ev));
+                }
+                return events;
+            },
+            "Take every queued event, oldest first")
+        .def(
+            "wait",
+            [](CaptionEventQueue& self, double timeout) {
+                return self.WaitForEvent(timeout < 0.0 ? -1 : static_cast<int>(timeout * 1000.0));
+            },
+            py::arg("timeout") = -1.0, py::call_guard<py::gil_scoped_release>(),
+            "Block until an event is queued or the stream closes; True if one is ready")
+        .def_property_readonly("closed", &CaptionEventQueue::IsClosed,
+                               "True once the captioner stopped; no more events follow")
+        .def("get_dropped_events", &CaptionEventQueue::GetDroppedEvents,
+             "Events lost because the consumer fell behind");
 #endif  // ENABLE_WHISPER
 
 #ifdef ENABLE_DIARIZATION
@@ -438,41 +1045,86 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def_readwrite("cluster_threshold", &DiarizerConfig::cluster_threshold,
                        "Clustering distance threshold (used only when num_speakers <= 0)")
         .def_readwrite("num_threads", &DiarizerConfig::num_threads,
-                       "Inference threads for the segmentation and embedding models");
+                       "Inference threads for the segmentation and embedding models")
+        .def_readwrite("window_s", &DiarizerConfig::window_s,
+                       "Diarize recordings longer than this in parallel windows; 0 = one pass")
+        .def_readwrite("window_overlap_s", &DiarizerConfig::window_overlap_s,
+                       "Overlap between consecutive windows in seconds")
+        .def_readwrite("num_workers", &DiarizerConfig::num_workers,
+                       "Windows diarized at once; 0 = hardware threads / num_threads");
 
     // Diarizer
     py::class_<Diarizer>(m, "Diarizer")
         .def(py::init<const DiarizerConfig&>(), py::arg("config") = DiarizerConfig(),
              "Construct a Diarizer with the given configuration")
-        .def("init", &Diarizer::Init,
+        .def("init", &Diarizer::Init, py::call_guard<py::gil_scoped_release>(),
              "Initialize the diarizer and load the models; returns True on success")
         .def("is_initialized", &Diarizer::IsInitialized,
              "Return True once init() has completed successfully")
         .def(
             "diarize",
-            [](Diarizer& self, py::array_t<float> audio_array, int sample_rate) {
-                py::buffer_info buf = audio_array.request();
+            [](Diarizer& self, const py::object& audio_array, int sample_rate) {
+                PcmBuffer pcm = RequestPcm(audio_array);
 
-                // Validate dimensions (should be 1D array)
-                if (buf.ndim != 1) {
-                    throw std::runtime_error("Audio array must be 1-dimensional (got " +
-                                             std::to_string(buf.ndim) + " dimensions)");
-                }
-
-                // Copy samples to a std::vector
-                const float* data = static_cast<const float*>(buf.ptr);
-                std::vector<float> samples(data, data + buf.shape[0]);
-
-                // Release the GIL during diarization (no Python access inside)
+                // Release the GIL during the copy and diarization (no Python access inside)
                 py::gil_scoped_release release;
-                return self.Diarize(samples, sample_rate);
+                return self.Diarize(ToFloatSamples(pcm), sample_rate);
             },
             py::arg("audio_array"), py::arg("sample_rate") = 16000,
-            "Run speaker diarization on a 1-D float32 NumPy array of mono PCM samples")
+            "Run speaker diarization on 1-D mono PCM: float32 in [-1, 1] or int16 (NumPy "
+            "array, bytes, memoryview)")
         .def("get_last_error", &Diarizer::GetLastError,
              "Return the last error message (empty string if no error)")
         .def("get_expected_sample_rate", &Diarizer::GetExpectedSampleRate,
              "Return the input sample rate the models expect (Hz)");
+
+    // OnlineDiarizerConfig
+    py::class_<OnlineDiarizerConfig>(m, "OnlineDiarizerConfig")
+        .def(py::init<>())
+        .def_readwrite("embedding_model_path", &OnlineDiarizerConfig::embedding_model_path,
+                       "Path to the speaker-embedding model (.onnx)")
+        .def_readwrite("num_threads", &OnlineDiarizerConfig::num_threads,
+                       "Inference threads for the embedding model")
+        .def_readwrite("min_segment_ms", &OnlineDiarizerConfig::min_segment_ms,
+                       "Utterances shorter than this are not embedded (speaker -1)")
+        .def_property(
+            "similarity_threshold",
+            [](const OnlineDiarizerConfig& c) { return c.clustering.similarity_threshold; },
+            [](OnlineDiarizerConfig& c, float v) { c.clustering.similarity_threshold = v; },
+            "Cosine similarity needed to join an existing speaker")
+        .def_property(
+            "max_speakers", [](const OnlineDiarizerConfig& c) { return c.clustering.max_speakers; },
+            [](OnlineDiarizerConfig& c, int v) { c.clustering.max_speakers = v; },
+            "Speakers tracked; past this each utterance joins the nearest one");
+
+    // OnlineDiarizer
+    py::class_<OnlineDiarizer>(m, "OnlineDiarizer")
+        .def(py::init<const OnlineDiarizerConfig&>(), py::arg("config") = OnlineDiarizerConfig(),
+             "Construct an OnlineDiarizer with the given configuration")
+        .def("init", &OnlineDiarizer::Init, py::call_guard<py::gil_scoped_release>(),
+             "Load the embedding model; returns True on success")
+        .def("is_initialized", &OnlineDiarizer::IsInitialized,
+             "Return True once init() has completed successfully")
+        .def(
+            "assign_speaker",
+            [](OnlineDiarizer& self, const py::object& audio_array, int sample_rate) {
+                PcmBuffer pcm = RequestPcm(audio_array);
+
+                py::gil_scoped_release release;
+                if (pcm.type == PcmType::Float32) {
+                    return self.AssignSpeaker(pcm.float_data(), pcm.count, sample_rate);
+                }
+                const std::vector<float> samples = ToFloatSamples(pcm);
+                return self.AssignSpeaker(samples.data(), samples.size(), sample_rate);
+            },
+            py::arg("audio_array"), py::arg("sample_rate") = 16000,
+            "Embed one utterance (1-D mono float32 in [-1, 1], or int16) and return its speaker "
+            "index (-1 = unknown)")
+        .def("get_num_speakers", &OnlineDiarizer::GetNumSpeakers,
+             "Number of speakers seen so far")
+        .def("reset", &OnlineDiarizer::Reset, "Forget every speaker")
+        .def("get_last_error", &OnlineDiarizer::GetLastError,
+             "Return the last error message (empty string if no error)");
 #endif  // ENABLE_DIARIZATION
 
     // ========== VAD Segmenter ==========
@@ -507,6 +1159,8 @@ PYBIND11_MODULE(_ffvoice, m) {
                        "Enable adaptive threshold adjustment")
         .def_readwrite("adaptive_factor", &VADSegmenter::Config::adaptive_factor,
                        "Adaptation speed (0.0-1.0)")
+        .def_readwrite("pre_roll_samples", &VADSegmenter::Config::pre_roll_samples,
+                       "Audio before speech start prepended to each segment (0 = off)")
         .def_static("from_preset", &VADSegmenter::Config::FromPreset, py::arg("sensitivity"),
                     "Create config from sensitivity preset");
 
@@ -590,6 +1244,49 @@ PYBIND11_MODULE(_ffvoice, m) {
             },
             "Get VAD statistics: (avg_vad_prob, speech_ratio)");
 
+    // ========== Audio Readers ==========
+
+    // MediaFileReader
+    py::class_<MediaFileReader>(m, "MediaFileReader")
+        .def(py::init<>(), "Create a streaming FFmpeg decoder (any format -> mono float)")
+        .def("open", &MediaFileReader::Open, py::arg("filename"),
+             py::arg("target_sample_rate") = 16000, "Open a media file; returns True on success")
+        .def(
+            "next_chunk",
+            [](MediaFileReader& self, size_t max_samples) -> py::object {
+                std::vector<float> chunk;
+                if (!self.NextChunk(chunk, max_samples)) {
+                    return py::none();
+                }
+                return py::array_t<float>(static_cast<py::ssize_t>(chunk.size()), chunk.data());
+            },
+            py::arg("max_samples") = 16000 * 30,
+            "Next decoded chunk as a float32 array, or None at the end of the file")
+        .def(
+            "read_all",
+            [](MediaFileReader& self) {
+                std::vector<float> pcm;
+                bool success = false;
+                {
+                    py::gil_scoped_release release;
+                    success = self.ReadAll(pcm);
+                }
+                if (!success) {
+                    throw std::runtime_error("Decoding failed: " + self.GetLastError());
+                }
+                return py::array_t<float>(static_cast<py::ssize_t>(pcm.size()), pcm.data());
+            },
+            "Decode the whole file into a float32 array")
+        .def("rewind", &MediaFileReader::Rewind, "Restart next_chunk() from the beginning")
+        .def("close", &MediaFileReader::Close, "Close the file")
+        .def("is_open", &MediaFileReader::IsOpen, "Check if a file is open")
+        .def("get_sample_rate", &MediaFileReader::GetSampleRate, "Sample rate of the file")
+        .def("get_channels", &MediaFileReader::GetChannels, "Channel count of the file")
+        .def("get_duration_seconds", &MediaFileReader::GetDurationSeconds,
+             "Duration reported by the container (0 if unknown)")
+        .def("get_codec_name", &MediaFileReader::GetCodecName, "Decoder in use")
+        .def("get_last_error", &MediaFileReader::GetLastError, "Get last error message");
+
     // ========== Audio Writers ==========
 
     // WAVWriter
@@ -624,9 +1321,21 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def("get_total_samples", &WavWriter::GetTotalSamples, "Get total samples written")
         .def("close", &WavWriter::Close, "Close the WAV file");
 
+    // FlacWriter::Config
+    py::class_<FlacWriter::Config>(m, "FLACWriterConfig")
+        .def(py::init<>())
+        .def_readwrite("num_threads", &FlacWriter::Config::num_threads,
+                       "Encoder threads (0 = one per hardware thread, needs libFLAC 1.5)")
+        .def_readwrite("total_frames_estimate", &FlacWriter::Config::total_frames_estimate,
+                       "Expected length in frames (0 = unknown)")
+        .def_readwrite("seek_point_seconds", &FlacWriter::Config::seek_point_seconds,
+                       "Seek point spacing when the length is known (0 = none)");
+
     // FLACWriter
     py::class_<FlacWriter>(m, "FLACWriter")
         .def(py::init<>(), "Create FLAC file writer")
+        .def(py::init<const FlacWriter::Config&>(), py::arg("config"),
+             "Create FLAC file writer with encoder configuration")
         .def("open", &FlacWriter::Open, py::arg("filename"), py::arg("sample_rate"),
              py::arg("channels"), py::arg("bits_per_sample") = 16, py::arg("compression_level") = 5,
              "Open FLAC file for writing")
@@ -659,6 +1368,59 @@ PYBIND11_MODULE(_ffvoice, m) {
              "Get compression ratio (original_size / compressed_size)")
         .def("close", &FlacWriter::Close, "Close the FLAC file");
 
+    // OpusWriter::Config
+    py::class_<OpusWriter::Config>(m, "OpusWriterConfig")
+        .def(py::init<>())
+        .def_readwrite("bitrate", &OpusWriter::Config::bitrate, "Target bits per second")
+        .def_readwrite("frame_ms", &OpusWriter::Config::frame_ms,
+                       "Encoder frame: 10, 20, 40 or 60 ms")
+        .def_readwrite("voice", &OpusWriter::Config::voice, "Tune for speech rather than music")
+        .def_readwrite("container", &OpusWriter::Config::container,
+                       "FFmpeg muxer name ('ogg', 'webm'); empty = by file extension")
+        .def_property(
+            "on_packet", [](const OpusWriter::Config&) { return py::none(); },
+            [](OpusWriter::Config& self, py::object callback) {
+                if (callback.is_none()) {
+                    self.on_packet = nullptr;
+                    return;
+                }
+                // Packets are produced inside write_samples()/close(), with the GIL held
+                py::function fn = callback;
+                self.on_packet = [fn](const uint8_t* data, size_t size, int64_t pts) {
+                    fn(py::bytes(reinterpret_cast<const char*>(data), size), pts);
+                };
+            },
+            "Callable(packet: bytes, pts: int) for every encoded packet");
+
+    // OpusWriter
+    py::class_<OpusWriter>(m, "OpusWriter")
+        .def(py::init<>(), "Create Opus writer")
+        .def(py::init<const OpusWriter::Config&>(), py::arg("config"),
+             "Create Opus writer with encoder configuration")
+        .def("open", &OpusWriter::Open, py::arg("filename"), py::arg("sample_rate"),
+             py::arg("channels"), "Open Opus output (empty filename = packets to on_packet only)")
+        .def(
+            "write_samples_array",
+            [](OpusWriter& self, py::array_t<int16_t> audio_array) {
+                py::buffer_info buf = audio_array.request();
+                if (buf.ndim != 1) {
+                    throw std::runtime_error("Audio array must be 1-dimensional (got " +
+                                             std::to_string(buf.ndim) + " dimensions)");
+                }
+                return self.WriteSamples(static_cast<const int16_t*>(buf.ptr),
+                                         static_cast<size_t>(buf.shape[0]));
+            },
+            py::arg("audio_array"), "Encode PCM samples from NumPy array (int16, 1D)")
+        .def("is_open", &OpusWriter::IsOpen, "Check if the encoder is open")
+        .def("has_error", &OpusWriter::HasError, "Check whether an encoder error occurred")
+        .def("get_total_samples", &OpusWriter::GetTotalSamples, "Get total samples written")
+        .def("get_encoded_bytes", &OpusWriter::GetEncodedBytes, "Get encoded payload bytes")
+        .def("get_compression_ratio", &OpusWriter::GetCompressionRatio,
+             "Get compression ratio (PCM size / encoded size)")
+        .def_static("is_supported_sample_rate", &OpusWriter::IsSupportedSampleRate,
+                    py::arg("sample_rate"), "Whether Opus encodes this rate directly")
+        .def("close", &OpusWriter::Close, "Flush the encoder and finish the file");
+
     // ========== Audio Mixer ==========
 
     // AudioMixer
@@ -688,34 +1450,16 @@ PYBIND11_MODULE(_ffvoice, m) {
         .def("set_master_gain", &AudioMixer::SetMasterGain, py::arg("gain"),
              "Set the master gain applied to the mix (clamped to [0, 8])")
         .def("get_master_gain", &AudioMixer::GetMasterGain, "Get the master gain")
+        .def("set_num_threads", &AudioMixer::SetNumThreads, py::arg("num_threads"),
+             "Set the threads that share each mix_block call (1 = serial)")
+        .def("get_num_threads", &AudioMixer::GetNumThreads, "Get the mixing thread count")
         .def("reset", &AudioMixer::Reset, "Remove all tracks and reset the master gain")
         .def(
             "mix_block",
             [](AudioMixer& self, const py::dict& tracks) {
-                // tracks: { track_id (int) : 1-D int16 NumPy array }.
-                // Every array must have the same length.
                 std::vector<py::array_t<int16_t>> arrays;  // keep buffers alive
                 std::vector<MixerInput> inputs;
-                size_t num_samples = 0;
-                bool first = true;
-
-                for (auto item : tracks) {
-                    int track_id = item.first.cast<int>();
-                    auto arr = item.second.cast<py::array_t<int16_t>>();
-                    py::buffer_info buf = arr.request();
-                    if (buf.ndim != 1) {
-                        throw std::runtime_error("Each track array must be 1-dimensional");
-                    }
-                    size_t n = static_cast<size_t>(buf.shape[0]);
-                    if (first) {
-                        num_samples = n;
-                        first = false;
-                    } else if (n != num_samples) {
-                        throw std::runtime_error("All track arrays must have the same length");
-                    }
-                    arrays.push_back(arr);
-                    inputs.push_back(MixerInput{track_id, static_cast<const int16_t*>(buf.ptr)});
-                }
+                const size_t num_samples = CollectMixerInputs(tracks, arrays, inputs);
 
                 py::array_t<int16_t> output(static_cast<py::ssize_t>(num_samples));
                 py::buffer_info out_buf = output.request();
@@ -725,7 +1469,31 @@ PYBIND11_MODULE(_ffvoice, m) {
                 }
                 return output;
             },
-            py::arg("tracks"), "Mix {track_id: int16 ndarray} into a single mixed int16 ndarray");
+            py::arg("tracks"), "Mix {track_id: int16 ndarray} into a single mixed int16 ndarray")
+        .def(
+            "mix_minus_block",
+            [](AudioMixer& self, const py::dict& tracks) {
+                std::vector<py::array_t<int16_t>> arrays;  // keep buffers alive
+                std::vector<MixerInput> inputs;
+                const size_t num_samples = CollectMixerInputs(tracks, arrays, inputs);
+
+                py::dict result;
+                std::vector<py::array_t<int16_t>> mixes;
+                std::vector<MixMinusOutput> outputs;
+                for (const MixerInput& input : inputs) {
+                    mixes.emplace_back(static_cast<py::ssize_t>(num_samples));
+                    outputs.push_back(
+                        MixMinusOutput{input.track_id, mixes.back().mutable_data()});
+                    result[py::int_(input.track_id)] = mixes.back();
+                }
+                if (!self.MixMinusBlock(inputs, outputs, num_samples)) {
+                    throw std::runtime_error(
+                        "mix_minus_block failed (mixer not initialized or invalid arguments)");
+                }
+                return result;
+            },
+            py::arg("tracks"),
+            "Mix {track_id: int16 ndarray} into {track_id: mix of every other track}");
 
     // ========== Ring Buffer ==========
 
@@ -775,6 +1543,58 @@ PYBIND11_MODULE(_ffvoice, m) {
             py::arg("count"), "Pop up to `count` values; returns them as a 1-D int16 ndarray")
         .def("clear", &RingBuffer<int16_t>::clear, "Reset the buffer to empty");
 
+    // ========== Metrics ==========
+
+    m.def(
+        "enable_metrics", [](bool enabled) { MetricsRegistry::SetEnabled(enabled); },
+        py::arg("enabled") = true,
+        "Turn per-stage latency/throughput recording on or off (off by default)");
+    m.def("metrics_enabled", &MetricsRegistry::IsEnabled, "Whether metrics are being recorded");
+    m.def(
+        "get_metrics",
+        []() {
+            MetricsRegistry& registry = MetricsRegistry::Instance();
+            py::dict counters;
+            for (const auto& [name, value] : registry.GetCounters()) {
+                counters[py::str(name)] = value;
+            }
+            py::dict histograms;
+            for (const auto& [name, h] : registry.GetHistograms()) {
+                py::dict entry;
+                entry["count"] = h.count;
+                entry["sum"] = h.sum;
+                entry["min"] = h.min;
+                entry["max"] = h.max;
+                entry["mean"] = h.mean;
+                entry["p50"] = h.p50;
+                entry["p90"] = h.p90;
+                entry["p99"] = h.p99;
+                entry["p999"] = h.p999;
+                histograms[py::str(name)] = entry;
+            }
+            py::dict metrics;
+            metrics["counters"] = counters;
+            metrics["histograms"] = histograms;
+            return metrics;
+        },
+        "Snapshot of all metrics: {'counters': {name: n}, 'histograms': {name: {count, sum, "
+        "min, max, mean, p50, p90, p99, p999}}}; histogram values are in microseconds unless "
+        "the name ends in _pct");
+    m.def(
+        "get_metrics_json", []() { return MetricsRegistry::Instance().ToJson(); },
+        "All metrics as a JSON string (same format as the CLI's --metrics-json)");
+    m.def(
+        "reset_metrics", []() { MetricsRegistry::Instance().Reset(); }, "Zero every metric");
+
+    // ========== Logging ==========
+
+    m.def("set_async_logging", &set_async_logging, py::arg("enabled") = true,
+          py::call_guard<py::gil_scoped_release>(),
+          "Write log messages from a background thread so the capture callback never blocks "
+          "on stderr; turning it off writes out everything still queued");
+    m.def("flush_log", &flush_log, py::call_guard<py::gil_scoped_release>(),
+          "Wait until every queued log message has been written");
+
     // ========== Build-feature flags ==========
 
 #ifdef ENABLE_DIARIZATION
@@ -5,12 +5,16 @@
 
 #include "utils/audio_converter.h"
 
+#include "media/mapped_wav_reader.h"
+#include "media/media_file_reader.h"
+#include "utils/audio_kernels.h"
 #include "utils/logger.h"
+#include "utils/polyphase_resampler.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstring>
-#include <fstream>
+#include <memory>
 
 // FLAC decoder
 #include <FLAC/stream_decoder.h>
@@ -32,70 +36,52 @@ bool AudioConverter::LoadAndConvert(const std::string& filename, std::vector<flo
         std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
     }
 
-    // Load audio file
-    std::vector<float> raw_pcm;
-    int sample_rate = 0;
-    int channels = 0;
-
-    bool success = false;
+    // WAV: convert straight from the mapped file into pcm_data, with no
+    // full-length intermediate copies
     if (ext == ".wav") {
-        success = LoadWAV(filename, raw_pcm, sample_rate, channels);
-    } else if (ext == ".flac") {
-        success = LoadFLAC(filename, raw_pcm, sample_rate, channels);
-    } else {
-        LOG_ERROR("Unsupported audio file format: %s", ext.c_str());
-        return false;
+        MappedWavReader reader;
+        if (!reader.Open(filename, target_sample_rate) || !reader.ReadAll(pcm_data)) {
+            LOG_ERROR("Failed to load audio file: %s", filename.c_str());
+            return false;
+        }
+        LOG_INFO("Loaded audio: %d Hz, %d channels, %zu frames -> %zu samples",
+                 reader.GetSampleRate(), reader.GetChannels(), reader.GetNumFrames(),
+                 pcm_data.size());
+        return true;
     }
 
-    if (!success) {
-        LOG_ERROR("Failed to load audio file: %s", filename.c_str());
-        return false;
+    if (ext == ".flac") {
+        int sample_rate = 0;
+        int channels = 0;
+        if (!LoadFLAC(filename, pcm_data, target_sample_rate, sample_rate, channels)) {
+            LOG_ERROR("Failed to load audio file: %s", filename.c_str());
+            return false;
+        }
+        LOG_INFO("Loaded audio: %d Hz, %d channels -> %zu samples", sample_rate, channels,
+                 pcm_data.size());
+        return true;
     }
 
-    LOG_INFO("Loaded audio: %d Hz, %d channels, %zu samples", sample_rate, channels,
-             raw_pcm.size());
-
-    // Convert stereo to mono if needed
-    std::vector<float> mono_pcm;
-    if (channels == 2) {
-        size_t num_frames = raw_pcm.size() / 2;
-        mono_pcm.resize(num_frames);
-        StereoToMono(raw_pcm.data(), num_frames, mono_pcm.data());
-        LOG_INFO("Converted stereo to mono: %zu frames", num_frames);
-    } else if (channels == 1) {
-        mono_pcm = std::move(raw_pcm);
-    } else {
-        LOG_ERROR("Unsupported channel count: %d", channels);
+    // Anything else (MP3, M4A, Opus, ...) is decoded by FFmpeg, which
+    // downmixes and resamples on the way
+    MediaFileReader reader;
+    if (!reader.Open(filename, target_sample_rate) || !reader.ReadAll(pcm_data)) {
+        LOG_ERROR("Failed to load audio file: %s", filename.c_str());
         return false;
     }
-
-    // Resample if needed
-    if (sample_rate != target_sample_rate) {
-        size_t output_size = static_cast<size_t>(
-            mono_pcm.size() * static_cast<double>(target_sample_rate) / sample_rate);
-        pcm_data.resize(output_size);
-        Resample(mono_pcm.data(), mono_pcm.size(), sample_rate, pcm_data.data(), pcm_data.size(),
-                 target_sample_rate);
-        LOG_INFO("Resampled: %d Hz → %d Hz (%zu samples)", sample_rate, target_sample_rate,
-                 pcm_data.size());
-    } else {
-        pcm_data = std::move(mono_pcm);
-    }
-
+    LOG_INFO("Loaded audio: %s, %d Hz, %d channels -> %zu samples", reader.GetCodecName().c_str(),
+             reader.GetSampleRate(), reader.GetChannels(), pcm_data.size());
     return true;
 }
 
+// The conversion kernels are SIMD-dispatched at runtime (see audio_kernels.h)
+
 void AudioConverter::Int16ToFloat(const int16_t* input, size_t num_samples, float* output) {
-    for (size_t i = 0; i < num_samples; ++i) {
-        output[i] = input[i] / 32768.0f;
-    }
+    GetAudioKernels().int16_to_float(input, num_samples, output);
 }
 
 void AudioConverter::FloatToInt16(const float* input, size_t num_samples, int16_t* output) {
-    for (size_t i = 0; i < num_samples; ++i) {
-        float clamped = std::clamp(input[i], -1.0f, 1.0f);
-        output[i] = static_cast<int16_t>(clamped * 32767.0f);
-    }
+    GetAudioKernels().float_to_int16(input, num_samples, output);
 }
 
 void AudioConverter::Resample(const float* input, size_t input_size, int input_rate, float* output,
@@ -129,108 +115,11 @@ void AudioConverter::Resample(const float* input, size_t input_size, int input_r
 }
 
 void AudioConverter::StereoToMono(const float* stereo, size_t num_frames, float* mono) {
-    for (size_t i = 0; i < num_frames; ++i) {
-        // Average left and right channels
-        mono[i] = (stereo[i * 2] + stereo[i * 2 + 1]) * 0.5f;
-    }
+    GetAudioKernels().stereo_to_mono(stereo, num_frames, mono);
 }
 
-// ============================================================================
-// Private Methods - WAV Loading
-// ============================================================================
-
-// WAV file format structures
-#pragma pack(push, 1)
-struct WavHeader {
-    char riff[4];        // "RIFF"
-    uint32_t file_size;  // File size - 8
-    char wave[4];        // "WAVE"
-};
-
-struct WavChunkHeader {
-    char id[4];     // Chunk ID
-    uint32_t size;  // Chunk size
-};
-
-struct WavFormatChunk {
-    uint16_t format;           // Audio format (1 = PCM)
-    uint16_t channels;         // Number of channels
-    uint32_t sample_rate;      // Sample rate
-    uint32_t byte_rate;        // Byte rate
-    uint16_t block_align;      // Block align
-    uint16_t bits_per_sample;  // Bits per sample
-};
-#pragma pack(pop)
-
-bool AudioConverter::LoadWAV(const std::string& filename, std::vector<float>& pcm_data,
-                             int& sample_rate, int& channels) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        LOG_ERROR("Failed to open WAV file: %s", filename.c_str());
-        return false;
-    }
-
-    // Read RIFF header
-    WavHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-
-    if (std::memcmp(header.riff, "RIFF", 4) != 0 || std::memcmp(header.wave, "WAVE", 4) != 0) {
-        LOG_ERROR("Invalid WAV file format");
-        return false;
-    }
-
-    // Find format chunk
-    WavFormatChunk fmt;
-    bool found_fmt = false;
-
-    while (file.good()) {
-        WavChunkHeader chunk;
-        file.read(reinterpret_cast<char*>(&chunk), sizeof(chunk));
-
-        if (!file.good())
-            break;
-
-        if (std::memcmp(chunk.id, "fmt ", 4) == 0) {
-            file.read(reinterpret_cast<char*>(&fmt), sizeof(fmt));
-            found_fmt = true;
-
-            // Skip any extra format bytes
-            if (chunk.size > sizeof(fmt)) {
-                file.seekg(chunk.size - sizeof(fmt), std::ios::cur);
-            }
-        } else if (std::memcmp(chunk.id, "data", 4) == 0 && found_fmt) {
-            // Found data chunk - read audio data
-            sample_rate = fmt.sample_rate;
-            channels = fmt.channels;
-
-            if (fmt.format != 1) {  // Only support PCM
-                LOG_ERROR("Unsupported WAV format: %d (only PCM supported)", fmt.format);
-                return false;
-            }
-
-            if (fmt.bits_per_sample != 16) {
-                LOG_ERROR("Unsupported bit depth: %d (only 16-bit supported)", fmt.bits_per_sample);
-                return false;
-            }
-
-            // Read int16 samples
-            size_t num_samples = chunk.size / sizeof(int16_t);
-            std::vector<int16_t> int16_data(num_samples);
-            file.read(reinterpret_cast<char*>(int16_data.data()), chunk.size);
-
-            // Convert to float
-            pcm_data.resize(num_samples);
-            Int16ToFloat(int16_data.data(), num_samples, pcm_data.data());
-
-            return true;
-        } else {
-            // Skip unknown chunk
-            file.seekg(chunk.size, std::ios::cur);
-        }
-    }
-
-    LOG_ERROR("No data chunk found in WAV file");
-    return false;
+void AudioConverter::Int16StereoToMono(const int16_t* stereo, size_t num_frames, float* mono) {
+    GetAudioKernels().int16_stereo_to_mono(stereo, num_frames, mono);
 }
 
 // ============================================================================
@@ -239,12 +128,42 @@ bool AudioConverter::LoadWAV(const std::string& filename, std::vector<float>& pc
 
 // FLAC decoder callback data
 struct FLACDecoderData {
-    std::vector<float>* pcm_data;
-    int sample_rate;
-    int channels;
-    int bits_per_sample;
+    std::vector<float>* pcm_data = nullptr;
+    int target_sample_rate = 0;
+    int sample_rate = 0;
+    int channels = 0;
+    int bits_per_sample = 0;
+    uint64_t total_samples = 0;  ///< From STREAMINFO; 0 if unknown
+    uint64_t decoded_frames = 0;
+    bool ready = false;
+
+    std::unique_ptr<PolyphaseResampler> resampler;
+    std::vector<float> mono;       ///< One decoded frame, downmixed
+    std::vector<float> resampled;  ///< That frame at the target rate
+    std::vector<float> native;     ///< Whole mono input, only for the linear fallback
 };
 
+// Set up the conversion once the stream format is known (normally from STREAMINFO)
+static void flac_prepare(FLACDecoderData* data) {
+    data->ready = true;
+    const size_t expected = static_cast<size_t>(data->total_samples);
+    if (data->sample_rate == data->target_sample_rate) {
+        data->pcm_data->reserve(expected);
+        return;
+    }
+
+    data->resampler =
+        std::make_unique<PolyphaseResampler>(data->sample_rate, data->target_sample_rate);
+    if (data->resampler->IsValid()) {
+        data->pcm_data->reserve(
+            data->resampler->GetMaxOutputSize(expected + data->resampler->GetLatency()));
+    } else {
+        // Rate pair beyond the polyphase filter bank: linear interpolation at
+        // the end needs the whole mono input
+        data->native.reserve(expected);
+    }
+}
+
 // FLAC write callback
 static FLAC__StreamDecoderWriteStatus flac_write_callback(const FLAC__StreamDecoder* /*decoder*/,
                                                           const FLAC__Frame* frame,
@@ -252,21 +171,47 @@ static FLAC__StreamDecoderWriteStatus flac_write_callback(const FLAC__StreamDeco
                                                           void* client_data) {
     FLACDecoderData* data = static_cast<FLACDecoderData*>(client_data);
 
-    // Get number of samples in this frame
-    unsigned block_size = frame->header.blocksize;
-    unsigned channels = frame->header.channels;
-
-    // Calculate conversion factor based on bit depth
-    float scale = 1.0f / (1 << (data->bits_per_sample - 1));
-
-    // Append samples to output (interleaved)
-    size_t old_size = data->pcm_data->size();
-    data->pcm_data->resize(old_size + block_size * channels);
+    if (!data->ready) {
+        // No STREAMINFO seen: take the format from the first frame header
+        data->sample_rate = static_cast<int>(frame->header.sample_rate);
+        data->channels = static_cast<int>(frame->header.channels);
+        data->bits_per_sample = static_cast<int>(frame->header.bits_per_sample);
+        if (data->sample_rate <= 0 || data->bits_per_sample <= 0) {
+            LOG_ERROR("FLAC stream has no sample rate or bit depth");
+            return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+        }
+        flac_prepare(data);
+    }
 
+    const unsigned block_size = frame->header.blocksize;
+    const unsigned channels = frame->header.channels;
+
+    // Downmix while converting: full scale at the stream's bit depth, averaged over channels
+    const float scale = std::ldexp(1.0f, 1 - data->bits_per_sample) / static_cast<float>(channels);
+    const bool streaming = data->resampler && data->resampler->IsValid();
+    std::vector<float>& out =
+        streaming ? data->mono : (data->resampler ? data->native : *data->pcm_data);
+    const size_t base = streaming ? 0 : out.size();
+    out.resize(base + block_size);
+    float* mono = out.data() + base;
     for (unsigned i = 0; i < block_size; ++i) {
+        int64_t sum = 0;
         for (unsigned ch = 0; ch < channels; ++ch) {
-            (*data->pcm_data)[old_size + i * channels + ch] = buffer[ch][i] * scale;
+            sum += buffer[ch][i];
         }
+        mono[i] = static_cast<float>(sum) * scale;
+    }
+    data->decoded_frames += block_size;
+
+    if (streaming) {
+        // Resample this frame onto the end of the output. Going through the
+        // scratch keeps pcm_data within its reservation.
+        std::vector<float>& resampled = data->resampled;
+        resampled.resize(data->resampler->GetMaxOutputSize(block_size));
+        const size_t n =
+            data->resampler->Process(mono, block_size, resampled.data(), resampled.size());
+        data->pcm_data->insert(data->pcm_data->end(), resampled.begin(),
+                               resampled.begin() + static_cast<std::ptrdiff_t>(n));
     }
 
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
@@ -277,13 +222,15 @@ static void flac_metadata_callback(const FLAC__StreamDecoder* /*decoder*/,
                                    const FLAC__StreamMetadata* metadata, void* client_data) {
     FLACDecoderData* data = static_cast<FLACDecoderData*>(client_data);
 
-    if (metadata->type == FLAC__METADATA_TYPE_STREAMINFO) {
+    if (metadata->type == FLAC__METADATA_TYPE_STREAMINFO && !data->ready) {
         data->sample_rate = metadata->data.stream_info.sample_rate;
         data->channels = metadata->data.stream_info.channels;
         data->bits_per_sample = metadata->data.stream_info.bits_per_sample;
+        data->total_samples = metadata->data.stream_info.total_samples;
 
         LOG_INFO("FLAC metadata: %d Hz, %d channels, %d bits", data->sample_rate, data->channels,
                  data->bits_per_sample);
+        flac_prepare(data);
     }
 }
 
@@ -294,7 +241,7 @@ static void flac_error_callback(const FLAC__StreamDecoder* /*decoder*/,
 }
 
 bool AudioConverter::LoadFLAC(const std::string& filename, std::vector<float>& pcm_data,
-                              int& sample_rate, int& channels) {
+                              int target_sample_rate, int& sample_rate, int& channels) {
     // Create FLAC decoder
     FLAC__StreamDecoder* decoder = FLAC__stream_decoder_new();
     if (!decoder) {
@@ -303,11 +250,10 @@ bool AudioConverter::LoadFLAC(const std::string& filename, std::vector<float>& p
     }
 
     // Setup decoder data
+    pcm_data.clear();
     FLACDecoderData data;
     data.pcm_data = &pcm_data;
-    data.sample_rate = 0;
-    data.channels = 0;
-    data.bits_per_sample = 0;
+    data.target_sample_rate = target_sample_rate;
 
     // Initialize decoder
     FLAC__StreamDecoderInitStatus init_status =
@@ -336,7 +282,27 @@ bool AudioConverter::LoadFLAC(const std::string& filename, std::vector<float>& p
         LOG_ERROR("FLAC decoding failed");
         return false;
     }
+    if (!data.resampler) {
+        return true;  // Already at the target rate
+    }
 
+    // Like PolyphaseResampler::ResampleBuffer: trim the filter tail or
+    // zero-fill to the length the input implies
+    const size_t output_size = static_cast<size_t>(static_cast<double>(data.decoded_frames) *
+                                                   target_sample_rate / data.sample_rate);
+    if (data.resampler->IsValid()) {
+        std::vector<float>& tail = data.resampled;
+        tail.resize(data.resampler->GetMaxOutputSize(data.resampler->GetLatency()));
+        tail.resize(data.resampler->Flush(tail.data(), tail.size()));
+        pcm_data.insert(pcm_data.end(), tail.begin(), tail.end());
+        pcm_data.resize(output_size, 0.0f);
+    } else {
+        pcm_data.resize(output_size);
+        Resample(data.native.data(), data.native.size(), data.sample_rate, pcm_data.data(),
+                 pcm_data.size(), target_sample_rate);
+    }
+    LOG_INFO("Resampled: %d Hz → %d Hz (%zu samples)", data.sample_rate, target_sample_rate,
+             pcm_data.size());
     return true;
 }
 
@@ -25,7 +25,7 @@ namespace ffvoice {
  *
  * Conversion pipeline:
  * @code
- * WAV/FLAC file (48kHz, int16, stereo)
+ * WAV/FLAC/MP3/... file (48kHz, int16, stereo)
  *   → Read file
  *   → Convert to float (48kHz, float, stereo)
  *   → Stereo to mono (48kHz, float, mono)
@@ -37,12 +37,18 @@ public:
     /**
      * @brief Load and convert audio file to Whisper format
      *
-     * Loads a WAV or FLAC file and converts it to the format required by Whisper:
+     * Loads an audio file and converts it to the format required by Whisper:
      * - 16kHz sample rate
      * - float32 format
      * - mono channel
      *
-     * @param filename Path to audio file (.wav or .flac)
+     * WAV files are read through MappedWavReader, which converts straight from
+     * the mapped file into @p pcm_data. FLAC is decoded with libFLAC, each
+     * frame downmixed and resampled as it is decoded; every other extension
+     * goes to MediaFileReader (FFmpeg). Either way @p pcm_data is the only
+     * full-length buffer.
+     *
+     * @param filename Path to audio file (.wav, .flac, or anything FFmpeg can decode)
      * @param pcm_data Output PCM data in Whisper format
      * @param target_sample_rate Target sample rate (default: 16000 Hz)
      * @return true if successful, false otherwise
@@ -76,8 +82,8 @@ public:
     /**
      * @brief Resample audio using linear interpolation
      *
-     * Simple linear interpolation resampler. For better quality, consider using
-     * a more sophisticated resampler (e.g., libsamplerate).
+     * Simple linear interpolation resampler with no anti-aliasing filter. Use
+     * PolyphaseResampler where quality matters (e.g. audio going to Whisper).
      *
      * @param input Input samples
      * @param input_size Number of input samples
@@ -100,28 +106,35 @@ public:
      */
     static void StereoToMono(const float* stereo, size_t num_frames, float* mono);
 
-private:
     /**
-     * @brief Load WAV file
-     * @param filename Path to WAV file
-     * @param pcm_data Output PCM data (float format)
-     * @param sample_rate Output sample rate
-     * @param channels Output number of channels
-     * @return true if successful, false otherwise
+     * @brief Convert interleaved int16 stereo straight to normalized float mono
+     *
+     * Same result as Int16ToFloat() followed by StereoToMono(), in one pass
+     * and without the intermediate stereo float buffer.
+     *
+     * @param stereo Input stereo samples (interleaved: L R L R ...)
+     * @param num_frames Number of frames (= num_samples / 2)
+     * @param mono Output mono samples (must be pre-allocated, size = num_frames)
      */
-    static bool LoadWAV(const std::string& filename, std::vector<float>& pcm_data, int& sample_rate,
-                        int& channels);
+    static void Int16StereoToMono(const int16_t* stereo, size_t num_frames, float* mono);
 
+private:
     /**
-     * @brief Load FLAC file
+     * @brief Decode a FLAC file straight into Whisper format
+     *
+     * The write callback downmixes each decoded frame and streams it through a
+     * PolyphaseResampler into @p pcm_data, which is reserved up front from the
+     * STREAMINFO sample count.
+     *
      * @param filename Path to FLAC file
-     * @param pcm_data Output PCM data (float format)
-     * @param sample_rate Output sample rate
-     * @param channels Output number of channels
+     * @param pcm_data Output PCM data (mono float at @p target_sample_rate)
+     * @param target_sample_rate Output sample rate
+     * @param sample_rate Sample rate of the file
+     * @param channels Number of channels in the file
      * @return true if successful, false otherwise
      */
     static bool LoadFLAC(const std::string& filename, std::vector<float>& pcm_data,
-                         int& sample_rate, int& channels);
+                         int target_sample_rate, int& sample_rate, int& channels);
 };
 
 }  // namespace ffvoice
@@ -0,0 +1,433 @@
+/**
+ * @file audio_kernels.cpp
+ * @brief SSE2 / AVX2 / NEON conversion and mixing kernels and the runtime dispatcher
+ */
+
+#include "utils/audio_kernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define FFVOICE_KERNELS_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        // MSVC accepts AVX2 intrinsics in any function
+        #define FFVOICE_TARGET_AVX2
+    #else
+        // Compiled for AVX2 regardless of -march; only called after CPU detection
+        #define FFVOICE_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define FFVOICE_KERNELS_NEON
+#endif
+
+namespace ffvoice {
+
+namespace {
+
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+constexpr float kStereoInt16Scale = 1.0f / 65536.0f;  // Average of two channels, then scale
+constexpr float kInt16Min = -32768.0f;
+constexpr float kInt16Max = 32767.0f;
+
+// =============================================================================
+// Scalar kernels (also used for the tails of the SIMD ones)
+// =============================================================================
+
+void Int16ToFloatScalar(const int16_t* input, size_t num_samples, float* output) {
+    for (size_t i = 0; i < num_samples; ++i) {
+        output[i] = static_cast<float>(input[i]) * kInt16Scale;
+    }
+}
+
+void FloatToInt16Scalar(const float* input, size_t num_samples, int16_t* output) {
+    for (size_t i = 0; i < num_samples; ++i) {
+        float clamped = std::clamp(input[i], -1.0f, 1.0f);
+        output[i] = static_cast<int16_t>(clamped * 32767.0f);
+    }
+}
+
+void StereoToMonoScalar(const float* stereo, size_t num_frames, float* mono) {
+    for (size_t i = 0; i < num_frames; ++i) {
+        mono[i] = (stereo[i * 2] + stereo[i * 2 + 1]) * 0.5f;
+    }
+}
+
+void Int16StereoToMonoScalar(const int16_t* stereo, size_t num_frames, float* mono) {
+    for (size_t i = 0; i < num_frames; ++i) {
+        const int sum = static_cast<int>(stereo[i * 2]) + static_cast<int>(stereo[i * 2 + 1]);
+        mono[i] = static_cast<float>(sum) * kStereoInt16Scale;
+    }
+}
+
+void MixInt16Scalar(const int16_t* input, size_t num_samples, const float gains[2],
+                    float* accumulator) {
+    for (size_t i = 0; i < num_samples; ++i) {
+        // Separate statements so the compiler cannot contract them into an FMA,
+        // which the SIMD versions do not use
+        const float scaled = static_cast<float>(input[i]) * gains[i % 2];
+        accumulator[i] += scaled;
+    }
+}
+
+void ScaledFloatToInt16Scalar(const float* input, size_t num_samples, float gain,
+                              int16_t* output) {
+    for (size_t i = 0; i < num_samples; ++i) {
+        const float scaled = input[i] * gain;
+        output[i] = static_cast<int16_t>(std::clamp(scaled, kInt16Min, kInt16Max));
+    }
+}
+
+constexpr AudioKernels kScalarKernels = {SimdLevel::Scalar, "scalar", Int16ToFloatScalar,
+                                         FloatToInt16Scalar, StereoToMonoScalar,
+                                         Int16StereoToMonoScalar, MixInt16Scalar,
+                                         ScaledFloatToInt16Scalar};
+
+#if defined(FFVOICE_KERNELS_X86)
+
+// =============================================================================
+// SSE2 kernels (x86-64 baseline)
+// =============================================================================
+
+void Int16ToFloatSse2(const int16_t* input, size_t num_samples, float* output) {
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        // Sign-extend by placing each sample in the top half of a 32-bit lane
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    Int16ToFloatScalar(input + i, num_samples - i, output + i);
+}
+
+void FloatToInt16Sse2(const float* input, size_t num_samples, int16_t* output) {
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lo), hi);
+        const __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), lo), hi);
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, scale)),
+                                               _mm_cvttps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+    FloatToInt16Scalar(input + i, num_samples - i, output + i);
+}
+
+void StereoToMonoSse2(const float* stereo, size_t num_frames, float* mono) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= num_frames; i += 4) {
+        const __m128 a = _mm_loadu_ps(stereo + i * 2);      // L0 R0 L1 R1
+        const __m128 b = _mm_loadu_ps(stereo + i * 2 + 4);  // L2 R2 L3 R3
+        const __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+void Int16StereoToMonoSse2(const int16_t* stereo, size_t num_frames, float* mono) {
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128 scale = _mm_set1_ps(kStereoInt16Scale);
+    size_t i = 0;
+    for (; i + 4 <= num_frames; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stereo + i * 2));
+        const __m128i sums = _mm_madd_epi16(x, ones);  // L + R per frame, as int32
+        _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_cvtepi32_ps(sums), scale));
+    }
+    Int16StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+// SIMD loops step by an even count, so gains[i % 2] lines up with the lanes and
+// the scalar tail can start from gains[0]
+void MixInt16Sse2(const int16_t* input, size_t num_samples, const float gains[2],
+                  float* accumulator) {
+    const __m128 gain = _mm_setr_ps(gains[0], gains[1], gains[0], gains[1]);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i),
+                                                  _mm_mul_ps(_mm_cvtepi32_ps(lo), gain)));
+        _mm_storeu_ps(accumulator + i + 4, _mm_add_ps(_mm_loadu_ps(accumulator + i + 4),
+                                                      _mm_mul_ps(_mm_cvtepi32_ps(hi), gain)));
+    }
+    MixInt16Scalar(input + i, num_samples - i, gains, accumulator + i);
+}
+
+void ScaledFloatToInt16Sse2(const float* input, size_t num_samples, float gain,
+                            int16_t* output) {
+    const __m128 scale = _mm_set1_ps(gain);
+    const __m128 lo = _mm_set1_ps(kInt16Min);
+    const __m128 hi = _mm_set1_ps(kInt16Max);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), lo), hi);
+        const __m128 b =
+            _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), lo), hi);
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+    ScaledFloatToInt16Scalar(input + i, num_samples - i, gain, output + i);
+}
+
+constexpr AudioKernels kSse2Kernels = {SimdLevel::SSE2, "sse2", Int16ToFloatSse2, FloatToInt16Sse2,
+                                       StereoToMonoSse2, Int16StereoToMonoSse2, MixInt16Sse2,
+                                       ScaledFloatToInt16Sse2};
+
+// =============================================================================
+// AVX2 kernels
+// =============================================================================
+
+FFVOICE_TARGET_AVX2 void Int16ToFloatAvx2(const int16_t* input, size_t num_samples,
+                                          float* output) {
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 16 <= num_samples; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        _mm256_storeu_ps(output + i,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a)), scale));
+        _mm256_storeu_ps(output + i + 8,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b)), scale));
+    }
+    Int16ToFloatScalar(input + i, num_samples - i, output + i);
+}
+
+FFVOICE_TARGET_AVX2 void FloatToInt16Avx2(const float* input, size_t num_samples,
+                                          int16_t* output) {
+    const __m256 lo = _mm256_set1_ps(-1.0f);
+    const __m256 hi = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 16 <= num_samples; i += 16) {
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i), lo), hi);
+        const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i + 8), lo), hi);
+        // packs works per 128-bit lane (a0-3 b0-3 a4-7 b4-7); restore sample order
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(a, scale)),
+                                                  _mm256_cvttps_epi32(_mm256_mul_ps(b, scale)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                            _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    FloatToInt16Scalar(input + i, num_samples - i, output + i);
+}
+
+FFVOICE_TARGET_AVX2 void StereoToMonoAvx2(const float* stereo, size_t num_frames, float* mono) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 8 <= num_frames; i += 8) {
+        const __m256 a = _mm256_loadu_ps(stereo + i * 2);      // Frames 0-3
+        const __m256 b = _mm256_loadu_ps(stereo + i * 2 + 8);  // Frames 4-7
+        // Per lane: frames 0 1 4 5 | 2 3 6 7
+        const __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m256 avg = _mm256_mul_ps(_mm256_add_ps(left, right), half);
+        const __m256d ordered =
+            _mm256_permute4x64_pd(_mm256_castps_pd(avg), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_ps(mono + i, _mm256_castpd_ps(ordered));
+    }
+    StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+FFVOICE_TARGET_AVX2 void Int16StereoToMonoAvx2(const int16_t* stereo, size_t num_frames,
+                                               float* mono) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256 scale = _mm256_set1_ps(kStereoInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= num_frames; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stereo + i * 2));
+        const __m256i sums = _mm256_madd_epi16(x, ones);
+        _mm256_storeu_ps(mono + i, _mm256_mul_ps(_mm256_cvtepi32_ps(sums), scale));
+    }
+    Int16StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+FFVOICE_TARGET_AVX2 void MixInt16Avx2(const int16_t* input, size_t num_samples,
+                                      const float gains[2], float* accumulator) {
+    const __m256 gain = _mm256_setr_ps(gains[0], gains[1], gains[0], gains[1], gains[0],
+                                       gains[1], gains[0], gains[1]);
+    size_t i = 0;
+    for (; i + 16 <= num_samples; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        const __m256 fa = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a));
+        const __m256 fb = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b));
+        _mm256_storeu_ps(accumulator + i, _mm256_add_ps(_mm256_loadu_ps(accumulator + i),
+                                                        _mm256_mul_ps(fa, gain)));
+        _mm256_storeu_ps(accumulator + i + 8, _mm256_add_ps(_mm256_loadu_ps(accumulator + i + 8),
+                                                            _mm256_mul_ps(fb, gain)));
+    }
+    MixInt16Scalar(input + i, num_samples - i, gains, accumulator + i);
+}
+
+FFVOICE_TARGET_AVX2 void ScaledFloatToInt16Avx2(const float* input, size_t num_samples,
+                                                float gain, int16_t* output) {
+    const __m256 scale = _mm256_set1_ps(gain);
+    const __m256 lo = _mm256_set1_ps(kInt16Min);
+    const __m256 hi = _mm256_set1_ps(kInt16Max);
+    size_t i = 0;
+    for (; i + 16 <= num_samples; i += 16) {
+        const __m256 a = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale);
+        const __m256 b = _mm256_mul_ps(_mm256_loadu_ps(input + i + 8), scale);
+        const __m256i packed =
+            _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(a, lo), hi)),
+                               _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(b, lo), hi)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                            _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    ScaledFloatToInt16Scalar(input + i, num_samples - i, gain, output + i);
+}
+
+constexpr AudioKernels kAvx2Kernels = {SimdLevel::AVX2, "avx2", Int16ToFloatAvx2, FloatToInt16Avx2,
+                                       StereoToMonoAvx2, Int16StereoToMonoAvx2, MixInt16Avx2,
+                                       ScaledFloatToInt16Avx2};
+
+bool CpuSupportsAvx2() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;  // OS does not save YMM registers
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+    #else
+    return __builtin_cpu_supports("avx2");
+    #endif
+}
+
+#elif defined(FFVOICE_KERNELS_NEON)
+
+// =============================================================================
+// NEON kernels (AArch64 baseline)
+// =============================================================================
+
+void Int16ToFloatNeon(const int16_t* input, size_t num_samples, float* output) {
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const int16x8_t x = vld1q_s16(input + i);
+        vst1q_f32(output + i,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), kInt16Scale));
+        vst1q_f32(output + i + 4,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), kInt16Scale));
+    }
+    Int16ToFloatScalar(input + i, num_samples - i, output + i);
+}
+
+void FloatToInt16Neon(const float* input, size_t num_samples, int16_t* output) {
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(input + i), lo), hi);
+        const float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(input + i + 4), lo), hi);
+        // vcvtq_s32_f32 truncates toward zero, like static_cast
+        const int32x4_t ia = vcvtq_s32_f32(vmulq_n_f32(a, 32767.0f));
+        const int32x4_t ib = vcvtq_s32_f32(vmulq_n_f32(b, 32767.0f));
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+    }
+    FloatToInt16Scalar(input + i, num_samples - i, output + i);
+}
+
+void StereoToMonoNeon(const float* stereo, size_t num_frames, float* mono) {
+    size_t i = 0;
+    for (; i + 4 <= num_frames; i += 4) {
+        const float32x4x2_t lr = vld2q_f32(stereo + i * 2);  // Deinterleaves L and R
+        vst1q_f32(mono + i, vmulq_n_f32(vaddq_f32(lr.val[0], lr.val[1]), 0.5f));
+    }
+    StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+void Int16StereoToMonoNeon(const int16_t* stereo, size_t num_frames, float* mono) {
+    size_t i = 0;
+    for (; i + 4 <= num_frames; i += 4) {
+        const int32x4_t sums = vpaddlq_s16(vld1q_s16(stereo + i * 2));  // L + R per frame
+        vst1q_f32(mono + i, vmulq_n_f32(vcvtq_f32_s32(sums), kStereoInt16Scale));
+    }
+    Int16StereoToMonoScalar(stereo + i * 2, num_frames - i, mono + i);
+}
+
+void MixInt16Neon(const int16_t* input, size_t num_samples, const float gains[2],
+                  float* accumulator) {
+    const float pattern[4] = {gains[0], gains[1], gains[0], gains[1]};
+    const float32x4_t gain = vld1q_f32(pattern);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const int16x8_t x = vld1q_s16(input + i);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        // Separate multiply and add (not vfmaq) to match the scalar rounding
+        vst1q_f32(accumulator + i, vaddq_f32(vld1q_f32(accumulator + i), vmulq_f32(lo, gain)));
+        vst1q_f32(accumulator + i + 4,
+                  vaddq_f32(vld1q_f32(accumulator + i + 4), vmulq_f32(hi, gain)));
+    }
+    MixInt16Scalar(input + i, num_samples - i, gains, accumulator + i);
+}
+
+void ScaledFloatToInt16Neon(const float* input, size_t num_samples, float gain,
+                            int16_t* output) {
+    const float32x4_t lo = vdupq_n_f32(kInt16Min);
+    const float32x4_t hi = vdupq_n_f32(kInt16Max);
+    size_t i = 0;
+    for (; i + 8 <= num_samples; i += 8) {
+        const float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i), gain), lo), hi);
+        const float32x4_t b =
+            vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i + 4), gain), lo), hi);
+        vst1q_s16(output + i,
+                  vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+    }
+    ScaledFloatToInt16Scalar(input + i, num_samples - i, gain, output + i);
+}
+
+constexpr AudioKernels kNeonKernels = {SimdLevel::NEON, "neon", Int16ToFloatNeon, FloatToInt16Neon,
+                                       StereoToMonoNeon, Int16StereoToMonoNeon, MixInt16Neon,
+                                       ScaledFloatToInt16Neon};
+
+#endif
+
+const AudioKernels& SelectKernels() {
+#if defined(FFVOICE_KERNELS_X86)
+    return CpuSupportsAvx2() ? kAvx2Kernels : kSse2Kernels;
+#elif defined(FFVOICE_KERNELS_NEON)
+    return kNeonKernels;
+#else
+    return kScalarKernels;
+#endif
+}
+
+}  // namespace
+
+const AudioKernels& GetAudioKernels() {
+    static const AudioKernels& kernels = SelectKernels();
+    return kernels;
+}
+
+const AudioKernels* GetAudioKernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return &kScalarKernels;
+#if defined(FFVOICE_KERNELS_X86)
+        case SimdLevel::SSE2:
+            return &kSse2Kernels;
+        case SimdLevel::AVX2:
+            return CpuSupportsAvx2() ? &kAvx2Kernels : nullptr;
+#elif defined(FFVOICE_KERNELS_NEON)
+        case SimdLevel::NEON:
+            return &kNeonKernels;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,69 @@
+/**
+ * @file audio_kernels.h
+ * @brief SIMD sample-format conversion and mixing kernels with runtime CPU dispatch
+ *
+ * AudioConverter's conversion functions and AudioMixer forward to the kernels
+ * selected here, so they are vectorized even when the build does not use
+ * -march=native (universal2, ARM and distribution builds).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ffvoice {
+
+/**
+ * @brief Instruction set a kernel table is written for
+ */
+enum class SimdLevel {
+    Scalar,  ///< Portable C++ loops
+    SSE2,    ///< x86-64 baseline
+    AVX2,    ///< x86-64 with AVX2 (selected only if the CPU supports it)
+    NEON     ///< AArch64 baseline
+};
+
+/**
+ * @brief One implementation of every conversion kernel
+ *
+ * All kernels give bit-identical results to the Scalar table and accept any
+ * length; tails shorter than a vector are handled with scalar code.
+ */
+struct AudioKernels {
+    SimdLevel level;
+    const char* name;  ///< "scalar", "sse2", "avx2" or "neon"
+
+    /// int16 -> float in [-1, 1) (x / 32768)
+    void (*int16_to_float)(const int16_t* input, size_t num_samples, float* output);
+
+    /// float -> int16, clamped to [-1, 1] and scaled by 32767 (truncating)
+    void (*float_to_int16)(const float* input, size_t num_samples, int16_t* output);
+
+    /// Interleaved stereo float -> mono float ((L + R) * 0.5)
+    void (*stereo_to_mono)(const float* stereo, size_t num_frames, float* mono);
+
+    /// Interleaved stereo int16 -> mono float in one pass ((L + R) / 65536)
+    void (*int16_stereo_to_mono)(const int16_t* stereo, size_t num_frames, float* mono);
+
+    /// accumulator[i] += input[i] * gains[i % 2] (int16 scale; equal gains for mono)
+    void (*mix_int16)(const int16_t* input, size_t num_samples, const float gains[2],
+                      float* accumulator);
+
+    /// float at int16 scale -> int16: times gain, clamped to [-32768, 32767] (truncating)
+    void (*scaled_float_to_int16)(const float* input, size_t num_samples, float gain,
+                                  int16_t* output);
+};
+
+/**
+ * @brief Fastest kernel table the running CPU supports (chosen once, thread-safe)
+ */
+const AudioKernels& GetAudioKernels();
+
+/**
+ * @brief Kernel table for a specific instruction set
+ * @return nullptr if @p level was not compiled in or the CPU does not support it
+ */
+const AudioKernels* GetAudioKernels(SimdLevel level);
+
+}  // namespace ffvoice
@@ -0,0 +1,110 @@
+/**
+ * @file batch_inputs.cpp
+ * @brief Implementation of batch input discovery and output naming
+ */
+
+#include "utils/batch_inputs.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace ffvoice {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const kAudioExtensions[] = {".wav", ".flac", ".mp3",  ".m4a",
+                                        ".aac", ".ogg",  ".opus", ".webm"};
+
+/// Identity of an output path: "./a.srt" and "a.srt" are the same file
+std::string PathKey(const fs::path& path) {
+    std::error_code ec;
+    const fs::path absolute = fs::absolute(path, ec);
+    return (ec ? path : absolute).lexically_normal().string();
+}
+
+fs::path OutputPath(const std::string& input, const std::string& output_dir,
+                    const std::string& extension, bool keep_source_extension) {
+    fs::path output = fs::path(input);
+    output = keep_source_extension ? fs::path(output.string() + extension)
+                                   : output.replace_extension(extension);
+    if (!output_dir.empty()) {
+        output = fs::path(output_dir) / output.filename();
+    }
+    return output;
+}
+
+}  // namespace
+
+bool CollectBatchInputs(const std::string& source, std::vector<std::string>& files) {
+    std::error_code ec;
+    if (fs::is_directory(source, ec)) {
+        std::vector<std::string> found;
+        for (const auto& entry : fs::directory_iterator(source, ec)) {
+            if (!entry.is_regular_file(ec)) {
+                continue;
+            }
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (std::find(std::begin(kAudioExtensions), std::end(kAudioExtensions), ext) !=
+                std::end(kAudioExtensions)) {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+        return !ec;
+    }
+
+    std::ifstream manifest(source);
+    if (!manifest) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        const size_t end = line.find_last_not_of(" \t\r");
+        files.push_back(line.substr(begin, end - begin + 1));
+    }
+    return true;
+}
+
+bool PlanBatchOutputs(const std::vector<std::string>& files, const std::string& output_dir,
+                      const std::string& extension, std::vector<std::string>& outputs,
+                      std::string& error) {
+    outputs.clear();
+    error.clear();
+
+    // First pass: how many inputs want each plain output name
+    std::map<std::string, size_t> wanted;
+    for (const auto& input : files) {
+        ++wanted[PathKey(OutputPath(input, output_dir, extension, false))];
+    }
+
+    std::map<std::string, size_t> owner;  // Output key -> index of the input writing it
+    for (size_t i = 0; i < files.size(); ++i) {
+        fs::path output = OutputPath(files[i], output_dir, extension, false);
+        if (wanted[PathKey(output)] > 1) {
+            output = OutputPath(files[i], output_dir, extension, true);
+        }
+        const auto [it, inserted] = owner.emplace(PathKey(output), i);
+        if (!inserted) {
+            error = files[it->second] + " and " + files[i] + " would both write " +
+                    output.string();
+            outputs.clear();
+            return false;
+        }
+        outputs.push_back(output.string());
+    }
+    return true;
+}
+
+}  // namespace ffvoice
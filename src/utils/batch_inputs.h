@@ -0,0 +1,49 @@
+/**
+ * @file batch_inputs.h
+ * @brief Input discovery and output naming for batch transcription
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Resolve a batch source into audio file paths.
+ *
+ * A directory yields every regular file in it with an audio extension
+ * (.wav, .flac, .mp3, .m4a, .aac, .ogg, .opus, .webm; case-insensitive),
+ * sorted. Any other path is read as a manifest: one path per line, blank
+ * lines and lines starting with '#' skipped, surrounding whitespace trimmed.
+ *
+ * @param source Directory or manifest file
+ * @param files  Receives the paths (appended)
+ * @return false if the directory or manifest cannot be read
+ */
+bool CollectBatchInputs(const std::string& source, std::vector<std::string>& files);
+
+/**
+ * @brief Choose a distinct output path for every batch input.
+ *
+ * An input's output is the input with its extension replaced by
+ * @p extension, placed beside it or, when @p output_dir is set, in
+ * output_dir. Inputs that would share an output ("a.wav" and "a.flac") keep
+ * their source extension instead ("a.wav.srt", "a.flac.srt"). Inputs that
+ * still collide — the same file listed twice, or equal file names from
+ * different directories going into one output_dir — are an error, since
+ * concurrent workers would overwrite each other's result.
+ *
+ * @param files      Batch inputs
+ * @param output_dir Output directory, or empty for "beside each input"
+ * @param extension  Output extension including the dot, e.g. ".srt"
+ * @param outputs    Receives one path per input, in input order
+ * @param error      Receives a message naming the colliding inputs on failure
+ * @return false if two inputs map to the same output
+ */
+bool PlanBatchOutputs(const std::vector<std::string>& files, const std::string& output_dir,
+                      const std::string& extension, std::vector<std::string>& outputs,
+                      std::string& error);
+
+}  // namespace ffvoice
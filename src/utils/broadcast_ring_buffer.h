@@ -0,0 +1,292 @@
+/**
+ * @file broadcast_ring_buffer.h
+ * @brief Lock-free single-producer / multi-consumer (SPMC) broadcast ring buffer
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Lock-free SPMC broadcast ring buffer.
+ *
+ * Every element pushed by the single producer is delivered to every attached
+ * consumer. Each consumer owns a private read cursor, so consumers drain at
+ * their own speed and a slow one never delays the producer or the others.
+ *
+ * The producer is wait-free: push_bulk() never blocks and never fails. When a
+ * consumer falls more than capacity() elements behind, the oldest elements are
+ * overwritten; that consumer skips ahead to the oldest element still in the
+ * buffer and the number of elements it missed is added to its overrun counter.
+ * Reads are validated against the producer's write claim after copying (a
+ * seqlock-style check), so a consumer never returns data that was being
+ * overwritten while it was copying.
+ *
+ * Consumers are registered with add_consumer(), which returns a small integer
+ * id used for all per-consumer calls. A consumer added while the producer is
+ * running starts at the current write position. Each id must be used by one
+ * thread at a time.
+ *
+ * This follows the same monotonic-counter layout as RingBuffer: slots are
+ * addressed by (index % capacity_) and each cursor lives on its own cache line.
+ *
+ * @tparam T element type; must be trivially copyable
+ */
+template <typename T>
+class BroadcastRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BroadcastRingBuffer requires a trivially copyable element type");
+
+public:
+    /**
+     * @brief Construct a broadcast buffer.
+     * @param capacity      Elements retained for consumers (clamped to at least 1).
+     * @param max_consumers Maximum number of simultaneously attached consumers
+     *                      (clamped to at least 1).
+     */
+    explicit BroadcastRingBuffer(size_t capacity, size_t max_consumers = 4)
+        : capacity_(capacity == 0 ? 1 : capacity),
+          buffer_(capacity_),
+          num_cursors_(max_consumers == 0 ? 1 : max_consumers),
+          cursors_(new Cursor[num_cursors_]) {
+    }
+
+    BroadcastRingBuffer(const BroadcastRingBuffer&) = delete;
+    BroadcastRingBuffer& operator=(const BroadcastRingBuffer&) = delete;
+
+    /// Number of elements retained for consumers.
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    /// Maximum number of consumers that can be attached at once.
+    size_t max_consumers() const noexcept {
+        return num_cursors_;
+    }
+
+    /// Total number of elements ever pushed.
+    size_t total_pushed() const noexcept {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Attach a new consumer starting at the current write position.
+     * @return Consumer id, or -1 if max_consumers() are already attached.
+     */
+    int add_consumer() {
+        for (size_t i = 0; i < num_cursors_; ++i) {
+            bool expected = false;
+            if (cursors_[i].active.compare_exchange_strong(expected, true,
+                                                           std::memory_order_acq_rel)) {
+                cursors_[i].overruns.store(0, std::memory_order_relaxed);
+                cursors_[i].tail.store(head_.load(std::memory_order_acquire),
+                                       std::memory_order_release);
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Detach a consumer; its id may be reused by a later add_consumer().
+     */
+    void remove_consumer(int id) {
+        if (valid(id)) {
+            cursors_[id].active.store(false, std::memory_order_release);
+        }
+    }
+
+    /// Number of currently attached consumers.
+    size_t consumer_count() const noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i < num_cursors_; ++i) {
+            if (cursors_[i].active.load(std::memory_order_acquire)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Publish @p count elements to all consumers. Producer thread only.
+     *
+     * Wait-free: always accepts all elements. If @p count exceeds capacity(),
+     * only the last capacity() elements can still be observed by consumers.
+     *
+     * @return Number of elements accepted (always @p count, or 0 for null input).
+     */
+    size_t push_bulk(const T* data, size_t count) {
+        if (data == nullptr || count == 0) {
+            return 0;
+        }
+
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t remaining = count;
+        while (remaining > 0) {
+            // Write at most one full lap per step so the claim never runs more
+            // than capacity_ ahead of the published head.
+            const size_t n = std::min(remaining, capacity_);
+
+            // Announce the slots about to be overwritten before touching them.
+            claim_.store(head + n, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            copy_in(head, data, n);
+            head_.store(head + n, std::memory_order_release);
+
+            head += n;
+            data += n;
+            remaining -= n;
+        }
+        return count;
+    }
+
+    /// Push a single element. Producer thread only.
+    void push(const T& value) {
+        push_bulk(&value, 1);
+    }
+
+    /**
+     * @brief Number of elements consumer @p id can read right now.
+     *
+     * Never exceeds capacity(), even if the consumer has been overrun.
+     */
+    size_t available_read(int id) const noexcept {
+        if (!valid(id)) {
+            return 0;
+        }
+        const size_t lag =
+            head_.load(std::memory_order_acquire) - cursors_[id].tail.load(std::memory_order_relaxed);
+        return std::min(lag, capacity_);
+    }
+
+    /**
+     * @brief Read up to @p count elements for consumer @p id.
+     *
+     * Elements lost to an overrun (since the last call) are skipped and added
+     * to overruns(id).
+     *
+     * @return Number of elements copied to @p data.
+     */
+    size_t pop_bulk(int id, T* data, size_t count) {
+        if (!valid(id) || data == nullptr || count == 0) {
+            return 0;
+        }
+        Cursor& cursor = cursors_[id];
+
+        size_t tail = cursor.tail.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+
+        if (head - tail > capacity_) {
+            // The producer lapped us: skip to the oldest retained element.
+            const size_t lost = head - tail - capacity_;
+            cursor.overruns.fetch_add(lost, std::memory_order_relaxed);
+            tail += lost;
+        }
+
+        size_t n = std::min(count, head - tail);
+        if (n > 0) {
+            copy_out(tail, data, n);
+
+            // Validate the copy: any element whose slot the producer has since
+            // claimed for overwriting may be torn and must be discarded.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const size_t claim = claim_.load(std::memory_order_relaxed);
+            const size_t oldest_valid = claim > capacity_ ? claim - capacity_ : 0;
+            if (tail < oldest_valid) {
+                const size_t torn = std::min(n, oldest_valid - tail);
+                cursor.overruns.fetch_add(torn, std::memory_order_relaxed);
+                tail += torn;
+                n -= torn;
+                if (n > 0) {
+                    std::memmove(data, data + torn, n * sizeof(T));
+                }
+                if (tail < oldest_valid) {
+                    // Everything we copied was overwritten, and more besides.
+                    cursor.overruns.fetch_add(oldest_valid - tail, std::memory_order_relaxed);
+                    tail = oldest_valid;
+                }
+            }
+        }
+
+        cursor.tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Total elements consumer @p id has missed because it fell too far behind.
+    size_t overruns(int id) const noexcept {
+        return valid(id) ? cursors_[id].overruns.load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * @brief Reset the buffer and all cursors to empty.
+     *
+     * Only safe to call when neither the producer nor any consumer is running.
+     * Attached consumers stay attached.
+     */
+    void clear() noexcept {
+        head_.store(0, std::memory_order_relaxed);
+        claim_.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < num_cursors_; ++i) {
+            cursors_[i].tail.store(0, std::memory_order_relaxed);
+            cursors_[i].overruns.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Same value as RingBuffer::kCacheLine (covers 128-byte Apple Silicon lines).
+    static constexpr size_t kCacheLine = 128;
+
+    // Per-consumer state, one cache line each so consumers never false-share.
+    struct alignas(kCacheLine) Cursor {
+        std::atomic<size_t> tail{0};      // elements consumed by this consumer
+        std::atomic<size_t> overruns{0};  // elements this consumer missed
+        std::atomic<bool> active{false};  // slot in use
+    };
+
+    bool valid(int id) const noexcept {
+        return id >= 0 && static_cast<size_t>(id) < num_cursors_ &&
+               cursors_[id].active.load(std::memory_order_relaxed);
+    }
+
+    // Copy n (<= capacity_) elements into the ring starting at logical index start.
+    void copy_in(size_t start, const T* src, size_t n) {
+        const size_t pos = start % capacity_;
+        const size_t first = std::min(n, capacity_ - pos);
+        std::memcpy(&buffer_[pos], src, first * sizeof(T));
+        if (n > first) {
+            std::memcpy(&buffer_[0], src + first, (n - first) * sizeof(T));
+        }
+    }
+
+    // Copy n (<= capacity_) elements out of the ring starting at logical index start.
+    void copy_out(size_t start, T* dst, size_t n) const {
+        const size_t pos = start % capacity_;
+        const size_t first = std::min(n, capacity_ - pos);
+        std::memcpy(dst, &buffer_[pos], first * sizeof(T));
+        if (n > first) {
+            std::memcpy(dst + first, &buffer_[0], (n - first) * sizeof(T));
+        }
+    }
+
+    const size_t capacity_;
+    std::vector<T> buffer_;
+    const size_t num_cursors_;
+    std::unique_ptr<Cursor[]> cursors_;
+
+    // head_ is the published write position; claim_ is the position the
+    // producer is about to write up to. Both are written only by the producer
+    // and share its cache line.
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    std::atomic<size_t> claim_{0};
+};
+
+}  // namespace ffvoice
@@ -5,20 +5,286 @@
 
 #include "utils/logger.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace ffvoice {
 
+namespace {
+
+const char* Prefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::ERROR:
+            return "[ERROR] ";
+        case LogLevel::WARNING:
+            return "[WARNING] ";
+        case LogLevel::DEBUG:
+            return "[DEBUG] ";
+        case LogLevel::INFO:
+        default:
+            return "[INFO] ";
+    }
+}
+
+/**
+ * Bounded multi-producer / single-consumer queue of preformatted messages
+ * (Vyukov's sequence-numbered ring) drained by one writer thread.
+ *
+ * Producers claim a slot with one CAS and copy the text in; if the ring is
+ * full they count a drop and return, so a producer never waits. The writer
+ * polls (as AsyncFileSink's writer does) rather than being woken, because
+ * notifying a condition variable is not safe from a real-time callback.
+ */
+class AsyncLogWriter {
+public:
+    static AsyncLogWriter& Instance() {
+        static AsyncLogWriter writer;
+        return writer;
+    }
+
+    ~AsyncLogWriter() {
+        Stop();
+    }
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    void Start() {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (thread_.joinable()) {
+            return;
+        }
+        if (!slots_) {
+            // Allocated once and kept: a producer that saw running_ just
+            // before Stop() may still be copying into a slot
+            slots_ = std::make_unique<Slot[]>(kSlots);
+            for (size_t i = 0; i < kSlots; ++i) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        stop_requested_.store(false, std::memory_order_relaxed);
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread(&AsyncLogWriter::Run, this);
+    }
+
+    void Stop() {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (!thread_.joinable()) {
+            return;
+        }
+        running_.store(false, std::memory_order_release);
+        stop_requested_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    /// @return false if the ring was full (the message is dropped and counted)
+    bool Push(LogLevel level, const char* message) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots_[pos & (kSlots - 1)];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                dropped_total_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        const size_t length = std::min(std::strlen(message), kMessageSize - 1);
+        std::memcpy(slot->text, message, length);
+        slot->text[length] = '\0';
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Flush() {
+        if (!IsRunning()) {
+            return;
+        }
+        const size_t target = enqueue_pos_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        flush_cv_.wait(lock, [&]() {
+            return written_pos_ >= target || !IsRunning();
+        });
+    }
+
+    uint64_t GetDroppedTotal() const {
+        return dropped_total_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kSlots = 256;        // Power of two
+    static constexpr size_t kMessageSize = 1024;  // Same limit as the LOG_* macros
+    static constexpr auto kIdleSleep = std::chrono::milliseconds(5);
+    static constexpr auto kRepeatInterval = std::chrono::seconds(1);
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::INFO;
+        char text[kMessageSize];
+    };
+
+    AsyncLogWriter() = default;
+
+    void Run() {
+        for (;;) {
+            // Read before draining so nothing pushed before the stop is missed
+            const bool stopping = stop_requested_.load(std::memory_order_acquire);
+            const bool wrote = Drain();
+            ReportDrops();
+            if (repeats_ > 0 && std::chrono::steady_clock::now() - last_write_ >= kRepeatInterval) {
+                WriteRepeats();
+            }
+            if (wrote) {
+                std::cerr.flush();
+            }
+            {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                written_pos_ = dequeue_pos_;
+            }
+            flush_cv_.notify_all();
+            if (stopping) {
+                break;
+            }
+            if (!wrote) {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+        }
+        WriteRepeats();
+        std::cerr.flush();
+        flush_cv_.notify_all();
+    }
+
+    /// @return true if anything was taken off the ring
+    bool Drain() {
+        bool any = false;
+        for (;;) {
+            Slot& slot = slots_[dequeue_pos_ & (kSlots - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+                return any;  // Empty, or the next producer is still copying
+            }
+            Consume(slot.level, slot.text);
+            slot.sequence.store(dequeue_pos_ + kSlots, std::memory_order_release);
+            ++dequeue_pos_;
+            any = true;
+        }
+    }
+
+    void Consume(LogLevel level, const char* text) {
+        if (have_last_ && level == last_level_ && last_text_ == text) {
+            ++repeats_;
+            return;
+        }
+        WriteRepeats();
+        std::cerr << Prefix(level) << text << '\n';
+        last_level_ = level;
+        last_text_ = text;
+        have_last_ = true;
+        last_write_ = std::chrono::steady_clock::now();
+    }
+
+    void WriteRepeats() {
+        if (repeats_ == 0) {
+            return;
+        }
+        std::cerr << Prefix(last_level_) << last_text_ << " (repeated " << repeats_
+                  << " more times)\n";
+        repeats_ = 0;
+        last_write_ = std::chrono::steady_clock::now();
+    }
+
+    void ReportDrops() {
+        const uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            WriteRepeats();
+            std::cerr << Prefix(LogLevel::WARNING) << "Logger: " << dropped
+                      << " messages dropped (queue full)\n";
+            have_last_ = false;
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;  // Writer thread only
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> dropped_total_{0};
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_requested_{false};
+    std::thread thread_;
+    std::mutex control_mutex_;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    size_t written_pos_ = 0;
+
+    // Coalescing state (writer thread only)
+    bool have_last_ = false;
+    LogLevel last_level_ = LogLevel::INFO;
+    std::string last_text_;
+    uint64_t repeats_ = 0;
+    std::chrono::steady_clock::time_point last_write_;
+};
+
+}  // namespace
+
+void log_message(LogLevel level, const char* message) {
+    AsyncLogWriter& writer = AsyncLogWriter::Instance();
+    if (writer.IsRunning()) {
+        writer.Push(level, message);
+        return;
+    }
+    std::cerr << Prefix(level) << message << std::endl;
+}
+
 void log_info(const std::string& message) {
-    std::cerr << "[INFO] " << message << std::endl;
+    log_message(LogLevel::INFO, message.c_str());
 }
 
 void log_warning(const std::string& message) {
-    std::cerr << "[WARNING] " << message << std::endl;
+    log_message(LogLevel::WARNING, message.c_str());
 }
 
 void log_error(const std::string& message) {
-    std::cerr << "[ERROR] " << message << std::endl;
+    log_message(LogLevel::ERROR, message.c_str());
+}
+
+void set_async_logging(bool enabled) {
+    if (enabled) {
+        AsyncLogWriter::Instance().Start();
+    } else {
+        AsyncLogWriter::Instance().Stop();
+    }
+}
+
+bool is_async_logging() {
+    return AsyncLogWriter::Instance().IsRunning();
+}
+
+void flush_log() {
+    AsyncLogWriter::Instance().Flush();
+}
+
+uint64_t get_dropped_log_messages() {
+    return AsyncLogWriter::Instance().GetDroppedTotal();
 }
 
 }  // namespace ffvoice
@@ -8,42 +8,107 @@
  * log_warning are available for callers that already hold a std::string.
  *
  * Output destinations:
+ *   LOG_DEBUG   -> stderr
  *   LOG_INFO    -> stderr
  *   LOG_WARNING -> stderr
  *   LOG_ERROR   -> stderr
+ *
+ * By default every message is written synchronously. set_async_logging(true)
+ * switches to a background writer: a message is formatted on the caller's
+ * stack and copied into a fixed lock-free queue, so logging from the audio
+ * callback never takes a lock, allocates or waits on stderr. A full queue
+ * drops the message (and the writer reports how many); identical messages in
+ * a row are coalesced into one line plus "(repeated N more times)", at most
+ * once per second.
+ *
+ * Levels more verbose than FFVOICE_LOG_LEVEL (a compile definition, one of
+ * FFVOICE_LOG_LEVEL_*; INFO by default, so LOG_DEBUG is off) compile to
+ * nothing: the format string is still type checked but neither it nor its
+ * arguments are evaluated.
  */
 
 #pragma once
 
+#include "ffvoice/types.h"
+
+#include <cstdint>
 #include <cstdio>
 #include <string>
 
+// Same values as ffvoice::LogLevel
+#define FFVOICE_LOG_LEVEL_NONE -1
+#define FFVOICE_LOG_LEVEL_ERROR 0
+#define FFVOICE_LOG_LEVEL_WARNING 1
+#define FFVOICE_LOG_LEVEL_INFO 2
+#define FFVOICE_LOG_LEVEL_DEBUG 3
+
+#ifndef FFVOICE_LOG_LEVEL
+    #define FFVOICE_LOG_LEVEL FFVOICE_LOG_LEVEL_INFO
+#endif
+
 namespace ffvoice {
 
 void log_info(const std::string& message);
 void log_warning(const std::string& message);
 void log_error(const std::string& message);
 
+/// Write (or, in async mode, enqueue) one message; never allocates in async mode
+void log_message(LogLevel level, const char* message);
+
+/**
+ * @brief Start or stop the background log writer
+ *
+ * Stopping writes out everything already queued before returning. Call from
+ * a normal thread, not from a real-time callback.
+ */
+void set_async_logging(bool enabled);
+
+bool is_async_logging();
+
+/// Block until every message queued so far has been written (no-op when synchronous)
+void flush_log();
+
+/// Messages dropped because the async queue was full, since process start
+uint64_t get_dropped_log_messages();
+
 }  // namespace ffvoice
 
-// Printf-style logging macros
-#define LOG_INFO(fmt, ...)                              \
-    do {                                                \
-        char buf[1024];                                 \
-        snprintf(buf, sizeof(buf), fmt, ##__VA_ARGS__); \
-        ffvoice::log_info(buf);                         \
+// Printf-style logging macros: LOG_INFO(fmt, ...)
+#define FFVOICE_LOG_AT(level, ...)                  \
+    do {                                            \
+        char buf[1024];                             \
+        snprintf(buf, sizeof(buf), __VA_ARGS__);    \
+        ffvoice::log_message(level, buf);           \
     } while (0)
 
-#define LOG_WARNING(fmt, ...)                           \
-    do {                                                \
-        char buf[1024];                                 \
-        snprintf(buf, sizeof(buf), fmt, ##__VA_ARGS__); \
-        ffvoice::log_warning(buf);                      \
+// A compiled-out level: keeps the format checked and the arguments "used"
+#define FFVOICE_LOG_DISCARD(...)                    \
+    do {                                            \
+        if (false) {                                \
+            snprintf(nullptr, 0, __VA_ARGS__);      \
+        }                                           \
     } while (0)
 
-#define LOG_ERROR(fmt, ...)                             \
-    do {                                                \
-        char buf[1024];                                 \
-        snprintf(buf, sizeof(buf), fmt, ##__VA_ARGS__); \
-        ffvoice::log_error(buf);                        \
-    } while (0)
+#if FFVOICE_LOG_LEVEL >= FFVOICE_LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(...) FFVOICE_LOG_AT(ffvoice::LogLevel::DEBUG, __VA_ARGS__)
+#else
+    #define LOG_DEBUG(...) FFVOICE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if FFVOICE_LOG_LEVEL >= FFVOICE_LOG_LEVEL_INFO
+    #define LOG_INFO(...) FFVOICE_LOG_AT(ffvoice::LogLevel::INFO, __VA_ARGS__)
+#else
+    #define LOG_INFO(...) FFVOICE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if FFVOICE_LOG_LEVEL >= FFVOICE_LOG_LEVEL_WARNING
+    #define LOG_WARNING(...) FFVOICE_LOG_AT(ffvoice::LogLevel::WARNING, __VA_ARGS__)
+#else
+    #define LOG_WARNING(...) FFVOICE_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if FFVOICE_LOG_LEVEL >= FFVOICE_LOG_LEVEL_ERROR
+    #define LOG_ERROR(...) FFVOICE_LOG_AT(ffvoice::LogLevel::ERROR, __VA_ARGS__)
+#else
+    #define LOG_ERROR(...) FFVOICE_LOG_DISCARD(__VA_ARGS__)
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file mapped_file.cpp
+ * @brief MappedFile implementation (POSIX mmap and Windows file mappings)
+ */
+
+#include "utils/mapped_file.h"
+
+#include "utils/logger.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace ffvoice {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path, bool prefetch) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              prefetch ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        last_error_ = "Cannot open " + path + " (error " + std::to_string(::GetLastError()) + ")";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        last_error_ = "Cannot map empty or unreadable file: " + path;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        last_error_ = "Cannot map " + path + " (error " + std::to_string(::GetLastError()) + ")";
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    file_ = nullptr;
+    mapping_ = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, bool prefetch) {
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        last_error_ = "Cannot open " + path + ": " + std::strerror(errno);
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        last_error_ = "Cannot map empty or unreadable file: " + path;
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        last_error_ = "Cannot map " + path + ": " + std::strerror(errno);
+        LOG_ERROR("%s", last_error_.c_str());
+        return false;
+    }
+    if (prefetch) {
+        // Read ahead aggressively and start pulling the whole file in now
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        ::madvise(data, size, MADV_WILLNEED);
+    }
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif  // _WIN32
+
+}  // namespace ffvoice
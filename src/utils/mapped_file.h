@@ -0,0 +1,72 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory-mapped file
+ *
+ * Reading a model with buffered stdio copies it through a user-space buffer
+ * one chunk at a time. Mapping it instead lets the kernel read ahead in large
+ * sequential requests straight from the page cache, and every process that
+ * maps the same file shares those cached pages: after the first run, loading
+ * a 500 MB model is a memory copy rather than disk I/O.
+ *
+ * @code
+ * MappedFile file;
+ * if (file.Open(path)) {
+ *     Parse(file.GetData(), file.GetSize());
+ * }  // Unmapped when file goes out of scope
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ffvoice {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map @p path read-only (unmapping any previous file)
+     * @param path File to map
+     * @param prefetch Ask the kernel to start reading the whole file now
+     * @return false if the file cannot be opened or mapped, or is empty
+     */
+    bool Open(const std::string& path, bool prefetch = true);
+
+    /// Unmap the file; safe to call when nothing is mapped
+    void Close();
+
+    bool IsOpen() const {
+        return data_ != nullptr;
+    }
+
+    const uint8_t* GetData() const {
+        return data_;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+    std::string GetLastError() const {
+        return last_error_;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;     ///< HANDLE of the open file
+    void* mapping_ = nullptr;  ///< HANDLE of the file mapping
+#endif
+    std::string last_error_;
+};
+
+}  // namespace ffvoice
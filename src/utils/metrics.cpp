@@ -0,0 +1,237 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the pipeline metrics registry
+ */
+
+#include "utils/metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace ffvoice {
+
+// ============================================================================
+// MetricHistogram
+// ============================================================================
+
+size_t MetricHistogram::BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    if (value >= (uint64_t{1} << kMaxValueBits)) {
+        return kNumBuckets - 1;
+    }
+    // The top kSubBucketBits + 1 bits select the bucket: the exponent picks
+    // the power-of-two range, the bits below the leading one the sub-bucket
+    const int msb = 63 - std::countl_zero(value);
+    const int shift = msb - kSubBucketBits;
+    return static_cast<size_t>(shift + 1) * kSubBuckets +
+           static_cast<size_t>((value >> shift) - kSubBuckets);
+}
+
+uint64_t MetricHistogram::BucketLowerBound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const int shift = static_cast<int>(index / kSubBuckets) - 1;
+    return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+void MetricHistogram::Record(uint64_t value) {
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t seen = min_.load(std::memory_order_relaxed);
+    while (value < seen && !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+    seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t MetricHistogram::GetMin() const {
+    const uint64_t min = min_.load(std::memory_order_relaxed);
+    return min == UINT64_MAX ? 0 : min;
+}
+
+double MetricHistogram::GetMean() const {
+    const uint64_t count = GetCount();
+    return count > 0 ? static_cast<double>(GetSum()) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t MetricHistogram::GetPercentile(double percentile) const {
+    // Sum the buckets rather than trusting count_: a concurrent Record() may
+    // have bumped one but not yet the other
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    if (percentile <= 0.0) {
+        return GetMin();
+    }
+    if (percentile >= 100.0) {
+        return GetMax();
+    }
+    const double p = percentile;
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t low = BucketLowerBound(i);
+            const uint64_t width = i + 1 < kNumBuckets ? BucketLowerBound(i + 1) - low : 1;
+            return std::clamp(low + width / 2, GetMin(), GetMax());
+        }
+    }
+    return GetMax();
+}
+
+HistogramSnapshot MetricHistogram::GetSnapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.count = GetCount();
+    snapshot.sum = GetSum();
+    snapshot.min = GetMin();
+    snapshot.max = GetMax();
+    snapshot.mean = GetMean();
+    snapshot.p50 = GetPercentile(50.0);
+    snapshot.p90 = GetPercentile(90.0);
+    snapshot.p99 = GetPercentile(99.0);
+    snapshot.p999 = GetPercentile(99.9);
+    return snapshot;
+}
+
+void MetricHistogram::Reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// MetricsRegistry
+// ============================================================================
+
+namespace {
+
+// Metric names are chosen by the code (processor names included), but keep
+// the output valid JSON whatever they contain
+std::string EscapeJson(const std::string& input) {
+    std::string out;
+    out.reserve(input.size());
+    for (unsigned char c : input) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+MetricsRegistry& MetricsRegistry::Instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricCounter& MetricsRegistry::Counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<MetricCounter>();
+    }
+    return *slot;
+}
+
+MetricHistogram& MetricsRegistry::Histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<MetricHistogram>();
+    }
+    return *slot;
+}
+
+std::map<std::string, uint64_t> MetricsRegistry::GetCounters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, uint64_t> values;
+    for (const auto& [name, counter] : counters_) {
+        values[name] = counter->Get();
+    }
+    return values;
+}
+
+std::map<std::string, HistogramSnapshot> MetricsRegistry::GetHistograms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, HistogramSnapshot> values;
+    for (const auto& [name, histogram] : histograms_) {
+        values[name] = histogram->GetSnapshot();
+    }
+    return values;
+}
+
+std::string MetricsRegistry::ToJson() const {
+    const auto counters = GetCounters();
+    const auto histograms = GetHistograms();
+
+    std::ostringstream json;
+    json << "{\"enabled\":" << (IsEnabled() ? "true" : "false") << ",\"counters\":{";
+    bool first = true;
+    for (const auto& [name, value] : counters) {
+        json << (first ? "" : ",") << '"' << EscapeJson(name) << "\":" << value;
+        first = false;
+    }
+    json << "},\"histograms\":{";
+    first = true;
+    for (const auto& [name, h] : histograms) {
+        char mean[32];
+        std::snprintf(mean, sizeof(mean), "%.3f", h.mean);
+        json << (first ? "" : ",") << '"' << EscapeJson(name) << "\":{\"count\":" << h.count
+             << ",\"sum\":" << h.sum << ",\"min\":" << h.min << ",\"max\":" << h.max
+             << ",\"mean\":" << mean << ",\"p50\":" << h.p50 << ",\"p90\":" << h.p90
+             << ",\"p99\":" << h.p99 << ",\"p999\":" << h.p999 << '}';
+        first = false;
+    }
+    json << '}';
+
+    const auto audio = counters.find("whisper.audio_us");
+    const auto total = histograms.find("whisper.total_us");
+    if (audio != counters.end() && total != histograms.end() && total->second.sum > 0) {
+        char rtf[32];
+        std::snprintf(rtf, sizeof(rtf), "%.3f",
+                      static_cast<double>(audio->second) / static_cast<double>(total->second.sum));
+        json << ",\"whisper_realtime_factor\":" << rtf;
+    }
+    json << '}';
+    return json.str();
+}
+
+void MetricsRegistry::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, counter] : counters_) {
+        counter->Reset();
+    }
+    for (auto& [name, histogram] : histograms_) {
+        histogram->Reset();
+    }
+}
+
+}  // namespace ffvoice
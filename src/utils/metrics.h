@@ -0,0 +1,232 @@
+/**
+ * @file metrics.h
+ * @brief Process-wide pipeline metrics: lock-free counters and latency histograms
+ *
+ * Every stage of the capture → process → transcribe → write pipeline records
+ * into MetricsRegistry::Instance() under a fixed name (see "Metric names"
+ * below), so one snapshot shows where the time goes and whether audio is
+ * being lost. Recording is off until MetricsRegistry::SetEnabled(true); while
+ * off, a ScopedTimer does not even read the clock.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ffvoice {
+
+/**
+ * @brief Monotonic event counter; Add() is a single relaxed atomic increment
+ */
+class MetricCounter {
+public:
+    void Add(uint64_t n = 1) {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+    void Reset() {
+        value_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/// Point-in-time summary of a MetricHistogram
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+/**
+ * @brief HDR-style histogram of non-negative integer values (e.g. microseconds)
+ *
+ * Values below 32 get exact buckets; above that each power of two is split
+ * into 32 linear sub-buckets, so a percentile is within ~3% of the true
+ * value over the whole range (up to 2^36, about 19 hours in microseconds;
+ * larger values count in the top bucket). Record() is wait-free: a few
+ * relaxed atomic operations on fixed storage, safe from a real-time thread
+ * and from any number of threads at once.
+ */
+class MetricHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    static constexpr int kMaxValueBits = 36;
+    static constexpr size_t kNumBuckets = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    /// Record one value
+    void Record(uint64_t value);
+
+    uint64_t GetCount() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetSum() const {
+        return sum_.load(std::memory_order_relaxed);
+    }
+
+    /// Smallest recorded value (0 if empty)
+    uint64_t GetMin() const;
+
+    uint64_t GetMax() const {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    double GetMean() const;
+
+    /**
+     * @brief Value at @p percentile (0-100) of the recorded distribution
+     * @return Midpoint of the bucket holding that rank, clamped to [min, max]
+     *         (exactly min at 0 and max at 100); 0 if empty
+     */
+    uint64_t GetPercentile(double percentile) const;
+
+    HistogramSnapshot GetSnapshot() const;
+
+    void Reset();
+
+    /// Bucket holding @p value
+    static size_t BucketIndex(uint64_t value);
+
+    /// Smallest value that falls into bucket @p index
+    static uint64_t BucketLowerBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Named counters and histograms shared by the whole process
+ *
+ * Counter() and Histogram() create the metric on first use and take a
+ * mutex, so hot paths look their handles up once (at construction or
+ * Open()) and keep the reference; handles stay valid for the life of the
+ * process, including across Reset().
+ *
+ * Metric names (histograms are in microseconds unless noted):
+ * - capture.callback_us, capture.read_us, capture.frames, capture.input_overflows
+ * - processor.<GetName()>_us: one histogram per processor in an AudioProcessorChain;
+ *   processor.ProcessorChain_us for a whole fused ProcessorChain
+ * - sink.ring_fill_pct (0-100), sink.dropped_samples, sink.write_us, sink.written_samples
+ * - captioner.ring_fill_pct (0-100), captioner.dropped_samples, captioner.vad_to_final_us,
+ *   captioner.time_to_first_caption_us (one value per captioner, from Initialize())
+ * - whisper.convert_us, whisper.inference_us, whisper.extract_us, whisper.total_us,
+ *   whisper.audio_us (counter of transcribed audio; divided by the sum of
+ *   whisper.total_us it gives the real-time factor)
+ * - whisper.load_us (model file to context), whisper.warmup_us (WhisperProcessor::Warmup())
+ *
+ * @code
+ * MetricsRegistry::SetEnabled(true);
+ * MetricHistogram& latency = MetricsRegistry::Instance().Histogram("my.stage_us");
+ * {
+ *     ScopedTimer timer(latency);
+ *     DoWork();
+ * }
+ * std::string json = MetricsRegistry::Instance().ToJson();
+ * @endcode
+ */
+class MetricsRegistry {
+public:
+    /// Global registry instance
+    static MetricsRegistry& Instance();
+
+    /// Turn recording on or off for ScopedTimer and the pipeline's instrumentation
+    static void SetEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Counter named @p name, created on first use
+    MetricCounter& Counter(const std::string& name);
+
+    /// Histogram named @p name, created on first use
+    MetricHistogram& Histogram(const std::string& name);
+
+    /// Current value of every counter
+    std::map<std::string, uint64_t> GetCounters() const;
+
+    /// Summary of every histogram
+    std::map<std::string, HistogramSnapshot> GetHistograms() const;
+
+    /**
+     * @brief All metrics as one JSON object
+     *
+     * {"enabled":true,"counters":{"name":N,...},
+     *  "histograms":{"name":{"count":N,"sum":N,"min":N,"max":N,"mean":X,
+     *                        "p50":N,"p90":N,"p99":N,"p999":N},...},
+     *  "whisper_realtime_factor":X}
+     * The real-time factor is present once Whisper has transcribed something.
+     */
+    std::string ToJson() const;
+
+    /// Zero every metric (handles stay valid)
+    void Reset();
+
+private:
+    MetricsRegistry() = default;
+
+    static inline std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters_;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms_;
+};
+
+/**
+ * @brief Records the lifetime of the scope into a histogram, in microseconds
+ *
+ * Does nothing (not even a clock read) when metrics are disabled at construction.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(MetricHistogram& histogram)
+        : histogram_(MetricsRegistry::IsEnabled() ? &histogram : nullptr) {
+        if (histogram_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (histogram_) {
+            histogram_->Record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_)
+                    .count()));
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    MetricHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace ffvoice
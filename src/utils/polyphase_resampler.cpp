@@ -0,0 +1,270 @@
+/**
+ * @file polyphase_resampler.cpp
+ * @brief Implementation of the polyphase windowed-sinc resampler
+ */
+
+#include "utils/polyphase_resampler.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__AVX2__) && defined(__FMA__)
+    #include <immintrin.h>
+    #define FFVOICE_RESAMPLER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define FFVOICE_RESAMPLER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define FFVOICE_RESAMPLER_NEON
+#endif
+
+namespace ffvoice {
+
+namespace {
+
+// Zero crossings of the sinc on each side, counted at the lower of the two
+// rates. 24 gives a ~1.7 kHz transition band for 48k -> 16k.
+constexpr size_t kZeroCrossings = 24;
+
+// Cutoff as a fraction of the lower Nyquist frequency; with the transition
+// band above, the stopband starts close to Nyquist itself.
+constexpr double kRolloff = 0.9;
+
+// Kaiser window shape (~80 dB stopband attenuation)
+constexpr double kKaiserBeta = 8.0;
+
+// Taps are padded to a multiple of 8 so every kernel runs without a tail loop
+constexpr size_t kTapAlignment = 8;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function of the first kind (series expansion)
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double half_x_sq = 0.25 * x * x;
+    for (int k = 1; k < 64 && term > 1e-12 * sum; ++k) {
+        term *= half_x_sq / (static_cast<double>(k) * k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Dot product of two arrays whose length is a multiple of kTapAlignment
+float Dot(const float* a, const float* b, size_t n) {
+#if defined(FFVOICE_RESAMPLER_AVX2)
+    // Two accumulators hide the FMA latency chain
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i < n) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+#elif defined(FFVOICE_RESAMPLER_SSE2)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (size_t i = 0; i < n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+#elif defined(FFVOICE_RESAMPLER_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#endif
+}
+
+}  // namespace
+
+PolyphaseResampler::PolyphaseResampler(int input_rate, int output_rate)
+    : input_rate_(input_rate), output_rate_(output_rate) {
+    if (input_rate <= 0 || output_rate <= 0) {
+        LOG_ERROR("PolyphaseResampler: invalid sample rate: input=%d, output=%d", input_rate,
+                  output_rate);
+        return;
+    }
+
+    const int divisor = std::gcd(input_rate, output_rate);
+    up_ = static_cast<size_t>(output_rate / divisor);
+    down_ = static_cast<size_t>(input_rate / divisor);
+    if (up_ > kMaxPhases) {
+        LOG_ERROR("PolyphaseResampler: %d -> %d Hz needs %zu phases (max %zu)", input_rate,
+                  output_rate, up_, kMaxPhases);
+        return;
+    }
+    valid_ = true;
+
+    // Equal rates: plain copy, no filter
+    if (up_ == down_) {
+        return;
+    }
+
+    // Filter length in input samples: kZeroCrossings per side at the lower rate
+    const double ratio = static_cast<double>(down_) / static_cast<double>(up_);
+    const size_t raw_taps =
+        static_cast<size_t>(std::ceil(2.0 * kZeroCrossings * std::max(1.0, ratio)));
+    taps_ = (raw_taps + kTapAlignment - 1) / kTapAlignment * kTapAlignment;
+
+    // Cutoff in cycles per input sample
+    const double cutoff = 0.5 * kRolloff * std::min(1.0, 1.0 / ratio);
+    const double half_length = static_cast<double>(taps_) / 2.0;
+    const double i0_beta = BesselI0(kKaiserBeta);
+
+    // Prototype tap j (of up_ * taps_) sits at t = (j - up_ * taps_ / 2) / up_ input samples.
+    // Phase p uses taps j = p + k * up_, stored reversed so that output = Dot(row, input window).
+    bank_.assign(up_ * taps_, 0.0f);
+    for (size_t p = 0; p < up_; ++p) {
+        float* row = bank_.data() + p * taps_;
+        double sum = 0.0;
+        for (size_t k = 0; k < taps_; ++k) {
+            const double t =
+                (static_cast<double>(p + k * up_) - static_cast<double>(up_ * taps_) / 2.0) /
+                static_cast<double>(up_);
+            const double x = 2.0 * cutoff * t;
+            const double sinc = std::abs(x) < 1e-12 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            const double r = t / half_length;
+            const double window =
+                std::abs(r) >= 1.0 ? 0.0 : BesselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / i0_beta;
+            const double h = 2.0 * cutoff * sinc * window;
+            row[taps_ - 1 - k] = static_cast<float>(h);
+            sum += h;
+        }
+        // Unity DC gain for every phase (removes the ripple between phases)
+        if (sum != 0.0) {
+            for (size_t k = 0; k < taps_; ++k) {
+                row[k] = static_cast<float>(row[k] / sum);
+            }
+        }
+    }
+
+    Reset();
+}
+
+size_t PolyphaseResampler::GetMaxOutputSize(size_t input_size) const {
+    if (up_ == down_) {
+        return input_size;
+    }
+    return ((pending_.size() + input_size) * up_ + phase_) / down_ + 1;
+}
+
+void PolyphaseResampler::Reset() {
+    // Half a window of leading silence centers the first output on input[0]
+    pending_.assign(taps_ > 0 ? taps_ / 2 - 1 : 0, 0.0f);
+    phase_ = 0;
+}
+
+size_t PolyphaseResampler::Process(const float* input, size_t input_size, float* output,
+                                   size_t output_capacity) {
+    if (!valid_) {
+        return 0;
+    }
+    if (up_ == down_) {
+        const size_t n = std::min(input_size, output_capacity);
+        if (n > 0) {
+            std::memcpy(output, input, n * sizeof(float));
+        }
+        return n;
+    }
+    Append(input, input_size);
+    return Drain(output, output_capacity);
+}
+
+size_t PolyphaseResampler::Flush(float* output, size_t output_capacity) {
+    if (!valid_ || up_ == down_) {
+        return 0;
+    }
+    // Push silence through the filter until the last real sample reaches the center
+    Append(nullptr, GetLatency());
+    const size_t written = Drain(output, output_capacity);
+    Reset();
+    return written;
+}
+
+size_t PolyphaseResampler::ResampleBuffer(const float* input, size_t input_size, float* output,
+                                          size_t output_size) {
+    size_t written = 0;
+    if (valid_) {
+        Reset();
+        written = Process(input, input_size, output, output_size);
+        written += Flush(output + written, output_size - written);
+    }
+    if (written < output_size) {
+        std::fill(output + written, output + output_size, 0.0f);
+    }
+    return written;
+}
+
+const char* PolyphaseResampler::GetKernelName() {
+#if defined(FFVOICE_RESAMPLER_AVX2)
+    return "avx2";
+#elif defined(FFVOICE_RESAMPLER_SSE2)
+    return "sse2";
+#elif defined(FFVOICE_RESAMPLER_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+void PolyphaseResampler::Append(const float* input, size_t count) {
+    const size_t old_size = pending_.size();
+    pending_.resize(old_size + count);
+    if (input) {
+        std::memcpy(pending_.data() + old_size, input, count * sizeof(float));
+    } else {
+        std::fill(pending_.begin() + static_cast<std::ptrdiff_t>(old_size), pending_.end(), 0.0f);
+    }
+}
+
+size_t PolyphaseResampler::Drain(float* output, size_t output_capacity) {
+    const float* data = pending_.data();
+    const size_t available = pending_.size();
+
+    size_t start = 0;  // Window start (oldest sample of the next output)
+    size_t written = 0;
+    while (written < output_capacity && start + taps_ <= available) {
+        output[written++] = Dot(bank_.data() + phase_ * taps_, data + start, taps_);
+        phase_ += down_;
+        start += phase_ / up_;
+        phase_ %= up_;
+    }
+
+    // Keep everything from the next window start on. start never passes the end:
+    // one step advances at most ceil(M / L) samples, and taps_ is larger than that.
+    const size_t kept = available - start;
+    if (start > 0) {
+        std::memmove(pending_.data(), data + start, kept * sizeof(float));
+        pending_.resize(kept);
+    }
+    return written;
+}
+
+}  // namespace ffvoice
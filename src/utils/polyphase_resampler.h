@@ -0,0 +1,154 @@
+/**
+ * @file polyphase_resampler.h
+ * @brief Streaming polyphase windowed-sinc resampler
+ *
+ * Band-limits before decimating, so content above the output Nyquist
+ * frequency (e.g. 8-24 kHz when going 48 kHz -> 16 kHz) is attenuated
+ * instead of aliasing down into the speech band.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ffvoice {
+
+/**
+ * @brief Rational-ratio resampler with a precomputed Kaiser-windowed sinc filter bank
+ *
+ * The rate ratio is reduced to L/M (48000 -> 16000 is 1/3, 44100 -> 16000 is
+ * 160/441) and the low-pass prototype is split into L phases, so each output
+ * sample is one dot product of taps_per_phase coefficients against the input.
+ * The dot product uses AVX2/FMA, SSE2 or NEON when the build targets them.
+ *
+ * Output is delay-compensated: output[i] lines up with input time
+ * i * input_rate / output_rate. Use it in one of two ways:
+ * - Streaming: call Process() chunk by chunk, then Flush() at end of stream.
+ *   The newest GetLatency() input samples are held back until more input
+ *   (or Flush()) completes their filter window.
+ * - One-shot: ResampleBuffer() converts a whole buffer in one call.
+ *
+ * @code
+ * PolyphaseResampler resampler(48000, 16000);
+ * std::vector<float> out(resampler.GetMaxOutputSize(chunk.size()));
+ * size_t n = resampler.Process(chunk.data(), chunk.size(), out.data(), out.size());
+ * @endcode
+ *
+ * Not thread-safe; use one instance per stream. After warm-up Process() does
+ * no heap allocation.
+ */
+class PolyphaseResampler {
+public:
+    /// Largest supported interpolation factor L (number of filter phases)
+    static constexpr size_t kMaxPhases = 1024;
+
+    /**
+     * @brief Build the filter bank for @p input_rate -> @p output_rate
+     *
+     * Check IsValid() afterwards: rates must be positive and reduce to at most
+     * kMaxPhases phases.
+     */
+    PolyphaseResampler(int input_rate, int output_rate);
+
+    /// True if the rates were accepted and the filter bank is ready
+    bool IsValid() const {
+        return valid_;
+    }
+
+    int GetInputRate() const {
+        return input_rate_;
+    }
+
+    int GetOutputRate() const {
+        return output_rate_;
+    }
+
+    /// Interpolation factor L (filter phases)
+    size_t GetNumPhases() const {
+        return up_;
+    }
+
+    /// Decimation factor M
+    size_t GetDecimation() const {
+        return down_;
+    }
+
+    /// Filter taps evaluated per output sample
+    size_t GetTapsPerPhase() const {
+        return taps_;
+    }
+
+    /// Input samples held back by Process() until more input arrives (half the filter)
+    size_t GetLatency() const {
+        return taps_ / 2;
+    }
+
+    /// Upper bound on the samples Process() can return for @p input_size new samples
+    size_t GetMaxOutputSize(size_t input_size) const;
+
+    /**
+     * @brief Resample the next chunk of a stream
+     *
+     * Output stops early if @p output_capacity is reached; unconsumed input
+     * stays buffered and is used by the next call.
+     *
+     * @param input Input samples (may be nullptr if @p input_size is 0)
+     * @param input_size Number of input samples
+     * @param output Output buffer
+     * @param output_capacity Size of @p output
+     * @return Number of samples written to @p output
+     */
+    size_t Process(const float* input, size_t input_size, float* output, size_t output_capacity);
+
+    /**
+     * @brief Emit the samples still held back by the filter delay (end of stream)
+     *
+     * Input past the end is treated as silence. Resets the stream state.
+     *
+     * @return Number of samples written to @p output
+     */
+    size_t Flush(float* output, size_t output_capacity);
+
+    /// Discard buffered input and start a new stream
+    void Reset();
+
+    /**
+     * @brief Resample a complete buffer (Reset(), Process() and Flush() in one call)
+     *
+     * Input beyond either end is treated as silence.
+     * If fewer than @p output_size samples can be produced the rest is zeroed.
+     *
+     * @param input Input samples
+     * @param input_size Number of input samples
+     * @param output Output buffer
+     * @param output_size Number of output samples wanted (typically
+     *                    input_size * output_rate / input_rate)
+     * @return Number of samples computed (before zero fill)
+     */
+    size_t ResampleBuffer(const float* input, size_t input_size, float* output,
+                          size_t output_size);
+
+    /// Dot-product kernel selected at build time ("avx2", "sse2", "neon" or "scalar")
+    static const char* GetKernelName();
+
+private:
+    /// Append @p count samples to the pending buffer (zeros if @p input is nullptr)
+    void Append(const float* input, size_t count);
+
+    /// Produce output from the pending buffer, then drop the consumed samples
+    size_t Drain(float* output, size_t output_capacity);
+
+    int input_rate_ = 0;
+    int output_rate_ = 0;
+    bool valid_ = false;
+    size_t up_ = 1;    ///< Interpolation factor L
+    size_t down_ = 1;  ///< Decimation factor M
+    size_t taps_ = 0;  ///< Taps per phase (multiple of 8)
+
+    std::vector<float> bank_;     ///< up_ rows of taps_ coefficients, time-reversed
+    std::vector<float> pending_;  ///< Input from the current window start onwards
+    size_t phase_ = 0;            ///< Filter phase of the next output sample
+};
+
+}  // namespace ffvoice
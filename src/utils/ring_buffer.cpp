@@ -5,8 +5,35 @@
 
 #include "utils/ring_buffer.h"
 
+#if !defined(__cpp_lib_atomic_wait)
+    #include <chrono>
+    #include <thread>
+#endif
+
 namespace ffvoice {
 
 // Template implementation in header file
 
+namespace detail {
+
+void ParkOnDoorbell(std::atomic<uint32_t>& doorbell, uint32_t seen) {
+#if defined(__cpp_lib_atomic_wait)
+    doorbell.wait(seen, std::memory_order_acquire);
+#else
+    // Standard libraries without atomic wait: fall back to a short poll
+    while (doorbell.load(std::memory_order_acquire) == seen) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+}
+
+void RingDoorbell(std::atomic<uint32_t>& doorbell) {
+    doorbell.fetch_add(1, std::memory_order_release);
+#if defined(__cpp_lib_atomic_wait)
+    doorbell.notify_all();
+#endif
+}
+
+}  // namespace detail
+
 }  // namespace ffvoice
@@ -8,10 +8,54 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace ffvoice {
 
+namespace detail {
+
+/**
+ * @brief Block until @p doorbell no longer holds @p seen.
+ *
+ * Implemented out of line with std::atomic::wait (a futex on Linux) so that
+ * the header stays usable from C++17 translation units.
+ */
+void ParkOnDoorbell(std::atomic<uint32_t>& doorbell, uint32_t seen);
+
+/**
+ * @brief Bump @p doorbell and wake every thread parked on it. Lock-free.
+ */
+void RingDoorbell(std::atomic<uint32_t>& doorbell);
+
+}  // namespace detail
+
+/**
+ * @brief Up to two contiguous regions of ring buffer memory.
+ *
+ * A range of ring slots wraps at most once, so it is described by a first
+ * region starting at the current position and an optional second region
+ * starting at slot 0. Returned by RingBuffer::acquire_write() (P = T) and
+ * RingBuffer::peek_read() (P = const T).
+ */
+template <typename P>
+struct RingSpans {
+    P* first = nullptr;      ///< First contiguous region
+    size_t first_size = 0;   ///< Elements in the first region
+    P* second = nullptr;     ///< Wrapped-around region (nullptr if none)
+    size_t second_size = 0;  ///< Elements in the second region
+
+    /// Total number of elements across both regions.
+    size_t size() const noexcept {
+        return first_size + second_size;
+    }
+
+    /// True when both regions are empty.
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+};
+
 /**
  * @brief Lock-free SPSC ring buffer.
  *
@@ -25,6 +69,18 @@ namespace ffvoice {
  * It is NOT safe for multiple producers or multiple consumers. clear() must
  * only be called while neither the producer nor the consumer thread is running.
  *
+ * Besides the copying push/pop API, the buffer offers a zero-copy API:
+ * acquire_write() / commit_write() let the producer fill ring memory in place,
+ * and peek_read() / consume() let the consumer process samples directly in
+ * ring memory (e.g. run VAD/RMS without an intermediate batch copy).
+ *
+ * Instead of polling, the consumer may park in wait_for_data() until a given
+ * number of elements is stored. The producer checks a single atomic after each
+ * publish and only rings the doorbell while the consumer is parked, so the
+ * real-time side never takes a lock or makes a system call otherwise. That
+ * check costs one full fence per publish, so prefer push_bulk() over push() on
+ * hot paths.
+ *
  * @tparam T element type (use a trivially copyable type on the real-time path)
  */
 template <typename T>
@@ -35,7 +91,10 @@ public:
      * @param capacity Maximum number of elements (clamped to at least 1).
      */
     explicit RingBuffer(size_t capacity)
-        : capacity_(capacity == 0 ? 1 : capacity), buffer_(capacity_) {
+        : capacity_(capacity == 0 ? 1 : capacity),
+          is_pow2_((capacity_ & (capacity_ - 1)) == 0),
+          mask_(capacity_ - 1),
+          buffer_(capacity_) {
     }
 
     RingBuffer(const RingBuffer&) = delete;
@@ -80,8 +139,8 @@ public:
         if (head - tail_.load(std::memory_order_acquire) >= capacity_) {
             return false;  // full
         }
-        buffer_[head % capacity_] = value;
-        head_.store(head + 1, std::memory_order_release);
+        buffer_[slot(head)] = value;
+        publish(head + 1);
         return true;
     }
 
@@ -95,7 +154,7 @@ public:
         if (tail == head_.load(std::memory_order_acquire)) {
             return false;  // empty
         }
-        value = buffer_[tail % capacity_];
+        value = buffer_[slot(tail)];
         tail_.store(tail + 1, std::memory_order_release);
         return true;
     }
@@ -111,10 +170,13 @@ public:
         const size_t head = head_.load(std::memory_order_relaxed);
         const size_t free_space = capacity_ - (head - tail_.load(std::memory_order_acquire));
         const size_t n = std::min(count, free_space);
-        for (size_t i = 0; i < n; ++i) {
-            buffer_[(head + i) % capacity_] = data[i];
-        }
-        head_.store(head + n, std::memory_order_release);
+
+        // At most two contiguous copies: up to the end of storage, then from slot 0.
+        const size_t pos = slot(head);
+        const size_t first = std::min(n, capacity_ - pos);
+        std::copy(data, data + first, buffer_.data() + pos);
+        std::copy(data + first, data + n, buffer_.data());
+        publish(head + n);
         return n;
     }
 
@@ -129,13 +191,105 @@ public:
         const size_t tail = tail_.load(std::memory_order_relaxed);
         const size_t available = head_.load(std::memory_order_acquire) - tail;
         const size_t n = std::min(count, available);
-        for (size_t i = 0; i < n; ++i) {
-            data[i] = buffer_[(tail + i) % capacity_];
-        }
+
+        const size_t pos = slot(tail);
+        const size_t first = std::min(n, capacity_ - pos);
+        std::copy(buffer_.data() + pos, buffer_.data() + pos + first, data);
+        std::copy(buffer_.data(), buffer_.data() + (n - first), data + first);
         tail_.store(tail + n, std::memory_order_release);
         return n;
     }
 
+    /**
+     * @brief Reserve up to @p max_count free slots for in-place writing. Producer thread only.
+     *
+     * The returned regions may be filled directly; nothing becomes visible to
+     * the consumer until commit_write() is called.
+     *
+     * @return Writable regions (total size 0..max_count, limited by free space).
+     */
+    RingSpans<T> acquire_write(size_t max_count) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t free_space = capacity_ - (head - tail_.load(std::memory_order_acquire));
+        return make_spans<T>(buffer_.data(), slot(head), std::min(max_count, free_space));
+    }
+
+    /**
+     * @brief Publish @p count elements written into regions from acquire_write().
+     *
+     * @p count must not exceed the size of the most recent acquire_write() result.
+     */
+    void commit_write(size_t count) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        publish(head + count);
+    }
+
+    /**
+     * @brief Expose up to @p max_count stored elements without copying. Consumer thread only.
+     *
+     * The regions stay valid (the producer will not overwrite them) until
+     * consume() releases them.
+     *
+     * @return Readable regions (total size 0..max_count, limited by stored data).
+     */
+    RingSpans<const T> peek_read(size_t max_count) const noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t available = head_.load(std::memory_order_acquire) - tail;
+        return make_spans<const T>(buffer_.data(), slot(tail), std::min(max_count, available));
+    }
+
+    /**
+     * @brief Release @p count elements previously exposed by peek_read().
+     *
+     * @p count must not exceed the size of the most recent peek_read() result.
+     */
+    void consume(size_t count) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(tail + count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Block until at least @p min_count elements are stored. Consumer thread only.
+     *
+     * @p min_count is clamped to [1, capacity()]. Returns early when another
+     * thread calls wake(), e.g. to shut the consumer down.
+     *
+     * @return true if @p min_count elements are available, false if woken by wake()
+     *         before that.
+     */
+    bool wait_for_data(size_t min_count) {
+        min_count = std::clamp<size_t>(min_count, 1, capacity_);
+        if (size() >= min_count) {
+            return true;
+        }
+
+        // Read the doorbell before arming: a ring between here and the park
+        // changes its value, so ParkOnDoorbell() returns immediately.
+        const uint32_t seen = doorbell_.load(std::memory_order_acquire);
+        wait_threshold_.store(min_count, std::memory_order_seq_cst);
+
+        // Re-check after arming; pairs with the seq_cst store in publish().
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_seq_cst) - tail < min_count &&
+            !wake_pending_.load(std::memory_order_acquire)) {
+            detail::ParkOnDoorbell(doorbell_, seen);
+        }
+        wait_threshold_.store(0, std::memory_order_relaxed);
+        wake_pending_.store(false, std::memory_order_relaxed);
+        return size() >= min_count;
+    }
+
+    /**
+     * @brief Release a consumer parked in wait_for_data(). Any thread.
+     *
+     * If the consumer is not parked, its next wait_for_data() returns
+     * immediately instead, so a shutdown request cannot be lost.
+     */
+    void wake() {
+        wake_pending_.store(true, std::memory_order_release);
+        detail::RingDoorbell(doorbell_);
+    }
+
     /**
      * @brief Reset the buffer to empty.
      *
@@ -148,22 +302,66 @@ public:
     }
 
 private:
+    // Make elements up to new_head visible, then ring the doorbell if the
+    // consumer is parked waiting for at least that many. The seq_cst store and
+    // load order against the consumer's arm-then-recheck in wait_for_data().
+    void publish(size_t new_head) {
+        head_.store(new_head, std::memory_order_seq_cst);
+        size_t want = wait_threshold_.load(std::memory_order_seq_cst);
+        if (want != 0 && new_head - tail_.load(std::memory_order_acquire) >= want &&
+            wait_threshold_.compare_exchange_strong(want, 0, std::memory_order_acq_rel)) {
+            detail::RingDoorbell(doorbell_);
+        }
+    }
+
     // Cache line size used to keep the producer and consumer counters apart.
     // 128 bytes covers Apple Silicon (128-byte lines) and x86-64 (64-byte lines).
     static constexpr size_t kCacheLine = 128;
 
+    // Map a monotonic counter to a storage slot. Power-of-two capacities use a
+    // mask; other capacities fall back to modulo. The branch is constant for
+    // the lifetime of the buffer, so it predicts perfectly.
+    size_t slot(size_t index) const noexcept {
+        return is_pow2_ ? (index & mask_) : (index % capacity_);
+    }
+
+    // Split n elements starting at storage slot pos into at most two regions.
+    template <typename P, typename Base>
+    RingSpans<P> make_spans(Base* base, size_t pos, size_t n) const noexcept {
+        RingSpans<P> spans;
+        if (n == 0) {
+            return spans;
+        }
+        spans.first = base + pos;
+        spans.first_size = std::min(n, capacity_ - pos);
+        if (n > spans.first_size) {
+            spans.second = base;
+            spans.second_size = n - spans.first_size;
+        }
+        return spans;
+    }
+
     // head_ and tail_ are monotonically increasing counters; the number of live
-    // elements is (head_ - tail_). Slots are addressed by (index % capacity_),
-    // so any capacity is supported, not only powers of two. The counters would
-    // only wrap after 2^64 operations, which is unreachable in practice.
+    // elements is (head_ - tail_). Slots are addressed by slot(index), so any
+    // capacity is supported; powers of two are cheaper. The counters would only
+    // wrap after 2^64 operations, which is unreachable in practice.
     //
     // head_ and tail_ are placed on separate cache lines: the producer only
     // writes head_ and the consumer only writes tail_, so sharing a line would
     // cause false sharing and ping-pong the line between the two cores.
+    //
+    // wait_threshold_ is non-zero only while the consumer is parked; the
+    // producer reads it on every publish, so it shares a line with doorbell_
+    // rather than with either counter.
     const size_t capacity_;
+    const bool is_pow2_;  // capacity_ is a power of two: slots are (index & mask_)
+    const size_t mask_;   // capacity_ - 1
     std::vector<T> buffer_;
     alignas(kCacheLine) std::atomic<size_t> head_{0};  // elements ever pushed (producer writes)
     alignas(kCacheLine) std::atomic<size_t> tail_{0};  // elements ever popped (consumer writes)
+    alignas(kCacheLine) std::atomic<size_t> wait_threshold_{0};  // elements a parked consumer needs
+    std::atomic<uint32_t> doorbell_{0};                          // bumped to wake the consumer
+    std::atomic<bool> wake_pending_{false};                      // set by wake(), cleared by waiter
 };
 
 }  // namespace ffvoice
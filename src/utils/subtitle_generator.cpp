@@ -5,11 +5,11 @@
 
 #include "utils/subtitle_generator.h"
 
+#include "audio/live_captioner.h"
 #include "utils/logger.h"
 
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
-#include <sstream>
 
 namespace ffvoice {
 
@@ -19,19 +19,18 @@ std::string SubtitleGenerator::GenerateString(const std::vector<TranscriptionSeg
         return {};
     }
 
-    switch (format) {
-        case Format::PlainText:
-            return GeneratePlainText(segments);
-        case Format::SRT:
-            return GenerateSRT(segments);
-        case Format::VTT:
-            return GenerateVTT(segments);
-        case Format::JSON:
-            return GenerateJSON(segments);
-        default:
-            LOG_ERROR("Unknown subtitle format");
-            return {};
+    if (!IsKnownFormat(format)) {
+        LOG_ERROR("Unknown subtitle format");
+        return {};
     }
+
+    std::string out;
+    AppendHeader(out, format);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        AppendSegment(out, segments[i], format, i);
+    }
+    AppendFooter(out, format, segments.size());
+    return out;
 }
 
 bool SubtitleGenerator::Generate(const std::vector<TranscriptionSegment>& segments,
@@ -63,97 +62,36 @@ bool SubtitleGenerator::Generate(const std::vector<TranscriptionSegment>& segmen
     return true;
 }
 
-std::string SubtitleGenerator::FormatTimeSRT(int64_t ms) {
-    // SRT format: HH:MM:SS,mmm
-    int hours = ms / 3600000;
-    int minutes = (ms % 3600000) / 60000;
-    int seconds = (ms % 60000) / 1000;
-    int milliseconds = ms % 1000;
-
-    std::ostringstream oss;
-    oss << std::setfill('0') << std::setw(2) << hours << ":" << std::setw(2) << minutes << ":"
-        << std::setw(2) << seconds << "," << std::setw(3) << milliseconds;
-
-    return oss.str();
-}
-
-std::string SubtitleGenerator::FormatTimeVTT(int64_t ms) {
-    // VTT format: HH:MM:SS.mmm
+void SubtitleGenerator::AppendTime(std::string& out, int64_t ms, char fraction_separator) {
+    // SRT: HH:MM:SS,mmm   VTT: HH:MM:SS.mmm
     int hours = ms / 3600000;
     int minutes = (ms % 3600000) / 60000;
     int seconds = (ms % 60000) / 1000;
     int milliseconds = ms % 1000;
 
-    std::ostringstream oss;
-    oss << std::setfill('0') << std::setw(2) << hours << ":" << std::setw(2) << minutes << ":"
-        << std::setw(2) << seconds << "." << std::setw(3) << milliseconds;
-
-    return oss.str();
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), "%02d:%02d:%02d%c%03d", hours, minutes, seconds,
+                                fraction_separator, milliseconds);
+    out.append(buf, static_cast<size_t>(n));
 }
 
-std::string
-SubtitleGenerator::GeneratePlainText(const std::vector<TranscriptionSegment>& segments) {
-    std::ostringstream oss;
-
-    for (const auto& segment : segments) {
-        oss << segment.text << "\n";
-    }
-
-    return oss.str();
-}
-
-std::string SubtitleGenerator::GenerateSRT(const std::vector<TranscriptionSegment>& segments) {
-    std::ostringstream oss;
-
-    for (size_t i = 0; i < segments.size(); ++i) {
-        const auto& segment = segments[i];
-
-        // Sequence number (1-indexed)
-        oss << (i + 1) << "\n";
-
-        // Timestamp: start --> end
-        oss << FormatTimeSRT(segment.start_ms) << " --> " << FormatTimeSRT(segment.end_ms) << "\n";
-
-        // Text content
-        oss << segment.text << "\n";
-
-        // Blank line separator (except after last segment)
-        if (i < segments.size() - 1) {
-            oss << "\n";
-        }
-    }
+namespace {
 
-    return oss.str();
+void AppendInt(std::string& out, int64_t value) {
+    char buf[24];
+    const int n = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    out.append(buf, static_cast<size_t>(n));
 }
 
-std::string SubtitleGenerator::GenerateVTT(const std::vector<TranscriptionSegment>& segments) {
-    std::ostringstream oss;
-
-    // VTT header
-    oss << "WEBVTT\n\n";
-
-    for (size_t i = 0; i < segments.size(); ++i) {
-        const auto& segment = segments[i];
-
-        // Timestamp: start --> end
-        oss << FormatTimeVTT(segment.start_ms) << " --> " << FormatTimeVTT(segment.end_ms) << "\n";
-
-        // Text content
-        oss << segment.text << "\n";
-
-        // Blank line separator (except after last segment)
-        if (i < segments.size() - 1) {
-            oss << "\n";
-        }
-    }
-
-    return oss.str();
+/// Fixed-point with 2 decimals, for confidence/probability floats
+void AppendFixed2(std::string& out, float value) {
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), "%.2f", static_cast<double>(value));
+    out.append(buf, static_cast<size_t>(n));
 }
 
-namespace {
-
 /**
- * @brief Escape a string for safe embedding as a JSON string value
+ * @brief Append a string escaped for safe embedding as a JSON string value
  *
  * Handles the characters that would otherwise produce invalid JSON:
  *   "  -> \"      backslash -> \\      newline -> \n
@@ -161,95 +99,244 @@ namespace {
  * Other control characters (0x00-0x1F) are emitted as \u00XX escapes so the
  * output is always valid JSON regardless of what the ASR produced.
  *
+ * @param out Buffer to append to (without surrounding quotes)
  * @param input Raw string (e.g. transcribed text)
- * @return Escaped string (without surrounding quotes)
  */
-std::string EscapeJSON(const std::string& input) {
-    std::ostringstream oss;
-
+void AppendEscapedJSON(std::string& out, const std::string& input) {
     for (unsigned char c : input) {
         switch (c) {
             case '"':
-                oss << "\\\"";
+                out += "\\\"";
                 break;
             case '\\':
-                oss << "\\\\";
+                out += "\\\\";
                 break;
             case '\n':
-                oss << "\\n";
+                out += "\\n";
                 break;
             case '\r':
-                oss << "\\r";
+                out += "\\r";
                 break;
             case '\t':
-                oss << "\\t";
+                out += "\\t";
                 break;
             default:
                 if (c < 0x20) {
                     // Other control characters -> \u00XX
-                    oss << "\\u" << std::hex << std::setfill('0') << std::setw(4)
-                        << static_cast<int>(c) << std::dec;
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out += buf;
                 } else {
-                    oss << c;
+                    out += static_cast<char>(c);
                 }
                 break;
         }
     }
-
-    return oss.str();
 }
 
 }  // namespace
 
-std::string SubtitleGenerator::GenerateJSON(const std::vector<TranscriptionSegment>& segments) {
-    std::ostringstream oss;
-
-    // Use fixed-point notation with 2 decimals for confidence/probability floats.
-    oss << std::fixed << std::setprecision(2);
+bool SubtitleGenerator::IsKnownFormat(Format format) {
+    switch (format) {
+        case Format::PlainText:
+        case Format::SRT:
+        case Format::VTT:
+        case Format::JSON:
+            return true;
+        default:
+            return false;
+    }
+}
 
-    oss << "{\n";
-    oss << "  \"segments\": [";
-    if (!segments.empty()) {
-        oss << "\n";
+void SubtitleGenerator::AppendHeader(std::string& out, Format format) {
+    if (format == Format::VTT) {
+        out += "WEBVTT\n\n";
+    } else if (format == Format::JSON) {
+        out += "{\n";
+        out += "  \"segments\": [";
     }
+}
 
-    for (size_t i = 0; i < segments.size(); ++i) {
-        const auto& segment = segments[i];
-
-        oss << "    {\n";
-        oss << "      \"start_ms\": " << segment.start_ms << ",\n";
-        oss << "      \"end_ms\": " << segment.end_ms << ",\n";
-        oss << "      \"confidence\": " << segment.confidence << ",\n";
-        oss << "      \"speaker_id\": " << segment.speaker_id << ",\n";
-        oss << "      \"text\": \"" << EscapeJSON(segment.text) << "\",\n";
-
-        // Per-word timestamps (empty array when no word data is available).
-        if (segment.words.empty()) {
-            oss << "      \"words\": []\n";
-        } else {
-            oss << "      \"words\": [\n";
-            for (size_t w = 0; w < segment.words.size(); ++w) {
-                const auto& word = segment.words[w];
-
-                oss << "        { \"start_ms\": " << word.start_ms
-                    << ", \"end_ms\": " << word.end_ms << ", \"text\": \"" << EscapeJSON(word.text)
-                    << "\", \"probability\": " << word.probability << " }";
-                oss << (w < segment.words.size() - 1 ? ",\n" : "\n");
+void SubtitleGenerator::AppendSegment(std::string& out, const TranscriptionSegment& segment,
+                                      Format format, size_t index) {
+    switch (format) {
+        case Format::PlainText:
+            out += segment.text;
+            out += '\n';
+            break;
+
+        case Format::SRT:
+            // Blank line separator between segments
+            if (index > 0) {
+                out += '\n';
+            }
+            // Sequence number (1-indexed)
+            AppendInt(out, static_cast<int64_t>(index + 1));
+            out += '\n';
+            AppendTime(out, segment.start_ms, ',');
+            out += " --> ";
+            AppendTime(out, segment.end_ms, ',');
+            out += '\n';
+            out += segment.text;
+            out += '\n';
+            break;
+
+        case Format::VTT:
+            if (index > 0) {
+                out += '\n';
             }
-            oss << "      ]\n";
+            AppendTime(out, segment.start_ms, '.');
+            out += " --> ";
+            AppendTime(out, segment.end_ms, '.');
+            out += '\n';
+            out += segment.text;
+            out += '\n';
+            break;
+
+        case Format::JSON: {
+            out += index > 0 ? ",\n" : "\n";
+            out += "    {\n";
+            out += "      \"start_ms\": ";
+            AppendInt(out, segment.start_ms);
+            out += ",\n      \"end_ms\": ";
+            AppendInt(out, segment.end_ms);
+            out += ",\n      \"confidence\": ";
+            AppendFixed2(out, segment.confidence);
+            out += ",\n      \"speaker_id\": ";
+            AppendInt(out, segment.speaker_id);
+            out += ",\n      \"text\": \"";
+            AppendEscapedJSON(out, segment.text);
+            out += "\",\n";
+
+            // Per-word timestamps (empty array when no word data is available).
+            if (segment.words.empty()) {
+                out += "      \"words\": []\n";
+            } else {
+                out += "      \"words\": [\n";
+                for (size_t w = 0; w < segment.words.size(); ++w) {
+                    const auto& word = segment.words[w];
+
+                    out += "        { \"start_ms\": ";
+                    AppendInt(out, word.start_ms);
+                    out += ", \"end_ms\": ";
+                    AppendInt(out, word.end_ms);
+                    out += ", \"text\": \"";
+                    AppendEscapedJSON(out, word.text);
+                    out += "\", \"probability\": ";
+                    AppendFixed2(out, word.probability);
+                    out += " }";
+                    out += w < segment.words.size() - 1 ? ",\n" : "\n";
+                }
+                out += "      ]\n";
+            }
+
+            out += "    }";
+            break;
+        }
+    }
+}
+
+void SubtitleGenerator::AppendFooter(std::string& out, Format format, size_t num_segments) {
+    if (format == Format::JSON) {
+        if (num_segments > 0) {
+            out += "\n  ";
         }
+        out += "]\n";
+        out += "}\n";
+    }
+}
+
+// ============================================================================
+// SubtitleWriter
+// ============================================================================
+
+SubtitleWriter::~SubtitleWriter() {
+    Close();
+}
+
+bool SubtitleWriter::Open(const std::string& output_file, SubtitleGenerator::Format format) {
+    Close();
 
-        oss << "    }";
-        oss << (i < segments.size() - 1 ? ",\n" : "\n");
+    // Binary mode for the same reason as SubtitleGenerator::Generate()
+    file_.open(output_file, std::ios::binary);
+    if (!file_.is_open()) {
+        LOG_ERROR("Failed to open output file: %s", output_file.c_str());
+        return false;
+    }
+    return Open(file_, format);
+}
+
+bool SubtitleWriter::Open(std::ostream& out, SubtitleGenerator::Format format) {
+    if (&out != &file_) {
+        Close();
+    }
+    if (!SubtitleGenerator::IsKnownFormat(format)) {
+        LOG_ERROR("Unknown subtitle format");
+        return false;
+    }
+
+    out_ = &out;
+    format_ = format;
+    count_ = 0;
+    buffer_.clear();
+    SubtitleGenerator::AppendHeader(buffer_, format_);
+    return Flush();
+}
+
+bool SubtitleWriter::Write(const std::vector<TranscriptionSegment>& segments) {
+    if (!out_) {
+        return false;
+    }
+    buffer_.clear();
+    for (const auto& segment : segments) {
+        SubtitleGenerator::AppendSegment(buffer_, segment, format_, count_++);
     }
+    return Flush();
+}
 
-    if (!segments.empty()) {
-        oss << "  ";
+bool SubtitleWriter::WriteSegment(const TranscriptionSegment& segment) {
+    if (!out_) {
+        return false;
     }
-    oss << "]\n";
-    oss << "}\n";
+    buffer_.clear();
+    SubtitleGenerator::AppendSegment(buffer_, segment, format_, count_++);
+    return Flush();
+}
 
-    return oss.str();
+bool SubtitleWriter::WriteCaption(const CaptionEvent& event) {
+    if (!out_) {
+        return false;
+    }
+    if (event.type != CaptionEventType::Final || event.text.empty()) {
+        return true;
+    }
+    cue_.start_ms = event.utterance_start_ms;
+    cue_.end_ms = event.utterance_end_ms;
+    cue_.text = event.text;  // Assignment reuses cue_.text's capacity
+    cue_.confidence = event.confidence;
+    cue_.speaker_id = event.speaker_id;
+    return WriteSegment(cue_);
+}
+
+bool SubtitleWriter::Flush() {
+    out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    // Flush per write so readers of the file see each chunk or cue as it completes
+    out_->flush();
+    return out_->good();
+}
+
+bool SubtitleWriter::Close() {
+    if (!out_) {
+        return true;
+    }
+    buffer_.clear();
+    SubtitleGenerator::AppendFooter(buffer_, format_, count_);
+    const bool ok = Flush();
+    out_ = nullptr;
+    if (file_.is_open()) {
+        file_.close();
+    }
+    return ok;
 }
 
 }  // namespace ffvoice
@@ -12,11 +12,16 @@
 
 #include "audio/whisper_processor.h"
 
+#include <cstddef>
+#include <fstream>
+#include <ostream>
 #include <string>
 #include <vector>
 
 namespace ffvoice {
 
+struct CaptionEvent;
+
 /**
  * @brief Subtitle and transcript generator
  *
@@ -79,47 +84,147 @@ public:
                                       Format format);
 
 private:
+    // The Append* helpers format into a caller-owned string so a reused buffer
+    // (see SubtitleWriter) costs no allocation per segment once it has grown.
+
     /**
-     * @brief Format timestamp for SRT format (HH:MM:SS,mmm)
+     * @brief Append a timestamp as HH:MM:SS,mmm (SRT) or HH:MM:SS.mmm (VTT)
+     * @param out Buffer to append to
      * @param ms Timestamp in milliseconds
-     * @return Formatted timestamp string
+     * @param fraction_separator ',' for SRT, '.' for VTT
      */
-    static std::string FormatTimeSRT(int64_t ms);
+    static void AppendTime(std::string& out, int64_t ms, char fraction_separator);
+
+    /// True for the formats listed in Format
+    static bool IsKnownFormat(Format format);
 
     /**
-     * @brief Format timestamp for VTT format (HH:MM:SS.mmm)
-     * @param ms Timestamp in milliseconds
-     * @return Formatted timestamp string
+     * @brief Append what precedes the first segment (VTT header, JSON opening)
+     * @param out Buffer to append to
+     * @param format Output format
+     */
+    static void AppendHeader(std::string& out, Format format);
+
+    /**
+     * @brief Append one segment, including its separator from the previous one
+     * @param out Buffer to append to
+     * @param segment Segment to write
+     * @param format Output format
+     * @param index 0-based position of the segment in the output
+     */
+    static void AppendSegment(std::string& out, const TranscriptionSegment& segment,
+                              Format format, size_t index);
+
+    /**
+     * @brief Append what follows the last segment (JSON closing)
+     * @param out Buffer to append to
+     * @param format Output format
+     * @param num_segments Number of segments written
+     */
+    static void AppendFooter(std::string& out, Format format, size_t num_segments);
+
+    friend class SubtitleWriter;
+};
+
+/**
+ * @brief Incremental subtitle/transcript writer
+ *
+ * Writes segments as they become available (e.g. from ChunkedTranscriber,
+ * or LiveCaptioner Final events) instead of all at the end, so a long session
+ * never holds its whole transcript in memory. Once closed, the output is
+ * identical to SubtitleGenerator::GenerateString() of all the segments
+ * written; before that the file holds every cue so far, and Close() adds the
+ * JSON closing brackets.
+ *
+ * Cues are formatted into one reused buffer, so after the first few writes
+ * appending a cue does no heap allocation. Not thread-safe: call from one
+ * thread at a time (a LiveCaptioner callback always runs on its worker).
+ *
+ * @code
+ * SubtitleWriter writer;
+ * writer.Open("output.srt", SubtitleGenerator::Format::SRT);
+ * writer.Write(first_batch);
+ * writer.Write(second_batch);
+ * writer.Close();
+ *
+ * // Live: one cue per finalized utterance
+ * captioner.SetCallback([&](const CaptionEvent& ev) { writer.WriteCaption(ev); });
+ * @endcode
+ */
+class SubtitleWriter {
+public:
+    SubtitleWriter() = default;
+    ~SubtitleWriter();
+
+    SubtitleWriter(const SubtitleWriter&) = delete;
+    SubtitleWriter& operator=(const SubtitleWriter&) = delete;
+
+    /**
+     * @brief Create @p output_file and write the format header
+     * @param output_file Output file path
+     * @param format Output format
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& output_file, SubtitleGenerator::Format format);
+
+    /**
+     * @brief Write to a caller-owned stream (e.g. std::cout) instead of a file
+     * @param out Output stream (must outlive the writer or Close())
+     * @param format Output format
+     * @return true if successful, false otherwise
      */
-    static std::string FormatTimeVTT(int64_t ms);
+    bool Open(std::ostream& out, SubtitleGenerator::Format format);
 
     /**
-     * @brief Generate plain text output
-     * @param segments Transcription segments
-     * @return Formatted text string
+     * @brief Append segments and flush them
+     * @param segments Segments in output order
+     * @return true if successful, false otherwise (or if not open)
      */
-    static std::string GeneratePlainText(const std::vector<TranscriptionSegment>& segments);
+    bool Write(const std::vector<TranscriptionSegment>& segments);
 
     /**
-     * @brief Generate SRT format output
-     * @param segments Transcription segments
-     * @return Formatted SRT string
+     * @brief Append one segment and flush it
+     * @param segment Next segment in output order
+     * @return true if successful, false otherwise (or if not open)
      */
-    static std::string GenerateSRT(const std::vector<TranscriptionSegment>& segments);
+    bool WriteSegment(const TranscriptionSegment& segment);
 
     /**
-     * @brief Generate VTT format output
-     * @param segments Transcription segments
-     * @return Formatted VTT string
+     * @brief Append a LiveCaptioner Final event as a cue and flush it
+     *
+     * Partial events and Finals with empty text are skipped (returning true),
+     * so the callback can forward every event unfiltered.
+     *
+     * @param event Caption event
+     * @return true if successful or skipped, false on a write error (or if not open)
      */
-    static std::string GenerateVTT(const std::vector<TranscriptionSegment>& segments);
+    bool WriteCaption(const CaptionEvent& event);
 
     /**
-     * @brief Generate JSON output with per-segment and per-word timestamps
-     * @param segments Transcription segments
-     * @return Formatted JSON string
+     * @brief Write the format footer and close the file
+     * @return true if everything was written successfully
      */
-    static std::string GenerateJSON(const std::vector<TranscriptionSegment>& segments);
+    bool Close();
+
+    bool IsOpen() const {
+        return out_ != nullptr;
+    }
+
+    /// Segments written since Open()
+    size_t GetSegmentCount() const {
+        return count_;
+    }
+
+private:
+    /// Write buffer_ to the stream and flush it
+    bool Flush();
+
+    std::ofstream file_;
+    std::ostream* out_ = nullptr;  ///< file_ or the caller's stream
+    SubtitleGenerator::Format format_ = SubtitleGenerator::Format::PlainText;
+    size_t count_ = 0;
+    std::string buffer_;        ///< Formatting buffer; cleared, never shrunk
+    TranscriptionSegment cue_;  ///< Reused to turn caption events into segments
 };
 
 }  // namespace ffvoice
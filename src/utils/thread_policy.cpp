@@ -0,0 +1,361 @@
+/**
+ * @file thread_policy.cpp
+ * @brief ThreadPolicy implementation (Linux, macOS and Windows back-ends)
+ */
+
+#include "utils/thread_policy.h"
+
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <avrt.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+    #include <mach/mach_time.h>
+    #include <mach/thread_policy.h>
+    #include <pthread.h>
+    #include <pthread/qos.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace ffvoice {
+
+namespace {
+
+std::mutex g_applied_mutex;
+std::vector<AppliedThreadPolicy> g_applied;
+
+void AppendError(std::string& error, const std::string& message) {
+    if (!error.empty()) {
+        error += "; ";
+    }
+    error += message;
+}
+
+std::string FormatCpus(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!out.empty()) {
+            out += ",";
+        }
+        out += std::to_string(cpus[i]);
+        if (j > i) {
+            out += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return out;
+}
+
+/// Pin the calling thread; on success @p applied.cpus lists the cores used
+void ApplyAffinity(std::vector<int> cpus, AppliedThreadPolicy& applied) {
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    const int num_cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                              [num_cpus](int cpu) { return cpu < 0 || cpu >= num_cpus; }),
+               cpus.end());
+    if (cpus.empty()) {
+        AppendError(applied.error, "no requested core exists on this machine");
+        return;
+    }
+
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= DWORD_PTR{1} << cpu;
+        }
+    }
+    if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        AppendError(applied.error,
+                    "SetThreadAffinityMask failed (error " + std::to_string(GetLastError()) + ")");
+        return;
+    }
+    applied.cpus = cpus;
+#elif defined(__APPLE__)
+    // macOS has no hard pinning; affinity tags are only hints between threads
+    AppendError(applied.error, "CPU pinning is not supported on macOS");
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        AppendError(applied.error, std::string("pthread_setaffinity_np: ") + std::strerror(rc));
+        return;
+    }
+    applied.cpus = cpus;
+#endif
+}
+
+#if defined(_WIN32)
+
+bool SetPriority(ThreadPriority priority, const ThreadPolicy&, AppliedThreadPolicy& applied) {
+    if (priority == ThreadPriority::RealTime) {
+        // MMCSS boosts the thread while keeping the system responsive
+        DWORD task_index = 0;
+        HANDLE task = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task_index);
+        if (task != nullptr) {
+            AvSetMmThreadPriority(task, AVRT_PRIORITY_HIGH);
+            applied.mechanism = "MMCSS Pro Audio";
+            return true;
+        }
+        AppendError(applied.error, "MMCSS registration failed (error " +
+                                       std::to_string(GetLastError()) + ")");
+        if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+            applied.mechanism = "THREAD_PRIORITY_TIME_CRITICAL";
+            return true;
+        }
+        return false;
+    }
+
+    const int value = priority == ThreadPriority::High ? THREAD_PRIORITY_HIGHEST
+                                                       : THREAD_PRIORITY_BELOW_NORMAL;
+    if (!SetThreadPriority(GetCurrentThread(), value)) {
+        AppendError(applied.error,
+                    "SetThreadPriority failed (error " + std::to_string(GetLastError()) + ")");
+        return false;
+    }
+    applied.mechanism = priority == ThreadPriority::High ? "THREAD_PRIORITY_HIGHEST"
+                                                         : "THREAD_PRIORITY_BELOW_NORMAL";
+    return true;
+}
+
+#elif defined(__APPLE__)
+
+bool SetPriority(ThreadPriority priority, const ThreadPolicy&, AppliedThreadPolicy& applied) {
+    if (priority == ThreadPriority::RealTime) {
+        // Same shape Core Audio uses for its I/O threads: a 10 ms period
+        // needing at most 2.5 ms of CPU within 5 ms
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        const double ticks_per_ms = 1e6 * timebase.denom / timebase.numer;
+        thread_time_constraint_policy_data_t policy;
+        policy.period = static_cast<uint32_t>(10.0 * ticks_per_ms);
+        policy.computation = static_cast<uint32_t>(2.5 * ticks_per_ms);
+        policy.constraint = static_cast<uint32_t>(5.0 * ticks_per_ms);
+        policy.preemptible = 1;
+        const kern_return_t kr = thread_policy_set(
+            pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+            reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+        if (kr == KERN_SUCCESS) {
+            applied.mechanism = "time-constraint policy";
+            return true;
+        }
+        AppendError(applied.error, "thread_policy_set failed (" + std::to_string(kr) + ")");
+        priority = ThreadPriority::High;
+    }
+
+    const qos_class_t qos =
+        priority == ThreadPriority::High ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_UTILITY;
+    const int rc = pthread_set_qos_class_self_np(qos, 0);
+    if (rc != 0) {
+        AppendError(applied.error, std::string("pthread_set_qos_class_self_np: ") +
+                                       std::strerror(rc));
+        return false;
+    }
+    applied.mechanism =
+        priority == ThreadPriority::High ? "QoS user-interactive" : "QoS utility";
+    applied.priority = priority;
+    return true;
+}
+
+#else
+
+bool SetNice(int nice_value, AppliedThreadPolicy& applied) {
+    // Linux applies a thread id's nice value to that thread only
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, nice_value) != 0) {
+        AppendError(applied.error, "setpriority(" + std::to_string(nice_value) +
+                                       "): " + std::strerror(errno));
+        return false;
+    }
+    applied.mechanism = "nice " + std::to_string(nice_value);
+    return true;
+}
+
+bool SetPriority(ThreadPriority priority, const ThreadPolicy& policy,
+                 AppliedThreadPolicy& applied) {
+    if (priority == ThreadPriority::RealTime) {
+        sched_param param{};
+        param.sched_priority =
+            std::clamp(policy.realtime_priority, sched_get_priority_min(SCHED_FIFO),
+                       sched_get_priority_max(SCHED_FIFO));
+        const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc == 0) {
+            applied.mechanism = "SCHED_FIFO " + std::to_string(param.sched_priority);
+            return true;
+        }
+        AppendError(applied.error,
+                    std::string("SCHED_FIFO: ") + std::strerror(rc) +
+                        (rc == EPERM ? " (needs CAP_SYS_NICE or an rtprio limit)" : ""));
+        if (!SetNice(-10, applied)) {
+            return false;
+        }
+        applied.priority = ThreadPriority::High;
+        return true;
+    }
+    return SetNice(priority == ThreadPriority::High ? -10 : 10, applied);
+}
+
+#endif
+
+}  // namespace
+
+AppliedThreadPolicy ApplyThreadPolicy(const ThreadPolicy& policy,
+                                      const std::string& thread_name) {
+    AppliedThreadPolicy applied;
+    applied.thread_name = thread_name;
+    if (policy.IsDefault()) {
+        return applied;
+    }
+
+    if (!policy.cpus.empty()) {
+        ApplyAffinity(policy.cpus, applied);
+    }
+    if (policy.priority != ThreadPriority::Default) {
+        applied.priority = policy.priority;
+        if (!SetPriority(policy.priority, policy, applied)) {
+            applied.priority = ThreadPriority::Default;
+        }
+    }
+
+    const std::string summary = FormatAppliedThreadPolicy(applied);
+    if (applied.error.empty()) {
+        LOG_INFO("Thread policy: %s", summary.c_str());
+    } else {
+        LOG_WARNING("Thread policy: %s", summary.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(g_applied_mutex);
+    auto it = std::find_if(g_applied.begin(), g_applied.end(), [&](const auto& entry) {
+        return entry.thread_name == thread_name;
+    });
+    if (it != g_applied.end()) {
+        *it = applied;
+    } else {
+        g_applied.push_back(applied);
+    }
+    return applied;
+}
+
+std::vector<AppliedThreadPolicy> GetAppliedThreadPolicies() {
+    std::lock_guard<std::mutex> lock(g_applied_mutex);
+    return g_applied;
+}
+
+void ClearAppliedThreadPolicies() {
+    std::lock_guard<std::mutex> lock(g_applied_mutex);
+    g_applied.clear();
+}
+
+std::string FormatAppliedThreadPolicy(const AppliedThreadPolicy& applied) {
+    std::string out = applied.thread_name + ": " + ThreadPriorityName(applied.priority);
+    if (!applied.mechanism.empty()) {
+        out += " (" + applied.mechanism + ")";
+    }
+    out += applied.cpus.empty() ? ", any cpu" : ", cpus " + FormatCpus(applied.cpus);
+    if (!applied.error.empty()) {
+        out += " [" + applied.error + "]";
+    }
+    return out;
+}
+
+const char* ThreadPriorityName(ThreadPriority priority) {
+    switch (priority) {
+        case ThreadPriority::Background:
+            return "background";
+        case ThreadPriority::High:
+            return "high";
+        case ThreadPriority::RealTime:
+            return "realtime";
+        case ThreadPriority::Default:
+        default:
+            return "default";
+    }
+}
+
+bool ParseCpuList(const std::string& text, std::vector<int>& cpus) {
+    std::vector<int> parsed;
+    const char* p = text.c_str();
+    // A core number: digits only, so "-" can only ever be a range separator
+    const auto parse_cpu = [&p](long& out) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        char* end = nullptr;
+        out = std::strtol(p, &end, 10);
+        p = end;
+        return out <= 4095;
+    };
+    while (true) {
+        long first = 0;
+        long last = 0;
+        if (!parse_cpu(first)) {
+            return false;
+        }
+        last = first;
+        if (*p == '-') {
+            ++p;
+            if (!parse_cpu(last) || last < first) {
+                return false;
+            }
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            parsed.push_back(static_cast<int>(cpu));
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (*p++ != ',') {
+            return false;
+        }
+    }
+    cpus = std::move(parsed);
+    return true;
+}
+
+std::vector<int> CpusExcept(const std::vector<int>& excluded) {
+    std::vector<int> cpus;
+    const int num_cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < num_cpus; ++cpu) {
+        if (std::find(excluded.begin(), excluded.end(), cpu) == excluded.end()) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+int CpuBudget(const ThreadPolicy& policy) {
+    if (!policy.cpus.empty()) {
+        return static_cast<int>(policy.cpus.size());
+    }
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+}  // namespace ffvoice
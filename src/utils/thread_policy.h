@@ -0,0 +1,119 @@
+/**
+ * @file thread_policy.h
+ * @brief Scheduling priority and CPU pinning for the engine's threads
+ *
+ * Capture callbacks, the captioner's worker and inference threads, file
+ * writers and Whisper's compute threads otherwise all run at default
+ * priority on any core, so under load inference can preempt the capture
+ * thread into input overflows. A ThreadPolicy raises the capture thread
+ * (SCHED_FIFO on Linux, a time-constraint policy on macOS, MMCSS "Pro Audio"
+ * on Windows) and keeps the inference pool off its core.
+ *
+ * @code
+ * ThreadPolicy capture;
+ * capture.priority = ThreadPriority::RealTime;
+ * capture.cpus = {0};
+ * device.SetThreadPolicy(capture);
+ *
+ * LiveCaptionerConfig cfg;
+ * cfg.thread_policy.cpus = CpusExcept({0});  // Whisper stays off the capture core
+ * ...
+ * for (const auto& applied : GetAppliedThreadPolicies()) {
+ *     LOG_INFO("%s", FormatAppliedThreadPolicy(applied).c_str());
+ * }
+ * @endcode
+ *
+ * Threads started from a pinned or raised thread inherit its policy on Linux
+ * (affinity and, with the default attributes, scheduling class), which is how
+ * whisper.cpp's per-call compute threads pick up the inference policy. On
+ * Windows and macOS only the calling thread is affected.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ffvoice {
+
+enum class ThreadPriority {
+    Default,     ///< Leave the thread as created
+    Background,  ///< Below normal (nice 10, QoS utility, THREAD_PRIORITY_BELOW_NORMAL)
+    High,        ///< Above normal (nice -10, QoS user-interactive, THREAD_PRIORITY_HIGHEST)
+    RealTime     ///< SCHED_FIFO, time-constraint policy or MMCSS; falls back to High
+};
+
+/**
+ * @brief Requested scheduling for one kind of thread.
+ */
+struct ThreadPolicy {
+    ThreadPriority priority = ThreadPriority::Default;
+
+    /// SCHED_FIFO priority for RealTime on Linux (clamped to the valid range)
+    int realtime_priority = 70;
+
+    /// Cores the thread may run on; empty = any core
+    std::vector<int> cpus;
+
+    bool IsDefault() const {
+        return priority == ThreadPriority::Default && cpus.empty();
+    }
+};
+
+/**
+ * @brief What ApplyThreadPolicy() actually achieved on one thread.
+ */
+struct AppliedThreadPolicy {
+    std::string thread_name;
+
+    /// Priority in effect afterwards (lower than requested if the request failed)
+    ThreadPriority priority = ThreadPriority::Default;
+
+    /// How the priority was set, e.g. "SCHED_FIFO 70" or "MMCSS Pro Audio"
+    std::string mechanism;
+
+    /// Cores the thread is pinned to; empty = not pinned
+    std::vector<int> cpus;
+
+    /// Why part of the request was not applied (empty if all of it was)
+    std::string error;
+};
+
+/**
+ * @brief Apply @p policy to the calling thread
+ *
+ * Never fails hard: whatever the OS refuses (typically real-time priority
+ * without CAP_SYS_NICE or an rtprio limit) is logged once and described in
+ * the result's error. Non-default results are also recorded for
+ * GetAppliedThreadPolicies().
+ *
+ * @param thread_name Label for logs and GetAppliedThreadPolicies()
+ */
+AppliedThreadPolicy ApplyThreadPolicy(const ThreadPolicy& policy, const std::string& thread_name);
+
+/// Latest result per thread name from ApplyThreadPolicy(), in first-applied order
+std::vector<AppliedThreadPolicy> GetAppliedThreadPolicies();
+
+/// Forget the recorded results (tests, or before a new session)
+void ClearAppliedThreadPolicies();
+
+/// One-line summary, e.g. "LiveCaptioner inference: High (nice -10), cpus 1-3"
+std::string FormatAppliedThreadPolicy(const AppliedThreadPolicy& applied);
+
+/// Priority name as used in summaries ("default", "background", "high", "realtime")
+const char* ThreadPriorityName(ThreadPriority priority);
+
+/**
+ * @brief Parse a core list such as "0-3,6"
+ * @return false (and @p cpus untouched) on malformed input
+ */
+bool ParseCpuList(const std::string& text, std::vector<int>& cpus);
+
+/// Every core of the machine except @p excluded (empty if none remains)
+std::vector<int> CpusExcept(const std::vector<int>& excluded);
+
+/// Number of cores the thread count of a pool pinned to @p policy should not exceed
+/// (policy.cpus.size(), or the hardware thread count when unpinned)
+int CpuBudget(const ThreadPolicy& policy);
+
+}  // namespace ffvoice
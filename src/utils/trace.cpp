@@ -0,0 +1,211 @@
+/**
+ * @file trace.cpp
+ * @brief Per-thread span buffers and Chrome trace JSON export
+ */
+
+#include "utils/trace.h"
+
+#include "utils/logger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace ffvoice {
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int64_t start_ns;  // Since the session's Start()
+    int64_t duration_ns;
+};
+
+// Written only by its own thread; the exporter reads [0, count)
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::string name;  // Guarded by TraceState::mutex
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> session{0};
+};
+
+struct TraceState {
+    std::mutex mutex;
+    // Kept after their thread exits so its spans can still be exported
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint64_t> session{0};
+    std::atomic<int64_t> origin_ns{0};
+    std::atomic<size_t> dropped{0};
+};
+
+TraceState& State() {
+    static TraceState state;
+    return state;
+}
+
+int64_t ToNanoseconds(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// Set by SetThreadName() even before the thread has a buffer
+thread_local std::string t_thread_name;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& CurrentBuffer() {
+    if (!t_buffer) {
+        TraceState& state = State();
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->events = std::make_unique<TraceEvent[]>(Tracer::kEventsPerThread);
+        owned->name = t_thread_name;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        owned->tid = static_cast<uint32_t>(state.buffers.size() + 1);
+        t_buffer = owned.get();
+        state.buffers.push_back(std::move(owned));
+    }
+    return *t_buffer;
+}
+
+// Span and thread names are chosen by the code, but keep the output valid JSON
+std::string EscapeJson(const std::string& input) {
+    std::string out;
+    out.reserve(input.size());
+    for (unsigned char c : input) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+// Chrome trace timestamps are microseconds; keep nanosecond precision
+std::string Microseconds(int64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000.0);
+    return buf;
+}
+
+}  // namespace
+
+void Tracer::Start() {
+    TraceState& state = State();
+    enabled_.store(false, std::memory_order_relaxed);
+    state.dropped.store(0, std::memory_order_relaxed);
+    state.origin_ns.store(ToNanoseconds(std::chrono::steady_clock::now()),
+                          std::memory_order_relaxed);
+    // Each thread clears its own buffer when it sees the new session
+    state.session.fetch_add(1, std::memory_order_release);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+    t_thread_name = name;
+    if (t_buffer) {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        t_buffer->name = name;
+    }
+}
+
+void Tracer::Record(const char* name, std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end) {
+    TraceState& state = State();
+    ThreadBuffer& buffer = CurrentBuffer();
+
+    const uint64_t session = state.session.load(std::memory_order_acquire);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.session.store(session, std::memory_order_release);
+    }
+    const size_t n = buffer.count.load(std::memory_order_relaxed);
+    if (n >= kEventsPerThread) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const int64_t start_ns = ToNanoseconds(start);
+    buffer.events[n] = {name, start_ns - state.origin_ns.load(std::memory_order_relaxed),
+                        ToNanoseconds(end) - start_ns};
+    buffer.count.store(n + 1, std::memory_order_release);
+}
+
+size_t Tracer::GetEventCount() {
+    TraceState& state = State();
+    const uint64_t session = state.session.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    size_t total = 0;
+    for (const auto& buffer : state.buffers) {
+        if (buffer->session.load(std::memory_order_acquire) == session) {
+            total += buffer->count.load(std::memory_order_acquire);
+        }
+    }
+    return total;
+}
+
+size_t Tracer::GetDroppedCount() {
+    return State().dropped.load(std::memory_order_relaxed);
+}
+
+std::string Tracer::ToChromeJson() {
+    TraceState& state = State();
+    const uint64_t session = state.session.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : state.buffers) {
+        if (buffer->session.load(std::memory_order_acquire) != session) {
+            continue;  // No spans from this thread in the current session
+        }
+        if (!buffer->name.empty()) {
+            json << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 << "\"tid\":" << buffer->tid << ",\"args\":{\"name\":\""
+                 << EscapeJson(buffer->name) << "\"}}";
+            first = false;
+        }
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            json << (first ? "" : ",") << "{\"name\":\"" << EscapeJson(event.name)
+                 << "\",\"cat\":\"ffvoice\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"ts\":" << Microseconds(event.start_ns)
+                 << ",\"dur\":" << Microseconds(event.duration_ns) << '}';
+            first = false;
+        }
+    }
+    json << "]}";
+    return json.str();
+}
+
+bool Tracer::WriteChromeTrace(const std::string& filename) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        LOG_ERROR("Failed to open trace file: %s", filename.c_str());
+        return false;
+    }
+    out << ToChromeJson() << '\n';
+    if (!out) {
+        LOG_ERROR("Failed to write trace file: %s", filename.c_str());
+        return false;
+    }
+    const size_t dropped = GetDroppedCount();
+    if (dropped > 0) {
+        LOG_WARNING("Trace: %zu spans dropped (per-thread buffer full)", dropped);
+    }
+    return true;
+}
+
+}  // namespace ffvoice
@@ -0,0 +1,117 @@
+/**
+ * @file trace.h
+ * @brief Scoped trace spans exported as Chrome trace JSON (chrome://tracing, Perfetto)
+ *
+ * FFVOICE_TRACE_SCOPE("Stage") marks the enclosing scope as one span on the
+ * calling thread's timeline. The macro compiles to nothing unless the build
+ * defines FFVOICE_ENABLE_TRACING (CMake option of the same name); when
+ * compiled in, a span costs one relaxed load while Tracer is stopped and two
+ * clock reads plus a store into the thread's own buffer while it runs.
+ *
+ * @code
+ * Tracer::Start();
+ * RunPipeline();                       // spans recorded on every thread
+ * Tracer::Stop();
+ * Tracer::WriteChromeTrace("trace.json");   // open in ui.perfetto.dev
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ffvoice {
+
+/**
+ * @brief Process-wide trace recorder with one event buffer per thread
+ *
+ * A thread's buffer is created (one allocation, under a mutex) at its first
+ * span and holds up to kEventsPerThread spans per session; later spans are
+ * dropped and counted rather than growing the buffer, so recording from the
+ * audio callback never allocates after its first span.
+ */
+class Tracer {
+public:
+    static constexpr size_t kEventsPerThread = 1 << 16;
+
+    /// Begin a new session (discards the previous one's events)
+    static void Start();
+
+    /// Stop recording; the events stay available for export
+    static void Stop();
+
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Label the calling thread's track in the exported trace (cheap; allocates no buffer)
+    static void SetThreadName(const std::string& name);
+
+    /**
+     * @brief Record one complete span
+     * @param name Span label; must outlive the session (use string literals)
+     */
+    static void Record(const char* name, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+
+    /// Spans recorded in the current session
+    static size_t GetEventCount();
+
+    /// Spans dropped because a thread's buffer was full
+    static size_t GetDroppedCount();
+
+    /// The current session as a Chrome trace JSON object ("traceEvents" array)
+    static std::string ToChromeJson();
+
+    /// Write ToChromeJson() to @p filename
+    static bool WriteChromeTrace(const std::string& filename);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * @brief Records the lifetime of the scope as a span while tracing runs
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name_(Tracer::IsEnabled() ? name : nullptr) {
+        if (name_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (name_) {
+            Tracer::Record(name_, start_, std::chrono::steady_clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace ffvoice
+
+#define FFVOICE_TRACE_CONCAT_INNER(a, b) a##b
+#define FFVOICE_TRACE_CONCAT(a, b) FFVOICE_TRACE_CONCAT_INNER(a, b)
+
+#ifdef FFVOICE_ENABLE_TRACING
+    #define FFVOICE_TRACE_SCOPE(name) \
+        ::ffvoice::TraceSpan FFVOICE_TRACE_CONCAT(ffvoice_trace_span_, __LINE__)(name)
+    #define FFVOICE_TRACE_THREAD_NAME(name) ::ffvoice::Tracer::SetThreadName(name)
+#else
+    #define FFVOICE_TRACE_SCOPE(name) \
+        do {                          \
+        } while (0)
+    #define FFVOICE_TRACE_THREAD_NAME(name) \
+        do {                                \
+        } while (0)
+#endif
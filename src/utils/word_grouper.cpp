@@ -9,20 +9,24 @@ namespace ffvoice {
 
 std::vector<Word> GroupTokensIntoWords(const std::vector<WordToken>& tokens) {
     std::vector<Word> words;
+    GroupTokensIntoWords(tokens, words);
+    return words;
+}
+
+void GroupTokensIntoWords(const std::vector<WordToken>& tokens, std::vector<Word>& words) {
+    words.clear();
 
     bool have_word = false;
-    Word current;
     double probability_sum = 0.0;
     int token_count = 0;
 
-    // Finalize the word currently being built and append it to the result.
+    // Finalize the word currently being built (always words.back()).
     auto flush = [&]() {
         if (!have_word) {
             return;
         }
-        current.probability =
+        words.back().probability =
             token_count > 0 ? static_cast<float>(probability_sum / token_count) : 0.0f;
-        words.push_back(current);
         have_word = false;
     };
 
@@ -38,21 +42,33 @@ std::vector<Word> GroupTokensIntoWords(const std::vector<WordToken>& tokens) {
         }
 
         if (!have_word) {
-            current = Word();
-            current.start_ms = token.start_ms;
+            // Built in place: no temporary Word to copy into the result
+            words.emplace_back();
+            words.back().start_ms = token.start_ms;
             have_word = true;
             probability_sum = 0.0;
             token_count = 0;
         }
 
+        Word& current = words.back();
         current.text += token.text;
         current.end_ms = token.end_ms;
         probability_sum += token.probability;
         ++token_count;
     }
     flush();
+}
 
-    return words;
+float MeanTokenProbability(const std::vector<WordToken>& tokens) {
+    double probability_sum = 0.0;
+    int token_count = 0;
+    for (const auto& token : tokens) {
+        if (!token.text.empty()) {
+            probability_sum += token.probability;
+            ++token_count;
+        }
+    }
+    return token_count > 0 ? static_cast<float>(probability_sum / token_count) : 0.0f;
 }
 
 }  // namespace ffvoice
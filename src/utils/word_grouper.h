@@ -40,4 +40,25 @@ struct WordToken {
  */
 std::vector<Word> GroupTokensIntoWords(const std::vector<WordToken>& tokens);
 
+/**
+ * @brief Group tokens into a caller-owned vector, reusing its capacity.
+ *
+ * Same grouping as the returning overload. @p words is cleared first; reusing
+ * one vector across calls avoids reallocating it for every segment.
+ *
+ * @param tokens Recognizer tokens in chronological order.
+ * @param words  Output: grouped words in chronological order.
+ */
+void GroupTokensIntoWords(const std::vector<WordToken>& tokens, std::vector<Word>& words);
+
+/**
+ * @brief Confidence of a recognized segment: the mean probability of its tokens.
+ *
+ * Empty-text tokens are ignored, as in word grouping.
+ *
+ * @param tokens Recognizer tokens of one segment.
+ * @return Mean token probability (0.0-1.0), or 0.0 without tokens.
+ */
+float MeanTokenProbability(const std::vector<WordToken>& tokens);
+
 }  // namespace ffvoice
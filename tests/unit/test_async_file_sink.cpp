@@ -0,0 +1,282 @@
+/**
+ * @file test_async_file_sink.cpp
+ * @brief Unit tests for AsyncFileSink
+ */
+
+#include "media/async_file_sink.h"
+#include "utils/signal_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+class AsyncFileSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_file_ = ::testing::TempDir() + "test_async_file_sink.wav";
+    }
+
+    void TearDown() override {
+        std::remove(test_file_.c_str());
+    }
+
+    // Helper: read the data chunk size field of a canonical 44-byte WAV header
+    uint32_t ReadDataSize(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        uint32_t data_size = 0;
+        file.seekg(40);
+        file.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
+        return data_size;
+    }
+
+    // Helper: read all PCM samples following the 44-byte header
+    std::vector<int16_t> ReadSamples(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        file.seekg(0, std::ios::end);
+        const std::streamoff size = file.tellg();
+        std::vector<int16_t> samples(static_cast<size_t>(size - 44) / sizeof(int16_t));
+        file.seekg(44);
+        file.read(reinterpret_cast<char*>(samples.data()),
+                  static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+        return samples;
+    }
+
+    std::string test_file_;
+};
+
+TEST_F(AsyncFileSinkTest, OpenAndClose) {
+    AsyncFileSink sink(AsyncFileSink::Config{});
+    EXPECT_FALSE(sink.IsOpen());
+
+    ASSERT_TRUE(sink.Open(test_file_));
+    EXPECT_TRUE(sink.IsOpen());
+
+    sink.Close();
+    EXPECT_FALSE(sink.IsOpen());
+    EXPECT_EQ(ReadDataSize(test_file_), 0u);
+}
+
+TEST_F(AsyncFileSinkTest, OpenInvalidPath) {
+    AsyncFileSink sink(AsyncFileSink::Config{});
+    EXPECT_FALSE(sink.Open("/nonexistent/path/file.wav"));
+    EXPECT_FALSE(sink.IsOpen());
+    EXPECT_FALSE(sink.GetLastError().empty());
+}
+
+TEST_F(AsyncFileSinkTest, WriteBeforeOpenIsIgnored) {
+    AsyncFileSink sink(AsyncFileSink::Config{});
+    std::vector<int16_t> samples(128, 1000);
+    EXPECT_EQ(sink.Write(samples.data(), samples.size()), 0u);
+    EXPECT_EQ(sink.GetDroppedSamples(), 0u);
+}
+
+TEST_F(AsyncFileSinkTest, CloseDrainsAllQueuedSamples) {
+    AsyncFileSink sink(AsyncFileSink::Config{});
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    // Write in small callback-sized blocks, as the capture thread would.
+    std::vector<int16_t> expected;
+    for (int block = 0; block < 40; ++block) {
+        std::vector<int16_t> chunk(256);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            chunk[i] = static_cast<int16_t>(block * 256 + static_cast<int>(i));
+        }
+        EXPECT_EQ(sink.Write(chunk.data(), chunk.size()), chunk.size());
+        expected.insert(expected.end(), chunk.begin(), chunk.end());
+    }
+
+    sink.Close();
+
+    EXPECT_EQ(sink.GetTotalSamples(), expected.size());
+    EXPECT_EQ(sink.GetDroppedSamples(), 0u);
+    EXPECT_EQ(ReadDataSize(test_file_), expected.size() * sizeof(int16_t));
+    EXPECT_EQ(ReadSamples(test_file_), expected);
+}
+
+TEST_F(AsyncFileSinkTest, DropsSamplesWhenRingIsFull) {
+    AsyncFileSink::Config cfg;
+    cfg.ring_buffer_capacity = 64;
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    // A single write larger than the ring can hold must drop the excess
+    // instead of blocking.
+    std::vector<int16_t> samples(1000, 42);
+    size_t queued = sink.Write(samples.data(), samples.size());
+
+    EXPECT_LE(queued, cfg.ring_buffer_capacity);
+    EXPECT_EQ(sink.GetDroppedSamples(), samples.size() - queued);
+    EXPECT_LE(sink.GetHighWaterMark(), sink.GetCapacity());
+    EXPECT_GT(sink.GetHighWaterMark(), 0u);
+
+    sink.Close();
+    EXPECT_EQ(sink.GetTotalSamples(), queued);
+}
+
+TEST_F(AsyncFileSinkTest, StereoOverflowDropsWholeFrames) {
+    AsyncFileSink::Config cfg;
+    cfg.channels = 2;
+    cfg.ring_buffer_capacity = 63;  // Odd on purpose: never a whole number of frames
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    // Left = +frame index, right = -frame index; overflow the ring several times
+    size_t frame = 0;
+    size_t queued = 0;
+    for (int block = 0; block < 50; ++block) {
+        std::vector<int16_t> samples;
+        for (int i = 0; i < 45; ++i, ++frame) {
+            samples.push_back(static_cast<int16_t>(frame % 30000 + 1));
+            samples.push_back(static_cast<int16_t>(-static_cast<int>(frame % 30000 + 1)));
+        }
+        const size_t n = sink.Write(samples.data(), samples.size());
+        EXPECT_EQ(0u, n % 2) << "split a frame";
+        queued += n;
+    }
+    sink.Close();
+    EXPECT_GT(sink.GetDroppedSamples(), 0u);
+    EXPECT_EQ(0u, sink.GetDroppedSamples() % 2);
+
+    const std::vector<int16_t> written = ReadSamples(test_file_);
+    ASSERT_EQ(queued, written.size());
+    for (size_t i = 0; i + 1 < written.size(); i += 2) {
+        ASSERT_GT(written[i], 0) << "left channel at sample " << i;
+        ASSERT_EQ(-written[i], written[i + 1]) << "channels swapped at sample " << i;
+    }
+}
+
+TEST_F(AsyncFileSinkTest, ReopenResetsStatistics) {
+    AsyncFileSink::Config cfg;
+    cfg.ring_buffer_capacity = 16;
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    std::vector<int16_t> samples(100, 7);
+    sink.Write(samples.data(), samples.size());
+    sink.Close();
+    EXPECT_GT(sink.GetDroppedSamples(), 0u);
+
+    ASSERT_TRUE(sink.Open(test_file_));
+    EXPECT_EQ(sink.GetDroppedSamples(), 0u);
+    EXPECT_EQ(sink.GetHighWaterMark(), 0u);
+    EXPECT_EQ(sink.GetTotalSamples(), 0u);
+    sink.Close();
+}
+
+TEST_F(AsyncFileSinkTest, DestructorFinalizesFile) {
+    auto samples = SignalGenerator::GenerateSineWave(440.0, 0.1, 48000);
+    {
+        AsyncFileSink sink(AsyncFileSink::Config{});
+        ASSERT_TRUE(sink.Open(test_file_));
+        sink.Write(samples.data(), samples.size());
+    }
+    EXPECT_EQ(ReadDataSize(test_file_), samples.size() * sizeof(int16_t));
+}
+
+// ============================================================================
+// Segmented recording
+// ============================================================================
+
+TEST_F(AsyncFileSinkTest, SegmentPathNumbersBeforeTheExtension) {
+    EXPECT_EQ("rec_0000.wav", AsyncFileSink::GetSegmentPath("rec.wav", 0));
+    EXPECT_EQ("dir/rec_0012.flac", AsyncFileSink::GetSegmentPath("dir/rec.flac", 12));
+    EXPECT_EQ("/data.d/rec_0001", AsyncFileSink::GetSegmentPath("/data.d/rec", 1));
+}
+
+TEST_F(AsyncFileSinkTest, SegmentsByDurationWithoutGaps) {
+    AsyncFileSink::Config cfg;
+    cfg.sample_rate = 16000;
+    cfg.segment_seconds = 0.25;  // 4000 samples per file
+    std::vector<std::string> closed;
+    cfg.on_file_closed = [&closed](const std::string& path) { closed.push_back(path); };
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    // 1.1 s in 10 ms blocks; boundaries fall inside blocks
+    std::vector<int16_t> expected;
+    for (int block = 0; block < 110; ++block) {
+        std::vector<int16_t> chunk(160);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            chunk[i] = static_cast<int16_t>(block * 160 + static_cast<int>(i));
+        }
+        ASSERT_EQ(sink.Write(chunk.data(), chunk.size()), chunk.size());
+        expected.insert(expected.end(), chunk.begin(), chunk.end());
+    }
+    sink.Close();
+
+    EXPECT_EQ(5u, sink.GetNumFiles());
+    EXPECT_EQ(expected.size(), sink.GetTotalSamples());
+    ASSERT_EQ(5u, closed.size());
+
+    const std::vector<size_t> sizes = {4000, 4000, 4000, 4000, 1600};
+    std::vector<int16_t> joined;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        const std::string path = AsyncFileSink::GetSegmentPath(test_file_, i);
+        EXPECT_EQ(path, closed[i]);
+        EXPECT_EQ(sizes[i] * sizeof(int16_t), ReadDataSize(path)) << path;
+        const std::vector<int16_t> samples = ReadSamples(path);
+        joined.insert(joined.end(), samples.begin(), samples.end());
+        std::remove(path.c_str());
+    }
+    EXPECT_EQ(expected, joined);
+
+    // The file opened ahead for the next segment is removed
+    std::ifstream unused(AsyncFileSink::GetSegmentPath(test_file_, 5));
+    EXPECT_FALSE(unused.good());
+}
+
+TEST_F(AsyncFileSinkTest, SegmentsBySizeOnFrameBoundaries) {
+    AsyncFileSink::Config cfg;
+    cfg.channels = 2;
+    cfg.segment_seconds = 60.0;
+    cfg.segment_bytes = 1002;  // 250 stereo frames; the odd bytes are not used
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(test_file_));
+
+    // Ends on a boundary: no empty third file
+    std::vector<int16_t> samples(1000, 5);
+    sink.Write(samples.data(), samples.size());
+    sink.Close();
+
+    EXPECT_EQ(2u, sink.GetNumFiles());
+    for (size_t i = 0; i < 2; ++i) {
+        const std::string path = AsyncFileSink::GetSegmentPath(test_file_, i);
+        EXPECT_EQ(500u * sizeof(int16_t), ReadDataSize(path)) << path;
+        std::remove(path.c_str());
+    }
+    std::ifstream third(AsyncFileSink::GetSegmentPath(test_file_, 2));
+    EXPECT_FALSE(third.good());
+}
+
+TEST_F(AsyncFileSinkTest, OpusSegmentsAndPacketCallback) {
+    const std::string opus_file = ::testing::TempDir() + "test_async_file_sink.opus";
+    std::atomic<size_t> packets{0};
+    AsyncFileSink::Config cfg;
+    cfg.format = AsyncFileSink::Format::OPUS;
+    cfg.segment_seconds = 0.5;
+    cfg.opus.on_packet = [&](const uint8_t*, size_t, int64_t) { ++packets; };
+    AsyncFileSink sink(cfg);
+    ASSERT_TRUE(sink.Open(opus_file));
+
+    const auto audio = SignalGenerator::GenerateSineWave(440.0, 1.0, 48000, 0.3);
+    sink.Write(audio.data(), audio.size());
+    sink.Close();
+
+    EXPECT_EQ(2u, sink.GetNumFiles());
+    EXPECT_GE(packets.load(), 50u);  // 20 ms packets
+    EXPECT_GT(sink.GetCompressionRatio(), 10.0);
+    for (size_t i = 0; i < 2; ++i) {
+        const std::string path = AsyncFileSink::GetSegmentPath(opus_file, i);
+        std::ifstream file(path, std::ios::binary);
+        char magic[4] = {};
+        file.read(magic, 4);
+        EXPECT_EQ("OggS", std::string(magic, 4)) << path;
+        std::remove(path.c_str());
+    }
+}
@@ -11,11 +11,14 @@
         #define _USE_MATH_DEFINES
     #endif
 
+    #include "media/flac_writer.h"
     #include "utils/audio_converter.h"
+    #include "utils/signal_generator.h"
 
     #include <gtest/gtest.h>
 
     #include <cmath>
+    #include <cstdio>
     #include <limits>
     #include <vector>
 
@@ -284,4 +287,33 @@ TEST_F(AudioConverterTest, LoadAndConvert_UnsupportedExtension) {
     EXPECT_FALSE(result);
 }
 
+TEST_F(AudioConverterTest, LoadAndConvert_FlacStereo48k) {
+    // 2 s of 48 kHz stereo, left and right identical
+    const auto mono = SignalGenerator::GenerateSineWave(440.0, 2.0, 48000, 0.5);
+    std::vector<int16_t> stereo;
+    stereo.reserve(mono.size() * 2);
+    for (int16_t s : mono) {
+        stereo.push_back(s);
+        stereo.push_back(s);
+    }
+    const std::string flac_path = ::testing::TempDir() + "test_audio_converter.flac";
+    FlacWriter writer;
+    ASSERT_TRUE(writer.Open(flac_path, 48000, 2));
+    writer.WriteSamples(stereo);
+    writer.Close();
+
+    std::vector<float> pcm_data;
+    ASSERT_TRUE(AudioConverter::LoadAndConvert(flac_path, pcm_data, 16000));
+    std::remove(flac_path.c_str());
+
+    // Downmixed and resampled while decoding: exactly the 16 kHz length
+    ASSERT_EQ(32000u, pcm_data.size());
+    double sum_sq = 0.0;
+    for (size_t i = 1000; i < pcm_data.size() - 1000; ++i) {  // skip filter edges
+        sum_sq += pcm_data[i] * pcm_data[i];
+    }
+    const double rms = std::sqrt(sum_sq / (pcm_data.size() - 2000));
+    EXPECT_NEAR(0.5 / std::sqrt(2.0), rms, 0.02);
+}
+
 #endif  // ENABLE_WHISPER
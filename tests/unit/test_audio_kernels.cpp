@@ -0,0 +1,174 @@
+/**
+ * @file test_audio_kernels.cpp
+ * @brief Unit tests for the SIMD conversion and mixing kernels (every ISA against scalar)
+ */
+
+#include "utils/audio_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+// Lengths around every vector width, so both the SIMD body and the scalar tail run
+const size_t kLengths[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 480, 4801};
+
+std::vector<int16_t> RandomInt16(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<int16_t> samples(count);
+    for (auto& s : samples) {
+        s = static_cast<int16_t>(dist(rng));
+    }
+    // Extremes exercise the sign extension and the int32 sum of two channels
+    if (count >= 4) {
+        samples[0] = -32768;
+        samples[1] = -32768;
+        samples[2] = 32767;
+        samples[3] = 32767;
+    }
+    return samples;
+}
+
+std::vector<float> RandomFloat(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    // Beyond [-1, 1] so clamping is exercised
+    std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+    std::vector<float> samples(count);
+    for (auto& s : samples) {
+        s = dist(rng);
+    }
+    return samples;
+}
+
+// Every table available on this machine, scalar first
+std::vector<const AudioKernels*> AvailableKernels() {
+    std::vector<const AudioKernels*> tables;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+        if (const AudioKernels* kernels = GetAudioKernels(level)) {
+            tables.push_back(kernels);
+        }
+    }
+    return tables;
+}
+
+}  // namespace
+
+TEST(AudioKernelsTest, DispatchPicksAnAvailableTable) {
+    const AudioKernels& best = GetAudioKernels();
+    ASSERT_NE(nullptr, GetAudioKernels(best.level));
+    EXPECT_STREQ(best.name, GetAudioKernels(best.level)->name);
+    ASSERT_NE(nullptr, GetAudioKernels(SimdLevel::Scalar));
+}
+
+TEST(AudioKernelsTest, Int16ToFloatMatchesScalar) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t n : kLengths) {
+            const std::vector<int16_t> input = RandomInt16(n, 1);
+            std::vector<float> expected(n);
+            std::vector<float> actual(n);
+            scalar.int16_to_float(input.data(), n, expected.data());
+            kernels->int16_to_float(input.data(), n, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " n=" << n;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, FloatToInt16MatchesScalar) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t n : kLengths) {
+            const std::vector<float> input = RandomFloat(n, 2);
+            std::vector<int16_t> expected(n);
+            std::vector<int16_t> actual(n);
+            scalar.float_to_int16(input.data(), n, expected.data());
+            kernels->float_to_int16(input.data(), n, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " n=" << n;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, StereoToMonoMatchesScalar) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t frames : kLengths) {
+            const std::vector<float> input = RandomFloat(frames * 2, 3);
+            std::vector<float> expected(frames);
+            std::vector<float> actual(frames);
+            scalar.stereo_to_mono(input.data(), frames, expected.data());
+            kernels->stereo_to_mono(input.data(), frames, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " frames=" << frames;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, FusedStereoInt16MatchesTwoStepConversion) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t frames : kLengths) {
+            const std::vector<int16_t> input = RandomInt16(frames * 2, 4);
+
+            // int16 -> float stereo -> mono, the unfused path
+            std::vector<float> stereo(frames * 2);
+            std::vector<float> expected(frames);
+            scalar.int16_to_float(input.data(), input.size(), stereo.data());
+            scalar.stereo_to_mono(stereo.data(), frames, expected.data());
+
+            std::vector<float> actual(frames);
+            kernels->int16_stereo_to_mono(input.data(), frames, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " frames=" << frames;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, MixInt16MatchesScalar) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    const float gains[2] = {0.75f, 1.5f};
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t n : kLengths) {
+            const std::vector<int16_t> input = RandomInt16(n, 5);
+            // Accumulate onto a non-zero mix, as the second track of a block would
+            std::vector<float> expected = RandomFloat(n, 6);
+            std::vector<float> actual = expected;
+            scalar.mix_int16(input.data(), n, gains, expected.data());
+            kernels->mix_int16(input.data(), n, gains, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " n=" << n;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, MixInt16AlternatesGainsPerSample) {
+    const std::vector<int16_t> input(33, 1000);
+    const float gains[2] = {1.0f, 0.0f};  // Left only
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        std::vector<float> mix(input.size(), 0.0f);
+        kernels->mix_int16(input.data(), input.size(), gains, mix.data());
+        for (size_t i = 0; i < mix.size(); ++i) {
+            EXPECT_EQ(i % 2 == 0 ? 1000.0f : 0.0f, mix[i]) << kernels->name << " i=" << i;
+        }
+    }
+}
+
+TEST(AudioKernelsTest, ScaledFloatToInt16MatchesScalar) {
+    const AudioKernels& scalar = *GetAudioKernels(SimdLevel::Scalar);
+    for (const AudioKernels* kernels : AvailableKernels()) {
+        for (size_t n : kLengths) {
+            // Values past int16 full scale, so the clamp saturates both ways
+            std::vector<float> input = RandomFloat(n, 7);
+            for (auto& s : input) {
+                s *= 32768.0f;
+            }
+            std::vector<int16_t> expected(n);
+            std::vector<int16_t> actual(n);
+            scalar.scaled_float_to_int16(input.data(), n, 1.25f, expected.data());
+            kernels->scaled_float_to_int16(input.data(), n, 1.25f, actual.data());
+            EXPECT_EQ(expected, actual) << kernels->name << " n=" << n;
+        }
+    }
+}
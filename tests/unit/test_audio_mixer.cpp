@@ -7,7 +7,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <thread>
 #include <vector>
 
 using namespace ffvoice;
@@ -18,6 +23,25 @@ protected:
     std::vector<int16_t> Block(size_t num_samples, int16_t value) {
         return std::vector<int16_t>(num_samples, value);
     }
+
+    // Helper: num_tracks tracks with random gain, pan and content, fed as inputs.
+    void AddRandomTracks(AudioMixer& mixer, int num_tracks, size_t num_samples) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> gain(0.0f, 2.0f);
+        std::uniform_real_distribution<float> pan(-1.0f, 1.0f);
+        std::uniform_int_distribution<int> sample(-3000, 3000);
+        blocks_.assign(static_cast<size_t>(num_tracks), std::vector<int16_t>(num_samples));
+        inputs_.clear();
+        for (auto& block : blocks_) {
+            for (auto& s : block) {
+                s = static_cast<int16_t>(sample(rng));
+            }
+            inputs_.push_back({mixer.AddTrack(gain(rng), pan(rng)), block.data()});
+        }
+    }
+
+    std::vector<std::vector<int16_t>> blocks_;
+    std::vector<MixerInput> inputs_;
 };
 
 // ============================================================================
@@ -124,6 +148,39 @@ TEST_F(AudioMixerTest, RemoveTrack_Works) {
     EXPECT_FALSE(mixer.RemoveTrack(t));  // already gone
 }
 
+TEST_F(AudioMixerTest, RemoveTrack_KeepsOtherTracksSettings) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+
+    int a = mixer.AddTrack(0.25f, -0.5f);
+    int b = mixer.AddTrack(0.5f, 0.0f);
+    int c = mixer.AddTrack(0.75f, 0.5f);
+    mixer.SetMute(c, true);
+
+    // Removing from the front and middle moves the last track into the hole
+    EXPECT_TRUE(mixer.RemoveTrack(a));
+    EXPECT_FALSE(mixer.HasTrack(a));
+    EXPECT_FLOAT_EQ(0.5f, mixer.GetGain(b));
+    EXPECT_FLOAT_EQ(0.75f, mixer.GetGain(c));
+    EXPECT_FLOAT_EQ(0.5f, mixer.GetPan(c));
+    EXPECT_TRUE(mixer.IsMuted(c));
+
+    int d = mixer.AddTrack(1.0f, 0.0f);
+    EXPECT_NE(a, d);  // ids are not reused
+    EXPECT_TRUE(mixer.RemoveTrack(b));
+    EXPECT_EQ(2u, mixer.GetTrackCount());
+    EXPECT_FLOAT_EQ(0.75f, mixer.GetGain(c));
+    EXPECT_FLOAT_EQ(1.0f, mixer.GetGain(d));
+
+    auto block = Block(64, 1000);
+    std::vector<int16_t> out(64);
+    ASSERT_TRUE(mixer.MixBlock({{b, block.data()}, {c, block.data()}, {d, block.data()}},
+                               out.data(), out.size()));
+    for (int16_t s : out) {
+        EXPECT_EQ(1000, s);  // only d: b is gone and c is muted
+    }
+}
+
 // ============================================================================
 // Per-track controls
 // ============================================================================
@@ -252,6 +309,25 @@ TEST_F(AudioMixerTest, MixBlock_SumsMultipleTracks) {
     }
 }
 
+TEST_F(AudioMixerTest, MixBlock_ManyTracksAndOddLength) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    std::vector<MixerInput> inputs;
+    std::vector<std::vector<int16_t>> blocks;
+    for (int i = 0; i < 64; ++i) {
+        blocks.push_back(Block(37, static_cast<int16_t>(i)));  // not a vector multiple
+    }
+    for (int i = 0; i < 64; ++i) {
+        inputs.push_back({mixer.AddTrack(0.5f), blocks[static_cast<size_t>(i)].data()});
+    }
+
+    std::vector<int16_t> out(37);
+    ASSERT_TRUE(mixer.MixBlock(inputs, out.data(), out.size()));
+    for (int16_t s : out) {
+        EXPECT_EQ(1008, s);  // (0 + 1 + ... + 63) * 0.5
+    }
+}
+
 TEST_F(AudioMixerTest, MixBlock_MutedTrackContributesSilence) {
     AudioMixer mixer;
     mixer.Initialize(48000, 1);
@@ -419,6 +495,185 @@ TEST_F(AudioMixerTest, MixBlock_PanIgnoredForMono) {
     }
 }
 
+// ============================================================================
+// MixBlock — parallel mixing
+// ============================================================================
+
+TEST_F(AudioMixerTest, SetNumThreads_Clamps) {
+    AudioMixer mixer;
+    EXPECT_EQ(1, mixer.GetNumThreads());
+    mixer.SetNumThreads(0);
+    EXPECT_EQ(1, mixer.GetNumThreads());
+    mixer.SetNumThreads(4);
+    EXPECT_EQ(4, mixer.GetNumThreads());
+    mixer.SetNumThreads(1000);
+    EXPECT_EQ(64, mixer.GetNumThreads());
+    mixer.SetNumThreads(1);
+    EXPECT_EQ(1, mixer.GetNumThreads());
+}
+
+TEST_F(AudioMixerTest, MixBlock_ParallelIsDeterministicAndMatchesSerial) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+    AddRandomTracks(mixer, 300, 960);
+
+    std::vector<int16_t> serial(960);
+    ASSERT_TRUE(mixer.MixBlock(inputs_, serial.data(), serial.size()));
+
+    mixer.SetNumThreads(4);
+    std::vector<int16_t> first(960);
+    std::vector<int16_t> again(960);
+    for (int run = 0; run < 20; ++run) {
+        ASSERT_TRUE(mixer.MixBlock(inputs_, again.data(), again.size()));
+        if (run == 0) {
+            first = again;
+        }
+        ASSERT_EQ(first, again) << "run " << run;
+    }
+
+    // Only the float summation order differs from serial mixing
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_LE(std::abs(serial[i] - first[i]), 1) << "sample " << i;
+    }
+}
+
+TEST_F(AudioMixerTest, MixBlock_SmallMixStaysSerial) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+    AddRandomTracks(mixer, 8, 512);  // below kMinInputsPerLane
+
+    std::vector<int16_t> serial(512);
+    ASSERT_TRUE(mixer.MixBlock(inputs_, serial.data(), serial.size()));
+    mixer.SetNumThreads(8);
+    std::vector<int16_t> parallel(512);
+    ASSERT_TRUE(mixer.MixBlock(inputs_, parallel.data(), parallel.size()));
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(AudioMixerTest, MixBlock_ParallelExactForIntegerSums) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    mixer.SetNumThreads(4);
+    std::vector<MixerInput> inputs;
+    auto block = Block(100, 10);
+    for (int i = 0; i < 200; ++i) {
+        inputs.push_back({mixer.AddTrack(), block.data()});
+    }
+    inputs.push_back({12345, block.data()});  // unknown id still ignored
+
+    std::vector<int16_t> out(100);
+    ASSERT_TRUE(mixer.MixBlock(inputs, out.data(), out.size()));
+    for (int16_t s : out) {
+        EXPECT_EQ(2000, s);
+    }
+}
+
+// ============================================================================
+// MixBlock — parameter snapshots and ramps
+// ============================================================================
+
+TEST_F(AudioMixerTest, MixBlock_GainChangeRampsOverNextBlock) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int t = mixer.AddTrack(1.0f);
+
+    auto in = Block(100, 1000);
+    std::vector<int16_t> out(100);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    EXPECT_EQ(1000, out.front());  // a new track starts at its gain
+
+    mixer.SetGain(t, 0.0f);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    for (size_t i = 1; i < out.size(); ++i) {
+        EXPECT_LE(out[i], out[i - 1]) << "sample " << i;
+    }
+    EXPECT_NEAR(990, out.front(), 1);  // one frame into the ramp
+    EXPECT_NEAR(500, out[49], 1);
+    EXPECT_EQ(0, out.back());          // reaches the target on the last frame
+
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    for (int16_t s : out) {
+        EXPECT_EQ(0, s);
+    }
+}
+
+TEST_F(AudioMixerTest, MixBlock_MuteAndPanRampPerChannel) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+    int t = mixer.AddTrack(1.0f, 0.0f);
+
+    auto in = Block(200, 1000);  // 100 stereo frames
+    std::vector<int16_t> out(200);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+
+    mixer.SetPan(t, -1.0f);  // right channel fades out, left stays
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    for (size_t frame = 0; frame < 100; ++frame) {
+        EXPECT_EQ(1000, out[frame * 2]) << "frame " << frame;
+    }
+    EXPECT_GT(out[1], 900);
+    EXPECT_EQ(0, out[199]);
+
+    mixer.SetMute(t, true);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    EXPECT_GT(out[0], 900);
+    EXPECT_EQ(0, out[198]);
+
+    mixer.SetMute(t, false);  // fades back in rather than clicking
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    EXPECT_LT(out[0], 100);
+    EXPECT_EQ(1000, out[198]);
+}
+
+TEST_F(AudioMixerTest, MixBlock_MasterGainChangeRamps) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int t = mixer.AddTrack();
+
+    auto in = Block(64, 2000);
+    std::vector<int16_t> out(64);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    mixer.SetMasterGain(0.5f);
+    ASSERT_TRUE(mixer.MixBlock({{t, in.data()}}, out.data(), out.size()));
+    EXPECT_GT(out.front(), 1900);
+    EXPECT_EQ(1000, out.back());
+}
+
+TEST_F(AudioMixerTest, MixBlock_ControlThreadNeverTearsABlock) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    std::vector<MixerInput> inputs;
+    auto in = Block(256, 100);
+    for (int i = 0; i < 4; ++i) {
+        inputs.push_back({mixer.AddTrack(1.0f), in.data()});
+    }
+
+    // Gains stay in [0, 1] during the churn, so every sample is in [0, 400]
+    std::atomic<bool> done{false};
+    std::thread control([&] {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> gain(0.0f, 1.0f);
+        while (!done.load()) {
+            for (const MixerInput& input : inputs) {
+                mixer.SetGain(input.track_id, gain(rng));
+            }
+            mixer.RemoveTrack(mixer.AddTrack(gain(rng)));
+        }
+    });
+
+    std::vector<int16_t> out(256);
+    for (int block = 0; block < 2000; ++block) {
+        ASSERT_TRUE(mixer.MixBlock(inputs, out.data(), out.size()));
+        for (int16_t s : out) {
+            ASSERT_GE(s, 0);
+            ASSERT_LE(s, 400);
+        }
+    }
+    done.store(true);
+    control.join();
+    EXPECT_EQ(4u, mixer.GetTrackCount());
+}
+
 // ============================================================================
 // MixBlock — argument validation
 // ============================================================================
@@ -450,6 +705,190 @@ TEST_F(AudioMixerTest, MixBlock_ZeroSamplesIsNoop) {
     EXPECT_TRUE(mixer.MixBlock({}, out.data(), 0));
 }
 
+// ============================================================================
+// MixMinusBlock
+// ============================================================================
+
+TEST_F(AudioMixerTest, MixMinus_MatchesMixingTheOthers) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+    AddRandomTracks(mixer, 12, 256);
+
+    std::vector<std::vector<int16_t>> minus(inputs_.size(), std::vector<int16_t>(256));
+    std::vector<MixMinusOutput> outputs;
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        outputs.push_back({inputs_[i].track_id, minus[i].data()});
+    }
+    ASSERT_TRUE(mixer.MixMinusBlock(inputs_, outputs, 256));
+
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        std::vector<MixerInput> others = inputs_;
+        others.erase(others.begin() + static_cast<std::ptrdiff_t>(i));
+        std::vector<int16_t> expected(256);
+        ASSERT_TRUE(mixer.MixBlock(others, expected.data(), expected.size()));
+        for (size_t j = 0; j < expected.size(); ++j) {
+            ASSERT_NEAR(expected[j], minus[i][j], 1) << "output " << i << " sample " << j;
+        }
+    }
+}
+
+TEST_F(AudioMixerTest, MixMinus_ExactForIntegerSums) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int a = mixer.AddTrack();
+    int b = mixer.AddTrack();
+    int c = mixer.AddTrack(2.0f);
+
+    auto in_a = Block(64, 100);
+    auto in_b = Block(64, 200);
+    auto in_c = Block(64, 300);
+    std::vector<int16_t> out_a(64), out_b(64), out_c(64);
+    ASSERT_TRUE(mixer.MixMinusBlock({{a, in_a.data()}, {b, in_b.data()}, {c, in_c.data()}},
+                                    {{a, out_a.data()}, {b, out_b.data()}, {c, out_c.data()}},
+                                    64));
+    EXPECT_EQ(Block(64, 800), out_a);
+    EXPECT_EQ(Block(64, 700), out_b);
+    EXPECT_EQ(Block(64, 300), out_c);
+}
+
+TEST_F(AudioMixerTest, MixMinus_MutedAndListenOnlyHearTheFullMix) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int talker = mixer.AddTrack();
+    int muted = mixer.AddTrack();
+    mixer.SetMute(muted, true);
+    int listener = mixer.AddTrack();  // no input this block
+
+    auto in_talker = Block(32, 1000);
+    auto in_muted = Block(32, 5000);
+    std::vector<int16_t> out_talker(32), out_muted(32), out_listener(32), out_unknown(32);
+    ASSERT_TRUE(mixer.MixMinusBlock({{talker, in_talker.data()}, {muted, in_muted.data()}},
+                                    {{talker, out_talker.data()},
+                                     {muted, out_muted.data()},
+                                     {listener, out_listener.data()},
+                                     {AudioMixer::kInvalidTrack, out_unknown.data()}},
+                                    32));
+    EXPECT_EQ(Block(32, 0), out_talker);
+    EXPECT_EQ(Block(32, 1000), out_muted);
+    EXPECT_EQ(Block(32, 1000), out_listener);
+    EXPECT_EQ(Block(32, 1000), out_unknown);
+}
+
+TEST_F(AudioMixerTest, MixMinus_ClipsEachOutputSeparately) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int a = mixer.AddTrack();
+    int b = mixer.AddTrack();
+    int c = mixer.AddTrack();
+
+    auto loud = Block(16, 30000);
+    auto quiet = Block(16, 1000);
+    std::vector<int16_t> out_a(16), out_c(16);
+    ASSERT_TRUE(mixer.MixMinusBlock({{a, loud.data()}, {b, loud.data()}, {c, quiet.data()}},
+                                    {{a, out_a.data()}, {c, out_c.data()}}, 16));
+    EXPECT_EQ(Block(16, 31000), out_a);  // the bus clipped, this output does not
+    EXPECT_EQ(Block(16, 32767), out_c);
+}
+
+TEST_F(AudioMixerTest, MixMinus_RampsMatchMixBlock) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 2);
+    int a = mixer.AddTrack();
+    int b = mixer.AddTrack();
+    auto in_a = Block(128, 1000);
+    auto in_b = Block(128, 2000);
+    std::vector<int16_t> out_a(128), out_b(128);
+    ASSERT_TRUE(mixer.MixMinusBlock({{a, in_a.data()}, {b, in_b.data()}},
+                                    {{a, out_a.data()}, {b, out_b.data()}}, 128));
+
+    // Removing a ramping track leaves exactly the other one
+    mixer.SetGain(a, 0.0f);
+    mixer.SetPan(b, 1.0f);
+    ASSERT_TRUE(mixer.MixMinusBlock({{a, in_a.data()}, {b, in_b.data()}},
+                                    {{a, out_a.data()}, {b, out_b.data()}}, 128));
+    EXPECT_NEAR(1969, out_a[0], 1);  // left of b fades on the pan ramp
+    EXPECT_EQ(0, out_a[126]);
+    EXPECT_EQ(2000, out_a[127]);
+    EXPECT_EQ(0, out_b[126]);  // a fades to silence
+    EXPECT_EQ(0, out_b[127]);
+}
+
+TEST_F(AudioMixerTest, MixMinus_ParallelBus) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    mixer.SetNumThreads(4);
+    std::vector<MixerInput> inputs;
+    std::vector<std::vector<int16_t>> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(Block(50, static_cast<int16_t>(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        inputs.push_back({mixer.AddTrack(), blocks[static_cast<size_t>(i)].data()});
+    }
+
+    std::vector<std::vector<int16_t>> minus(100, std::vector<int16_t>(50));
+    std::vector<MixMinusOutput> outputs;
+    for (int i = 0; i < 100; ++i) {
+        outputs.push_back({inputs[static_cast<size_t>(i)].track_id,
+                           minus[static_cast<size_t>(i)].data()});
+    }
+    ASSERT_TRUE(mixer.MixMinusBlock(inputs, outputs, 50));
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(Block(50, static_cast<int16_t>(4950 - i)), minus[static_cast<size_t>(i)]);
+    }
+}
+
+TEST_F(AudioMixerTest, MixMinus_NullOutputFails) {
+    AudioMixer mixer;
+    mixer.Initialize(48000, 1);
+    int t = mixer.AddTrack();
+    auto in = Block(8, 1);
+    EXPECT_FALSE(mixer.MixMinusBlock({{t, in.data()}}, {{t, nullptr}}, 8));
+    EXPECT_TRUE(mixer.MixMinusBlock({{t, in.data()}}, {}, 0));
+}
+
+// ============================================================================
+// Limiter
+// ============================================================================
+
+TEST_F(AudioMixerTest, Limiter_TurnsOverlapsDownInsteadOfClipping) {
+    AudioMixer mixer;
+    EXPECT_FALSE(mixer.EnableLimiter());  // Not initialized
+    mixer.Initialize(48000, 1);
+    int a = mixer.AddTrack();
+    int b = mixer.AddTrack();
+    ASSERT_TRUE(mixer.EnableLimiter());
+    EXPECT_TRUE(mixer.IsLimiterEnabled());
+    const size_t latency = mixer.GetLatencyFrames();
+    EXPECT_EQ(240u, latency);  // 5 ms lookahead
+
+    // Two tracks at 3/4 full scale sum to 1.5x full scale
+    auto loud = Block(480, 24576);
+    std::vector<int16_t> out(480);
+    int peak = 0;
+    int clipped = 0;
+    for (int block = 0; block < 10; ++block) {
+        ASSERT_TRUE(mixer.MixBlock({{a, loud.data()}, {b, loud.data()}}, out.data(), 480));
+        for (int16_t s : out) {
+            peak = std::max(peak, static_cast<int>(s));
+            clipped += s == 32767 ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(0, clipped);
+    EXPECT_NEAR(32767 * 0.891, peak, 40);  // -1 dBFS ceiling
+
+    // Mix-minus outputs keep the plain clamp (and no delay)
+    std::vector<int16_t> minus(480);
+    ASSERT_TRUE(mixer.MixMinusBlock({{a, loud.data()}, {b, loud.data()}}, {{-1, minus.data()}},
+                                    480));
+    EXPECT_EQ(Block(480, 32767), minus);
+
+    mixer.DisableLimiter();
+    EXPECT_EQ(0u, mixer.GetLatencyFrames());
+    ASSERT_TRUE(mixer.MixBlock({{a, loud.data()}, {b, loud.data()}}, out.data(), 480));
+    EXPECT_EQ(Block(480, 32767), out);
+}
+
 // ============================================================================
 // Reset
 // ============================================================================
@@ -2,7 +2,8 @@
  * @file test_audio_processor.cpp
  * @brief Unit tests for the audio processing chain
  *
- * Covers VolumeNormalizer, HighPassFilter and AudioProcessorChain.
+ * Covers VolumeNormalizer, HighPassFilter and AudioProcessorChain, for the
+ * int16 and float sample paths.
  * These processors run inside the recording callback (apps/cli/main.cpp),
  * so their correctness directly affects every processed recording.
  */
@@ -371,3 +372,97 @@ TEST_F(AudioProcessorTest, Chain_AppliesProcessingEffect) {
     // The chained high-pass filter must actually run on the buffer.
     EXPECT_LT(Rms(samples), in_rms * 0.3);
 }
+
+// ============================================================================
+// Float processing
+// ============================================================================
+
+TEST_F(AudioProcessorTest, Float_HighPassFilterMatchesInt16) {
+    HighPassFilter int16_filter(80.0f);
+    HighPassFilter float_filter(80.0f);
+    ASSERT_TRUE(int16_filter.Initialize(48000, 1));
+    ASSERT_TRUE(float_filter.Initialize(48000, 1));
+
+    auto samples = SineWave(4800, 50.0, 48000, 8000.0);
+    std::vector<float> float_samples(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float_samples[i] = samples[i] / 32767.0f;
+    }
+
+    int16_filter.Process(samples.data(), samples.size());
+    float_filter.Process(float_samples.data(), float_samples.size());
+
+    // Same maths; the int16 path only adds truncation
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(samples[i], float_samples[i] * 32767.0f, 1.0f) << "sample " << i;
+    }
+}
+
+TEST_F(AudioProcessorTest, Float_VolumeNormalizerMatchesInt16) {
+    VolumeNormalizer int16_normalizer;
+    VolumeNormalizer float_normalizer;
+    ASSERT_TRUE(int16_normalizer.Initialize(48000, 2));
+    ASSERT_TRUE(float_normalizer.Initialize(48000, 2));
+
+    auto samples = SineWave(9600, 440.0, 48000, 1000.0);
+    std::vector<float> float_samples(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float_samples[i] = samples[i] / 32767.0f;
+    }
+
+    int16_normalizer.Process(samples.data(), samples.size());
+    float_normalizer.Process(float_samples.data(), float_samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(samples[i], float_samples[i] * 32767.0f, 1.0f) << "sample " << i;
+    }
+}
+
+TEST_F(AudioProcessorTest, Float_StagesKeepHeadroomAboveFullScale) {
+    // Quiet signal with one full-scale peak: the normalizer's gain pushes the
+    // peak past 1.0, which only the int16 path clips
+    VolumeNormalizer float_normalizer(0.5f, 0.0001f, 10.0f);
+    VolumeNormalizer int16_normalizer(0.5f, 0.0001f, 10.0f);
+    ASSERT_TRUE(float_normalizer.Initialize(48000, 1));
+    ASSERT_TRUE(int16_normalizer.Initialize(48000, 1));
+
+    std::vector<float> float_samples(4800, 0.02f);
+    float_samples.back() = 1.0f;
+    std::vector<int16_t> samples(4800, static_cast<int16_t>(0.02f * 32767.0f));
+    samples.back() = 32767;
+
+    float_normalizer.Process(float_samples.data(), float_samples.size());
+    int16_normalizer.Process(samples.data(), samples.size());
+
+    EXPECT_GT(float_samples.back(), 1.0f);
+    EXPECT_EQ(32767, samples.back());
+}
+
+TEST_F(AudioProcessorTest, Float_ChainRunsNativeStages) {
+    AudioProcessorChain chain;
+    chain.AddProcessor(std::make_unique<HighPassFilter>(80.0f));
+    ASSERT_TRUE(chain.Initialize(48000, 1));
+
+    std::vector<float> samples(4800, 0.25f);  // pure DC
+    chain.Process(samples.data(), samples.size());
+
+    EXPECT_LT(std::abs(samples.back()), 0.25f * 0.3f);
+}
+
+TEST_F(AudioProcessorTest, Float_Int16OnlyProcessorFallsBackThroughInt16) {
+    AudioProcessorChain chain;
+    auto p = std::make_unique<CountingProcessor>();
+    CountingProcessor* p_raw = p.get();
+    chain.AddProcessor(std::move(p));
+    ASSERT_TRUE(chain.Initialize(48000, 1));
+
+    std::vector<float> samples = {0.0f, 0.5f, -0.5f, 0.999f};
+    const std::vector<float> original = samples;
+    chain.Process(samples.data(), samples.size());
+
+    // The default float Process() round-trips through the int16 overload
+    EXPECT_EQ(1, p_raw->process_calls);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_NEAR(original[i], samples[i], 1.0f / 16384.0f) << "sample " << i;
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file test_batch_inputs.cpp
+ * @brief Unit tests for batch input discovery and output naming
+ */
+
+#include "utils/batch_inputs.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+std::string TempDir(const char* name) {
+    const fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir.string();
+}
+
+void Touch(const fs::path& path) {
+    std::ofstream(path, std::ios::binary) << "x";
+}
+
+}  // namespace
+
+TEST(BatchInputsTest, DirectoryYieldsSortedAudioFilesOnly) {
+    const fs::path dir = TempDir("ffvoice_batch_dir");
+    Touch(dir / "b.flac");
+    Touch(dir / "a.WAV");
+    Touch(dir / "notes.txt");
+    Touch(dir / "c.opus");
+    fs::create_directories(dir / "nested.wav");  // A directory, not a file
+
+    std::vector<std::string> files;
+    ASSERT_TRUE(CollectBatchInputs(dir.string(), files));
+    ASSERT_EQ(3u, files.size());
+    EXPECT_EQ((dir / "a.WAV").string(), files[0]);
+    EXPECT_EQ((dir / "b.flac").string(), files[1]);
+    EXPECT_EQ((dir / "c.opus").string(), files[2]);
+
+    files.clear();
+    EXPECT_FALSE(CollectBatchInputs((dir / "missing.list").string(), files));
+    EXPECT_TRUE(files.empty());
+    fs::remove_all(dir);
+}
+
+TEST(BatchInputsTest, ManifestSkipsCommentsAndBlankLinesAndTrims) {
+    const fs::path dir = TempDir("ffvoice_batch_manifest");
+    const fs::path manifest = dir / "inputs.list";
+    std::ofstream(manifest) << "# recordings\n"
+                               "  /data/one.wav  \r\n"
+                               "\n"
+                               "\t\n"
+                               "rel/two file.flac\n"
+                               "   # indented comment\n";
+
+    std::vector<std::string> files;
+    ASSERT_TRUE(CollectBatchInputs(manifest.string(), files));
+    ASSERT_EQ(2u, files.size());
+    EXPECT_EQ("/data/one.wav", files[0]);
+    EXPECT_EQ("rel/two file.flac", files[1]);
+    fs::remove_all(dir);
+}
+
+TEST(BatchInputsTest, CollidingOutputsKeepSourceExtensionOrFail) {
+    std::vector<std::string> outputs;
+    std::string error;
+
+    // Distinct names: plain replacement beside the input, or in output_dir
+    ASSERT_TRUE(PlanBatchOutputs({"in/a.wav", "in/b.wav"}, "", ".srt", outputs, error));
+    EXPECT_EQ((fs::path("in/a.srt")).string(), outputs[0]);
+    ASSERT_TRUE(PlanBatchOutputs({"in/a.wav", "in/b.wav"}, "subs", ".srt", outputs, error));
+    EXPECT_EQ((fs::path("subs") / "b.srt").string(), outputs[1]);
+
+    // Same stem: both keep their source extension, others are untouched
+    ASSERT_TRUE(
+        PlanBatchOutputs({"in/a.wav", "in/a.flac", "in/c.mp3"}, "", ".srt", outputs, error));
+    ASSERT_EQ(3u, outputs.size());
+    EXPECT_EQ(fs::path("in/a.wav.srt").string(), outputs[0]);
+    EXPECT_EQ(fs::path("in/a.flac.srt").string(), outputs[1]);
+    EXPECT_EQ(fs::path("in/c.srt").string(), outputs[2]);
+
+    // Equal names from different directories are fine beside their inputs...
+    ASSERT_TRUE(PlanBatchOutputs({"x/a.wav", "y/a.wav"}, "", ".txt", outputs, error));
+    EXPECT_NE(outputs[0], outputs[1]);
+
+    // ...but collide in one output directory
+    EXPECT_FALSE(PlanBatchOutputs({"x/a.wav", "y/a.wav"}, "subs", ".txt", outputs, error));
+    EXPECT_NE(std::string::npos, error.find("x/a.wav")) << error;
+    EXPECT_NE(std::string::npos, error.find("y/a.wav")) << error;
+    EXPECT_TRUE(outputs.empty());
+
+    // The same file listed twice, spelled differently
+    EXPECT_FALSE(PlanBatchOutputs({"in/a.wav", "./in/a.wav"}, "", ".srt", outputs, error));
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,233 @@
+/**
+ * @file test_biquad_cascade.cpp
+ * @brief Unit tests for BiquadCascade design and its wavefront SIMD kernel
+ */
+
+#include "audio/biquad_cascade.h"
+#include "audio/processor_chain.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kRate = 48000;
+
+std::vector<float> MakeSignal(size_t frames, int channels) {
+    std::vector<float> signal(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < channels; ++ch) {
+            const double t = static_cast<double>(i) / kRate;
+            // A low tone, a speech-band tone and a DC offset, different per channel
+            signal[i * channels + ch] = static_cast<float>(
+                0.4 * std::sin(2.0 * kPi * (30.0 + 10.0 * ch) * t) +
+                0.3 * std::sin(2.0 * kPi * (1000.0 + 250.0 * ch) * t) + 0.1 * (ch + 1));
+        }
+    }
+    return signal;
+}
+
+/// Section after section, channel by channel, with the same float coefficients
+std::vector<float> FilterReference(const std::vector<BiquadSection>& sections,
+                                   std::vector<float> data, int channels) {
+    for (const auto& section : sections) {
+        const BiquadCoefficients c = BiquadCascade::Design(section, kRate);
+        const auto b0 = static_cast<float>(c.b0), b1 = static_cast<float>(c.b1),
+                   b2 = static_cast<float>(c.b2), a1 = static_cast<float>(c.a1),
+                   a2 = static_cast<float>(c.a2);
+        for (int ch = 0; ch < channels; ++ch) {
+            float s1 = 0.0f;
+            float s2 = 0.0f;
+            for (size_t i = ch; i < data.size(); i += channels) {
+                const float x = data[i];
+                const float y = b0 * x + s1;
+                s1 = (b1 * x - a1 * y) + s2;
+                s2 = b2 * x - a2 * y;
+                data[i] = y;
+            }
+        }
+    }
+    return data;
+}
+
+double Rms(const std::vector<float>& samples, size_t from) {
+    double sum = 0.0;
+    for (size_t i = from; i < samples.size(); ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return std::sqrt(sum / static_cast<double>(samples.size() - from));
+}
+
+std::vector<float> Tone(double frequency, size_t frames) {
+    std::vector<float> tone(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        tone[i] = static_cast<float>(0.5 * std::sin(2.0 * kPi * frequency * i / kRate));
+    }
+    return tone;
+}
+
+}  // namespace
+
+TEST(BiquadCascadeTest, MatchesSerialCascadeForAnyBlockSize) {
+    const std::vector<BiquadSection> sections = {{BiquadType::HighPass, 80.0f, 0.5412f},
+                                                 {BiquadType::HighPass, 80.0f, 1.3066f},
+                                                 {BiquadType::Notch, 50.0f, 5.0f},
+                                                 {BiquadType::HighShelf, 4000.0f, 0.7071f, 3.0f},
+                                                 {BiquadType::LowPass, 7000.0f}};
+    for (int channels : {1, 2, 3}) {
+        const std::vector<float> input = MakeSignal(9600, channels);
+        const std::vector<float> expected = FilterReference(sections, input, channels);
+
+        BiquadCascade cascade(sections);
+        ASSERT_TRUE(cascade.Initialize(kRate, channels));
+        std::vector<float> output = input;
+        // Blocks shorter than the cascade exercise the fill / drain steps alone
+        const size_t blocks[] = {1, 2, 3, 7, 256, 480, 1000};
+        size_t frame = 0;
+        for (size_t b = 0; frame < 9600; ++b) {
+            const size_t frames = std::min(blocks[b % 7], 9600 - frame);
+            cascade.Process(output.data() + frame * channels, frames * channels);
+            frame += frames;
+        }
+        for (size_t i = 0; i < output.size(); ++i) {
+            ASSERT_NEAR(expected[i], output[i], 1e-5) << "channels " << channels << " at " << i;
+        }
+    }
+}
+
+TEST(BiquadCascadeTest, ButterworthDesign) {
+    const auto sections = BiquadCascade::ButterworthHighPass(80.0f, 4);
+    ASSERT_EQ(2u, sections.size());
+    EXPECT_NEAR(1.3066, sections[0].q, 1e-4);
+    EXPECT_NEAR(0.5412, sections[1].q, 1e-4);
+    EXPECT_TRUE(BiquadCascade::ButterworthHighPass(80.0f, 3).empty());
+    EXPECT_TRUE(BiquadCascade::ButterworthLowPass(8000.0f, 18).empty());
+
+    BiquadCascade hpf(sections);
+    ASSERT_TRUE(hpf.Initialize(kRate, 1));
+    EXPECT_NEAR(std::sqrt(0.5), hpf.GetMagnitudeResponse(80.0), 1e-3);  // -3 dB at cutoff
+    EXPECT_NEAR(1.0 / 256.0, hpf.GetMagnitudeResponse(20.0), 5e-4);     // 24 dB/octave
+    EXPECT_NEAR(1.0, hpf.GetMagnitudeResponse(1000.0), 1e-3);
+
+    BiquadCascade lpf(BiquadCascade::ButterworthLowPass(8000.0f, 8));
+    ASSERT_TRUE(lpf.Initialize(kRate, 1));
+    EXPECT_NEAR(1.0, lpf.GetMagnitudeResponse(1000.0), 1e-3);
+    EXPECT_LT(lpf.GetMagnitudeResponse(16000.0), 1e-2);  // Anti-aliasing for 48k -> 16k
+}
+
+TEST(BiquadCascadeTest, ShelfNotchAndPeakResponses) {
+    BiquadCascade eq({{BiquadType::Notch, 50.0f, 10.0f},
+                      {BiquadType::LowShelf, 200.0f, 0.7071f, -6.0f},
+                      {BiquadType::Peaking, 3000.0f, 2.0f, 6.0f}});
+    ASSERT_TRUE(eq.Initialize(kRate, 1));
+    EXPECT_LT(eq.GetMagnitudeResponse(50.0), 1e-3);
+    EXPECT_NEAR(std::pow(10.0, -6.0 / 20.0), eq.GetMagnitudeResponse(10.0), 0.02);
+    EXPECT_NEAR(std::pow(10.0, 6.0 / 20.0), eq.GetMagnitudeResponse(3000.0), 0.02);
+    EXPECT_NEAR(1.0, eq.GetMagnitudeResponse(15000.0), 0.02);
+}
+
+TEST(BiquadCascadeTest, SteeperThanFirstOrderHighPass) {
+    BiquadCascade cascade;  // 4th-order at 80 Hz
+    HighPassFilter first_order(80.0f);
+    ASSERT_TRUE(cascade.Initialize(kRate, 1));
+    ASSERT_TRUE(first_order.Initialize(kRate, 1));
+
+    std::vector<float> rumble = Tone(25.0, kRate);
+    std::vector<float> rumble_first = rumble;
+    cascade.Process(rumble.data(), rumble.size());
+    first_order.Process(rumble_first.data(), rumble_first.size());
+    EXPECT_LT(Rms(rumble, kRate / 2), 0.05 * Rms(rumble_first, kRate / 2));  // ~0.3^3
+
+    std::vector<float> speech = Tone(1000.0, kRate);
+    cascade.Process(speech.data(), speech.size());
+    EXPECT_NEAR(0.5 / std::sqrt(2.0), Rms(speech, kRate / 2), 0.005);
+}
+
+TEST(BiquadCascadeTest, Int16MatchesFloatAndClamps) {
+    BiquadCascade int16_cascade;
+    BiquadCascade float_cascade;
+    ASSERT_TRUE(int16_cascade.Initialize(kRate, 2));
+    ASSERT_TRUE(float_cascade.Initialize(kRate, 2));
+
+    const std::vector<float> signal = MakeSignal(4800, 2);
+    std::vector<int16_t> pcm(signal.size());
+    std::vector<float> floats(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(std::lrint(signal[i] * 32767.0f));
+        floats[i] = pcm[i] / 32767.0f;
+    }
+    int16_cascade.Process(pcm.data(), pcm.size());
+    float_cascade.Process(floats.data(), floats.size());
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        // Within a few LSB: Store() truncates, and float state rounding differs by scale
+        ASSERT_NEAR(floats[i] * 32767.0f, pcm[i], 4.0f) << i;
+    }
+
+    // +12 dB shelf on a full-scale tone must clamp, not wrap
+    BiquadCascade boost({{BiquadType::HighShelf, 1000.0f, 0.7071f, 12.0f}});
+    ASSERT_TRUE(boost.Initialize(kRate, 1));
+    std::vector<int16_t> loud(4800);
+    for (size_t i = 0; i < loud.size(); ++i) {
+        loud[i] = static_cast<int16_t>(30000.0 * std::sin(2.0 * kPi * 5000.0 * i / kRate));
+    }
+    boost.Process(loud.data(), loud.size());
+    int peak = 0;
+    for (int16_t s : loud) {
+        peak = std::max(peak, std::abs(static_cast<int>(s)));
+    }
+    EXPECT_EQ(32767, peak);
+}
+
+TEST(BiquadCascadeTest, ResetClearsState) {
+    BiquadCascade cascade;
+    ASSERT_TRUE(cascade.Initialize(kRate, 1));
+    std::vector<float> first = Tone(100.0, 2000);
+    std::vector<float> second = first;
+    cascade.Process(first.data(), first.size());
+    cascade.Reset();
+    cascade.Process(second.data(), second.size());
+    EXPECT_EQ(first, second);
+}
+
+TEST(BiquadCascadeTest, RejectsInvalidDesigns) {
+    EXPECT_FALSE(BiquadCascade(std::vector<BiquadSection>{}).Initialize(kRate, 1));
+    EXPECT_FALSE(BiquadCascade(BiquadCascade::ButterworthHighPass(80.0f, 5)).Initialize(kRate, 1));
+    EXPECT_FALSE(BiquadCascade({{BiquadType::LowPass, 30000.0f}}).Initialize(kRate, 1));
+    EXPECT_FALSE(BiquadCascade({{BiquadType::Notch, 50.0f, 0.0f}}).Initialize(kRate, 1));
+    EXPECT_FALSE(BiquadCascade().Initialize(kRate, 0));
+
+    // Processing before Initialize() leaves the samples alone
+    BiquadCascade uninitialized;
+    std::vector<float> samples(16, 0.5f);
+    uninitialized.Process(samples.data(), samples.size());
+    EXPECT_EQ(std::vector<float>(16, 0.5f), samples);
+}
+
+TEST(BiquadCascadeTest, RunsInsideProcessorChains) {
+    const std::vector<float> signal = MakeSignal(4800, 1);
+
+    auto chain = std::make_unique<AudioProcessorChain>();
+    chain->AddProcessor(std::make_unique<BiquadCascade>());
+    ASSERT_TRUE(chain->Initialize(kRate, 1));
+    std::vector<float> dynamic = signal;
+    chain->Process(dynamic.data(), dynamic.size());
+
+    ProcessorChain<BiquadCascade> fixed(BiquadCascade::ButterworthHighPass(80.0f, 4));
+    ASSERT_TRUE(fixed.Initialize(kRate, 1));
+    std::vector<float> fused = signal;
+    fixed.Process(fused.data(), fused.size());
+
+    // Sub-blocks change where the wavefront fills, not the result
+    for (size_t i = 0; i < signal.size(); ++i) {
+        ASSERT_NEAR(dynamic[i], fused[i], 1e-6f) << i;
+    }
+    EXPECT_LT(Rms(dynamic, 2400), Rms(signal, 2400));
+}
@@ -0,0 +1,222 @@
+/**
+ * @file test_broadcast_ring_buffer.cpp
+ * @brief Unit tests for the lock-free SPMC BroadcastRingBuffer
+ */
+
+#include "utils/broadcast_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace ffvoice;
+
+TEST(BroadcastRingBufferTest, ConstructionClampsArguments) {
+    BroadcastRingBuffer<int16_t> rb(0, 0);
+    EXPECT_EQ(rb.capacity(), 1u);
+    EXPECT_EQ(rb.max_consumers(), 1u);
+    EXPECT_EQ(rb.consumer_count(), 0u);
+}
+
+TEST(BroadcastRingBufferTest, AddAndRemoveConsumers) {
+    BroadcastRingBuffer<int16_t> rb(16, 2);
+    int a = rb.add_consumer();
+    int b = rb.add_consumer();
+    EXPECT_GE(a, 0);
+    EXPECT_GE(b, 0);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(rb.add_consumer(), -1);  // Full
+    EXPECT_EQ(rb.consumer_count(), 2u);
+
+    rb.remove_consumer(a);
+    EXPECT_EQ(rb.consumer_count(), 1u);
+    EXPECT_EQ(rb.add_consumer(), a);  // Slot is reused
+}
+
+TEST(BroadcastRingBufferTest, InvalidConsumerIdIsRejected) {
+    BroadcastRingBuffer<int16_t> rb(16, 2);
+    int16_t out[4];
+    EXPECT_EQ(rb.pop_bulk(-1, out, 4), 0u);
+    EXPECT_EQ(rb.pop_bulk(5, out, 4), 0u);
+    EXPECT_EQ(rb.pop_bulk(0, out, 4), 0u);  // Not attached
+    EXPECT_EQ(rb.available_read(0), 0u);
+    EXPECT_EQ(rb.overruns(0), 0u);
+}
+
+TEST(BroadcastRingBufferTest, EveryConsumerSeesEveryElement) {
+    BroadcastRingBuffer<int16_t> rb(32, 3);
+    int a = rb.add_consumer();
+    int b = rb.add_consumer();
+
+    std::vector<int16_t> data = {1, 2, 3, 4, 5};
+    EXPECT_EQ(rb.push_bulk(data.data(), data.size()), data.size());
+    EXPECT_EQ(rb.available_read(a), 5u);
+    EXPECT_EQ(rb.available_read(b), 5u);
+
+    std::vector<int16_t> out_a(5), out_b(5);
+    EXPECT_EQ(rb.pop_bulk(a, out_a.data(), 5), 5u);
+    EXPECT_EQ(out_a, data);
+    EXPECT_EQ(rb.available_read(a), 0u);
+
+    // b is independent of a
+    EXPECT_EQ(rb.available_read(b), 5u);
+    EXPECT_EQ(rb.pop_bulk(b, out_b.data(), 2), 2u);
+    EXPECT_EQ(out_b[0], 1);
+    EXPECT_EQ(out_b[1], 2);
+    EXPECT_EQ(rb.available_read(b), 3u);
+}
+
+TEST(BroadcastRingBufferTest, LateConsumerStartsAtWritePosition) {
+    BroadcastRingBuffer<int16_t> rb(32, 2);
+    std::vector<int16_t> data(10, 7);
+    rb.push_bulk(data.data(), data.size());
+
+    int late = rb.add_consumer();
+    EXPECT_EQ(rb.available_read(late), 0u);
+
+    rb.push(9);
+    int16_t v = 0;
+    EXPECT_EQ(rb.pop_bulk(late, &v, 1), 1u);
+    EXPECT_EQ(v, 9);
+}
+
+TEST(BroadcastRingBufferTest, WrapAroundPreservesOrder) {
+    BroadcastRingBuffer<int> rb(8, 1);
+    int id = rb.add_consumer();
+
+    int next_in = 0;
+    int next_out = 0;
+    for (int round = 0; round < 20; ++round) {
+        std::vector<int> in(5);
+        for (auto& x : in) {
+            x = next_in++;
+        }
+        rb.push_bulk(in.data(), in.size());
+
+        std::vector<int> out(5);
+        ASSERT_EQ(rb.pop_bulk(id, out.data(), out.size()), 5u);
+        for (int x : out) {
+            EXPECT_EQ(x, next_out++);
+        }
+    }
+    EXPECT_EQ(rb.overruns(id), 0u);
+}
+
+TEST(BroadcastRingBufferTest, SlowConsumerIsOverrunWithoutAffectingOthers) {
+    BroadcastRingBuffer<int> rb(8, 2);
+    int fast = rb.add_consumer();
+    int slow = rb.add_consumer();
+
+    std::vector<int> out(8);
+    for (int i = 0; i < 20; ++i) {
+        rb.push(i);
+        ASSERT_EQ(rb.pop_bulk(fast, out.data(), 1), 1u);
+        EXPECT_EQ(out[0], i);
+    }
+    EXPECT_EQ(rb.overruns(fast), 0u);
+
+    // slow never read: only the last 8 elements survive
+    EXPECT_EQ(rb.available_read(slow), 8u);
+    EXPECT_EQ(rb.pop_bulk(slow, out.data(), out.size()), 8u);
+    EXPECT_EQ(rb.overruns(slow), 12u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i], 12 + i);
+    }
+}
+
+TEST(BroadcastRingBufferTest, PushLargerThanCapacityKeepsTail) {
+    BroadcastRingBuffer<int> rb(4, 1);
+    int id = rb.add_consumer();
+
+    std::vector<int> in(10);
+    std::iota(in.begin(), in.end(), 0);
+    EXPECT_EQ(rb.push_bulk(in.data(), in.size()), in.size());
+    EXPECT_EQ(rb.total_pushed(), 10u);
+
+    std::vector<int> out(4);
+    EXPECT_EQ(rb.pop_bulk(id, out.data(), out.size()), 4u);
+    EXPECT_EQ(out, (std::vector<int>{6, 7, 8, 9}));
+    EXPECT_EQ(rb.overruns(id), 6u);
+}
+
+TEST(BroadcastRingBufferTest, ClearResetsCursors) {
+    BroadcastRingBuffer<int> rb(4, 1);
+    int id = rb.add_consumer();
+    std::vector<int> in(10, 1);
+    rb.push_bulk(in.data(), in.size());
+    int v;
+    rb.pop_bulk(id, &v, 1);
+
+    rb.clear();
+    EXPECT_EQ(rb.available_read(id), 0u);
+    EXPECT_EQ(rb.overruns(id), 0u);
+    EXPECT_EQ(rb.total_pushed(), 0u);
+}
+
+// ============================================================================
+// Concurrency: each consumer receives a gap-free, in-order subsequence, and
+// every element it did not receive is accounted for by its overrun counter.
+// ============================================================================
+
+TEST(BroadcastRingBufferTest, ConcurrentConsumersAccountForEveryElement) {
+    constexpr size_t kTotal = 200000;
+    constexpr int kConsumers = 3;
+    BroadcastRingBuffer<uint32_t> rb(1024, kConsumers);
+
+    std::vector<int> ids;
+    for (int c = 0; c < kConsumers; ++c) {
+        ids.push_back(rb.add_consumer());
+    }
+
+    std::atomic<bool> done{false};
+    std::vector<size_t> received(kConsumers, 0);
+    std::vector<bool> ordered(kConsumers, true);
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            std::vector<uint32_t> out(64 * (c + 1));
+            int64_t last = -1;
+            auto drain_once = [&]() {
+                size_t n = rb.pop_bulk(ids[c], out.data(), out.size());
+                for (size_t i = 0; i < n; ++i) {
+                    if (static_cast<int64_t>(out[i]) <= last) {
+                        ordered[c] = false;
+                    }
+                    last = out[i];
+                }
+                received[c] += n;
+                return n;
+            };
+            while (!done.load(std::memory_order_acquire)) {
+                if (drain_once() == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            while (drain_once() > 0) {
+            }
+        });
+    }
+
+    std::vector<uint32_t> block(100);
+    for (size_t i = 0; i < kTotal; i += block.size()) {
+        for (size_t j = 0; j < block.size(); ++j) {
+            block[j] = static_cast<uint32_t>(i + j);
+        }
+        rb.push_bulk(block.data(), block.size());
+    }
+    done.store(true, std::memory_order_release);
+
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    for (int c = 0; c < kConsumers; ++c) {
+        EXPECT_TRUE(ordered[c]) << "consumer " << c;
+        EXPECT_EQ(received[c] + rb.overruns(ids[c]), kTotal) << "consumer " << c;
+    }
+}
@@ -0,0 +1,188 @@
+/**
+ * @file test_caption_event_queue.cpp
+ * @brief Unit tests for CaptionEventQueue and its LiveCaptioner hookup
+ * @note Only compiled when ENABLE_WHISPER is defined
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/caption_event_queue.h"
+
+    #include <gtest/gtest.h>
+
+    #include <chrono>
+    #include <memory>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+    #ifndef _WIN32
+        #include <poll.h>
+    #endif
+
+using namespace ffvoice;
+
+namespace {
+
+CaptionEvent MakeEvent(uint32_t id, CaptionEventType type = CaptionEventType::Partial) {
+    CaptionEvent ev;
+    ev.type = type;
+    ev.utterance_id = id;
+    ev.text = "utterance " + std::to_string(id);
+    return ev;
+}
+
+    #ifndef _WIN32
+bool IsReadable(int fd) {
+    pollfd pfd{fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+    #endif
+
+}  // namespace
+
+TEST(CaptionEventQueueTest, PopsInPushOrder) {
+    CaptionEventQueue queue(8);
+    for (uint32_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.Push(MakeEvent(i)));
+    }
+    CaptionEvent ev;
+    for (uint32_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue.Pop(ev));
+        EXPECT_EQ(i, ev.utterance_id);
+        EXPECT_EQ("utterance " + std::to_string(i), ev.text);
+    }
+    EXPECT_FALSE(queue.Pop(ev));
+}
+
+TEST(CaptionEventQueueTest, FullQueueDropsNewEvents) {
+    CaptionEventQueue queue(4);
+    for (uint32_t i = 0; i < 6; ++i) {
+        queue.Push(MakeEvent(i));
+    }
+    EXPECT_EQ(2u, queue.GetDroppedEvents());
+
+    CaptionEvent ev;
+    ASSERT_TRUE(queue.Pop(ev));
+    EXPECT_EQ(0u, ev.utterance_id);
+    EXPECT_TRUE(queue.Push(MakeEvent(9)));  // Space again after a pop
+}
+
+TEST(CaptionEventQueueTest, ReadyFdFollowsEvents) {
+    CaptionEventQueue queue;
+    #ifdef _WIN32
+    EXPECT_EQ(-1, queue.GetReadyFd());
+    #else
+    const int fd = queue.GetReadyFd();
+    ASSERT_GE(fd, 0);
+    EXPECT_FALSE(IsReadable(fd));
+
+    queue.Push(MakeEvent(1));
+    queue.Push(MakeEvent(2));
+    EXPECT_TRUE(IsReadable(fd));
+
+    queue.ClearReady();
+    EXPECT_FALSE(IsReadable(fd));
+    CaptionEvent ev;
+    EXPECT_TRUE(queue.Pop(ev));
+    EXPECT_TRUE(queue.Pop(ev));
+
+    queue.Close();
+    EXPECT_TRUE(IsReadable(fd));
+    EXPECT_FALSE(queue.Push(MakeEvent(3)));
+    #endif
+}
+
+TEST(CaptionEventQueueTest, WaitForEventWakesOnPushAndClose) {
+    CaptionEventQueue queue;
+    EXPECT_FALSE(queue.WaitForEvent(10));  // Times out
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue.Push(MakeEvent(7));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue.Close();
+    });
+    EXPECT_TRUE(queue.WaitForEvent(-1));
+    CaptionEvent ev;
+    ASSERT_TRUE(queue.Pop(ev));
+    EXPECT_EQ(7u, ev.utterance_id);
+
+    EXPECT_FALSE(queue.WaitForEvent(-1));  // Returns on Close() with nothing queued
+    EXPECT_TRUE(queue.IsClosed());
+    producer.join();
+}
+
+TEST(CaptionEventQueueTest, ConcurrentProducersLoseNothing) {
+    CaptionEventQueue queue(1024);
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < 4; ++t) {
+        producers.emplace_back([&queue, t]() {
+            for (uint32_t i = 0; i < 200; ++i) {
+                queue.Push(MakeEvent(t * 1000 + i));
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(4, 0);
+    size_t received = 0;
+    CaptionEvent ev;
+    while (received < 800) {
+        if (!queue.WaitForEvent(1000)) {
+            break;
+        }
+        while (queue.Pop(ev)) {
+            const uint32_t t = ev.utterance_id / 1000;
+            EXPECT_EQ(next[t]++, ev.utterance_id % 1000);  // Per-producer order kept
+            ++received;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(800u, received);
+    EXPECT_EQ(0u, queue.GetDroppedEvents());
+}
+
+TEST(CaptionEventQueueTest, LiveCaptionerQueuesEventsAndClosesOnStop) {
+    LiveCaptionerConfig cfg;
+    cfg.vad.speech_threshold = 0.5f;
+    cfg.vad.min_speech_frames = 2;
+    cfg.vad.min_silence_frames = 2;
+    cfg.suppress_whisper_progress = true;
+    cfg.transcribe_fn = [](const int16_t*, size_t, std::vector<TranscriptionSegment>& out) {
+        out.clear();
+        out.emplace_back(0LL, 500LL, "queued", 0.9f);
+        return true;
+    };
+
+    auto queue = std::make_shared<CaptionEventQueue>();
+    LiveCaptioner captioner(cfg);
+    captioner.SetEventQueue(queue);  // No callback: events only reach the queue
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    const std::vector<int16_t> speech(4800, 10000);
+    const std::vector<int16_t> silence(4800, 0);
+    for (int i = 0; i < 4; ++i) {
+        captioner.FeedAudio(speech.data(), speech.size());
+    }
+    for (int i = 0; i < 4; ++i) {
+        captioner.FeedAudio(silence.data(), silence.size());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    captioner.Stop();
+    EXPECT_TRUE(queue->IsClosed());
+
+    bool got_final = false;
+    CaptionEvent ev;
+    while (queue->Pop(ev)) {
+        if (ev.type == CaptionEventType::Final) {
+            got_final = true;
+            EXPECT_EQ("queued", ev.text);
+        }
+    }
+    EXPECT_TRUE(got_final);
+}
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,228 @@
+/**
+ * @file test_caption_server.cpp
+ * @brief Unit tests for CaptionServer over real sockets (via the scheduler test seam)
+ * @note Only compiled when ENABLE_WHISPER is defined, and only on POSIX
+ */
+
+#if defined(ENABLE_WHISPER) && !defined(_WIN32)
+
+    #include "audio/caption_server.h"
+
+    #include <gtest/gtest.h>
+
+    #include <chrono>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+    #include <netdb.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+
+using namespace ffvoice;
+
+namespace {
+
+CaptionServerConfig MakeServerConfig(const std::string& listen) {
+    CaptionServerConfig cfg;
+    cfg.listen = listen;
+    cfg.scheduler.num_workers = 2;
+    cfg.scheduler.threads_per_worker = 1;
+    cfg.scheduler.transcribe_fn = [](const int16_t*, size_t,
+                                     std::vector<TranscriptionSegment>& out) {
+        out.clear();
+        out.emplace_back(0LL, 100LL, "ok", 0.8f);
+        return true;
+    };
+    cfg.session.sample_rate = 16000;
+    cfg.session.vad_prob_source = []() { return 0.9f; };  // All speech: Stop() flushes a Final
+    cfg.session.vad.min_speech_frames = 2;
+    cfg.session.min_samples_for_partial = 16000000;  // Finals only
+    return cfg;
+}
+
+/// Connect to "unix:PATH" or "host:port"; -1 on failure
+int Connect(const std::string& address) {
+    if (address.rfind("unix:", 0) == 0) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        const std::string path = address.substr(5);
+        path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        return -1;
+    }
+
+    const size_t colon = address.rfind(':');
+    addrinfo hints{};
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(address.substr(0, colon).c_str(), address.substr(colon + 1).c_str(), &hints,
+                    &result) != 0) {
+        return -1;
+    }
+    int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd >= 0 && connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    return fd;
+}
+
+bool SendAll(int fd, const std::vector<int16_t>& samples) {
+    const char* data = reinterpret_cast<const char*>(samples.data());
+    size_t left = samples.size() * sizeof(int16_t);
+    while (left > 0) {
+        const ssize_t sent = send(fd, data, left, 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        left -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/// Read until the server closes the connection, @p until appears, or the timeout passes
+std::string Receive(int fd, const std::string& until = "", int timeout_ms = 5000) {
+    std::string text;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (!until.empty() && text.find(until) != std::string::npos) {
+            break;
+        }
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 50) <= 0) {
+            continue;
+        }
+        char buffer[4096];
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        text.append(buffer, static_cast<size_t>(n));
+    }
+    return text;
+}
+
+/// One complete session: stream @p samples, end the stream, collect every line
+std::string StreamSession(const std::string& address, const std::vector<int16_t>& samples) {
+    const int fd = Connect(address);
+    if (fd < 0) {
+        return "connect failed";
+    }
+    // Wait for the session so the audio is not still queued behind accept()
+    std::string text = Receive(fd, "session_start");
+    SendAll(fd, samples);
+    shutdown(fd, SHUT_WR);
+    text += Receive(fd);
+    close(fd);
+    return text;
+}
+
+}  // namespace
+
+TEST(CaptionServerTest, UnixSocketSessionReturnsCaptionLines) {
+    const std::string path = "/tmp/ffvoice_caption_server_" + std::to_string(getpid()) + ".sock";
+    CaptionServer server(MakeServerConfig("unix:" + path));
+    ASSERT_TRUE(server.Start()) << server.GetLastError();
+    std::thread loop([&]() { EXPECT_TRUE(server.Run()); });
+
+    const std::string text = StreamSession("unix:" + path, std::vector<int16_t>(8000, 10000));
+    EXPECT_NE(std::string::npos,
+              text.find("{\"event\":\"session_start\",\"session\":1,\"sample_rate\":16000,"
+                        "\"channels\":1}\n"))
+        << text;
+    EXPECT_NE(std::string::npos, text.find("\"type\":\"final\",\"utterance_id\":")) << text;
+    EXPECT_NE(std::string::npos, text.find("\"text\":\"ok\"")) << text;
+    EXPECT_NE(std::string::npos,
+              text.find("{\"event\":\"session_end\",\"session\":1,\"dropped_samples\":0,"
+                        "\"dropped_events\":0}\n"))
+        << text;
+
+    server.RequestStop();
+    loop.join();
+    EXPECT_EQ(16000u, server.GetStats().bytes_received);
+    EXPECT_EQ(0u, server.GetStats().active_sessions);
+    EXPECT_NE(0, access(path.c_str(), F_OK)) << "socket file must be removed on shutdown";
+}
+
+TEST(CaptionServerTest, ConcurrentTcpSessionsShareOneScheduler) {
+    CaptionServer server(MakeServerConfig("127.0.0.1:0"));
+    ASSERT_TRUE(server.Start()) << server.GetLastError();
+    const std::string address = server.GetBoundAddress();
+    ASSERT_NE("127.0.0.1:0", address);
+    std::thread loop([&]() { EXPECT_TRUE(server.Run()); });
+
+    constexpr int kClients = 4;
+    std::vector<std::string> results(kClients);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < kClients; ++i) {
+        clients.emplace_back([&, i]() {
+            results[i] = StreamSession(address, std::vector<int16_t>(4800 * (i + 1), 10000));
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    for (const auto& text : results) {
+        EXPECT_NE(std::string::npos, text.find("\"text\":\"ok\"")) << text;
+        EXPECT_NE(std::string::npos, text.find("\"event\":\"session_end\"")) << text;
+    }
+
+    const CaptionServerStats stats = server.GetStats();
+    EXPECT_EQ(static_cast<uint64_t>(kClients), stats.sessions_accepted);
+    EXPECT_EQ(0u, stats.dropped_samples);
+    server.RequestStop();
+    loop.join();
+}
+
+TEST(CaptionServerTest, RefusesExtraSessionsAndDropsAudioOnOverrun) {
+    CaptionServerConfig cfg = MakeServerConfig("127.0.0.1:0");
+    cfg.max_sessions = 1;
+    cfg.session.ring_buffer_capacity = 256;  // Far less than one socket read
+    CaptionServer server(cfg);
+    ASSERT_TRUE(server.Start()) << server.GetLastError();
+    std::thread loop([&]() { EXPECT_TRUE(server.Run()); });
+
+    const int first = Connect(server.GetBoundAddress());
+    ASSERT_GE(first, 0);
+    ASSERT_NE(std::string::npos, Receive(first, "session_start").find("session_start"));
+
+    const int second = Connect(server.GetBoundAddress());
+    ASSERT_GE(second, 0);
+    EXPECT_NE(std::string::npos, Receive(second).find("{\"event\":\"error\""));
+    close(second);
+
+    ASSERT_TRUE(SendAll(first, std::vector<int16_t>(32000, 10000)));
+    shutdown(first, SHUT_WR);
+    const std::string text = Receive(first);
+    close(first);
+    EXPECT_NE(std::string::npos, text.find("\"event\":\"session_end\"")) << text;
+    EXPECT_EQ(std::string::npos, text.find("\"dropped_samples\":0,")) << text;
+
+    const CaptionServerStats stats = server.GetStats();
+    EXPECT_EQ(1u, stats.sessions_accepted);
+    EXPECT_EQ(1u, stats.sessions_refused);
+    EXPECT_GT(stats.dropped_samples, 0u);
+    EXPECT_EQ(64000u, stats.bytes_received);
+    server.RequestStop();
+    loop.join();
+}
+
+TEST(CaptionServerTest, StartRejectsBadAddresses) {
+    for (const char* address : {"unix:", "127.0.0.1:not-a-port", "127.0.0.1:"}) {
+        CaptionServer server(MakeServerConfig(address));
+        EXPECT_FALSE(server.Start()) << address;
+        EXPECT_FALSE(server.GetLastError().empty()) << address;
+        EXPECT_FALSE(server.Run());  // Not started
+    }
+}
+
+#endif  // ENABLE_WHISPER && !_WIN32
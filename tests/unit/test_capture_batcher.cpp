@@ -0,0 +1,112 @@
+/**
+ * @file test_capture_batcher.cpp
+ * @brief Unit tests for CaptureBatcher
+ */
+
+#include "audio/capture_batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+CaptureBatcherConfig MakeConfig(size_t capacity, size_t batch) {
+    CaptureBatcherConfig config;
+    config.capacity_samples = capacity;
+    config.batch_samples = batch;
+    return config;
+}
+
+}  // namespace
+
+TEST(CaptureBatcherTest, DrainerDeliversFixedBatchesThenTail) {
+    CaptureBatcher batcher(MakeConfig(1024, 100));
+    std::mutex mutex;
+    std::vector<size_t> sizes;
+    std::vector<int16_t> received;
+    ASSERT_TRUE(batcher.StartDrainer([&](const int16_t* samples, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sizes.push_back(n);
+        received.insert(received.end(), samples, samples + n);
+    }));
+    EXPECT_FALSE(batcher.StartDrainer([](const int16_t*, size_t) {}));
+
+    // Capture-callback sized blocks that do not line up with the batch size
+    std::vector<int16_t> input(1250);
+    std::iota(input.begin(), input.end(), 0);
+    for (size_t pos = 0; pos < input.size(); pos += 250) {
+        batcher.Push(input.data() + pos, 250);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    batcher.Stop();
+
+    EXPECT_EQ(input, received);
+    ASSERT_FALSE(sizes.empty());
+    for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+        EXPECT_EQ(100u, sizes[i]);
+    }
+    EXPECT_EQ(0u, batcher.GetDroppedSamples());
+}
+
+TEST(CaptureBatcherTest, FullRingDropsAndCounts) {
+    CaptureBatcher batcher(MakeConfig(256, 64));
+    std::vector<int16_t> block(200, 7);
+    batcher.Push(block.data(), block.size());
+    batcher.Push(block.data(), block.size());
+
+    EXPECT_EQ(256u, batcher.GetAvailableSamples());
+    EXPECT_EQ(144u, batcher.GetDroppedSamples());
+}
+
+TEST(CaptureBatcherTest, ReadWaitsForRequestedSamples) {
+    CaptureBatcher batcher(MakeConfig(1024, 64));
+    std::thread producer([&]() {
+        std::vector<int16_t> block(64, 1);
+        for (int i = 0; i < 8; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            batcher.Push(block.data(), block.size());
+        }
+    });
+
+    std::vector<int16_t> out(512);
+    EXPECT_EQ(512u, batcher.Read(out.data(), out.size()));
+    producer.join();
+}
+
+TEST(CaptureBatcherTest, ReadTimesOutWithPartialData) {
+    CaptureBatcher batcher(MakeConfig(1024, 64));
+    std::vector<int16_t> block(100, 3);
+    batcher.Push(block.data(), block.size());
+
+    std::vector<int16_t> out(500);
+    EXPECT_EQ(0u, batcher.Read(out.data(), 0, 10));
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(100u, batcher.Read(out.data(), out.size(), 20));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    // Zero timeout returns at once
+    batcher.Push(block.data(), 10);
+    EXPECT_EQ(10u, batcher.Read(out.data(), out.size(), 0));
+}
+
+TEST(CaptureBatcherTest, StopReleasesBlockedReader) {
+    CaptureBatcher batcher(MakeConfig(1024, 64));
+    size_t got = 1;
+    std::thread reader([&]() {
+        std::vector<int16_t> out(256);
+        got = batcher.Read(out.data(), out.size());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    batcher.Stop();
+    reader.join();
+    EXPECT_EQ(0u, got);
+}
@@ -0,0 +1,210 @@
+/**
+ * @file test_chunked_transcriber.cpp
+ * @brief Unit tests for ChunkedTranscriber (via the transcribe_fn test seam)
+ * @note Only compiled when ENABLE_WHISPER is defined
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/chunked_transcriber.h"
+    #include "media/wav_writer.h"
+
+    #include <gtest/gtest.h>
+
+    #include <algorithm>
+    #include <chrono>
+    #include <cmath>
+    #include <cstdio>
+    #include <cstdlib>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr int kRate = 16000;
+
+// 1 kHz tone bursts at the given amplitudes: burst i covers [1 + 3i, 3 + 3i) s,
+// with silence in between and one second of silence at the end
+std::vector<float> Bursts(const std::vector<float>& amplitudes) {
+    std::vector<float> pcm(static_cast<size_t>(kRate) * (3 * amplitudes.size() + 1), 0.0f);
+    for (size_t b = 0; b < amplitudes.size(); ++b) {
+        const size_t begin = static_cast<size_t>(kRate) * (1 + 3 * b);
+        for (size_t i = 0; i < 2 * static_cast<size_t>(kRate); ++i) {
+            pcm[begin + i] = amplitudes[b] * std::sin(2.0 * 3.14159265358979 * 1000.0 * i / kRate);
+        }
+    }
+    return pcm;
+}
+
+// Seam that names each chunk after its loudest sample and returns one segment
+// covering the whole chunk (chunk-relative time, as whisper.cpp reports it)
+ChunkedTranscriberConfig MakeConfig(size_t workers = 1) {
+    ChunkedTranscriberConfig cfg;
+    cfg.num_workers = workers;
+    cfg.threads_per_worker = 1;
+    cfg.transcribe_fn = [](const int16_t* samples, size_t count,
+                           std::vector<TranscriptionSegment>& out) {
+        int peak = 0;
+        for (size_t i = 0; i < count; ++i) {
+            peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+        }
+        out.clear();
+        out.emplace_back(0LL, static_cast<int64_t>(count) * 1000 / kRate,
+                         std::to_string((peak + 1638) / 3277), 0.9f);  // 0.1 steps
+        return true;
+    };
+    return cfg;
+}
+
+}  // namespace
+
+TEST(ChunkedTranscriberTest, CutsOnSilenceAndShiftsTimestamps) {
+    ChunkedTranscriber transcriber(MakeConfig());
+    ASSERT_TRUE(transcriber.Initialize());
+
+    const std::vector<float> pcm = Bursts({0.3f, 0.5f, 0.7f});
+    std::vector<TranscriptionSegment> segments;
+    ASSERT_TRUE(transcriber.TranscribePcm(pcm.data(), pcm.size(), [&](const auto& chunk) {
+        segments.insert(segments.end(), chunk.begin(), chunk.end());
+    }));
+
+    ASSERT_EQ(segments.size(), 3u);
+    const char* names[] = {"3", "5", "7"};
+    for (size_t i = 0; i < segments.size(); ++i) {
+        EXPECT_EQ(segments[i].text, names[i]);
+        // Starts one overlap before the burst (plus VAD onset), ends after the hangover
+        const int64_t burst_start = 1000 + 3000 * static_cast<int64_t>(i);
+        EXPECT_NEAR(segments[i].start_ms, burst_start - 1000, 400) << "segment " << i;
+        EXPECT_NEAR(segments[i].end_ms, burst_start + 2000 + 500, 100) << "segment " << i;
+    }
+
+    const ChunkedTranscriptionStats& stats = transcriber.GetLastStats();
+    EXPECT_EQ(stats.chunks, 3u);
+    EXPECT_EQ(stats.segments, 3u);
+    EXPECT_DOUBLE_EQ(stats.audio_duration_s, static_cast<double>(pcm.size()) / kRate);
+    // Silence between utterances is never sent to Whisper
+    EXPECT_LT(stats.decoded_duration_s, stats.audio_duration_s);
+}
+
+TEST(ChunkedTranscriberTest, OutputOrderDoesNotDependOnDecodeTiming) {
+    ChunkedTranscriberConfig cfg = MakeConfig(3);
+    auto name_chunk = cfg.transcribe_fn;
+    // Earlier chunks take longer, so they finish last
+    cfg.transcribe_fn = [name_chunk](const int16_t* samples, size_t count,
+                                     std::vector<TranscriptionSegment>& out) {
+        name_chunk(samples, count, out);
+        const int delay_ms = out[0].text == "3" ? 60 : out[0].text == "5" ? 30 : 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+        return true;
+    };
+    ChunkedTranscriber transcriber(cfg);
+    ASSERT_TRUE(transcriber.Initialize());
+
+    const std::vector<float> pcm = Bursts({0.3f, 0.5f, 0.7f});
+    std::vector<std::string> texts;
+    ASSERT_TRUE(transcriber.TranscribePcm(pcm.data(), pcm.size(), [&](const auto& chunk) {
+        for (const auto& segment : chunk) {
+            texts.push_back(segment.text);
+        }
+    }));
+    EXPECT_EQ(texts, (std::vector<std::string>{"3", "5", "7"}));
+}
+
+TEST(ChunkedTranscriberTest, ForcedCutsDropSegmentsInsideTheOverlap) {
+    ChunkedTranscriberConfig cfg = MakeConfig();
+    cfg.max_chunk_ms = 5000;
+    // Two segments per chunk: the overlap second, then the rest
+    cfg.transcribe_fn = [](const int16_t*, size_t count, std::vector<TranscriptionSegment>& out) {
+        const int64_t length_ms = static_cast<int64_t>(count) * 1000 / kRate;
+        out.clear();
+        out.emplace_back(0LL, 1000LL, "overlap", 0.9f);
+        out.emplace_back(1000LL, length_ms, "body", 0.9f);
+        return true;
+    };
+    ChunkedTranscriber transcriber(cfg);
+    ASSERT_TRUE(transcriber.Initialize());
+
+    // 12 s of continuous tone: cut every 5 s of speech
+    std::vector<float> pcm(12 * kRate);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = 0.5f * std::sin(2.0 * 3.14159265358979 * 440.0 * i / kRate);
+    }
+    std::vector<TranscriptionSegment> segments;
+    ASSERT_TRUE(transcriber.TranscribePcm(pcm.data(), pcm.size(), [&](const auto& chunk) {
+        segments.insert(segments.end(), chunk.begin(), chunk.end());
+    }));
+
+    ASSERT_GE(transcriber.GetLastStats().chunks, 3u);
+    // Only the first chunk's overlap segment is new audio; later ones are repeats
+    ASSERT_GE(segments.size(), 2u);
+    EXPECT_EQ(segments[0].text, "overlap");
+    for (size_t i = 1; i < segments.size(); ++i) {
+        EXPECT_EQ(segments[i].text, "body") << "segment " << i;
+        EXPECT_GE(segments[i].start_ms, segments[i - 1].start_ms);
+    }
+}
+
+TEST(ChunkedTranscriberTest, WavFileIsStreamedThroughTheSameChunks) {
+    const std::vector<float> pcm = Bursts({0.3f, 0.6f});
+    const std::string path = ::testing::TempDir() + "test_chunked_transcriber.wav";
+    {
+        // 48 kHz stereo: the reader converts it while streaming
+        std::vector<int16_t> stereo(pcm.size() * 3 * 2);
+        for (size_t i = 0; i < pcm.size() * 3; ++i) {
+            const float s = pcm[i / 3];
+            stereo[2 * i] = static_cast<int16_t>(s * 32767.0f);
+            stereo[2 * i + 1] = static_cast<int16_t>(s * 32767.0f);
+        }
+        WavWriter writer;
+        ASSERT_TRUE(writer.Open(path, 48000, 2));
+        writer.WriteSamples(stereo);
+        writer.Close();
+    }
+
+    ChunkedTranscriber transcriber(MakeConfig(2));
+    ASSERT_TRUE(transcriber.Initialize());
+    std::vector<TranscriptionSegment> segments;
+    ASSERT_TRUE(transcriber.TranscribeFile(path, segments)) << transcriber.GetLastError();
+    std::remove(path.c_str());
+
+    ASSERT_EQ(segments.size(), 2u);
+    EXPECT_EQ(segments[0].text, "3");
+    EXPECT_EQ(segments[1].text, "6");
+    EXPECT_NEAR(segments[1].start_ms, 3000, 400);
+    EXPECT_NEAR(transcriber.GetLastStats().audio_duration_s, 7.0, 0.01);
+}
+
+TEST(ChunkedTranscriberTest, FailedChunkFailsTheRun) {
+    ChunkedTranscriberConfig cfg = MakeConfig();
+    cfg.transcribe_fn = [](const int16_t*, size_t, std::vector<TranscriptionSegment>&) {
+        return false;
+    };
+    ChunkedTranscriber transcriber(cfg);
+    ASSERT_TRUE(transcriber.Initialize());
+
+    const std::vector<float> pcm = Bursts({0.5f});
+    EXPECT_FALSE(transcriber.TranscribePcm(pcm.data(), pcm.size(), [](const auto&) {}));
+    EXPECT_FALSE(transcriber.GetLastError().empty());
+}
+
+TEST(ChunkedTranscriberTest, RequiresInitializeAndARunningSharedScheduler) {
+    ChunkedTranscriber transcriber(MakeConfig());
+    const std::vector<float> pcm(kRate, 0.0f);
+    EXPECT_FALSE(transcriber.TranscribePcm(pcm.data(), pcm.size(), [](const auto&) {}));
+
+    InferenceSchedulerConfig scheduler_cfg;
+    scheduler_cfg.transcribe_fn = MakeConfig().transcribe_fn;
+    InferenceScheduler scheduler(scheduler_cfg);
+
+    ChunkedTranscriberConfig cfg;
+    cfg.scheduler = &scheduler;
+    ChunkedTranscriber shared(cfg);
+    EXPECT_FALSE(shared.Initialize());
+    ASSERT_TRUE(scheduler.Start());
+    EXPECT_TRUE(shared.Initialize());
+}
+
+#endif  // ENABLE_WHISPER
@@ -1,14 +1,19 @@
 /**
  * @file test_diarizer.cpp
- * @brief Unit tests for the Diarizer class and MergeIntoSegments
- * @note MergeIntoSegments tests always run; Diarizer tests (via the
- *       diarize_fn seam) are only compiled when ENABLE_DIARIZATION is defined.
+ * @brief Unit tests for the Diarizer classes, MergeIntoSegments and speaker clustering
+ * @note MergeIntoSegments, SpeakerClusterer and ClusterEmbeddings tests always
+ *       run; Diarizer and OnlineDiarizer tests (via the diarize_fn / embed_fn
+ *       seams) are only compiled when ENABLE_DIARIZATION is defined.
  */
 
 #include "audio/diarizer.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
 #include <vector>
 
 using namespace ffvoice;
@@ -148,6 +153,203 @@ TEST_F(MergeIntoSegmentsTest, PreSetSpeakerId_OverwrittenWhenOverlapFound) {
     EXPECT_EQ(2, segments[0].speaker_id);
 }
 
+TEST_F(MergeIntoSegmentsTest, Words_SpeakerChangeInsideSegment) {
+    // One segment spans a speaker change; each word gets its own speaker.
+    std::vector<TranscriptionSegment> segments = {MakeSegment(0, 2000)};
+    segments[0].words = {Word(0, 400, " hi", 0.9f), Word(500, 900, " there", 0.9f),
+                         Word(1200, 1900, " yes", 0.9f)};
+    std::vector<SpeakerSegment> speakers = {
+        SpeakerSegment(0, 1000, 0),
+        SpeakerSegment(1000, 2000, 1),
+    };
+
+    MergeIntoSegments(segments, speakers);
+
+    EXPECT_EQ(0, segments[0].speaker_id);  // tie: earlier speaker segment
+    EXPECT_EQ(0, segments[0].words[0].speaker_id);
+    EXPECT_EQ(0, segments[0].words[1].speaker_id);
+    EXPECT_EQ(1, segments[0].words[2].speaker_id);
+}
+
+TEST_F(MergeIntoSegmentsTest, Words_InGap_TakeSegmentSpeaker) {
+    std::vector<TranscriptionSegment> segments = {MakeSegment(0, 2000)};
+    segments[0].words = {Word(100, 800, " one", 0.9f), Word(1100, 1300, " two", 0.9f)};
+    std::vector<SpeakerSegment> speakers = {SpeakerSegment(0, 1000, 4)};
+
+    MergeIntoSegments(segments, speakers);
+
+    EXPECT_EQ(4, segments[0].speaker_id);
+    EXPECT_EQ(4, segments[0].words[1].speaker_id);  // no overlap of its own
+}
+
+TEST_F(MergeIntoSegmentsTest, UnsortedAndOverlappingInput_MatchesExhaustiveSearch) {
+    // Reference: the largest overlap over every speaker segment, earlier wins ties
+    auto reference = [](int64_t start, int64_t end, const std::vector<SpeakerSegment>& speakers,
+                        int32_t fallback) {
+        int64_t best_overlap = 0;
+        int32_t best = fallback;
+        for (const auto& sp : speakers) {
+            const int64_t overlap = std::min(end, sp.end_ms) - std::max(start, sp.start_ms);
+            if (overlap > best_overlap) {
+                best_overlap = overlap;
+                best = sp.speaker_id;
+            }
+        }
+        return best;
+    };
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int64_t> when(0, 60000);
+    std::uniform_int_distribution<int64_t> length(50, 3000);
+    std::uniform_int_distribution<int32_t> who(0, 3);
+
+    // Overlapping speech and one speaker segment spanning almost everything
+    std::vector<SpeakerSegment> speakers = {SpeakerSegment(1000, 59000, 9)};
+    for (int i = 0; i < 200; ++i) {
+        const int64_t start = when(rng);
+        speakers.emplace_back(start, start + length(rng), who(rng));
+    }
+
+    // Mostly ordered segments with a few out of order, each with three words
+    std::vector<TranscriptionSegment> segments;
+    for (int i = 0; i < 100; ++i) {
+        const int64_t start = i % 17 == 0 ? when(rng) : static_cast<int64_t>(i) * 600;
+        TranscriptionSegment seg = MakeSegment(start, start + 600);
+        for (int w = 0; w < 3; ++w) {
+            seg.words.emplace_back(start + w * 200, start + w * 200 + 150, " w", 0.9f);
+        }
+        segments.push_back(seg);
+    }
+
+    std::vector<TranscriptionSegment> merged = segments;
+    MergeIntoSegments(merged, speakers);
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const int32_t expected = reference(segments[i].start_ms, segments[i].end_ms, speakers, -1);
+        ASSERT_EQ(expected, merged[i].speaker_id) << "segment " << i;
+        for (size_t w = 0; w < segments[i].words.size(); ++w) {
+            const Word& word = segments[i].words[w];
+            ASSERT_EQ(reference(word.start_ms, word.end_ms, speakers, expected),
+                      merged[i].words[w].speaker_id)
+                << "segment " << i << " word " << w;
+        }
+    }
+}
+
+// =============================================================================
+// SpeakerClusterer tests — always compiled
+// =============================================================================
+
+TEST(SpeakerClustererTest, SimilarEmbeddingsShareASpeaker) {
+    SpeakerClusterer clusterer;
+
+    const std::vector<float> a = {1.0f, 0.0f, 0.0f};
+    const std::vector<float> a_louder = {3.0f, 0.3f, 0.0f};  // scale does not matter
+    const std::vector<float> b = {0.0f, 1.0f, 0.0f};
+
+    EXPECT_EQ(0, clusterer.Assign(a.data(), a.size()));
+    EXPECT_EQ(1, clusterer.Assign(b.data(), b.size()));
+    EXPECT_EQ(0, clusterer.Assign(a_louder.data(), a_louder.size()));
+    EXPECT_EQ(1, clusterer.Assign(b.data(), b.size()));
+    EXPECT_EQ(2u, clusterer.GetNumSpeakers());
+}
+
+TEST(SpeakerClustererTest, ThresholdDecidesANewSpeaker) {
+    SpeakerClusterer::Config config;
+    config.similarity_threshold = 0.9f;
+    SpeakerClusterer clusterer(config);
+
+    // cos(a, c) = 0.8: the same speaker at 0.5, a new one at 0.9
+    const std::vector<float> a = {1.0f, 0.0f};
+    const std::vector<float> c = {0.8f, 0.6f};
+    EXPECT_EQ(0, clusterer.Assign(a.data(), a.size()));
+    EXPECT_EQ(1, clusterer.Assign(c.data(), c.size()));
+}
+
+TEST(SpeakerClustererTest, MaxSpeakersBoundsTheCentroids) {
+    SpeakerClusterer::Config config;
+    config.max_speakers = 2;
+    SpeakerClusterer clusterer(config);
+
+    const std::vector<float> a = {1.0f, 0.0f, 0.0f};
+    const std::vector<float> b = {0.0f, 1.0f, 0.0f};
+    const std::vector<float> near_b = {0.0f, 1.0f, 0.9f};
+    ASSERT_EQ(0, clusterer.Assign(a.data(), a.size()));
+    ASSERT_EQ(1, clusterer.Assign(b.data(), b.size()));
+
+    // A third voice joins the nearest speaker instead of growing the model
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(1, clusterer.Assign(near_b.data(), near_b.size()));
+    }
+    EXPECT_EQ(2u, clusterer.GetNumSpeakers());
+}
+
+TEST(SpeakerClustererTest, CentroidFollowsADriftingVoice) {
+    SpeakerClusterer::Config config;
+    config.similarity_threshold = 0.8f;
+    config.max_centroid_weight = 4;
+    SpeakerClusterer clusterer(config);
+
+    // Turn the voice 90 degrees in small steps; each step is close to the centroid
+    constexpr double kPi = 3.14159265358979323846;
+    for (int step = 0; step <= 45; ++step) {
+        const double angle = step * (kPi / 2.0) / 45.0;
+        const float v[2] = {static_cast<float>(std::cos(angle)),
+                            static_cast<float>(std::sin(angle))};
+        ASSERT_EQ(0, clusterer.Assign(v, 2)) << "step " << step;
+    }
+
+    // The original direction is now a different speaker
+    const std::vector<float> start = {1.0f, 0.0f};
+    EXPECT_EQ(1, clusterer.Assign(start.data(), start.size()));
+}
+
+TEST(SpeakerClustererTest, RejectsInvalidEmbeddingsAndResets) {
+    SpeakerClusterer clusterer;
+
+    const std::vector<float> zero = {0.0f, 0.0f, 0.0f};
+    const std::vector<float> a = {1.0f, 0.0f, 0.0f};
+    const std::vector<float> other_dim = {1.0f, 0.0f};
+    EXPECT_EQ(-1, clusterer.Assign(nullptr, 3));
+    EXPECT_EQ(-1, clusterer.Assign(zero.data(), zero.size()));
+    EXPECT_EQ(0, clusterer.Assign(a.data(), a.size()));
+    EXPECT_EQ(-1, clusterer.Assign(other_dim.data(), other_dim.size()));
+
+    clusterer.Reset();
+    EXPECT_EQ(0u, clusterer.GetNumSpeakers());
+    EXPECT_EQ(0, clusterer.Assign(other_dim.data(), other_dim.size()));
+}
+
+TEST(ClusterEmbeddingsTest, ThresholdSeparatesVoices) {
+    const std::vector<std::vector<float>> embeddings = {
+        {1.0f, 0.0f}, {0.0f, 1.0f}, {0.9f, 0.1f}, {0.1f, 0.9f}, {1.0f, 0.05f},
+    };
+    const std::vector<int32_t> labels = ClusterEmbeddings(embeddings, 0, 0.5f);
+    EXPECT_EQ((std::vector<int32_t>{0, 1, 0, 1, 0}), labels);
+
+    // A distance threshold above every pair merges everything
+    EXPECT_EQ((std::vector<int32_t>{0, 0, 0, 0, 0}), ClusterEmbeddings(embeddings, 0, 2.5f));
+}
+
+TEST(ClusterEmbeddingsTest, NumSpeakersOverridesThreshold) {
+    const std::vector<std::vector<float>> embeddings = {
+        {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.1f, 1.0f},
+    };
+    EXPECT_EQ((std::vector<int32_t>{0, 1, 2, 2}), ClusterEmbeddings(embeddings, 0, 0.5f));
+    const std::vector<int32_t> two = ClusterEmbeddings(embeddings, 2, 0.5f);
+    ASSERT_EQ(4u, two.size());
+    EXPECT_EQ(two[2], two[3]);
+    EXPECT_EQ(2, *std::max_element(two.begin(), two.end()) + 1);
+}
+
+TEST(ClusterEmbeddingsTest, InvalidEmbeddingsAreUnknown) {
+    const std::vector<std::vector<float>> embeddings = {
+        {}, {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 2.0f},
+    };
+    EXPECT_EQ((std::vector<int32_t>{-1, 0, -1, -1, 0}), ClusterEmbeddings(embeddings, 0, 0.5f));
+    EXPECT_TRUE(ClusterEmbeddings({}, 0, 0.5f).empty());
+}
+
 #ifdef ENABLE_DIARIZATION
 
 // =============================================================================
@@ -311,4 +513,164 @@ TEST_F(DiarizerTest, Integration_DiarizeThenMergeIntoSegments) {
     EXPECT_EQ(-1, segments[2].speaker_id);
 }
 
+// =============================================================================
+// Windowed Diarizer tests — diarize_fn + embed_fn seams
+// =============================================================================
+
+namespace {
+
+/// Recording that alternates between two "voices" (+/-0.5) every @p turn_s seconds
+std::vector<float> MakeAlternatingRecording(int seconds, int turn_s) {
+    std::vector<float> samples(static_cast<size_t>(seconds) * 16000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = (i / (static_cast<size_t>(turn_s) * 16000)) % 2 == 0 ? 0.5f : -0.5f;
+    }
+    return samples;
+}
+
+/// Windowed seam config: speakers are numbered by first appearance within each
+/// call, as a per-window diarizer would; the embedding is the audio's sign.
+DiarizerConfig MakeWindowedSeamConfig(std::atomic<int>* diarize_calls) {
+    DiarizerConfig cfg;
+    cfg.diarize_fn = [diarize_calls](const std::vector<float>& samples, int sample_rate) {
+        ++*diarize_calls;
+        std::vector<SpeakerSegment> segments;
+        int32_t first_voice = 0;
+        size_t begin = 0;
+        for (size_t i = 1; i <= samples.size(); ++i) {
+            if (i < samples.size() && (samples[i] >= 0.0f) == (samples[begin] >= 0.0f)) {
+                continue;
+            }
+            const int32_t voice = samples[begin] >= 0.0f ? 0 : 1;
+            if (segments.empty()) {
+                first_voice = voice;
+            }
+            segments.emplace_back(static_cast<int64_t>(begin) * 1000 / sample_rate,
+                                  static_cast<int64_t>(i) * 1000 / sample_rate,
+                                  voice == first_voice ? 0 : 1);
+            begin = i;
+        }
+        return segments;
+    };
+    cfg.embed_fn = [](const float* samples, size_t, int) {
+        return samples[0] >= 0.0f ? std::vector<float>{1.0f, 0.0f}
+                                  : std::vector<float>{0.0f, 1.0f};
+    };
+    cfg.window_s = 30;
+    cfg.window_overlap_s = 10;
+    cfg.num_workers = 3;
+    return cfg;
+}
+
+}  // namespace
+
+TEST(DiarizerWindowedTest, LongRecording_LabelsSpeakersConsistentlyAcrossWindows) {
+    std::atomic<int> calls{0};
+    Diarizer diarizer(MakeWindowedSeamConfig(&calls));
+    ASSERT_TRUE(diarizer.Init());
+
+    // 100 s in 30 s windows stepping by 20 s: [0,30) [20,50) [40,70) [60,90) [80,100)
+    const auto speakers = diarizer.Diarize(MakeAlternatingRecording(100, 10), 16000);
+    EXPECT_EQ(5, calls.load());
+
+    // Window-local ids differ (each window starts on whoever speaks first) but
+    // the global labels follow the voice, and cuts at overlap midpoints rejoin
+    ASSERT_EQ(10u, speakers.size());
+    for (size_t i = 0; i < speakers.size(); ++i) {
+        EXPECT_EQ(static_cast<int64_t>(i) * 10000, speakers[i].start_ms) << "turn " << i;
+        EXPECT_EQ(static_cast<int64_t>(i + 1) * 10000, speakers[i].end_ms) << "turn " << i;
+        EXPECT_EQ(static_cast<int32_t>(i % 2), speakers[i].speaker_id) << "turn " << i;
+    }
+}
+
+TEST(DiarizerWindowedTest, ShortRecording_RunsInOnePass) {
+    std::atomic<int> calls{0};
+    Diarizer diarizer(MakeWindowedSeamConfig(&calls));
+    ASSERT_TRUE(diarizer.Init());
+
+    const auto speakers = diarizer.Diarize(MakeAlternatingRecording(25, 10), 16000);
+    EXPECT_EQ(1, calls.load());
+    ASSERT_EQ(3u, speakers.size());
+    EXPECT_EQ(1, speakers[1].speaker_id);
+    EXPECT_EQ(25000, speakers[2].end_ms);
+}
+
+TEST(DiarizerWindowedTest, WithoutEmbedFn_SeamSeesTheWholeRecording) {
+    std::atomic<int> calls{0};
+    DiarizerConfig cfg = MakeWindowedSeamConfig(&calls);
+    cfg.embed_fn = nullptr;
+    Diarizer diarizer(cfg);
+    ASSERT_TRUE(diarizer.Init());
+
+    EXPECT_EQ(10u, diarizer.Diarize(MakeAlternatingRecording(100, 10), 16000).size());
+    EXPECT_EQ(1, calls.load());
+}
+
+// =============================================================================
+// OnlineDiarizer tests — embed_fn seam, no model files
+// =============================================================================
+
+namespace {
+
+/// Seam config whose "embedding" is the first sample's sign: +/- one voice each
+OnlineDiarizerConfig MakeOnlineSeamConfig(int* calls) {
+    OnlineDiarizerConfig cfg;
+    cfg.embed_fn = [calls](const float* samples, size_t, int) {
+        ++*calls;
+        return samples[0] >= 0.0f ? std::vector<float>{1.0f, 0.0f}
+                                  : std::vector<float>{0.0f, 1.0f};
+    };
+    return cfg;
+}
+
+}  // namespace
+
+TEST(OnlineDiarizerTest, AssignBeforeInit_ReturnsUnknown) {
+    int calls = 0;
+    OnlineDiarizer diarizer(MakeOnlineSeamConfig(&calls));
+    std::vector<float> samples(16000, 0.1f);
+
+    EXPECT_EQ(-1, diarizer.AssignSpeaker(samples.data(), samples.size(), 16000));
+    EXPECT_EQ(0, calls);
+}
+
+TEST(OnlineDiarizerTest, AssignsSpeakersAcrossUtterances) {
+    int calls = 0;
+    OnlineDiarizer diarizer(MakeOnlineSeamConfig(&calls));
+    ASSERT_TRUE(diarizer.Init());
+    EXPECT_EQ(16000, diarizer.GetExpectedSampleRate());
+
+    std::vector<float> alice(16000, 0.1f);
+    std::vector<float> bob(16000, -0.1f);
+    EXPECT_EQ(0, diarizer.AssignSpeaker(alice.data(), alice.size(), 16000));
+    EXPECT_EQ(1, diarizer.AssignSpeaker(bob.data(), bob.size(), 16000));
+    EXPECT_EQ(0, diarizer.AssignSpeaker(alice.data(), alice.size(), 16000));
+    EXPECT_EQ(2u, diarizer.GetNumSpeakers());
+
+    diarizer.Reset();
+    EXPECT_EQ(0u, diarizer.GetNumSpeakers());
+    EXPECT_EQ(0, diarizer.AssignSpeaker(bob.data(), bob.size(), 16000));
+}
+
+TEST(OnlineDiarizerTest, ShortUtterance_IsNotEmbedded) {
+    int calls = 0;
+    OnlineDiarizerConfig cfg = MakeOnlineSeamConfig(&calls);
+    cfg.min_segment_ms = 500;
+    OnlineDiarizer diarizer(cfg);
+    ASSERT_TRUE(diarizer.Init());
+
+    std::vector<float> samples(7999, 0.1f);  // just under 500 ms
+    EXPECT_EQ(-1, diarizer.AssignSpeaker(samples.data(), samples.size(), 16000));
+    EXPECT_EQ(0, calls);
+}
+
+TEST(OnlineDiarizerTest, Init_NoSeamEmptyModelPath_Fails) {
+    OnlineDiarizerConfig cfg;
+    cfg.embedding_model_path = "";
+    OnlineDiarizer diarizer(cfg);
+
+    EXPECT_FALSE(diarizer.Init());
+    EXPECT_FALSE(diarizer.GetLastError().empty());
+}
+
 #endif  // ENABLE_DIARIZATION
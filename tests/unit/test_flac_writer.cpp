@@ -4,10 +4,12 @@
  */
 
 #include "media/flac_writer.h"
+#include "utils/audio_converter.h"
 #include "utils/signal_generator.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <vector>
@@ -206,6 +208,78 @@ TEST_F(FlacWriterTest, SupportStereo) {
     EXPECT_TRUE(HasFlacMagic(test_file_));
 }
 
+TEST_F(FlacWriterTest, SupportUpToEightChannels) {
+    const auto tone = SignalGenerator::GenerateSineWave(440.0, 0.1, 48000, 0.3);
+    for (int channels = 3; channels <= 8; ++channels) {
+        std::vector<int16_t> interleaved;
+        for (int16_t sample : tone) {
+            for (int ch = 0; ch < channels; ++ch) {
+                interleaved.push_back(static_cast<int16_t>(sample / (ch + 1)));
+            }
+        }
+
+        FlacWriter writer;
+        ASSERT_TRUE(writer.Open(test_file_, 48000, channels)) << channels << " channels";
+        EXPECT_EQ(interleaved.size(), writer.WriteSamples(interleaved));
+        writer.Close();
+        EXPECT_TRUE(HasFlacMagic(test_file_));
+    }
+
+    FlacWriter writer;
+    EXPECT_FALSE(writer.Open(test_file_, 48000, 9));
+}
+
+TEST_F(FlacWriterTest, ThreadedEncodingDecodesToSameAudio) {
+    const auto audio = SignalGenerator::GenerateWhiteNoise(2.0, 48000, 0.3);
+    const std::string threaded_file = ::testing::TempDir() + "test_flac_threaded.flac";
+
+    FlacWriter single;
+    ASSERT_TRUE(single.Open(test_file_, 48000, 1));
+    single.WriteSamples(audio);
+    single.Close();
+
+    FlacWriter::Config config;
+    config.num_threads = 4;  // falls back to one thread on libFLAC < 1.5
+    FlacWriter threaded(config);
+    ASSERT_TRUE(threaded.Open(threaded_file, 48000, 1));
+    for (size_t pos = 0; pos < audio.size(); pos += 4096) {
+        const size_t n = std::min<size_t>(4096, audio.size() - pos);
+        EXPECT_EQ(n, threaded.WriteSamples(audio.data() + pos, n));
+    }
+    threaded.Close();
+    EXPECT_FALSE(threaded.HasError());
+    EXPECT_EQ(audio.size(), threaded.GetTotalSamples());
+
+    std::vector<float> expected;
+    std::vector<float> actual;
+    ASSERT_TRUE(AudioConverter::LoadAndConvert(test_file_, expected, 48000));
+    ASSERT_TRUE(AudioConverter::LoadAndConvert(threaded_file, actual, 48000));
+    EXPECT_EQ(expected, actual);
+    std::remove(threaded_file.c_str());
+}
+
+TEST_F(FlacWriterTest, KnownLengthAddsSeekTable) {
+    const auto audio = SignalGenerator::GenerateSineWave(440.0, 10.0, 48000, 0.3);
+    const std::string seekable_file = ::testing::TempDir() + "test_flac_seekable.flac";
+
+    FlacWriter plain;
+    ASSERT_TRUE(plain.Open(test_file_, 48000, 1));
+    plain.WriteSamples(audio);
+    plain.Close();
+
+    FlacWriter::Config config;
+    config.total_frames_estimate = audio.size();
+    config.seek_point_seconds = 1;
+    FlacWriter seekable(config);
+    ASSERT_TRUE(seekable.Open(seekable_file, 48000, 1));
+    seekable.WriteSamples(audio);
+    seekable.Close();
+
+    // Same frames plus a SEEKTABLE block of 18-byte points, one per second
+    EXPECT_GE(GetFileSize(seekable_file), GetFileSize(test_file_) + 10 * 18);
+    std::remove(seekable_file.c_str());
+}
+
 // ============================================================================
 // Edge Cases
 // ============================================================================
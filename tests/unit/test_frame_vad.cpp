@@ -0,0 +1,141 @@
+/**
+ * @file test_frame_vad.cpp
+ * @brief Unit tests for FrameVAD (energy / spectral-flatness frame VAD)
+ */
+
+#include "audio/frame_vad.h"
+#include "audio/vad_segmenter.h"
+#include "utils/signal_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+// Probability of every frame of @p samples
+std::vector<float> Score(FrameVAD& vad, const std::vector<int16_t>& samples) {
+    std::vector<float> probs;
+    const size_t frame = vad.GetFrameSamples();
+    for (size_t pos = 0; pos + frame <= samples.size(); pos += frame) {
+        probs.push_back(vad.ProcessFrame(samples.data() + pos));
+    }
+    return probs;
+}
+
+}  // namespace
+
+TEST(FrameVADTest, FrameSizeFollowsRateAndChannels) {
+    FrameVAD vad;
+    ASSERT_TRUE(vad.Initialize(48000, 1));
+    EXPECT_EQ(480u, vad.GetFrameSamples());
+    ASSERT_TRUE(vad.Initialize(16000, 2));
+    EXPECT_EQ(320u, vad.GetFrameSamples());
+
+    EXPECT_FALSE(vad.Initialize(0, 1));
+    EXPECT_FALSE(vad.Initialize(48000, 0));
+    EXPECT_FALSE(vad.Initialize(100, 1));  // one sample per frame
+}
+
+TEST(FrameVADTest, UninitializedScoresZero) {
+    FrameVAD vad;
+    int16_t sample = 10000;
+    EXPECT_EQ(0.0f, vad.ProcessFrame(&sample));
+}
+
+TEST(FrameVADTest, SilenceScoresZeroAndToneScoresHigh) {
+    FrameVAD vad;
+    ASSERT_TRUE(vad.Initialize(48000, 1));
+
+    for (float p : Score(vad, SignalGenerator::GenerateSilence(0.2))) {
+        EXPECT_EQ(0.0f, p);
+    }
+    for (float p : Score(vad, SignalGenerator::GenerateSineWave(200.0, 0.2, 48000, 0.3))) {
+        EXPECT_GT(p, 0.9f);
+    }
+}
+
+TEST(FrameVADTest, FlatSpectrumIsNotSpeech) {
+    FrameVAD vad;
+    ASSERT_TRUE(vad.Initialize(48000, 1));
+
+    // Loud white noise from the first frame: energy alone would say speech
+    for (float p : Score(vad, SignalGenerator::GenerateWhiteNoise(0.2, 48000, 0.3))) {
+        EXPECT_LT(p, 0.5f);
+    }
+}
+
+TEST(FrameVADTest, NoiseFloorRisesSlowlyAndFallsAtOnce) {
+    FrameVAD::Config config;
+    config.noise_rise_db_per_s = 10.0f;
+    FrameVAD vad(config);
+    ASSERT_TRUE(vad.Initialize(48000, 1));
+    EXPECT_NEAR(-60.0f, vad.GetNoiseFloorDbfs(), 0.01f);
+
+    // A 200 Hz tone at -10 dBFS RMS for 1 s lifts the floor by at most 10 dB
+    Score(vad, SignalGenerator::GenerateSineWave(200.0, 1.0, 48000, 0.45));
+    EXPECT_NEAR(-50.0f, vad.GetNoiseFloorDbfs(), 0.5f);
+
+    // A steady background is learned: once the floor reaches it, it stops scoring
+    const auto hum = SignalGenerator::GenerateSineWave(100.0, 6.0, 48000, 0.01);
+    const std::vector<float> probs = Score(vad, hum);
+    EXPECT_EQ(0.0f, probs.back());
+
+    for (float p : Score(vad, SignalGenerator::GenerateSineWave(200.0, 0.1, 48000, 0.3))) {
+        EXPECT_GT(p, 0.9f);  // speech well above the learned floor
+    }
+
+    vad.Reset();
+    EXPECT_NEAR(-60.0f, vad.GetNoiseFloorDbfs(), 0.01f);
+}
+
+TEST(FrameVADTest, StereoMatchesMonoForIdenticalChannels) {
+    const auto mono = SignalGenerator::GenerateSineWave(300.0, 0.3, 48000, 0.2);
+    std::vector<int16_t> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        stereo[2 * i] = mono[i];
+        stereo[2 * i + 1] = mono[i];
+    }
+
+    FrameVAD mono_vad;
+    FrameVAD stereo_vad;
+    ASSERT_TRUE(mono_vad.Initialize(48000, 1));
+    ASSERT_TRUE(stereo_vad.Initialize(48000, 2));
+    const std::vector<float> expected = Score(mono_vad, mono);
+    const std::vector<float> actual = Score(stereo_vad, stereo);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i], actual[i]) << "frame " << i;
+    }
+}
+
+TEST(FrameVADTest, DrivesVADSegmenterAtItsFrameRate) {
+    FrameVAD vad;
+    ASSERT_TRUE(vad.Initialize(48000, 1));
+    VADSegmenter segmenter;  // default config: 0.3 s to start, 0.5 s of silence to end
+
+    std::vector<int16_t> audio = SignalGenerator::GenerateSilence(0.5);
+    const auto speech = SignalGenerator::GenerateSineWave(200.0, 1.0, 48000, 0.3);
+    audio.insert(audio.end(), speech.begin(), speech.end());
+    const auto silence = SignalGenerator::GenerateSilence(0.6);
+    audio.insert(audio.end(), silence.begin(), silence.end());
+
+    std::vector<size_t> segments;
+    size_t end_frame = 0;
+    const size_t frame = vad.GetFrameSamples();
+    for (size_t pos = 0; pos + frame <= audio.size(); pos += frame) {
+        const float p = vad.ProcessFrame(audio.data() + pos);
+        segmenter.ProcessFrame(audio.data() + pos, frame, p, [&](const int16_t*, size_t n) {
+            segments.push_back(n);
+            end_frame = pos / frame;
+        });
+    }
+
+    ASSERT_EQ(1u, segments.size());
+    // Confirmed after 30 frames of speech, cut 50 frames after it ends
+    EXPECT_EQ(48000u - 29 * 480 + 50 * 480, segments[0]);
+    EXPECT_EQ(50u + 100u + 49u, end_frame);
+}
@@ -0,0 +1,228 @@
+/**
+ * @file test_inference_scheduler.cpp
+ * @brief Unit tests for InferenceScheduler (via the transcribe_fn test seam)
+ * @note Only compiled when ENABLE_WHISPER is defined
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/inference_scheduler.h"
+    #include "audio/live_captioner.h"
+
+    #include <gtest/gtest.h>
+
+    #include <atomic>
+    #include <chrono>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+/// Transcribe seam that records the first sample of every request it runs and
+/// blocks while @p gate is closed.
+struct RecordingBackend {
+    std::mutex mutex;
+    std::vector<int16_t> order;
+    std::atomic<bool> gate_open{true};
+    std::atomic<int> started{0};
+
+    InferenceSchedulerConfig MakeConfig(size_t workers = 1) {
+        InferenceSchedulerConfig cfg;
+        cfg.num_workers = workers;
+        cfg.threads_per_worker = 1;
+        cfg.transcribe_fn = [this](const int16_t* samples, size_t count,
+                                   std::vector<TranscriptionSegment>& out) {
+            started.fetch_add(1);
+            while (!gate_open.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(count > 0 ? samples[0] : -1);
+            }
+            out.clear();
+            out.emplace_back(0LL, 100LL, "ok", 0.8f);
+            return true;
+        };
+        return cfg;
+    }
+};
+
+std::vector<int16_t> Tagged(int16_t tag) {
+    return std::vector<int16_t>(160, tag);
+}
+
+bool WaitFor(const std::function<bool()>& cond, int timeout_ms = 2000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (cond()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(InferenceSchedulerTest, AutoSizingUsesAtLeastOneWorkerAndThread) {
+    InferenceSchedulerConfig cfg;
+    cfg.transcribe_fn = [](const int16_t*, size_t, std::vector<TranscriptionSegment>&) {
+        return true;
+    };
+    InferenceScheduler scheduler(cfg);
+    EXPECT_GE(scheduler.GetNumWorkers(), 1u);
+    EXPECT_GE(scheduler.GetThreadsPerWorker(), 1);
+
+    const unsigned hw = std::thread::hardware_concurrency();
+    if (hw > 0 && scheduler.GetNumWorkers() > 1) {
+        EXPECT_LE(scheduler.GetNumWorkers() * static_cast<size_t>(scheduler.GetThreadsPerWorker()),
+                  static_cast<size_t>(hw));
+    }
+}
+
+TEST(InferenceSchedulerTest, SubmitReturnsSegmentsAndTiming) {
+    RecordingBackend backend;
+    InferenceScheduler scheduler(backend.MakeConfig());
+    ASSERT_TRUE(scheduler.Start());
+
+    InferenceResult result = scheduler.Submit(InferencePriority::Final, Tagged(1), 16000).get();
+    EXPECT_TRUE(result.ok);
+    ASSERT_EQ(result.segments.size(), 1u);
+    EXPECT_EQ(result.segments[0].text, "ok");
+    EXPECT_GE(result.queue_wait_ms, 0.0);
+
+    scheduler.Stop();
+    auto stats = scheduler.GetStats();
+    EXPECT_EQ(stats.submitted, 1u);
+    EXPECT_EQ(stats.completed, 1u);
+    EXPECT_EQ(stats.queue_depth, 0u);
+}
+
+TEST(InferenceSchedulerTest, SubmitPcmReachesSeamAsInt16) {
+    RecordingBackend backend;
+    InferenceScheduler scheduler(backend.MakeConfig());
+    ASSERT_TRUE(scheduler.Start());
+
+    // 0.25 in float is 8192 in int16
+    InferenceResult result =
+        scheduler.SubmitPcm(InferencePriority::Partial, std::vector<float>(160, 0.25f)).get();
+    EXPECT_TRUE(result.ok);
+    scheduler.Stop();
+
+    ASSERT_EQ(backend.order.size(), 1u);
+    EXPECT_NEAR(backend.order[0], 8192, 1);
+}
+
+TEST(InferenceSchedulerTest, FinalsAreServedBeforePartials) {
+    RecordingBackend backend;
+    backend.gate_open.store(false);
+    InferenceScheduler scheduler(backend.MakeConfig(1));
+    ASSERT_TRUE(scheduler.Start());
+
+    // Occupy the only worker, then queue partials ahead of a final
+    auto blocker = scheduler.Submit(InferencePriority::Partial, Tagged(0), 16000);
+    ASSERT_TRUE(WaitFor([&]() { return backend.started.load() == 1; }));
+    auto p1 = scheduler.Submit(InferencePriority::Partial, Tagged(1), 16000);
+    auto p2 = scheduler.Submit(InferencePriority::Partial, Tagged(2), 16000);
+    auto f1 = scheduler.Submit(InferencePriority::Final, Tagged(3), 16000);
+    EXPECT_EQ(scheduler.GetQueueDepth(), 3u);
+
+    backend.gate_open.store(true);
+    blocker.get();
+    p1.get();
+    p2.get();
+    f1.get();
+    scheduler.Stop();
+
+    std::lock_guard<std::mutex> lock(backend.mutex);
+    EXPECT_EQ(backend.order, (std::vector<int16_t>{0, 3, 1, 2}));
+}
+
+TEST(InferenceSchedulerTest, PartialsRejectedWhenQueueFullButFinalsAccepted) {
+    RecordingBackend backend;
+    backend.gate_open.store(false);
+    InferenceSchedulerConfig cfg = backend.MakeConfig(1);
+    cfg.max_queue_depth = 1;
+    InferenceScheduler scheduler(cfg);
+    ASSERT_TRUE(scheduler.Start());
+
+    auto blocker = scheduler.Submit(InferencePriority::Final, Tagged(0), 16000);
+    ASSERT_TRUE(WaitFor([&]() { return backend.started.load() == 1; }));
+    auto queued = scheduler.Submit(InferencePriority::Partial, Tagged(1), 16000);
+    auto rejected = scheduler.Submit(InferencePriority::Partial, Tagged(2), 16000);
+    auto final_over_limit = scheduler.Submit(InferencePriority::Final, Tagged(3), 16000);
+
+    // The rejected future resolves immediately
+    ASSERT_EQ(rejected.wait_for(std::chrono::milliseconds(0)), std::future_status::ready);
+    EXPECT_FALSE(rejected.get().ok);
+
+    backend.gate_open.store(true);
+    EXPECT_TRUE(blocker.get().ok);
+    EXPECT_TRUE(queued.get().ok);
+    EXPECT_TRUE(final_over_limit.get().ok);
+    scheduler.Stop();
+
+    EXPECT_EQ(scheduler.GetStats().rejected, 1u);
+}
+
+TEST(InferenceSchedulerTest, StopCancelsQueuedRequests) {
+    RecordingBackend backend;
+    backend.gate_open.store(false);
+    InferenceScheduler scheduler(backend.MakeConfig(1));
+    ASSERT_TRUE(scheduler.Start());
+
+    auto running = scheduler.Submit(InferencePriority::Final, Tagged(0), 16000);
+    ASSERT_TRUE(WaitFor([&]() { return backend.started.load() == 1; }));
+    auto queued = scheduler.Submit(InferencePriority::Final, Tagged(1), 16000);
+
+    std::thread stopper([&]() { scheduler.Stop(); });
+    EXPECT_FALSE(queued.get().ok);  // Cancelled before a worker picked it up
+    backend.gate_open.store(true);
+    EXPECT_TRUE(running.get().ok);  // In-flight request still completes
+    stopper.join();
+
+    EXPECT_EQ(scheduler.GetStats().cancelled, 1u);
+    EXPECT_FALSE(scheduler.Submit(InferencePriority::Final, Tagged(2), 16000).get().ok);
+}
+
+TEST(InferenceSchedulerTest, LiveCaptionerUsesSharedScheduler) {
+    RecordingBackend backend;
+    InferenceScheduler scheduler(backend.MakeConfig(2));
+    ASSERT_TRUE(scheduler.Start());
+
+    LiveCaptionerConfig cfg;
+    cfg.scheduler = &scheduler;
+    cfg.vad.min_speech_frames = 2;
+    cfg.vad.min_silence_frames = 2;
+    cfg.min_samples_for_partial = 480000;  // Finals only
+
+    std::atomic<int> finals{0};
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback([&](const CaptionEvent& ev) {
+        if (ev.type == CaptionEventType::Final && ev.text == "ok") {
+            finals.fetch_add(1);
+        }
+    });
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    std::vector<int16_t> speech(4800, 10000);
+    std::vector<int16_t> silence(4800, 0);
+    for (int i = 0; i < 4; ++i) {
+        captioner.FeedAudio(speech.data(), speech.size());
+    }
+    for (int i = 0; i < 4; ++i) {
+        captioner.FeedAudio(silence.data(), silence.size());
+    }
+
+    EXPECT_TRUE(WaitFor([&]() { return finals.load() >= 1; }));
+    captioner.Stop();
+    scheduler.Stop();
+    EXPECT_GE(scheduler.GetStats().completed, 1u);
+}
+
+#endif  // ENABLE_WHISPER
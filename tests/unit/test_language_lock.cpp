@@ -0,0 +1,82 @@
+/**
+ * @file test_language_lock.cpp
+ * @brief Unit tests for LanguageLock session language pinning
+ */
+
+#include "audio/language_lock.h"
+
+#include <gtest/gtest.h>
+
+using namespace ffvoice;
+
+TEST(LanguageLockTest, LocksMostSpokenLanguageAfterProbeSpeech) {
+    LanguageLock::Config config;
+    config.probe_ms = 3000;
+    config.probe_utterances = 10;
+    LanguageLock lock(config);
+    EXPECT_EQ("auto", lock.GetLanguage());
+
+    lock.OnFinal("en", 1000, 0.9f);
+    lock.OnFinal("de", 1500, 0.6f);  // A misdetected utterance
+    EXPECT_FALSE(lock.IsLocked());
+    EXPECT_EQ("auto", lock.GetLanguage());
+
+    lock.OnFinal("en", 1000, 0.9f);
+    ASSERT_TRUE(lock.IsLocked());
+    EXPECT_EQ("en", lock.GetLanguage());  // 2000 ms of English beats 1500 ms of German
+}
+
+TEST(LanguageLockTest, LocksAfterProbeUtterancesWithTiesToFirstHeard) {
+    LanguageLock::Config config;
+    config.probe_utterances = 2;
+    LanguageLock lock(config);
+
+    lock.OnFinal("zh", 400, 0.8f);
+    lock.OnFinal("ja", 400, 0.8f);
+    ASSERT_TRUE(lock.IsLocked());
+    EXPECT_EQ("zh", lock.GetLanguage());
+}
+
+TEST(LanguageLockTest, ConsecutiveWeakFinalsDetectAgain) {
+    LanguageLock::Config config;
+    config.probe_utterances = 1;
+    config.reprobe_confidence = 0.4f;
+    config.reprobe_after = 2;
+    LanguageLock lock(config);
+    lock.OnFinal("en", 2000, 0.9f);
+    ASSERT_TRUE(lock.IsLocked());
+
+    // One weak final is not enough, and a confident one resets the count
+    lock.OnFinal("en", 2000, 0.2f);
+    lock.OnFinal("en", 2000, 0.8f);
+    lock.OnFinal("en", 2000, 0.3f);
+    EXPECT_TRUE(lock.IsLocked());
+
+    lock.OnFinal("en", 2000, 0.1f);
+    EXPECT_FALSE(lock.IsLocked());
+    EXPECT_EQ("auto", lock.GetLanguage());
+    EXPECT_EQ(1u, lock.GetReprobeCount());
+
+    // The new speaker's language is learned from scratch
+    lock.OnFinal("fr", 2000, 0.9f);
+    EXPECT_EQ("fr", lock.GetLanguage());
+
+    lock.Reset();
+    EXPECT_FALSE(lock.IsLocked());
+    EXPECT_EQ(0u, lock.GetReprobeCount());
+}
+
+TEST(LanguageLockTest, IgnoresUnknownLanguageAndStaysOffWhenDisabled) {
+    LanguageLock lock;
+    lock.OnFinal("", 10000, 0.9f);  // Back-end could not report a language
+    EXPECT_FALSE(lock.IsLocked());
+
+    LanguageLock::Config config;
+    config.enabled = false;
+    LanguageLock disabled(config);
+    for (int i = 0; i < 5; ++i) {
+        disabled.OnFinal("en", 5000, 0.9f);
+    }
+    EXPECT_FALSE(disabled.IsLocked());
+    EXPECT_EQ("auto", disabled.GetLanguage());
+}
@@ -7,6 +7,7 @@
 #ifdef ENABLE_WHISPER
 
     #include "audio/live_captioner.h"
+#include "utils/word_grouper.h"
 
     #include <gtest/gtest.h>
 
@@ -14,6 +15,7 @@
     #include <chrono>
     #include <mutex>
     #include <thread>
+    #include <utility>
     #include <vector>
 
 using namespace ffvoice;
@@ -32,8 +34,8 @@ LiveCaptionerConfig MakeTestConfig(
 
     // VAD tuned for fast unit-test triggering
     cfg.vad.speech_threshold = 0.5f;
-    cfg.vad.min_speech_frames = 2;   // triggers after ~2 batches of speech
-    cfg.vad.min_silence_frames = 2;  // triggers after ~2 batches of silence
+    cfg.vad.min_speech_frames = 2;   // triggers after 2 frames (20 ms) of speech
+    cfg.vad.min_silence_frames = 2;  // triggers after 2 frames (20 ms) of silence
 
     cfg.partial_interval_ms = 200;
     cfg.min_samples_for_partial = 8000;  // ~167 ms at 48 kHz
@@ -262,9 +264,9 @@ TEST_F(LiveCaptionerTest, FeedAudio_RingBufferFull_ReturnsShortCount) {
 TEST_F(LiveCaptionerTest, Final_FiresAfterSpeechThenSilence) {
     LiveCaptionerConfig cfg = MakeTestConfig();
 
-    // Use the built-in RMS estimator (vad_prob_source=nullptr).
-    // MakeSpeech(4800) produces amplitude 10000 → RMS=10000 → vad_prob=1.0.
-    // MakeSilence(4800) produces amplitude 0    → RMS=0    → vad_prob=0.0.
+    // Use the built-in FrameVAD (vad_prob_source=nullptr).
+    // MakeSpeech(4800) produces amplitude 10000 → far above the noise floor → vad_prob=1.0.
+    // MakeSilence(4800) produces amplitude 0    → below min_energy_dbfs    → vad_prob=0.0.
     // This guarantees each worker batch sees the correct VAD probability
     // derived from the sample data itself, avoiding any ordering race.
     cfg.vad_prob_source = nullptr;
@@ -274,15 +276,15 @@ TEST_F(LiveCaptionerTest, Final_FiresAfterSpeechThenSilence) {
     ASSERT_TRUE(captioner.Initialize());
     ASSERT_TRUE(captioner.Start());
 
-    // --- Speech phase: amplitude 10000 → RMS-based vad_prob clamped to 1.0 ---
-    // Feed enough to exceed min_speech_frames (2 worker batches of 4800 samples)
+    // --- Speech phase: amplitude 10000 → FrameVAD vad_prob 1.0 ---
+    // Feed enough to exceed min_speech_frames (2 frames of 480 samples)
     for (int i = 0; i < 4; ++i) {
         auto speech = MakeSpeech(4800);
         captioner.FeedAudio(speech.data(), speech.size());
     }
 
     // --- Silence phase: amplitude 0 → vad_prob=0.0 ---
-    // Feed enough to exceed min_silence_frames (2 worker batches)
+    // Feed enough to exceed min_silence_frames (2 frames)
     for (int i = 0; i < 4; ++i) {
         auto silence = MakeSilence(4800);
         captioner.FeedAudio(silence.data(), silence.size());
@@ -349,6 +351,36 @@ TEST_F(LiveCaptionerTest, Stop_FlushesBufferedFinal) {
     EXPECT_TRUE(has_final) << "Stop() must flush a pending Final event";
 }
 
+TEST_F(LiveCaptionerTest, VadProbSource_WrappedBatchIsOneVadFrame) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.min_samples_for_partial = 1000000;  // Finals only
+    // Only the second batch is speech, and it straddles the ring wrap
+    cfg.ring_buffer_capacity = 7200;
+    std::atomic<int> batches{0};
+    cfg.vad_prob_source = [&]() { return batches.fetch_add(1) == 1 ? 1.0f : 0.0f; };
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    // One batch of speech is below min_speech_frames (2): no utterance
+    auto audio = MakeSilence(4800);
+    for (int batch = 0; batch < 4; ++batch) {
+        size_t fed = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (fed < audio.size()) {
+            fed += captioner.FeedAudio(audio.data() + fed, audio.size() - fed);
+            ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(WaitFor([&]() { return batches.load() > batch; }));
+    }
+    captioner.Stop();
+
+    EXPECT_EQ(0u, EventCount());
+}
+
 // =============================================================================
 // Utterance ID tests
 // =============================================================================
@@ -356,7 +388,7 @@ TEST_F(LiveCaptionerTest, Stop_FlushesBufferedFinal) {
 TEST_F(LiveCaptionerTest, UtteranceId_IncrementsPerFinal) {
     LiveCaptionerConfig cfg = MakeTestConfig();
 
-    // Use the built-in RMS estimator so VAD probability tracks sample amplitude,
+    // Use the built-in FrameVAD so VAD probability tracks sample amplitude,
     // not a shared variable — avoids ordering races between test and worker threads.
     cfg.vad_prob_source = nullptr;
 
@@ -714,16 +746,16 @@ TEST_F(LiveCaptionerTest, EdgeCase_TranscribeFnReturnsFalse_FinalEmittedWithEmpt
 }
 
 TEST_F(LiveCaptionerTest, EdgeCase_RmsBasedVadProb_SilenceProducesLowProb) {
-    // Use default vad_prob_source (nullptr → built-in RMS estimator)
+    // Use default vad_prob_source (nullptr → built-in FrameVAD)
     LiveCaptionerConfig cfg = MakeTestConfig();
-    cfg.vad_prob_source = nullptr;  // use built-in RMS estimator
+    cfg.vad_prob_source = nullptr;  // use built-in FrameVAD
 
     LiveCaptioner captioner(cfg);
     captioner.SetCallback(MakeCallback());
     ASSERT_TRUE(captioner.Initialize());
     ASSERT_TRUE(captioner.Start());
 
-    // Feed silence — RMS estimator should produce near-zero VAD prob
+    // Feed silence — FrameVAD should produce near-zero VAD prob
     for (int i = 0; i < 8; ++i) {
         auto s = MakeSilence(4800);
         captioner.FeedAudio(s.data(), s.size());
@@ -739,4 +771,694 @@ TEST_F(LiveCaptionerTest, EdgeCase_RmsBasedVadProb_SilenceProducesLowProb) {
     }
 }
 
+// =============================================================================
+// Per-frame VAD side channel
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, FrameVadTags_SegmentExactlyTheTaggedFrames) {
+    std::mutex sizes_mutex;
+    std::vector<size_t> final_sizes;
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t count, std::vector<TranscriptionSegment>& out) {
+            {
+                std::lock_guard<std::mutex> lock(sizes_mutex);
+                final_sizes.push_back(count);
+            }
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    cfg.min_samples_for_partial = 1000000;  // Finals only
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+    ASSERT_EQ(480u, captioner.GetVadFrameSamples());
+
+    // Silent samples, so only the tags can start speech: frames [10, 40) are speech
+    auto audio = MakeSilence(480 * 60);
+    std::vector<float> probs(60, 0.0f);
+    std::fill(probs.begin() + 10, probs.begin() + 40, 1.0f);
+    // Uneven calls, each a whole number of frames
+    size_t frame = 0;
+    for (size_t frames : {7, 13, 25, 15}) {
+        ASSERT_EQ(frames * 480, captioner.FeedAudio(audio.data() + frame * 480, frames * 480,
+                                                    &probs[frame], frames));
+        frame += frames;
+    }
+
+    ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(sizes_mutex);
+        return !final_sizes.empty();
+    }));
+    captioner.Stop();
+
+    // Confirmed on the 2nd speech frame, closed by the 2nd silent one:
+    // frames [11, 42) at 48 kHz = 31 * 160 samples at 16 kHz
+    std::lock_guard<std::mutex> lock(sizes_mutex);
+    ASSERT_EQ(1u, final_sizes.size());
+    EXPECT_NEAR(31.0 * 160.0, static_cast<double>(final_sizes[0]), 16.0);
+}
+
+TEST_F(LiveCaptionerTest, FrameVadTags_OverrideTheBuiltInVad) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    // Loud samples FrameVAD would call speech, tagged as silence
+    auto speech = MakeSpeech(4800);
+    const std::vector<float> probs(10, 0.0f);
+    for (int i = 0; i < 8; ++i) {
+        captioner.FeedAudio(speech.data(), speech.size(), probs.data(), probs.size());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    captioner.Stop();
+    EXPECT_EQ(0u, EventCount());
+}
+
+TEST_F(LiveCaptionerTest, FrameVadTags_FollowDelayedVadAcrossUnalignedBlocks) {
+    std::mutex sizes_mutex;
+    std::vector<size_t> final_sizes;
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t count, std::vector<TranscriptionSegment>& out) {
+            {
+                std::lock_guard<std::mutex> lock(sizes_mutex);
+                final_sizes.push_back(count);
+            }
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    cfg.min_samples_for_partial = 1000000;  // Finals only
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    // 256-sample blocks through a VAD with RNNoise's one-frame delay: input
+    // frame k is judged in the block that completes it, and its output is
+    // frame k + 1 of the stream. Input frames [10, 40) are speech.
+    auto audio = MakeSilence(480 * 60);
+    std::vector<float> probs(60, 0.0f);
+    std::fill(probs.begin() + 10, probs.begin() + 40, 1.0f);
+    for (size_t start = 0; start < audio.size(); start += 256) {
+        const size_t count = std::min<size_t>(256, audio.size() - start);
+        const size_t end = start + count;
+        const size_t frame = end / 480 - 1;  // Completed in this block, if any
+        if (end >= 480 && end % 480 < count) {
+            const size_t offset = (frame + 1) * 480 - start;  // Output frame frame + 1
+            ASSERT_EQ(count, captioner.FeedAudio(audio.data() + start, count, &probs[frame], 1,
+                                                 offset));
+        } else {
+            ASSERT_EQ(count, captioner.FeedAudio(audio.data() + start, count));
+        }
+    }
+
+    ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(sizes_mutex);
+        return !final_sizes.empty();
+    }));
+    captioner.Stop();
+
+    // Output frames [11, 41) are speech: frames [12, 43) as in the aligned case
+    std::lock_guard<std::mutex> lock(sizes_mutex);
+    ASSERT_EQ(1u, final_sizes.size());
+    EXPECT_NEAR(31.0 * 160.0, static_cast<double>(final_sizes[0]), 16.0);
+}
+
+TEST_F(LiveCaptionerTest, SmallRing_IngestsWholeFramesOnly) {
+    std::mutex sizes_mutex;
+    std::vector<size_t> final_sizes;
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t count, std::vector<TranscriptionSegment>& out) {
+            {
+                std::lock_guard<std::mutex> lock(sizes_mutex);
+                final_sizes.push_back(count);
+            }
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    cfg.min_samples_for_partial = 1000000;  // Finals only
+    cfg.ring_buffer_capacity = 1200;        // 2.5 frames: batches of 2, never 10
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    // Tagged as in FrameVadTags_SegmentExactlyTheTaggedFrames, fed in
+    // half frames as the small ring drains
+    auto audio = MakeSilence(480 * 60);
+    std::vector<float> probs(60, 0.0f);
+    std::fill(probs.begin() + 10, probs.begin() + 40, 1.0f);
+    for (size_t start = 0; start < audio.size(); start += 240) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (captioner.FeedAudio(audio.data() + start, 240, &probs[start / 480],
+                                   start % 480 == 0 ? 1 : 0) == 0) {
+            ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(sizes_mutex);
+        return !final_sizes.empty();
+    }));
+    captioner.Stop();
+
+    std::lock_guard<std::mutex> lock(sizes_mutex);
+    ASSERT_EQ(1u, final_sizes.size());
+    EXPECT_NEAR(31.0 * 160.0, static_cast<double>(final_sizes[0]), 16.0);
+}
+
+TEST_F(LiveCaptionerTest, Initialize_RejectsRingBelowOneFrame) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.ring_buffer_capacity = 479;
+    LiveCaptioner captioner(cfg);
+    EXPECT_FALSE(captioner.Initialize());
+    EXPECT_NE(std::string::npos, captioner.GetLastError().find("ring_buffer_capacity"));
+}
+
+TEST_F(LiveCaptionerTest, FrameVadTags_WriteWhatFitsLikePlainFeed) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.ring_buffer_capacity = 2000;
+    LiveCaptioner captioner(cfg);
+    ASSERT_TRUE(captioner.Initialize());
+
+    auto audio = MakeSilence(3000);
+    const std::vector<float> probs(6, 1.0f);
+    // Under one frame, off the grid, then tags reaching into the next block
+    EXPECT_EQ(470u, captioner.FeedAudio(audio.data(), 470, probs.data(), 1, 10));
+    EXPECT_EQ(1000u, captioner.FeedAudio(audio.data(), 1000, probs.data(), 2, 490));
+    EXPECT_EQ(530u, captioner.FeedAudio(audio.data(), 960, probs.data(), 2));  // Ring full
+    EXPECT_EQ(0u, captioner.FeedAudio(audio.data(), 480, probs.data(), 1));
+}
+
+// =============================================================================
+// Incremental (streaming) partials
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, IncrementalPartial_ConfirmsStableTextAndBoundsWindow) {
+    // Every decode returns the same two words spanning the first 200 ms of the
+    // window, so consecutive hypotheses agree and the window keeps advancing.
+    std::mutex sizes_mutex;
+    std::vector<size_t> call_sizes;
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t count, std::vector<TranscriptionSegment>& out) {
+            {
+                std::lock_guard<std::mutex> lock(sizes_mutex);
+                call_sizes.push_back(count);
+            }
+            out.clear();
+            TranscriptionSegment seg(0, 200, " hello world", 0.9f);
+            seg.words.emplace_back(0, 100, " hello", 0.9f);
+            seg.words.emplace_back(100, 200, " world", 0.9f);
+            out.push_back(seg);
+            return true;
+        });
+    cfg.incremental_partials = true;
+    cfg.partial_window_ms = 300;  // 4800 samples of 16 kHz Whisper-format audio
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 4800;
+    cfg.vad_prob_source = []() { return 0.9f; };
+    cfg.vad.min_silence_frames = 100000;
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    for (int i = 0; i < 20; ++i) {
+        auto s = MakeSpeech(4800);
+        captioner.FeedAudio(s.data(), s.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+
+    bool confirmed = WaitFor(
+        [this]() {
+            for (const auto& ev : CollectEvents()) {
+                if (ev.type == CaptionEventType::Partial &&
+                    ev.text.find("hello world") != std::string::npos) {
+                    return true;
+                }
+            }
+            return false;
+        },
+        4000);
+
+    // Snapshot partial decode sizes before Stop() triggers the full Final decode
+    std::vector<size_t> partial_sizes;
+    {
+        std::lock_guard<std::mutex> lock(sizes_mutex);
+        partial_sizes = call_sizes;
+    }
+    captioner.Stop();
+
+    EXPECT_TRUE(confirmed);
+    ASSERT_FALSE(partial_sizes.empty());
+    for (size_t n : partial_sizes) {
+        EXPECT_LE(n, 4800u) << "Incremental partials must not re-decode beyond the window";
+    }
+}
+
+TEST_F(LiveCaptionerTest, IncrementalPartial_StatesResetAfterFinal) {
+    std::atomic<float> vad_prob{0.9f};
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.incremental_partials = true;
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 4800;
+    cfg.vad_prob_source = [&vad_prob]() { return vad_prob.load(); };
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    for (int utterance = 0; utterance < 2; ++utterance) {
+        vad_prob.store(0.9f);
+        for (int i = 0; i < 6; ++i) {
+            auto s = MakeSpeech(4800);
+            captioner.FeedAudio(s.data(), s.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        }
+        vad_prob.store(0.0f);
+        for (int i = 0; i < 4; ++i) {
+            auto s = MakeSilence(4800);
+            captioner.FeedAudio(s.data(), s.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        }
+    }
+
+    WaitFor(
+        [this]() {
+            size_t finals = 0;
+            for (const auto& ev : CollectEvents()) {
+                finals += (ev.type == CaptionEventType::Final) ? 1 : 0;
+            }
+            return finals >= 2;
+        },
+        4000);
+    captioner.Stop();
+
+    // A partial of the second utterance must not carry text from the first
+    for (const auto& ev : CollectEvents()) {
+        if (ev.type == CaptionEventType::Partial) {
+            EXPECT_EQ(ev.text.find("hello world hello world"), std::string::npos)
+                << "Partial text leaked across utterances: " << ev.text;
+        }
+    }
+}
+
+TEST_F(LiveCaptionerTest, IncrementalPartial_KeepsItsUtteranceIdWhenFinalQueuedMeanwhile) {
+    // Hold the first (partial) decode until the utterance has ended and its
+    // Final is queued; the partial must still carry its own utterance's id
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t, std::vector<TranscriptionSegment>& out) {
+            if (calls.fetch_add(1) == 0) {
+                WaitFor([&]() { return release.load(); }, 4000);
+            }
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    std::atomic<float> vad_prob{0.9f};
+    cfg.vad_prob_source = [&vad_prob]() { return vad_prob.load(); };
+    cfg.incremental_partials = true;
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 4800;
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    for (int i = 0; i < 4; ++i) {
+        auto s = MakeSpeech(4800);
+        captioner.FeedAudio(s.data(), s.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+    ASSERT_TRUE(WaitFor([&]() { return calls.load() > 0; }));
+    vad_prob.store(0.0f);
+    for (int i = 0; i < 4; ++i) {
+        auto s = MakeSilence(4800);
+        captioner.FeedAudio(s.data(), s.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Final is queued by now
+    release.store(true);
+
+    ASSERT_TRUE(WaitFor([this]() {
+        for (const auto& ev : CollectEvents()) {
+            if (ev.type == CaptionEventType::Final) {
+                return true;
+            }
+        }
+        return false;
+    }));
+    captioner.Stop();
+
+    const auto evs = CollectEvents();
+    ASSERT_GE(evs.size(), 2u);
+    ASSERT_EQ(CaptionEventType::Partial, evs[0].type);
+    EXPECT_EQ(0u, evs[0].utterance_id) << "Partial stamped with the next utterance's id";
+    for (const auto& ev : evs) {
+        if (ev.type == CaptionEventType::Final) {
+            EXPECT_EQ(evs[0].utterance_id, ev.utterance_id);
+            break;
+        }
+    }
+}
+
+// =============================================================================
+// Ingest / inference decoupling
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, SlowTranscription_DoesNotStallIngest) {
+    // Each decode takes much longer than the ring buffer can absorb at the
+    // feed rate below; ingest must keep draining regardless.
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([](const int16_t*, size_t, std::vector<TranscriptionSegment>& out) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            out.clear();
+            out.emplace_back(0LL, 500LL, "slow", 0.9f);
+            return true;
+        });
+    cfg.ring_buffer_capacity = 19200;  // 400 ms at 48 kHz
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 4800;
+    cfg.vad_prob_source = []() { return 0.9f; };
+    cfg.vad.min_silence_frames = 100000;
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    size_t short_writes = 0;
+    for (int i = 0; i < 30; ++i) {
+        auto s = MakeSpeech(4800);
+        if (captioner.FeedAudio(s.data(), s.size()) < s.size()) {
+            ++short_writes;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    }
+    captioner.Stop();
+
+    EXPECT_EQ(short_writes, 0u) << "FeedAudio dropped audio while Whisper was busy";
+    EXPECT_GT(captioner.GetDroppedPartials(), 0u) << "Stale partials should have been replaced";
+}
+
+TEST_F(LiveCaptionerTest, StalePartials_DroppedWhenFinalQueued) {
+    // Block the first decode until the utterance has ended, so every later
+    // partial of the utterance is still queued when its Final arrives.
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t, std::vector<TranscriptionSegment>& out) {
+            if (calls.fetch_add(1) == 0) {
+                WaitFor([&]() { return release.load(); }, 4000);
+            }
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    std::atomic<float> vad_prob{0.9f};
+    cfg.vad_prob_source = [&vad_prob]() { return vad_prob.load(); };
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 4800;
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    for (int i = 0; i < 8; ++i) {
+        auto s = MakeSpeech(4800);
+        captioner.FeedAudio(s.data(), s.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+    vad_prob.store(0.0f);
+    for (int i = 0; i < 4; ++i) {
+        auto s = MakeSilence(4800);
+        captioner.FeedAudio(s.data(), s.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    release.store(true);
+
+    bool got_final = WaitFor(
+        [this]() {
+            for (const auto& ev : CollectEvents()) {
+                if (ev.type == CaptionEventType::Final) {
+                    return true;
+                }
+            }
+            return false;
+        },
+        4000);
+    captioner.Stop();
+
+    ASSERT_TRUE(got_final);
+    EXPECT_GT(captioner.GetDroppedPartials(), 0u);
+
+    // Only the partial that was already decoding may be delivered, and never
+    // after the Final of its utterance.
+    auto evs = CollectEvents();
+    size_t partials = 0;
+    bool seen_final = false;
+    for (const auto& ev : evs) {
+        if (ev.type == CaptionEventType::Final) {
+            seen_final = true;
+        } else {
+            ++partials;
+            EXPECT_FALSE(seen_final) << "Partial delivered after its Final";
+        }
+    }
+    EXPECT_LE(partials, 1u);
+}
+
+// =============================================================================
+// Whisper-format accumulation
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, JobAudio_IsConvertedTo16kHzMono) {
+    // Stereo 48 kHz: left 10000, right 6000 -> mono 8000 at a third of the frames
+    std::mutex calls_mutex;
+    std::vector<std::pair<CaptionEventType, std::vector<int16_t>>> calls;
+    std::atomic<bool> in_final{false};
+    LiveCaptionerConfig cfg = MakeTestConfig(
+        [&](const int16_t* samples, size_t count, std::vector<TranscriptionSegment>& out) {
+            std::lock_guard<std::mutex> lock(calls_mutex);
+            calls.emplace_back(in_final.load() ? CaptionEventType::Final
+                                               : CaptionEventType::Partial,
+                               std::vector<int16_t>(samples, samples + count));
+            out.clear();
+            out.emplace_back(0LL, 500LL, "hello world", 0.9f);
+            return true;
+        });
+    cfg.channels = 2;
+    cfg.partial_interval_ms = 0;
+    cfg.min_samples_for_partial = 9600;
+    std::atomic<float> vad_prob{0.9f};
+    cfg.vad_prob_source = [&vad_prob]() { return vad_prob.load(); };
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    std::vector<int16_t> stereo(4800);
+    for (size_t i = 0; i < stereo.size(); i += 2) {
+        stereo[i] = 10000;
+        stereo[i + 1] = 6000;
+    }
+    constexpr int kSpeechBatches = 8;
+    for (int i = 0; i < kSpeechBatches; ++i) {
+        captioner.FeedAudio(stereo.data(), stereo.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }
+    ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(calls_mutex);
+        return !calls.empty();
+    }));
+    in_final.store(true);
+    captioner.Stop();  // Flushes the utterance as a Final
+
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    ASSERT_GE(calls.size(), 2u);
+    const size_t max_samples = kSpeechBatches * stereo.size() / 2 / 3;
+    for (const auto& [type, samples] : calls) {
+        ASSERT_GT(samples.size(), 64u);
+        EXPECT_LE(samples.size(), max_samples);
+        // Away from the filter edges the downmixed level comes through unchanged
+        EXPECT_NEAR(8000, samples[samples.size() / 2], 40);
+    }
+    EXPECT_EQ(CaptionEventType::Final, calls.back().first);
+}
+
+// =============================================================================
+// Speaker labelling tests
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, SpeakerFn_LabelsEachFinal) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.min_samples_for_partial = 4800;
+    cfg.partial_interval_ms = 0;
+    std::atomic<int> speaker_calls{0};
+    std::atomic<size_t> speaker_samples{0};
+    cfg.speaker_fn = [&](const float*, size_t count) {
+        speaker_samples.store(count);
+        return static_cast<int32_t>(10 + speaker_calls.fetch_add(1));
+    };
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    // Two utterances, each 0.4 s of speech followed by 0.2 s of silence
+    for (int utterance = 0; utterance < 2; ++utterance) {
+        for (int i = 0; i < 4; ++i) {
+            auto speech = MakeSpeech(4800);
+            captioner.FeedAudio(speech.data(), speech.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        }
+        for (int i = 0; i < 2; ++i) {
+            auto silence = MakeSilence(4800);
+            captioner.FeedAudio(silence.data(), silence.size());
+        }
+        ASSERT_TRUE(WaitFor([&]() { return speaker_calls.load() > utterance; }));
+    }
+    captioner.Stop();
+
+    EXPECT_EQ(2, speaker_calls.load());
+    // The speaker sees the utterance as Whisper does: 16 kHz
+    EXPECT_GT(speaker_samples.load(), 0u);
+    EXPECT_LE(speaker_samples.load(), 6u * 4800 / 3);
+
+    std::vector<int32_t> final_speakers;
+    for (const auto& ev : CollectEvents()) {
+        if (ev.type == CaptionEventType::Final) {
+            final_speakers.push_back(ev.speaker_id);
+        } else {
+            EXPECT_EQ(-1, ev.speaker_id);
+        }
+    }
+    EXPECT_EQ((std::vector<int32_t>{10, 11}), final_speakers);
+}
+
+TEST_F(LiveCaptionerTest, LanguageLock_HoldsWhileTokensAreConfident) {
+    // Segments carry what WhisperProcessor extracts: confidence is the mean
+    // probability of their tokens
+    std::atomic<float> token_p{0.8f};
+    std::mutex requested_mutex;
+    std::vector<std::string> requested;
+    LiveCaptionerConfig cfg =
+        MakeTestConfig([&](const int16_t*, size_t, std::vector<TranscriptionSegment>& out) {
+            const float p = token_p.load();
+            const std::vector<WordToken> tokens = {{" hello", 0, 200, p}, {" world", 200, 400, p}};
+            out.clear();
+            out.emplace_back(0LL, 400LL, " hello world", MeanTokenProbability(tokens));
+            return true;
+        });
+    cfg.min_samples_for_partial = 1000000;  // Finals only
+    cfg.language_fn = [&](const std::string& language) {
+        std::lock_guard<std::mutex> lock(requested_mutex);
+        requested.push_back(language);
+        return std::string("en");
+    };
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+
+    auto finals = [&]() {
+        std::lock_guard<std::mutex> lock(requested_mutex);
+        return requested.size();
+    };
+    for (size_t utterance = 0; utterance < 8; ++utterance) {
+        if (utterance == 5) {
+            token_p.store(0.1f);  // The locked language stops fitting
+        }
+        for (int i = 0; i < 4; ++i) {
+            auto speech = MakeSpeech(4800);
+            captioner.FeedAudio(speech.data(), speech.size());
+        }
+        for (int i = 0; i < 2; ++i) {
+            auto silence = MakeSilence(4800);
+            captioner.FeedAudio(silence.data(), silence.size());
+        }
+        ASSERT_TRUE(WaitFor([&]() { return finals() > utterance; }));
+    }
+    captioner.Stop();
+
+    // Locked after three probe finals; confident finals keep it, two weak ones release it
+    std::lock_guard<std::mutex> lock(requested_mutex);
+    EXPECT_EQ((std::vector<std::string>{"auto", "auto", "auto", "en", "en", "en", "en", "auto"}),
+              requested);
+}
+
+// =============================================================================
+// Startup: background model load and time to first caption
+// =============================================================================
+
+TEST_F(LiveCaptionerTest, BackgroundInit_ReturnsAtOnceAndReportsLoadFailure) {
+    LiveCaptionerConfig cfg = MakeTestConfig();
+    cfg.transcribe_fn = nullptr;  // Load a real model, which does not exist
+    cfg.whisper.model_path = "/nonexistent/ggml-missing.bin";
+    cfg.background_init = true;
+    cfg.vad.min_silence_frames = 10000;
+
+    LiveCaptioner captioner(cfg);
+    captioner.SetCallback(MakeCallback());
+    ASSERT_TRUE(captioner.Initialize());
+    ASSERT_TRUE(captioner.Start());
+    for (int i = 0; i < 4; ++i) {
+        auto speech = MakeSpeech(4800);
+        captioner.FeedAudio(speech.data(), speech.size());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // The flushed Final still arrives, empty, once the failed load is known
+    captioner.Stop();
+    EXPECT_FALSE(captioner.IsModelReady());
+    EXPECT_NE(std::string::npos, captioner.GetLastError().find("initialization failed"));
+    const auto evs = CollectEvents();
+    ASSERT_FALSE(evs.empty());
+    EXPECT_EQ(CaptionEventType::Final, evs.back().type);
+    EXPECT_TRUE(evs.back().text.empty());
+}
+
+TEST_F(LiveCaptionerTest, TimeToFirstCaption_MeasuredFromInitialize) {
+    LiveCaptioner captioner(MakeTestConfig());
+    captioner.SetCallback(MakeCallback());
+    EXPECT_EQ(-1, captioner.GetTimeToFirstCaptionMs());
+    ASSERT_TRUE(captioner.Initialize());
+    EXPECT_TRUE(captioner.IsModelReady());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(captioner.Start());
+    for (int i = 0; i < 4; ++i) {
+        auto speech = MakeSpeech(4800);
+        captioner.FeedAudio(speech.data(), speech.size());
+    }
+    for (int i = 0; i < 4; ++i) {
+        auto silence = MakeSilence(4800);
+        captioner.FeedAudio(silence.data(), silence.size());
+    }
+    ASSERT_TRUE(WaitFor([this]() { return EventCount() > 0; }));
+    captioner.Stop();
+
+    const int64_t first_ms = captioner.GetTimeToFirstCaptionMs();
+    EXPECT_GE(first_ms, 50);
+    EXPECT_LT(first_ms, 4000);
+}
+
 #endif  // ENABLE_WHISPER
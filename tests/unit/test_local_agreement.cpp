@@ -0,0 +1,115 @@
+/**
+ * @file test_local_agreement.cpp
+ * @brief Unit tests for LocalAgreement streaming transcript stabilization
+ */
+
+#include "audio/local_agreement.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+std::vector<Word> MakeWords(const std::vector<std::string>& texts, int64_t start_ms = 0,
+                            int64_t step_ms = 100) {
+    std::vector<Word> words;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        const int64_t t0 = start_ms + static_cast<int64_t>(i) * step_ms;
+        words.emplace_back(t0, t0 + step_ms, " " + texts[i], 0.9f);
+    }
+    return words;
+}
+
+}  // namespace
+
+TEST(LocalAgreementTest, FirstHypothesisIsTentative) {
+    LocalAgreement la;
+    EXPECT_EQ(la.Update(MakeWords({"hello", "world"})), 0u);
+    EXPECT_TRUE(la.GetCommitted().empty());
+    EXPECT_EQ(la.GetTentative().size(), 2u);
+    EXPECT_EQ(la.GetText(), " hello world");
+    EXPECT_EQ(la.GetCommittedEndMs(), 0);
+}
+
+TEST(LocalAgreementTest, CommitsCommonPrefixOfConsecutiveHypotheses) {
+    LocalAgreement la;
+    la.Update(MakeWords({"the", "cat", "sad"}));
+    EXPECT_EQ(la.Update(MakeWords({"the", "cat", "sat", "down"})), 2u);
+
+    ASSERT_EQ(la.GetCommitted().size(), 2u);
+    EXPECT_EQ(la.GetCommittedText(), " the cat");
+    EXPECT_EQ(la.GetCommittedEndMs(), 200);
+    ASSERT_EQ(la.GetTentative().size(), 2u);
+    EXPECT_EQ(la.GetText(), " the cat sat down");
+}
+
+TEST(LocalAgreementTest, ComparisonIgnoresCaseAndPunctuation) {
+    LocalAgreement la;
+    la.Update(MakeWords({"Hello,", "world"}));
+    EXPECT_EQ(la.Update(MakeWords({"hello", "World."})), 2u);
+}
+
+TEST(LocalAgreementTest, DropsWordsEchoedFromCommittedText) {
+    LocalAgreement la;
+    la.Update(MakeWords({"good", "morning"}));
+    la.Update(MakeWords({"good", "morning"}));
+    ASSERT_EQ(la.GetCommitted().size(), 2u);
+
+    // The next window starts after "morning" but Whisper repeats the prompt.
+    la.Update(MakeWords({"morning", "everyone"}, 200));
+    la.Update(MakeWords({"morning", "everyone"}, 200));
+    EXPECT_EQ(la.GetCommittedText(), " good morning everyone");
+}
+
+TEST(LocalAgreementTest, CommitUntilForcesOldTentativeWords) {
+    LocalAgreement la;
+    la.Update(MakeWords({"a", "b", "c", "d"}));
+    EXPECT_EQ(la.CommitUntil(200), 2u);
+    EXPECT_EQ(la.GetCommittedText(), " a b");
+    EXPECT_EQ(la.GetTentative().size(), 2u);
+}
+
+TEST(LocalAgreementTest, ResetClearsState) {
+    LocalAgreement la;
+    la.Update(MakeWords({"x"}));
+    la.Update(MakeWords({"x"}));
+    la.Reset();
+    EXPECT_TRUE(la.GetCommitted().empty());
+    EXPECT_TRUE(la.GetTentative().empty());
+    EXPECT_EQ(la.GetText(), "");
+}
+
+TEST(LocalAgreementTest, SegmentsToWordsUsesWordTimestamps) {
+    TranscriptionSegment seg(0, 1000, " hi there");
+    seg.words.emplace_back(0, 400, " hi", 0.8f);
+    seg.words.emplace_back(400, 1000, " there", 0.7f);
+
+    auto words = LocalAgreement::SegmentsToWords({seg}, 2000);
+    ASSERT_EQ(words.size(), 2u);
+    EXPECT_EQ(words[0].start_ms, 2000);
+    EXPECT_EQ(words[0].end_ms, 2400);
+    EXPECT_EQ(words[1].end_ms, 3000);
+}
+
+TEST(LocalAgreementTest, SegmentsToWordsSplitsTextWithoutWordTimestamps) {
+    TranscriptionSegment seg(100, 900, "one two three", 0.5f);
+    auto words = LocalAgreement::SegmentsToWords({seg}, 1000);
+    ASSERT_EQ(words.size(), 3u);
+    EXPECT_EQ(words[0].text, " one");
+    // Only the segment end is a reliable boundary
+    EXPECT_EQ(words[0].end_ms, 1100);
+    EXPECT_EQ(words[1].end_ms, 1100);
+    EXPECT_EQ(words[2].end_ms, 1900);
+}
+
+TEST(LocalAgreementTest, JoinWordsInsertsMissingSpaces) {
+    std::vector<Word> words;
+    words.emplace_back(0, 1, "foo", 1.0f);
+    words.emplace_back(1, 2, "bar", 1.0f);
+    words.emplace_back(2, 3, " baz", 1.0f);
+    EXPECT_EQ(LocalAgreement::JoinWords(words), "foo bar baz");
+}
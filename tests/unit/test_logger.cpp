@@ -10,6 +10,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace ffvoice;
 
@@ -259,3 +261,104 @@ TEST_F(LoggerTest, AllLevels_GoesToStderr_WithPrefixes) {
     // stdout must be completely empty
     EXPECT_TRUE(out.str().empty()) << "Unexpected stdout output: " << out.str();
 }
+
+// =============================================================================
+// Async Mode and Compile-Time Filtering
+// =============================================================================
+
+namespace {
+
+size_t CountOccurrences(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST_F(LoggerTest, AsyncMode_WritesQueuedMessagesOnFlush) {
+    StreamCapture err(std::cerr);
+    set_async_logging(true);
+    EXPECT_TRUE(is_async_logging());
+
+    LOG_INFO("async message %d", 1);
+    log_error("async error");
+    flush_log();
+    const std::string flushed = err.str();
+
+    set_async_logging(false);
+    EXPECT_FALSE(is_async_logging());
+
+    EXPECT_NE(std::string::npos, flushed.find("[INFO] async message 1"));
+    EXPECT_NE(std::string::npos, flushed.find("[ERROR] async error"));
+    EXPECT_LT(flushed.find("async message 1"), flushed.find("async error"));
+}
+
+TEST_F(LoggerTest, AsyncMode_CoalescesRepeatedMessages) {
+    StreamCapture err(std::cerr);
+    set_async_logging(true);
+
+    for (int i = 0; i < 100; ++i) {
+        LOG_ERROR("Input overflow detected");
+    }
+    LOG_INFO("something else");
+    set_async_logging(false);  // Drains the queue
+
+    const std::string captured = err.str();
+    EXPECT_EQ(2u, CountOccurrences(captured, "Input overflow detected"));
+    EXPECT_NE(std::string::npos,
+              captured.find("[ERROR] Input overflow detected (repeated 99 more times)"));
+    EXPECT_NE(std::string::npos, captured.find("[INFO] something else"));
+}
+
+TEST_F(LoggerTest, AsyncMode_StopWritesPendingRepeats) {
+    StreamCapture err(std::cerr);
+    set_async_logging(true);
+    log_warning("same warning");
+    log_warning("same warning");
+    log_warning("same warning");
+    set_async_logging(false);
+
+    EXPECT_NE(std::string::npos, err.str().find("same warning (repeated 2 more times)"));
+}
+
+TEST_F(LoggerTest, AsyncMode_ConcurrentProducersLoseNothingUnlessCounted) {
+    StreamCapture err(std::cerr);
+    const uint64_t dropped_before = get_dropped_log_messages();
+    set_async_logging(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 50; ++i) {
+                LOG_INFO("producer %d message %d", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    set_async_logging(false);
+
+    const uint64_t dropped = get_dropped_log_messages() - dropped_before;
+    const std::string captured = err.str();
+    EXPECT_EQ(200u, CountOccurrences(captured, "[INFO] producer ") + dropped);
+}
+
+TEST_F(LoggerTest, SyncModeAfterAsyncWritesImmediately) {
+    set_async_logging(true);
+    set_async_logging(false);
+
+    StreamCapture err(std::cerr);
+    log_info("back to sync");
+    EXPECT_NE(std::string::npos, err.str().find("[INFO] back to sync"));
+}
+
+TEST_F(LoggerTest, DiscardedLevelEvaluatesNothing) {
+    int evaluated = 0;
+    FFVOICE_LOG_DISCARD("%d", ++evaluated);
+    EXPECT_EQ(0, evaluated);
+}
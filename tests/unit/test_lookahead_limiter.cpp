@@ -0,0 +1,211 @@
+/**
+ * @file test_lookahead_limiter.cpp
+ * @brief Unit tests for LookaheadLimiter (ceiling, lookahead, release, AGC, latency)
+ */
+
+#include "audio/biquad_cascade.h"
+#include "audio/lookahead_limiter.h"
+#include "audio/processor_chain.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kRate = 48000;
+const float kCeiling = std::pow(10.0f, -1.0f / 20.0f);  // Default -1 dBFS
+
+std::vector<float> Tone(double frequency, double amplitude, size_t frames, int channels = 1) {
+    std::vector<float> tone(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < channels; ++ch) {
+            tone[i * channels + ch] =
+                static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * i / kRate + ch));
+        }
+    }
+    return tone;
+}
+
+/// Feed @p samples through @p limiter in uneven blocks
+void ProcessInBlocks(LookaheadLimiter& limiter, std::vector<float>& samples, int channels) {
+    const size_t blocks[] = {1, 37, 128, 129, 480, 3};
+    const size_t frames = samples.size() / channels;
+    size_t done = 0;
+    for (size_t b = 0; done < frames; ++b) {
+        const size_t n = std::min(blocks[b % 6], frames - done);
+        limiter.Process(samples.data() + done * channels, n * channels);
+        done += n;
+    }
+}
+
+float Peak(const std::vector<float>& samples, size_t from = 0, size_t to = SIZE_MAX) {
+    float peak = 0.0f;
+    for (size_t i = from; i < std::min(to, samples.size()); ++i) {
+        peak = std::max(peak, std::fabs(samples[i]));
+    }
+    return peak;
+}
+
+double Rms(const std::vector<float>& samples, size_t from, size_t to) {
+    double sum = 0.0;
+    for (size_t i = from; i < to; ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return std::sqrt(sum / static_cast<double>(to - from));
+}
+
+}  // namespace
+
+TEST(LookaheadLimiterTest, NeverExceedsCeiling) {
+    for (int channels : {1, 2}) {
+        LookaheadLimiter limiter;
+        ASSERT_TRUE(limiter.Initialize(kRate, channels));
+
+        // Quiet speech-level tone with bursts up to 4x full scale
+        std::vector<float> signal = Tone(440.0, 0.2, kRate, channels);
+        for (size_t burst = 0; burst < 4; ++burst) {
+            const size_t start = (burst * 11000 + 3000) * channels;
+            for (size_t i = start; i < start + 2000 * channels; ++i) {
+                signal[i] *= 5.0f + 5.0f * static_cast<float>(burst);
+            }
+        }
+        ProcessInBlocks(limiter, signal, channels);
+        EXPECT_LE(Peak(signal), kCeiling * 1.00001f) << channels << " channels";
+        EXPECT_LT(limiter.GetGainReductionDb(), 1e-3f);
+    }
+}
+
+TEST(LookaheadLimiterTest, PassesQuietAudioDelayedByLatency) {
+    LookaheadLimiter limiter;
+    ASSERT_TRUE(limiter.Initialize(kRate, 2));
+    EXPECT_EQ(240u, limiter.GetLatencyFrames());
+
+    const std::vector<float> input = Tone(1000.0, 0.5, 4800, 2);
+    std::vector<float> output = input;
+    ProcessInBlocks(limiter, output, 2);
+
+    const size_t delay = limiter.GetLatencyFrames() * 2;
+    for (size_t i = 0; i < delay; ++i) {
+        ASSERT_EQ(0.0f, output[i]);
+    }
+    for (size_t i = delay; i < output.size(); ++i) {
+        ASSERT_EQ(input[i - delay], output[i]) << i;  // Unity gain is exact
+    }
+    EXPECT_FLOAT_EQ(0.0f, limiter.GetGainReductionDb());
+}
+
+TEST(LookaheadLimiterTest, GainFallsBeforeThePeakAndRecoversAfter) {
+    LookaheadLimiterConfig config;
+    config.release_ms = 20.0f;
+    LookaheadLimiter limiter(config);
+    ASSERT_TRUE(limiter.Initialize(kRate, 1));
+    const size_t latency = limiter.GetLatencyFrames();
+
+    // Steady level with one 2.0 spike; output frame i + latency is input frame i
+    constexpr size_t kSpike = 10000;
+    std::vector<float> signal(kRate, 0.5f);
+    signal[kSpike] = 2.0f;
+    limiter.Process(signal.data(), signal.size());
+
+    // The minimum and the average each span latency + 1 frames, so the gain starts falling
+    // 2 * latency input frames ahead of the spike
+    EXPECT_FLOAT_EQ(0.5f, signal[kSpike - latency - 1]);
+    EXPECT_LT(signal[kSpike + latency / 2], 0.5f);  // Already turned down ahead of it
+    EXPECT_LE(signal[kSpike + latency], kCeiling * 1.00001f);
+    // The ramp down is smooth: no frame drops by more than a small step
+    for (size_t i = kSpike; i < kSpike + latency; ++i) {
+        ASSERT_LT(signal[i] - signal[i + 1], 0.01f) << i;
+    }
+    // Five release time constants later the gain is back to within 1%
+    EXPECT_NEAR(0.5f, signal[kSpike + 2 * latency + 5 * 960], 0.005f);
+}
+
+TEST(LookaheadLimiterTest, AgcLevelsQuietSpeechWithoutClipping) {
+    LookaheadLimiterConfig config;
+    config.agc_target_level = 0.2f;
+    LookaheadLimiter limiter(config);
+    ASSERT_TRUE(limiter.Initialize(kRate, 1));
+
+    // 4 s at -40 dBFS RMS: the gain starts at unity and climbs to its +20 dB limit
+    std::vector<float> quiet = Tone(300.0, 0.01 * std::sqrt(2.0), 4 * kRate);
+    ProcessInBlocks(limiter, quiet, 1);
+    EXPECT_NEAR(20.0f, limiter.GetAgcGainDb(), 0.5f);
+    EXPECT_NEAR(0.1, Rms(quiet, 3 * kRate, 4 * kRate), 0.005);
+
+    // Then a sudden near-full-scale shout, before the AGC has turned back down
+    std::vector<float> shout = Tone(300.0, 0.9, 2 * kRate);
+    ProcessInBlocks(limiter, shout, 1);
+    EXPECT_LE(Peak(shout), kCeiling * 1.00001f);  // The limiter catches it, not a clamp
+    EXPECT_NEAR(0.2, Rms(shout, kRate, 2 * kRate), 0.02);
+    EXPECT_LT(limiter.GetAgcGainDb(), -9.0f);
+}
+
+TEST(LookaheadLimiterTest, Int16OutputStaysBelowFullScale) {
+    LookaheadLimiter limiter;
+    ASSERT_TRUE(limiter.Initialize(kRate, 1));
+    std::vector<int16_t> square(9600);
+    for (size_t i = 0; i < square.size(); ++i) {
+        square[i] = (i / 50) % 2 == 0 ? 32767 : -32768;
+    }
+    limiter.Process(square.data(), square.size());
+    for (size_t i = 0; i < square.size(); ++i) {
+        ASSERT_LE(std::abs(static_cast<int>(square[i])), static_cast<int>(32767 * kCeiling) + 1)
+            << i;
+    }
+    EXPECT_NEAR(-1.0f, limiter.GetGainReductionDb(), 0.01f);
+}
+
+TEST(LookaheadLimiterTest, ResetClearsDelayLineAndEnvelope) {
+    LookaheadLimiter limiter;
+    ASSERT_TRUE(limiter.Initialize(kRate, 1));
+    std::vector<float> first = Tone(200.0, 3.0, 4800);
+    std::vector<float> second = first;
+    limiter.Process(first.data(), first.size());
+    limiter.Reset();
+    EXPECT_FLOAT_EQ(0.0f, limiter.GetGainReductionDb());
+    limiter.Process(second.data(), second.size());
+    EXPECT_EQ(first, second);
+}
+
+TEST(LookaheadLimiterTest, RejectsInvalidConfig) {
+    const auto rejects = [](auto change) {
+        LookaheadLimiterConfig config;
+        change(config);
+        return !LookaheadLimiter(config).Initialize(kRate, 1);
+    };
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) { c.ceiling_db = 0.5f; }));
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) { c.lookahead_ms = 0.0f; }));
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) { c.lookahead_ms = 60.0f; }));
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) { c.release_ms = 0.0f; }));
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) {
+        c.agc_target_level = 0.2f;
+        c.agc_min_gain_db = 3.0f;
+    }));
+    EXPECT_TRUE(rejects([](LookaheadLimiterConfig& c) { c.agc_target_level = 1.5f; }));
+    EXPECT_FALSE(rejects([](LookaheadLimiterConfig& c) { c.ceiling_db = 0.0f; }));
+    EXPECT_FALSE(LookaheadLimiter().Initialize(kRate, 0));
+}
+
+TEST(LookaheadLimiterTest, ChainsReportTotalLatency) {
+    AudioProcessorChain chain;
+    chain.AddProcessor(std::make_unique<BiquadCascade>());
+    chain.AddProcessor(std::make_unique<LookaheadLimiter>());
+    ASSERT_TRUE(chain.Initialize(kRate, 1));
+    EXPECT_EQ(240u, chain.GetLatencyFrames());
+
+    LookaheadLimiterConfig config;
+    config.lookahead_ms = 2.0f;
+    ProcessorChain<BiquadCascade, LookaheadLimiter> fixed(
+        BiquadCascade::ButterworthHighPass(80.0f, 2), config);
+    ASSERT_TRUE(fixed.Initialize(kRate, 1));
+    EXPECT_EQ(96u, fixed.GetLatencyFrames());
+    EXPECT_EQ(0u, BiquadCascade().GetLatencyFrames());
+}
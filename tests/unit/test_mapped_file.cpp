@@ -0,0 +1,62 @@
+/**
+ * @file test_mapped_file.cpp
+ * @brief Unit tests for MappedFile
+ */
+
+#include "utils/mapped_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace ffvoice;
+
+namespace {
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}  // namespace
+
+TEST(MappedFileTest, MapsWholeFile) {
+    const std::string path = TempPath("ffvoice_mapped_file.bin");
+    std::string contents(100000, '\0');
+    for (size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<char>(i * 7);
+    }
+    std::ofstream(path, std::ios::binary) << contents;
+
+    MappedFile file;
+    ASSERT_TRUE(file.Open(path)) << file.GetLastError();
+    EXPECT_TRUE(file.IsOpen());
+    ASSERT_EQ(contents.size(), file.GetSize());
+    EXPECT_EQ(0, std::memcmp(contents.data(), file.GetData(), contents.size()));
+
+    // Reopening replaces the previous mapping
+    ASSERT_TRUE(file.Open(path, false));
+    EXPECT_EQ(contents.size(), file.GetSize());
+    file.Close();
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_EQ(nullptr, file.GetData());
+    EXPECT_EQ(0u, file.GetSize());
+    file.Close();  // Idempotent
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, FailsOnMissingOrEmptyFile) {
+    MappedFile file;
+    EXPECT_FALSE(file.Open(TempPath("ffvoice_mapped_missing.bin")));
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_NE(std::string::npos, file.GetLastError().find("Cannot open"));
+
+    const std::string empty = TempPath("ffvoice_mapped_empty.bin");
+    std::ofstream(empty).close();
+    EXPECT_FALSE(file.Open(empty));
+    EXPECT_NE(std::string::npos, file.GetLastError().find("empty"));
+    std::remove(empty.c_str());
+}
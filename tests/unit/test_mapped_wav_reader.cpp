@@ -0,0 +1,199 @@
+/**
+ * @file test_mapped_wav_reader.cpp
+ * @brief Unit tests for MappedWavReader
+ */
+
+#include "media/mapped_wav_reader.h"
+#include "media/wav_writer.h"
+#include "utils/audio_kernels.h"
+#include "utils/polyphase_resampler.h"
+#include "utils/signal_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace ffvoice;
+
+class MappedWavReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_file_ = ::testing::TempDir() + "test_mapped_wav_reader.wav";
+    }
+
+    void TearDown() override {
+        std::remove(test_file_.c_str());
+    }
+
+    // Write interleaved int16 samples with WavWriter
+    void WriteWav(const std::vector<int16_t>& samples, int sample_rate, int channels) {
+        WavWriter writer;
+        ASSERT_TRUE(writer.Open(test_file_, sample_rate, channels));
+        writer.WriteSamples(samples);
+        writer.Close();
+    }
+
+    // Reference conversion: whole-buffer int16 -> float, downmix, ResampleBuffer
+    static std::vector<float> Reference(const std::vector<int16_t>& samples, int sample_rate,
+                                        int channels, int target_rate) {
+        const AudioKernels& kernels = GetAudioKernels();
+        const size_t frames = samples.size() / channels;
+        std::vector<float> mono(frames);
+        if (channels == 2) {
+            kernels.int16_stereo_to_mono(samples.data(), frames, mono.data());
+        } else {
+            kernels.int16_to_float(samples.data(), frames, mono.data());
+        }
+        if (sample_rate == target_rate) {
+            return mono;
+        }
+        std::vector<float> output(
+            static_cast<size_t>(frames * static_cast<double>(target_rate) / sample_rate));
+        PolyphaseResampler resampler(sample_rate, target_rate);
+        resampler.ResampleBuffer(mono.data(), mono.size(), output.data(), output.size());
+        return output;
+    }
+
+    // Stereo tone with different content per channel
+    static std::vector<int16_t> StereoTone(size_t frames, int sample_rate) {
+        const std::vector<int16_t> left =
+            SignalGenerator::GenerateSineWave(440.0, 1.0, sample_rate, 0.5);
+        const std::vector<int16_t> right =
+            SignalGenerator::GenerateSineWave(1000.0, 1.0, sample_rate, 0.3);
+        std::vector<int16_t> stereo(frames * 2);
+        for (size_t i = 0; i < frames; ++i) {
+            stereo[2 * i] = left[i % left.size()];
+            stereo[2 * i + 1] = right[i % right.size()];
+        }
+        return stereo;
+    }
+
+    std::string test_file_;
+};
+
+TEST_F(MappedWavReaderTest, OpenReadsHeader) {
+    WriteWav(StereoTone(48000, 48000), 48000, 2);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000)) << reader.GetLastError();
+    EXPECT_TRUE(reader.IsOpen());
+    EXPECT_EQ(48000, reader.GetSampleRate());
+    EXPECT_EQ(2, reader.GetChannels());
+    EXPECT_EQ(48000u, reader.GetNumFrames());
+    EXPECT_DOUBLE_EQ(1.0, reader.GetDurationSeconds());
+    EXPECT_EQ(16000u, reader.GetOutputSize());
+
+    reader.Close();
+    EXPECT_FALSE(reader.IsOpen());
+}
+
+TEST_F(MappedWavReaderTest, ReadAllMono16kIsPlainConversion) {
+    const std::vector<int16_t> samples =
+        SignalGenerator::GenerateSineWave(440.0, 0.5, 16000, 0.5);
+    WriteWav(samples, 16000, 1);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    std::vector<float> pcm;
+    ASSERT_TRUE(reader.ReadAll(pcm));
+    EXPECT_EQ(Reference(samples, 16000, 1, 16000), pcm);
+}
+
+TEST_F(MappedWavReaderTest, ReadAllStereo48kMatchesWholeBufferConversion) {
+    const std::vector<int16_t> samples = StereoTone(48000 + 123, 48000);
+    WriteWav(samples, 48000, 2);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    std::vector<float> pcm;
+    ASSERT_TRUE(reader.ReadAll(pcm));
+
+    const std::vector<float> expected = Reference(samples, 48000, 2, 16000);
+    ASSERT_EQ(expected.size(), pcm.size());
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        ASSERT_FLOAT_EQ(expected[i], pcm[i]) << "sample " << i;
+    }
+}
+
+TEST_F(MappedWavReaderTest, ChunksConcatenateToReadAll) {
+    const std::vector<int16_t> samples = StereoTone(44100 * 2, 44100);
+    WriteWav(samples, 44100, 2);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    std::vector<float> whole;
+    ASSERT_TRUE(reader.ReadAll(whole));
+
+    // Odd chunk size so chunk edges fall inside conversion blocks
+    reader.Rewind();
+    std::vector<float> joined;
+    std::vector<float> chunk;
+    while (reader.NextChunk(chunk, 1001)) {
+        EXPECT_LE(chunk.size(), 1001u);
+        joined.insert(joined.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_FALSE(reader.NextChunk(chunk, 1001));
+    EXPECT_TRUE(chunk.empty());
+
+    // The stream may carry one sample beyond the floor()ed ReadAll() size
+    ASSERT_GE(joined.size(), whole.size());
+    EXPECT_LE(joined.size(), whole.size() + 1);
+    for (size_t i = 0; i < whole.size(); ++i) {
+        ASSERT_FLOAT_EQ(whole[i], joined[i]) << "sample " << i;
+    }
+}
+
+TEST_F(MappedWavReaderTest, ChunksWithoutResamplingCoverEveryFrame) {
+    const std::vector<int16_t> samples =
+        SignalGenerator::GenerateSineWave(440.0, 1.0, 16000, 0.5);
+    WriteWav(samples, 16000, 1);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    std::vector<float> joined;
+    std::vector<float> chunk;
+    while (reader.NextChunk(chunk, 5000)) {
+        joined.insert(joined.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(Reference(samples, 16000, 1, 16000), joined);
+}
+
+TEST_F(MappedWavReaderTest, EmptyDataChunk) {
+    WriteWav({}, 48000, 1);
+
+    MappedWavReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    EXPECT_EQ(0u, reader.GetNumFrames());
+    std::vector<float> pcm;
+    EXPECT_TRUE(reader.ReadAll(pcm));
+    EXPECT_TRUE(pcm.empty());
+}
+
+TEST_F(MappedWavReaderTest, NonexistentFileFails) {
+    MappedWavReader reader;
+    EXPECT_FALSE(reader.Open("/nonexistent/path/file.wav"));
+    EXPECT_FALSE(reader.IsOpen());
+    EXPECT_FALSE(reader.GetLastError().empty());
+}
+
+TEST_F(MappedWavReaderTest, NonWavFileFails) {
+    {
+        std::ofstream file(test_file_, std::ios::binary);
+        file << "This is not a RIFF/WAVE file at all";
+    }
+    MappedWavReader reader;
+    EXPECT_FALSE(reader.Open(test_file_));
+    EXPECT_FALSE(reader.IsOpen());
+}
+
+TEST_F(MappedWavReaderTest, Non16BitFails) {
+    WavWriter writer;
+    ASSERT_TRUE(writer.Open(test_file_, 16000, 1, 24));
+    writer.Close();
+
+    MappedWavReader reader;
+    EXPECT_FALSE(reader.Open(test_file_));
+    EXPECT_NE(std::string::npos, reader.GetLastError().find("bit depth"));
+}
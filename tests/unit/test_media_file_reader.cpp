@@ -0,0 +1,116 @@
+/**
+ * @file test_media_file_reader.cpp
+ * @brief Unit tests for MediaFileReader
+ */
+
+#include "media/media_file_reader.h"
+#include "media/wav_writer.h"
+#include "utils/signal_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+class MediaFileReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_file_ = ::testing::TempDir() + "test_media_file_reader.wav";
+    }
+
+    void TearDown() override {
+        std::remove(test_file_.c_str());
+    }
+
+    // Helper: write a sine wave as 16-bit WAV
+    void WriteSine(double seconds, int sample_rate, int channels) {
+        auto samples = SignalGenerator::GenerateSineWave(440.0, seconds, sample_rate, 0.5);
+        if (channels == 2) {
+            std::vector<int16_t> stereo;
+            stereo.reserve(samples.size() * 2);
+            for (int16_t s : samples) {
+                stereo.push_back(s);
+                stereo.push_back(s);
+            }
+            samples.swap(stereo);
+        }
+        WavWriter writer;
+        ASSERT_TRUE(writer.Open(test_file_, sample_rate, channels));
+        writer.WriteSamples(samples);
+        writer.Close();
+    }
+
+    std::string test_file_;
+};
+
+TEST_F(MediaFileReaderTest, OpenMissingFileFails) {
+    MediaFileReader reader;
+    EXPECT_FALSE(reader.Open(::testing::TempDir() + "does_not_exist.mp3"));
+    EXPECT_FALSE(reader.IsOpen());
+    EXPECT_FALSE(reader.GetLastError().empty());
+
+    std::vector<float> pcm;
+    EXPECT_FALSE(reader.ReadAll(pcm));
+    EXPECT_FALSE(reader.NextChunk(pcm, 1024));
+}
+
+TEST_F(MediaFileReaderTest, RejectsInvalidTargetRate) {
+    WriteSine(0.5, 16000, 1);
+    MediaFileReader reader;
+    EXPECT_FALSE(reader.Open(test_file_, 0));
+    EXPECT_FALSE(reader.IsOpen());
+}
+
+TEST_F(MediaFileReaderTest, ReadAllResamplesAndDownmixes) {
+    WriteSine(2.0, 48000, 2);
+    MediaFileReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+    EXPECT_EQ(48000, reader.GetSampleRate());
+    EXPECT_EQ(2, reader.GetChannels());
+    EXPECT_NEAR(2.0, reader.GetDurationSeconds(), 0.05);
+
+    std::vector<float> pcm;
+    ASSERT_TRUE(reader.ReadAll(pcm));
+    EXPECT_NEAR(32000.0, static_cast<double>(pcm.size()), 100.0);
+
+    float peak = 0.0f;
+    for (float s : pcm) {
+        peak = std::max(peak, std::abs(s));
+    }
+    EXPECT_GT(peak, 0.4f);
+    EXPECT_LE(peak, 1.0f);
+}
+
+TEST_F(MediaFileReaderTest, ChunksMatchReadAll) {
+    WriteSine(3.0, 16000, 1);
+    MediaFileReader reader;
+    ASSERT_TRUE(reader.Open(test_file_, 16000));
+
+    std::vector<float> all;
+    ASSERT_TRUE(reader.ReadAll(all));
+
+    ASSERT_TRUE(reader.Rewind());
+    std::vector<float> chunked;
+    std::vector<float> chunk;
+    while (reader.NextChunk(chunk, 5000)) {
+        EXPECT_LE(chunk.size(), 5000u);
+        chunked.insert(chunked.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_TRUE(reader.GetLastError().empty());
+    EXPECT_EQ(all, chunked);
+}
+
+TEST_F(MediaFileReaderTest, CloseResetsState) {
+    WriteSine(0.5, 16000, 1);
+    MediaFileReader reader;
+    ASSERT_TRUE(reader.Open(test_file_));
+    reader.Close();
+    EXPECT_FALSE(reader.IsOpen());
+    EXPECT_EQ(0, reader.GetSampleRate());
+    reader.Close();  // Should not crash
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for MetricHistogram, MetricsRegistry and ScopedTimer
+ */
+
+#include "audio/audio_processor.h"
+#include "utils/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ffvoice;
+
+class MetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MetricsRegistry::Instance().Reset();
+    }
+
+    void TearDown() override {
+        // The registry is process-wide: leave it off for the other suites
+        MetricsRegistry::SetEnabled(false);
+        MetricsRegistry::Instance().Reset();
+    }
+};
+
+TEST_F(MetricsTest, BucketsCoverEveryValue) {
+    for (uint64_t value = 0; value < 200000; value += (value < 4096 ? 1 : 97)) {
+        const size_t index = MetricHistogram::BucketIndex(value);
+        ASSERT_LT(index, MetricHistogram::kNumBuckets);
+        EXPECT_LE(MetricHistogram::BucketLowerBound(index), value) << value;
+        EXPECT_GT(MetricHistogram::BucketLowerBound(index + 1), value) << value;
+    }
+    // Exact below the first sub-bucket range; huge values land in the top bucket
+    EXPECT_EQ(17u, MetricHistogram::BucketIndex(17));
+    EXPECT_EQ(MetricHistogram::kNumBuckets - 1, MetricHistogram::BucketIndex(UINT64_MAX));
+}
+
+TEST_F(MetricsTest, PercentilesWithinThreePercent) {
+    MetricHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        histogram.Record(value);
+    }
+
+    EXPECT_EQ(100000u, histogram.GetCount());
+    EXPECT_EQ(1u, histogram.GetMin());
+    EXPECT_EQ(100000u, histogram.GetMax());
+    EXPECT_NEAR(50000.5, histogram.GetMean(), 1e-6);
+    EXPECT_NEAR(50000.0, static_cast<double>(histogram.GetPercentile(50.0)), 1500.0);
+    EXPECT_NEAR(90000.0, static_cast<double>(histogram.GetPercentile(90.0)), 2700.0);
+    EXPECT_NEAR(99000.0, static_cast<double>(histogram.GetPercentile(99.0)), 2970.0);
+    EXPECT_EQ(100000u, histogram.GetPercentile(100.0));
+
+    histogram.Reset();
+    EXPECT_EQ(0u, histogram.GetCount());
+    EXPECT_EQ(0u, histogram.GetMin());
+    EXPECT_EQ(0u, histogram.GetPercentile(50.0));
+}
+
+TEST_F(MetricsTest, ConcurrentRecordLosesNothing) {
+    MetricHistogram histogram;
+    MetricCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (uint64_t i = 0; i < 50000; ++i) {
+                histogram.Record(i % 1000);
+                counter.Add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(200000u, histogram.GetCount());
+    EXPECT_EQ(200000u, counter.Get());
+    EXPECT_EQ(4u * 50u * 499500u, histogram.GetSum());
+    EXPECT_EQ(0u, histogram.GetMin());
+    EXPECT_EQ(999u, histogram.GetMax());
+}
+
+TEST_F(MetricsTest, RegistryHandlesAreStable) {
+    MetricsRegistry& registry = MetricsRegistry::Instance();
+    MetricCounter& counter = registry.Counter("test.events");
+    EXPECT_EQ(&counter, &registry.Counter("test.events"));
+    EXPECT_EQ(&registry.Histogram("test.latency_us"), &registry.Histogram("test.latency_us"));
+
+    counter.Add(5);
+    EXPECT_EQ(5u, registry.GetCounters().at("test.events"));
+    registry.Reset();
+    EXPECT_EQ(0u, counter.Get());
+    counter.Add();
+    EXPECT_EQ(1u, registry.GetCounters().at("test.events"));
+}
+
+TEST_F(MetricsTest, ToJsonIncludesRealtimeFactor) {
+    MetricsRegistry& registry = MetricsRegistry::Instance();
+    registry.Counter("whisper.audio_us").Add(10000000);  // 10 s of audio
+    registry.Histogram("whisper.total_us").Record(2000000);  // in 2 s
+    registry.Histogram("test.latency_us").Record(42);
+
+    const std::string json = registry.ToJson();
+    EXPECT_NE(std::string::npos, json.find("\"counters\":{"));
+    EXPECT_NE(std::string::npos, json.find("\"whisper.audio_us\":10000000"));
+    EXPECT_NE(std::string::npos, json.find("\"test.latency_us\":{\"count\":1,\"sum\":42"));
+    EXPECT_NE(std::string::npos, json.find("\"whisper_realtime_factor\":5.000"));
+    EXPECT_EQ('}', json.back());
+}
+
+TEST_F(MetricsTest, ScopedTimerOnlyRecordsWhenEnabled) {
+    MetricHistogram& histogram = MetricsRegistry::Instance().Histogram("test.scope_us");
+    {
+        ScopedTimer timer(histogram);
+    }
+    EXPECT_EQ(0u, histogram.GetCount());
+
+    MetricsRegistry::SetEnabled(true);
+    {
+        ScopedTimer timer(histogram);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(1u, histogram.GetCount());
+    EXPECT_GE(histogram.GetMax(), 1500u);
+}
+
+TEST_F(MetricsTest, ProcessorChainTimesEachProcessor) {
+    AudioProcessorChain chain;
+    chain.AddProcessor(std::make_unique<HighPassFilter>(80.0f));
+    chain.AddProcessor(std::make_unique<VolumeNormalizer>());
+    ASSERT_TRUE(chain.Initialize(48000, 1));
+
+    MetricsRegistry::SetEnabled(true);
+    std::vector<int16_t> samples(480, 1000);
+    chain.Process(samples.data(), samples.size());
+    chain.Process(samples.data(), samples.size());
+
+    const auto histograms = MetricsRegistry::Instance().GetHistograms();
+    EXPECT_EQ(2u, histograms.at("processor.HighPassFilter_us").count);
+    EXPECT_EQ(2u, histograms.at("processor.VolumeNormalizer_us").count);
+}
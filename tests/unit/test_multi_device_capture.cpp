@@ -0,0 +1,203 @@
+/**
+ * @file test_multi_device_capture.cpp
+ * @brief Unit tests for MultiDeviceCapture alignment (devices simulated via PushDeviceAudio)
+ */
+
+#include "audio/audio_mixer.h"
+#include "audio/multi_device_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kRate = 48000;
+constexpr size_t kCallbackFrames = 256;
+
+/// The sound in the room: every microphone hears the same 200 Hz tone
+int16_t RoomSample(double time) {
+    return static_cast<int16_t>(std::lrint(10000.0 * std::sin(2.0 * kPi * 200.0 * time)));
+}
+
+/// A mono device whose clock starts at @p start and runs at @p rate frames per second
+struct SimDevice {
+    double start;
+    double rate;
+    double jitter = 0.0;  ///< Peak timestamp noise in seconds
+    uint64_t frames = 0;
+
+    double NextBlockEnd() const {
+        return start + static_cast<double>(frames + kCallbackFrames) / rate;
+    }
+
+    std::vector<int16_t> NextBlock(double& adc_time) {
+        adc_time = start + static_cast<double>(frames) / rate;
+        std::vector<int16_t> block(kCallbackFrames);
+        for (size_t i = 0; i < kCallbackFrames; ++i) {
+            block[i] = RoomSample(start + static_cast<double>(frames + i) / rate);
+        }
+        frames += kCallbackFrames;
+        // Deterministic pseudo-random noise on the reported time only
+        adc_time += jitter * std::sin(static_cast<double>(frames) * 12.9898);
+        return block;
+    }
+};
+
+MultiDeviceCaptureConfig MakeConfig(size_t devices) {
+    MultiDeviceCaptureConfig config;
+    config.device_ids.resize(devices);
+    config.sample_rate = kRate;
+    config.block_frames = 480;
+    return config;
+}
+
+/// Deliver device blocks in the order their callbacks would fire until @p until;
+/// @p active limits which devices still deliver
+std::vector<std::vector<int16_t>> Deliver(MultiDeviceCapture& capture,
+                                          std::vector<SimDevice>& devices, double until,
+                                          std::vector<bool> active = {}) {
+    if (active.empty()) {
+        active.assign(devices.size(), true);
+    }
+    std::vector<std::vector<int16_t>> out(devices.size());
+    MultiDeviceBlock block;
+    while (true) {
+        size_t next = devices.size();
+        for (size_t d = 0; d < devices.size(); ++d) {
+            if (active[d] && (next == devices.size() ||
+                              devices[d].NextBlockEnd() < devices[next].NextBlockEnd())) {
+                next = d;
+            }
+        }
+        if (next == devices.size() || devices[next].NextBlockEnd() > until) {
+            break;
+        }
+        double adc_time = 0.0;
+        const std::vector<int16_t> samples = devices[next].NextBlock(adc_time);
+        capture.PushDeviceAudio(next, samples.data(), samples.size(), adc_time);
+
+        while (capture.ReadBlock(block)) {
+            for (size_t d = 0; d < devices.size(); ++d) {
+                out[d].insert(out[d].end(), block.devices[d], block.devices[d] + block.num_frames);
+            }
+        }
+    }
+    return out;
+}
+
+int MaxDifference(const std::vector<int16_t>& a, const std::vector<int16_t>& b, size_t from) {
+    int worst = 0;
+    for (size_t i = from; i < std::min(a.size(), b.size()); ++i) {
+        worst = std::max(worst, std::abs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+}  // namespace
+
+TEST(MultiDeviceCaptureTest, AlignsDevicesThatStartAtDifferentTimes) {
+    MultiDeviceCapture capture(MakeConfig(2));
+    std::vector<SimDevice> devices = {{1.000, kRate}, {1.010, kRate}};  // Second starts 10 ms late
+    const auto out = Deliver(capture, devices, 2.0);
+
+    ASSERT_GT(out[0].size(), 40000u);
+    // The reference skips its 480-frame lead and is otherwise untouched
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(RoomSample(1.010 + static_cast<double>(i) / kRate), out[0][i]) << i;
+    }
+    EXPECT_LE(MaxDifference(out[0], out[1], 0), 2);
+    EXPECT_EQ(0u, capture.GetResyncs(1));
+    EXPECT_EQ(0u, capture.GetUnderruns(1));
+}
+
+TEST(MultiDeviceCaptureTest, CompensatesClockDrift) {
+    MultiDeviceCapture capture(MakeConfig(2));
+    // Second device runs 500 ppm fast; reported capture times jitter by up to 0.2 ms
+    std::vector<SimDevice> devices = {{1.0, kRate, 0.0002},
+                                      {1.003, kRate * (1.0 + 500e-6), 0.0002}};
+    const auto out = Deliver(capture, devices, 21.0);
+
+    EXPECT_NEAR(500.0, capture.GetDriftPpm(1), 20.0);
+    EXPECT_EQ(0u, capture.GetDroppedSamples(1));
+    EXPECT_EQ(0u, capture.GetUnderruns(1));
+    EXPECT_EQ(0u, capture.GetResyncs(1));
+
+    // Without correction the devices would be 480 frames apart by now; after
+    // convergence the residual lag stays well under one sample (~260 here)
+    ASSERT_GT(out[1].size(), 19u * kRate);
+    EXPECT_LT(MaxDifference(out[0], out[1], 10u * kRate), 100);
+}
+
+TEST(MultiDeviceCaptureTest, SilentDeviceContributesSilence) {
+    MultiDeviceCapture capture(MakeConfig(2));
+    std::vector<SimDevice> devices = {{1.0, kRate}, {1.0, kRate}};
+    Deliver(capture, devices, 1.5);
+
+    // The second device stops delivering; the reference must keep flowing
+    const auto out = Deliver(capture, devices, 2.5, {true, false});
+    ASSERT_GT(out[0].size(), 40000u);
+    EXPECT_GT(capture.GetUnderruns(1), 0u);
+    EXPECT_TRUE(std::all_of(out[1].end() - 4800, out[1].end(), [](int16_t s) { return s == 0; }));
+}
+
+TEST(MultiDeviceCaptureTest, BlocksFeedMixerAndInterleavedProcessors) {
+    MultiDeviceCapture capture(MakeConfig(2));
+    std::vector<SimDevice> devices = {{1.0, kRate}, {1.0, kRate}};
+    Deliver(capture, devices, 1.5);
+
+    double adc_time = 0.0;
+    for (size_t d = 0; d < 2; ++d) {
+        for (int i = 0; i < 2; ++i) {
+            const std::vector<int16_t> samples = devices[d].NextBlock(adc_time);
+            capture.PushDeviceAudio(d, samples.data(), samples.size(), adc_time);
+        }
+    }
+    MultiDeviceBlock block;
+    ASSERT_TRUE(capture.ReadBlock(block));
+    ASSERT_EQ(2u, block.devices.size());
+    EXPECT_EQ(2, capture.GetTotalChannels());
+    for (size_t j = 0; j < block.num_frames; ++j) {
+        ASSERT_EQ(block.devices[0][j], block.interleaved[j * 2]);
+        ASSERT_EQ(block.devices[1][j], block.interleaved[j * 2 + 1]);
+    }
+
+    AudioMixer mixer;
+    ASSERT_TRUE(mixer.Initialize(kRate, 1));
+    const int first = mixer.AddTrack(0.5f, 0.0f);
+    const int second = mixer.AddTrack(0.5f, 0.0f);
+    std::vector<int16_t> mixed(block.num_frames);
+    ASSERT_TRUE(mixer.MixBlock({{first, block.devices[0]}, {second, block.devices[1]}},
+                               mixed.data(), block.num_frames));
+    for (size_t j = 0; j < block.num_frames; ++j) {
+        EXPECT_NEAR((block.devices[0][j] + block.devices[1][j]) / 2.0, mixed[j], 1.0);
+    }
+}
+
+TEST(MultiDeviceCaptureTest, RejectsInvalidUseAndCountsDrops) {
+    MultiDeviceCapture empty;
+    EXPECT_FALSE(empty.Open());  // No devices configured
+    EXPECT_FALSE(empty.Start([](MultiDeviceBlock&) {}));
+
+    MultiDeviceCaptureConfig config = MakeConfig(2);
+    config.buffer_ms = 50;  // 2400 frames
+    MultiDeviceCapture capture(config);
+    MultiDeviceBlock block;
+    EXPECT_FALSE(capture.ReadBlock(block));  // Nothing delivered yet
+    EXPECT_FALSE(capture.Start([](MultiDeviceBlock&) {}));  // Not open
+
+    const std::vector<int16_t> samples(1000, 1);
+    EXPECT_FALSE(capture.PushDeviceAudio(2, samples.data(), samples.size(), 0.0));
+    EXPECT_TRUE(capture.PushDeviceAudio(0, samples.data(), samples.size(), 1.0));
+    EXPECT_TRUE(capture.PushDeviceAudio(0, samples.data(), samples.size(), 1.02));
+    EXPECT_FALSE(capture.PushDeviceAudio(0, samples.data(), samples.size(), 1.04));
+    EXPECT_EQ(1000u, capture.GetDroppedSamples(0));
+    EXPECT_FALSE(capture.ReadBlock(block));  // Device 1 has not started
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_opus_writer.cpp
+ * @brief Unit tests for OpusWriter
+ */
+
+#include "media/opus_writer.h"
+#include "utils/signal_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+class OpusWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_file_ = ::testing::TempDir() + "test_opus_writer.opus";
+    }
+
+    void TearDown() override {
+        std::remove(test_file_.c_str());
+    }
+
+    // Helper: first four bytes of a file
+    std::string ReadMagic(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[4] = {};
+        file.read(magic, 4);
+        return std::string(magic, static_cast<size_t>(file.gcount()));
+    }
+
+    std::string test_file_;
+};
+
+TEST_F(OpusWriterTest, RejectsUnsupportedParameters) {
+    EXPECT_TRUE(OpusWriter::IsSupportedSampleRate(48000));
+    EXPECT_TRUE(OpusWriter::IsSupportedSampleRate(16000));
+    EXPECT_FALSE(OpusWriter::IsSupportedSampleRate(44100));
+
+    OpusWriter writer;
+    EXPECT_FALSE(writer.Open(test_file_, 44100, 1));
+    EXPECT_FALSE(writer.Open(test_file_, 48000, 0));
+    EXPECT_FALSE(writer.Open(test_file_, 48000, 9));
+    EXPECT_FALSE(writer.IsOpen());
+
+    OpusWriter::Config config;
+    config.frame_ms = 25;
+    OpusWriter odd_frames(config);
+    EXPECT_FALSE(odd_frames.Open(test_file_, 48000, 1));
+}
+
+TEST_F(OpusWriterTest, WritesOggOpus) {
+    OpusWriter writer;
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 1));
+    EXPECT_TRUE(writer.IsOpen());
+
+    const auto audio = SignalGenerator::GenerateSineWave(440.0, 2.0, 48000, 0.3);
+    for (size_t pos = 0; pos < audio.size(); pos += 256) {  // capture-sized blocks
+        const size_t n = std::min<size_t>(256, audio.size() - pos);
+        EXPECT_EQ(n, writer.WriteSamples(audio.data() + pos, n));
+    }
+    writer.Close();
+
+    EXPECT_FALSE(writer.IsOpen());
+    EXPECT_FALSE(writer.HasError());
+    EXPECT_EQ(audio.size(), writer.GetTotalSamples());
+    EXPECT_EQ("OggS", ReadMagic(test_file_));
+    // 32 kb/s against 768 kb/s of PCM
+    EXPECT_GT(writer.GetCompressionRatio(), 10.0);
+}
+
+TEST_F(OpusWriterTest, WritesWebM) {
+    const std::string webm_file = ::testing::TempDir() + "test_opus_writer.webm";
+    OpusWriter writer;
+    ASSERT_TRUE(writer.Open(webm_file, 48000, 2));
+    writer.WriteSamples(SignalGenerator::GenerateSineWave(440.0, 0.5, 48000, 0.3));
+    writer.Close();
+
+    EXPECT_FALSE(writer.HasError());
+    EXPECT_EQ(std::string("\x1A\x45\xDF\xA3"), ReadMagic(webm_file));  // EBML header
+    std::remove(webm_file.c_str());
+}
+
+TEST_F(OpusWriterTest, PacketsOnlyWithoutFile) {
+    std::vector<size_t> sizes;
+    std::vector<int64_t> pts;
+    OpusWriter::Config config;
+    config.on_packet = [&](const uint8_t* data, size_t size, int64_t packet_pts) {
+        EXPECT_NE(nullptr, data);
+        sizes.push_back(size);
+        pts.push_back(packet_pts);
+    };
+
+    OpusWriter writer(config);
+    ASSERT_TRUE(writer.Open("", 48000, 1));
+    writer.WriteSamples(SignalGenerator::GenerateSineWave(440.0, 1.0, 48000, 0.3));
+    writer.Close();
+
+    // 50 frames of 20 ms, plus whatever the encoder's lookahead adds at the flush
+    ASSERT_GE(sizes.size(), 50u);
+    uint64_t total = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        EXPECT_GT(sizes[i], 0u);
+        total += sizes[i];
+        if (i > 0) {
+            EXPECT_EQ(960, pts[i] - pts[i - 1]) << "packet " << i;
+        }
+    }
+    EXPECT_EQ(total, writer.GetEncodedBytes());
+}
+
+TEST_F(OpusWriterTest, CloseEncodesPartialFrame) {
+    size_t packets = 0;
+    OpusWriter::Config config;
+    config.on_packet = [&](const uint8_t*, size_t, int64_t) { ++packets; };
+
+    OpusWriter writer(config);
+    ASSERT_TRUE(writer.Open(test_file_, 16000, 1));
+    std::vector<int16_t> samples(100, 1000);  // well under one 320-sample frame
+    EXPECT_EQ(samples.size(), writer.WriteSamples(samples));
+    EXPECT_EQ(0u, packets);
+
+    writer.Close();
+    EXPECT_GE(packets, 1u);
+    EXPECT_EQ("OggS", ReadMagic(test_file_));
+}
+
+TEST_F(OpusWriterTest, WriteToClosedWriter) {
+    OpusWriter writer;
+    std::vector<int16_t> samples(960, 1000);
+    EXPECT_EQ(0u, writer.WriteSamples(samples));
+    EXPECT_TRUE(writer.HasError());
+    writer.Close();  // Should not crash
+}
@@ -0,0 +1,198 @@
+/**
+ * @file test_polyphase_resampler.cpp
+ * @brief Unit tests for PolyphaseResampler
+ */
+
+#include "utils/polyphase_resampler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<float> MakeSine(double frequency, int sample_rate, size_t count,
+                            double amplitude = 0.5) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] =
+            static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * i / sample_rate));
+    }
+    return samples;
+}
+
+// RMS over [begin, end), used to skip the filter's edge transients
+double Rms(const std::vector<float>& samples, size_t begin, size_t end) {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return std::sqrt(sum / static_cast<double>(end - begin));
+}
+
+}  // namespace
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+TEST(PolyphaseResamplerTest, ReducesCommonRatios) {
+    PolyphaseResampler from_48k(48000, 16000);
+    ASSERT_TRUE(from_48k.IsValid());
+    EXPECT_EQ(1u, from_48k.GetNumPhases());
+    EXPECT_EQ(3u, from_48k.GetDecimation());
+    EXPECT_EQ(0u, from_48k.GetTapsPerPhase() % 8);
+
+    PolyphaseResampler from_44k(44100, 16000);
+    ASSERT_TRUE(from_44k.IsValid());
+    EXPECT_EQ(160u, from_44k.GetNumPhases());
+    EXPECT_EQ(441u, from_44k.GetDecimation());
+}
+
+TEST(PolyphaseResamplerTest, RejectsInvalidRates) {
+    EXPECT_FALSE(PolyphaseResampler(0, 16000).IsValid());
+    EXPECT_FALSE(PolyphaseResampler(48000, -1).IsValid());
+    // 16001/48000 cannot be reduced below kMaxPhases phases
+    EXPECT_FALSE(PolyphaseResampler(48000, 16001).IsValid());
+}
+
+TEST(PolyphaseResamplerTest, SameRateIsPassThrough) {
+    PolyphaseResampler resampler(16000, 16000);
+    ASSERT_TRUE(resampler.IsValid());
+    const std::vector<float> input = {0.0f, 0.5f, 1.0f, -0.5f};
+    std::vector<float> output(input.size());
+
+    EXPECT_EQ(input.size(),
+              resampler.ResampleBuffer(input.data(), input.size(), output.data(), output.size()));
+    EXPECT_EQ(input, output);
+}
+
+// =============================================================================
+// Frequency response
+// =============================================================================
+
+TEST(PolyphaseResamplerTest, PassbandToneIsPreservedAndAligned) {
+    for (int input_rate : {48000, 44100}) {
+        const size_t input_size = static_cast<size_t>(input_rate) / 2;  // 0.5 s
+        const std::vector<float> input = MakeSine(1000.0, input_rate, input_size);
+        const size_t output_size = input_size * 16000 / static_cast<size_t>(input_rate);
+        std::vector<float> output(output_size);
+
+        PolyphaseResampler resampler(input_rate, 16000);
+        resampler.ResampleBuffer(input.data(), input.size(), output.data(), output.size());
+
+        // Delay-compensated: output matches the ideal 16 kHz sine away from the edges
+        const std::vector<float> expected = MakeSine(1000.0, 16000, output_size);
+        for (size_t i = 100; i < output_size - 100; ++i) {
+            ASSERT_NEAR(expected[i], output[i], 0.01f) << "rate " << input_rate << " i " << i;
+        }
+    }
+}
+
+TEST(PolyphaseResamplerTest, ToneAboveOutputNyquistIsRejected) {
+    // 12 kHz at 48 kHz would alias to 4 kHz at 16 kHz without a low-pass filter
+    const std::vector<float> input = MakeSine(12000.0, 48000, 24000);
+    std::vector<float> output(8000);
+
+    PolyphaseResampler resampler(48000, 16000);
+    resampler.ResampleBuffer(input.data(), input.size(), output.data(), output.size());
+
+    const double in_rms = Rms(input, 0, input.size());
+    const double out_rms = Rms(output, 100, output.size() - 100);
+    EXPECT_LT(out_rms, in_rms * 0.001);  // > 60 dB down
+}
+
+TEST(PolyphaseResamplerTest, UpsamplingPreservesTone) {
+    const std::vector<float> input = MakeSine(440.0, 16000, 8000);
+    std::vector<float> output(24000);
+
+    PolyphaseResampler resampler(16000, 48000);
+    resampler.ResampleBuffer(input.data(), input.size(), output.data(), output.size());
+
+    const std::vector<float> expected = MakeSine(440.0, 48000, output.size());
+    for (size_t i = 300; i < output.size() - 300; ++i) {
+        ASSERT_NEAR(expected[i], output[i], 0.01f) << "i " << i;
+    }
+}
+
+// =============================================================================
+// Streaming
+// =============================================================================
+
+TEST(PolyphaseResamplerTest, ChunkedStreamMatchesSingleCall) {
+    const std::vector<float> input = MakeSine(700.0, 44100, 10000);
+
+    PolyphaseResampler whole(44100, 16000);
+    std::vector<float> expected(whole.GetMaxOutputSize(input.size()));
+    size_t expected_size = whole.Process(input.data(), input.size(), expected.data(),
+                                         expected.size());
+    std::vector<float> tail(whole.GetMaxOutputSize(0) + whole.GetLatency());
+    const size_t tail_size = whole.Flush(tail.data(), tail.size());
+    expected.resize(expected_size);
+    expected.insert(expected.end(), tail.begin(), tail.begin() + tail_size);
+
+    PolyphaseResampler chunked(44100, 16000);
+    std::vector<float> streamed;
+    std::vector<float> chunk_out;
+    for (size_t offset = 0; offset < input.size(); offset += 441) {
+        const size_t n = std::min<size_t>(441, input.size() - offset);
+        chunk_out.resize(chunked.GetMaxOutputSize(n));
+        const size_t written =
+            chunked.Process(input.data() + offset, n, chunk_out.data(), chunk_out.size());
+        streamed.insert(streamed.end(), chunk_out.begin(), chunk_out.begin() + written);
+    }
+    chunk_out.resize(chunked.GetMaxOutputSize(0) + chunked.GetLatency());
+    const size_t flushed = chunked.Flush(chunk_out.data(), chunk_out.size());
+    streamed.insert(streamed.end(), chunk_out.begin(), chunk_out.begin() + flushed);
+
+    // Roughly input_size * 160 / 441 samples in total, identical either way
+    EXPECT_NEAR(static_cast<double>(input.size()) * 160.0 / 441.0,
+                static_cast<double>(streamed.size()), 2.0);
+    EXPECT_EQ(expected, streamed);
+}
+
+TEST(PolyphaseResamplerTest, LimitedOutputCapacityKeepsPendingInput) {
+    const std::vector<float> input = MakeSine(500.0, 48000, 4800);
+
+    PolyphaseResampler reference(48000, 16000);
+    std::vector<float> expected(reference.GetMaxOutputSize(input.size()));
+    expected.resize(
+        reference.Process(input.data(), input.size(), expected.data(), expected.size()));
+
+    // Ask for at most 100 samples per call; the rest of the input must not be lost
+    PolyphaseResampler limited(48000, 16000);
+    std::vector<float> collected(100);
+    collected.resize(limited.Process(input.data(), input.size(), collected.data(), 100));
+    std::vector<float> more(100);
+    size_t n = 0;
+    while ((n = limited.Process(nullptr, 0, more.data(), more.size())) > 0) {
+        collected.insert(collected.end(), more.begin(), more.begin() + n);
+    }
+
+    EXPECT_EQ(expected, collected);
+}
+
+TEST(PolyphaseResamplerTest, StreamingOutputIsAlignedAndHoldsBackLatency) {
+    PolyphaseResampler resampler(48000, 16000);
+    std::vector<float> input(960, 0.0f);
+    input[300] = 1.0f;
+    std::vector<float> output(resampler.GetMaxOutputSize(input.size()));
+    output.resize(resampler.Process(input.data(), input.size(), output.data(), output.size()));
+
+    // The impulse at input 300 lands on output 100 (no delay in the output timeline) ...
+    const size_t peak = static_cast<size_t>(
+        std::max_element(output.begin(), output.end()) - output.begin());
+    EXPECT_EQ(100u, peak);
+
+    // ... and the newest samples wait for the rest of their filter window
+    EXPECT_LE(output.size(), (input.size() - resampler.GetLatency()) / 3 + 1);
+    std::vector<float> tail(resampler.GetLatency());
+    const size_t flushed = resampler.Flush(tail.data(), tail.size());
+    EXPECT_EQ(input.size() / 3, output.size() + flushed);
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_processor_chain.cpp
+ * @brief Unit tests for the fused, statically typed ProcessorChain
+ *
+ * The fused chain must produce what AudioProcessorChain produces for the same
+ * stages; these tests compare the two on odd block sizes so sub-block edges
+ * fall mid-buffer.
+ */
+
+#include "audio/audio_processor.h"
+#include "audio/processor_chain.h"
+#include "utils/audio_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// int16-only stage that records the blocks it is handed
+class CountingProcessor : public AudioProcessor {
+public:
+    CountingProcessor() = default;
+    explicit CountingProcessor(bool init_should_succeed)
+        : init_should_succeed(init_should_succeed) {}
+
+    bool Initialize(int sample_rate, int channels) override {
+        sample_rate_ = sample_rate;
+        channels_ = channels;
+        ++init_calls;
+        return init_should_succeed;
+    }
+
+    void Process(int16_t* samples, size_t num_samples) override {
+        (void)samples;
+        ++process_calls;
+        samples_seen += num_samples;
+        largest_block = std::max(largest_block, num_samples);
+    }
+
+    void Reset() override {
+        ++reset_calls;
+    }
+
+    std::string GetName() const override {
+        return "CountingProcessor";
+    }
+
+    int init_calls = 0;
+    int process_calls = 0;
+    int reset_calls = 0;
+    size_t samples_seen = 0;
+    size_t largest_block = 0;
+    bool init_should_succeed = true;
+};
+
+// Interleaved two-tone signal with a DC offset, in [-1, 1]
+std::vector<float> TestSignal(size_t frames, int channels) {
+    std::vector<float> samples(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < channels; ++ch) {
+            const double t = static_cast<double>(i) / 48000.0;
+            samples[i * channels + ch] = static_cast<float>(
+                0.1 + 0.3 * std::sin(2.0 * kPi * (440.0 + 110.0 * ch) * t) +
+                0.05 * std::sin(2.0 * kPi * 30.0 * t));
+        }
+    }
+    return samples;
+}
+
+std::unique_ptr<AudioProcessorChain> ReferenceChain() {
+    auto chain = std::make_unique<AudioProcessorChain>();
+    chain->AddProcessor(std::make_unique<HighPassFilter>(80.0f));
+    chain->AddProcessor(std::make_unique<VolumeNormalizer>(0.5f));
+    return chain;
+}
+
+}  // namespace
+
+TEST(ProcessorChainTest, GetNameAndStageAccess) {
+    ProcessorChain<HighPassFilter, VolumeNormalizer> chain(80.0f, 0.5f);
+    EXPECT_EQ("ProcessorChain", chain.GetName());
+    EXPECT_EQ("HighPassFilter", chain.Get<0>().GetName());
+    EXPECT_EQ("VolumeNormalizer", chain.Get<1>().GetName());
+}
+
+TEST(ProcessorChainTest, FloatMatchesAudioProcessorChain) {
+    ProcessorChain<HighPassFilter, VolumeNormalizer> fused(80.0f, 0.5f);
+    auto reference = ReferenceChain();
+    ASSERT_TRUE(fused.Initialize(48000, 2));
+    ASSERT_TRUE(reference->Initialize(48000, 2));
+
+    std::vector<float> expected = TestSignal(9600, 2);
+    std::vector<float> actual = expected;
+
+    // 1000-frame blocks: sub-blocks of 480, 480 and 40 frames
+    for (size_t pos = 0; pos < expected.size(); pos += 2000) {
+        const size_t n = std::min<size_t>(2000, expected.size() - pos);
+        reference->Process(expected.data() + pos, n);
+        fused.Process(actual.data() + pos, n);
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_FLOAT_EQ(expected[i], actual[i]) << "sample " << i;
+    }
+}
+
+TEST(ProcessorChainTest, Int16ConvertsOncePerBlock) {
+    ProcessorChain<HighPassFilter, VolumeNormalizer> fused(80.0f, 0.5f);
+    auto reference = ReferenceChain();
+    ASSERT_TRUE(fused.Initialize(48000, 1));
+    ASSERT_TRUE(reference->Initialize(48000, 1));
+
+    const AudioKernels& kernels = GetAudioKernels();
+    const std::vector<float> signal = TestSignal(4800, 1);
+    std::vector<int16_t> samples(signal.size());
+    kernels.float_to_int16(signal.data(), signal.size(), samples.data());
+
+    // Reference: int16 -> float, float chain, float -> int16
+    std::vector<float> as_float(samples.size());
+    kernels.int16_to_float(samples.data(), samples.size(), as_float.data());
+    reference->Process(as_float.data(), as_float.size());
+    std::vector<int16_t> expected(samples.size());
+    kernels.float_to_int16(as_float.data(), as_float.size(), expected.data());
+
+    for (size_t pos = 0; pos < samples.size(); pos += 256) {
+        fused.Process(samples.data() + pos, std::min<size_t>(256, samples.size() - pos));
+    }
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(expected[i], samples[i], 1) << "sample " << i;
+    }
+}
+
+TEST(ProcessorChainTest, NonFusableStageGetsSubBlocks) {
+    ProcessorChain<HighPassFilter, CountingProcessor, VolumeNormalizer> chain;
+    ASSERT_TRUE(chain.Initialize(48000, 2));
+
+    std::vector<float> samples = TestSignal(1000, 2);
+    chain.Process(samples.data(), samples.size());
+
+    const CountingProcessor& counter = chain.Get<1>();
+    EXPECT_EQ(1, counter.init_calls);
+    EXPECT_EQ(3, counter.process_calls);  // 480 + 480 + 40 frames
+    EXPECT_EQ(samples.size(), counter.samples_seen);
+    EXPECT_EQ(ProcessorChain<CountingProcessor>::kSubBlockFrames * 2, counter.largest_block);
+}
+
+TEST(ProcessorChainTest, InitializeFailsWhenStageFails) {
+    ProcessorChain<HighPassFilter, CountingProcessor> chain(80.0f, false);
+    EXPECT_FALSE(chain.Initialize(48000, 1));
+    EXPECT_EQ(1, chain.Get<1>().init_calls);
+}
+
+TEST(ProcessorChainTest, ResetPropagatesToEveryStage) {
+    ProcessorChain<HighPassFilter, CountingProcessor, VolumeNormalizer> chain;
+    ASSERT_TRUE(chain.Initialize(48000, 1));
+
+    std::vector<float> first = TestSignal(2000, 1);
+    std::vector<float> second = first;
+    chain.Process(first.data(), first.size());
+    chain.Reset();
+    chain.Process(second.data(), second.size());
+
+    EXPECT_EQ(1, chain.Get<1>().reset_calls);
+    // Filter and gain state start over, so the output repeats exactly
+    for (size_t i = 0; i < first.size(); ++i) {
+        ASSERT_FLOAT_EQ(first[i], second[i]) << "sample " << i;
+    }
+}
+
+TEST(ProcessorChainTest, ZeroSamplesIsNoop) {
+    ProcessorChain<HighPassFilter, CountingProcessor> chain;
+    ASSERT_TRUE(chain.Initialize(48000, 1));
+    int16_t sample = 1234;
+    chain.Process(&sample, 0);
+    EXPECT_EQ(1234, sample);
+    EXPECT_EQ(0, chain.Get<1>().process_calls);
+}
@@ -557,5 +557,249 @@ TEST(RingBufferBatchTest, PartialBatchOperations) {
     EXPECT_TRUE(buffer.empty());
 }
 
+// ============================================================================
+// Zero-copy Span API Tests
+// ============================================================================
+
+TEST(RingBufferSpanTest, AcquireCommitThenPeekConsume) {
+    RingBuffer<int> buffer(16);
+
+    auto w = buffer.acquire_write(10);
+    ASSERT_EQ(w.size(), 10u);
+    EXPECT_EQ(w.second_size, 0u);
+    for (size_t i = 0; i < w.first_size; ++i) {
+        w.first[i] = static_cast<int>(i);
+    }
+    EXPECT_TRUE(buffer.empty()) << "Nothing is visible before commit_write()";
+
+    buffer.commit_write(10);
+    EXPECT_EQ(buffer.size(), 10u);
+
+    auto r = buffer.peek_read(100);
+    ASSERT_EQ(r.size(), 10u);
+    for (size_t i = 0; i < r.first_size; ++i) {
+        EXPECT_EQ(r.first[i], static_cast<int>(i));
+    }
+    EXPECT_EQ(buffer.size(), 10u) << "peek_read() must not consume";
+
+    buffer.consume(4);
+    EXPECT_EQ(buffer.size(), 6u);
+    int value = -1;
+    ASSERT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, 4);
+}
+
+TEST(RingBufferSpanTest, SpansSplitAtWrapAround) {
+    RingBuffer<int> buffer(8);
+    std::vector<int> tmp(6);
+    std::iota(tmp.begin(), tmp.end(), 0);
+    buffer.push_bulk(tmp.data(), tmp.size());
+    buffer.pop_bulk(tmp.data(), tmp.size());  // head = tail = 6
+
+    auto w = buffer.acquire_write(8);
+    ASSERT_EQ(w.size(), 8u);
+    EXPECT_EQ(w.first_size, 2u);
+    EXPECT_EQ(w.second_size, 6u);
+    int next = 100;
+    for (size_t i = 0; i < w.first_size; ++i) {
+        w.first[i] = next++;
+    }
+    for (size_t i = 0; i < w.second_size; ++i) {
+        w.second[i] = next++;
+    }
+    buffer.commit_write(w.size());
+    EXPECT_TRUE(buffer.full());
+    EXPECT_TRUE(buffer.acquire_write(1).empty()) << "No free slots when full";
+
+    auto r = buffer.peek_read(8);
+    EXPECT_EQ(r.first_size, 2u);
+    EXPECT_EQ(r.second_size, 6u);
+
+    std::vector<int> out(8);
+    EXPECT_EQ(buffer.pop_bulk(out.data(), out.size()), 8u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i], 100 + i);
+    }
+}
+
+TEST(RingBufferSpanTest, PartialCommitPublishesOnlyCommitted) {
+    RingBuffer<int16_t> buffer(32);
+    auto w = buffer.acquire_write(20);
+    ASSERT_EQ(w.size(), 20u);
+    for (size_t i = 0; i < 20; ++i) {
+        w.first[i] = static_cast<int16_t>(i);
+    }
+    buffer.commit_write(5);
+    EXPECT_EQ(buffer.size(), 5u);
+    EXPECT_EQ(buffer.available_write(), 27u);
+}
+
+TEST(RingBufferSpanTest, NonPowerOfTwoCapacityWrapsCorrectly) {
+    // Exercises the modulo path alongside the masked power-of-two path
+    for (size_t capacity : {7u, 8u, 1000u, 1024u}) {
+        RingBuffer<int> buffer(capacity);
+        int next_in = 0;
+        int next_out = 0;
+        std::vector<int> chunk(capacity / 2 + 1);
+        for (int round = 0; round < 50; ++round) {
+            for (auto& x : chunk) {
+                x = next_in++;
+            }
+            ASSERT_EQ(buffer.push_bulk(chunk.data(), chunk.size()), chunk.size());
+            auto r = buffer.peek_read(chunk.size());
+            ASSERT_EQ(r.size(), chunk.size());
+            for (size_t i = 0; i < r.first_size; ++i) {
+                ASSERT_EQ(r.first[i], next_out++) << "capacity " << capacity;
+            }
+            for (size_t i = 0; i < r.second_size; ++i) {
+                ASSERT_EQ(r.second[i], next_out++) << "capacity " << capacity;
+            }
+            buffer.consume(r.size());
+        }
+        EXPECT_TRUE(buffer.empty());
+    }
+}
+
+TEST(RingBufferSpanTest, ConcurrentZeroCopyProducerConsumer) {
+    constexpr int kTotal = 100000;
+    RingBuffer<int> buffer(256);
+
+    std::thread producer([&]() {
+        int next = 0;
+        while (next < kTotal) {
+            auto w = buffer.acquire_write(static_cast<size_t>(kTotal - next));
+            for (size_t i = 0; i < w.first_size; ++i) {
+                w.first[i] = next++;
+            }
+            for (size_t i = 0; i < w.second_size; ++i) {
+                w.second[i] = next++;
+            }
+            buffer.commit_write(w.size());
+            if (w.empty()) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    bool in_order = true;
+    while (expected < kTotal) {
+        auto r = buffer.peek_read(64);
+        for (size_t i = 0; i < r.first_size; ++i) {
+            in_order = in_order && (r.first[i] == expected++);
+        }
+        for (size_t i = 0; i < r.second_size; ++i) {
+            in_order = in_order && (r.second[i] == expected++);
+        }
+        buffer.consume(r.size());
+        if (r.empty()) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(buffer.empty());
+}
+
+// ============================================================================
+// Event-driven wakeup (wait_for_data / wake)
+// ============================================================================
+
+TEST(RingBufferWaitTest, ReturnsImmediatelyWhenEnoughData) {
+    RingBuffer<int> buffer(16);
+    std::vector<int> data(8, 1);
+    buffer.push_bulk(data.data(), data.size());
+
+    EXPECT_TRUE(buffer.wait_for_data(8));
+    EXPECT_TRUE(buffer.wait_for_data(0));  // Clamped to 1
+}
+
+TEST(RingBufferWaitTest, BlocksUntilThresholdReached) {
+    RingBuffer<int> buffer(256);
+    std::atomic<bool> woke{false};
+    bool result = false;
+
+    std::thread consumer([&]() {
+        result = buffer.wait_for_data(100);
+        woke.store(true);
+    });
+
+    std::vector<int> half(50, 7);
+    buffer.push_bulk(half.data(), half.size());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(woke.load()) << "Consumer must stay parked below the threshold";
+
+    buffer.push_bulk(half.data(), half.size());
+    consumer.join();
+
+    EXPECT_TRUE(woke.load());
+    EXPECT_TRUE(result);
+    EXPECT_EQ(buffer.size(), 100u);
+}
+
+TEST(RingBufferWaitTest, WakeReleasesParkedConsumer) {
+    RingBuffer<int> buffer(16);
+    bool result = true;
+
+    std::thread consumer([&]() { result = buffer.wait_for_data(10); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    buffer.wake();
+    consumer.join();
+
+    EXPECT_FALSE(result);
+}
+
+TEST(RingBufferWaitTest, WakeBeforeWaitIsNotLost) {
+    RingBuffer<int> buffer(16);
+    buffer.wake();
+    EXPECT_FALSE(buffer.wait_for_data(1));
+}
+
+TEST(RingBufferWaitTest, ThresholdAboveCapacityIsClamped) {
+    RingBuffer<int> buffer(4);
+    std::thread consumer([&]() { EXPECT_TRUE(buffer.wait_for_data(1000)); });
+    for (int i = 0; i < 4; ++i) {
+        buffer.push(i);
+    }
+    consumer.join();
+}
+
+TEST(RingBufferWaitTest, StreamingConsumerNeverMissesWakeup) {
+    constexpr int kTotal = 100000;
+    constexpr size_t kBatch = 32;
+    RingBuffer<int> buffer(1024);
+
+    std::thread producer([&]() {
+        int next = 0;
+        while (next < kTotal) {
+            const int chunk = std::min<int>(7, kTotal - next);
+            std::vector<int> data(static_cast<size_t>(chunk));
+            std::iota(data.begin(), data.end(), next);
+            const size_t n = buffer.push_bulk(data.data(), data.size());
+            next += static_cast<int>(n);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    bool in_order = true;
+    std::vector<int> out(kBatch);
+    while (expected < kTotal) {
+        // The producer's final chunk may leave fewer than kBatch elements
+        const size_t want = std::min<size_t>(kBatch, static_cast<size_t>(kTotal - expected));
+        ASSERT_TRUE(buffer.wait_for_data(want));
+        const size_t n = buffer.pop_bulk(out.data(), want);
+        for (size_t i = 0; i < n; ++i) {
+            in_order = in_order && (out[i] == expected++);
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+}
+
 }  // namespace test
-}  // namespace ffvoice
\ No newline at end of file
+}  // namespace ffvoice
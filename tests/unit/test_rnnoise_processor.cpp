@@ -15,6 +15,7 @@
 
     #include <gtest/gtest.h>
 
+    #include <algorithm>
     #include <cmath>
     #include <random>
     #include <vector>
@@ -243,6 +244,60 @@ TEST_F(RNNoiseProcessorTest, VAD_SpeechReturnsHighProbability) {
     EXPECT_LE(vad_prob, 1.0f);
 }
 
+TEST_F(RNNoiseProcessorTest, VAD_OneProbabilityPerFrameOfTheBlock) {
+    RNNoiseConfig config;
+    config.enable_vad = true;
+    RNNoiseProcessor processor(config);
+    processor.Initialize(48000, 2);
+
+    auto samples = GenerateSineWave(480 * 2 * 4, 440.0, 48000);  // 4 stereo frames
+    processor.Process(samples.data(), samples.size());
+    const std::vector<float>& probs = processor.GetFrameVADProbabilities();
+
+    #ifdef ENABLE_RNNOISE
+    ASSERT_EQ(4u, probs.size());
+    EXPECT_EQ(processor.GetVADProbability(), probs.back());
+    #else
+    EXPECT_TRUE(probs.empty());
+    #endif
+
+    // Each call reports only its own frames
+    processor.Process(samples.data(), 480 * 2);
+    #ifdef ENABLE_RNNOISE
+    EXPECT_EQ(1u, processor.GetFrameVADProbabilities().size());
+    #endif
+    processor.Process(samples.data(), 0);
+    EXPECT_TRUE(processor.GetFrameVADProbabilities().empty());
+}
+
+TEST_F(RNNoiseProcessorTest, VAD_OffsetPlacesDelayedProbabilitiesInTheOutput) {
+    RNNoiseConfig config;
+    config.enable_vad = true;
+    RNNoiseProcessor processor(config);
+    processor.Initialize(48000, 2);
+
+    // Whole frames: the probabilities describe the block itself
+    auto samples = GenerateSineWave(480 * 2 * 2, 440.0, 48000);
+    processor.Process(samples.data(), 480 * 2);
+    EXPECT_EQ(0u, processor.GetFrameVADOffset());
+
+    // 256-frame blocks: the first switches to the delayed path and completes
+    // nothing; the second completes the frame that started 256 frames
+    // earlier, whose output begins one frame after that
+    processor.Process(samples.data(), 256 * 2);
+    EXPECT_TRUE(processor.GetFrameVADProbabilities().empty());
+    processor.Process(samples.data(), 256 * 2);
+    #ifdef ENABLE_RNNOISE
+    EXPECT_EQ(1u, processor.GetFrameVADProbabilities().size());
+    EXPECT_EQ((480u - 256u) * 2u, processor.GetFrameVADOffset());
+    #else
+    EXPECT_EQ(0u, processor.GetFrameVADOffset());
+    #endif
+
+    processor.Reset();
+    EXPECT_EQ(0u, processor.GetFrameVADOffset());
+}
+
 TEST_F(RNNoiseProcessorTest, VAD_DisabledReturnsZero) {
     RNNoiseConfig config;
     config.enable_vad = false;  // Explicitly disable
@@ -294,6 +349,139 @@ TEST_F(RNNoiseProcessorTest, Reset_MultipleResets) {
     EXPECT_TRUE(true);
 }
 
+// =============================================================================
+// Frame Rebuffering Tests
+// =============================================================================
+
+TEST_F(RNNoiseProcessorTest, Rebuffer_UnalignedBlocksLagByOneFrame) {
+    RNNoiseProcessor aligned;
+    RNNoiseProcessor unaligned;
+    aligned.Initialize(48000, 1);
+    unaligned.Initialize(48000, 1);
+
+    const auto input = GenerateSineWave(4800, 440.0, 48000, 10000);  // 10 frames
+
+    // Whole frames are denoised in place
+    auto expected = input;
+    for (size_t pos = 0; pos < expected.size(); pos += 480) {
+        aligned.Process(expected.data() + pos, 480);
+    }
+
+    // 256-sample capture blocks return the previous frame
+    auto output = input;
+    for (size_t pos = 0; pos < output.size(); pos += 256) {
+        unaligned.Process(output.data() + pos, std::min<size_t>(256, output.size() - pos));
+    }
+
+    for (size_t i = 0; i < 480; ++i) {
+        ASSERT_EQ(0, output[i]) << "sample " << i;
+    }
+    for (size_t i = 480; i < output.size(); ++i) {
+        ASSERT_EQ(expected[i - 480], output[i]) << "sample " << i;
+    }
+}
+
+TEST_F(RNNoiseProcessorTest, Rebuffer_ResetRestoresInPlaceProcessing) {
+    RNNoiseProcessor processor;
+    processor.Initialize(48000, 2);
+
+    auto partial = GenerateSineWave(200, 440.0, 48000);
+    processor.Process(partial.data(), partial.size());
+    processor.Reset();
+
+    // After Reset() a whole stereo frame is denoised in place again, not delayed
+    RNNoiseProcessor fresh;
+    fresh.Initialize(48000, 2);
+    auto expected = GenerateSineWave(960, 440.0, 48000, 10000);
+    auto output = expected;
+    fresh.Process(expected.data(), expected.size());
+    processor.Process(output.data(), output.size());
+    EXPECT_EQ(expected, output);
+}
+
+TEST_F(RNNoiseProcessorTest, Float_MatchesInt16Path) {
+    RNNoiseProcessor int16_processor;
+    RNNoiseProcessor float_processor;
+    int16_processor.Initialize(48000, 1);
+    float_processor.Initialize(48000, 1);
+
+    auto samples = GenerateSineWave(4800, 440.0, 48000, 10000);
+    std::vector<float> float_samples(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float_samples[i] = samples[i] / 32768.0f;
+    }
+
+    // Mid-frame blocks, so both paths also take the delayed route
+    for (size_t pos = 0; pos < samples.size(); pos += 256) {
+        const size_t n = std::min<size_t>(256, samples.size() - pos);
+        int16_processor.Process(samples.data() + pos, n);
+        float_processor.Process(float_samples.data() + pos, n);
+    }
+
+    // Same 16-bit-scale input to RNNoise; the int16 path only adds truncation
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(samples[i], float_samples[i] * 32768.0f, 1.0f) << "sample " << i;
+    }
+}
+
+// =============================================================================
+// Parallel Channel Tests
+// =============================================================================
+
+TEST_F(RNNoiseProcessorTest, Parallel_MatchesSerialOutput) {
+    const int channels = 8;
+    RNNoiseConfig serial_cfg;
+    serial_cfg.enable_vad = true;
+    RNNoiseConfig parallel_cfg = serial_cfg;
+    parallel_cfg.num_threads = 3;  // Uneven split: lanes get 3, 3 and 2 channels
+
+    RNNoiseProcessor serial(serial_cfg);
+    RNNoiseProcessor parallel(parallel_cfg);
+    ASSERT_TRUE(serial.Initialize(48000, channels));
+    ASSERT_TRUE(parallel.Initialize(48000, channels));
+
+    // Each channel gets its own tone so a swapped channel would show
+    std::vector<int16_t> input(480 * channels * 20);
+    for (size_t i = 0; i < input.size(); ++i) {
+        const size_t ch = i % channels;
+        const size_t frame = i / channels;
+        input[i] = static_cast<int16_t>(8000 * std::sin(2.0 * M_PI * (200.0 + 100.0 * ch) *
+                                                        frame / 48000.0));
+    }
+
+    auto expected = input;
+    auto output = input;
+    // Mix of whole-frame and mid-frame blocks exercises both paths
+    size_t blocks = 0;
+    for (size_t pos = 0; pos < input.size();) {
+        const size_t frames = blocks++ % 3 == 0 ? 480 : 256;
+        const size_t n = std::min<size_t>(frames * channels, input.size() - pos);
+        serial.Process(expected.data() + pos, n);
+        parallel.Process(output.data() + pos, n);
+        pos += n;
+        ASSERT_EQ(serial.GetVADProbability(), parallel.GetVADProbability());
+    }
+    EXPECT_EQ(expected, output);
+}
+
+TEST_F(RNNoiseProcessorTest, Parallel_MoreThreadsThanChannelsAndReinitialize) {
+    RNNoiseConfig cfg;
+    cfg.num_threads = 8;
+    RNNoiseProcessor processor(cfg);
+
+    // Capped at one thread per channel
+    ASSERT_TRUE(processor.Initialize(48000, 2));
+    auto samples = GenerateSineWave(960 * 4, 440.0, 48000);
+    processor.Process(samples.data(), samples.size());
+
+    // The pool is rebuilt for the new channel count; Reset() keeps it running
+    ASSERT_TRUE(processor.Initialize(48000, 4));
+    processor.Reset();
+    auto quad = GenerateSineWave(1920 * 4, 440.0, 48000);
+    processor.Process(quad.data(), quad.size());
+    EXPECT_TRUE(true);
+}
+
 // =============================================================================
 // Edge Cases
 // =============================================================================
@@ -6,6 +6,7 @@
 
 #ifdef ENABLE_WHISPER
 
+    #include "audio/live_captioner.h"
     #include "utils/subtitle_generator.h"
 
     #include <gtest/gtest.h>
@@ -342,4 +343,131 @@ TEST_F(SubtitleGeneratorTest, GenerateString_SingleSegment_ContainsText) {
     EXPECT_TRUE(Contains(result, "Hello from GenerateString"));
 }
 
+// ============================================================================
+// SubtitleWriter — incremental output
+// ============================================================================
+
+TEST_F(SubtitleGeneratorTest, Writer_BatchesMatchGenerateStringForEveryFormat) {
+    const auto all = SampleSegments();
+    std::vector<TranscriptionSegment> third;
+    third.emplace_back(3200, 4000, "Third \"line\"", 0.5f);
+
+    std::vector<TranscriptionSegment> expected_segments = all;
+    expected_segments.push_back(third[0]);
+
+    for (auto format : {SubtitleGenerator::Format::PlainText, SubtitleGenerator::Format::SRT,
+                        SubtitleGenerator::Format::VTT, SubtitleGenerator::Format::JSON}) {
+        std::ostringstream out;
+        SubtitleWriter writer;
+        ASSERT_TRUE(writer.Open(out, format));
+        ASSERT_TRUE(writer.Write({all[0]}));
+        ASSERT_TRUE(writer.Write({}));
+        ASSERT_TRUE(writer.Write({all[1], third[0]}));
+        EXPECT_EQ(writer.GetSegmentCount(), 3u);
+        ASSERT_TRUE(writer.Close());
+
+        EXPECT_EQ(out.str(), SubtitleGenerator::GenerateString(expected_segments, format))
+            << "format " << static_cast<int>(format);
+    }
+}
+
+TEST_F(SubtitleGeneratorTest, Writer_FileIsReadableBeforeClose) {
+    const auto segments = SampleSegments();
+
+    SubtitleWriter writer;
+    ASSERT_TRUE(writer.Open(temp_path_, SubtitleGenerator::Format::SRT));
+    ASSERT_TRUE(writer.Write({segments[0]}));
+
+    // Each batch is flushed, so a reader sees it while transcription goes on
+    EXPECT_TRUE(Contains(ReadFile(), "Hello world"));
+
+    ASSERT_TRUE(writer.Write({segments[1]}));
+    ASSERT_TRUE(writer.Close());
+    EXPECT_FALSE(writer.IsOpen());
+    EXPECT_EQ(ReadFile(),
+              SubtitleGenerator::GenerateString(segments, SubtitleGenerator::Format::SRT));
+}
+
+TEST_F(SubtitleGeneratorTest, Writer_JSONWithoutSegmentsIsValid) {
+    std::ostringstream out;
+    SubtitleWriter writer;
+    ASSERT_TRUE(writer.Open(out, SubtitleGenerator::Format::JSON));
+    ASSERT_TRUE(writer.Close());
+    EXPECT_EQ(out.str(), "{\n  \"segments\": []\n}\n");
+}
+
+TEST_F(SubtitleGeneratorTest, Writer_CaptionFinalsBecomeCues) {
+    auto make_event = [](CaptionEventType type, const std::string& text, int64_t start_ms,
+                         int64_t end_ms, float confidence, int32_t speaker_id = -1) {
+        CaptionEvent ev;
+        ev.type = type;
+        ev.text = text;
+        ev.utterance_start_ms = start_ms;
+        ev.utterance_end_ms = end_ms;
+        ev.confidence = confidence;
+        ev.utterance_id = 0;
+        ev.speaker_id = speaker_id;
+        return ev;
+    };
+    const CaptionEvent first =
+        make_event(CaptionEventType::Final, "Hello \"live\"", 0, 1500, 0.9f, 0);
+    const CaptionEvent partial = make_event(CaptionEventType::Partial, "Hel", 0, 400, 0.0f);
+    const CaptionEvent silent = make_event(CaptionEventType::Final, "", 1500, 1600, 0.0f);
+    const CaptionEvent second = make_event(CaptionEventType::Final, "Second", 1600, 2400, 0.75f);
+
+    std::vector<TranscriptionSegment> expected;
+    expected.emplace_back(0, 1500, "Hello \"live\"", 0.9f);
+    expected.back().speaker_id = 0;
+    expected.emplace_back(1600, 2400, "Second", 0.75f);
+
+    for (auto format : {SubtitleGenerator::Format::SRT, SubtitleGenerator::Format::VTT,
+                        SubtitleGenerator::Format::JSON}) {
+        std::ostringstream out;
+        SubtitleWriter writer;
+        ASSERT_TRUE(writer.Open(out, format));
+        // Partials and empty finals are skipped, so every event can be forwarded
+        for (const auto* event : {&partial, &first, &silent, &second}) {
+            ASSERT_TRUE(writer.WriteCaption(*event));
+        }
+        EXPECT_EQ(writer.GetSegmentCount(), 2u);
+        ASSERT_TRUE(writer.Close());
+        EXPECT_FALSE(writer.WriteCaption(second));
+
+        EXPECT_EQ(out.str(), SubtitleGenerator::GenerateString(expected, format))
+            << "format " << static_cast<int>(format);
+    }
+}
+
+TEST_F(SubtitleGeneratorTest, Writer_SingleSegmentsAndEscapes) {
+    std::vector<TranscriptionSegment> segments;
+    segments.emplace_back(0, 3723004, "Tab\there\nback\\slash", 0.126f);
+    segments.back().words.emplace_back(0, 500, std::string("\x01" "ctl"), 0.5f);
+    segments.emplace_back(3723004, 3723100, "Next", 1.0f);
+
+    std::ostringstream out;
+    SubtitleWriter writer;
+    ASSERT_TRUE(writer.Open(out, SubtitleGenerator::Format::JSON));
+    for (const auto& segment : segments) {
+        ASSERT_TRUE(writer.WriteSegment(segment));
+    }
+    ASSERT_TRUE(writer.Close());
+
+    const std::string json = out.str();
+    EXPECT_EQ(json, SubtitleGenerator::GenerateString(segments, SubtitleGenerator::Format::JSON));
+    EXPECT_TRUE(Contains(json, "\"start_ms\": 3723004"));
+    EXPECT_TRUE(Contains(json, "\"confidence\": 0.13"));
+    EXPECT_TRUE(Contains(json, "Tab\\there\\nback\\\\slash"));
+    EXPECT_TRUE(Contains(json, "\"text\": \"\\u0001ctl\", \"probability\": 0.50"));
+    const std::string srt =
+        SubtitleGenerator::GenerateString(segments, SubtitleGenerator::Format::SRT);
+    EXPECT_TRUE(Contains(srt, "01:02:03,004 --> 01:02:03,100"));
+}
+
+TEST_F(SubtitleGeneratorTest, Writer_BadOutputPathFails) {
+    SubtitleWriter writer;
+    EXPECT_FALSE(writer.Open("/nonexistent_dir_ffvoice/out.srt", SubtitleGenerator::Format::SRT));
+    EXPECT_FALSE(writer.IsOpen());
+    EXPECT_FALSE(writer.Write(SampleSegments()));
+}
+
 #endif  // ENABLE_WHISPER
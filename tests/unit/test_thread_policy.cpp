@@ -0,0 +1,131 @@
+/**
+ * @file test_thread_policy.cpp
+ * @brief Unit tests for ThreadPolicy parsing, application and reporting
+ */
+
+#include "audio/capture_batcher.h"
+#include "utils/thread_policy.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+using namespace ffvoice;
+
+class ThreadPolicyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ClearAppliedThreadPolicies();
+    }
+    void TearDown() override {
+        ClearAppliedThreadPolicies();
+    }
+};
+
+TEST_F(ThreadPolicyTest, ParsesCoreLists) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(ParseCpuList("0", cpus));
+    EXPECT_EQ(std::vector<int>({0}), cpus);
+    ASSERT_TRUE(ParseCpuList("0-3,6", cpus));
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 6}), cpus);
+    ASSERT_TRUE(ParseCpuList("2,4-5", cpus));
+    EXPECT_EQ(std::vector<int>({2, 4, 5}), cpus);
+}
+
+TEST_F(ThreadPolicyTest, RejectsMalformedCoreLists) {
+    std::vector<int> cpus = {7};
+    for (const char* text : {"", "-1", "3-1", "1,", ",1", "1-", "a", "1 2", "0-99999"}) {
+        EXPECT_FALSE(ParseCpuList(text, cpus)) << text;
+    }
+    EXPECT_EQ(std::vector<int>({7}), cpus);  // Untouched on failure
+}
+
+TEST_F(ThreadPolicyTest, CpusExceptAndBudget) {
+    const int num_cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::vector<int> rest = CpusExcept({0});
+    EXPECT_EQ(static_cast<size_t>(num_cpus - 1), rest.size());
+    for (int cpu : rest) {
+        EXPECT_NE(0, cpu);
+    }
+
+    ThreadPolicy policy;
+    EXPECT_EQ(num_cpus, CpuBudget(policy));
+    policy.cpus = {1, 2};
+    EXPECT_EQ(2, CpuBudget(policy));
+}
+
+TEST_F(ThreadPolicyTest, DefaultPolicyIsNotRecorded) {
+    const AppliedThreadPolicy applied = ApplyThreadPolicy(ThreadPolicy{}, "idle");
+    EXPECT_EQ(ThreadPriority::Default, applied.priority);
+    EXPECT_TRUE(applied.error.empty());
+    EXPECT_TRUE(GetAppliedThreadPolicies().empty());
+}
+
+TEST_F(ThreadPolicyTest, FormatsSummaries) {
+    AppliedThreadPolicy applied;
+    applied.thread_name = "LiveCaptioner inference";
+    applied.priority = ThreadPriority::High;
+    applied.mechanism = "nice -10";
+    applied.cpus = {1, 2, 3, 5};
+    EXPECT_EQ("LiveCaptioner inference: high (nice -10), cpus 1-3,5",
+              FormatAppliedThreadPolicy(applied));
+
+    applied.cpus.clear();
+    applied.mechanism.clear();
+    applied.priority = ThreadPriority::Default;
+    applied.error = "SCHED_FIFO: Operation not permitted";
+    EXPECT_EQ("LiveCaptioner inference: default, any cpu [SCHED_FIFO: Operation not permitted]",
+              FormatAppliedThreadPolicy(applied));
+}
+
+#if defined(__linux__)
+TEST_F(ThreadPolicyTest, PinsThreadAndRecordsResult) {
+    AppliedThreadPolicy applied;
+    int running_on = -1;
+    // A separate thread so the pinning does not outlive the test
+    std::thread([&] {
+        ThreadPolicy policy;
+        policy.cpus = {sched_getcpu()};  // A core this process is allowed to use
+        applied = ApplyThreadPolicy(policy, "pinned");
+        running_on = sched_getcpu();
+    }).join();
+
+    ASSERT_TRUE(applied.error.empty()) << applied.error;
+    ASSERT_EQ(1u, applied.cpus.size());
+    EXPECT_EQ(applied.cpus[0], running_on);
+
+    const auto recorded = GetAppliedThreadPolicies();
+    ASSERT_EQ(1u, recorded.size());
+    EXPECT_EQ("pinned", recorded[0].thread_name);
+    EXPECT_EQ(applied.cpus, recorded[0].cpus);
+}
+#endif
+
+TEST_F(ThreadPolicyTest, ComponentThreadsApplyTheirPolicy) {
+    CaptureBatcherConfig config;
+    config.capacity_samples = 1024;
+    config.batch_samples = 16;
+    // Background priority never needs privileges
+    config.drainer_thread_policy.priority = ThreadPriority::Background;
+    CaptureBatcher batcher(config);
+    ASSERT_TRUE(batcher.StartDrainer([](const int16_t*, size_t) {}));
+    const std::vector<int16_t> samples(64, 1);
+    batcher.Push(samples.data(), samples.size());
+    batcher.Stop();
+
+    const auto recorded = GetAppliedThreadPolicies();
+    ASSERT_EQ(1u, recorded.size());
+    EXPECT_EQ("CaptureBatcher drainer", recorded[0].thread_name);
+#if defined(__linux__)
+    EXPECT_EQ(ThreadPriority::Background, recorded[0].priority);
+    EXPECT_EQ("nice 10", recorded[0].mechanism);
+#endif
+}
@@ -0,0 +1,140 @@
+/**
+ * @file test_trace.cpp
+ * @brief Unit tests for Tracer and TraceSpan
+ */
+
+#include "utils/trace.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ffvoice;
+
+class TraceTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        // The tracer is process-wide: leave it off for the other suites
+        Tracer::Stop();
+    }
+};
+
+TEST_F(TraceTest, SpansOnlyRecordedWhileRunning) {
+    Tracer::Start();
+    Tracer::Stop();
+    {
+        TraceSpan span("Stopped");
+    }
+    EXPECT_EQ(0u, Tracer::GetEventCount());
+    EXPECT_EQ(std::string::npos, Tracer::ToChromeJson().find("Stopped"));
+
+    Tracer::Start();
+    {
+        TraceSpan span("Running");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    Tracer::Stop();
+    EXPECT_EQ(1u, Tracer::GetEventCount());
+
+    const std::string json = Tracer::ToChromeJson();
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"Running\",\"cat\":\"ffvoice\",\"ph\":\"X\""));
+    EXPECT_EQ("]}", json.substr(json.size() - 2));
+
+    // Duration is in microseconds
+    const size_t dur = json.find("\"dur\":");
+    ASSERT_NE(std::string::npos, dur);
+    EXPECT_GE(std::stod(json.substr(dur + 6)), 1500.0);
+}
+
+TEST_F(TraceTest, StartDiscardsPreviousSession) {
+    Tracer::Start();
+    {
+        TraceSpan span("FirstSession");
+    }
+    Tracer::Start();
+    {
+        TraceSpan span("SecondSession");
+    }
+    Tracer::Stop();
+
+    const std::string json = Tracer::ToChromeJson();
+    EXPECT_EQ(1u, Tracer::GetEventCount());
+    EXPECT_EQ(std::string::npos, json.find("FirstSession"));
+    EXPECT_NE(std::string::npos, json.find("SecondSession"));
+}
+
+TEST_F(TraceTest, EachThreadGetsItsOwnTrack) {
+    Tracer::Start();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t]() {
+            Tracer::SetThreadName("worker \"" + std::to_string(t) + "\"");
+            for (int i = 0; i < 100; ++i) {
+                TraceSpan span("Work");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Tracer::Stop();
+
+    EXPECT_EQ(300u, Tracer::GetEventCount());
+    EXPECT_EQ(0u, Tracer::GetDroppedCount());
+    const std::string json = Tracer::ToChromeJson();
+    for (int t = 0; t < 3; ++t) {
+        // Thread names are escaped into metadata events
+        EXPECT_NE(std::string::npos,
+                  json.find("\"args\":{\"name\":\"worker \\\"" + std::to_string(t) + "\\\"\"}"));
+    }
+}
+
+TEST_F(TraceTest, FullBufferDropsAndCounts) {
+    Tracer::Start();
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < Tracer::kEventsPerThread + 10; ++i) {
+        Tracer::Record("Flood", now, now);
+    }
+    Tracer::Stop();
+
+    EXPECT_EQ(Tracer::kEventsPerThread, Tracer::GetEventCount());
+    EXPECT_EQ(10u, Tracer::GetDroppedCount());
+}
+
+TEST_F(TraceTest, WriteChromeTrace) {
+    Tracer::Start();
+    {
+        TraceSpan span("Written");
+    }
+    Tracer::Stop();
+
+    const std::string path = ::testing::TempDir() + "test_trace.json";
+    ASSERT_TRUE(Tracer::WriteChromeTrace(path));
+    std::ifstream in(path);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    EXPECT_NE(std::string::npos, contents.str().find("\"name\":\"Written\""));
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(Tracer::WriteChromeTrace(::testing::TempDir() + "no_such_dir/trace.json"));
+}
+
+TEST_F(TraceTest, ScopeMacroFollowsBuildFlag) {
+    Tracer::Start();
+    {
+        FFVOICE_TRACE_SCOPE("Macro");
+    }
+    Tracer::Stop();
+#ifdef FFVOICE_ENABLE_TRACING
+    EXPECT_EQ(1u, Tracer::GetEventCount());
+#else
+    EXPECT_EQ(0u, Tracer::GetEventCount());
+#endif
+}
@@ -0,0 +1,69 @@
+/**
+ * @file test_transcription_arena.cpp
+ * @brief Unit tests for TranscriptionArena (reusable transcription output)
+ */
+
+#include "audio/whisper_processor.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace ffvoice;
+
+TEST(TranscriptionArenaTest, StartsEmpty) {
+    TranscriptionArena arena;
+    EXPECT_TRUE(arena.empty());
+    EXPECT_EQ(0u, arena.size());
+    EXPECT_EQ(arena.begin(), arena.end());
+}
+
+TEST(TranscriptionArenaTest, AppendAddsDefaultSegments) {
+    TranscriptionArena arena;
+    TranscriptionSegment& first = arena.Append();
+    first.start_ms = 100;
+    first.text = " hello";
+    arena.Append().text = " world";
+
+    ASSERT_EQ(2u, arena.size());
+    EXPECT_EQ(100, arena[0].start_ms);
+    EXPECT_EQ(" hello", arena[0].text);
+    EXPECT_EQ(" world", arena[1].text);
+    EXPECT_EQ(0, arena[1].start_ms);
+    EXPECT_EQ(-1, arena[1].speaker_id);
+
+    std::string joined;
+    for (const auto& segment : arena) {
+        joined += segment.text;
+    }
+    EXPECT_EQ(" hello world", joined);
+}
+
+TEST(TranscriptionArenaTest, ClearKeepsSlotsAndResetsReusedSegment) {
+    TranscriptionArena arena;
+    TranscriptionSegment& segment = arena.Append();
+    segment.start_ms = 5;
+    segment.end_ms = 9;
+    segment.confidence = 0.5f;
+    segment.speaker_id = 2;
+    segment.text.assign(200, 'x');  // Well beyond any small-string buffer
+    segment.words.emplace_back(0, 10, " w", 1.0f);
+    const char* text_storage = segment.text.data();
+
+    arena.clear();
+    EXPECT_TRUE(arena.empty());
+    EXPECT_EQ(1u, arena.capacity());
+
+    TranscriptionSegment& reused = arena.Append();
+    EXPECT_EQ(0, reused.start_ms);
+    EXPECT_EQ(0, reused.end_ms);
+    EXPECT_FLOAT_EQ(0.0f, reused.confidence);
+    EXPECT_EQ(-1, reused.speaker_id);
+    EXPECT_TRUE(reused.text.empty());
+    EXPECT_TRUE(reused.words.empty());
+
+    // Same slot, same text buffer: refilling does not allocate
+    reused.text.assign(150, 'y');
+    EXPECT_EQ(text_storage, reused.text.data());
+    EXPECT_EQ(1u, arena.capacity());
+}
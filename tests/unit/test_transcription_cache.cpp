@@ -0,0 +1,227 @@
+/**
+ * @file test_transcription_cache.cpp
+ * @brief Unit tests for TranscriptionCache
+ */
+
+#include "audio/transcription_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ffvoice;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+std::string TempDir(const char* name) {
+    const fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    return dir.string();
+}
+
+std::vector<TranscriptionSegment> OneSegment(const std::string& text) {
+    return {TranscriptionSegment(0, 1000, text, 0.5f)};
+}
+
+}  // namespace
+
+TEST(TranscriptionCacheTest, RoundTripsSegmentsWordsAndSpeakers) {
+    const std::string dir = TempDir("ffvoice_cache_roundtrip");
+    TranscriptionCache cache({dir});
+
+    std::vector<TranscriptionSegment> segments = {
+        TranscriptionSegment(0, 1200, " Hello world", 0.9f),
+        TranscriptionSegment(1200, 2500, " 你好", 0.7f),
+        TranscriptionSegment(2500, 2600, "", 0.1f),
+    };
+    segments[0].speaker_id = 1;
+    segments[0].words.resize(2);
+    segments[0].words[0].start_ms = 0;
+    segments[0].words[0].end_ms = 500;
+    segments[0].words[0].text = " Hello";
+    segments[0].words[0].probability = 0.95f;
+    segments[0].words[0].speaker_id = 1;
+    segments[0].words[1].start_ms = 500;
+    segments[0].words[1].end_ms = 1200;
+    segments[0].words[1].text = " world";
+    segments[0].words[1].probability = 0.85f;
+    const std::vector<SpeakerSegment> speakers = {{0, 1200, 1}, {1200, 2500, 0}};
+
+    const std::string key = TranscriptionCache::MakeKey("0123", WhisperConfig{});
+    std::vector<TranscriptionSegment> loaded;
+    EXPECT_FALSE(cache.Lookup(key, loaded));
+    ASSERT_TRUE(cache.Store(key, segments, &speakers)) << cache.GetLastError();
+
+    std::vector<SpeakerSegment> loaded_speakers;
+    loaded = OneSegment("stale");
+    ASSERT_TRUE(cache.Lookup(key, loaded, &loaded_speakers));
+    ASSERT_EQ(segments.size(), loaded.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        EXPECT_EQ(segments[i].start_ms, loaded[i].start_ms);
+        EXPECT_EQ(segments[i].end_ms, loaded[i].end_ms);
+        EXPECT_EQ(segments[i].text, loaded[i].text);
+        EXPECT_FLOAT_EQ(segments[i].confidence, loaded[i].confidence);
+        EXPECT_EQ(segments[i].speaker_id, loaded[i].speaker_id);
+        ASSERT_EQ(segments[i].words.size(), loaded[i].words.size());
+    }
+    EXPECT_EQ(" world", loaded[0].words[1].text);
+    EXPECT_EQ(500, loaded[0].words[1].start_ms);
+    EXPECT_FLOAT_EQ(0.85f, loaded[0].words[1].probability);
+    EXPECT_EQ(1, loaded[0].words[0].speaker_id);
+    EXPECT_EQ(-1, loaded[0].words[1].speaker_id);
+    ASSERT_EQ(2u, loaded_speakers.size());
+    EXPECT_EQ(1200, loaded_speakers[1].start_ms);
+    EXPECT_EQ(0, loaded_speakers[1].speaker_id);
+
+    const TranscriptionCacheStats stats = cache.GetStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.stores);
+    EXPECT_EQ(1u, stats.entries);
+    EXPECT_GT(stats.bytes, 0u);
+
+    cache.Clear();
+    EXPECT_FALSE(cache.Lookup(key, loaded));
+    EXPECT_EQ(0u, cache.GetStats().entries);
+    fs::remove_all(dir);
+}
+
+TEST(TranscriptionCacheTest, EachEntryKeepsItsDetectedLanguage) {
+    const std::string dir = TempDir("ffvoice_cache_language");
+    TranscriptionCache cache({dir});
+
+    // Two recordings transcribed with language = "auto", one English, one German
+    WhisperConfig config;
+    const std::string english = TranscriptionCache::MakeKey("english-clip", config);
+    const std::string german = TranscriptionCache::MakeKey("german-clip", config);
+    ASSERT_TRUE(cache.Store(english, OneSegment(" Good morning"), nullptr, "en"));
+    ASSERT_TRUE(cache.Store(german, OneSegment(" Guten Morgen"), nullptr, "de"));
+
+    std::vector<TranscriptionSegment> loaded;
+    std::string language = "stale";
+    ASSERT_TRUE(cache.Lookup(german, loaded, nullptr, &language));
+    EXPECT_EQ("de", language);
+    ASSERT_EQ(1u, loaded.size());
+    EXPECT_EQ(" Guten Morgen", loaded[0].text);
+
+    ASSERT_TRUE(cache.Lookup(english, loaded, nullptr, &language));
+    EXPECT_EQ("en", language);
+    ASSERT_EQ(1u, loaded.size());
+    EXPECT_EQ(" Good morning", loaded[0].text);
+
+    // No language stored: a hit clears it rather than keeping the previous one
+    ASSERT_TRUE(cache.Store("unknown", OneSegment(" ..."), nullptr));
+    ASSERT_TRUE(cache.Lookup("unknown", loaded, nullptr, &language));
+    EXPECT_TRUE(language.empty());
+
+    // A miss leaves the caller's value alone
+    language = "en";
+    EXPECT_FALSE(cache.Lookup("missing", loaded, nullptr, &language));
+    EXPECT_EQ("en", language);
+    fs::remove_all(dir);
+}
+
+TEST(TranscriptionCacheTest, KeyCoversContentAndOutputSettings) {
+    const std::string dir = TempDir("ffvoice_cache_keys");
+    fs::create_directories(dir);
+    const std::string audio = (fs::path(dir) / "clip.raw").string();
+    std::ofstream(audio, std::ios::binary) << std::string(1000, 'a');
+    const std::string hash = TranscriptionCache::HashFile(audio);
+    ASSERT_EQ(32u, hash.size());
+    EXPECT_EQ(hash, TranscriptionCache::HashBytes(std::string(1000, 'a').data(), 1000));
+    EXPECT_NE(hash, TranscriptionCache::HashBytes(std::string(999, 'a').data(), 999));
+    EXPECT_TRUE(TranscriptionCache::HashFile((fs::path(dir) / "missing.wav").string()).empty());
+
+    WhisperConfig config;
+    config.model_path = "/models/ggml-tiny.bin";
+    const std::string key = TranscriptionCache::MakeKey(hash, config);
+    EXPECT_NE(key, TranscriptionCache::MakeKey("other", config));
+
+    // Settings that change the transcript change the key...
+    WhisperConfig changed = config;
+    changed.language = "de";
+    EXPECT_NE(key, TranscriptionCache::MakeKey(hash, changed));
+    changed = config;
+    changed.word_timestamps = true;
+    EXPECT_NE(key, TranscriptionCache::MakeKey(hash, changed));
+    changed = config;
+    changed.initial_prompt = "Glossary: ffvoice";
+    EXPECT_NE(key, TranscriptionCache::MakeKey(hash, changed));
+    changed = config;
+    changed.model_path = "/models/ggml-base.bin";
+    EXPECT_NE(key, TranscriptionCache::MakeKey(hash, changed));
+
+    // ...the rest, and where the model lives, do not
+    changed = config;
+    changed.n_threads = 16;
+    changed.print_progress = false;
+    changed.model_path = "/opt/other/ggml-tiny.bin";
+    EXPECT_EQ(key, TranscriptionCache::MakeKey(hash, changed));
+    fs::remove_all(dir);
+}
+
+TEST(TranscriptionCacheTest, EvictsLeastRecentlyUsedEntries) {
+    const std::string dir = TempDir("ffvoice_cache_lru");
+    uint64_t entry_bytes = 0;
+    {
+        TranscriptionCache probe({dir});
+        ASSERT_TRUE(probe.Store("probe", OneSegment("x")));
+        entry_bytes = probe.GetStats().bytes;
+        probe.Clear();
+    }
+    ASSERT_GT(entry_bytes, 0u);
+
+    TranscriptionCache cache({dir, 3 * entry_bytes});
+    ASSERT_TRUE(cache.Store("a", OneSegment("a")));
+    ASSERT_TRUE(cache.Store("b", OneSegment("b")));
+    ASSERT_TRUE(cache.Store("c", OneSegment("c")));
+
+    // Age the entries explicitly: file times may be coarser than the test
+    const auto now = fs::file_time_type::clock::now();
+    fs::last_write_time(fs::path(dir) / "a.ffvc", now - std::chrono::hours(3));
+    fs::last_write_time(fs::path(dir) / "b.ffvc", now - std::chrono::hours(2));
+    fs::last_write_time(fs::path(dir) / "c.ffvc", now - std::chrono::hours(1));
+
+    // Using "a" makes "b" the least recently used
+    std::vector<TranscriptionSegment> loaded;
+    ASSERT_TRUE(cache.Lookup("a", loaded));
+    ASSERT_TRUE(cache.Store("d", OneSegment("d")));
+
+    EXPECT_TRUE(cache.Lookup("a", loaded));
+    EXPECT_FALSE(cache.Lookup("b", loaded));
+    EXPECT_TRUE(cache.Lookup("c", loaded));
+    EXPECT_TRUE(cache.Lookup("d", loaded));
+    const TranscriptionCacheStats stats = cache.GetStats();
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(3u, stats.entries);
+    EXPECT_LE(stats.bytes, 3 * entry_bytes);
+    fs::remove_all(dir);
+}
+
+TEST(TranscriptionCacheTest, CorruptEntryIsAMissAndDeleted) {
+    const std::string dir = TempDir("ffvoice_cache_corrupt");
+    TranscriptionCache cache({dir});
+    ASSERT_TRUE(cache.Store("k", OneSegment("hello")));
+    const fs::path entry = fs::path(dir) / "k.ffvc";
+
+    // Truncated by a crash or a full disk
+    fs::resize_file(entry, fs::file_size(entry) - 2);
+    std::vector<TranscriptionSegment> loaded = OneSegment("unchanged");
+    EXPECT_FALSE(cache.Lookup("k", loaded));
+    EXPECT_FALSE(fs::exists(entry));
+    ASSERT_EQ(1u, loaded.size());
+    EXPECT_EQ("unchanged", loaded[0].text);
+
+    // Not a cache entry at all
+    std::ofstream(entry, std::ios::binary) << std::string(200, '\xff');
+    EXPECT_FALSE(cache.Lookup("k", loaded));
+    EXPECT_FALSE(fs::exists(entry));
+    EXPECT_EQ(2u, cache.GetStats().misses);
+    fs::remove_all(dir);
+}
@@ -7,7 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 using namespace ffvoice;
@@ -191,6 +193,173 @@ TEST_F(VADSegmenterTest, Flush_WithBufferedSpeech) {
     EXPECT_EQ(480u * 5, received_segments_[0].num_samples);
 }
 
+// =============================================================================
+// Segment Hand-off Tests
+// =============================================================================
+
+TEST_F(VADSegmenterTest, TakeSegment_OutlivesCallback) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    config.min_silence_frames = 2;
+    VADSegmenter segmenter(config);
+
+    auto samples = GenerateSamples(480, 1234);
+    SegmentHandle handle;
+    const int16_t* delivered = nullptr;
+    auto take = [&](const int16_t* seg, size_t) {
+        delivered = seg;
+        handle = segmenter.TakeSegment();
+        EXPECT_TRUE(segmenter.TakeSegment().empty());  // Only once per segment
+    };
+    for (int i = 0; i < 4; ++i) {
+        segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, take);
+    }
+    for (int i = 0; i < 2; ++i) {
+        segmenter.ProcessFrame(samples.data(), samples.size(), 0.1f, take);
+    }
+
+    // The handle owns the very buffer the callback saw, and it stays valid
+    ASSERT_FALSE(handle.empty());
+    EXPECT_EQ(delivered, handle.data());
+    EXPECT_EQ(480u * 6, handle.size());
+    EXPECT_EQ(1234, handle.data()[handle.size() - 1]);
+    EXPECT_EQ(0u, segmenter.GetBufferSize());
+
+    SegmentHandle moved = std::move(handle);
+    EXPECT_TRUE(handle.empty());
+    EXPECT_EQ(480u * 6, moved.size());
+}
+
+TEST_F(VADSegmenterTest, TakeSegment_OutsideCallbackIsEmpty) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    VADSegmenter segmenter(config);
+
+    auto samples = GenerateSamples(480);
+    segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, GetCallback());
+
+    EXPECT_TRUE(segmenter.TakeSegment().empty());
+    EXPECT_EQ(480u, segmenter.GetBufferSize());  // Still accumulating
+}
+
+TEST_F(VADSegmenterTest, TakeSegment_RecyclesBuffers) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    config.max_segment_samples = 4800;
+    VADSegmenter segmenter(config);
+
+    // Handles dropped after each segment: the pool hands back the same buffers
+    auto samples = GenerateSamples(480);
+    std::vector<const int16_t*> buffers;
+    auto take = [&](const int16_t*, size_t) {
+        SegmentHandle handle = segmenter.TakeSegment();
+        if (std::find(buffers.begin(), buffers.end(), handle.data()) == buffers.end()) {
+            buffers.push_back(handle.data());
+        }
+    };
+    for (int i = 0; i < 200; ++i) {
+        segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, take);
+    }
+
+    EXPECT_LE(buffers.size(), 2u);
+}
+
+TEST_F(VADSegmenterTest, GetCurrentBuffer_ViewsSpeechInProgress) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    config.min_silence_frames = 1;
+    VADSegmenter segmenter(config);
+
+    EXPECT_TRUE(segmenter.GetCurrentBuffer().empty());
+
+    auto speech = GenerateSamples(480, 777);
+    segmenter.ProcessFrame(speech.data(), speech.size(), 0.9f, GetCallback());
+    ASSERT_EQ(480u, segmenter.GetCurrentBuffer().size());
+    EXPECT_EQ(777, segmenter.GetCurrentBuffer()[0]);
+
+    segmenter.ProcessFrame(speech.data(), speech.size(), 0.1f, GetCallback());
+    EXPECT_EQ(1u, received_segments_.size());
+    EXPECT_TRUE(segmenter.GetCurrentBuffer().empty());
+}
+
+// =============================================================================
+// Pre-roll Tests
+// =============================================================================
+
+TEST_F(VADSegmenterTest, PreRoll_PrependedWhenSpeechStarts) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 3;
+    config.pre_roll_samples = 480 * 4;
+    VADSegmenter segmenter(config);
+
+    // Frames 1..6 are silence, 7..9 speech: speech is confirmed on frame 9
+    for (int16_t frame = 1; frame <= 9; ++frame) {
+        auto samples = GenerateSamples(480, frame);
+        segmenter.ProcessFrame(samples.data(), samples.size(), frame >= 7 ? 0.9f : 0.1f,
+                               GetCallback());
+    }
+    ASSERT_TRUE(segmenter.IsInSpeech());
+
+    // The last four frames before the confirming one, oldest first
+    const std::vector<int16_t>& buffer = segmenter.GetCurrentBuffer();
+    ASSERT_EQ(480u * 5, buffer.size());
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        ASSERT_EQ(static_cast<int16_t>(5 + i / 480), buffer[i]) << "sample " << i;
+    }
+}
+
+TEST_F(VADSegmenterTest, PreRoll_WrapsAndKeepsNewestSamples) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    config.pre_roll_samples = 700;  // Not a whole number of frames: writes wrap
+    VADSegmenter segmenter(config);
+
+    std::vector<int16_t> ramp(480 * 3);
+    for (size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = static_cast<int16_t>(i);
+    }
+    for (size_t pos = 0; pos < ramp.size(); pos += 480) {
+        segmenter.ProcessFrame(ramp.data() + pos, 480, 0.1f, GetCallback());
+    }
+    auto speech = GenerateSamples(480, -1);
+    segmenter.ProcessFrame(speech.data(), speech.size(), 0.9f, GetCallback());
+
+    const std::vector<int16_t>& buffer = segmenter.GetCurrentBuffer();
+    ASSERT_EQ(700u + 480u, buffer.size());
+    for (size_t i = 0; i < 700; ++i) {
+        ASSERT_EQ(static_cast<int16_t>(ramp.size() - 700 + i), buffer[i]) << "sample " << i;
+    }
+    EXPECT_EQ(-1, buffer[700]);
+}
+
+TEST_F(VADSegmenterTest, PreRoll_StartsOverAfterEachSegment) {
+    VADSegmenter::Config config;
+    config.min_speech_frames = 1;
+    config.min_silence_frames = 2;
+    config.pre_roll_samples = 480 * 10;
+    VADSegmenter segmenter(config);
+
+    auto samples = GenerateSamples(480);
+    segmenter.ProcessFrame(samples.data(), samples.size(), 0.1f, GetCallback());
+    for (int i = 0; i < 3; ++i) {
+        segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, GetCallback());
+    }
+    for (int i = 0; i < 2; ++i) {
+        segmenter.ProcessFrame(samples.data(), samples.size(), 0.1f, GetCallback());
+    }
+    ASSERT_EQ(1u, received_segments_.size());
+    EXPECT_EQ(480u * 6, received_segments_[0].num_samples);  // 1 pre-roll + 3 speech + 2 silence
+
+    // Audio already delivered is not repeated in the next segment
+    segmenter.ProcessFrame(samples.data(), samples.size(), 0.1f, GetCallback());
+    segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, GetCallback());
+    EXPECT_EQ(480u * 2, segmenter.GetBufferSize());
+
+    segmenter.Reset();
+    segmenter.ProcessFrame(samples.data(), samples.size(), 0.9f, GetCallback());
+    EXPECT_EQ(480u, segmenter.GetBufferSize());
+}
+
 // =============================================================================
 // Reset Tests
 // =============================================================================
@@ -8,8 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <string>
 #include <vector>
 
 using namespace ffvoice;
@@ -51,6 +55,22 @@ protected:
         return file.good();
     }
 
+    // Helper: Read a whole file
+    static std::vector<char> ReadFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file),
+                                 std::istreambuf_iterator<char>());
+    }
+
+    // Helper: Write @p samples in 256-frame callbacks, as the capture path does
+    static void WriteInCallbacks(WavWriter& writer, const std::vector<int16_t>& samples,
+                                 int channels) {
+        const size_t block = 256 * static_cast<size_t>(channels);
+        for (size_t pos = 0; pos < samples.size(); pos += block) {
+            writer.WriteSamples(samples.data() + pos, std::min(block, samples.size() - pos));
+        }
+    }
+
     std::string test_file_;
 };
 
@@ -311,6 +331,135 @@ TEST_F(WavWriterTest, ReopenAfterClose) {
     EXPECT_EQ(header.num_channels, 2);
 }
 
+// ============================================================================
+// Buffering and Checkpoint Tests
+// ============================================================================
+
+TEST_F(WavWriterTest, BufferedMatchesWriteThrough) {
+    const auto samples = SignalGenerator::GenerateSineWave(440.0, 2.0, 48000, 0.5);
+    const std::string reference_file = ::testing::TempDir() + "test_wav_writer_ref.wav";
+
+    WavWriter::Config through;
+    through.buffer_bytes = 0;
+    WavWriter reference(through);
+    ASSERT_TRUE(reference.Open(reference_file, 48000, 1, 16));
+    WriteInCallbacks(reference, samples, 1);
+    reference.Close();
+
+    // A buffer size that is neither a block nor a callback multiple
+    WavWriter::Config buffered;
+    buffered.buffer_bytes = 10000;
+    WavWriter writer(buffered);
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 1, 16));
+    WriteInCallbacks(writer, samples, 1);
+    EXPECT_EQ(samples.size(), writer.GetTotalSamples());
+    writer.Close();
+
+    const std::vector<char> expected = ReadFile(reference_file);
+    EXPECT_EQ(44u + samples.size() * 2, expected.size());
+    EXPECT_EQ(expected, ReadFile(test_file_));
+    std::remove(reference_file.c_str());
+}
+
+TEST_F(WavWriterTest, HeaderCheckpointedWhileRecording) {
+    WavWriter::Config config;
+    config.buffer_bytes = 4096;
+    config.checkpoint_ms = 100;
+    WavWriter writer(config);
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 1, 16));
+
+    // 1 s of audio; nothing has been closed, as after a crash
+    WriteInCallbacks(writer, SignalGenerator::GenerateSineWave(440.0, 1.0, 48000, 0.5), 1);
+
+    WavHeader header;
+    ASSERT_TRUE(ReadWavHeader(test_file_, header));
+    const uint32_t written_bytes = 48000 * 2;
+    const uint32_t checkpoint_bytes = 4800 * 2;
+    EXPECT_LE(header.data_size, written_bytes);
+    EXPECT_GE(header.data_size + checkpoint_bytes + config.buffer_bytes, written_bytes);
+    EXPECT_EQ(header.data_size + 36, header.chunk_size);
+    EXPECT_GE(ReadFile(test_file_).size(), 44u + header.data_size);
+
+    // Flush() brings the file and its header up to date
+    ASSERT_TRUE(writer.Flush());
+    ASSERT_TRUE(ReadWavHeader(test_file_, header));
+    EXPECT_EQ(written_bytes, header.data_size);
+    EXPECT_EQ(44u + written_bytes, ReadFile(test_file_).size());
+    writer.Close();
+}
+
+TEST_F(WavWriterTest, CheckpointsDisabled_HeaderWrittenOnClose) {
+    WavWriter::Config config;
+    config.buffer_bytes = 0;
+    config.checkpoint_ms = 0;
+    WavWriter writer(config);
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 1, 16));
+    WriteInCallbacks(writer, SignalGenerator::GenerateSineWave(440.0, 1.0, 48000, 0.5), 1);
+
+    WavHeader header;
+    ASSERT_TRUE(ReadWavHeader(test_file_, header));
+    EXPECT_EQ(0u, header.data_size);
+
+    writer.Close();
+    ASSERT_TRUE(ReadWavHeader(test_file_, header));
+    EXPECT_EQ(48000u * 2, header.data_size);
+}
+
+TEST_F(WavWriterTest, DirectIoAndSyncProduceTheSameFile) {
+    // Stereo, so the file does not end on a 4 KiB block boundary
+    const auto mono = SignalGenerator::GenerateSineWave(440.0, 0.5, 48000, 0.5);
+    std::vector<int16_t> samples;
+    for (int16_t sample : mono) {
+        samples.push_back(sample);
+        samples.push_back(static_cast<int16_t>(-sample));
+    }
+    const std::string reference_file = ::testing::TempDir() + "test_wav_writer_ref.wav";
+    {
+        WavWriter reference;
+        ASSERT_TRUE(reference.Open(reference_file, 48000, 2, 16));
+        reference.WriteSamples(samples);
+    }
+
+    // Falls back to buffered I/O where the filesystem rejects O_DIRECT
+    WavWriter::Config config;
+    config.buffer_bytes = 10000;
+    config.checkpoint_ms = 50;
+    config.direct_io = true;
+    config.sync_data = true;
+    WavWriter writer(config);
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 2, 16));
+    WriteInCallbacks(writer, samples, 2);
+    ASSERT_TRUE(writer.Flush());
+    writer.Close();
+
+    EXPECT_EQ(ReadFile(reference_file), ReadFile(test_file_));
+    std::remove(reference_file.c_str());
+}
+
+TEST_F(WavWriterTest, Rf64ReservesSpaceButStaysWavUnder4GB) {
+    WavWriter::Config config;
+    config.rf64 = true;
+    WavWriter writer(config);
+    ASSERT_TRUE(writer.Open(test_file_, 48000, 2, 16));
+    std::vector<int16_t> samples(960, 1234);
+    writer.WriteSamples(samples);
+    writer.Close();
+
+    // RIFF, then a 28-byte JUNK chunk (the future ds64), then fmt and data
+    const std::vector<char> file = ReadFile(test_file_);
+    ASSERT_EQ(80u + samples.size() * 2, file.size());
+    EXPECT_EQ("RIFF", std::string(file.data(), 4));
+    EXPECT_EQ("JUNK", std::string(file.data() + 12, 4));
+    EXPECT_EQ("fmt ", std::string(file.data() + 48, 4));
+    EXPECT_EQ("data", std::string(file.data() + 72, 4));
+    uint32_t riff_size = 0;
+    uint32_t data_size = 0;
+    std::memcpy(&riff_size, file.data() + 4, 4);
+    std::memcpy(&data_size, file.data() + 76, 4);
+    EXPECT_EQ(file.size() - 8, riff_size);
+    EXPECT_EQ(samples.size() * 2, data_size);
+}
+
 // ============================================================================
 // Destructor Test
 // ============================================================================
@@ -0,0 +1,166 @@
+/**
+ * @file test_whisper_backend.cpp
+ * @brief Unit tests for Whisper backend selection and the capability probe
+ * @note Only compiled when ENABLE_WHISPER is defined; no model file or GPU is needed
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_backend.h"
+    #include "audio/whisper_processor.h"
+
+    #include <gtest/gtest.h>
+
+    #include <string>
+
+using namespace ffvoice;
+
+namespace {
+
+WhisperDeviceInfo Gpu(WhisperBackend backend, int index, const std::string& name) {
+    WhisperDeviceInfo device;
+    device.backend = backend;
+    device.index = index;
+    device.name = name;
+    device.description = "Test GPU";
+    return device;
+}
+
+/// Two CUDA GPUs and one Vulkan GPU, in ggml's device order
+WhisperCapabilities MultiGpuNode() {
+    WhisperCapabilities caps;
+    caps.backends = {WhisperBackend::CPU, WhisperBackend::CUDA, WhisperBackend::VULKAN};
+    caps.devices = {Gpu(WhisperBackend::CUDA, 0, "CUDA0"), Gpu(WhisperBackend::CUDA, 1, "CUDA1"),
+                    Gpu(WhisperBackend::VULKAN, 0, "Vulkan0")};
+    return caps;
+}
+
+WhisperCapabilities CpuOnly() {
+    WhisperCapabilities caps;
+    caps.backends = {WhisperBackend::CPU};
+    return caps;
+}
+
+}  // namespace
+
+TEST(WhisperBackendTest, NamesRoundTrip) {
+    for (WhisperBackend backend :
+         {WhisperBackend::AUTO, WhisperBackend::CPU, WhisperBackend::CUDA, WhisperBackend::METAL,
+          WhisperBackend::VULKAN, WhisperBackend::OPENVINO, WhisperBackend::COREML}) {
+        WhisperBackend parsed = WhisperBackend::CPU;
+        ASSERT_TRUE(ParseWhisperBackend(GetWhisperBackendName(backend), parsed));
+        EXPECT_EQ(backend, parsed);
+    }
+    WhisperBackend parsed = WhisperBackend::CPU;
+    EXPECT_TRUE(ParseWhisperBackend("CUDA", parsed));
+    EXPECT_EQ(WhisperBackend::CUDA, parsed);
+    EXPECT_FALSE(ParseWhisperBackend("tpu", parsed));
+    EXPECT_EQ(WhisperBackend::CUDA, parsed);  // Untouched on failure
+}
+
+TEST(WhisperBackendTest, BackendGpuIndexMapsToGlobalDevice) {
+    WhisperAcceleration accel;
+    accel.backend = WhisperBackend::VULKAN;
+    accel.flash_attn = true;
+    WhisperContextSettings settings;
+    std::string error;
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error)) << error;
+    EXPECT_TRUE(settings.use_gpu);
+    EXPECT_EQ(2, settings.gpu_device);  // Vulkan's first GPU is the third overall
+    EXPECT_TRUE(settings.flash_attn);
+    EXPECT_EQ("Vulkan0 (Test GPU)", settings.description);
+
+    accel.backend = WhisperBackend::CUDA;
+    accel.gpu_device = 1;
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error)) << error;
+    EXPECT_EQ(1, settings.gpu_device);
+
+    accel.gpu_device = 2;
+    EXPECT_FALSE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error));
+    EXPECT_NE(std::string::npos, error.find("2 cuda GPU(s)")) << error;
+}
+
+TEST(WhisperBackendTest, AutoUsesGpusWhenPresent) {
+    WhisperAcceleration accel;  // AUTO, GPU 0
+    WhisperContextSettings settings;
+    std::string error;
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error));
+    EXPECT_TRUE(settings.use_gpu);
+    EXPECT_EQ(0, settings.gpu_device);
+
+    accel.gpu_device = 2;  // AUTO counts all GPUs
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error));
+    EXPECT_EQ(2, settings.gpu_device);
+
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, CpuOnly(), settings, error));
+    EXPECT_FALSE(settings.use_gpu);
+    EXPECT_EQ("CPU", settings.description);
+}
+
+TEST(WhisperBackendTest, MissingBackendFailsInsteadOfFallingBack) {
+    WhisperAcceleration accel;
+    accel.backend = WhisperBackend::METAL;
+    WhisperContextSettings settings;
+    std::string error;
+    EXPECT_FALSE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error));
+    EXPECT_NE(std::string::npos, error.find("'metal'")) << error;
+    EXPECT_NE(std::string::npos, error.find("cpu, cuda, vulkan")) << error;
+
+    accel.backend = WhisperBackend::CPU;
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, MultiGpuNode(), settings, error));
+    EXPECT_FALSE(settings.use_gpu);
+}
+
+TEST(WhisperBackendTest, OpenVinoEncoderDevice) {
+    WhisperCapabilities caps = CpuOnly();
+    caps.backends.push_back(WhisperBackend::OPENVINO);
+    WhisperAcceleration accel;
+    accel.backend = WhisperBackend::OPENVINO;
+    accel.openvino_device = "GPU";
+    WhisperContextSettings settings;
+    std::string error;
+    ASSERT_TRUE(ResolveWhisperAcceleration(accel, caps, settings, error)) << error;
+    EXPECT_EQ("GPU", settings.openvino_device);
+    EXPECT_FALSE(settings.use_gpu);
+
+    accel.openvino_device.clear();
+    EXPECT_FALSE(ResolveWhisperAcceleration(accel, caps, settings, error));
+}
+
+TEST(WhisperBackendTest, ProbeAlwaysReportsCpu) {
+    const WhisperCapabilities caps = ProbeWhisperCapabilities();
+    EXPECT_TRUE(caps.Supports(WhisperBackend::CPU));
+    EXPECT_TRUE(caps.Supports(WhisperBackend::AUTO));
+    for (const auto& device : caps.devices) {
+        EXPECT_FALSE(device.name.empty());
+    }
+}
+
+TEST(WhisperBackendTest, ProcessorRejectsUnavailableBackend) {
+    const WhisperCapabilities caps = ProbeWhisperCapabilities();
+    if (caps.Supports(WhisperBackend::CUDA)) {
+        GTEST_SKIP() << "CUDA is available in this build";
+    }
+    WhisperConfig config;
+    config.model_path = "/nonexistent/ggml-missing.bin";
+    config.acceleration.backend = WhisperBackend::CUDA;
+    WhisperProcessor processor(config);
+    EXPECT_FALSE(processor.Initialize());
+    EXPECT_NE(std::string::npos, processor.GetLastError().find("'cuda'"));
+    EXPECT_TRUE(processor.GetBackendDescription().empty());
+}
+
+TEST(WhisperBackendTest, LoadReportsMissingModelWithOrWithoutMmap) {
+    const WhisperContextSettings settings;  // CPU
+    for (bool use_mmap : {true, false}) {
+        std::string error;
+        EXPECT_EQ(nullptr, LoadWhisperContext("/nonexistent/ggml-missing.bin", settings, use_mmap,
+                                              true, error));
+        EXPECT_NE(std::string::npos, error.find("ggml-missing.bin")) << error;
+    }
+
+    WhisperProcessor processor{WhisperConfig()};
+    EXPECT_FALSE(processor.Warmup());  // Needs a loaded model
+}
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,155 @@
+/**
+ * @file test_whisper_model_catalog.cpp
+ * @brief Unit tests for the Whisper model catalog and budget-driven selection
+ * @note Only compiled when ENABLE_WHISPER is defined; no model file is needed
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_model_catalog.h"
+
+    #include <gtest/gtest.h>
+
+    #include <cstdio>
+    #include <filesystem>
+    #include <fstream>
+    #include <string>
+
+using namespace ffvoice;
+
+TEST(WhisperModelCatalogTest, ListsQuantizedVariants) {
+    WhisperModelCatalog catalog;
+    const WhisperModelVariant* small = catalog.Find("small-q5_1");
+    ASSERT_NE(nullptr, small);
+    EXPECT_EQ(WhisperModelType::SMALL, small->type);
+    EXPECT_EQ(WhisperQuantization::Q5_1, small->quantization);
+    EXPECT_EQ("ggml-small-q5_1.bin", small->filename);
+    EXPECT_LT(small->file_mb, catalog.Find("small")->file_mb / 2);
+
+    ASSERT_NE(nullptr, catalog.Find("medium-q5_0"));
+    ASSERT_NE(nullptr, catalog.Find("large-v3"));
+    EXPECT_EQ(nullptr, catalog.Find("large-v3-q8_0"));  // Not published
+    EXPECT_EQ(nullptr, catalog.Find("huge"));
+    EXPECT_EQ("ggml-tiny.bin", catalog.GetVariants().front().filename);
+}
+
+TEST(WhisperModelCatalogTest, SelectsLargestModelThatKeepsUp) {
+    WhisperModelCatalog catalog;
+    WhisperResourceBudget budget;
+    budget.max_rtf = 1.0;
+    WhisperModelChoice choice;
+
+    // Uncalibrated defaults: medium runs at ~1x realtime, so one stream just fits it
+    ASSERT_TRUE(catalog.Select(budget, choice)) << catalog.GetLastError();
+    EXPECT_EQ(WhisperModelType::MEDIUM, choice.variant.type);
+    EXPECT_LE(choice.estimated_rtf, 1.0);
+    EXPECT_FALSE(choice.measured);
+
+    // Seven streams share the CPU: F16 base just misses realtime, q8_0 is a bit faster
+    budget.concurrency = 7;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("base-q8_0", choice.variant.name);
+    EXPECT_NEAR(7 * 0.1 * 1.43 * 0.9, choice.estimated_rtf, 1e-9);
+
+    // Without quantized files F16 base is too slow, so tiny wins
+    budget.allow_quantized = false;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("tiny", choice.variant.name);
+
+    budget.concurrency = 100;
+    EXPECT_FALSE(catalog.Select(budget, choice));
+    EXPECT_NE(std::string::npos, catalog.GetLastError().find("100 stream(s)"));
+}
+
+TEST(WhisperModelCatalogTest, MemoryBudgetPrefersQuantizedFiles) {
+    WhisperModelCatalog catalog;
+    const WhisperModelVariant& medium_q5 = *catalog.Find("medium-q5_0");
+    EXPECT_EQ(514u + 4 * 570u, WhisperModelCatalog::EstimateMemoryMb(medium_q5, 4, true));
+    EXPECT_EQ(4 * (514u + 570u), WhisperModelCatalog::EstimateMemoryMb(medium_q5, 4, false));
+
+    WhisperResourceBudget budget;
+    budget.max_rtf = 1.0;
+    budget.max_memory_mb = 1200;  // Neither F16 nor q8_0 medium fits with its state
+    WhisperModelChoice choice;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("medium-q5_0", choice.variant.name);
+    EXPECT_EQ(514u + 570u, choice.estimated_memory_mb);
+
+    budget.share_model = false;
+    budget.concurrency = 2;
+    budget.max_rtf = 10.0;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("small-q5_1", choice.variant.name);  // 2 x (181 + 390) MB of 1200
+}
+
+TEST(WhisperModelCatalogTest, CalibrationRescalesUnmeasuredVariants) {
+    WhisperModelCatalog catalog;
+    EXPECT_FALSE(catalog.IsCalibrated());
+    const WhisperModelVariant& tiny = *catalog.Find("tiny");
+    const WhisperModelVariant& small = *catalog.Find("small");
+    const double small_default = catalog.EstimateRtf(small);
+
+    // This machine turns out four times slower than the defaults assume
+    catalog.SetMeasuredRtf("tiny", 0.4);
+    EXPECT_TRUE(catalog.IsCalibrated());
+    EXPECT_DOUBLE_EQ(0.4, catalog.EstimateRtf(tiny));
+    EXPECT_NEAR(4.0 * small_default, catalog.EstimateRtf(small), 1e-9);
+
+    // A measurement of the variant itself wins over extrapolation
+    catalog.SetMeasuredRtf("small", 1.0);
+    EXPECT_DOUBLE_EQ(1.0, catalog.EstimateRtf(small));
+
+    WhisperResourceBudget budget;
+    budget.max_rtf = 1.0;
+    WhisperModelChoice choice;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("small", choice.variant.name);
+    EXPECT_TRUE(choice.measured);
+
+    catalog.SetMeasuredRtf("unknown-model", 1.0);  // Ignored
+    catalog.SetMeasuredRtf("base", -1.0);
+    EXPECT_NE(0.0, catalog.EstimateRtf(*catalog.Find("base")));
+}
+
+TEST(WhisperModelCatalogTest, CalibrationRoundTripsThroughFile) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "ffvoice_catalog_test.txt").string();
+    WhisperModelCatalog saved;
+    saved.SetMeasuredRtf("base-q8_0", 0.125);
+    saved.SetMeasuredRtf("medium", 2.5);
+    ASSERT_TRUE(saved.SaveCalibration(path));
+
+    WhisperModelCatalog loaded;
+    ASSERT_TRUE(loaded.LoadCalibration(path));
+    EXPECT_DOUBLE_EQ(0.125, loaded.EstimateRtf(*loaded.Find("base-q8_0")));
+    EXPECT_DOUBLE_EQ(2.5, loaded.EstimateRtf(*loaded.Find("medium")));
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(loaded.LoadCalibration(path));
+}
+
+TEST(WhisperModelCatalogTest, OnlyConsidersFilesInModelDir) {
+    const std::filesystem::path dir =
+        std::filesystem::temp_directory_path() / "ffvoice_catalog_models";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "ggml-base.bin") << "x";
+    std::ofstream(dir / "ggml-tiny-q5_1.bin") << "x";
+
+    WhisperModelCatalog catalog;
+    WhisperResourceBudget budget;
+    budget.max_rtf = 10.0;
+    budget.model_dir = dir.string();
+    WhisperModelChoice choice;
+    ASSERT_TRUE(catalog.Select(budget, choice));
+    EXPECT_EQ("base", choice.variant.name);
+
+    // First-run calibration picks the cheapest file present, then fails on the dummy weights
+    EXPECT_FALSE(catalog.CalibrateSmallestAvailable(dir.string(), WhisperConfig(), 1.0));
+    EXPECT_NE(std::string::npos, catalog.GetLastError().find("tiny-q5_1"));
+
+    std::filesystem::remove_all(dir);
+    EXPECT_FALSE(catalog.Select(budget, choice));
+    EXPECT_NE(std::string::npos, catalog.GetLastError().find("No catalog Whisper model"));
+}
+
+#endif  // ENABLE_WHISPER
@@ -0,0 +1,92 @@
+/**
+ * @file test_whisper_model_registry.cpp
+ * @brief Unit tests for WhisperModelRegistry and WhisperStateLease
+ * @note Only compiled when ENABLE_WHISPER is defined; no model file is needed
+ */
+
+#ifdef ENABLE_WHISPER
+
+    #include "audio/whisper_model_registry.h"
+    #include "audio/whisper_processor.h"
+
+    #include <gtest/gtest.h>
+
+    #include <atomic>
+    #include <string>
+    #include <thread>
+    #include <utility>
+    #include <vector>
+
+using namespace ffvoice;
+
+TEST(WhisperModelRegistryTest, InstanceIsSingleton) {
+    EXPECT_EQ(&WhisperModelRegistry::Instance(), &WhisperModelRegistry::Instance());
+}
+
+TEST(WhisperModelRegistryTest, EmptyPath_ReturnsNullWithError) {
+    auto& registry = WhisperModelRegistry::Instance();
+    EXPECT_EQ(registry.Acquire(""), nullptr);
+    EXPECT_FALSE(registry.GetLastError().empty());
+}
+
+TEST(WhisperModelRegistryTest, MissingModel_ReturnsNullAndCachesNothing) {
+    auto& registry = WhisperModelRegistry::Instance();
+    const size_t before = registry.GetLoadedModelCount();
+
+    EXPECT_EQ(registry.Acquire("/nonexistent/ggml-missing.bin"), nullptr);
+    EXPECT_NE(registry.GetLastError().find("ggml-missing.bin"), std::string::npos);
+    EXPECT_EQ(registry.GetLoadedModelCount(), before);
+}
+
+TEST(WhisperModelRegistryTest, ConcurrentMisses_AllFailWithoutCachingAnything) {
+    auto& registry = WhisperModelRegistry::Instance();
+    const size_t before = registry.GetLoadedModelCount();
+
+    // Same key and distinct keys at once: waiters on a failed load get nullptr too
+    std::atomic<int> loaded{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&registry, &loaded, i] {
+            const std::string path = (i % 2 == 0)
+                                         ? std::string("/nonexistent/ggml-shared.bin")
+                                         : "/nonexistent/ggml-" + std::to_string(i) + ".bin";
+            if (registry.Acquire(path)) {
+                ++loaded;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(loaded.load(), 0);
+    EXPECT_FALSE(registry.GetLastError().empty());
+    EXPECT_EQ(registry.GetLoadedModelCount(), before);
+
+    // Nothing is left marked in flight: a later call loads (and fails) again
+    EXPECT_EQ(registry.Acquire("/nonexistent/ggml-shared.bin"), nullptr);
+    EXPECT_NE(registry.GetLastError().find("ggml-shared.bin"), std::string::npos);
+}
+
+TEST(WhisperModelRegistryTest, SharedProcessor_FailsCleanlyWithoutModel) {
+    WhisperConfig config;
+    config.model_path = "/nonexistent/ggml-missing.bin";
+    config.share_model = true;
+
+    WhisperProcessor processor(config);
+    EXPECT_FALSE(processor.Initialize());
+    EXPECT_FALSE(processor.IsInitialized());
+    EXPECT_FALSE(processor.GetLastError().empty());
+}
+
+TEST(WhisperStateLeaseTest, DefaultLeaseIsEmpty) {
+    WhisperStateLease lease;
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(lease.get(), nullptr);
+
+    WhisperStateLease moved = std::move(lease);
+    EXPECT_FALSE(moved);
+    moved.reset();  // Safe on an empty lease
+}
+
+#endif  // ENABLE_WHISPER
@@ -294,3 +294,53 @@ TEST_F(WordGrouperTest, WordsPreserveChronologicalOrder) {
     EXPECT_EQ(" two", words[1].text);
     EXPECT_EQ(" three", words[2].text);
 }
+
+// ============================================================================
+// In-place overload
+// ============================================================================
+
+TEST_F(WordGrouperTest, InPlaceOverloadMatchesReturningOverload) {
+    std::vector<WordToken> tokens = {
+        Tok(" Hel", 0, 100, 0.5f),
+        Tok("lo", 100, 200, 1.0f),
+        Tok(" world", 200, 400, 0.75f),
+    };
+    auto expected = GroupTokensIntoWords(tokens);
+
+    std::vector<Word> words;
+    GroupTokensIntoWords(tokens, words);
+
+    ASSERT_EQ(expected.size(), words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        EXPECT_EQ(expected[i].text, words[i].text);
+        EXPECT_EQ(expected[i].start_ms, words[i].start_ms);
+        EXPECT_EQ(expected[i].end_ms, words[i].end_ms);
+        EXPECT_FLOAT_EQ(expected[i].probability, words[i].probability);
+    }
+}
+
+TEST_F(WordGrouperTest, InPlaceOverloadReplacesPreviousContentAndKeepsCapacity) {
+    std::vector<Word> words;
+    GroupTokensIntoWords({Tok(" a", 0, 10), Tok(" b", 10, 20), Tok(" c", 20, 30)}, words);
+    ASSERT_EQ(3u, words.size());
+    const size_t capacity = words.capacity();
+    const Word* storage = words.data();
+
+    GroupTokensIntoWords({Tok(" d", 30, 40)}, words);
+
+    ASSERT_EQ(1u, words.size());
+    EXPECT_EQ(" d", words[0].text);
+    EXPECT_EQ(30, words[0].start_ms);
+    EXPECT_EQ(capacity, words.capacity());
+    EXPECT_EQ(storage, words.data());
+}
+
+// ============================================================================
+// Segment confidence
+// ============================================================================
+
+TEST_F(WordGrouperTest, MeanTokenProbabilityIgnoresEmptyTokens) {
+    EXPECT_FLOAT_EQ(0.0f, MeanTokenProbability({}));
+    EXPECT_FLOAT_EQ(0.75f, MeanTokenProbability({Tok(" Hel", 0, 100, 0.5f), Tok("", 100, 100, 0.0f),
+                                                 Tok("lo", 100, 200, 1.0f)}));
+}